@@ -35,6 +35,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkHistogram.h>
 #endif
 
+#include <atomic>
+
 class vtkImageData;
 
 namespace itk
@@ -646,6 +648,18 @@ namespace mitk
       new \a ImageStatisticsHolder object.
       */
     StatisticsHolderPointer GetStatistics() const { return m_ImageStatistics; }
+
+    /**
+      \brief Returns how often an image accessor could not be granted immediately.
+
+      The counter is incremented every time a read or write accessor had to wait for (or was refused because of) an
+      overlapping accessor. Accessors on disjoint image parts (e.g. different slices requested via GetSliceData())
+      never conflict and are not counted.
+      */
+    unsigned long GetAccessorContentionCount() const { return m_AccessorContentionCount; }
+
+    /** \brief Resets the counter returned by GetAccessorContentionCount(). */
+    void ResetAccessorContentionCount() { m_AccessorContentionCount = 0; }
   protected:
     mitkCloneMacro(Self);
 
@@ -739,6 +753,8 @@ namespace mitk
 
     /** A mutex, which needs to be locked to manage m_Readers and m_Writers */
     itk::SimpleFastMutexLock m_ReadWriteLock;
+    /** Number of accessor requests that collided with an overlapping accessor, see GetAccessorContentionCount() */
+    mutable std::atomic<unsigned long> m_AccessorContentionCount;
     /** A mutex, which needs to be locked to manage m_VtkReaders */
     itk::SimpleFastMutexLock m_VtkReadersLock;
   };
@@ -30,6 +30,11 @@ namespace mitk
   //##Documentation
   //## @brief The ImageAccessorBase class provides a lock mechanism for all inheriting image accessors.
   //##
+  //## Read accessors are shared: they only have to wait for overlapping write accessors. Write accessors are
+  //## exclusive with respect to the memory range they cover, so writers on disjoint image parts (e.g. two slices
+  //## obtained via Image::GetSliceData()) do not block each other. Collisions are counted, see
+  //## Image::GetAccessorContentionCount().
+  //##
   //## @ingroup Data
 
   class Image;
@@ -0,0 +1,85 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGEREGIONMODIFICATIONEVENT_H
+#define MITKIMAGEREGIONMODIFICATIONEVENT_H
+
+#include <mitkTimeGeometry.h>
+
+#include <itkEventObject.h>
+#include <itkImageRegion.h>
+
+namespace mitk
+{
+  /**
+  \brief Base class of the events an image sends when some of its voxels are overwritten in place.
+
+  Code that writes into a part of an image (e.g. the segmentation tools writing a slice) sends an
+  ImageRegionAboutToBeModifiedEvent before and an ImageRegionModifiedEvent after the modification. Both carry the
+  modified region (index coordinates of the 3D volume) and the time step. Observers that keep data derived from the
+  voxels (like statistics) can restrict their update to this region. The ImageRegionModifiedEvent is sent after the
+  image was marked as modified.
+  */
+  class ImageRegionModificationEvent : public itk::AnyEvent
+  {
+  public:
+    typedef ImageRegionModificationEvent Self;
+    typedef itk::AnyEvent Superclass;
+    typedef itk::ImageRegion<3> RegionType;
+
+    ImageRegionModificationEvent(const RegionType &region = RegionType(), TimeStepType timeStep = 0)
+      : m_Region(region), m_TimeStep(timeStep)
+    {
+    }
+    ImageRegionModificationEvent(const Self &other)
+      : Superclass(other), m_Region(other.m_Region), m_TimeStep(other.m_TimeStep)
+    {
+    }
+    ~ImageRegionModificationEvent() override {}
+    const char *GetEventName() const override { return "ImageRegionModificationEvent"; }
+    bool CheckEvent(const ::itk::EventObject *e) const override { return dynamic_cast<const Self *>(e) != nullptr; }
+    ::itk::EventObject *MakeObject() const override { return new Self(m_Region, m_TimeStep); }
+    const RegionType &GetRegion() const { return m_Region; }
+    TimeStepType GetTimeStep() const { return m_TimeStep; }
+
+  private:
+    RegionType m_Region;
+    TimeStepType m_TimeStep;
+    void operator=(const Self &); // just hide
+  };
+
+#define mitkImageRegionModificationEventMacro(classname, super)                                                       \
+  class classname : public super                                                                                       \
+  {                                                                                                                    \
+  public:                                                                                                              \
+    typedef classname Self;                                                                                            \
+    typedef super Superclass;                                                                                          \
+    classname(const RegionType &region = RegionType(), TimeStepType timeStep = 0) : Superclass(region, timeStep) {}    \
+    classname(const Self &other) : Superclass(other) {}                                                                \
+    ~classname() override {}                                                                                           \
+    const char *GetEventName() const override { return #classname; }                                                   \
+    bool CheckEvent(const ::itk::EventObject *e) const override { return dynamic_cast<const Self *>(e) != nullptr; }   \
+    ::itk::EventObject *MakeObject() const override { return new Self(GetRegion(), GetTimeStep()); }                   \
+                                                                                                                       \
+  private:                                                                                                             \
+    void operator=(const Self &);                                                                                      \
+  };
+
+  mitkImageRegionModificationEventMacro(ImageRegionAboutToBeModifiedEvent, ImageRegionModificationEvent);
+  mitkImageRegionModificationEventMacro(ImageRegionModifiedEvent, ImageRegionModificationEvent);
+}
+
+#endif
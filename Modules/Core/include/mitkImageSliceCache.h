@@ -0,0 +1,213 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkImageSliceCache_h
+#define mitkImageSliceCache_h
+
+#include <MitkCoreExports.h>
+
+#include "mitkExtractSliceFilter.h"
+#include "mitkImage.h"
+#include "mitkPlaneGeometry.h"
+
+#include <vtkSmartPointer.h>
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class vtkImageData;
+class vtkMatrix4x4;
+
+namespace mitk
+{
+  /**
+    \brief Cache of resliced image slices, used by ImageVtkMapper2D.
+
+    The cache keeps the most recently used slices up to a memory limit (GetMaximumMemorySize()).
+    A slice is identified by a SliceKey, which comprises everything the result of reslicing depends
+    on: the image and its modification time, the time step, the values (not the identity) of the
+    plane geometry and the reslice parameters. Slices of an image that was modified since are dropped.
+    The mappers of all images and render windows share one cache (GetInstance()), so the memory limit
+    holds for the application as a whole. It holds the slices requested by the mappers only.
+
+    Slices can also be resliced on a background thread by RequestSlice(), either because they are
+    expected to be shown soon (prefetching the neighbours of the current slice while scrolling) or
+    because the caller does not want to wait for them (asynchronous reslicing). The background
+    thread reslices a private image that references the pixels of the requested time step, so it
+    never touches the pipeline of the original image. While it reads the pixels, it holds an
+    ImageReadAccessor of the time step, so writers wait until the slice is done. The thread is
+    started on demand and ends when all requests are done. Shutdown() stops it for good; the Core
+    module does so for the shared cache when it is unloaded, before static objects are destroyed.
+
+    All methods are thread safe.
+  */
+  class MITKCORE_EXPORT ImageSliceCache
+  {
+  public:
+    /** \brief Everything the result of reslicing depends on. */
+    class MITKCORE_EXPORT SliceKey
+    {
+    public:
+      SliceKey();
+
+      /**
+        \brief Key of a slice of image, resliced along planeGeometry.
+        The key is invalid for geometries other than plain PlaneGeometry objects (e.g. curved planes).
+      */
+      SliceKey(const Image *image,
+               int timeStep,
+               const PlaneGeometry *planeGeometry,
+               ExtractSliceFilter::ResliceInterpolation interpolation,
+               bool inPlaneResampleExtentByGeometry);
+
+      bool IsValid() const { return m_Image != nullptr; }
+      const Image *GetImage() const { return m_Image; }
+
+      bool operator==(const SliceKey &other) const;
+      bool operator!=(const SliceKey &other) const { return !(*this == other); }
+
+    private:
+      friend class ImageSliceCache;
+
+      const Image *m_Image;
+      unsigned long m_ImageMTime;
+      unsigned long m_TimeStepGeometryMTime;
+      int m_TimeStep;
+      ExtractSliceFilter::ResliceInterpolation m_Interpolation;
+      bool m_InPlaneResampleExtentByGeometry;
+      double m_Plane[18];
+      const BaseGeometry *m_ReferenceGeometry;
+      unsigned long m_ReferenceGeometryMTime;
+    };
+
+    /** \brief A resliced slice together with the reslicing results the mapper needs besides the pixels. */
+    struct Slice
+    {
+      vtkSmartPointer<vtkImageData> image;
+      double bounds[6];
+      ScalarType spacing[2];
+      vtkSmartPointer<vtkMatrix4x4> resliceAxes;
+    };
+
+    typedef std::shared_ptr<const Slice> SliceConstPointer;
+
+    /** \brief The cache shared by all ImageVtkMapper2D instances. */
+    static ImageSliceCache *GetInstance();
+
+    ImageSliceCache();
+
+    /** \brief Calls Shutdown(), which does not wait for anything if it was called before. */
+    ~ImageSliceCache();
+
+    /**
+      \brief Drops the queued requests and waits for the slice which is resliced in the background at the moment.
+      Later requests are ignored, cached slices can still be retrieved.
+    */
+    void Shutdown();
+
+    /**
+      \brief Memory limit of the cached slices in bytes (default 64 MiB).
+      The most recently used slice is always kept.
+    */
+    void SetMaximumMemorySize(size_t bytes);
+    size_t GetMaximumMemorySize() const;
+
+    /** \brief Returns the slice of key and marks it as most recently used, nullptr if it is not cached. */
+    SliceConstPointer GetSlice(const SliceKey &key);
+
+    /**
+      \brief Adds a slice resliced by the caller.
+      The slice image and the reslice axes are copied, so the caller may reuse them.
+    */
+    SliceConstPointer AddSlice(const SliceKey &key,
+                               vtkImageData *sliceImage,
+                               const double bounds[6],
+                               const ScalarType spacing[2],
+                               vtkMatrix4x4 *resliceAxes);
+
+    /**
+      \brief Reslices a slice of image along planeGeometry on the background thread.
+
+      Requests with priority are processed before all others and drop the queued requests
+      without priority, which are the prefetching requests of slices the user scrolled past.
+      onCached is called from the background thread as soon as the slice is cached, or right
+      away in the calling thread if it is cached already. A slice which is requested already
+      is resliced once, and the callbacks of all its requests are called.
+
+      The request takes what it needs from image and planeGeometry, so they may be changed
+      afterwards. Must be called from the thread which owns the image (the GUI thread).
+    */
+    void RequestSlice(const SliceKey &key,
+                      Image *image,
+                      const PlaneGeometry *planeGeometry,
+                      bool priority,
+                      const std::function<void()> &onCached = std::function<void()>());
+
+    /** \brief Whether the slice of key is queued or resliced in the background at the moment. */
+    bool IsSliceRequested(const SliceKey &key) const;
+
+    /** \brief Removes all cached slices and queued requests. */
+    void Clear();
+
+  private:
+    struct SliceRequest
+    {
+      SliceKey key;
+      Image::ConstPointer image;
+      Image::ImageDataItemPointer volumeData;
+      Image::Pointer volume;
+      PlaneGeometry::Pointer planeGeometry;
+      BaseGeometry::Pointer referenceGeometry;
+      bool priority;
+      std::function<void()> onCached;
+    };
+
+    typedef std::list<std::pair<SliceKey, SliceConstPointer>> SliceListType;
+
+    ImageSliceCache(const ImageSliceCache &) = delete;
+    ImageSliceCache &operator=(const ImageSliceCache &) = delete;
+
+    /** Inserts slice as most recently used and evicts slices beyond the memory limit. m_Mutex must be locked. */
+    void InsertSlice(const SliceKey &key, const SliceConstPointer &slice);
+
+    /** Reslices the requested slices one after another until there are no more requests. */
+    void ProcessRequests();
+
+    /** Returns a function calling first and then second; either may be empty. */
+    static std::function<void()> CombineCallbacks(const std::function<void()> &first,
+                                                  const std::function<void()> &second);
+
+    static SliceConstPointer Reslice(const SliceRequest &request);
+
+    mutable std::mutex m_Mutex;
+    SliceListType m_Slices;
+    size_t m_MemorySize;
+    size_t m_MaximumMemorySize;
+
+    std::deque<SliceRequest> m_Requests;
+    SliceKey m_KeyInProgress;
+    std::function<void()> m_OnCachedInProgress;
+    std::thread m_Worker;
+    bool m_WorkerRunning;
+    bool m_Stop;
+  };
+}
+
+#endif
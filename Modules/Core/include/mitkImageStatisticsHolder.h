@@ -36,6 +36,11 @@ namespace mitk
     GetStatistics() method in mitk::Image class.
 
     Minimum or maximum might by infinite values. 2nd minimum and maximum are guaranteed to be finite values.
+
+    The extrema are computed separately for each time step, when they are requested for the first time.
+    Large images are split into chunks along their slowest dimension, which are processed on all cores.
+    For vector images, the extrema of all components are computed in a single pass and kept, so that
+    switching between components does not touch the image again.
     */
   class MITKCORE_EXPORT ImageStatisticsHolder
   {
@@ -141,6 +146,25 @@ namespace mitk
 
     bool IsValidTimeStep(int t) const;
 
+    /** \brief Extrema of the values of a part of an image, as accumulated by _ComputeExtremaInItkImage() */
+    struct ExtremaType
+    {
+      ExtremaType();
+
+      /** \brief Adds a single value */
+      void Add(ScalarType value);
+
+      /** \brief Adds all values of another part of the image */
+      void Merge(const ExtremaType &other);
+
+      ScalarType min;
+      ScalarType secondMin;
+      ScalarType max;
+      ScalarType secondMax;
+      unsigned int countOfMin;
+      unsigned int countOfMax;
+    };
+
     template <typename ItkImageType>
     friend void _ComputeExtremaInItkImage(const ItkImageType *itkImage,
                                           mitk::ImageStatisticsHolder *statisticsHolder,
@@ -159,6 +183,9 @@ namespace mitk
 
     virtual void Expand(unsigned int timeSteps);
 
+    /** \brief Stores the extrema of time step t, which can then be queried by the getters. */
+    void SetExtrema(int t, const ExtremaType &extrema);
+
     ImageTimeSelector::Pointer GetTimeSelector();
 
     mitk::Image *m_Image;
@@ -173,6 +200,9 @@ namespace mitk
     mutable std::vector<ScalarType> m_Scalar2ndMin;
     mutable std::vector<ScalarType> m_Scalar2ndMax;
 
+    /** Extrema of all components of vector images, per time step. Empty for scalar images and not yet computed time steps. */
+    std::vector<std::vector<ExtremaType>> m_ComponentExtrema;
+
     itk::TimeStamp m_LastRecomputeTimeStamp;
   };
 
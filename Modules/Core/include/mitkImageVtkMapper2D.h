@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK Rendering
 #include "mitkBaseRenderer.h"
 #include "mitkExtractSliceFilter.h"
+#include "mitkImageSliceCache.h"
 #include "mitkVtkMapper.h"
 
 // VTK
@@ -92,6 +93,12 @@ namespace mitk
    *   - \b "texture interpolation": (BoolProperty) texture interpolation of the image
    *   - \b "reslice interpolation": (VtkResliceInterpolationProperty) reslice interpolation of the image
    *   - \b "in plane resample extent by geometry": (BoolProperty) Do it or not
+   *   - \b "Image Rendering.Prefetched Slices": (IntProperty) Number of neighbouring slices on each side which are
+   *          resliced in the background whenever another slice is shown, so that scrolling shows them without delay.
+   *          Best set for the image the user scrolls through only, as all prefetched slices share the memory of
+   *          the slice cache
+   *   - \b "Image Rendering.Asynchronous Reslicing": (BoolProperty) Reslice in the background and keep showing the
+   *          previous slice until the new one is ready, instead of blocking the render window
    *   - \b "bounding box": (BoolProperty) Is the Bounding Box of the image shown or not
    *   - \b "layer": (IntProperty) Layer of the image
    *   - \b "volume annotation color": (ColorProperty) color of the volume annotation, TODO has to be reimplemented
@@ -107,6 +114,8 @@ namespace mitk
    *   - \b "texture interpolation", mitk::BoolProperty::New( false ) )
    *   - \b "reslice interpolation", mitk::VtkResliceInterpolationProperty::New() )
    *   - \b "in plane resample extent by geometry", mitk::BoolProperty::New( false ) )
+   *   - \b "Image Rendering.Prefetched Slices", mitk::IntProperty::New( 0 ), renderer, overwrite )
+   *   - \b "Image Rendering.Asynchronous Reslicing", mitk::BoolProperty::New( false ), renderer, overwrite )
    *   - \b "bounding box", mitk::BoolProperty::New( false ) )
    *   - \b "layer", mitk::IntProperty::New(10), renderer, overwrite)
    *   - \b "Image Rendering.Transfer Function":  Default color transfer function for CTs
@@ -115,6 +124,12 @@ namespace mitk
    * If the modality-property is set for an image, the mapper uses modality-specific default properties,
    * e.g. color maps, if they are defined.
 
+   * Slices which are prefetched or resliced asynchronously are kept in the ImageSliceCache shared by all
+   * mappers, so that showing them does not reslice the image again. Slices resliced synchronously by the
+   * mapper are not cached. Thick slices and curved planes are always resliced. The asynchronous mode needs
+   * a registered CallbackFromGUIThread implementation (which Qt based applications have) to render again
+   * once the requested slice is ready.
+
    * \ingroup Mapper
    */
   class MITKCORE_EXPORT ImageVtkMapper2D : public VtkMapper
@@ -190,6 +205,17 @@ namespace mitk
       /** \brief This filter is used to apply the level window to Grayvalue and RBG(A) images. */
       vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
 
+      /** \brief Slice of the cache which is shown, nullptr if the shown slice was resliced by the mapper. */
+      mitk::ImageSliceCache::SliceConstPointer m_CurrentSlice;
+      /** \brief Key of the shown slice, invalid if it cannot be cached (e.g. thick slices). */
+      mitk::ImageSliceCache::SliceKey m_CurrentSliceKey;
+      /** \brief Spacing of m_CurrentSlice, m_mmPerPixel points to it while a cached slice is shown. */
+      mitk::ScalarType m_CurrentSliceSpacing[2];
+      /** \brief Key of the slice which is resliced asynchronously and not shown yet. */
+      mitk::ImageSliceCache::SliceKey m_PendingSliceKey;
+      /** \brief Index of the slice of the world geometry whose neighbours were prefetched last. */
+      int m_LastPrefetchedSlice;
+
       /** \brief Default constructor of the local storage. */
       LocalStorage();
       /** \brief Default deconstructor of the local storage. */
@@ -303,6 +329,17 @@ namespace mitk
       * If the distances have different sign, there is an intersection.
       **/
     bool RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry, SlicedGeometry3D *imageGeometry);
+
+    /**
+      * \brief Requests the neighbouring slices of the current slice of the renderer's world geometry
+      * from the slice cache, the ones in the direction of scrolling first.
+      *
+      * Does nothing unless the current slice changed since the last call, i.e. unless the user scrolls.
+      */
+    void PrefetchNeighbouringSlices(mitk::BaseRenderer *renderer,
+                                    int numberOfSlices,
+                                    ExtractSliceFilter::ResliceInterpolation interpolation,
+                                    bool inPlaneResampleExtentByGeometry);
   };
 
 } // namespace mitk
@@ -29,6 +29,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #pragma GCC visibility pop
 
 #include <deque>
+#include <string>
 
 namespace mitk
 {
@@ -103,6 +104,37 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     void SetUndoLimit(std::size_t limit) override;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory occupied by the undo history in bytes.
+    //## If the value is 0 that means that there is no limit. Default is an eighth of the physical memory.
+    std::size_t GetUndoMemoryLimit() const;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory occupied by the undo history.
+    //## The memory of an item is reported by UndoStackItem::GetMemorySize(), e.g. the
+    //## compressed slices of segmentation operations. If the limit is exceeded, the oldest
+    //## groups of items (see UndoStackItem::GetGroupEventId()) are swapped out to disk (see
+    //## SetSwapToDisk()) or dropped from the bottom of the undo stack. The most recent group
+    //## is always kept, even if it exceeds the limit.
+    //## The 0 value means that there is no limit.
+    //## @param limit the maximum number of bytes held in memory by the undo stack
+    void SetUndoMemoryLimit(std::size_t limit);
+
+    //##Documentation
+    //## @brief Returns the number of bytes currently held in memory by the undo stack
+    std::size_t GetUndoMemorySize() const;
+
+    //##Documentation
+    //## @brief If enabled, old items exceeding the memory limit are moved to
+    //## temporary files instead of being dropped. Default is false.
+    void SetSwapToDisk(bool swapToDisk);
+    bool GetSwapToDisk() const;
+
+    //##Documentation
+    //## @brief Directory for the swap files, the default temp path if empty
+    void SetSwapDirectory(const std::string &directory);
+    std::string GetSwapDirectory() const;
+
     //##Documentation
     //## @brief Returns the ObjectEventId of the
     //## top element in the OperationHistory
@@ -138,8 +170,17 @@ namespace mitk
   private:
     int FirstObjectEventIdOfCurrentGroup(UndoContainer &stack);
 
+    //## @brief Swaps out or drops the oldest groups of undo items until the memory limit is met
+    void EnforceUndoMemoryLimit();
+
     std::size_t m_UndoLimit;
 
+    std::size_t m_UndoMemoryLimit;
+
+    bool m_SwapToDisk;
+
+    std::string m_SwapDirectory;
+
   };
 
 #pragma GCC visibility push(default)
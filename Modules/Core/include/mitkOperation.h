@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkCommon.h>
 
+#include <string>
+
 namespace mitk
 {
   typedef int OperationType;
@@ -43,6 +45,21 @@ namespace mitk
 
     OperationType GetOperationType();
 
+    //##Documentation
+    //## @brief Returns the number of bytes of data held in memory by this operation.
+    //##
+    //## Used by undo models to keep the undo history within a memory budget. Operations
+    //## holding no significant amount of data do not need to reimplement this (returns 0).
+    virtual std::size_t GetMemorySize() const;
+
+    //##Documentation
+    //## @brief Moves the data held by this operation to disk to free memory.
+    //##
+    //## The operation must still be executable afterwards. Returns false, if the operation
+    //## does not support swapping or nothing was swapped out.
+    //## @param directory directory for the swap files, the default temp path if empty
+    virtual bool SwapOut(const std::string &directory);
+
   protected:
     OperationType m_OperationType;
   };
@@ -78,6 +78,14 @@ namespace mitk
     virtual void ReverseOperations();
     virtual void ReverseAndExecute();
 
+    //##Documentation
+    //## @brief Returns the number of bytes of undo data held in memory by this item
+    virtual std::size_t GetMemorySize() const;
+
+    //##Documentation
+    //## @brief Moves the undo data of this item to disk, see Operation::SwapOut()
+    virtual bool SwapOut(const std::string &directory);
+
     //##Documentation
     //## @brief Increases the current ObjectEventId
     //## For example if a button click generates operations the ObjectEventId has to be incremented to be able to undo
@@ -170,6 +178,12 @@ namespace mitk
     //##reverses and executes both operations (used, when moved from undo to redo stack)
     void ReverseAndExecute() override;
 
+    //## @brief Sum of the memory size of operation and undo operation
+    std::size_t GetMemorySize() const override;
+
+    //## @brief Swaps out operation and undo operation
+    bool SwapOut(const std::string &directory) override;
+
     //## @brief returns true if the destination still is present
     //## and false if it already has been deleted
     virtual bool IsValid();
@@ -0,0 +1,47 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPARALLELFOR_H
+#define MITKPARALLELFOR_H
+
+#include <MitkCoreExports.h>
+
+#include <functional>
+
+namespace mitk
+{
+  /**
+    \brief Calls task(i) for i = 0..numberOfTasks-1 on the threads of an itk::MultiThreader.
+
+    The threads take the next index from a shared counter, so tasks of different duration are balanced. The
+    calling thread takes part as the first thread. At most maximumNumberOfThreads threads are used, or
+    itk::MultiThreader::GetGlobalDefaultNumberOfThreads() if it is 0, so the global ITK setting (e.g. the
+    environment variable ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS) limits all users of this function.
+
+    If a task throws, no further tasks are started and the first exception is rethrown after all threads
+    finished.
+  */
+  MITKCORE_EXPORT void ParallelFor(unsigned int numberOfTasks,
+                                   const std::function<void(unsigned int)> &task,
+                                   unsigned int maximumNumberOfThreads = 0);
+
+  /**
+    \brief Number of threads ParallelFor() uses for the given maximum (0: the global ITK default).
+  */
+  MITKCORE_EXPORT unsigned int GetParallelForNumberOfThreads(unsigned int maximumNumberOfThreads = 0);
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkParallelFor.h"
+
+#include <itkMultiThreader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+namespace
+{
+  struct ParallelForStruct
+  {
+    unsigned int NumberOfTasks;
+    const std::function<void(unsigned int)> *Task;
+    std::atomic<unsigned int> NextTask;
+    std::exception_ptr Exception;
+    std::mutex ExceptionMutex;
+  };
+
+  void RunTasks(ParallelForStruct &str)
+  {
+    for (unsigned int i = str.NextTask++; i < str.NumberOfTasks; i = str.NextTask++)
+    {
+      try
+      {
+        (*str.Task)(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(str.ExceptionMutex);
+        if (!str.Exception)
+          str.Exception = std::current_exception();
+        str.NextTask = str.NumberOfTasks;
+      }
+    }
+  }
+
+  ITK_THREAD_RETURN_TYPE ParallelForThreaderCallback(void *arg)
+  {
+    auto *threadInfo = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+    RunTasks(*static_cast<ParallelForStruct *>(threadInfo->UserData));
+    return ITK_THREAD_RETURN_VALUE;
+  }
+}
+
+unsigned int mitk::GetParallelForNumberOfThreads(unsigned int maximumNumberOfThreads)
+{
+  if (maximumNumberOfThreads == 0)
+    maximumNumberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  return std::max(1u, std::min(maximumNumberOfThreads, itk::MultiThreader::GetGlobalMaximumNumberOfThreads()));
+}
+
+void mitk::ParallelFor(unsigned int numberOfTasks,
+                       const std::function<void(unsigned int)> &task,
+                       unsigned int maximumNumberOfThreads)
+{
+  const unsigned int numberOfThreads =
+    std::min(numberOfTasks, GetParallelForNumberOfThreads(maximumNumberOfThreads));
+
+  if (numberOfThreads <= 1)
+  {
+    for (unsigned int i = 0; i < numberOfTasks; ++i)
+      task(i);
+    return;
+  }
+
+  ParallelForStruct str;
+  str.NumberOfTasks = numberOfTasks;
+  str.Task = &task;
+  str.NextTask = 0;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(ParallelForThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  if (str.Exception)
+    std::rethrow_exception(str.Exception);
+}
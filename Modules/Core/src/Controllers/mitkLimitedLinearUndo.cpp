@@ -15,10 +15,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkLimitedLinearUndo.h"
+#include <mitkMemoryUtilities.h>
 #include <mitkRenderingManager.h>
 
+#include <algorithm>
+
 mitk::LimitedLinearUndo::LimitedLinearUndo()
-: m_UndoLimit(0)
+: m_UndoLimit(0), m_UndoMemoryLimit(MemoryUtilities::GetTotalSizeOfPhysicalRam() / 8), m_SwapToDisk(false)
 {
   // nothing to do
 }
@@ -61,6 +64,8 @@ bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
   }
   m_UndoList.push_back(operationEvent);
 
+  this->EnforceUndoMemoryLimit();
+
   InvokeEvent(UndoNotEmptyEvent());
 
   return true;
@@ -186,14 +191,97 @@ void mitk::LimitedLinearUndo::SetUndoLimit(std::size_t undoLimit)
 {
   if (undoLimit != m_UndoLimit)
   {
-    if (m_UndoList.size() > undoLimit)
+    if (0 != undoLimit)
     {
-      m_UndoList.erase(m_UndoList.begin(), m_UndoList.end() - undoLimit);
+      while (m_UndoList.size() > undoLimit)
+      {
+        auto item = m_UndoList.front();
+        m_UndoList.pop_front();
+        delete item;
+      }
     }
     m_UndoLimit = undoLimit;
   }
 }
 
+std::size_t mitk::LimitedLinearUndo::GetUndoMemoryLimit() const
+{
+  return m_UndoMemoryLimit;
+}
+
+void mitk::LimitedLinearUndo::SetUndoMemoryLimit(std::size_t limit)
+{
+  if (limit != m_UndoMemoryLimit)
+  {
+    m_UndoMemoryLimit = limit;
+    this->EnforceUndoMemoryLimit();
+  }
+}
+
+std::size_t mitk::LimitedLinearUndo::GetUndoMemorySize() const
+{
+  std::size_t size = 0;
+  for (auto item : m_UndoList)
+    size += item->GetMemorySize();
+  return size;
+}
+
+void mitk::LimitedLinearUndo::SetSwapToDisk(bool swapToDisk)
+{
+  m_SwapToDisk = swapToDisk;
+}
+
+bool mitk::LimitedLinearUndo::GetSwapToDisk() const
+{
+  return m_SwapToDisk;
+}
+
+void mitk::LimitedLinearUndo::SetSwapDirectory(const std::string &directory)
+{
+  m_SwapDirectory = directory;
+}
+
+std::string mitk::LimitedLinearUndo::GetSwapDirectory() const
+{
+  return m_SwapDirectory;
+}
+
+void mitk::LimitedLinearUndo::EnforceUndoMemoryLimit()
+{
+  if (0 == m_UndoMemoryLimit || m_UndoList.empty())
+    return;
+
+  std::size_t size = this->GetUndoMemorySize();
+
+  // the most recent group stays in memory, it is the one most likely to be undone. Older groups are
+  // swapped out or dropped as a whole, so Undo(false) never finds an incomplete group.
+  const int newestGroupEventId = m_UndoList.back()->GetGroupEventId();
+
+  if (m_SwapToDisk)
+  {
+    for (std::size_t i = 0;
+         size > m_UndoMemoryLimit && i < m_UndoList.size() && m_UndoList[i]->GetGroupEventId() != newestGroupEventId;
+         ++i)
+    {
+      std::size_t itemSize = m_UndoList[i]->GetMemorySize();
+      if (itemSize > 0 && m_UndoList[i]->SwapOut(m_SwapDirectory))
+        size -= itemSize - std::min(itemSize, m_UndoList[i]->GetMemorySize());
+    }
+  }
+
+  while (size > m_UndoMemoryLimit && m_UndoList.front()->GetGroupEventId() != newestGroupEventId)
+  {
+    const int groupEventId = m_UndoList.front()->GetGroupEventId();
+    while (m_UndoList.front()->GetGroupEventId() == groupEventId)
+    {
+      auto item = m_UndoList.front();
+      size -= std::min(size, item->GetMemorySize());
+      m_UndoList.pop_front();
+      delete item;
+    }
+  }
+}
+
 int mitk::LimitedLinearUndo::GetLastObjectEventIdInList()
 {
   return m_UndoList.back()->GetObjectEventId();
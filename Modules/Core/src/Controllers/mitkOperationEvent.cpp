@@ -76,6 +76,16 @@ void mitk::UndoStackItem::ReverseAndExecute()
   ReverseOperations();
 }
 
+std::size_t mitk::UndoStackItem::GetMemorySize() const
+{
+  return 0;
+}
+
+bool mitk::UndoStackItem::SwapOut(const std::string &)
+{
+  return false;
+}
+
 // ******************** mitk::OperationEvent ********************
 
 mitk::Operation *mitk::OperationEvent::GetOperation()
@@ -138,6 +148,26 @@ void mitk::OperationEvent::ReverseAndExecute()
     m_Destination->ExecuteOperation(m_Operation);
 }
 
+std::size_t mitk::OperationEvent::GetMemorySize() const
+{
+  std::size_t size = 0;
+  if (m_Operation)
+    size += m_Operation->GetMemorySize();
+  if (m_UndoOperation)
+    size += m_UndoOperation->GetMemorySize();
+  return size;
+}
+
+bool mitk::OperationEvent::SwapOut(const std::string &directory)
+{
+  bool swapped = false;
+  if (m_Operation)
+    swapped = m_Operation->SwapOut(directory) || swapped;
+  if (m_UndoOperation)
+    swapped = m_UndoOperation->SwapOut(directory) || swapped;
+  return swapped;
+}
+
 mitk::OperationActor *mitk::OperationEvent::GetDestination()
 {
   return m_Destination;
@@ -45,7 +45,8 @@ mitk::Image::Image()
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_AccessorContentionCount(0)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -60,7 +61,8 @@ mitk::Image::Image(const Image &other)
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_AccessorContentionCount(0)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
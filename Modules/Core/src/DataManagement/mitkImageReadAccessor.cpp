@@ -67,8 +67,10 @@ mitk::ImageReadAccessor::~ImageReadAccessor()
     m_Image->m_ReadWriteLock.Lock();
 
     // delete self from list of ImageReadAccessors in Image
+    // (the order of the list is irrelevant, so avoid shifting all remaining readers)
     auto it = std::find(m_Image->m_Readers.begin(), m_Image->m_Readers.end(), this);
-    m_Image->m_Readers.erase(it);
+    *it = m_Image->m_Readers.back();
+    m_Image->m_Readers.pop_back();
 
     // delete lock, if there are no waiting ImageAccessors
     if (m_WaitLock->m_WaiterCount <= 0)
@@ -116,6 +118,7 @@ void mitk::ImageReadAccessor::OrganizeReadAccess()
         if (!(m_Options & ExceptionIfLocked))
         {
           PreventRecursiveMutexLock(w);
+          ++m_Image->m_AccessorContentionCount;
 
           // WAIT
           w->Increment();
@@ -129,6 +132,7 @@ void mitk::ImageReadAccessor::OrganizeReadAccess()
         else
         {
           // THROW EXCEPTION
+          ++m_Image->m_AccessorContentionCount;
           m_Image->m_ReadWriteLock.Unlock();
           mitkThrowException(mitk::MemoryIsLockedException)
             << "The image part being ordered by the ImageAccessor is already in use and locked";
@@ -138,7 +142,8 @@ void mitk::ImageReadAccessor::OrganizeReadAccess()
     }   // for
   }     // if
 
-  // Now, we know, that there is no conflict with a Write-Access
+  // Now, we know, that there is no conflict with a Write-Access. Other readers never conflict with this one, so read
+  // access is shared and m_Readers does not have to be inspected at all.
   // Lock the Mutex in ImageAccessorBase, to make sure that every other ImageAccessor has to wait if it locks the mutex
   m_WaitLock->m_Mutex.Lock();
 
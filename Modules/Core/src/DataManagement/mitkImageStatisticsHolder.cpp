@@ -27,6 +27,7 @@ mitk::ImageStatisticsHolder::ImageStatisticsHolder(mitk::Image *image)
   m_ScalarMax.resize(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
   m_Scalar2ndMin.resize(1, itk::NumericTraits<ScalarType>::max());
   m_Scalar2ndMax.resize(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
+  m_ComponentExtrema.resize(1);
 
   mitk::HistogramGenerator::Pointer generator = mitk::HistogramGenerator::New();
   m_HistogramGeneratorObject = generator;
@@ -85,6 +86,7 @@ void mitk::ImageStatisticsHolder::Expand(unsigned int timeSteps)
     m_Scalar2ndMax.resize(timeSteps, itk::NumericTraits<ScalarType>::NonpositiveMin());
     m_CountOfMinValuedVoxels.resize(timeSteps, 0);
     m_CountOfMaxValuedVoxels.resize(timeSteps, 0);
+    m_ComponentExtrema.resize(timeSteps);
   }
 }
 
@@ -96,11 +98,143 @@ void mitk::ImageStatisticsHolder::ResetImageStatistics()
   m_Scalar2ndMax.assign(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
   m_CountOfMinValuedVoxels.assign(1, 0);
   m_CountOfMaxValuedVoxels.assign(1, 0);
+  m_ComponentExtrema.assign(1, std::vector<ExtremaType>());
 }
 
 #include "mitkImageAccessByItk.h"
+#include "mitkParallelFor.h"
 
-//#define BOUNDINGOBJECT_IGNORE
+#include <itkImageScanlineConstIterator.h>
+
+#include <algorithm>
+
+namespace
+{
+  // below this number of voxels per chunk, starting threads takes longer than visiting the voxels
+  const itk::SizeValueType MINIMUM_NUMBER_OF_VOXELS_PER_CHUNK = 256 * 1024;
+
+  /** Splits region along its slowest dimension into chunks of at least MINIMUM_NUMBER_OF_VOXELS_PER_CHUNK voxels. */
+  template <typename RegionType>
+  std::vector<RegionType> SplitIntoChunks(const RegionType &region)
+  {
+    const unsigned int slowestDimension = RegionType::ImageDimension - 1;
+    const itk::SizeValueType numberOfLayers = region.GetSize(slowestDimension);
+    if (numberOfLayers == 0)
+      return std::vector<RegionType>();
+
+    const itk::SizeValueType voxelsPerLayer = std::max<itk::SizeValueType>(1, region.GetNumberOfPixels() / numberOfLayers);
+    const itk::SizeValueType layersPerChunk =
+      std::max<itk::SizeValueType>(1, MINIMUM_NUMBER_OF_VOXELS_PER_CHUNK / voxelsPerLayer);
+
+    std::vector<RegionType> chunks;
+    for (itk::SizeValueType layer = 0; layer < numberOfLayers; layer += layersPerChunk)
+    {
+      RegionType chunk = region;
+      chunk.SetIndex(slowestDimension, region.GetIndex(slowestDimension) + static_cast<itk::IndexValueType>(layer));
+      chunk.SetSize(slowestDimension, std::min(layersPerChunk, numberOfLayers - layer));
+      chunks.push_back(chunk);
+    }
+    return chunks;
+  }
+}
+
+mitk::ImageStatisticsHolder::ExtremaType::ExtremaType()
+  : min(itk::NumericTraits<ScalarType>::max()),
+    secondMin(itk::NumericTraits<ScalarType>::max()),
+    max(itk::NumericTraits<ScalarType>::NonpositiveMin()),
+    secondMax(itk::NumericTraits<ScalarType>::NonpositiveMin()),
+    countOfMin(0),
+    countOfMax(0)
+{
+}
+
+void mitk::ImageStatisticsHolder::ExtremaType::Add(ScalarType value)
+{
+  // update min
+  if (value < min)
+  {
+    secondMin = min;
+    min = value;
+    countOfMin = 1;
+  }
+  else if (value == min)
+  {
+    ++countOfMin;
+  }
+  else if (value < secondMin)
+  {
+    secondMin = value;
+  }
+
+  // update max
+  if (value > max)
+  {
+    secondMax = max;
+    max = value;
+    countOfMax = 1;
+  }
+  else if (value == max)
+  {
+    ++countOfMax;
+  }
+  else if (value > secondMax)
+  {
+    secondMax = value;
+  }
+}
+
+void mitk::ImageStatisticsHolder::ExtremaType::Merge(const ExtremaType &other)
+{
+  // merge min
+  if (other.min < min)
+  {
+    secondMin = std::min(min, other.secondMin);
+    min = other.min;
+    countOfMin = other.countOfMin;
+  }
+  else if (other.min == min)
+  {
+    secondMin = std::min(secondMin, other.secondMin);
+    countOfMin += other.countOfMin;
+  }
+  else
+  {
+    secondMin = std::min(secondMin, other.min);
+  }
+
+  // merge max
+  if (other.max > max)
+  {
+    secondMax = std::max(max, other.secondMax);
+    max = other.max;
+    countOfMax = other.countOfMax;
+  }
+  else if (other.max == max)
+  {
+    secondMax = std::max(secondMax, other.secondMax);
+    countOfMax += other.countOfMax;
+  }
+  else
+  {
+    secondMax = std::max(secondMax, other.max);
+  }
+}
+
+void mitk::ImageStatisticsHolder::SetExtrema(int t, const ExtremaType &extrema)
+{
+  m_ScalarMin[t] = extrema.min;
+  m_ScalarMax[t] = extrema.max;
+  m_Scalar2ndMin[t] = extrema.secondMin;
+  m_Scalar2ndMax[t] = extrema.secondMax;
+  m_CountOfMinValuedVoxels[t] = extrema.countOfMin;
+  m_CountOfMaxValuedVoxels[t] = extrema.countOfMax;
+
+  //// guard for wrong 2dMin/Max on single constant value images
+  if (m_ScalarMax[t] == m_ScalarMin[t])
+  {
+    m_Scalar2ndMax[t] = m_Scalar2ndMin[t] = m_ScalarMax[t];
+  }
+}
 
 template <typename ItkImageType>
 void mitk::_ComputeExtremaInItkImage(const ItkImageType *itkImage, mitk::ImageStatisticsHolder *statisticsHolder, int t)
@@ -112,70 +246,33 @@ void mitk::_ComputeExtremaInItkImage(const ItkImageType *itkImage, mitk::ImageSt
   if (region != itkImage->GetRequestedRegion())
     return;
 
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-  typedef typename ItkImageType::PixelType TPixel;
-  TPixel value = 0;
-
   if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
     return;
   statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-  statisticsHolder->m_CountOfMinValuedVoxels[t] = 0;
-  statisticsHolder->m_CountOfMaxValuedVoxels[t] = 0;
 
-  statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t] = itk::NumericTraits<ScalarType>::max();
-  statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t] =
-    itk::NumericTraits<ScalarType>::NonpositiveMin();
+  // every chunk gets its own partial extrema, which are merged afterwards
+  const auto chunks = SplitIntoChunks(region);
+  std::vector<ImageStatisticsHolder::ExtremaType> partialExtrema(chunks.size());
 
-  while (!it.IsAtEnd())
-  {
-    value = it.Get();
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765)
+  mitk::ParallelFor(static_cast<unsigned int>(chunks.size()), [&](unsigned int i) {
+    ImageStatisticsHolder::ExtremaType &extrema = partialExtrema[i];
+    itk::ImageScanlineConstIterator<ItkImageType> it(itkImage, chunks[i]);
+    while (!it.IsAtEnd())
     {
-#endif
-      // update min
-      if (value < statisticsHolder->m_ScalarMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t];
-        statisticsHolder->m_ScalarMin[t] = value;
-        statisticsHolder->m_CountOfMinValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMin[t])
-      {
-        ++statisticsHolder->m_CountOfMinValuedVoxels[t];
-      }
-      else if (value < statisticsHolder->m_Scalar2ndMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = value;
-      }
-
-      // update max
-      if (value > statisticsHolder->m_ScalarMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t];
-        statisticsHolder->m_ScalarMax[t] = value;
-        statisticsHolder->m_CountOfMaxValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMax[t])
+      while (!it.IsAtEndOfLine())
       {
-        ++statisticsHolder->m_CountOfMaxValuedVoxels[t];
+        extrema.Add(it.Get());
+        ++it;
       }
-      else if (value > statisticsHolder->m_Scalar2ndMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
+      it.NextLine();
     }
-#endif
+  });
 
-    ++it;
-  }
+  ImageStatisticsHolder::ExtremaType extrema;
+  for (const auto &partial : partialExtrema)
+    extrema.Merge(partial);
 
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (statisticsHolder->m_ScalarMax[t] == statisticsHolder->m_ScalarMin[t])
-  {
-    statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMax[t];
-  }
+  statisticsHolder->SetExtrema(t, extrema);
   statisticsHolder->m_LastRecomputeTimeStamp.Modified();
 }
 
@@ -192,68 +289,45 @@ void mitk::_ComputeExtremaInItkVectorImage(const ItkImageType *itkImage,
   if (region != itkImage->GetRequestedRegion())
     return;
 
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-
   if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
     return;
+
+  const unsigned int numberOfComponents = itkImage->GetNumberOfComponentsPerPixel();
+  if (component >= numberOfComponents)
+    return;
+
   statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-  statisticsHolder->m_CountOfMinValuedVoxels[t] = 0;
-  statisticsHolder->m_CountOfMaxValuedVoxels[t] = 0;
 
-  statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t] = itk::NumericTraits<ScalarType>::max();
-  statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t] =
-    itk::NumericTraits<ScalarType>::NonpositiveMin();
+  // all components at once, so that the image is visited only once when the displayed component changes
+  const auto chunks = SplitIntoChunks(region);
+  std::vector<std::vector<ImageStatisticsHolder::ExtremaType>> partialExtrema(
+    chunks.size(), std::vector<ImageStatisticsHolder::ExtremaType>(numberOfComponents));
 
-  while (!it.IsAtEnd())
-  {
-    double value = it.Get()[component];
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765)
+  mitk::ParallelFor(static_cast<unsigned int>(chunks.size()), [&](unsigned int i) {
+    std::vector<ImageStatisticsHolder::ExtremaType> &extrema = partialExtrema[i];
+    itk::ImageScanlineConstIterator<ItkImageType> it(itkImage, chunks[i]);
+    while (!it.IsAtEnd())
     {
-#endif
-      // update min
-      if (value < statisticsHolder->m_ScalarMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t];
-        statisticsHolder->m_ScalarMin[t] = value;
-        statisticsHolder->m_CountOfMinValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMin[t])
-      {
-        ++statisticsHolder->m_CountOfMinValuedVoxels[t];
-      }
-      else if (value < statisticsHolder->m_Scalar2ndMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = value;
-      }
-
-      // update max
-      if (value > statisticsHolder->m_ScalarMax[t])
+      while (!it.IsAtEndOfLine())
       {
-        statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t];
-        statisticsHolder->m_ScalarMax[t] = value;
-        statisticsHolder->m_CountOfMaxValuedVoxels[t] = 1;
+        const auto value = it.Get();
+        for (unsigned int c = 0; c < numberOfComponents; ++c)
+          extrema[c].Add(value[c]);
+        ++it;
       }
-      else if (value == statisticsHolder->m_ScalarMax[t])
-      {
-        ++statisticsHolder->m_CountOfMaxValuedVoxels[t];
-      }
-      else if (value > statisticsHolder->m_Scalar2ndMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
+      it.NextLine();
     }
-#endif
-
-    ++it;
-  }
+  });
 
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (statisticsHolder->m_ScalarMax[t] == statisticsHolder->m_ScalarMin[t])
+  std::vector<ImageStatisticsHolder::ExtremaType> extrema(numberOfComponents);
+  for (const auto &partial : partialExtrema)
   {
-    statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMax[t];
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+      extrema[c].Merge(partial[c]);
   }
+
+  statisticsHolder->m_ComponentExtrema[t] = extrema;
+  statisticsHolder->SetExtrema(t, extrema[component]);
   statisticsHolder->m_LastRecomputeTimeStamp.Modified();
 }
 
@@ -269,6 +343,14 @@ void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int com
 
   Expand(t + 1);
 
+  // vector images: the extrema of all components were computed together
+  if (!m_ComponentExtrema[t].empty())
+  {
+    if (component < m_ComponentExtrema[t].size())
+      this->SetExtrema(t, m_ComponentExtrema[t][component]);
+    return;
+  }
+
   // do we have valid information already?
   if (m_ScalarMin[t] != itk::NumericTraits<ScalarType>::max() ||
       m_Scalar2ndMin[t] != itk::NumericTraits<ScalarType>::max())
@@ -30,9 +30,11 @@ mitk::ImageWriteAccessor::~ImageWriteAccessor()
 
   m_Image->m_ReadWriteLock.Lock();
 
-  // delete self from list of ImageReadAccessors in Image
+  // delete self from list of ImageWriteAccessors in Image
+  // (the order of the list is irrelevant, so avoid shifting all remaining writers)
   auto it = std::find(m_Image->m_Writers.begin(), m_Image->m_Writers.end(), this);
-  m_Image->m_Writers.erase(it);
+  *it = m_Image->m_Writers.back();
+  m_Image->m_Writers.pop_back();
 
   // delete lock, if there are no waiting ImageAccessors
   if (m_WaitLock->m_WaiterCount <= 0)
@@ -87,7 +89,7 @@ void mitk::ImageWriteAccessor::OrganizeWriteAccess()
   }     // if
 
   // Check, if there is any Write-Access going on
-  if (m_Image->m_Writers.size() > 0)
+  if (!readOverlap && m_Image->m_Writers.size() > 0)
   {
     // Check for every WriteAccessor, if the Region of this ImageAccessors overlaps
     // make sure this iterator is not used, when m_ReadWriteLock is Unlocked!
@@ -114,6 +116,8 @@ void mitk::ImageWriteAccessor::OrganizeWriteAccess()
 
   if (readOverlap || writeOverlap)
   {
+    ++m_Image->m_AccessorContentionCount;
+
     // Throw an exception or wait for the WriteAccessor w until it is released and start again with the request
     // afterwards.
     if (!(m_Options & ExceptionIfLocked))
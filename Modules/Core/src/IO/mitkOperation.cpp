@@ -28,3 +28,13 @@ mitk::OperationType mitk::Operation::GetOperationType()
 {
   return m_OperationType;
 }
+
+std::size_t mitk::Operation::GetMemorySize() const
+{
+  return 0;
+}
+
+bool mitk::Operation::SwapOut(const std::string &)
+{
+  return false;
+}
@@ -0,0 +1,420 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageSliceCache.h"
+
+#include <mitkAbstractTransformGeometry.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkLogMacros.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace
+{
+  size_t GetMemorySize(const mitk::ImageSliceCache::SliceConstPointer &slice)
+  {
+    return static_cast<size_t>(slice->image->GetActualMemorySize()) * 1024;
+  }
+}
+
+mitk::ImageSliceCache::SliceKey::SliceKey()
+  : m_Image(nullptr),
+    m_ImageMTime(0),
+    m_TimeStepGeometryMTime(0),
+    m_TimeStep(0),
+    m_Interpolation(ExtractSliceFilter::RESLICE_NEAREST),
+    m_InPlaneResampleExtentByGeometry(false),
+    m_ReferenceGeometry(nullptr),
+    m_ReferenceGeometryMTime(0)
+{
+  std::fill(m_Plane, m_Plane + 18, 0.0);
+}
+
+mitk::ImageSliceCache::SliceKey::SliceKey(const Image *image,
+                                          int timeStep,
+                                          const PlaneGeometry *planeGeometry,
+                                          ExtractSliceFilter::ResliceInterpolation interpolation,
+                                          bool inPlaneResampleExtentByGeometry)
+  : SliceKey()
+{
+  // curved planes reslice with a transform of their own, which is not part of the key
+  if (image == nullptr || planeGeometry == nullptr ||
+      dynamic_cast<const AbstractTransformGeometry *>(planeGeometry) != nullptr)
+    return;
+
+  const BaseGeometry *timeStepGeometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+  if (timeStepGeometry == nullptr)
+    return;
+
+  m_ImageMTime = image->GetMTime();
+  m_TimeStepGeometryMTime = timeStepGeometry->GetMTime();
+  m_TimeStep = timeStep;
+  m_Interpolation = interpolation;
+  m_InPlaneResampleExtentByGeometry = inPlaneResampleExtentByGeometry;
+
+  // the renderers use copies of the planes of their world geometry, so planes are compared by value
+  const auto *indexToWorld = planeGeometry->GetIndexToWorldTransform();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (unsigned int j = 0; j < 3; ++j)
+      m_Plane[3 * i + j] = indexToWorld->GetMatrix()[i][j];
+    m_Plane[9 + i] = indexToWorld->GetOffset()[i];
+  }
+  const BaseGeometry::BoundsArrayType bounds = planeGeometry->GetBounds();
+  for (unsigned int i = 0; i < 6; ++i)
+    m_Plane[12 + i] = bounds[i];
+
+  m_ReferenceGeometry = planeGeometry->GetReferenceGeometry();
+  m_ReferenceGeometryMTime = m_ReferenceGeometry != nullptr ? m_ReferenceGeometry->GetMTime() : 0;
+
+  m_Image = image;
+}
+
+bool mitk::ImageSliceCache::SliceKey::operator==(const SliceKey &other) const
+{
+  return m_Image == other.m_Image && m_ImageMTime == other.m_ImageMTime &&
+         m_TimeStepGeometryMTime == other.m_TimeStepGeometryMTime && m_TimeStep == other.m_TimeStep &&
+         m_Interpolation == other.m_Interpolation &&
+         m_InPlaneResampleExtentByGeometry == other.m_InPlaneResampleExtentByGeometry &&
+         m_ReferenceGeometry == other.m_ReferenceGeometry &&
+         m_ReferenceGeometryMTime == other.m_ReferenceGeometryMTime &&
+         std::equal(m_Plane, m_Plane + 18, other.m_Plane);
+}
+
+mitk::ImageSliceCache *mitk::ImageSliceCache::GetInstance()
+{
+  static ImageSliceCache instance;
+  return &instance;
+}
+
+mitk::ImageSliceCache::ImageSliceCache()
+  : m_MemorySize(0), m_MaximumMemorySize(64 * 1024 * 1024), m_WorkerRunning(false), m_Stop(false)
+{
+}
+
+mitk::ImageSliceCache::~ImageSliceCache()
+{
+  this->Shutdown();
+}
+
+void mitk::ImageSliceCache::Shutdown()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+    m_Requests.clear();
+  }
+
+  if (m_Worker.joinable())
+    m_Worker.join();
+}
+
+void mitk::ImageSliceCache::SetMaximumMemorySize(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MaximumMemorySize = bytes;
+}
+
+size_t mitk::ImageSliceCache::GetMaximumMemorySize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumMemorySize;
+}
+
+mitk::ImageSliceCache::SliceConstPointer mitk::ImageSliceCache::GetSlice(const SliceKey &key)
+{
+  if (!key.IsValid())
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  for (auto it = m_Slices.begin(); it != m_Slices.end(); ++it)
+  {
+    if (it->first == key)
+    {
+      m_Slices.splice(m_Slices.begin(), m_Slices, it);
+      return m_Slices.front().second;
+    }
+  }
+
+  return nullptr;
+}
+
+mitk::ImageSliceCache::SliceConstPointer mitk::ImageSliceCache::AddSlice(const SliceKey &key,
+                                                                         vtkImageData *sliceImage,
+                                                                         const double bounds[6],
+                                                                         const ScalarType spacing[2],
+                                                                         vtkMatrix4x4 *resliceAxes)
+{
+  if (!key.IsValid() || sliceImage == nullptr || resliceAxes == nullptr)
+    return nullptr;
+
+  auto slice = std::make_shared<Slice>();
+  slice->image = vtkSmartPointer<vtkImageData>::New();
+  slice->image->DeepCopy(sliceImage);
+  std::copy(bounds, bounds + 6, slice->bounds);
+  std::copy(spacing, spacing + 2, slice->spacing);
+  slice->resliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  slice->resliceAxes->DeepCopy(resliceAxes);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  this->InsertSlice(key, slice);
+  return slice;
+}
+
+void mitk::ImageSliceCache::InsertSlice(const SliceKey &key, const SliceConstPointer &slice)
+{
+  // slices of older versions of this image can never be requested again
+  for (auto it = m_Slices.begin(); it != m_Slices.end();)
+  {
+    if (it->first == key || (it->first.m_Image == key.m_Image && it->first.m_ImageMTime < key.m_ImageMTime))
+    {
+      m_MemorySize -= GetMemorySize(it->second);
+      it = m_Slices.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  m_Slices.emplace_front(key, slice);
+  m_MemorySize += GetMemorySize(slice);
+
+  while (m_MemorySize > m_MaximumMemorySize && m_Slices.size() > 1)
+  {
+    m_MemorySize -= GetMemorySize(m_Slices.back().second);
+    m_Slices.pop_back();
+  }
+}
+
+void mitk::ImageSliceCache::RequestSlice(const SliceKey &key,
+                                         Image *image,
+                                         const PlaneGeometry *planeGeometry,
+                                         bool priority,
+                                         const std::function<void()> &onCached)
+{
+  if (!key.IsValid() || image == nullptr || planeGeometry == nullptr)
+    return;
+
+  std::function<void()> onCachedOfQueued;
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if (m_Stop)
+      return;
+
+    if (std::any_of(m_Slices.cbegin(), m_Slices.cend(), [&key](const SliceListType::value_type &entry) {
+          return entry.first == key;
+        }))
+    {
+      // the slice may have been cached since the caller looked for it
+      lock.unlock();
+      if (onCached)
+        onCached();
+      return;
+    }
+
+    if (m_KeyInProgress == key)
+    {
+      m_OnCachedInProgress = CombineCallbacks(m_OnCachedInProgress, onCached);
+      return;
+    }
+
+    auto queued = std::find_if(
+      m_Requests.begin(), m_Requests.end(), [&key](const SliceRequest &request) { return request.key == key; });
+    if (queued != m_Requests.end())
+    {
+      if (!priority || queued->priority)
+      {
+        queued->onCached = CombineCallbacks(queued->onCached, onCached);
+        return;
+      }
+      // requeued with priority below, keeping the callbacks of the other callers
+      onCachedOfQueued = queued->onCached;
+      m_Requests.erase(queued);
+    }
+  }
+
+  // Everything the background thread needs is taken from the image and the geometry here, in the GUI thread.
+  // The request holds a reference to the image and to the data item of the time step, which thus stay valid
+  // even if the image is changed or deleted meanwhile; the slice is cached under the key of the old version
+  // then, which is dropped. The pixels are read under an ImageReadAccessor in Reslice() only, which has to be
+  // created and destroyed in the background thread.
+  SliceRequest request;
+  request.key = key;
+  request.image = image;
+  request.priority = priority;
+  request.onCached = CombineCallbacks(onCachedOfQueued, onCached);
+
+  request.volumeData = image->GetVolumeData(key.m_TimeStep);
+  BaseGeometry::Pointer timeStepGeometry = image->GetTimeGeometry()->GetGeometryForTimeStep(key.m_TimeStep);
+  if (request.volumeData.IsNull() || timeStepGeometry.IsNull())
+    return;
+
+  request.volume = Image::New();
+  request.volume->Initialize(image->GetPixelType(), *timeStepGeometry);
+
+  request.planeGeometry = planeGeometry->Clone();
+  if (planeGeometry->GetReferenceGeometry() != nullptr)
+  {
+    // PlaneGeometry does not own its reference geometry
+    request.referenceGeometry = planeGeometry->GetReferenceGeometry()->Clone();
+    request.planeGeometry->SetReferenceGeometry(request.referenceGeometry);
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_Stop)
+    return;
+
+  if (priority)
+  {
+    // the user moved on, the queued neighbours of older slices are not needed any more
+    m_Requests.erase(std::remove_if(m_Requests.begin(),
+                                    m_Requests.end(),
+                                    [](const SliceRequest &queuedRequest) { return !queuedRequest.priority; }),
+                     m_Requests.end());
+    m_Requests.push_front(std::move(request));
+  }
+  else
+  {
+    m_Requests.push_back(std::move(request));
+  }
+
+  if (!m_WorkerRunning)
+  {
+    // a finished worker has left the loop already, so joining it does not block
+    if (m_Worker.joinable())
+      m_Worker.join();
+
+    m_WorkerRunning = true;
+    m_Worker = std::thread(&ImageSliceCache::ProcessRequests, this);
+  }
+}
+
+bool mitk::ImageSliceCache::IsSliceRequested(const SliceKey &key) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return (key.IsValid() && m_KeyInProgress == key) ||
+         std::any_of(
+           m_Requests.cbegin(), m_Requests.cend(), [&key](const SliceRequest &request) { return request.key == key; });
+}
+
+void mitk::ImageSliceCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Slices.clear();
+  m_MemorySize = 0;
+  m_Requests.clear();
+}
+
+void mitk::ImageSliceCache::ProcessRequests()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  while (!m_Stop && !m_Requests.empty())
+  {
+    SliceRequest request = std::move(m_Requests.front());
+    m_Requests.pop_front();
+    m_KeyInProgress = request.key;
+    m_OnCachedInProgress = request.onCached;
+    lock.unlock();
+
+    SliceConstPointer slice;
+    try
+    {
+      slice = Reslice(request);
+    }
+    catch (const std::exception &e)
+    {
+      MITK_WARN << "Cannot reslice image in the background: " << e.what();
+    }
+
+    lock.lock();
+    std::function<void()> onCached = m_OnCachedInProgress;
+    m_KeyInProgress = SliceKey();
+    m_OnCachedInProgress = std::function<void()>();
+
+    if (slice && !m_Stop)
+    {
+      this->InsertSlice(request.key, slice);
+
+      if (onCached)
+      {
+        lock.unlock();
+        onCached();
+        lock.lock();
+      }
+    }
+  }
+
+  m_WorkerRunning = false;
+}
+
+std::function<void()> mitk::ImageSliceCache::CombineCallbacks(const std::function<void()> &first,
+                                                               const std::function<void()> &second)
+{
+  if (!first)
+    return second;
+  if (!second)
+    return first;
+
+  return [first, second]() {
+    first();
+    second();
+  };
+}
+
+mitk::ImageSliceCache::SliceConstPointer mitk::ImageSliceCache::Reslice(const SliceRequest &request)
+{
+  // keeps writers away from the pixels until the slice is copied below
+  ImageReadAccessor readAccess(request.image, request.volumeData);
+  request.volume->SetImportVolume(const_cast<void *>(readAccess.GetData()), 0, 0, Image::ReferenceMemory);
+
+  // the same settings as in ImageVtkMapper2D::GenerateDataForRenderer(), for the single time step of the request
+  ExtractSliceFilter::Pointer reslicer = ExtractSliceFilter::New();
+  reslicer->SetInput(request.volume);
+  reslicer->SetWorldGeometry(request.planeGeometry);
+  reslicer->SetTimeStep(0);
+  reslicer->SetResliceTransformByGeometry(request.volume->GetGeometry());
+  reslicer->SetInPlaneResampleExtentByGeometry(request.key.m_InPlaneResampleExtentByGeometry);
+  reslicer->SetInterpolationMode(request.key.m_Interpolation);
+  reslicer->SetVtkOutputRequest(true);
+  reslicer->SetOutputDimensionality(2);
+  reslicer->SetOutputSpacingZDirection(1.0);
+  reslicer->SetOutputExtentZDirection(0, 0);
+  reslicer->Modified();
+  reslicer->UpdateLargestPossibleRegion();
+
+  vtkImageData *output = reslicer->GetVtkOutput();
+  if (output == nullptr)
+    return nullptr;
+
+  auto slice = std::make_shared<Slice>();
+  slice->image = vtkSmartPointer<vtkImageData>::New();
+  slice->image->DeepCopy(output);
+  std::fill(slice->bounds, slice->bounds + 6, 0.0);
+  reslicer->GetClippedPlaneBounds(slice->bounds);
+  std::copy(reslicer->GetOutputSpacing(), reslicer->GetOutputSpacing() + 2, slice->spacing);
+  slice->resliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  slice->resliceAxes->DeepCopy(reslicer->GetResliceAxes());
+  return slice;
+}
@@ -56,9 +56,50 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 
 // ITK
+#include <itkCommand.h>
 #include <itkRGBAPixel.h>
+#include <mitkCallbackFromGUIThread.h>
+#include <mitkRenderingManager.h>
 #include <mitkRenderingModeProperty.h>
 
+#include <algorithm>
+
+namespace
+{
+  /** Requests an update of a render window. Posted to the GUI thread when a slice was resliced in the background. */
+  class RenderWindowUpdateCommand : public itk::Command
+  {
+  public:
+    typedef RenderWindowUpdateCommand Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkFactorylessNewMacro(Self);
+
+    void SetRenderWindow(mitk::RenderingManager *renderingManager, vtkRenderWindow *renderWindow)
+    {
+      m_RenderingManager = renderingManager;
+      m_RenderWindow = renderWindow;
+    }
+
+    void Execute(itk::Object *, const itk::EventObject &) override { this->RequestUpdate(); }
+    void Execute(const itk::Object *, const itk::EventObject &) override { this->RequestUpdate(); }
+
+  private:
+    RenderWindowUpdateCommand() : m_RenderWindow(nullptr) {}
+
+    void RequestUpdate()
+    {
+      // the rendering manager ignores render windows which were removed in the meantime
+      if (m_RenderingManager.IsNotNull())
+      {
+        m_RenderingManager->RequestUpdate(m_RenderWindow);
+      }
+    }
+
+    mitk::RenderingManager::Pointer m_RenderingManager;
+    vtkRenderWindow *m_RenderWindow;
+  };
+}
+
 mitk::ImageVtkMapper2D::ImageVtkMapper2D()
 {
 }
@@ -164,6 +205,7 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
   // Initialize the interpolation mode for resampling; switch to nearest
   // neighbor if the input image is too small.
+  ExtractSliceFilter::ResliceInterpolation interpolation = ExtractSliceFilter::RESLICE_NEAREST;
   if ((image->GetDimension() >= 3) && (image->GetDimension(2) > 1))
   {
     VtkResliceInterpolationProperty *resliceInterpolationProperty;
@@ -178,20 +220,17 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     switch (interpolationMode)
     {
       case VTK_RESLICE_NEAREST:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
+        interpolation = ExtractSliceFilter::RESLICE_NEAREST;
         break;
       case VTK_RESLICE_LINEAR:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_LINEAR);
+        interpolation = ExtractSliceFilter::RESLICE_LINEAR;
         break;
       case VTK_RESLICE_CUBIC:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_CUBIC);
+        interpolation = ExtractSliceFilter::RESLICE_CUBIC;
         break;
     }
   }
-  else
-  {
-    localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
-  }
+  localStorage->m_Reslicer->SetInterpolationMode(interpolation);
 
   // set the vtk output property to true, makes sure that no unneeded mitk image convertion
   // is done.
@@ -227,7 +266,57 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
   const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
 
-  if (thickSlicesMode > 0)
+  // thick slices are not cached, the key of curved planes is invalid
+  ImageSliceCache::SliceKey sliceKey;
+  if (thickSlicesMode == 0)
+  {
+    sliceKey = ImageSliceCache::SliceKey(
+      image, this->GetTimestep(), planeGeometry, interpolation, inPlaneResampleExtentByGeometry);
+  }
+  ImageSliceCache *sliceCache = ImageSliceCache::GetInstance();
+  ImageSliceCache::SliceConstPointer cachedSlice = sliceCache->GetSlice(sliceKey);
+
+  bool asynchronousReslicing = false;
+  datanode->GetBoolProperty("Image Rendering.Asynchronous Reslicing", asynchronousReslicing, renderer);
+  int prefetchedSlices = 0;
+  datanode->GetIntProperty("Image Rendering.Prefetched Slices", prefetchedSlices, renderer);
+
+  // keep showing the last slice of this image until the requested one is resliced in the background
+  if (cachedSlice == nullptr && asynchronousReslicing && sliceKey.IsValid() &&
+      localStorage->m_CurrentSliceKey.GetImage() == image)
+  {
+    RenderingManager::Pointer renderingManager = renderer->GetRenderingManager();
+    vtkRenderWindow *renderWindow = renderer->GetRenderWindow();
+    sliceCache->RequestSlice(sliceKey, image, planeGeometry, true, [renderingManager, renderWindow]() {
+      auto command = RenderWindowUpdateCommand::New();
+      command->SetRenderWindow(renderingManager, renderWindow);
+      CallbackFromGUIThread::GetInstance()->CallThisFromGUIThread(command);
+    });
+    localStorage->m_PendingSliceKey = sliceKey;
+
+    // queued after the requested slice, which has priority
+    if (prefetchedSlices > 0)
+    {
+      this->PrefetchNeighbouringSlices(renderer, prefetchedSlices, interpolation, inPlaneResampleExtentByGeometry);
+    }
+    return;
+  }
+  localStorage->m_PendingSliceKey = ImageSliceCache::SliceKey();
+
+  // Bounds information for reslicing (only reuqired if reference geometry
+  // is present)
+  // this used for generating a vtkPLaneSource with the right size
+  double sliceBounds[6];
+  for (auto &sliceBound : sliceBounds)
+  {
+    sliceBound = 0.0;
+  }
+
+  if (cachedSlice != nullptr)
+  {
+    localStorage->m_ReslicedImage = cachedSlice->image;
+  }
+  else if (thickSlicesMode > 0)
   {
     double dataZSpacing = 1.0;
 
@@ -280,21 +369,34 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     localStorage->m_Reslicer->Modified();
     // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
     localStorage->m_Reslicer->UpdateLargestPossibleRegion();
+    // the slice is not added to the cache, which holds only the slices requested from the background thread
     localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
   }
 
-  // Bounds information for reslicing (only reuqired if reference geometry
-  // is present)
-  // this used for generating a vtkPLaneSource with the right size
-  double sliceBounds[6];
-  for (auto &sliceBound : sliceBounds)
+  localStorage->m_CurrentSlice = cachedSlice;
+  localStorage->m_CurrentSliceKey = sliceKey;
+
+  if (cachedSlice != nullptr)
   {
-    sliceBound = 0.0;
+    std::copy(cachedSlice->bounds, cachedSlice->bounds + 6, sliceBounds);
+
+    // get the spacing of the slice
+    localStorage->m_CurrentSliceSpacing[0] = cachedSlice->spacing[0];
+    localStorage->m_CurrentSliceSpacing[1] = cachedSlice->spacing[1];
+    localStorage->m_mmPerPixel = localStorage->m_CurrentSliceSpacing;
+  }
+  else
+  {
+    localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
+
+    // get the spacing of the slice
+    localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
   }
-  localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
 
-  // get the spacing of the slice
-  localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
+  if (sliceKey.IsValid() && prefetchedSlices > 0)
+  {
+    this->PrefetchNeighbouringSlices(renderer, prefetchedSlices, interpolation, inPlaneResampleExtentByGeometry);
+  }
 
   // calculate minimum bounding rect of IMAGE in texture
   {
@@ -675,7 +777,8 @@ void mitk::ImageVtkMapper2D::Update(mitk::BaseRenderer *renderer)
       (localStorage->m_LastUpdateTime < renderer->GetCurrentWorldPlaneGeometry()->GetMTime()) ||
       (localStorage->m_LastUpdateTime < node->GetPropertyList()->GetMTime()) ||
       (localStorage->m_LastUpdateTime < node->GetPropertyList(renderer)->GetMTime()) ||
-      (localStorage->m_LastUpdateTime < data->GetPropertyList()->GetMTime()))
+      (localStorage->m_LastUpdateTime < data->GetPropertyList()->GetMTime()) ||
+      localStorage->m_PendingSliceKey.IsValid())
   {
     this->GenerateDataForRenderer(renderer);
   }
@@ -702,6 +805,8 @@ void mitk::ImageVtkMapper2D::SetDefaultProperties(mitk::DataNode *node, mitk::Ba
     node->AddProperty("reslice interpolation", mitk::VtkResliceInterpolationProperty::New());
   node->AddProperty("texture interpolation", mitk::BoolProperty::New(false));
   node->AddProperty("in plane resample extent by geometry", mitk::BoolProperty::New(false));
+  node->AddProperty("Image Rendering.Prefetched Slices", mitk::IntProperty::New(0), renderer, overwrite);
+  node->AddProperty("Image Rendering.Asynchronous Reslicing", mitk::BoolProperty::New(false), renderer, overwrite);
   node->AddProperty("bounding box", mitk::BoolProperty::New(false));
 
   mitk::RenderingModeProperty::Pointer renderingModeProperty = mitk::RenderingModeProperty::New();
@@ -1027,7 +1132,9 @@ void mitk::ImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_Reslicer->GetResliceAxes();
+  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_CurrentSlice != nullptr
+                                           ? localStorage->m_CurrentSlice->resliceAxes
+                                           : localStorage->m_Reslicer->GetResliceAxes();
   trans->SetMatrix(matrix);
   // transform the plane/contour (the actual actor) to the corresponding view (axial, coronal or saggital)
   localStorage->m_Actor->SetUserTransform(trans);
@@ -1071,12 +1178,61 @@ bool mitk::ImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometr
   return false;
 }
 
+void mitk::ImageVtkMapper2D::PrefetchNeighbouringSlices(mitk::BaseRenderer *renderer,
+                                                        int numberOfSlices,
+                                                        ExtractSliceFilter::ResliceInterpolation interpolation,
+                                                        bool inPlaneResampleExtentByGeometry)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+  auto *image = const_cast<mitk::Image *>(this->GetInput());
+
+  const auto *worldGeometry = dynamic_cast<const SlicedGeometry3D *>(renderer->GetCurrentWorldGeometry());
+  if (worldGeometry == nullptr)
+  {
+    return;
+  }
+
+  const int currentSlice = static_cast<int>(renderer->GetSlice());
+  if (currentSlice == localStorage->m_LastPrefetchedSlice)
+  {
+    return;
+  }
+
+  // the neighbours in the direction of scrolling are needed first
+  const int direction = currentSlice < localStorage->m_LastPrefetchedSlice ? -1 : 1;
+  localStorage->m_LastPrefetchedSlice = currentSlice;
+
+  const int numberOfWorldSlices = static_cast<int>(worldGeometry->GetSlices());
+  for (int distance = 1; distance <= numberOfSlices; ++distance)
+  {
+    for (int side : {direction, -direction})
+    {
+      const int slice = currentSlice + side * distance;
+      if (slice < 0 || slice >= numberOfWorldSlices)
+      {
+        continue;
+      }
+
+      const PlaneGeometry *planeGeometry = worldGeometry->GetPlaneGeometry(slice);
+      if (planeGeometry == nullptr || !RenderingGeometryIntersectsImage(planeGeometry, image->GetSlicedGeometry()))
+      {
+        continue;
+      }
+
+      ImageSliceCache::SliceKey sliceKey(
+        image, this->GetTimestep(), planeGeometry, interpolation, inPlaneResampleExtentByGeometry);
+      ImageSliceCache::GetInstance()->RequestSlice(sliceKey, image, planeGeometry, false);
+    }
+  }
+}
+
 mitk::ImageVtkMapper2D::LocalStorage::~LocalStorage()
 {
 }
 
 mitk::ImageVtkMapper2D::LocalStorage::LocalStorage()
-  : m_VectorComponentExtractor(vtkSmartPointer<vtkImageExtractComponents>::New())
+  : m_VectorComponentExtractor(vtkSmartPointer<vtkImageExtractComponents>::New()),
+    m_LastPrefetchedSlice(-1)
 {
   m_LevelWindowFilter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
 
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkGeometryDataWriterService.h>
 #include <mitkIOMimeTypes.h>
 #include <mitkIOUtil.h>
+#include <mitkImageSliceCache.h>
 #include <mitkImageVtkLegacyIO.h>
 #include <mitkImageVtkXmlIO.h>
 #include <mitkItkImageIO.h>
@@ -228,6 +229,10 @@ void MitkCoreActivator::Unload(us::ModuleContext *)
   m_MimeTypeProviderReg.Unregister();
   m_MimeTypeProvider->Stop();
 
+  // the background thread of the slice cache has to end before the
+  // static objects of this library are destroyed
+  mitk::ImageSliceCache::GetInstance()->Shutdown();
+
   for (std::vector<mitk::CustomMimeType *>::const_iterator mimeTypeIter = m_DefaultMimeTypes.begin(),
                                                            iterEnd = m_DefaultMimeTypes.end();
        mimeTypeIter != iterEnd;
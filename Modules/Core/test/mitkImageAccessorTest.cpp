@@ -211,6 +211,34 @@ int mitkImageAccessorTest(int argc, char *argv[])
     MITK_TEST_CONDITION_REQUIRED(false, "Ignoring the lock mechanism leads to exception.");
   }
 
+  // conflicting accessors are counted as contention, accessors on disjoint slices are not
+  image->ResetAccessorContentionCount();
+  try
+  {
+    mitk::ImageWriteAccessor first(image);
+    mitk::ImageReadAccessor second(image, nullptr, mitk::ImageAccessorBase::ExceptionIfLocked);
+    MITK_TEST_CONDITION_REQUIRED(false, "Overlapping read access with \"ExceptionIfLocked\" has to throw.");
+  }
+  catch (const mitk::MemoryIsLockedException & /*e*/)
+  {
+  }
+  MITK_TEST_CONDITION_REQUIRED(image->GetAccessorContentionCount() == 1, "Testing the accessor contention counter");
+
+  if (image->GetDimension() > 2 && image->GetDimension(2) > 1)
+  {
+    try
+    {
+      mitk::ImageWriteAccessor firstSlice(image, image->GetSliceData(0));
+      mitk::ImageWriteAccessor secondSlice(image, image->GetSliceData(1));
+      MITK_TEST_CONDITION_REQUIRED(image->GetAccessorContentionCount() == 1,
+                                   "Disjoint slice accessors are not counted as contention");
+    }
+    catch (const mitk::Exception & /*e*/)
+    {
+      MITK_TEST_CONDITION_REQUIRED(false, "Write access on disjoint slices must not conflict.");
+    }
+  }
+
   // CREATE THREADS
 
   image->GetGeometry()->Initialize();
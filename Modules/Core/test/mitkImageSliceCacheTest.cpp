@@ -0,0 +1,262 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImageGenerator.h>
+#include <mitkImageSliceCache.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+class mitkImageSliceCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageSliceCacheTestSuite);
+  MITK_TEST(TestKeysCompareGeometriesByValue);
+  MITK_TEST(TestModifiedImageMissesCache);
+  MITK_TEST(TestLeastRecentlyUsedSliceIsEvicted);
+  MITK_TEST(TestRequestedSliceIsResliced);
+  MITK_TEST(TestRequestedSliceEqualsSynchronousSlice);
+  MITK_TEST(TestCallbacksOfAllCallersAreCalled);
+  MITK_TEST(TestRequestsAfterShutdownAreIgnored);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+
+  mitk::PlaneGeometry::Pointer CreatePlane(
+    mitk::ScalarType position, mitk::PlaneGeometry::PlaneOrientation orientation = mitk::PlaneGeometry::Axial)
+  {
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_Image->GetGeometry(), orientation, position);
+    return plane;
+  }
+
+  mitk::ImageSliceCache::SliceKey CreateKey(
+    const mitk::PlaneGeometry *plane,
+    mitk::ExtractSliceFilter::ResliceInterpolation interpolation = mitk::ExtractSliceFilter::RESLICE_NEAREST)
+  {
+    return mitk::ImageSliceCache::SliceKey(m_Image, 0, plane, interpolation, false);
+  }
+
+  /** Waits up to five seconds for the background thread to reslice the slice of key. */
+  static void WaitForSlice(const mitk::ImageSliceCache &cache, const mitk::ImageSliceCache::SliceKey &key)
+  {
+    for (int i = 0; i < 500 && cache.IsSliceRequested(key); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  /** Reslices m_Image along plane with the settings of ImageVtkMapper2D, in the calling thread. */
+  mitk::ExtractSliceFilter::Pointer ResliceSynchronously(const mitk::PlaneGeometry *plane,
+                                                         mitk::ExtractSliceFilter::ResliceInterpolation interpolation)
+  {
+    mitk::ExtractSliceFilter::Pointer reslicer = mitk::ExtractSliceFilter::New();
+    reslicer->SetInput(m_Image);
+    reslicer->SetWorldGeometry(plane);
+    reslicer->SetTimeStep(0);
+    reslicer->SetResliceTransformByGeometry(m_Image->GetTimeGeometry()->GetGeometryForTimeStep(0));
+    reslicer->SetInPlaneResampleExtentByGeometry(false);
+    reslicer->SetInterpolationMode(interpolation);
+    reslicer->SetVtkOutputRequest(true);
+    reslicer->SetOutputDimensionality(2);
+    reslicer->SetOutputSpacingZDirection(1.0);
+    reslicer->SetOutputExtentZDirection(0, 0);
+    reslicer->Modified();
+    reslicer->UpdateLargestPossibleRegion();
+    return reslicer;
+  }
+
+  /** Adds an empty slice of 64 x 64 float pixels, i.e. 16 KiB. */
+  void AddSlice(mitk::ImageSliceCache &cache, const mitk::ImageSliceCache::SliceKey &key)
+  {
+    auto sliceImage = vtkSmartPointer<vtkImageData>::New();
+    sliceImage->SetDimensions(64, 64, 1);
+    sliceImage->AllocateScalars(VTK_FLOAT, 1);
+
+    const double bounds[6] = {0, 64, 0, 64, 0, 0};
+    const mitk::ScalarType spacing[2] = {1, 1};
+    auto resliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+    CPPUNIT_ASSERT(cache.AddSlice(key, sliceImage, bounds, spacing, resliceAxes) != nullptr);
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(64, 64, 20, 1, 1, 1, 1, 1000, 0);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void TestKeysCompareGeometriesByValue()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(5);
+    mitk::PlaneGeometry::Pointer copy = plane->Clone();
+
+    CPPUNIT_ASSERT(this->CreateKey(plane).IsValid());
+    CPPUNIT_ASSERT(this->CreateKey(plane) == this->CreateKey(copy));
+    CPPUNIT_ASSERT(this->CreateKey(plane) != this->CreateKey(this->CreatePlane(6)));
+    CPPUNIT_ASSERT(this->CreateKey(plane) !=
+                   mitk::ImageSliceCache::SliceKey(m_Image, 0, plane, mitk::ExtractSliceFilter::RESLICE_LINEAR, false));
+    CPPUNIT_ASSERT(!mitk::ImageSliceCache::SliceKey(nullptr, 0, plane, mitk::ExtractSliceFilter::RESLICE_NEAREST, false)
+                      .IsValid());
+
+    mitk::ImageSliceCache cache;
+    this->AddSlice(cache, this->CreateKey(plane));
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(copy)) != nullptr);
+  }
+
+  void TestModifiedImageMissesCache()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(5);
+
+    mitk::ImageSliceCache cache;
+    this->AddSlice(cache, this->CreateKey(plane));
+    m_Image->Modified();
+
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(plane)) == nullptr);
+  }
+
+  void TestLeastRecentlyUsedSliceIsEvicted()
+  {
+    mitk::ImageSliceCache cache;
+    cache.SetMaximumMemorySize(40 * 1024); // two slices and their overhead
+
+    this->AddSlice(cache, this->CreateKey(this->CreatePlane(1)));
+    this->AddSlice(cache, this->CreateKey(this->CreatePlane(2)));
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(this->CreatePlane(1))) != nullptr);
+
+    this->AddSlice(cache, this->CreateKey(this->CreatePlane(3)));
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(this->CreatePlane(1))) != nullptr);
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(this->CreatePlane(2))) == nullptr);
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(this->CreatePlane(3))) != nullptr);
+  }
+
+  void TestRequestedSliceIsResliced()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(5);
+    const mitk::ImageSliceCache::SliceKey key = this->CreateKey(plane);
+
+    mitk::ImageSliceCache cache;
+    cache.RequestSlice(key, m_Image, plane, true);
+    WaitForSlice(cache, key);
+
+    mitk::ImageSliceCache::SliceConstPointer slice = cache.GetSlice(key);
+    CPPUNIT_ASSERT(slice != nullptr);
+
+    int dimensions[3];
+    slice->image->GetDimensions(dimensions);
+    CPPUNIT_ASSERT_EQUAL(64, dimensions[0]);
+    CPPUNIT_ASSERT_EQUAL(64, dimensions[1]);
+  }
+
+  void TestRequestedSliceEqualsSynchronousSlice()
+  {
+    const mitk::ExtractSliceFilter::ResliceInterpolation interpolations[] = {mitk::ExtractSliceFilter::RESLICE_NEAREST,
+                                                                             mitk::ExtractSliceFilter::RESLICE_LINEAR};
+    const mitk::PlaneGeometry::PlaneOrientation orientations[] = {mitk::PlaneGeometry::Axial,
+                                                                  mitk::PlaneGeometry::Sagittal,
+                                                                  mitk::PlaneGeometry::Frontal};
+
+    mitk::ImageSliceCache cache;
+    for (auto interpolation : interpolations)
+    {
+      for (auto orientation : orientations)
+      {
+        mitk::PlaneGeometry::Pointer plane = this->CreatePlane(7, orientation);
+        const mitk::ImageSliceCache::SliceKey key = this->CreateKey(plane, interpolation);
+        cache.RequestSlice(key, m_Image, plane, false);
+        WaitForSlice(cache, key);
+
+        mitk::ImageSliceCache::SliceConstPointer slice = cache.GetSlice(key);
+        CPPUNIT_ASSERT(slice != nullptr);
+
+        mitk::ExtractSliceFilter::Pointer reslicer = this->ResliceSynchronously(plane, interpolation);
+        vtkImageData *expected = reslicer->GetVtkOutput();
+
+        int expectedDimensions[3];
+        int dimensions[3];
+        expected->GetDimensions(expectedDimensions);
+        slice->image->GetDimensions(dimensions);
+        for (int i = 0; i < 3; ++i)
+          CPPUNIT_ASSERT_EQUAL(expectedDimensions[i], dimensions[i]);
+        CPPUNIT_ASSERT_EQUAL(expected->GetScalarType(), slice->image->GetScalarType());
+        CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfScalarComponents(), slice->image->GetNumberOfScalarComponents());
+
+        const size_t size = static_cast<size_t>(expectedDimensions[0]) * expectedDimensions[1] *
+                            expectedDimensions[2] * expected->GetScalarSize() *
+                            expected->GetNumberOfScalarComponents();
+        CPPUNIT_ASSERT_MESSAGE("Pixels of the background slice equal the pixels of ExtractSliceFilter",
+                               std::memcmp(expected->GetScalarPointer(), slice->image->GetScalarPointer(), size) == 0);
+
+        CPPUNIT_ASSERT_EQUAL(reslicer->GetOutputSpacing()[0], slice->spacing[0]);
+        CPPUNIT_ASSERT_EQUAL(reslicer->GetOutputSpacing()[1], slice->spacing[1]);
+        double expectedBounds[6] = {0, 0, 0, 0, 0, 0};
+        reslicer->GetClippedPlaneBounds(expectedBounds);
+        for (int i = 0; i < 6; ++i)
+          CPPUNIT_ASSERT_EQUAL(expectedBounds[i], slice->bounds[i]);
+      }
+    }
+  }
+
+  void TestCallbacksOfAllCallersAreCalled()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(5);
+    const mitk::ImageSliceCache::SliceKey key = this->CreateKey(plane);
+
+    std::atomic<int> firstCalls(0);
+    std::atomic<int> secondCalls(0);
+
+    mitk::ImageSliceCache cache;
+    cache.RequestSlice(key, m_Image, plane, false, [&firstCalls]() { ++firstCalls; });
+    cache.RequestSlice(key, m_Image, plane, true, [&secondCalls]() { ++secondCalls; });
+
+    // the callbacks are called after the slice is cached
+    for (int i = 0; i < 500 && (firstCalls == 0 || secondCalls == 0); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    CPPUNIT_ASSERT(cache.GetSlice(key) != nullptr);
+    CPPUNIT_ASSERT_EQUAL(1, firstCalls.load());
+    CPPUNIT_ASSERT_EQUAL(1, secondCalls.load());
+  }
+
+  void TestRequestsAfterShutdownAreIgnored()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(5);
+    const mitk::ImageSliceCache::SliceKey key = this->CreateKey(plane);
+
+    mitk::ImageSliceCache cache;
+    this->AddSlice(cache, this->CreateKey(this->CreatePlane(1)));
+    cache.Shutdown();
+    cache.RequestSlice(key, m_Image, plane, true);
+
+    CPPUNIT_ASSERT(!cache.IsSliceRequested(key));
+    CPPUNIT_ASSERT(cache.GetSlice(key) == nullptr);
+    CPPUNIT_ASSERT(cache.GetSlice(this->CreateKey(this->CreatePlane(1))) != nullptr);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageSliceCache)
@@ -0,0 +1,121 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkITKImageImport.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageStatisticsHolder.h>
+
+#include <itkVectorImage.h>
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+class mitkImageStatisticsHolderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsHolderTestSuite);
+  MITK_TEST(TestExtremaOfScalarImage);
+  MITK_TEST(TestExtremaOfConstantImage);
+  MITK_TEST(TestExtremaOfVectorImage);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  /** Extrema computed by visiting the values one after another. */
+  void CheckExtrema(const std::vector<double> &values, mitk::ImageStatisticsHolder *statistics, int t, unsigned int component)
+  {
+    std::set<double> distinctValues(values.begin(), values.end());
+    const double min = *distinctValues.begin();
+    const double max = *distinctValues.rbegin();
+    const double secondMin = distinctValues.size() > 1 ? *std::next(distinctValues.begin()) : min;
+    const double secondMax = distinctValues.size() > 1 ? *std::next(distinctValues.rbegin()) : max;
+
+    CPPUNIT_ASSERT_EQUAL(min, statistics->GetScalarValueMin(t, component));
+    CPPUNIT_ASSERT_EQUAL(max, statistics->GetScalarValueMax(t, component));
+    CPPUNIT_ASSERT_EQUAL(secondMin, statistics->GetScalarValue2ndMin(t, component));
+    CPPUNIT_ASSERT_EQUAL(secondMax, statistics->GetScalarValue2ndMax(t, component));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(std::count(values.begin(), values.end(), min)),
+                         statistics->GetCountOfMinValuedVoxels(t, component));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(std::count(values.begin(), values.end(), max)),
+                         statistics->GetCountOfMaxValuedVoxels(t, component));
+  }
+
+public:
+  void TestExtremaOfScalarImage()
+  {
+    // large enough to be split into several chunks
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(128, 128, 40, 3, 1, 1, 1, 1000, -1000);
+
+    const size_t numberOfVoxels = 128 * 128 * 40;
+    for (int t = 0; t < 3; ++t)
+    {
+      mitk::ImageReadAccessor readAccess(image, image->GetVolumeData(t));
+      const auto *data = static_cast<const short *>(readAccess.GetData());
+      std::vector<double> values(data, data + numberOfVoxels);
+      this->CheckExtrema(values, image->GetStatistics(), t, 0);
+    }
+  }
+
+  void TestExtremaOfConstantImage()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateGradientImage<unsigned char>(1, 1, 1);
+    auto *statistics = image->GetStatistics();
+
+    CPPUNIT_ASSERT_EQUAL(statistics->GetScalarValueMin(), statistics->GetScalarValueMax());
+    CPPUNIT_ASSERT_EQUAL(statistics->GetScalarValueMin(), statistics->GetScalarValue2ndMin());
+    CPPUNIT_ASSERT_EQUAL(statistics->GetScalarValueMax(), statistics->GetScalarValue2ndMax());
+    CPPUNIT_ASSERT_EQUAL(1.0, statistics->GetCountOfMinValuedVoxels());
+  }
+
+  void TestExtremaOfVectorImage()
+  {
+    typedef itk::VectorImage<float, 3> VectorImageType;
+    const unsigned int numberOfComponents = 3;
+
+    VectorImageType::SizeType size;
+    size.Fill(64);
+    VectorImageType::Pointer itkImage = VectorImageType::New();
+    itkImage->SetRegions(VectorImageType::RegionType(size));
+    itkImage->SetNumberOfComponentsPerPixel(numberOfComponents);
+    itkImage->Allocate();
+
+    std::vector<std::vector<double>> values(numberOfComponents);
+    float *buffer = itkImage->GetBufferPointer();
+    const size_t numberOfVoxels = 64 * 64 * 64;
+    for (size_t i = 0; i < numberOfVoxels; ++i)
+    {
+      for (unsigned int c = 0; c < numberOfComponents; ++c)
+      {
+        const float value = static_cast<float>((i * (c + 7)) % (50 + 100 * c)) - 10.0f * c;
+        buffer[i * numberOfComponents + c] = value;
+        values[c].push_back(value);
+      }
+    }
+
+    mitk::Image::Pointer image = mitk::GrabItkImageMemory(itkImage.GetPointer());
+
+    // switching between the components must give the extrema of the requested component
+    this->CheckExtrema(values[1], image->GetStatistics(), 0, 1);
+    this->CheckExtrema(values[0], image->GetStatistics(), 0, 0);
+    this->CheckExtrema(values[2], image->GetStatistics(), 0, 2);
+    this->CheckExtrema(values[1], image->GetStatistics(), 0, 1);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsHolder)
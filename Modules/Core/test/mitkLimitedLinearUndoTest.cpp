@@ -0,0 +1,172 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include "mitkInteractionConst.h"
+#include "mitkLimitedLinearUndo.h"
+#include "mitkOperation.h"
+
+namespace
+{
+  /** Operation pretending to hold some data that can be swapped out */
+  class MemoryTestOperation : public mitk::Operation
+  {
+  public:
+    MemoryTestOperation(std::size_t size, bool swappable)
+      : Operation(mitk::OpTEST), m_Size(size), m_Swappable(swappable), m_SwappedOut(false)
+    {
+    }
+
+    std::size_t GetMemorySize() const override { return m_SwappedOut ? 0 : m_Size; }
+    bool SwapOut(const std::string &) override
+    {
+      if (!m_Swappable || m_SwappedOut)
+        return false;
+      m_SwappedOut = true;
+      return true;
+    }
+
+  private:
+    std::size_t m_Size;
+    bool m_Swappable;
+    bool m_SwappedOut;
+  };
+
+  /** Gives access to the undo stack */
+  class TestUndo : public mitk::LimitedLinearUndo
+  {
+  public:
+    mitkClassMacro(TestUndo, mitk::LimitedLinearUndo);
+    itkFactorylessNewMacro(Self);
+
+    std::size_t GetNumberOfUndoGroups() const
+    {
+      std::size_t groups = 0;
+      for (std::size_t i = 0; i < m_UndoList.size(); ++i)
+      {
+        if (0 == i || m_UndoList[i]->GetGroupEventId() != m_UndoList[i - 1]->GetGroupEventId())
+          ++groups;
+      }
+      return groups;
+    }
+
+    std::size_t GetNumberOfUndoItems() const { return m_UndoList.size(); }
+  };
+}
+
+class mitkLimitedLinearUndoTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLimitedLinearUndoTestSuite);
+
+  MITK_TEST(SetUndoMemoryLimit_DropsOldestItems);
+  MITK_TEST(SetOperationEvent_KeepsNewestItemAboveLimit);
+  MITK_TEST(SetOperationEvent_SwapsOutOldItems);
+  MITK_TEST(SetUndoLimit_ZeroMeansNoLimit);
+  MITK_TEST(SetUndoMemoryLimit_DropsWholeGroups);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  TestUndo::Pointer m_Undo;
+
+  /** Adds an item, by default as a group of its own like a segmentation tool does */
+  void AddItem(std::size_t operationSize, bool swappable = false, bool newGroup = true)
+  {
+    auto *doOp = new MemoryTestOperation(operationSize, swappable);
+    auto *undoOp = new MemoryTestOperation(operationSize, swappable);
+    m_Undo->SetOperationEvent(new mitk::OperationEvent(nullptr, doOp, undoOp, "Test"));
+    mitk::OperationEvent::IncCurrObjectEventId();
+    if (newGroup)
+      mitk::OperationEvent::IncCurrGroupEventId();
+  }
+
+  std::size_t CountUndoSteps() const { return m_Undo->GetNumberOfUndoGroups(); }
+
+public:
+  void setUp() override
+  {
+    m_Undo = TestUndo::New();
+    m_Undo->SetUndoMemoryLimit(0);
+  }
+  void tearDown() override { m_Undo = nullptr; }
+
+  void SetUndoMemoryLimit_DropsOldestItems()
+  {
+    for (int i = 0; i < 10; ++i)
+      this->AddItem(100);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2000), m_Undo->GetUndoMemorySize());
+
+    m_Undo->SetUndoMemoryLimit(1000);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1000), m_Undo->GetUndoMemorySize());
+
+    this->AddItem(100);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1000), m_Undo->GetUndoMemorySize());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), this->CountUndoSteps());
+  }
+
+  void SetOperationEvent_KeepsNewestItemAboveLimit()
+  {
+    m_Undo->SetUndoMemoryLimit(100);
+    this->AddItem(10);
+    this->AddItem(1000);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2000), m_Undo->GetUndoMemorySize());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), this->CountUndoSteps());
+  }
+
+  void SetOperationEvent_SwapsOutOldItems()
+  {
+    m_Undo->SetSwapToDisk(true);
+    m_Undo->SetUndoMemoryLimit(500);
+    for (int i = 0; i < 10; ++i)
+      this->AddItem(100, true);
+
+    // all but the newest items are swapped out instead of dropped
+    CPPUNIT_ASSERT(m_Undo->GetUndoMemorySize() <= 500);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(10), this->CountUndoSteps());
+  }
+
+  void SetUndoLimit_ZeroMeansNoLimit()
+  {
+    m_Undo->SetUndoLimit(3);
+    for (int i = 0; i < 5; ++i)
+      this->AddItem(1);
+    m_Undo->SetUndoLimit(0);
+    this->AddItem(1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), this->CountUndoSteps());
+  }
+
+  void SetUndoMemoryLimit_DropsWholeGroups()
+  {
+    // three groups of three items each
+    for (int i = 0; i < 9; ++i)
+      this->AddItem(100, false, i % 3 == 2);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), this->CountUndoSteps());
+
+    // the oldest group has to go completely, although dropping one item would be enough
+    m_Undo->SetUndoMemoryLimit(1700);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), this->CountUndoSteps());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6), m_Undo->GetNumberOfUndoItems());
+
+    // the newest group is kept, even if it exceeds the limit alone
+    m_Undo->SetUndoMemoryLimit(100);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), this->CountUndoSteps());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), m_Undo->GetNumberOfUndoItems());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLimitedLinearUndo)
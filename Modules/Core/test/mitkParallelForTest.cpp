@@ -0,0 +1,115 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkParallelFor.h>
+
+#include <itkMultiThreader.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class mitkParallelForTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkParallelForTestSuite);
+  MITK_TEST(TestEveryTaskRunsOnce);
+  MITK_TEST(TestNoTasks);
+  MITK_TEST(TestMaximumNumberOfThreads);
+  MITK_TEST(TestGlobalDefaultNumberOfThreads);
+  MITK_TEST(TestExceptionIsRethrown);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  itk::ThreadIdType m_GlobalDefaultNumberOfThreads;
+
+  /** Number of distinct threads running the tasks. Every task waits a little, so all threads get some tasks. */
+  size_t CountThreads(unsigned int numberOfTasks, unsigned int maximumNumberOfThreads)
+  {
+    std::set<std::thread::id> threads;
+    std::mutex mutex;
+    mitk::ParallelFor(numberOfTasks,
+                      [&](unsigned int) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                        std::lock_guard<std::mutex> lock(mutex);
+                        threads.insert(std::this_thread::get_id());
+                      },
+                      maximumNumberOfThreads);
+    return threads.size();
+  }
+
+public:
+  void setUp() override { m_GlobalDefaultNumberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads(); }
+
+  void tearDown() override { itk::MultiThreader::SetGlobalDefaultNumberOfThreads(m_GlobalDefaultNumberOfThreads); }
+
+  void TestEveryTaskRunsOnce()
+  {
+    const unsigned int numberOfTasks = 10000;
+    std::vector<std::atomic<unsigned int>> calls(numberOfTasks);
+    for (auto &count : calls)
+      count = 0;
+
+    mitk::ParallelFor(numberOfTasks, [&](unsigned int i) { calls[i]++; }, 4);
+
+    for (unsigned int i = 0; i < numberOfTasks; ++i)
+      CPPUNIT_ASSERT_EQUAL(1u, calls[i].load());
+  }
+
+  void TestNoTasks()
+  {
+    bool called = false;
+    mitk::ParallelFor(0, [&](unsigned int) { called = true; });
+    CPPUNIT_ASSERT(!called);
+  }
+
+  void TestMaximumNumberOfThreads()
+  {
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), CountThreads(50, 1));
+    CPPUNIT_ASSERT(CountThreads(50, 2) <= 2);
+    CPPUNIT_ASSERT_EQUAL(3u, mitk::GetParallelForNumberOfThreads(3));
+  }
+
+  void TestGlobalDefaultNumberOfThreads()
+  {
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(1);
+    CPPUNIT_ASSERT_EQUAL(1u, mitk::GetParallelForNumberOfThreads());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), CountThreads(50, 0));
+
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads(2);
+    CPPUNIT_ASSERT_EQUAL(2u, mitk::GetParallelForNumberOfThreads());
+    CPPUNIT_ASSERT(CountThreads(50, 0) <= 2);
+  }
+
+  void TestExceptionIsRethrown()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::ParallelFor(1000,
+                                           [&](unsigned int i) {
+                                             if (i == 10)
+                                               throw std::runtime_error("task failed");
+                                           },
+                                           4),
+                         std::runtime_error);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkParallelFor)
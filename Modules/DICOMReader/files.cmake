@@ -4,9 +4,11 @@ set(CPP_FILES
   mitkBaseDICOMReaderService.cpp
   mitkDICOMFileReader.cpp
   mitkDICOMTagScanner.cpp
+  mitkDICOMTagCacheIndex.cpp
   mitkDICOMGDCMTagScanner.cpp
   mitkDICOMDCMTKTagScanner.cpp
   mitkDICOMImageBlockDescriptor.cpp
+  mitkDICOMLazyImage.cpp
   mitkDICOMITKSeriesGDCMReader.cpp
   mitkDICOMDatasetSorter.cpp
   mitkDICOMTagBasedSorter.cpp
@@ -42,6 +42,10 @@ public:
 
   IFileReader::ConfidenceLevel GetConfidenceLevel() const override;
 
+  /** Name of the boolean option that makes readers based on DICOMITKSeriesGDCMReader
+   * decode slices on demand (see DICOMITKSeriesGDCMReader::SetLazyLoading()). Off by default.*/
+  static std::string LAZY_LOADING_OPTION();
+
 protected:
   /** Returns the list of all DCM files that are in the same directory
    * like this->GetLocalFileName().*/
@@ -50,6 +54,9 @@ protected:
   /** Returns the reader instance that should be used. The descission may be based
    * one the passed relevant file list.*/
   virtual mitk::DICOMFileReader::Pointer GetReader(const mitk::StringList& relevantFiles) const = 0;
+
+private:
+  void SetDefaultLoadingOptions();
 };
 
 
@@ -87,6 +87,12 @@ namespace mitk
       DICOMDCMTKTagScanner();
       ~DICOMDCMTKTagScanner() override;
 
+      /**
+        \brief Scans one file for all m_ScannedTags.
+        \return An empty map if the file could not be read.
+      */
+      FileTagsType ScanFile(const std::string& fileName) const;
+
       std::set<DICOMTagPath> m_ScannedTags;
       StringList m_InputFilenames;
       DICOMGenericTagCache::Pointer m_Cache;
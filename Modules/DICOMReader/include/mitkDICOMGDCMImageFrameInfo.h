@@ -19,6 +19,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDICOMDatasetAccessingImageFrameInfo.h"
 
+#include <map>
+
 #include "gdcmScanner.h"
 
 namespace mitk
@@ -30,17 +32,23 @@ namespace mitk
     This class combines a DICOMImageFrameInfo object with the scanning results
     from gdcm::Scanner. The scanning results will be used to implement the tag
     access methods of DICOMDatasetAccess.
+
+    The values are copied, so the frame info does not depend on the lifetime
+    of the scanner that found them.
   */
   class MITKDICOMREADER_EXPORT DICOMGDCMImageFrameInfo : public DICOMDatasetAccessingImageFrameInfo
   {
     public:
 
+      typedef std::map<gdcm::Tag, std::string> TagValueMapType;
+
       mitkClassMacro(DICOMGDCMImageFrameInfo, DICOMDatasetAccessingImageFrameInfo);
       itkFactorylessNewMacro( DICOMGDCMImageFrameInfo );
       mitkNewMacro1Param( DICOMGDCMImageFrameInfo, const std::string&);
       mitkNewMacro2Param( DICOMGDCMImageFrameInfo, const std::string&, unsigned int );
       mitkNewMacro1Param( DICOMGDCMImageFrameInfo, const DICOMImageFrameInfo::Pointer& );
       mitkNewMacro2Param( DICOMGDCMImageFrameInfo, const DICOMImageFrameInfo::Pointer&, gdcm::Scanner::TagToValue const&);
+      mitkNewMacro2Param( DICOMGDCMImageFrameInfo, const DICOMImageFrameInfo::Pointer&, TagValueMapType const&);
 
       ~DICOMGDCMImageFrameInfo() override;
 
@@ -53,9 +61,10 @@ namespace mitk
     protected:
       explicit DICOMGDCMImageFrameInfo(const DICOMImageFrameInfo::Pointer& frameinfo);
       DICOMGDCMImageFrameInfo(const DICOMImageFrameInfo::Pointer& frameinfo, gdcm::Scanner::TagToValue const& tagToValueMapping);
+      DICOMGDCMImageFrameInfo(const DICOMImageFrameInfo::Pointer& frameinfo, TagValueMapType const& tagToValueMapping);
       DICOMGDCMImageFrameInfo(const std::string& filename = "", unsigned int frameNo = 0);
 
-      const gdcm::Scanner::TagToValue m_TagForValue;
+      const TagValueMapType m_TagForValue;
   };
 
   typedef std::vector<DICOMGDCMImageFrameInfo::Pointer> DICOMGDCMImageFrameList;
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define mitkDICOMGDCMTagCache_h
 
 #include "mitkDICOMTagCache.h"
+#include "mitkDICOMGDCMImageFrameInfo.h"
 
 #include <set>
 #include <memory>
@@ -47,6 +48,16 @@ namespace mitk
 
       void InitCache(const std::set<DICOMTag>& scannedTags, const std::shared_ptr<gdcm::Scanner>& scanner, const StringList& inputFiles);
 
+      /**
+        \brief Initializes the cache with frames that already contain the scanned values.
+        GetScanner() is not available for caches initialized this way.
+      */
+      void InitCache(const std::set<DICOMTag>& scannedTags, const StringList& inputFiles, const DICOMGDCMImageFrameList& frames);
+
+      /**
+        \brief The scanner passed to InitCache().
+        \throw mitk::Exception if the cache was initialized without scanner.
+      */
       const gdcm::Scanner& GetScanner() const;
 
   protected:
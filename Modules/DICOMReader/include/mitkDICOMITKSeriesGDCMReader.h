@@ -47,6 +47,7 @@ namespace mitk
    - \ref DICOMITKSeriesGDCMReader_ForcedConfiguration
    - \ref DICOMITKSeriesGDCMReader_UserConfiguration
    - \ref DICOMITKSeriesGDCMReader_GantryTilt
+   - \ref DICOMITKSeriesGDCMReader_ParallelLoading
    - \ref DICOMITKSeriesGDCMReader_Testing
    - \ref DICOMITKSeriesGDCMReader_Internals
      - \ref DICOMITKSeriesGDCMReader_RelatedClasses
@@ -135,6 +136,24 @@ namespace mitk
    As such gemetries do not "work" in conjunction with mitk::Image, DICOMITKSeriesGDCMReader is able to perform a correction for such series.
    Whether or not such correction should be attempted is controlled by SetFixTiltByShearing(), the default being correction.
    For details, see "Internals" below.
+
+  \section DICOMITKSeriesGDCMReader_ParallelLoading Parallel loading
+
+   The geometry of each image block is determined by itk::ImageSeriesReader, but the
+   slices are decoded by GetNumberOfLoadingThreads() threads directly into the
+   mitk::Image, without an intermediate ITK image. Blocks which need the tilt
+   correction and files with multiple frames are read by itk::ImageSeriesReader
+   slice after slice, as is everything when SetDirectSliceLoading() is turned off.
+   The tool BenchmarkDICOMMitkImageLoading of module DICOMTesting measures the
+   throughput of both variants.
+
+   With SetLazyLoading() turned on, blocks that can be loaded directly are not
+   decoded at all while loading. The resulting DICOMLazyImage decodes slices on
+   their first access, together with some neighbouring slices, and whole time steps
+   when their volume is accessed. Opening large series then only takes the time
+   for scanning and sorting, and memory is only used for the parts that are accessed.
+   The files must stay available as long as the image is used.
+
   \section DICOMITKSeriesGDCMReader_Testing Testing
 
   A number of tests is implemented in module DICOMTesting, which is documented at \ref DICOMTesting.
@@ -231,6 +250,25 @@ class MITKDICOMREADER_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
 
     bool GetFixTiltByShearing() const;
 
+    /**
+      \brief Number of threads decoding the slices of an image block (see \ref DICOMITKSeriesGDCMReader_ParallelLoading).
+      0 (default) uses one thread per hardware thread.
+    */
+    void SetNumberOfLoadingThreads(unsigned int threads);
+    unsigned int GetNumberOfLoadingThreads() const;
+
+    /**
+      \brief Controls whether slices are decoded directly into the mitk::Image (see \ref DICOMITKSeriesGDCMReader_ParallelLoading).
+    */
+    void SetDirectSliceLoading(bool on);
+    bool GetDirectSliceLoading() const;
+
+    /**
+      \brief Controls whether slices are decoded on demand instead of while loading (default: off, see \ref DICOMITKSeriesGDCMReader_ParallelLoading).
+    */
+    void SetLazyLoading(bool on);
+    bool GetLazyLoading() const;
+
     /**
       \brief Controls whether groups of only two images are accepted when ensuring consecutive slices via EquiDistantBlocksSorter.
     */
@@ -349,6 +387,10 @@ class MITKDICOMREADER_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
 
     bool m_SimpleVolumeReading;
 
+    unsigned int m_NumberOfLoadingThreads;
+    bool m_DirectSliceLoading;
+    bool m_LazyLoading;
+
   private:
 
     SortingBlockList m_SortingResultInProgress;
@@ -0,0 +1,133 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkDICOMLazyImage_h
+#define mitkDICOMLazyImage_h
+
+#include "mitkImage.h"
+
+#include "MitkDICOMReaderExports.h"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+
+  /**
+    \ingroup DICOMReaderModule
+    \brief Image whose slices are decoded from their DICOM files on first access.
+
+    The image is initialized with its final geometry and pixel type, but
+    without pixel data. Every file provides exactly one slice. A slice is
+    decoded when it is accessed for the first time, together with up to
+    GetNumberOfPrefetchedSlices() not yet decoded neighbours on each side,
+    so that scrolling through the slices does not read file by file.
+    Accessing a volume (e.g. by vtk based rendering or an ImageReadAccessor)
+    decodes all missing slices of this time step, accessing the whole image
+    decodes all missing slices of all time steps. Slices which are never
+    accessed are never decoded.
+
+    The memory of a time step is allocated as a whole when its first slice
+    is decoded, but left uninitialized, so that operating systems which
+    commit memory pages on first write only use memory for decoded slices.
+
+    The class deliberately keeps the class name of mitk::Image (it does
+    not use mitkClassMacro), so that data type predicates, writers and the
+    scene serialization treat it like any other image. Copies (Clone())
+    are ordinary images with all slices decoded.
+
+    If slices cannot be decoded (e.g. because their files were removed in
+    the meantime), an error is logged and the slices are filled with zeros.
+
+    \sa DICOMITKSeriesGDCMReader::SetLazyLoading()
+  */
+  class MITKDICOMREADER_EXPORT DICOMLazyImage : public Image
+  {
+    public:
+
+      typedef DICOMLazyImage Self;
+      typedef Image Superclass;
+      typedef itk::SmartPointer<Self> Pointer;
+      typedef itk::SmartPointer<const Self> ConstPointer;
+
+      itkFactorylessNewMacro(Self);
+
+      typedef std::vector<std::string> StringContainer;
+
+      /** \brief Pairs of a file and the buffer its slice is decoded into. */
+      typedef std::vector<std::pair<std::string, void*>> SliceTargetList;
+
+      /** \brief Decodes the slices of all files into their buffers; called with the slices of one access. */
+      typedef std::function<void(const SliceTargetList&)> SliceReaderType;
+
+      /**
+        \brief Sets the files of all slices, one list of files per time step, and the function that decodes them.
+        The image must already be initialized, the number of lists must match its number of time steps
+        and the number of files in each list its number of slices.
+      */
+      void SetSliceFiles(const std::vector<StringContainer>& filenamesForTimeSteps, const SliceReaderType& sliceReader);
+
+      /** \brief Number of neighbouring slices on each side decoded together with an accessed slice (default 8). */
+      itkSetMacro(NumberOfPrefetchedSlices, unsigned int);
+      itkGetConstMacro(NumberOfPrefetchedSlices, unsigned int);
+
+      /** \brief Number of slices decoded so far. */
+      unsigned int GetNumberOfLoadedSlices() const;
+
+      ImageDataItemPointer GetSliceData(int s = 0,
+                                        int t = 0,
+                                        int n = 0,
+                                        void *data = nullptr,
+                                        ImportMemoryManagementType importMemoryManagement = CopyMemory) const override;
+
+      ImageDataItemPointer GetVolumeData(int t = 0,
+                                         int n = 0,
+                                         void *data = nullptr,
+                                         ImportMemoryManagementType importMemoryManagement = CopyMemory) const override;
+
+      ImageDataItemPointer GetChannelData(int n = 0,
+                                          void *data = nullptr,
+                                          ImportMemoryManagementType importMemoryManagement = CopyMemory) const override;
+
+    protected:
+
+      DICOMLazyImage();
+      ~DICOMLazyImage() override;
+
+      /** \brief Decodes all slices in [firstSlice, endSlice) of time step t that are not decoded yet. m_LoadingMutex must be locked. */
+      void LoadSlices(int firstSlice, int endSlice, int t) const;
+
+    private:
+
+      DICOMLazyImage(const DICOMLazyImage&) = delete;
+      DICOMLazyImage& operator=(const DICOMLazyImage&) = delete;
+
+      std::vector<StringContainer> m_FilenamesForTimeSteps;
+      SliceReaderType m_SliceReader;
+      unsigned int m_NumberOfPrefetchedSlices;
+      mutable unsigned int m_NumberOfLoadedSlices;
+
+      /** Serializes the decoding, so that no slice is returned before it is completely decoded. */
+      mutable std::mutex m_LoadingMutex;
+  };
+
+}
+
+#endif
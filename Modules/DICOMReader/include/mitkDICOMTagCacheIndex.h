@@ -0,0 +1,183 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkDICOMTagCacheIndex_h
+#define mitkDICOMTagCacheIndex_h
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mitkDICOMTagPath.h"
+
+#include "MitkDICOMReaderExports.h"
+
+namespace mitk
+{
+
+  /**
+    \ingroup DICOMReaderModule
+    \brief Persistent index of the tag values found by a DICOMTagScanner.
+
+    Scanning the headers of many DICOM files takes long, and the same
+    directories tend to be opened again and again. The index remembers
+    the values scanned from every file, keyed by the path, the modification
+    time (in nanoseconds, as far as the file system records it) and the size
+    of the file. A file whose modification time or size changed, or which was
+    not yet scanned for all requested tags, is scanned again.
+
+    The entries of all files in one directory are stored together in an
+    index file inside the cache directory. It is loaded when a file of the
+    directory is looked up for the first time and written by Save() if
+    entries were added. At most GetMaximumNumberOfFiles() entries are kept in
+    memory; if more are loaded or inserted, the least recently used
+    directories are written to their index files and removed from memory.
+    The scanners return different strings for the same tag (e.g. GDCM
+    returns binary values as raw bytes), so every scanner implementation uses
+    its own index, distinguished by the name passed to the constructor.
+
+    The index files determine the tag values returned for unchanged files,
+    so the cache directory must not be writable by other users. On POSIX
+    systems the directory is created with mode 0700, and an existing directory
+    is only used if it is owned by the current user and neither group nor
+    world writable. Otherwise the index is kept in memory only.
+
+    All methods are thread safe.
+  */
+  class MITKDICOMREADER_EXPORT DICOMTagCacheIndex
+  {
+    public:
+
+      /**
+        \brief Values found for one scanned tag path: the explicit path of every finding and its value.
+        An empty list means that the file does not contain the tag.
+      */
+      typedef std::vector<std::pair<DICOMTagPath, std::string>> FindingsType;
+      typedef std::map<DICOMTagPath, FindingsType> FileTagsType;
+
+      struct FileStatus
+      {
+        long long modificationTime; ///< nanoseconds since the epoch, in the resolution of the file system
+        unsigned long long size;
+      };
+
+      explicit DICOMTagCacheIndex(const std::string& name);
+      ~DICOMTagCacheIndex();
+
+      /**
+        \brief Directory of the index files.
+        An empty directory keeps the index in memory only. Defaults to the
+        environment variable MITK_DICOM_TAG_CACHE_DIR if it is set, and to
+        the per-user directory returned by GetDefaultCacheDirectory() otherwise.
+        Changing the directory forgets all entries in memory.
+      */
+      void SetCacheDirectory(const std::string& directory);
+      std::string GetCacheDirectory() const;
+
+      /**
+        \brief Per-user cache directory: "MITK/DICOMTagCache" in %LOCALAPPDATA% on Windows,
+        in ~/Library/Caches on macOS and in $XDG_CACHE_HOME (or ~/.cache) otherwise.
+        Empty if the home directory is unknown.
+      */
+      static std::string GetDefaultCacheDirectory();
+
+      /**
+        \brief Maximum number of files whose entries are kept in memory (default: 50000).
+      */
+      void SetMaximumNumberOfFiles(size_t maximumNumberOfFiles);
+      size_t GetMaximumNumberOfFiles() const;
+
+      /**
+        \brief Number of files whose entries are currently kept in memory.
+      */
+      size_t GetNumberOfFiles() const;
+
+      /**
+        \brief Determines modification time and size of a file.
+        \return false if the file does not exist.
+      */
+      static bool GetFileStatus(const std::string& filename, FileStatus& status);
+
+      /**
+        \brief Retrieves the values of scannedPaths for a file.
+        \return true if the index has an entry for the file with the given status which
+        contains all scannedPaths. tags then contains exactly these paths.
+      */
+      bool Lookup(const std::string& filename, const FileStatus& status,
+        const std::set<DICOMTagPath>& scannedPaths, FileTagsType& tags);
+
+      /**
+        \brief Adds the values scanned from a file to the index.
+        Values of other paths, which were scanned before from the same version
+        of the file, are kept.
+      */
+      void Insert(const std::string& filename, const FileStatus& status, const FileTagsType& tags);
+
+      /**
+        \brief Writes the index files of all directories with new entries.
+      */
+      void Save();
+
+      /**
+        \brief Forgets all entries in memory; the index files are kept.
+      */
+      void Clear();
+
+    private:
+
+      struct FileEntry
+      {
+        FileStatus status;
+        FileTagsType tags;
+      };
+
+      struct DirectoryIndex
+      {
+        bool modified = false;
+        unsigned long long lastUse = 0;
+        std::map<std::string, FileEntry> files;
+      };
+
+      DICOMTagCacheIndex(const DICOMTagCacheIndex&) = delete;
+      DICOMTagCacheIndex& operator=(const DICOMTagCacheIndex&) = delete;
+
+      /** Returns the index of the directory of filename, loading it if necessary. m_Mutex must be locked. */
+      DirectoryIndex& GetDirectoryIndex(const std::string& filename, std::string& directory, std::string& nameInDirectory);
+      std::string GetIndexFileName(const std::string& directory) const;
+      void LoadDirectoryIndex(const std::string& directory, DirectoryIndex& index) const;
+      void SaveDirectoryIndex(const std::string& directory, const DirectoryIndex& index) const;
+
+      /** Removes the least recently used directories except keptDirectory until at most m_MaximumNumberOfFiles
+          entries are left. Modified directories are saved first. m_Mutex must be locked. */
+      void EvictDirectories(const std::string& keptDirectory);
+
+      /** Checks that the cache directory can safely be used (see class description), creating it if requested. */
+      bool IsCacheDirectoryUsable(bool create) const;
+
+      std::string m_Name;
+      std::string m_CacheDirectory;
+      std::map<std::string, DirectoryIndex> m_Directories;
+      size_t m_NumberOfFiles;
+      size_t m_MaximumNumberOfFiles;
+      unsigned long long m_UseCounter;
+      mutable std::mutex m_Mutex;
+  };
+}
+
+#endif
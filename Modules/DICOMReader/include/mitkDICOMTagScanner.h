@@ -17,12 +17,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef mitkDICOMTagScanner_h
 #define mitkDICOMTagScanner_h
 
+#include <functional>
+#include <set>
 #include <stack>
 #include "itkMutexLock.h"
 
 #include "mitkDICOMEnums.h"
 #include "mitkDICOMTagPath.h"
 #include "mitkDICOMTagCache.h"
+#include "mitkDICOMTagCacheIndex.h"
 #include "mitkDICOMDatasetAccessingImageFrameInfo.h"
 
 namespace mitk
@@ -39,6 +42,12 @@ namespace mitk
 
     This is an abstract base class for concrete scanner implementations.
 
+    Scanning the files of a large directory is dominated by opening and parsing
+    the file headers, so implementations scan the files in parallel and keep the
+    results in a persistent DICOMTagCacheIndex (see ScanFiles()). Opening an
+    unchanged directory again then only needs the modification time and size
+    of every file.
+
     @remark When used in a process where multiple classes will access the scan
     results, care should be taken that all the tags and files of interest
     are communicated to DICOMTagScanner before requesting the results!
@@ -90,8 +99,40 @@ namespace mitk
       */
       virtual DICOMTagCache::Pointer GetScanCache() const = 0;
 
+      /**
+        \brief Number of threads scanning files in parallel.
+        0 (default) uses itk::MultiThreader::GetGlobalDefaultNumberOfThreads().
+      */
+      itkSetMacro(NumberOfThreads, unsigned int);
+      itkGetConstMacro(NumberOfThreads, unsigned int);
+
+      /**
+        \brief Whether scanned tag values are kept in the persistent DICOMTagCacheIndex (default: true).
+      */
+      itkSetMacro(UsePersistentCache, bool);
+      itkGetConstMacro(UsePersistentCache, bool);
+      itkBooleanMacro(UsePersistentCache);
+
     protected:
 
+      typedef DICOMTagCacheIndex::FileTagsType FileTagsType;
+
+      /**
+        \brief Scans a list of files for the tags of the scanner.
+        Returns the tags of every file in the order of the given files. Every map has to contain
+        all scanned paths; an empty map marks a file which could not be read.
+      */
+      typedef std::function<std::vector<FileTagsType>(const StringList& filenames)> ScanFunctionType;
+
+      /**
+        \brief Scans the given files in parallel, taking the values of unchanged files from the index.
+        The files are split into chunks which are passed to scanFiles() from GetNumberOfThreads()
+        threads, so scanFiles() has to be thread safe. Unreadable files are not cached.
+        \return The tags of every file, in the order of the files.
+      */
+      std::vector<FileTagsType> ScanFiles(const StringList& filenames, const std::set<DICOMTagPath>& scannedPaths,
+        DICOMTagCacheIndex& index, const ScanFunctionType& scanFiles) const;
+
       /** \brief Return active C locale */
       static std::string GetActiveLocale();
       /**
@@ -108,6 +149,9 @@ namespace mitk
       DICOMTagScanner();
       ~DICOMTagScanner() override;
 
+      unsigned int m_NumberOfThreads;
+      bool m_UsePersistentCache;
+
     private:
 
       static itk::MutexLock::Pointer s_LocaleMutex;
@@ -18,11 +18,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define mitkDICOMSeriesReaderHelper_h
 
 #include "mitkImage.h"
+#include "mitkDICOMLazyImage.h"
 #include "mitkGantryTiltInformation.h"
 #include "mitkDICOMTag.h"
 
 #include <itkGDCMImageIO.h>
 
+#include <functional>
+
 /* Forward deceleration of an DCMTK class. Used in the txx but part of the interface.*/
 class OFDateTime;
 
@@ -40,6 +43,36 @@ class ITKDICOMSeriesReaderHelper
     typedef std::vector<std::string> StringContainer;
     typedef std::list<StringContainer> StringContainerList;
 
+    ITKDICOMSeriesReaderHelper();
+
+    /**
+      \brief Number of threads decoding slices in parallel when loading directly (see SetDirectSliceLoading()).
+      0 (default) uses itk::MultiThreader::GetGlobalDefaultNumberOfThreads().
+    */
+    void SetNumberOfThreads(unsigned int threads);
+    unsigned int GetNumberOfThreads() const;
+
+    /**
+      \brief Controls whether slices are decoded directly into the buffer of the mitk::Image (default: on).
+
+      Otherwise, each volume is read by itk::ImageSeriesReader and copied into the mitk::Image.
+      Direct loading decodes the slices on GetNumberOfThreads() threads and needs no intermediate
+      ITK image. Volumes which need the gantry tilt correction and files with more than one frame
+      are always read by itk::ImageSeriesReader.
+    */
+    void SetDirectSliceLoading(bool on);
+    bool GetDirectSliceLoading() const;
+
+    /**
+      \brief Controls whether Load() and Load3DnT() return a DICOMLazyImage (default: off).
+
+      The image is initialized with its geometry, but slices are only decoded on their first access.
+      Only effective together with SetDirectSliceLoading(); volumes that cannot be loaded directly
+      are loaded completely.
+    */
+    void SetLazyLoading(bool on);
+    bool GetLazyLoading() const;
+
     Image::Pointer Load( const StringContainer& filenames, bool correctTilt, const GantryTiltInformation& tiltInfo );
     Image::Pointer Load3DnT( const StringContainerList& filenamesLists, bool correctTilt, const GantryTiltInformation& tiltInfo );
 
@@ -50,6 +83,20 @@ class ITKDICOMSeriesReaderHelper
     typedef std::vector<TimeBounds> TimeBoundsList;
     typedef itk::FixedArray<OFDateTime,2>  DateTimeBounds;
 
+    /** Reads one file of an unexpected pixel type, converting it into the given slice buffer. */
+    typedef std::function<void(const std::string& filename, void* sliceBuffer)> ConvertingSliceReaderType;
+
+    /** Describes the slices expected by direct loading. Files that do not contain exactly one slice of
+     sliceSizeInBytes with the given component type and number of components are read by convertingReader.
+     */
+    struct SliceDecoding
+    {
+      size_t sliceSizeInBytes;
+      itk::ImageIOBase::IOComponentType componentType;
+      unsigned int numberOfComponents;
+      ConvertingSliceReaderType convertingReader;
+    };
+
 
     /** Scans the given files for the acquisition time and returns the lowest and
      highest acquisition date time as date time bounds via bounds.
@@ -94,6 +141,33 @@ class ITKDICOMSeriesReaderHelper
                     const GantryTiltInformation& tiltInfo,
                     itk::GDCMImageIO::Pointer& io);
 
+    /** Initializes image with the geometry determined by itk::ImageSeriesReader, without pixel data,
+     for decoding the slices directly into it (see SetDirectSliceLoading()).
+     @return false if the files cannot be loaded this way, e.g. because they contain multiple frames.
+     */
+    template <typename ImageType>
+    bool
+    InitializeForDirectLoading( Image* image,
+                                const StringContainerList& filenamesForTimeSteps,
+                                SliceDecoding& decoding ) const;
+
+    /** Decodes the slices of all time steps directly into a new mitk::Image.
+     @return nullptr if the files cannot be loaded this way.
+     */
+    template <typename ImageType>
+    Image::Pointer
+    LoadDICOMDirectly( const StringContainerList& filenamesForTimeSteps ) const;
+
+    /** Returns a DICOMLazyImage for the files that decodes its slices on access (see SetLazyLoading()).
+     @return nullptr if the files cannot be loaded directly.
+     */
+    template <typename ImageType>
+    Image::Pointer
+    LoadDICOMLazily( const StringContainerList& filenamesForTimeSteps ) const;
+
+    /** Decodes one slice per file into its buffer, using GetNumberOfThreads() threads. */
+    void ReadSlices( const DICOMLazyImage::SliceTargetList& slices, const SliceDecoding& decoding ) const;
+
     template <typename PixelType>
     Image::Pointer
     LoadDICOMByITK3DnT( const StringContainerList& filenames,
@@ -101,7 +175,9 @@ class ITKDICOMSeriesReaderHelper
                         const GantryTiltInformation& tiltInfo,
                         itk::GDCMImageIO::Pointer& io);
 
-
+    unsigned int m_NumberOfThreads;
+    bool m_DirectSliceLoading;
+    bool m_LazyLoading;
 };
 
 }
@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkITKDICOMSeriesReaderHelper.h"
 
+#include <itkImageFileReader.h>
 #include <itkImageSeriesReader.h>
 #include <itkResampleImageFilter.h>
 //#include <itkAffineTransform.h>
@@ -23,6 +24,139 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "dcmtk/ofstd/ofdatime.h"
 
+#include "mitkImageWriteAccessor.h"
+
+#include <cstring>
+
+template <typename ImageType>
+bool
+mitk::ITKDICOMSeriesReaderHelper
+::InitializeForDirectLoading( Image* image,
+                              const StringContainerList& filenamesForTimeSteps,
+                              SliceDecoding& decoding ) const
+{
+  typedef typename ImageType::PixelType PixelType;
+  typedef itk::ImageSeriesReader<ImageType> ReaderType;
+
+  const StringContainer& filenames = filenamesForTimeSteps.front();
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    if (filenamesOfTimeStep.size() != filenames.size())
+    {
+      return false;
+    }
+  }
+
+  // let ITK determine the geometry, so that it is exactly the one of the ITK based loading
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(itk::GDCMImageIO::New());
+  reader->ReverseOrderOff(); // see LoadDICOMByITK()
+  reader->SetFileNames(filenames);
+  reader->UpdateOutputInformation();
+
+  const typename ImageType::RegionType region = reader->GetOutput()->GetLargestPossibleRegion();
+  if (region.GetSize()[2] != filenames.size())
+  {
+    return false; // multi-frame files
+  }
+
+  typename ImageType::Pointer geometryImage = ImageType::New();
+  geometryImage->CopyInformation(reader->GetOutput());
+  geometryImage->SetRegions(region);
+
+  // same initialization as in LoadDICOMByITK() and LoadDICOMByITK3DnT()
+  if (ImageType::ImageDimension > 3)
+  {
+    image->InitializeByItk(geometryImage.GetPointer(), 1, filenamesForTimeSteps.size());
+  }
+  else
+  {
+    image->InitializeByItk(geometryImage.GetPointer());
+  }
+
+  auto pixelTypeIO = itk::GDCMImageIO::New();
+  pixelTypeIO->SetPixelTypeInfo(static_cast<const PixelType*>(nullptr));
+
+  const size_t sliceSizeInBytes = region.GetSize()[0] * region.GetSize()[1] * sizeof(PixelType);
+
+  // slices of another pixel type are converted like itk::ImageSeriesReader does
+  auto convertingReader = [sliceSizeInBytes](const std::string& filename, void* sliceBuffer)
+  {
+    typedef itk::ImageFileReader<ImageType> SliceReaderType;
+    typename SliceReaderType::Pointer sliceReader = SliceReaderType::New();
+    sliceReader->SetImageIO(itk::GDCMImageIO::New());
+    sliceReader->SetFileName(filename);
+    sliceReader->Update();
+
+    if (sliceReader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() * sizeof(PixelType) != sliceSizeInBytes)
+    {
+      mitkThrow() << "Size of slice " << filename << " does not match the size of the other slices.";
+    }
+    std::memcpy(sliceBuffer, sliceReader->GetOutput()->GetBufferPointer(), sliceSizeInBytes);
+  };
+
+  decoding.sliceSizeInBytes = sliceSizeInBytes;
+  decoding.componentType = pixelTypeIO->GetComponentType();
+  decoding.numberOfComponents = pixelTypeIO->GetNumberOfComponents();
+  decoding.convertingReader = convertingReader;
+
+  return true;
+}
+
+template <typename ImageType>
+mitk::Image::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::LoadDICOMDirectly( const StringContainerList& filenamesForTimeSteps ) const
+{
+  mitk::Image::Pointer image = mitk::Image::New();
+  SliceDecoding decoding;
+  if (!this->InitializeForDirectLoading<ImageType>(image, filenamesForTimeSteps, decoding))
+  {
+    return nullptr;
+  }
+
+  ImageWriteAccessor accessor(image);
+  char* buffer = static_cast<char*>(accessor.GetData());
+
+  // one slice per file, ordered by time step and file
+  DICOMLazyImage::SliceTargetList slices;
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    for (const auto& filename : filenamesOfTimeStep)
+    {
+      slices.emplace_back(filename, buffer + slices.size() * decoding.sliceSizeInBytes);
+    }
+  }
+
+  this->ReadSlices(slices, decoding);
+
+  return image;
+}
+
+template <typename ImageType>
+mitk::Image::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::LoadDICOMLazily( const StringContainerList& filenamesForTimeSteps ) const
+{
+  DICOMLazyImage::Pointer image = DICOMLazyImage::New();
+  SliceDecoding decoding;
+  if (!this->InitializeForDirectLoading<ImageType>(image, filenamesForTimeSteps, decoding))
+  {
+    return nullptr;
+  }
+
+  // the image outlives this helper, so the reader works on a copy of it
+  const ITKDICOMSeriesReaderHelper helper(*this);
+  image->SetSliceFiles(std::vector<StringContainer>(filenamesForTimeSteps.cbegin(), filenamesForTimeSteps.cend()),
+                       [helper, decoding](const DICOMLazyImage::SliceTargetList& slices)
+                       {
+                         // only pixel data is decoded here, the geometry was read with the reader's locale
+                         helper.ReadSlices(slices, decoding);
+                       });
+
+  return image.GetPointer();
+}
+
 template <typename PixelType>
 mitk::Image::Pointer
 mitk::ITKDICOMSeriesReaderHelper
@@ -33,6 +167,17 @@ mitk::ITKDICOMSeriesReaderHelper
     itk::GDCMImageIO::Pointer& io)
 {
   /******** Normal Case, 3D (also for GDCM < 2 usable) ***************/
+  if (m_DirectSliceLoading && !correctTilt)
+  {
+    const StringContainerList filenamesForTimeSteps(1, filenames);
+    mitk::Image::Pointer image = m_LazyLoading ? LoadDICOMLazily<itk::Image<PixelType, 3>>(filenamesForTimeSteps)
+                                               : LoadDICOMDirectly<itk::Image<PixelType, 3>>(filenamesForTimeSteps);
+    if (image.IsNotNull())
+    {
+      return image;
+    }
+  }
+
   mitk::Image::Pointer image = mitk::Image::New();
 
   typedef itk::Image<PixelType, 3> ImageType;
@@ -101,6 +246,18 @@ mitk::ITKDICOMSeriesReaderHelper
     mitkThrow() << "Error while loading 3D+t. Inconsistent size of generated time bounds list. List size: "<< timeBoundsList.size() << "; number of steps: "<<numberOfTimeSteps;
   }
 
+  if (m_DirectSliceLoading && !correctTilt)
+  {
+    mitk::Image::Pointer image = m_LazyLoading ? LoadDICOMLazily<itk::Image<PixelType, 4>>(filenamesForTimeSteps)
+                                               : LoadDICOMDirectly<itk::Image<PixelType, 4>>(filenamesForTimeSteps);
+    if (image.IsNotNull())
+    {
+      TimeGeometry::Pointer timeGeometry = GenerateTimeGeometry(image->GetGeometry(), timeBoundsList);
+      image->SetTimeGeometry(timeGeometry);
+      return image;
+    }
+  }
+
   mitk::Image::Pointer image = mitk::Image::New();
 
   typedef itk::Image<PixelType, 4> ImageType;
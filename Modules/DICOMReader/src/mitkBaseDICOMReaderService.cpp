@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkDICOMProperty.h>
 #include "legacy/mitkDicomSeriesReader.h"
 #include <mitkDICOMDCMTKTagScanner.h>
+#include <mitkDICOMITKSeriesGDCMReader.h>
 #include <mitkLocaleSwitch.h>
 #include "mitkIPropertyProvider.h"
 #include "mitkPropertyNameHelper.h"
@@ -40,13 +41,27 @@ namespace mitk {
   BaseDICOMReaderService::BaseDICOMReaderService(const std::string& description)
     : AbstractFileReader(CustomMimeType(IOMimeTypes::DICOM_MIMETYPE()), description)
 {
+  this->SetDefaultLoadingOptions();
 }
 
   BaseDICOMReaderService::BaseDICOMReaderService(const mitk::CustomMimeType& customType, const std::string& description)
     : AbstractFileReader(customType, description)
   {
+    this->SetDefaultLoadingOptions();
   }
 
+void BaseDICOMReaderService::SetDefaultLoadingOptions()
+{
+  Options defaultOptions;
+  defaultOptions[LAZY_LOADING_OPTION()] = false;
+  this->SetDefaultOptions(defaultOptions);
+}
+
+std::string BaseDICOMReaderService::LAZY_LOADING_OPTION()
+{
+  return "Load slices on demand";
+}
+
 std::vector<itk::SmartPointer<BaseData> > BaseDICOMReaderService::Read()
 {
   std::vector<BaseData::Pointer> result;
@@ -125,6 +140,14 @@ std::vector<itk::SmartPointer<BaseData> > BaseDICOMReaderService::Read()
             m_ReadFiles.push_back( relevantFiles.at(i) );
           }
 
+          // derived services may replace the default options, then the option is missing
+          const us::Any lazyLoading = this->GetOption(LAZY_LOADING_OPTION());
+          auto gdcmReader = dynamic_cast<DICOMITKSeriesGDCMReader*>(reader.GetPointer());
+          if (gdcmReader != nullptr && !lazyLoading.Empty())
+          {
+            gdcmReader->SetLazyLoading(us::any_cast<bool>(lazyLoading));
+          }
+
           reader->SetAdditionalTagsOfInterest(mitk::GetCurrentDICOMTagsOfInterest());
           reader->SetTagLookupTableToPropertyFunctor(mitk::GetDICOMPropertyForDICOMValuesFunctor);
           reader->SetInputFiles(relevantFiles);
@@ -20,6 +20,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <dcmtk/dcmdata/dcfilefo.h>
 #include <dcmtk/dcmdata/dcpath.h>
 
+namespace
+{
+  mitk::DICOMTagCacheIndex& GetTagCacheIndex()
+  {
+    static mitk::DICOMTagCacheIndex index("dcmtk");
+    return index;
+  }
+}
+
 mitk::DICOMDCMTKTagScanner::DICOMDCMTKTagScanner()
 {
 }
@@ -108,57 +117,37 @@ void mitk::DICOMDCMTKTagScanner::Scan()
 
   try
   {
-    DcmPathProcessor processor;
-    processor.setItemWildcardSupport(true);
+    auto scanFiles = [this](const StringList& filenames)
+    {
+      std::vector<FileTagsType> result;
+      result.reserve(filenames.size());
+      for (const auto& fileName : filenames)
+      {
+        result.push_back(this->ScanFile(fileName));
+      }
+      return result;
+    };
+
+    const std::vector<FileTagsType> fileTags = this->ScanFiles(m_InputFilenames, m_ScannedTags, GetTagCacheIndex(), scanFiles);
 
     DICOMGenericTagCache::Pointer newCache = DICOMGenericTagCache::New();
 
-    for (const auto& fileName : this->m_InputFilenames)
+    for (size_t i = 0; i < m_InputFilenames.size(); ++i)
     {
-      DcmFileFormat dfile;
-      OFCondition cond = dfile.loadFile(fileName.c_str());
-      if (cond.bad())
+      if (fileTags[i].empty() && !m_ScannedTags.empty())
       {
-        MITK_ERROR << "Error when scanning for tags. Cannot open given file. File: " << fileName;
+        continue; // could not be read, see ScanFile()
       }
-      else
-      {
-        DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(fileName);
 
-        for (const auto& path : this->m_ScannedTags)
+      DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(m_InputFilenames[i]);
+      for (const auto& tag : fileTags[i])
+      {
+        for (const auto& finding : tag.second)
         {
-          std::string tagPath = DICOMTagPathToDCMTKSearchPath(path);
-          cond = processor.findOrCreatePath(dfile.getDataset(), tagPath.c_str());
-          if (cond.good())
-          {
-            OFList< DcmPath * > findings;
-            processor.getResults(findings);
-            for (const auto& finding : findings)
-            {
-              auto element = dynamic_cast<DcmElement*>(finding->back()->m_obj);
-              if (!element)
-              {
-                auto item = dynamic_cast<DcmItem*>(finding->back()->m_obj);
-                if (item)
-                {
-                  element = item->getElement(finding->back()->m_itemNo);
-                }
-              }
-
-              if (element)
-              {
-                OFString value;
-                cond = element->getOFStringArray(value);
-                if (cond.good())
-                {
-                  info->SetTagValue(DcmPathToTagPath(finding), std::string(value.c_str()));
-                }
-              }
-            }
-          }
+          info->SetTagValue(finding.first, finding.second);
         }
-        newCache->AddFrameInfo(info);
       }
+      newCache->AddFrameInfo(info);
     }
 
     m_Cache = newCache;
@@ -172,6 +161,59 @@ void mitk::DICOMDCMTKTagScanner::Scan()
   }
 }
 
+mitk::DICOMTagCacheIndex::FileTagsType mitk::DICOMDCMTKTagScanner::ScanFile(const std::string& fileName) const
+{
+  FileTagsType result;
+
+  DcmFileFormat dfile;
+  OFCondition cond = dfile.loadFile(fileName.c_str());
+  if (cond.bad())
+  {
+    MITK_ERROR << "Error when scanning for tags. Cannot open given file. File: " << fileName;
+    return result;
+  }
+
+  DcmPathProcessor processor;
+  processor.setItemWildcardSupport(true);
+
+  for (const auto& path : this->m_ScannedTags)
+  {
+    DICOMTagCacheIndex::FindingsType& pathFindings = result[path];
+
+    std::string tagPath = DICOMTagPathToDCMTKSearchPath(path);
+    cond = processor.findOrCreatePath(dfile.getDataset(), tagPath.c_str());
+    if (cond.good())
+    {
+      OFList< DcmPath * > findings;
+      processor.getResults(findings);
+      for (const auto& finding : findings)
+      {
+        auto element = dynamic_cast<DcmElement*>(finding->back()->m_obj);
+        if (!element)
+        {
+          auto item = dynamic_cast<DcmItem*>(finding->back()->m_obj);
+          if (item)
+          {
+            element = item->getElement(finding->back()->m_itemNo);
+          }
+        }
+
+        if (element)
+        {
+          OFString value;
+          cond = element->getOFStringArray(value);
+          if (cond.good())
+          {
+            pathFindings.emplace_back(DcmPathToTagPath(finding), std::string(value.c_str()));
+          }
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
 mitk::DICOMTagCache::Pointer
 mitk::DICOMDCMTKTagScanner::GetScanCache() const
 {
@@ -16,6 +16,19 @@
 
 #include "mitkDICOMGDCMImageFrameInfo.h"
 
+namespace
+{
+  mitk::DICOMGDCMImageFrameInfo::TagValueMapType CopyTagValues(gdcm::Scanner::TagToValue const& tagToValueMapping)
+  {
+    mitk::DICOMGDCMImageFrameInfo::TagValueMapType result;
+    for (const auto& tagValue : tagToValueMapping)
+    {
+      result.emplace_hint(result.end(), tagValue.first, tagValue.second != nullptr ? tagValue.second : "");
+    }
+    return result;
+  }
+}
+
 mitk::DICOMGDCMImageFrameInfo
 ::DICOMGDCMImageFrameInfo(const std::string& filename, unsigned int frameNo)
 :DICOMDatasetAccessingImageFrameInfo(filename, frameNo)
@@ -33,6 +46,13 @@ mitk::DICOMGDCMImageFrameInfo
 mitk::DICOMGDCMImageFrameInfo
 ::DICOMGDCMImageFrameInfo(const DICOMImageFrameInfo::Pointer& frameinfo, gdcm::Scanner::TagToValue const& tagToValueMapping)
 :DICOMDatasetAccessingImageFrameInfo(frameinfo->Filename, frameinfo->FrameNo)
+,m_TagForValue(CopyTagValues(tagToValueMapping))
+{
+}
+
+mitk::DICOMGDCMImageFrameInfo
+::DICOMGDCMImageFrameInfo(const DICOMImageFrameInfo::Pointer& frameinfo, TagValueMapType const& tagToValueMapping)
+:DICOMDatasetAccessingImageFrameInfo(frameinfo->Filename, frameinfo->FrameNo)
 ,m_TagForValue(tagToValueMapping)
 {
 }
@@ -53,21 +73,14 @@ mitk::DICOMGDCMImageFrameInfo
   {
     result.isValid = true;
 
-    if (mappedValue->second != nullptr)
+    std::string s(mappedValue->second);
+    try
     {
-      std::string s(mappedValue->second);
-      try
-      {
-        result.value = s.erase(s.find_last_not_of(" \n\r\t")+1);
-      }
-      catch(...)
-      {
-        result.value = s;
-      }
+      result.value = s.erase(s.find_last_not_of(" \n\r\t")+1);
     }
-    else
+    catch(...)
     {
-      result.value = "";
+      result.value = s;
     }
   }
   else
@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDICOMEnums.h"
 #include "mitkDICOMGDCMImageFrameInfo.h"
 
+#include <mitkExceptionMacro.h>
+
 mitk::DICOMGDCMTagCache::DICOMGDCMTagCache()
 {
 }
@@ -101,8 +103,28 @@ mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const
   }
 }
 
+void
+mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const StringList& inputFiles, const DICOMGDCMImageFrameList& frames)
+{
+  m_ScannedTags = scannedTags;
+  m_InputFilenames = inputFiles;
+  m_Scanner.reset();
+
+  m_ScanResult.clear();
+  m_ScanResult.reserve(frames.size());
+
+  for (const auto& frame : frames)
+  {
+    m_ScanResult.push_back(frame.GetPointer());
+  }
+}
+
 const gdcm::Scanner&
 mitk::DICOMGDCMTagCache::GetScanner() const
 {
+  if (!m_Scanner)
+  {
+    mitkThrow() << "DICOMGDCMTagCache was initialized without gdcm::Scanner.";
+  }
   return *(this->m_Scanner);
 }
@@ -20,9 +20,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <gdcmScanner.h>
 
+namespace
+{
+  mitk::DICOMTagCacheIndex& GetTagCacheIndex()
+  {
+    static mitk::DICOMTagCacheIndex index("gdcm");
+    return index;
+  }
+}
+
 mitk::DICOMGDCMTagScanner::DICOMGDCMTagScanner()
 {
-  m_GDCMScanner = std::make_shared<gdcm::Scanner>();
 }
 
 mitk::DICOMGDCMTagScanner::~DICOMGDCMTagScanner()
@@ -45,8 +53,6 @@ mitk::DICOMDatasetFinding mitk::DICOMGDCMTagScanner::GetTagValue( DICOMImageFram
 void mitk::DICOMGDCMTagScanner::AddTag( const DICOMTag& tag )
 {
   m_ScannedTags.insert( tag );
-  m_GDCMScanner->AddTag(
-    gdcm::Tag( tag.GetGroup(), tag.GetElement() ) ); // also a set, duplicate calls to AddTag don't hurt
 }
 
 void mitk::DICOMGDCMTagScanner::AddTags( const DICOMTagList& tags )
@@ -97,10 +103,66 @@ void mitk::DICOMGDCMTagScanner::SetInputFiles( const StringList& filenames )
 void mitk::DICOMGDCMTagScanner::Scan()
 {
   // TODO integrate push/pop locale??
-  m_GDCMScanner->Scan( m_InputFilenames );
+  std::set<DICOMTagPath> scannedPaths;
+  for (const auto& tag : m_ScannedTags)
+  {
+    scannedPaths.insert(DICOMTagPath(tag));
+  }
+
+  auto scanFiles = [this](const StringList& filenames)
+  {
+    // gdcm::Scanner is not thread safe, so every chunk uses its own
+    gdcm::Scanner scanner;
+    for (const auto& tag : m_ScannedTags)
+    {
+      scanner.AddTag(gdcm::Tag(tag.GetGroup(), tag.GetElement()));
+    }
+    scanner.Scan(filenames);
+
+    std::vector<FileTagsType> result(filenames.size());
+    for (size_t i = 0; i < filenames.size(); ++i)
+    {
+      if (!scanner.IsKey(filenames[i].c_str()))
+      {
+        continue; // not readable, leave empty
+      }
+
+      const gdcm::Scanner::TagToValue& mapping = scanner.GetMapping(filenames[i].c_str());
+      for (const auto& tag : m_ScannedTags)
+      {
+        const DICOMTagPath path(tag);
+        DICOMTagCacheIndex::FindingsType& findings = result[i][path];
+
+        const auto value = mapping.find(gdcm::Tag(tag.GetGroup(), tag.GetElement()));
+        if (value != mapping.cend())
+        {
+          findings.emplace_back(path, value->second != nullptr ? value->second : "");
+        }
+      }
+    }
+    return result;
+  };
+
+  const std::vector<FileTagsType> fileTags = this->ScanFiles(m_InputFilenames, scannedPaths, GetTagCacheIndex(), scanFiles);
+
+  DICOMGDCMImageFrameList frames;
+  frames.reserve(m_InputFilenames.size());
+  for (size_t i = 0; i < m_InputFilenames.size(); ++i)
+  {
+    DICOMGDCMImageFrameInfo::TagValueMapType tagValues;
+    for (const auto& tag : fileTags[i])
+    {
+      if (!tag.second.empty())
+      {
+        const DICOMTag& dicomTag = tag.first.GetFirstNode().tag;
+        tagValues.emplace(gdcm::Tag(dicomTag.GetGroup(), dicomTag.GetElement()), tag.second.front().second);
+      }
+    }
+    frames.push_back(DICOMGDCMImageFrameInfo::New(DICOMImageFrameInfo::New(m_InputFilenames[i], 0), tagValues));
+  }
 
   DICOMGDCMTagCache::Pointer newCache = DICOMGDCMTagCache::New();
-  newCache->InitCache(m_ScannedTags, m_GDCMScanner, m_InputFilenames);
+  newCache->InitCache(m_ScannedTags, m_InputFilenames, frames);
 
   m_Cache = newCache;
 }
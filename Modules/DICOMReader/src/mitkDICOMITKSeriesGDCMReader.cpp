@@ -32,6 +32,9 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( unsigned int decimalPl
 : DICOMFileReader()
 , m_FixTiltByShearing(m_DefaultFixTiltByShearing)
 , m_SimpleVolumeReading( simpleVolumeImport )
+, m_NumberOfLoadingThreads( 0 )
+, m_DirectSliceLoading( true )
+, m_LazyLoading( false )
 , m_DecimalPlacesForOrientation( decimalPlacesForOrientation )
 , m_ExternalCache(false)
 {
@@ -42,6 +45,9 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( unsigned int decimalPl
 mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( const DICOMITKSeriesGDCMReader& other )
 : DICOMFileReader( other )
 , m_FixTiltByShearing( other.m_FixTiltByShearing)
+, m_NumberOfLoadingThreads( other.m_NumberOfLoadingThreads )
+, m_DirectSliceLoading( other.m_DirectSliceLoading )
+, m_LazyLoading( other.m_LazyLoading )
 , m_SortingResultInProgress( other.m_SortingResultInProgress )
 , m_Sorter( other.m_Sorter )
 , m_EquiDistantBlocksSorter( other.m_EquiDistantBlocksSorter->Clone() )
@@ -65,6 +71,9 @@ mitk::DICOMITKSeriesGDCMReader& mitk::DICOMITKSeriesGDCMReader::
   {
     DICOMFileReader::operator                =( other );
     this->m_FixTiltByShearing                = other.m_FixTiltByShearing;
+    this->m_NumberOfLoadingThreads           = other.m_NumberOfLoadingThreads;
+    this->m_DirectSliceLoading               = other.m_DirectSliceLoading;
+    this->m_LazyLoading                      = other.m_LazyLoading;
     this->m_SortingResultInProgress          = other.m_SortingResultInProgress;
     this->m_Sorter                           = other.m_Sorter; // TODO should clone the list items
     this->m_EquiDistantBlocksSorter          = other.m_EquiDistantBlocksSorter->Clone();
@@ -123,6 +132,36 @@ bool mitk::DICOMITKSeriesGDCMReader::GetFixTiltByShearing() const
   return m_FixTiltByShearing;
 }
 
+void mitk::DICOMITKSeriesGDCMReader::SetNumberOfLoadingThreads( unsigned int threads )
+{
+  m_NumberOfLoadingThreads = threads;
+}
+
+unsigned int mitk::DICOMITKSeriesGDCMReader::GetNumberOfLoadingThreads() const
+{
+  return m_NumberOfLoadingThreads;
+}
+
+void mitk::DICOMITKSeriesGDCMReader::SetDirectSliceLoading( bool on )
+{
+  m_DirectSliceLoading = on;
+}
+
+bool mitk::DICOMITKSeriesGDCMReader::GetDirectSliceLoading() const
+{
+  return m_DirectSliceLoading;
+}
+
+void mitk::DICOMITKSeriesGDCMReader::SetLazyLoading( bool on )
+{
+  m_LazyLoading = on;
+}
+
+bool mitk::DICOMITKSeriesGDCMReader::GetLazyLoading() const
+{
+  return m_LazyLoading;
+}
+
 void mitk::DICOMITKSeriesGDCMReader::SetAcceptTwoSlicesGroups( bool accept ) const
 {
   this->Modified();
@@ -451,6 +490,9 @@ bool mitk::DICOMITKSeriesGDCMReader::LoadMitkImageForImageBlockDescriptor(
   }
 
   mitk::ITKDICOMSeriesReaderHelper helper;
+  helper.SetNumberOfThreads( m_NumberOfLoadingThreads );
+  helper.SetDirectSliceLoading( m_DirectSliceLoading );
+  helper.SetLazyLoading( m_LazyLoading );
   bool success( true );
   try
   {
@@ -0,0 +1,161 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMLazyImage.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkLogMacros.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+mitk::DICOMLazyImage::DICOMLazyImage()
+  : m_NumberOfPrefetchedSlices(8),
+    m_NumberOfLoadedSlices(0)
+{
+}
+
+mitk::DICOMLazyImage::~DICOMLazyImage()
+{
+}
+
+void mitk::DICOMLazyImage::SetSliceFiles(const std::vector<StringContainer>& filenamesForTimeSteps,
+                                         const SliceReaderType& sliceReader)
+{
+  if (!this->IsInitialized())
+  {
+    mitkThrow() << "DICOMLazyImage must be initialized before its slice files are set.";
+  }
+
+  if (filenamesForTimeSteps.size() != this->GetDimension(3))
+  {
+    mitkThrow() << "DICOMLazyImage has " << this->GetDimension(3) << " time steps, but files for "
+                << filenamesForTimeSteps.size() << " time steps were passed.";
+  }
+
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    if (filenamesOfTimeStep.size() != this->GetDimension(2))
+    {
+      mitkThrow() << "DICOMLazyImage has " << this->GetDimension(2) << " slices, but a time step with "
+                  << filenamesOfTimeStep.size() << " files was passed.";
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_LoadingMutex);
+  m_FilenamesForTimeSteps = filenamesForTimeSteps;
+  m_SliceReader = sliceReader;
+}
+
+unsigned int mitk::DICOMLazyImage::GetNumberOfLoadedSlices() const
+{
+  std::lock_guard<std::mutex> lock(m_LoadingMutex);
+  return m_NumberOfLoadedSlices;
+}
+
+mitk::Image::ImageDataItemPointer mitk::DICOMLazyImage::GetSliceData(
+  int s, int t, int n, void *data, ImportMemoryManagementType importMemoryManagement) const
+{
+  std::lock_guard<std::mutex> lock(m_LoadingMutex);
+
+  if (n == 0 && this->IsValidSlice(s, t, n) && !this->IsSliceSet(s, t, n))
+  {
+    const int prefetched = static_cast<int>(m_NumberOfPrefetchedSlices);
+    const int numberOfSlices = static_cast<int>(this->GetDimension(2));
+    this->LoadSlices(std::max(0, s - prefetched), std::min(numberOfSlices, s + prefetched + 1), t);
+  }
+
+  return Superclass::GetSliceData(s, t, n, data, importMemoryManagement);
+}
+
+mitk::Image::ImageDataItemPointer mitk::DICOMLazyImage::GetVolumeData(
+  int t, int n, void *data, ImportMemoryManagementType importMemoryManagement) const
+{
+  std::lock_guard<std::mutex> lock(m_LoadingMutex);
+
+  if (n == 0 && this->IsValidVolume(t, n) && !this->IsVolumeSet(t, n))
+  {
+    this->LoadSlices(0, this->GetDimension(2), t);
+  }
+
+  return Superclass::GetVolumeData(t, n, data, importMemoryManagement);
+}
+
+mitk::Image::ImageDataItemPointer mitk::DICOMLazyImage::GetChannelData(
+  int n, void *data, ImportMemoryManagementType importMemoryManagement) const
+{
+  std::lock_guard<std::mutex> lock(m_LoadingMutex);
+
+  if (n == 0 && this->IsValidChannel(n) && !this->IsChannelSet(n))
+  {
+    for (unsigned int t = 0; t < this->GetDimension(3); ++t)
+    {
+      if (!this->IsVolumeSet(t, n))
+      {
+        this->LoadSlices(0, this->GetDimension(2), t);
+      }
+    }
+  }
+
+  return Superclass::GetChannelData(n, data, importMemoryManagement);
+}
+
+void mitk::DICOMLazyImage::LoadSlices(int firstSlice, int endSlice, int t) const
+{
+  if (static_cast<size_t>(t) >= m_FilenamesForTimeSteps.size() || !m_SliceReader)
+  {
+    return; // not (yet) connected to files, behave like a plain image
+  }
+
+  const StringContainer& filenames = m_FilenamesForTimeSteps[t];
+  const size_t sliceSizeInBytes = static_cast<size_t>(this->GetDimension(0)) * this->GetDimension(1)
+                                  * this->GetPixelType().GetSize();
+
+  // obtaining the slices allocates the whole volume of the time step, but does not touch its memory.
+  // No image accessors here: they lock the image, which may be locked by a caller waiting for this decoding.
+  SliceTargetList slices;
+  for (int s = firstSlice; s < endSlice; ++s)
+  {
+    if (!this->IsSliceSet(s, t, 0))
+    {
+      slices.emplace_back(filenames[s], Superclass::GetSliceData(s, t, 0)->GetData());
+    }
+  }
+
+  if (slices.empty())
+  {
+    return;
+  }
+
+  MITK_DEBUG << "Decoding " << slices.size() << " slices of time step " << t;
+
+  try
+  {
+    m_SliceReader(slices);
+  }
+  catch (const std::exception& e)
+  {
+    MITK_ERROR << "Cannot decode slices " << firstSlice << " to " << endSlice - 1 << " of time step " << t << ": "
+               << e.what();
+    for (const auto& slice : slices)
+    {
+      std::memset(slice.second, 0, sliceSizeInBytes);
+    }
+  }
+
+  m_NumberOfLoadedSlices += static_cast<unsigned int>(slices.size());
+}
@@ -0,0 +1,543 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMTagCacheIndex.h"
+
+#include <mitkLogMacros.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <itksys/Encoding.hxx>
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  // The index files are a cache of the local machine, so they are written in native byte order.
+  const char IndexFileMagic[] = "MITKDICOMTagCacheIndex";
+  const std::uint32_t IndexFileVersion = 2;
+
+  template <typename T>
+  void WriteValue(std::ostream& stream, T value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void WriteString(std::ostream& stream, const std::string& value)
+  {
+    WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(value.size()));
+    stream.write(value.data(), value.size());
+  }
+
+  void WritePath(std::ostream& stream, const mitk::DICOMTagPath& path)
+  {
+    WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(path.Size()));
+    for (const auto& node : path.GetNodes())
+    {
+      WriteValue<std::uint8_t>(stream, static_cast<std::uint8_t>(node.type));
+      WriteValue<std::uint16_t>(stream, static_cast<std::uint16_t>(node.tag.GetGroup()));
+      WriteValue<std::uint16_t>(stream, static_cast<std::uint16_t>(node.tag.GetElement()));
+      WriteValue<std::int32_t>(stream, static_cast<std::int32_t>(node.selection));
+    }
+  }
+
+  template <typename T>
+  T ReadValue(std::istream& stream)
+  {
+    T value = T();
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream)
+    {
+      throw std::runtime_error("Unexpected end of index file.");
+    }
+    return value;
+  }
+
+  std::string ReadString(std::istream& stream)
+  {
+    auto size = ReadValue<std::uint32_t>(stream);
+    if (size > (1u << 26))
+    {
+      throw std::runtime_error("Invalid string in index file.");
+    }
+    std::string value(size, '\0');
+    stream.read(&value[0], size);
+    if (!stream)
+    {
+      throw std::runtime_error("Unexpected end of index file.");
+    }
+    return value;
+  }
+
+  // DICOMTagPath::FromStr() uses regular expressions, which is much too slow for the number of paths in an index
+  mitk::DICOMTagPath ReadPath(std::istream& stream)
+  {
+    mitk::DICOMTagPath path;
+    auto size = ReadValue<std::uint32_t>(stream);
+    for (std::uint32_t i = 0; i < size; ++i)
+    {
+      auto type = ReadValue<std::uint8_t>(stream);
+      auto group = ReadValue<std::uint16_t>(stream);
+      auto element = ReadValue<std::uint16_t>(stream);
+      auto selection = ReadValue<std::int32_t>(stream);
+
+      if (type > static_cast<std::uint8_t>(mitk::DICOMTagPath::NodeInfo::NodeType::AnyElement))
+      {
+        throw std::runtime_error("Invalid tag path in index file.");
+      }
+      path.AddNode(mitk::DICOMTagPath::NodeInfo(mitk::DICOMTag(group, element),
+        static_cast<mitk::DICOMTagPath::NodeInfo::NodeType>(type), selection));
+    }
+    return path;
+  }
+
+  // FNV-1a, which in contrast to std::hash gives the same index file names for every build
+  std::uint64_t HashString(const std::string& value)
+  {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : value)
+    {
+      hash ^= c;
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+}
+
+mitk::DICOMTagCacheIndex::DICOMTagCacheIndex(const std::string& name)
+  : m_Name(name), m_NumberOfFiles(0), m_MaximumNumberOfFiles(50000), m_UseCounter(0)
+{
+  if (!itksys::SystemTools::GetEnv("MITK_DICOM_TAG_CACHE_DIR", m_CacheDirectory))
+  {
+    m_CacheDirectory = GetDefaultCacheDirectory();
+  }
+}
+
+mitk::DICOMTagCacheIndex::~DICOMTagCacheIndex()
+{
+}
+
+void mitk::DICOMTagCacheIndex::SetCacheDirectory(const std::string& directory)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_CacheDirectory = directory;
+  m_Directories.clear();
+  m_NumberOfFiles = 0;
+}
+
+std::string mitk::DICOMTagCacheIndex::GetCacheDirectory() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_CacheDirectory;
+}
+
+std::string mitk::DICOMTagCacheIndex::GetDefaultCacheDirectory()
+{
+  std::string base;
+#if defined(_WIN32)
+  if (!itksys::SystemTools::GetEnv("LOCALAPPDATA", base) || base.empty())
+  {
+    return std::string();
+  }
+#elif defined(__APPLE__)
+  if (!itksys::SystemTools::GetEnv("HOME", base) || base.empty())
+  {
+    return std::string();
+  }
+  base += "/Library/Caches";
+#else
+  if (!itksys::SystemTools::GetEnv("XDG_CACHE_HOME", base) || base.empty())
+  {
+    if (!itksys::SystemTools::GetEnv("HOME", base) || base.empty())
+    {
+      return std::string();
+    }
+    base += "/.cache";
+  }
+#endif
+  return base + "/MITK/DICOMTagCache";
+}
+
+void mitk::DICOMTagCacheIndex::SetMaximumNumberOfFiles(size_t maximumNumberOfFiles)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MaximumNumberOfFiles = maximumNumberOfFiles;
+  this->EvictDirectories(std::string());
+}
+
+size_t mitk::DICOMTagCacheIndex::GetMaximumNumberOfFiles() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumNumberOfFiles;
+}
+
+size_t mitk::DICOMTagCacheIndex::GetNumberOfFiles() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfFiles;
+}
+
+bool mitk::DICOMTagCacheIndex::GetFileStatus(const std::string& filename, FileStatus& status)
+{
+#ifdef _WIN32
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if (!GetFileAttributesExW(itksys::Encoding::ToWide(filename).c_str(), GetFileExInfoStandard, &data)
+    || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+  {
+    return false;
+  }
+
+  // FILETIME counts 100 ns intervals since 1601-01-01
+  const unsigned long long fileTime =
+    (static_cast<unsigned long long>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+  status.modificationTime = (static_cast<long long>(fileTime) - 116444736000000000LL) * 100;
+  status.size = (static_cast<unsigned long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+#else
+  struct stat fileStatus;
+  if (stat(filename.c_str(), &fileStatus) != 0 || S_ISDIR(fileStatus.st_mode))
+  {
+    return false;
+  }
+
+#ifdef __APPLE__
+  const long long nanoseconds = fileStatus.st_mtimespec.tv_nsec;
+#else
+  const long long nanoseconds = fileStatus.st_mtim.tv_nsec;
+#endif
+  status.modificationTime = static_cast<long long>(fileStatus.st_mtime) * 1000000000LL + nanoseconds;
+  status.size = static_cast<unsigned long long>(fileStatus.st_size);
+#endif
+  return true;
+}
+
+bool mitk::DICOMTagCacheIndex::Lookup(const std::string& filename, const FileStatus& status,
+  const std::set<DICOMTagPath>& scannedPaths, FileTagsType& tags)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  std::string directory;
+  std::string nameInDirectory;
+  const DirectoryIndex& index = this->GetDirectoryIndex(filename, directory, nameInDirectory);
+
+  auto entry = index.files.find(nameInDirectory);
+  if (entry == index.files.cend()
+    || entry->second.status.modificationTime != status.modificationTime
+    || entry->second.status.size != status.size)
+  {
+    return false;
+  }
+
+  FileTagsType result;
+  for (const auto& path : scannedPaths)
+  {
+    auto finding = entry->second.tags.find(path);
+    if (finding == entry->second.tags.cend())
+    {
+      return false;
+    }
+    result.insert(*finding);
+  }
+
+  tags.swap(result);
+  return true;
+}
+
+void mitk::DICOMTagCacheIndex::Insert(const std::string& filename, const FileStatus& status, const FileTagsType& tags)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  std::string directory;
+  std::string nameInDirectory;
+  DirectoryIndex& index = this->GetDirectoryIndex(filename, directory, nameInDirectory);
+
+  auto inserted = index.files.emplace(nameInDirectory, FileEntry());
+  FileEntry& entry = inserted.first->second;
+  if (!inserted.second && (entry.status.modificationTime != status.modificationTime || entry.status.size != status.size))
+  {
+    entry.tags.clear();
+  }
+  entry.status = status;
+  for (const auto& tag : tags)
+  {
+    entry.tags[tag.first] = tag.second;
+  }
+  index.modified = true;
+
+  if (inserted.second)
+  {
+    ++m_NumberOfFiles;
+    this->EvictDirectories(directory);
+  }
+}
+
+void mitk::DICOMTagCacheIndex::Save()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_CacheDirectory.empty())
+  {
+    return;
+  }
+
+  for (auto& directory : m_Directories)
+  {
+    if (directory.second.modified)
+    {
+      this->SaveDirectoryIndex(directory.first, directory.second);
+      directory.second.modified = false;
+    }
+  }
+}
+
+void mitk::DICOMTagCacheIndex::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Directories.clear();
+  m_NumberOfFiles = 0;
+}
+
+mitk::DICOMTagCacheIndex::DirectoryIndex& mitk::DICOMTagCacheIndex::GetDirectoryIndex(
+  const std::string& filename, std::string& directory, std::string& nameInDirectory)
+{
+  directory = itksys::SystemTools::GetFilenamePath(filename);
+  directory = itksys::SystemTools::CollapseFullPath(directory.empty() ? "." : directory);
+  nameInDirectory = itksys::SystemTools::GetFilenameName(filename);
+
+  auto finding = m_Directories.find(directory);
+  if (finding != m_Directories.end())
+  {
+    finding->second.lastUse = ++m_UseCounter;
+    return finding->second;
+  }
+
+  DirectoryIndex& index = m_Directories[directory];
+  index.lastUse = ++m_UseCounter;
+  this->LoadDirectoryIndex(directory, index);
+  m_NumberOfFiles += index.files.size();
+  this->EvictDirectories(directory);
+  return index;
+}
+
+void mitk::DICOMTagCacheIndex::EvictDirectories(const std::string& keptDirectory)
+{
+  while (m_NumberOfFiles > m_MaximumNumberOfFiles)
+  {
+    auto leastRecentlyUsed = m_Directories.end();
+    for (auto directory = m_Directories.begin(); directory != m_Directories.end(); ++directory)
+    {
+      if (directory->first != keptDirectory
+        && (leastRecentlyUsed == m_Directories.end() || directory->second.lastUse < leastRecentlyUsed->second.lastUse))
+      {
+        leastRecentlyUsed = directory;
+      }
+    }
+
+    if (leastRecentlyUsed == m_Directories.end())
+    {
+      return;
+    }
+
+    if (leastRecentlyUsed->second.modified && !m_CacheDirectory.empty())
+    {
+      this->SaveDirectoryIndex(leastRecentlyUsed->first, leastRecentlyUsed->second);
+    }
+    m_NumberOfFiles -= leastRecentlyUsed->second.files.size();
+    m_Directories.erase(leastRecentlyUsed);
+  }
+}
+
+bool mitk::DICOMTagCacheIndex::IsCacheDirectoryUsable(bool create) const
+{
+#ifdef _WIN32
+  // %LOCALAPPDATA% is only accessible by its user
+  if (create)
+  {
+    itksys::SystemTools::MakeDirectory(m_CacheDirectory);
+  }
+  return itksys::SystemTools::FileIsDirectory(m_CacheDirectory);
+#else
+  if (create)
+  {
+    const std::string parent = itksys::SystemTools::GetParentDirectory(m_CacheDirectory);
+    if (!parent.empty())
+    {
+      itksys::SystemTools::MakeDirectory(parent);
+    }
+    if (mkdir(m_CacheDirectory.c_str(), S_IRWXU) != 0 && errno != EEXIST)
+    {
+      MITK_WARN << "Cannot create DICOM tag cache directory " << m_CacheDirectory;
+      return false;
+    }
+  }
+
+  // other users must not be able to place index files, which would determine the tag values of unchanged files
+  struct stat directoryStatus;
+  if (lstat(m_CacheDirectory.c_str(), &directoryStatus) != 0)
+  {
+    return false;
+  }
+  if (!S_ISDIR(directoryStatus.st_mode) || directoryStatus.st_uid != geteuid()
+    || (directoryStatus.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+  {
+    if (create)
+    {
+      MITK_WARN << "Not using DICOM tag cache directory " << m_CacheDirectory
+                << ": it must be a directory owned by the current user and not writable by others.";
+    }
+    return false;
+  }
+  return true;
+#endif
+}
+
+std::string mitk::DICOMTagCacheIndex::GetIndexFileName(const std::string& directory) const
+{
+  std::ostringstream name;
+  name << m_CacheDirectory << "/" << m_Name << "-" << std::hex << std::setw(16) << std::setfill('0')
+       << HashString(directory) << ".index";
+  return name.str();
+}
+
+void mitk::DICOMTagCacheIndex::LoadDirectoryIndex(const std::string& directory, DirectoryIndex& index) const
+{
+  if (m_CacheDirectory.empty() || !this->IsCacheDirectoryUsable(false))
+  {
+    return;
+  }
+
+  std::ifstream stream(this->GetIndexFileName(directory), std::ios::binary);
+  if (!stream)
+  {
+    return;
+  }
+
+  try
+  {
+    char magic[sizeof(IndexFileMagic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || std::string(magic, sizeof(magic)) != std::string(IndexFileMagic, sizeof(IndexFileMagic))
+      || ReadValue<std::uint32_t>(stream) != IndexFileVersion)
+    {
+      return;
+    }
+
+    // the file name is a hash of the directory, so make sure that the file belongs to this directory
+    if (ReadString(stream) != directory)
+    {
+      return;
+    }
+
+    std::map<std::string, FileEntry> files;
+    auto numberOfFiles = ReadValue<std::uint32_t>(stream);
+    for (std::uint32_t fileIndex = 0; fileIndex < numberOfFiles; ++fileIndex)
+    {
+      std::string name = ReadString(stream);
+      FileEntry& entry = files[name];
+      entry.status.modificationTime = static_cast<long long>(ReadValue<std::int64_t>(stream));
+      entry.status.size = ReadValue<std::uint64_t>(stream);
+
+      auto numberOfPaths = ReadValue<std::uint32_t>(stream);
+      for (std::uint32_t pathIndex = 0; pathIndex < numberOfPaths; ++pathIndex)
+      {
+        DICOMTagPath path = ReadPath(stream);
+        FindingsType& findings = entry.tags[path];
+
+        auto numberOfFindings = ReadValue<std::uint32_t>(stream);
+        for (std::uint32_t findingIndex = 0; findingIndex < numberOfFindings; ++findingIndex)
+        {
+          DICOMTagPath findingPath = ReadPath(stream);
+          findings.emplace_back(findingPath, ReadString(stream));
+        }
+      }
+    }
+
+    index.files.swap(files);
+  }
+  catch (const std::exception& e)
+  {
+    MITK_WARN << "Ignoring invalid DICOM tag cache index " << this->GetIndexFileName(directory) << ": " << e.what();
+  }
+}
+
+void mitk::DICOMTagCacheIndex::SaveDirectoryIndex(const std::string& directory, const DirectoryIndex& index) const
+{
+  if (!this->IsCacheDirectoryUsable(true))
+  {
+    return;
+  }
+
+  const std::string filename = this->GetIndexFileName(directory);
+  const std::string temporaryFilename = filename + ".tmp";
+
+  {
+    std::ofstream stream(temporaryFilename, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+      MITK_WARN << "Cannot write DICOM tag cache index " << temporaryFilename;
+      return;
+    }
+
+    stream.write(IndexFileMagic, sizeof(IndexFileMagic));
+    WriteValue<std::uint32_t>(stream, IndexFileVersion);
+    WriteString(stream, directory);
+
+    WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(index.files.size()));
+    for (const auto& file : index.files)
+    {
+      WriteString(stream, file.first);
+      WriteValue<std::int64_t>(stream, file.second.status.modificationTime);
+      WriteValue<std::uint64_t>(stream, file.second.status.size);
+
+      WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(file.second.tags.size()));
+      for (const auto& tag : file.second.tags)
+      {
+        WritePath(stream, tag.first);
+        WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(tag.second.size()));
+        for (const auto& finding : tag.second)
+        {
+          WritePath(stream, finding.first);
+          WriteString(stream, finding.second);
+        }
+      }
+    }
+
+    if (!stream)
+    {
+      MITK_WARN << "Cannot write DICOM tag cache index " << temporaryFilename;
+      stream.close();
+      itksys::SystemTools::RemoveFile(temporaryFilename);
+      return;
+    }
+  }
+
+  // replace the index at once, so that other processes never read a partially written file
+  if (!itksys::SystemTools::RenameFile(temporaryFilename, filename))
+  {
+    MITK_WARN << "Cannot write DICOM tag cache index " << filename;
+    itksys::SystemTools::RemoveFile(temporaryFilename);
+  }
+}
@@ -16,9 +16,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDICOMTagScanner.h"
 
+#include "mitkParallelFor.h"
+
+#include <algorithm>
+
 itk::MutexLock::Pointer mitk::DICOMTagScanner::s_LocaleMutex = itk::MutexLock::New();
 
 mitk::DICOMTagScanner::DICOMTagScanner()
+  : m_NumberOfThreads(0),
+    m_UsePersistentCache(true)
 {
 }
 
@@ -74,3 +80,64 @@ std::string mitk::DICOMTagScanner::GetActiveLocale()
 {
   return setlocale(LC_NUMERIC, nullptr);
 }
+
+std::vector<mitk::DICOMTagScanner::FileTagsType> mitk::DICOMTagScanner::ScanFiles(const StringList& filenames,
+  const std::set<DICOMTagPath>& scannedPaths, DICOMTagCacheIndex& index, const ScanFunctionType& scanFiles) const
+{
+  // large enough to make the overhead per chunk negligible, small enough to balance the threads
+  const size_t chunkSize = 32;
+  const size_t numberOfChunks = (filenames.size() + chunkSize - 1) / chunkSize;
+
+  std::vector<FileTagsType> result(filenames.size());
+
+  auto scanChunk = [&](unsigned int chunk)
+  {
+    const size_t begin = chunk * chunkSize;
+    const size_t end = std::min(begin + chunkSize, filenames.size());
+
+    StringList filesToScan;
+    std::vector<size_t> indicesToScan;
+    std::vector<DICOMTagCacheIndex::FileStatus> statusOfScannedFiles;
+    std::vector<bool> cacheScannedFiles;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      DICOMTagCacheIndex::FileStatus status = { 0, 0 };
+      const bool hasStatus = m_UsePersistentCache && DICOMTagCacheIndex::GetFileStatus(filenames[i], status);
+      if (hasStatus && index.Lookup(filenames[i], status, scannedPaths, result[i]))
+      {
+        continue;
+      }
+
+      filesToScan.push_back(filenames[i]);
+      indicesToScan.push_back(i);
+      statusOfScannedFiles.push_back(status);
+      cacheScannedFiles.push_back(hasStatus);
+    }
+
+    if (filesToScan.empty())
+    {
+      return;
+    }
+
+    std::vector<FileTagsType> scannedTags = scanFiles(filesToScan);
+    for (size_t j = 0; j < indicesToScan.size() && j < scannedTags.size(); ++j)
+    {
+      if (cacheScannedFiles[j] && !scannedTags[j].empty())
+      {
+        index.Insert(filesToScan[j], statusOfScannedFiles[j], scannedTags[j]);
+      }
+      result[indicesToScan[j]].swap(scannedTags[j]);
+    }
+  };
+
+  // chunks are handed out through a shared counter, so threads hitting the cache simply take more chunks
+  mitk::ParallelFor(static_cast<unsigned int>(numberOfChunks), scanChunk, m_NumberOfThreads);
+
+  if (m_UsePersistentCache)
+  {
+    index.Save();
+  }
+
+  return result;
+}
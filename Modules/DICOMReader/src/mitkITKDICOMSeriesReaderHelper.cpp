@@ -32,14 +32,102 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDICOMGDCMTagScanner.h"
 #include "mitkArbitraryTimeGeometry.h"
+#include "mitkParallelFor.h"
 
 #include "dcmtk/dcmdata/dcvrda.h"
 
+#include <algorithm>
+#include <atomic>
+
 
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::AcquisitionDateTag = mitk::DICOMTag( 0x0008, 0x0022 );
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::AcquisitionTimeTag = mitk::DICOMTag( 0x0008, 0x0032 );
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::TriggerTimeTag = mitk::DICOMTag( 0x0018, 0x1060 );
 
+mitk::ITKDICOMSeriesReaderHelper::ITKDICOMSeriesReaderHelper()
+  : m_NumberOfThreads(0),
+    m_DirectSliceLoading(true),
+    m_LazyLoading(false)
+{
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::SetNumberOfThreads( unsigned int threads )
+{
+  m_NumberOfThreads = threads;
+}
+
+unsigned int mitk::ITKDICOMSeriesReaderHelper::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::SetDirectSliceLoading( bool on )
+{
+  m_DirectSliceLoading = on;
+}
+
+bool mitk::ITKDICOMSeriesReaderHelper::GetDirectSliceLoading() const
+{
+  return m_DirectSliceLoading;
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::SetLazyLoading( bool on )
+{
+  m_LazyLoading = on;
+}
+
+bool mitk::ITKDICOMSeriesReaderHelper::GetLazyLoading() const
+{
+  return m_LazyLoading;
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::ReadSlices( const DICOMLazyImage::SliceTargetList& slices,
+                                                   const SliceDecoding& decoding ) const
+{
+  std::atomic<size_t> nextSlice( 0 );
+
+  auto worker = [&]( unsigned int )
+  {
+    // one IO per thread, GDCMImageIO keeps the state of the last read file
+    itk::GDCMImageIO::Pointer io = itk::GDCMImageIO::New();
+
+    size_t slice;
+    while ( ( slice = nextSlice++ ) < slices.size() )
+    {
+      try
+      {
+        const std::string& filename = slices[slice].first;
+        void* sliceBuffer = slices[slice].second;
+
+        io->SetFileName( filename.c_str() );
+        io->ReadImageInformation();
+
+        if ( io->GetComponentType() == decoding.componentType
+          && io->GetNumberOfComponents() == decoding.numberOfComponents
+          && io->GetImageSizeInBytes() == decoding.sliceSizeInBytes )
+        {
+          io->Read( sliceBuffer );
+        }
+        else
+        {
+          decoding.convertingReader( filename, sliceBuffer );
+        }
+      }
+      catch ( ... )
+      {
+        // stop the other threads, ParallelFor() rethrows the first exception
+        nextSlice = slices.size();
+        throw;
+      }
+    }
+  };
+
+  // one task per thread, each pulling slices from the shared counter with its own IO
+  const unsigned int numberOfThreads = static_cast<unsigned int>(
+    std::min<size_t>( mitk::GetParallelForNumberOfThreads( m_NumberOfThreads ), slices.size() ) );
+  mitk::ParallelFor( numberOfThreads, worker, numberOfThreads );
+}
+
 #define switch3DCase( IOType, T ) \
   case IOType:                    \
     return LoadDICOMByITK<T>( filenames, correctTilt, tiltInfo, io );
@@ -254,6 +254,9 @@ mitk::ThreeDnTDICOMSeriesReader
   }
 
   mitk::ITKDICOMSeriesReaderHelper helper;
+  helper.SetNumberOfThreads( m_NumberOfLoadingThreads );
+  helper.SetDirectSliceLoading( m_DirectSliceLoading );
+  helper.SetLazyLoading( m_LazyLoading );
   mitk::Image::Pointer mitkImage = helper.Load3DnT( filenamesPerTimestep, m_FixTiltByShearing && hasTilt, tiltInfo );
 
   block.SetMitkImage( mitkImage );
@@ -1,6 +1,7 @@
 set(MODULE_TESTS
   mitkDICOMReaderConfiguratorTest.cpp
   mitkDICOMDCMTKTagScannerTest.cpp
+  mitkDICOMTagCacheIndexTest.cpp
   mitkDICOMSimpleVolumeImportTest.cpp
   mitkDICOMTagPathTest.cpp
   mitkDICOMPropertyTest.cpp
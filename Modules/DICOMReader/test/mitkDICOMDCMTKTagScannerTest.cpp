@@ -28,6 +28,7 @@ class mitkDICOMDCMTKTagScannerTestSuite : public mitk::TestFixture
 
   MITK_TEST(DeepScanning);
   MITK_TEST(MultiFileScanning);
+  MITK_TEST(CachedParallelScanning);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -123,6 +124,55 @@ public:
     CPPUNIT_ASSERT_MESSAGE("Testing value of instance uid finding of frame 3", findings.front().value == "1.2.276.0.99.1.4.8323329.3795.1303917947.940055");
   }
 
+  void CachedParallelScanning()
+  {
+    mitk::DICOMTagPath instanceUID(0x0008, 0x0018);
+    mitk::DICOMTagPath patientName(0x0010, 0x0010);
+
+    scanner->SetInputFiles(ctFiles);
+    scanner->AddTagPath(instanceUID);
+    scanner->AddTagPath(patientName);
+    scanner->UsePersistentCacheOff();
+    scanner->SetNumberOfThreads(1);
+    scanner->Scan();
+    mitk::DICOMDatasetAccessingImageFrameList referenceFrames = scanner->GetFrameInfoList();
+
+    // the second scan with cache is answered from the index
+    for (int i = 0; i < 2; ++i)
+    {
+      mitk::DICOMDCMTKTagScanner::Pointer cachedScanner = mitk::DICOMDCMTKTagScanner::New();
+      cachedScanner->SetInputFiles(ctFiles);
+      cachedScanner->AddTagPath(instanceUID);
+      cachedScanner->AddTagPath(patientName);
+      cachedScanner->SetNumberOfThreads(4);
+      cachedScanner->Scan();
+
+      mitk::DICOMDatasetAccessingImageFrameList frames = cachedScanner->GetFrameInfoList();
+      CPPUNIT_ASSERT_MESSAGE("Testing number of frames of cached scan", frames.size() == referenceFrames.size());
+
+      for (size_t frameIndex = 0; frameIndex < frames.size(); ++frameIndex)
+      {
+        CPPUNIT_ASSERT_MESSAGE("Testing file order of cached scan", frames[frameIndex]->GetFilenameIfAvailable() == referenceFrames[frameIndex]->GetFilenameIfAvailable());
+
+        for (const auto& path : { instanceUID, patientName })
+        {
+          auto findings = frames[frameIndex]->GetTagValueAsString(path);
+          auto referenceFindings = referenceFrames[frameIndex]->GetTagValueAsString(path);
+          CPPUNIT_ASSERT_MESSAGE("Testing number of findings of cached scan", findings.size() == referenceFindings.size());
+
+          auto referenceFinding = referenceFindings.cbegin();
+          for (const auto& finding : findings)
+          {
+            CPPUNIT_ASSERT_MESSAGE("Testing validity of cached finding", finding.isValid);
+            CPPUNIT_ASSERT_MESSAGE("Testing path of cached finding", finding.path == referenceFinding->path);
+            CPPUNIT_ASSERT_MESSAGE("Testing value of cached finding", finding.value == referenceFinding->value);
+            ++referenceFinding;
+          }
+        }
+      }
+    }
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkDICOMDCMTKTagScanner)
@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkDICOMITKSeriesGDCMReader.h"
+#include "mitkDICOMLazyImage.h"
 #include "mitkDICOMFileReaderTestHelper.h"
 #include "mitkDICOMFilenameSorter.h"
 #include "mitkDICOMTagBasedSorter.h"
@@ -121,5 +122,57 @@ int mitkDICOMITKSeriesGDCMReaderBasicsTest(int argc, char* argv[])
   mitk::DICOMFileReaderTestHelper::TestMitkImagesAreLoaded( gdcmReader, additionalTags, expectedPropertyTypes );
 
 
+  //////////////////////////////////////////////////////////////////////////
+  //
+  // Direct slice loading must give the same images as itk::ImageSeriesReader
+  //
+  //////////////////////////////////////////////////////////////////////////
+
+  gdcmReader->SetDirectSliceLoading( false );
+  gdcmReader->LoadImages();
+  std::vector<mitk::Image::Pointer> itkLoadedImages;
+  for ( unsigned int o = 0; o < gdcmReader->GetNumberOfOutputs(); ++o )
+  {
+    itkLoadedImages.push_back( gdcmReader->GetOutput( o ).GetMitkImage() );
+  }
+
+  gdcmReader->SetDirectSliceLoading( true );
+  gdcmReader->SetNumberOfLoadingThreads( 3 );
+  gdcmReader->LoadImages();
+  for ( unsigned int o = 0; o < gdcmReader->GetNumberOfOutputs(); ++o )
+  {
+    mitk::Image::Pointer directlyLoadedImage = gdcmReader->GetOutput( o ).GetMitkImage();
+    MITK_TEST_CONDITION_REQUIRED( directlyLoadedImage.IsNotNull() && itkLoadedImages[o].IsNotNull(), "Output " << o << " is loaded both ways" );
+    MITK_TEST_CONDITION( mitk::Equal( *directlyLoadedImage, *itkLoadedImages[o], mitk::eps, true ),
+                         "Directly loaded output " << o << " equals the one loaded by itk::ImageSeriesReader" );
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  //
+  // Lazy loading must decode slices on access only, giving the same images
+  //
+  //////////////////////////////////////////////////////////////////////////
+
+  gdcmReader->SetLazyLoading( true );
+  gdcmReader->LoadImages();
+  for ( unsigned int o = 0; o < gdcmReader->GetNumberOfOutputs(); ++o )
+  {
+    mitk::Image::Pointer image = gdcmReader->GetOutput( o ).GetMitkImage();
+    auto lazyImage = dynamic_cast<mitk::DICOMLazyImage*>( image.GetPointer() );
+    if ( lazyImage == nullptr )
+    {
+      continue; // e.g. multi-frame files
+    }
+
+    MITK_TEST_CONDITION( lazyImage->GetNumberOfLoadedSlices() == 0, "Lazily loaded output " << o << " has no slices decoded" );
+    lazyImage->GetSliceData( lazyImage->GetDimension( 2 ) / 2 );
+    MITK_TEST_CONDITION( lazyImage->GetNumberOfLoadedSlices() > 0
+                         && lazyImage->GetNumberOfLoadedSlices() <= 2 * lazyImage->GetNumberOfPrefetchedSlices() + 1,
+                         "Accessing one slice of output " << o << " decodes only this slice and its neighbours" );
+    MITK_TEST_CONDITION( mitk::Equal( *lazyImage, *itkLoadedImages[o], mitk::eps, true ),
+                         "Lazily loaded output " << o << " equals the one loaded by itk::ImageSeriesReader" );
+  }
+  gdcmReader->SetLazyLoading( false );
+
   MITK_TEST_END();
 }
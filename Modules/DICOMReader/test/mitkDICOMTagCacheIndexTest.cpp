@@ -0,0 +1,257 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMTagCacheIndex.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+class mitkDICOMTagCacheIndexTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMTagCacheIndexTestSuite);
+
+  MITK_TEST(LookupAfterInsert);
+  MITK_TEST(LookupAfterReload);
+  MITK_TEST(ChangedFileIsNotFound);
+  MITK_TEST(MissingPathIsNotFound);
+  MITK_TEST(LeastRecentlyUsedDirectoriesAreEvicted);
+  MITK_TEST(EvictedDirectoriesAreSaved);
+#ifndef _WIN32
+  MITK_TEST(WritableCacheDirectoryIsNotUsed);
+#endif
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::string m_CacheDirectory;
+  std::string m_DataDirectory;
+  std::string m_Filename;
+
+  mitk::DICOMTagPath m_PatientName;
+  mitk::DICOMTagPath m_InstanceUID;
+  mitk::DICOMTagCacheIndex::FileTagsType m_Tags;
+
+public:
+
+  void setUp() override
+  {
+    m_CacheDirectory = mitk::IOUtil::CreateTemporaryDirectory("DICOMTagCacheIndexTest_cache_XXXXXX");
+    m_DataDirectory = mitk::IOUtil::CreateTemporaryDirectory("DICOMTagCacheIndexTest_data_XXXXXX");
+    m_Filename = m_DataDirectory + "/file.dcm";
+    std::ofstream(m_Filename.c_str()) << "not really DICOM";
+
+    m_PatientName = mitk::DICOMTagPath(0x0010, 0x0010);
+    m_InstanceUID = mitk::DICOMTagPath(0x0008, 0x0018);
+
+    m_Tags.clear();
+    m_Tags[m_PatientName].emplace_back(m_PatientName, "L_H");
+    m_Tags[m_InstanceUID]; // scanned but not found
+  }
+
+  void tearDown() override
+  {
+    itksys::SystemTools::RemoveADirectory(m_CacheDirectory);
+    itksys::SystemTools::RemoveADirectory(m_DataDirectory);
+  }
+
+  void CheckTags(const mitk::DICOMTagCacheIndex::FileTagsType& tags)
+  {
+    CPPUNIT_ASSERT_MESSAGE("Testing number of paths", tags.size() == 2);
+    CPPUNIT_ASSERT_MESSAGE("Testing number of findings", tags.at(m_PatientName).size() == 1);
+    CPPUNIT_ASSERT_MESSAGE("Testing path of finding", tags.at(m_PatientName).front().first == m_PatientName);
+    CPPUNIT_ASSERT_MESSAGE("Testing value of finding", tags.at(m_PatientName).front().second == "L_H");
+    CPPUNIT_ASSERT_MESSAGE("Testing path without finding", tags.at(m_InstanceUID).empty());
+  }
+
+  std::set<mitk::DICOMTagPath> ScannedPaths() const
+  {
+    return { m_PatientName, m_InstanceUID };
+  }
+
+  void LookupAfterInsert()
+  {
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory("");
+
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    CPPUNIT_ASSERT_MESSAGE("Testing GetFileStatus()", mitk::DICOMTagCacheIndex::GetFileStatus(m_Filename, status));
+
+    mitk::DICOMTagCacheIndex::FileTagsType tags;
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup in empty index", !index.Lookup(m_Filename, status, ScannedPaths(), tags));
+
+    index.Insert(m_Filename, status, m_Tags);
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup after insert", index.Lookup(m_Filename, status, ScannedPaths(), tags));
+    CheckTags(tags);
+
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup of subset", index.Lookup(m_Filename, status, { m_PatientName }, tags));
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup of subset returns only requested paths", tags.size() == 1);
+  }
+
+  void LookupAfterReload()
+  {
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    mitk::DICOMTagCacheIndex::GetFileStatus(m_Filename, status);
+
+    {
+      mitk::DICOMTagCacheIndex index("test");
+      index.SetCacheDirectory(m_CacheDirectory);
+      index.Insert(m_Filename, status, m_Tags);
+      index.Save();
+    }
+
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory(m_CacheDirectory);
+    mitk::DICOMTagCacheIndex::FileTagsType tags;
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup after reload", index.Lookup(m_Filename, status, ScannedPaths(), tags));
+    CheckTags(tags);
+
+    mitk::DICOMTagCacheIndex otherIndex("other");
+    otherIndex.SetCacheDirectory(m_CacheDirectory);
+    CPPUNIT_ASSERT_MESSAGE("Testing that indices of other names are separate", !otherIndex.Lookup(m_Filename, status, ScannedPaths(), tags));
+  }
+
+  void ChangedFileIsNotFound()
+  {
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory("");
+
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    mitk::DICOMTagCacheIndex::GetFileStatus(m_Filename, status);
+    index.Insert(m_Filename, status, m_Tags);
+
+    mitk::DICOMTagCacheIndex::FileTagsType tags;
+    mitk::DICOMTagCacheIndex::FileStatus changedStatus = status;
+    changedStatus.size += 1;
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup with changed size", !index.Lookup(m_Filename, changedStatus, ScannedPaths(), tags));
+
+    changedStatus = status;
+    changedStatus.modificationTime += 1; // one nanosecond
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup with changed modification time", !index.Lookup(m_Filename, changedStatus, ScannedPaths(), tags));
+  }
+
+  void MissingPathIsNotFound()
+  {
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory("");
+
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    mitk::DICOMTagCacheIndex::GetFileStatus(m_Filename, status);
+    index.Insert(m_Filename, status, m_Tags);
+
+    std::set<mitk::DICOMTagPath> scannedPaths = ScannedPaths();
+    scannedPaths.insert(mitk::DICOMTagPath(0x0020, 0x0032));
+
+    mitk::DICOMTagCacheIndex::FileTagsType tags;
+    CPPUNIT_ASSERT_MESSAGE("Testing lookup of path that was not scanned", !index.Lookup(m_Filename, status, scannedPaths, tags));
+  }
+
+  /** Creates a file in the given subdirectory of the data directory and inserts it into the index. */
+  std::string InsertFileInDirectory(mitk::DICOMTagCacheIndex& index, const std::string& directory)
+  {
+    itksys::SystemTools::MakeDirectory(m_DataDirectory + "/" + directory);
+    std::string filename = m_DataDirectory + "/" + directory + "/file.dcm";
+    std::ofstream(filename.c_str()) << "not really DICOM";
+
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    mitk::DICOMTagCacheIndex::GetFileStatus(filename, status);
+    index.Insert(filename, status, m_Tags);
+    return filename;
+  }
+
+  bool IsInIndex(mitk::DICOMTagCacheIndex& index, const std::string& filename)
+  {
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    mitk::DICOMTagCacheIndex::GetFileStatus(filename, status);
+    mitk::DICOMTagCacheIndex::FileTagsType tags;
+    return index.Lookup(filename, status, ScannedPaths(), tags);
+  }
+
+  void LeastRecentlyUsedDirectoriesAreEvicted()
+  {
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory("");
+    index.SetMaximumNumberOfFiles(2);
+
+    std::string a = InsertFileInDirectory(index, "a");
+    std::string b = InsertFileInDirectory(index, "b");
+    CPPUNIT_ASSERT_MESSAGE("Testing number of files below maximum", index.GetNumberOfFiles() == 2);
+
+    CPPUNIT_ASSERT(IsInIndex(index, a)); // a is now used more recently than b
+    std::string c = InsertFileInDirectory(index, "c");
+    CPPUNIT_ASSERT_MESSAGE("Testing number of files after eviction", index.GetNumberOfFiles() == 2);
+    CPPUNIT_ASSERT_MESSAGE("Testing that the least recently used directory was evicted", !IsInIndex(index, b));
+    CPPUNIT_ASSERT_MESSAGE("Testing that the recently used directory was kept", IsInIndex(index, a));
+    CPPUNIT_ASSERT_MESSAGE("Testing that the new directory was kept", IsInIndex(index, c));
+  }
+
+  void EvictedDirectoriesAreSaved()
+  {
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory(m_CacheDirectory);
+    index.SetMaximumNumberOfFiles(1);
+
+    std::string a = InsertFileInDirectory(index, "a");
+    InsertFileInDirectory(index, "b");
+    CPPUNIT_ASSERT_MESSAGE("Testing number of files after eviction", index.GetNumberOfFiles() == 1);
+    CPPUNIT_ASSERT_MESSAGE("Testing that the evicted directory is reloaded from its index file", IsInIndex(index, a));
+  }
+
+#ifndef _WIN32
+  void WritableCacheDirectoryIsNotUsed()
+  {
+    chmod(m_CacheDirectory.c_str(), S_IRWXU | S_IRWXG | S_IRWXO);
+    {
+      mitk::DICOMTagCacheIndex index("test");
+      index.SetCacheDirectory(m_CacheDirectory);
+      index.Insert(m_Filename, Status(), m_Tags);
+      index.Save();
+    }
+    chmod(m_CacheDirectory.c_str(), S_IRWXU);
+
+    mitk::DICOMTagCacheIndex index("test");
+    index.SetCacheDirectory(m_CacheDirectory);
+    CPPUNIT_ASSERT_MESSAGE("Testing that no index was written to a world writable directory", !IsInIndex(index, m_Filename));
+
+    index.Insert(m_Filename, Status(), m_Tags);
+    index.Save();
+    chmod(m_CacheDirectory.c_str(), S_IRWXU | S_IWGRP | S_IXGRP);
+
+    mitk::DICOMTagCacheIndex otherIndex("test");
+    otherIndex.SetCacheDirectory(m_CacheDirectory);
+    CPPUNIT_ASSERT_MESSAGE("Testing that no index is read from a group writable directory", !IsInIndex(otherIndex, m_Filename));
+    chmod(m_CacheDirectory.c_str(), S_IRWXU);
+  }
+#endif
+
+  mitk::DICOMTagCacheIndex::FileStatus Status() const
+  {
+    mitk::DICOMTagCacheIndex::FileStatus status;
+    mitk::DICOMTagCacheIndex::GetFileStatus(m_Filename, status);
+    return status;
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMTagCacheIndex)
@@ -0,0 +1,158 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkThreeDnTDICOMSeriesReader.h"
+#include "mitkImage.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkParallelFor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+/**
+  Measures the loading throughput of DICOMITKSeriesGDCMReader (via ThreeDnTDICOMSeriesReader,
+  so 3D+t blocks are covered, too) for the ITK series reader and for direct slice loading with
+  different numbers of threads. The file headers are analyzed once, only LoadImages() is timed.
+*/
+
+namespace
+{
+  struct Configuration
+  {
+    std::string name;
+    bool directSliceLoading;
+    unsigned int numberOfThreads;
+  };
+
+  size_t GetImageSizeInBytes(const mitk::Image* image)
+  {
+    size_t size = image->GetPixelType().GetSize();
+    for (unsigned int dim = 0; dim < image->GetDimension(); ++dim)
+    {
+      size *= image->GetDimension(dim);
+    }
+    return size;
+  }
+
+  bool EqualImageData(const mitk::Image* image, const mitk::Image* reference)
+  {
+    const size_t size = GetImageSizeInBytes(image);
+    if (size != GetImageSizeInBytes(reference))
+    {
+      return false;
+    }
+
+    mitk::ImageReadAccessor accessor(image);
+    mitk::ImageReadAccessor referenceAccessor(reference);
+    return std::memcmp(accessor.GetData(), referenceAccessor.GetData(), size) == 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  unsigned int repetitions = 3;
+  mitk::StringList files;
+
+  for (int arg = 1; arg < argc; ++arg)
+  {
+    if (std::string(argv[arg]) == "-r" && arg + 1 < argc)
+    {
+      repetitions = std::max(1, std::atoi(argv[++arg]));
+    }
+    else
+    {
+      files.push_back(argv[arg]);
+    }
+  }
+
+  if (files.empty())
+  {
+    std::cerr << "Usage: " << argv[0] << " [-r repetitions] file1 [file2 ...]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  setlocale(LC_NUMERIC, "C");
+
+  mitk::ThreeDnTDICOMSeriesReader::Pointer reader = mitk::ThreeDnTDICOMSeriesReader::New();
+  reader->SetInputFiles(files);
+  reader->AnalyzeInputFiles();
+
+  const unsigned int defaultThreads = mitk::GetParallelForNumberOfThreads();
+  std::vector<Configuration> configurations;
+  configurations.push_back({ "itk::ImageSeriesReader", false, 1 });
+  configurations.push_back({ "direct, 1 thread", true, 1 });
+  if (defaultThreads > 1)
+  {
+    configurations.push_back({ "direct, " + std::to_string(defaultThreads) + " threads", true, defaultThreads });
+  }
+
+  std::vector<mitk::Image::Pointer> referenceImages;
+  bool allEqual = true;
+
+  std::cout << std::setw(28) << std::left << "configuration" << std::right
+            << std::setw(12) << "seconds" << std::setw(14) << "slices/s" << std::setw(12) << "MB/s" << std::endl;
+
+  for (const auto& configuration : configurations)
+  {
+    reader->SetDirectSliceLoading(configuration.directSliceLoading);
+    reader->SetNumberOfLoadingThreads(configuration.numberOfThreads);
+
+    double seconds = 0.0;
+    size_t slices = 0;
+    size_t bytes = 0;
+
+    for (unsigned int repetition = 0; repetition < repetitions; ++repetition)
+    {
+      auto start = std::chrono::steady_clock::now();
+      reader->LoadImages();
+      seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      for (unsigned int o = 0; o < reader->GetNumberOfOutputs(); ++o)
+      {
+        const mitk::DICOMImageBlockDescriptor& block = reader->GetOutput(o);
+        mitk::Image::Pointer image = block.GetMitkImage();
+        if (image.IsNull())
+        {
+          continue;
+        }
+
+        slices += block.GetImageFrameList().size();
+        bytes += GetImageSizeInBytes(image);
+
+        if (referenceImages.size() <= o)
+        {
+          referenceImages.push_back(image);
+        }
+        else if (!EqualImageData(image, referenceImages[o]))
+        {
+          std::cerr << "Output " << o << " of '" << configuration.name << "' differs from the itk::ImageSeriesReader output" << std::endl;
+          allEqual = false;
+        }
+      }
+    }
+
+    std::cout << std::setw(28) << std::left << configuration.name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << seconds / repetitions
+              << std::setw(14) << std::setprecision(1) << slices / seconds
+              << std::setw(12) << bytes / seconds / (1024.0 * 1024.0) << std::endl;
+  }
+
+  return allEqual ? EXIT_SUCCESS : EXIT_FAILURE;
+}
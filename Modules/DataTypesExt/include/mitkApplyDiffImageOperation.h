@@ -81,6 +81,9 @@ namespace mitk
     Image::Pointer GetDiffImage();
 
     bool IsImageStillValid() { return m_ImageStillValid; }
+
+    std::size_t GetMemorySize() const override;
+    bool SwapOut(const std::string &directory) override;
   };
 
 } // namespace mitk
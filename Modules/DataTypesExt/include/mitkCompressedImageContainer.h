@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkObject.h>
 
+#include <string>
 #include <vector>
 
 namespace mitk
@@ -32,7 +33,18 @@ namespace mitk
   /**
     \brief Holds one (compressed) mitk::Image
 
-    Uses zlib to compress the data of an mitk::Image.
+    Uses zlib to compress the data of an mitk::Image. The data of each time step is split into blocks of
+    GetBlockSize() bytes which are compressed independently. This allows to compress and uncompress the blocks
+    in parallel and to uncompress only the blocks covering a requested region (see GetData(), GetSliceImage()).
+
+    Two additional means exist to keep large undo histories affordable:
+    - SetImage() accepts a reference container. Only the bytewise difference (XOR) to the image held by the
+      reference is compressed then, which is mostly zero and compresses far better if the two images are similar
+      (e.g. a segmentation slice before and after an edit). The reference is kept alive by this container.
+    - SwapOut() moves the compressed data into a temporary file. GetImage() still works afterwards, it reads the
+      data back from the file on demand.
+
+    A reference must not be given a new image while other containers depend on it.
 
     $Author$
   */
@@ -50,19 +62,69 @@ namespace mitk
        */
       void SetImage(Image *);
 
+    /**
+     * \brief Creates a compressed version of the difference between image and the image held by reference.
+     *
+     * Falls back to compressing the full image if reference is nullptr or does not hold an image of the same
+     * memory size and number of time steps.
+     */
+    void SetImage(Image *image, CompressedImageContainer *reference);
+
     /**
      * \brief Creates a full mitk::Image from its compressed version.
      *
      * This Method hold no buffer, so the uncompression algorithm will be
      * executed every time you call this method. Don't overdo it.
      *
+     * Returns nullptr if no image was set. Throws an mitk::Exception if the data could not be uncompressed.
      */
     Image::Pointer GetImage();
 
+    /**
+     * \brief Creates a 2D mitk::Image of one slice (index along the third image dimension) of one time step.
+     *
+     * Only the blocks holding the slice are uncompressed. Throws an mitk::Exception if the data could not be
+     * uncompressed.
+     */
+    Image::Pointer GetSliceImage(unsigned int sliceIndex, unsigned int timeStep = 0);
+
+    /**
+     * \brief Uncompresses numberOfBytes bytes starting at byte offset of time step timeStep into buffer.
+     *
+     * Only the blocks overlapping the requested range are uncompressed. Returns false if the range is invalid
+     * or the data could not be uncompressed.
+     */
+    bool GetData(unsigned int timeStep, std::size_t offset, std::size_t numberOfBytes, void *buffer) const;
+
+    /** \brief Size of the uncompressed data of one time step in bytes. */
+    std::size_t GetTimeStepSizeInBytes() const { return m_OneTimeStepImageSizeInBytes; }
+
+    /** \brief Number of uncompressed bytes per independently compressed block. */
+    static std::size_t GetBlockSize();
+
+    /** \brief Number of bytes of compressed data currently held in memory (0 if swapped out). */
+    std::size_t GetCompressedSize() const;
+
+    /**
+     * \brief Writes the compressed data to a temporary file in directory (the default temp path if empty) and
+     * releases the memory. Returns false if nothing was swapped out.
+     */
+    bool SwapOut(const std::string &directory = std::string());
+
+    bool IsSwappedOut() const { return !m_SwapFileName.empty(); }
+
+    /** \brief True, if only the difference to a reference container is stored. */
+    bool IsDifferenceEncoded() const { return m_Reference.IsNotNull(); }
+
   protected:
     CompressedImageContainer(); // purposely hidden
     ~CompressedImageContainer() override;
 
+    void ClearBuffers();
+
+    /** \brief Number of uncompressed bytes of block block (within a time step). */
+    std::size_t GetBlockSizeInBytes(unsigned int block) const;
+
     PixelType *m_PixelType;
 
     unsigned int m_ImageDimension;
@@ -72,10 +134,22 @@ namespace mitk
 
     unsigned int m_NumberOfTimeSteps;
 
-    /// one for each timestep. first = pointer to compressed data; second = size of buffer in bytes
+    unsigned int m_BlocksPerTimeStep;
+
+    /// one for each block of each timestep (block b of timestep t at t * m_BlocksPerTimeStep + b).
+    /// first = pointer to compressed data (nullptr if swapped out); second = size of buffer in bytes
     std::vector<std::pair<unsigned char *, unsigned long>> m_ByteBuffers;
 
     BaseGeometry::Pointer m_ImageGeometry;
+
+    /// container the stored data is the difference to, nullptr if the full image is stored
+    CompressedImageContainer::Pointer m_Reference;
+
+    /// file holding all buffers one after the other, empty if the data is in memory
+    std::string m_SwapFileName;
+
+    /// file position of each buffer in the swap file, plus the file size
+    std::vector<std::size_t> m_SwapFileOffsets;
   };
 
 } // namespace
@@ -69,3 +69,13 @@ mitk::Image::Pointer mitk::ApplyDiffImageOperation::GetDiffImage()
 
   return image;
 }
+
+std::size_t mitk::ApplyDiffImageOperation::GetMemorySize() const
+{
+  return zlibContainer.IsNotNull() ? zlibContainer->GetCompressedSize() : 0;
+}
+
+bool mitk::ApplyDiffImageOperation::SwapOut(const std::string &directory)
+{
+  return zlibContainer.IsNotNull() && zlibContainer->SwapOut(directory);
+}
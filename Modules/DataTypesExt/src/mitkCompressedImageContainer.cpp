@@ -15,27 +15,73 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkCompressedImageContainer.h"
+#include "mitkIOUtil.h"
 #include "mitkImageReadAccessor.h"
+#include "mitkParallelFor.h"
 
 #include "itk_zlib.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 
-mitk::CompressedImageContainer::CompressedImageContainer() : m_PixelType(nullptr), m_ImageGeometry(nullptr)
+// small enough to keep all cores busy for a single 2D slice, large enough to keep the compression ratio
+static const std::size_t COMPRESSION_BLOCK_SIZE = 256 * 1024;
+
+namespace
+{
+  void LogZlibError(int zlibRetVal)
+  {
+    switch (zlibRetVal)
+    {
+      case Z_DATA_ERROR:
+        MITK_ERROR << "compressed data corrupted" << std::endl;
+        break;
+      case Z_MEM_ERROR:
+        MITK_ERROR << "not enough memory" << std::endl;
+        break;
+      case Z_BUF_ERROR:
+        MITK_ERROR << "output buffer too small" << std::endl;
+        break;
+      default:
+        MITK_ERROR << "other, unspecified error" << std::endl;
+        break;
+    }
+  }
+}
+
+mitk::CompressedImageContainer::CompressedImageContainer()
+  : m_PixelType(nullptr),
+    m_ImageDimension(0),
+    m_OneTimeStepImageSizeInBytes(0),
+    m_NumberOfTimeSteps(0),
+    m_BlocksPerTimeStep(0),
+    m_ImageGeometry(nullptr)
 {
 }
 
 mitk::CompressedImageContainer::~CompressedImageContainer()
 {
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
-  {
-    free(iter->first);
-  }
+  this->ClearBuffers();
 
   delete m_PixelType;
 }
 
-void mitk::CompressedImageContainer::SetImage(Image *image)
+std::size_t mitk::CompressedImageContainer::GetBlockSize()
+{
+  return COMPRESSION_BLOCK_SIZE;
+}
+
+std::size_t mitk::CompressedImageContainer::GetBlockSizeInBytes(unsigned int block) const
+{
+  std::size_t begin = block * COMPRESSION_BLOCK_SIZE;
+  return std::min<std::size_t>(COMPRESSION_BLOCK_SIZE, m_OneTimeStepImageSizeInBytes - begin);
+}
+
+void mitk::CompressedImageContainer::ClearBuffers()
 {
   for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
   {
@@ -43,12 +89,31 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
   }
 
   m_ByteBuffers.clear();
+  m_Reference = nullptr;
+
+  if (!m_SwapFileName.empty())
+  {
+    std::remove(m_SwapFileName.c_str());
+    m_SwapFileName.clear();
+  }
+  m_SwapFileOffsets.clear();
+}
+
+void mitk::CompressedImageContainer::SetImage(Image *image)
+{
+  this->SetImage(image, nullptr);
+}
+
+void mitk::CompressedImageContainer::SetImage(Image *image, CompressedImageContainer *reference)
+{
+  this->ClearBuffers();
 
   // Compress diff image using zlib (will be restored on demand)
   // determine memory size occupied by voxel data
   m_ImageDimension = image->GetDimension();
   m_ImageDimensions.clear();
 
+  delete m_PixelType;
   m_PixelType = new mitk::PixelType(image->GetPixelType());
 
   m_OneTimeStepImageSizeInBytes = m_PixelType->GetSize(); // bits per element divided by 8
@@ -70,58 +135,66 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
     m_NumberOfTimeSteps = image->GetDimension(3);
   }
 
-  for (unsigned int timestep = 0; timestep < m_NumberOfTimeSteps; ++timestep)
+  m_BlocksPerTimeStep =
+    static_cast<unsigned int>((m_OneTimeStepImageSizeInBytes + COMPRESSION_BLOCK_SIZE - 1) / COMPRESSION_BLOCK_SIZE);
+
+  // the difference to a similar image is mostly zero, which zlib compresses very well
+  std::vector<unsigned char> difference;
+  if (reference != nullptr && reference != this && !reference->m_ByteBuffers.empty() &&
+      reference->m_OneTimeStepImageSizeInBytes == m_OneTimeStepImageSizeInBytes &&
+      reference->m_NumberOfTimeSteps == m_NumberOfTimeSteps)
   {
-    // allocate a buffer as specified by zlib
-    unsigned long bufferSize =
-      m_OneTimeStepImageSizeInBytes + static_cast<unsigned long>(m_OneTimeStepImageSizeInBytes * 0.2) + 12;
-    auto *byteBuffer = (unsigned char *)malloc(bufferSize);
+    m_Reference = reference;
+    difference.resize(m_OneTimeStepImageSizeInBytes);
+  }
 
-    if (itk::Object::GetDebug())
-    {
-      // compress image here into a buffer
-      MITK_INFO << "Using ZLib version: '" << zlibVersion() << "'" << std::endl
-                << "Attempting to compress " << m_OneTimeStepImageSizeInBytes << " image bytes into a buffer of size "
-                << bufferSize << std::endl;
-    }
+  if (itk::Object::GetDebug())
+  {
+    MITK_INFO << "Using ZLib version: '" << zlibVersion() << "'" << std::endl
+              << "Attempting to compress " << m_NumberOfTimeSteps << " x " << m_OneTimeStepImageSizeInBytes
+              << " image bytes in blocks of " << COMPRESSION_BLOCK_SIZE << " bytes" << std::endl;
+  }
 
+  m_ByteBuffers.resize(m_NumberOfTimeSteps * m_BlocksPerTimeStep, std::pair<unsigned char *, unsigned long>(nullptr, 0));
+  std::atomic<bool> failed(false);
+  for (unsigned int timestep = 0; timestep < m_NumberOfTimeSteps; ++timestep)
+  {
     ImageReadAccessor imgAcc(image, image->GetVolumeData(timestep));
-    ::Bytef *dest(byteBuffer);
-    ::uLongf destLen(bufferSize);
-    auto *source((unsigned char *)imgAcc.GetData());
-    ::uLongf sourceLen(m_OneTimeStepImageSizeInBytes);
-    int zlibRetVal = ::compress(dest, &destLen, source, sourceLen);
-    if (itk::Object::GetDebug())
+    auto *source((const unsigned char *)imgAcc.GetData());
+    if (m_Reference.IsNotNull())
     {
-      if (zlibRetVal == Z_OK)
-      {
-        MITK_INFO << "Success, using " << destLen << " bytes of the buffer (ratio "
-                  << ((double)destLen / (double)sourceLen) << ")" << std::endl;
-      }
-      else
+      if (!m_Reference->GetData(timestep, 0, m_OneTimeStepImageSizeInBytes, difference.data()))
+        mitkThrow() << "Could not uncompress the reference image of a difference encoded image.";
+      for (unsigned long byte = 0; byte < m_OneTimeStepImageSizeInBytes; ++byte)
+        difference[byte] ^= source[byte];
+      source = difference.data();
+    }
+
+    mitk::ParallelFor(m_BlocksPerTimeStep, [&](unsigned int block) {
+      ::uLongf sourceLen(this->GetBlockSizeInBytes(block));
+      // allocate a buffer as specified by zlib
+      ::uLongf destLen(::compressBound(sourceLen));
+      auto *byteBuffer = (unsigned char *)malloc(destLen);
+      int zlibRetVal = ::compress(byteBuffer, &destLen, source + block * COMPRESSION_BLOCK_SIZE, sourceLen);
+      if (zlibRetVal != Z_OK)
       {
-        switch (zlibRetVal)
-        {
-          case Z_MEM_ERROR:
-            MITK_ERROR << "not enough memory" << std::endl;
-            break;
-          case Z_BUF_ERROR:
-            MITK_ERROR << "output buffer too small" << std::endl;
-            break;
-          default:
-            MITK_ERROR << "other, unspecified error" << std::endl;
-            break;
-        }
+        LogZlibError(zlibRetVal);
+        failed = true;
+        destLen = 0;
       }
-    }
 
-    // only use the neccessary amount of memory, realloc the buffer!
-    byteBuffer = (unsigned char *)realloc(byteBuffer, destLen);
-    bufferSize = destLen;
-    // MITK_INFO << "Using " << bufferSize << " bytes to store compressed image (" << destLen << " needed)" <<
-    // std::endl;
+      // only use the neccessary amount of memory, realloc the buffer!
+      byteBuffer = (unsigned char *)realloc(byteBuffer, std::max<uLongf>(destLen, 1));
+      m_ByteBuffers[timestep * m_BlocksPerTimeStep + block] =
+        std::pair<unsigned char *, unsigned long>(byteBuffer, destLen);
+    });
+  }
 
-    m_ByteBuffers.push_back(std::pair<unsigned char *, unsigned long>(byteBuffer, bufferSize));
+  if (itk::Object::GetDebug() && !failed)
+  {
+    MITK_INFO << "Success, using " << this->GetCompressedSize() << " bytes (ratio "
+              << ((double)this->GetCompressedSize() / (double)(m_OneTimeStepImageSizeInBytes * m_NumberOfTimeSteps))
+              << ")" << std::endl;
   }
 }
 
@@ -139,40 +212,11 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
   image->Initialize(*m_PixelType, m_ImageDimension, dims); // this IS needed, right ?? But it does allocate memory ->
                                                            // does create one big lump of memory (also in windows)
 
-  unsigned int timeStep(0);
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter, ++timeStep)
+  for (unsigned int timeStep = 0; timeStep < m_NumberOfTimeSteps; ++timeStep)
   {
     ImageReadAccessor imgAcc(image, image->GetVolumeData(timeStep));
-    auto *dest((unsigned char *)imgAcc.GetData());
-    ::uLongf destLen(m_OneTimeStepImageSizeInBytes);
-    ::Bytef *source(iter->first);
-    ::uLongf sourceLen(iter->second);
-    int zlibRetVal = ::uncompress(dest, &destLen, source, sourceLen);
-    if (itk::Object::GetDebug())
-    {
-      if (zlibRetVal == Z_OK)
-      {
-        MITK_INFO << "Success, destLen now " << destLen << " bytes" << std::endl;
-      }
-      else
-      {
-        switch (zlibRetVal)
-        {
-          case Z_DATA_ERROR:
-            MITK_ERROR << "compressed data corrupted" << std::endl;
-            break;
-          case Z_MEM_ERROR:
-            MITK_ERROR << "not enough memory" << std::endl;
-            break;
-          case Z_BUF_ERROR:
-            MITK_ERROR << "output buffer too small" << std::endl;
-            break;
-          default:
-            MITK_ERROR << "other, unspecified error" << std::endl;
-            break;
-        }
-      }
-    }
+    if (!this->GetData(timeStep, 0, m_OneTimeStepImageSizeInBytes, const_cast<void *>(imgAcc.GetData())))
+      mitkThrow() << "Could not uncompress time step " << timeStep << " of the compressed image.";
   }
 
   image->SetGeometry(m_ImageGeometry);
@@ -180,3 +224,174 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 
   return image;
 }
+
+mitk::Image::Pointer mitk::CompressedImageContainer::GetSliceImage(unsigned int sliceIndex, unsigned int timeStep)
+{
+  unsigned int numberOfSlices = m_ImageDimension > 2 ? m_ImageDimensions[2] : 1;
+  if (m_ByteBuffers.empty() || m_ImageDimension < 2 || sliceIndex >= numberOfSlices ||
+      timeStep >= m_NumberOfTimeSteps)
+    return nullptr;
+
+  Image::Pointer image = Image::New();
+  unsigned int dims[2] = {m_ImageDimensions[0], m_ImageDimensions[1]};
+  image->Initialize(*m_PixelType, 2, dims);
+
+  std::size_t sliceSizeInBytes = m_OneTimeStepImageSizeInBytes / numberOfSlices;
+  {
+    ImageReadAccessor imgAcc(image, image->GetVolumeData(0));
+    if (!this->GetData(timeStep, sliceIndex * sliceSizeInBytes, sliceSizeInBytes, const_cast<void *>(imgAcc.GetData())))
+      mitkThrow() << "Could not uncompress slice " << sliceIndex << " of the compressed image.";
+  }
+
+  // move the image geometry to the slice
+  BaseGeometry::Pointer geometry = m_ImageGeometry->Clone();
+  Point3D sliceIndexPoint;
+  sliceIndexPoint.Fill(0);
+  sliceIndexPoint[2] = sliceIndex;
+  Point3D origin;
+  m_ImageGeometry->IndexToWorld(sliceIndexPoint, origin);
+  geometry->SetOrigin(origin);
+  BaseGeometry::BoundsArrayType bounds = geometry->GetBounds();
+  bounds[5] = bounds[4] + 1;
+  geometry->SetBounds(bounds);
+  image->SetGeometry(geometry);
+  image->Modified();
+
+  return image;
+}
+
+bool mitk::CompressedImageContainer::GetData(unsigned int timeStep,
+                                             std::size_t offset,
+                                             std::size_t numberOfBytes,
+                                             void *buffer) const
+{
+  if (timeStep >= m_NumberOfTimeSteps || m_ByteBuffers.empty() || offset + numberOfBytes > m_OneTimeStepImageSizeInBytes)
+    return false;
+  if (numberOfBytes == 0)
+    return true;
+
+  auto *dest = static_cast<unsigned char *>(buffer);
+  auto firstBlock = static_cast<unsigned int>(offset / COMPRESSION_BLOCK_SIZE);
+  auto lastBlock = static_cast<unsigned int>((offset + numberOfBytes - 1) / COMPRESSION_BLOCK_SIZE);
+  unsigned int firstBuffer = timeStep * m_BlocksPerTimeStep + firstBlock;
+
+  // the buffers of consecutive blocks are stored one after the other in the swap file
+  std::vector<unsigned char> swappedData;
+  if (!m_SwapFileName.empty())
+  {
+    std::size_t begin = m_SwapFileOffsets[firstBuffer];
+    std::size_t end = m_SwapFileOffsets[firstBuffer + lastBlock - firstBlock + 1];
+    swappedData.resize(end - begin);
+    std::ifstream swapFile(m_SwapFileName.c_str(), std::ios::in | std::ios::binary);
+    swapFile.seekg(begin);
+    if (!swapFile.read(reinterpret_cast<char *>(swappedData.data()), swappedData.size()))
+    {
+      MITK_ERROR << "could not read compressed image data from " << m_SwapFileName << std::endl;
+      return false;
+    }
+  }
+
+  std::atomic<bool> failed(false);
+  mitk::ParallelFor(lastBlock - firstBlock + 1, [&](unsigned int i) {
+    unsigned int block = firstBlock + i;
+    const auto &byteBuffer = m_ByteBuffers[firstBuffer + i];
+    ::Bytef *source(byteBuffer.first);
+    if (!m_SwapFileName.empty())
+      source = swappedData.data() + (m_SwapFileOffsets[firstBuffer + i] - m_SwapFileOffsets[firstBuffer]);
+
+    // blocks only partially covered by the requested range are uncompressed into a temporary buffer
+    std::size_t blockBegin = block * COMPRESSION_BLOCK_SIZE;
+    std::size_t blockSize = this->GetBlockSizeInBytes(block);
+    std::size_t begin = std::max(blockBegin, offset);
+    std::size_t end = std::min(blockBegin + blockSize, offset + numberOfBytes);
+    std::vector<unsigned char> blockData;
+    unsigned char *blockDest = dest + (blockBegin - offset);
+    if (begin != blockBegin || end != blockBegin + blockSize)
+    {
+      blockData.resize(blockSize);
+      blockDest = blockData.data();
+    }
+
+    ::uLongf destLen(blockSize);
+    int zlibRetVal = ::uncompress(blockDest, &destLen, source, byteBuffer.second);
+    if (zlibRetVal != Z_OK)
+    {
+      LogZlibError(zlibRetVal);
+      failed = true;
+      return;
+    }
+
+    if (!blockData.empty())
+      std::memcpy(dest + (begin - offset), blockData.data() + (begin - blockBegin), end - begin);
+  });
+
+  if (failed)
+    return false;
+
+  if (m_Reference.IsNotNull())
+  {
+    std::vector<unsigned char> referenceData(numberOfBytes);
+    if (!m_Reference->GetData(timeStep, offset, numberOfBytes, referenceData.data()))
+      return false;
+    for (std::size_t byte = 0; byte < numberOfBytes; ++byte)
+      dest[byte] ^= referenceData[byte];
+  }
+
+  return true;
+}
+
+std::size_t mitk::CompressedImageContainer::GetCompressedSize() const
+{
+  if (!m_SwapFileName.empty())
+    return 0;
+
+  std::size_t size(0);
+  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
+  {
+    size += iter->second;
+  }
+  return size;
+}
+
+bool mitk::CompressedImageContainer::SwapOut(const std::string &directory)
+{
+  if (m_ByteBuffers.empty() || !m_SwapFileName.empty())
+    return false;
+
+  std::ofstream swapFile;
+  std::string swapFileName;
+  try
+  {
+    swapFileName = IOUtil::CreateTemporaryFile(swapFile, std::ios_base::binary, "MITK_undo_XXXXXX.zlib", directory);
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_WARN << "Could not swap out compressed image: " << e.what();
+    return false;
+  }
+
+  std::vector<std::size_t> offsets(1, 0);
+  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
+  {
+    swapFile.write(reinterpret_cast<const char *>(iter->first), iter->second);
+    offsets.push_back(offsets.back() + iter->second);
+  }
+  swapFile.close();
+
+  if (!swapFile)
+  {
+    MITK_WARN << "Could not write compressed image to " << swapFileName;
+    std::remove(swapFileName.c_str());
+    return false;
+  }
+
+  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
+  {
+    free(iter->first);
+    iter->first = nullptr;
+  }
+  m_SwapFileName = swapFileName;
+  m_SwapFileOffsets.swap(offsets);
+
+  return true;
+}
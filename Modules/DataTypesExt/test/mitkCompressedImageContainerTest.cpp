@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageDataItem.h"
 #include "mitkImageReadAccessor.h"
 
+#include <algorithm>
+
 class mitkCompressedImageContainerTestClass
 {
 public:
@@ -28,6 +30,82 @@ public:
     container->SetImage(image);                                     // compress
     mitk::Image::Pointer uncompressedImage = container->GetImage(); // uncompress
 
+    Compare(image, uncompressedImage, numberFailed);
+  }
+
+  static void TestDifferenceAndSwapping(mitk::CompressedImageContainer *container,
+                                        mitk::Image *image,
+                                        unsigned int &numberFailed)
+  {
+    // the difference of an image to itself is zero everywhere
+    mitk::CompressedImageContainer::Pointer diffContainer = mitk::CompressedImageContainer::New();
+    diffContainer->SetImage(image, container);
+    if (!diffContainer->IsDifferenceEncoded())
+    {
+      ++numberFailed;
+      std::cerr << "  (EE) Image not difference encoded" << std::endl;
+    }
+    if (diffContainer->GetCompressedSize() > container->GetCompressedSize())
+    {
+      ++numberFailed;
+      std::cerr << "  (EE) Difference encoded image needs more memory than the full image ("
+                << diffContainer->GetCompressedSize() << " vs. " << container->GetCompressedSize() << ")" << std::endl;
+    }
+    Compare(image, diffContainer->GetImage(), numberFailed);
+
+    // swapped out data is read back from disk
+    if (!container->SwapOut() || container->GetCompressedSize() != 0 || !container->IsSwappedOut())
+    {
+      ++numberFailed;
+      std::cerr << "  (EE) Swapping out failed" << std::endl;
+    }
+    Compare(image, container->GetImage(), numberFailed);
+    Compare(image, diffContainer->GetImage(), numberFailed);
+  }
+
+  static void TestRandomAccess(mitk::CompressedImageContainer *container, mitk::Image *image, unsigned int &numberFailed)
+  {
+    container->SetImage(image);
+
+    unsigned int timeStep = image->GetDimension() > 3 ? image->GetDimension(3) - 1 : 0;
+    mitk::ImageReadAccessor origImgAcc(image, image->GetVolumeData(timeStep));
+    auto *originalData((const unsigned char *)origImgAcc.GetData());
+
+    // a range crossing a block border
+    std::size_t size = container->GetTimeStepSizeInBytes();
+    std::size_t offset = std::min(size / 2, mitk::CompressedImageContainer::GetBlockSize() - 3);
+    std::size_t numberOfBytes = std::min(size - offset, std::size_t(7));
+    std::vector<unsigned char> data(numberOfBytes);
+    if (!container->GetData(timeStep, offset, numberOfBytes, data.data()) ||
+        !std::equal(data.begin(), data.end(), originalData + offset))
+    {
+      ++numberFailed;
+      std::cerr << "  (EE) Data range differs after uncompression" << std::endl;
+    }
+
+    if (container->GetData(timeStep, size, 1, data.data()))
+    {
+      ++numberFailed;
+      std::cerr << "  (EE) Data range outside the image accepted" << std::endl;
+    }
+
+    if (image->GetDimension() > 2)
+    {
+      unsigned int sliceIndex = image->GetDimension(2) / 2;
+      std::size_t sliceSize = size / image->GetDimension(2);
+      mitk::Image::Pointer slice = container->GetSliceImage(sliceIndex, timeStep);
+      mitk::ImageReadAccessor sliceAcc(slice);
+      auto *sliceData((const unsigned char *)sliceAcc.GetData());
+      if (slice->GetDimension() != 2 || !std::equal(sliceData, sliceData + sliceSize, originalData + sliceIndex * sliceSize))
+      {
+        ++numberFailed;
+        std::cerr << "  (EE) Slice " << sliceIndex << " differs after uncompression" << std::endl;
+      }
+    }
+  }
+
+  static void Compare(mitk::Image *image, mitk::Image *uncompressedImage, unsigned int &numberFailed)
+  {
     // check dimensions
     if (image->GetDimension() != uncompressedImage->GetDimension())
     {
@@ -165,6 +243,8 @@ int mitkCompressedImageContainerTest(int argc, char *argv[])
 
   // some real work
   mitkCompressedImageContainerTestClass::Test(container, image, numberFailed);
+  mitkCompressedImageContainerTestClass::TestDifferenceAndSwapping(container, image, numberFailed);
+  mitkCompressedImageContainerTestClass::TestRandomAccess(container, image, numberFailed);
 
   std::cout << "Testing destruction" << std::endl;
 
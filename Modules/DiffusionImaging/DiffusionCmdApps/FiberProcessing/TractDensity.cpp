@@ -33,6 +33,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIOUtil.h>
 #include <itkTractDensityImageFilter.h>
 #include <itkTractsToFiberEndingsImageFilter.h>
+#include <chrono>
 
 
 mitk::FiberBundle::Pointer LoadFib(std::string filename)
@@ -44,6 +45,39 @@ mitk::FiberBundle::Pointer LoadFib(std::string filename)
   return dynamic_cast<mitk::FiberBundle*>(baseData.GetPointer());
 }
 
+/*!
+\brief Compare the single threaded tract density computation with the multi threaded one (runtime and result).
+*/
+template< class OutImageType >
+void BenchmarkTractDensity(typename itk::TractDensityImageFilter< OutImageType >::Pointer generator)
+{
+  itk::ThreadIdType numThreads = generator->GetNumberOfThreads();
+  std::vector< typename OutImageType::Pointer > outputs;
+  std::vector< double > seconds;
+  for (itk::ThreadIdType threads : {static_cast<itk::ThreadIdType>(1), numThreads})
+  {
+    generator->SetNumberOfThreads(threads);
+    generator->Modified();
+    auto start = std::chrono::steady_clock::now();
+    generator->Update();
+    seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    typename OutImageType::Pointer output = generator->GetOutput();
+    output->DisconnectPipeline();
+    outputs.push_back(output);
+  }
+
+  size_t numVoxels = outputs[0]->GetLargestPossibleRegion().GetNumberOfPixels();
+  size_t numDifferent = 0;
+  for (size_t i=0; i<numVoxels; ++i)
+    if (outputs[0]->GetBufferPointer()[i]!=outputs[1]->GetBufferPointer()[i])
+      ++numDifferent;
+
+  MITK_INFO << "Tract density with 1 thread: " << seconds[0] << "s";
+  MITK_INFO << "Tract density with " << numThreads << " threads: " << seconds[1] << "s (speedup " << seconds[0]/seconds[1] << ")";
+  MITK_INFO << "Voxels differing between both results: " << numDifferent;
+}
+
 /*!
 \brief Modify input tractogram: fiber resampling, compression, pruning and transformation.
 */
@@ -64,6 +98,7 @@ int main(int argc, char* argv[])
   parser.addArgument("endpoints", "", mitkCommandLineParser::Bool, "Output endpoints image:", "calculate image of fiber endpoints instead of mask", us::Any());
   parser.addArgument("reference_image", "", mitkCommandLineParser::String, "Reference image:", "output image will have geometry of this reference image", us::Any());
   parser.addArgument("upsampling", "", mitkCommandLineParser::Float, "Upsampling:", "upsampling", 1.0);
+  parser.addArgument("benchmark", "", mitkCommandLineParser::Bool, "Benchmark:", "compare runtime and result of the single and multi threaded tract density computation", us::Any());
 
 
   std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
@@ -82,6 +117,10 @@ int main(int argc, char* argv[])
   if (parsedArgs.count("normalize"))
     normalize = us::any_cast<bool>(parsedArgs["normalize"]);
 
+  bool benchmark = false;
+  if (parsedArgs.count("benchmark"))
+    benchmark = us::any_cast<bool>(parsedArgs["benchmark"]);
+
   float upsampling = 1.0;
   if (parsedArgs.count("upsampling"))
     upsampling = us::any_cast<float>(parsedArgs["upsampling"]);
@@ -181,6 +220,8 @@ int main(int argc, char* argv[])
         generator->SetUseImageGeometry(true);
 
       }
+      if (benchmark)
+        BenchmarkTractDensity< OutImageType >(generator);
       generator->Update();
 
       // get output image
@@ -29,7 +29,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itksys/SystemTools.hxx>
 #include <tinyxml.h>
 #include <vtkCleanPolyData.h>
-#include <mitkTrackvis.h>
+#include <mitkFiberStreamReader.h>
 #include <mitkCustomMimeType.h>
 #include "mitkDiffusionIOMimeTypes.h"
 
@@ -68,10 +68,16 @@ std::vector<itk::SmartPointer<mitk::BaseData> > mitk::FiberBundleTrackVisReader:
 
     if (ext==".trk")
     {
-      FiberBundle::Pointer mitk_fib = FiberBundle::New();
-      TrackVisFiberReader reader;
-      reader.open(this->GetInputLocation().c_str());
-      reader.read(mitk_fib.GetPointer());
+      mitk::FiberStreamReader reader;
+      reader.Open(filename);
+
+      mitk::FiberStore fibers;
+      reader.ReadAll(fibers);
+      reader.Close();
+
+      FiberBundle::Pointer mitk_fib = FiberBundle::New(fibers.GeneratePolyData());
+      if (reader.GetReferenceGeometry().IsNotNull())
+        mitk_fib->SetReferenceGeometry(dynamic_cast<mitk::BaseGeometry*>(reader.GetReferenceGeometry().GetPointer()));
       result.push_back(mitk_fib.GetPointer());
       return result;
     }
@@ -17,6 +17,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <ctime>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
+#include <iterator>
 
 #include <omp.h>
 #include "itkStreamlineTrackingFilter.h"
@@ -77,6 +79,9 @@ StreamlineTrackingFilter
   , m_UseOutputProbabilityMap(false)
   , m_CurrentTracts(0)
   , m_Progress(0)
+  , m_NumSteps(0)
+  , m_SeedBatchSize(100)
+  , m_FiberStreamWriter(nullptr)
   , m_StopTracking(false)
   , m_InterpolateMasks(true)
   , m_TrialsPerSeed(10)
@@ -91,17 +96,44 @@ StreamlineTrackingFilter
 
 std::string StreamlineTrackingFilter::GetStatusText()
 {
-  std::string status = "Seedpoints processed: " + boost::lexical_cast<std::string>(m_Progress) + "/" + boost::lexical_cast<std::string>(m_SeedPoints.size());
+  unsigned int progress = m_Progress;
+  unsigned int tracts = m_CurrentTracts;
+  std::string status = "Seedpoints processed: " + boost::lexical_cast<std::string>(progress) + "/" + boost::lexical_cast<std::string>(m_SeedPoints.size());
   if (m_SeedPoints.size()>0)
-    status += " (" + boost::lexical_cast<std::string>(100*m_Progress/m_SeedPoints.size()) + "%)";
+    status += " (" + boost::lexical_cast<std::string>(100*progress/m_SeedPoints.size()) + "%)";
   if (m_MaxNumTracts>0)
-    status += "\nFibers accepted: " + boost::lexical_cast<std::string>(m_CurrentTracts) + "/" + boost::lexical_cast<std::string>(m_MaxNumTracts);
+    status += "\nFibers accepted: " + boost::lexical_cast<std::string>(tracts) + "/" + boost::lexical_cast<std::string>(m_MaxNumTracts);
   else
-    status += "\nFibers accepted: " + boost::lexical_cast<std::string>(m_CurrentTracts);
+    status += "\nFibers accepted: " + boost::lexical_cast<std::string>(tracts);
+  status += "\nStreamlines/s: " + boost::lexical_cast<std::string>(static_cast<unsigned long>(GetStreamlinesPerSecond()));
+  status += " | Steps/s: " + boost::lexical_cast<std::string>(static_cast<unsigned long>(GetStepsPerSecond()));
 
   return status;
 }
 
+double StreamlineTrackingFilter::GetTrackingTime() const
+{
+  // the end time is older than the start time while the tracking is running
+  std::chrono::time_point<std::chrono::system_clock> end = m_EndTime<m_StartTime ? std::chrono::system_clock::now() : m_EndTime;
+  return std::chrono::duration<double>(end - m_StartTime).count();
+}
+
+double StreamlineTrackingFilter::GetStreamlinesPerSecond() const
+{
+  double seconds = GetTrackingTime();
+  if (seconds<=0)
+    return 0;
+  return m_CurrentTracts/seconds;
+}
+
+double StreamlineTrackingFilter::GetStepsPerSecond() const
+{
+  double seconds = GetTrackingTime();
+  if (seconds<=0)
+    return 0;
+  return m_NumSteps/seconds;
+}
+
 void StreamlineTrackingFilter::BeforeTracking()
 {
   m_StopTracking = false;
@@ -684,6 +716,23 @@ void StreamlineTrackingFilter::GetSeedPointsFromSeedImage()
     mitkThrow() << "No valid seed point in seed image! Is your seed image registered with the image you are tracking on?";
 }
 
+bool StreamlineTrackingFilter::ReserveTract()
+{
+  unsigned int tract = m_CurrentTracts++;
+  if (m_StopTracking.load() || (m_MaxNumTracts > 0 && tract>=static_cast<unsigned int>(m_MaxNumTracts)))
+  {
+    m_CurrentTracts--;
+    return false;
+  }
+  if (m_MaxNumTracts > 0 && tract+1>=static_cast<unsigned int>(m_MaxNumTracts))
+  {
+    std::cout << "                                                                                                     \r";
+    MITK_INFO << "Reconstructed maximum number of tracts (" << tract+1 << "). Stopping tractography.";
+    m_StopTracking.store(true);
+  }
+  return true;
+}
+
 void StreamlineTrackingFilter::GenerateData()
 {
   this->BeforeTracking();
@@ -691,102 +740,124 @@ void StreamlineTrackingFilter::GenerateData()
     std::random_shuffle(m_SeedPoints.begin(), m_SeedPoints.end());
 
   m_CurrentTracts = 0;
+  m_Progress = 0;
+  m_NumSteps = 0;
   int num_seeds = static_cast<int>(m_SeedPoints.size());
+  int batch_size = static_cast<int>(std::max(m_SeedBatchSize, 1u));
   itk::Index<3> zeroIndex; zeroIndex.Fill(0);
-  m_Progress = 0;
-  int i = 0;
-  int print_interval = num_seeds/100;
-  if (print_interval<100)
+  std::atomic<int> next_seed(0);
+  if (num_seeds/100<100)
     m_Verbose=false;
 
+  // accepted streamlines are collected per thread and merged after the tracking (in demo mode directly in m_Tractogram)
+  std::vector< BundleType > thread_tractograms(static_cast<unsigned int>(omp_get_max_threads()));
+
 #pragma omp parallel
-  while (i<num_seeds && !m_StopTracking)
   {
-    int temp_i = 0;
-#pragma omp critical
-    {
-      temp_i = i;
-      i++;
-    }
+    BundleType& tractogram = m_DemoMode ? m_Tractogram : thread_tractograms.at(static_cast<unsigned int>(omp_get_thread_num()));
+    std::vector< float > stream_buffer;
+    std::chrono::time_point<std::chrono::system_clock> last_print = std::chrono::system_clock::now();
 
-    if (temp_i>=num_seeds || m_StopTracking)
-      continue;
-    else if (m_Verbose && i%print_interval==0)
-#pragma omp critical
+    // the flag is only polled, relaxed loads suffice (it does not publish any other data)
+    while (!m_StopTracking.load(std::memory_order_relaxed))
     {
-      m_Progress += static_cast<unsigned int>(print_interval);
-      std::cout << "                                                                                                     \r";
-      if (m_MaxNumTracts>0)
-        std::cout << "Tried: " << m_Progress << "/" << num_seeds << " | Accepted: " << m_CurrentTracts << "/" << m_MaxNumTracts << '\r';
-      else
-        std::cout << "Tried: " << m_Progress << "/" << num_seeds << " | Accepted: " << m_CurrentTracts << '\r';
-      cout.flush();
-    }
-
-    const itk::Point<float> worldPos = m_SeedPoints.at(static_cast<unsigned int>(temp_i));
-
-    for (unsigned int trials=0; trials<m_TrialsPerSeed; ++trials)
-    {
-      FiberType fib;
-      DirectionContainer direction_container;
-      float tractLength = 0;
-      unsigned long counter = 0;
-
-      // get starting direction
-      vnl_vector_fixed<float,3> dir; dir.fill(0.0);
-      std::deque< vnl_vector_fixed<float,3> > olddirs;
-      dir = GetNewDirection(worldPos, olddirs, zeroIndex) * 0.5f;
-
-      bool exclude = false;
-      if (m_ExclusionRegions.IsNotNull() && mitk::imv::IsInsideMask<float>(worldPos, m_InterpolateMasks, m_ExclusionInterpolator))
-        exclude = true;
-
-      bool success = false;
-      if (dir.magnitude()>0.0001f && !exclude)
+      // claim the next batch of seed points
+      int batch_start = next_seed.fetch_add(batch_size);
+      if (batch_start>=num_seeds)
+        break;
+      int batch_end = std::min(batch_start + batch_size, num_seeds);
+      unsigned long batch_steps = 0;
+
+      int s = batch_start;
+      for (; s<batch_end && !m_StopTracking.load(std::memory_order_relaxed); ++s)
       {
-        // forward tracking
-        tractLength = FollowStreamline(worldPos, dir, &fib, &direction_container, 0, false, exclude);
-        fib.push_front(worldPos);
-
-        // backward tracking
-        if (!exclude)
-          tractLength = FollowStreamline(worldPos, -dir, &fib, &direction_container, tractLength, true, exclude);
+        const itk::Point<float> worldPos = m_SeedPoints.at(static_cast<unsigned int>(s));
 
-        counter = fib.size();
-
-        if (tractLength>=m_MinTractLength && counter>=2 && !exclude)
+        for (unsigned int trials=0; trials<m_TrialsPerSeed; ++trials)
         {
-#pragma omp critical
-          if ( IsValidFiber(&fib) )
+          FiberType fib;
+          DirectionContainer direction_container;
+          float tractLength = 0;
+          unsigned long counter = 0;
+
+          // get starting direction
+          vnl_vector_fixed<float,3> dir; dir.fill(0.0);
+          std::deque< vnl_vector_fixed<float,3> > olddirs;
+          dir = GetNewDirection(worldPos, olddirs, zeroIndex) * 0.5f;
+
+          bool exclude = false;
+          if (m_ExclusionRegions.IsNotNull() && mitk::imv::IsInsideMask<float>(worldPos, m_InterpolateMasks, m_ExclusionInterpolator))
+            exclude = true;
+
+          bool success = false;
+          if (dir.magnitude()>0.0001f && !exclude)
           {
-            if (!m_StopTracking)
+            // forward tracking
+            tractLength = FollowStreamline(worldPos, dir, &fib, &direction_container, 0, false, exclude);
+            fib.push_front(worldPos);
+
+            // backward tracking
+            if (!exclude)
+              tractLength = FollowStreamline(worldPos, -dir, &fib, &direction_container, tractLength, true, exclude);
+
+            counter = fib.size();
+            batch_steps += counter;
+
+            if (tractLength>=m_MinTractLength && counter>=2 && !exclude && IsValidFiber(&fib) && ReserveTract())
             {
-              if (!m_UseOutputProbabilityMap)
-                m_Tractogram.push_back(fib);
-              else
+              if (m_UseOutputProbabilityMap)
+              {
+#pragma omp critical (probmap)
                 FiberToProbmap(&fib);
-              m_CurrentTracts++;
-              success = true;
-            }
-            if (m_MaxNumTracts > 0 && m_CurrentTracts>=static_cast<unsigned int>(m_MaxNumTracts))
-            {
-              if (!m_StopTracking)
+              }
+              else if (m_FiberStreamWriter!=nullptr)
               {
-                std::cout << "                                                                                                     \r";
-                MITK_INFO << "Reconstructed maximum number of tracts (" << m_CurrentTracts << "). Stopping tractography.";
+                stream_buffer.clear();
+                for (const auto& p : fib)
+                  stream_buffer.insert(stream_buffer.end(), p.GetDataPointer(), p.GetDataPointer() + 3);
+                m_FiberStreamWriter->WriteFiber(stream_buffer.data(), static_cast<unsigned int>(fib.size()));
               }
-              m_StopTracking = true;
+              else
+                tractogram.push_back(std::move(fib));
+              success = true;
             }
           }
-        }
-      }
 
-      if (success || m_TrackingHandler->GetMode()!=mitk::TrackingDataHandler::PROBABILISTIC)
-        break;  // we only try one seed point multiple times if we use a probabilistic tracker and have not found a valid streamline yet
+          if (success || m_TrackingHandler->GetMode()!=mitk::TrackingDataHandler::PROBABILISTIC)
+            break;  // we only try one seed point multiple times if we use a probabilistic tracker and have not found a valid streamline yet
 
-    }// trials per seed
+        }// trials per seed
+      }// seed points of batch
 
-  }// seed points
+      m_Progress += static_cast<unsigned int>(s - batch_start);
+      m_NumSteps += batch_steps;
+
+      if (m_Verbose && omp_get_thread_num()==0 && std::chrono::system_clock::now() - last_print > std::chrono::seconds(1))
+      {
+        last_print = std::chrono::system_clock::now();
+        std::cout << "                                                                                                     \r";
+        if (m_MaxNumTracts>0)
+          std::cout << "Tried: " << m_Progress << "/" << num_seeds << " | Accepted: " << m_CurrentTracts << "/" << m_MaxNumTracts;
+        else
+          std::cout << "Tried: " << m_Progress << "/" << num_seeds << " | Accepted: " << m_CurrentTracts;
+        std::cout << " | Streamlines/s: " << static_cast<unsigned long>(GetStreamlinesPerSecond()) << '\r';
+        cout.flush();
+      }
+    }// seed batches
+  }
+
+  if (!m_DemoMode)
+  {
+    size_t num_fibers = 0;
+    for (auto& t : thread_tractograms)
+      num_fibers += t.size();
+    m_Tractogram.reserve(num_fibers);
+    for (auto& t : thread_tractograms)
+    {
+      std::move(t.begin(), t.end(), std::back_inserter(m_Tractogram));
+      BundleType().swap(t);
+    }
+  }
 
   this->AfterTracking();
 }
@@ -906,16 +977,17 @@ void StreamlineTrackingFilter::BuildFibers(bool check)
   vtkSmartPointer<vtkCellArray> vNewLines = vtkSmartPointer<vtkCellArray>::New();
   vtkSmartPointer<vtkPoints> vNewPoints = vtkSmartPointer<vtkPoints>::New();
 
-  for (unsigned int i=0; i<m_Tractogram.size(); i++)
+  vtkIdType num_points = 0;
+  for (const FiberType& fib : m_Tractogram)
+    num_points += static_cast<vtkIdType>(fib.size());
+  vNewPoints->Allocate(num_points);
+  vNewLines->Allocate(static_cast<vtkIdType>(m_Tractogram.size()) + num_points);
+
+  for (const FiberType& fib : m_Tractogram)
   {
-    vtkSmartPointer<vtkPolyLine> container = vtkSmartPointer<vtkPolyLine>::New();
-    FiberType fib = m_Tractogram.at(i);
-    for (FiberType::iterator it = fib.begin(); it!=fib.end(); ++it)
-    {
-      vtkIdType id = vNewPoints->InsertNextPoint((*it).GetDataPointer());
-      container->GetPointIds()->InsertNextId(id);
-    }
-    vNewLines->InsertNextCell(container);
+    vNewLines->InsertNextCell(static_cast<int>(fib.size()));
+    for (const itk::Point<float>& p : fib)
+      vNewLines->InsertCellPoint(vNewPoints->InsertNextPoint(p.GetDataPointer()));
   }
 
   if (check)
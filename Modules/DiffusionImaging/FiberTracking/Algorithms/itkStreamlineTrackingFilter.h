@@ -33,10 +33,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkDiffusionPropertyHelper.h>
 #include <mitkPointSet.h>
 #include <chrono>
+#include <atomic>
 #include <TrackingHandlers/mitkTrackingDataHandler.h>
 #include <MitkFiberTrackingExports.h>
 #include <mitkFiberBundle.h>
 #include <mitkPeakImage.h>
+#include <mitkFiberStreamWriter.h>
 
 namespace itk{
 
@@ -133,6 +135,19 @@ public:
   itkSetMacro( TrackingPriorWeight, float)            ///< Weight between prior and data [0-1]. One mean tracking only on the prior peaks, zero only on the data.
   itkSetMacro( TrackingPriorAsMask, bool)             ///< If true, data directions in voxels where prior directions are invalid are set to zero
   itkSetMacro( IntroduceDirectionsFromPrior, bool)    ///< If false, prior voxels with invalid data voxel are ignored
+  itkSetMacro( SeedBatchSize, unsigned int )          ///< Number of consecutive seed points claimed by a thread at once
+  itkGetMacro( SeedBatchSize, unsigned int )
+
+  ///< If set, accepted streamlines are written to this (opened) writer as soon as they are found instead of being collected in the output polydata
+  void SetFiberStreamWriter( mitk::FiberStreamWriter* writer )
+  {
+    m_FiberStreamWriter = writer;
+  }
+
+  unsigned long GetNumSteps() const { return m_NumSteps; }   ///< Integration steps of all tried streamlines (accepted or not)
+  double GetTrackingTime() const;                           ///< Seconds since the tracking was started (or duration of the last run)
+  double GetStreamlinesPerSecond() const;                   ///< Accepted streamlines per second
+  double GetStepsPerSecond() const;                         ///< Integration steps per second
 
   ///< Use manually defined points in physical space as seed points instead of seed image
   void SetSeedPoints( const std::vector< itk::Point<float> >& sP) {
@@ -212,14 +227,18 @@ protected:
   bool                                m_Random;
   bool                                m_UseOutputProbabilityMap;
   std::vector< itk::Point<float> >    m_SeedPoints;
-  unsigned int                        m_CurrentTracts;
-  unsigned int                        m_Progress;
-  bool                                m_StopTracking;
+  std::atomic<unsigned int>           m_CurrentTracts;
+  std::atomic<unsigned int>           m_Progress;
+  std::atomic<unsigned long>          m_NumSteps;
+  unsigned int                        m_SeedBatchSize;
+  mitk::FiberStreamWriter*            m_FiberStreamWriter;
+  std::atomic<bool>                   m_StopTracking;     ///< set by ReserveTract() (tracking threads) or SetStopTracking() (GUI thread)
   bool                                m_InterpolateMasks;
   unsigned int                        m_TrialsPerSeed;
   EndpointConstraints                 m_EndpointConstraint;
 
   void BuildFibers(bool check);
+  bool ReserveTract();    ///< Counts an accepted streamline. Returns false if the maximum number of tracts is already reached.
   float CheckCurvature(DirectionContainer *fib, bool front);
 
   // decision forest
@@ -23,15 +23,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // misc
 #include <cmath>
+#include <memory>
 #include <boost/progress.hpp>
 #include <vtkBox.h>
 #include <mitkDiffusionFunctionCollection.h>
+#include <mitkFiberStreamReader.h>
 
 namespace itk{
 
 template< class OutputImageType >
 TractDensityImageFilter< OutputImageType >::TractDensityImageFilter()
-  : m_UpsamplingFactor(1)
+  : m_StreamChunkSize(100000)
+  , m_UpsamplingFactor(1)
   , m_InvertImage(false)
   , m_BinaryOutput(false)
   , m_UseImageGeometry(false)
@@ -46,11 +49,106 @@ TractDensityImageFilter< OutputImageType >::~TractDensityImageFilter()
 {
 }
 
+template< class OutputImageType >
+void TractDensityImageFilter< OutputImageType >::ProcessFibers(const mitk::FiberStore& fibers, bool useWeights, boost::progress_display* disp)
+{
+  typename OutputImageType::Pointer outImage = this->GetOutput();
+  itk::Vector<double,3> spacing = outImage->GetSpacing();
+  OutPixelType* outImageBufferPointer = outImage->GetBufferPointer();
+  const ImageRegion<3> region = outImage->GetLargestPossibleRegion();
+  const int depth = static_cast<int>(region.GetSize(2));
+
+  // The fibers of a chunk are distributed in contiguous ranges over the threads. Each thread bins the density
+  // contributions of its fibers by z-slab. Afterwards every slab is filled by one thread, which applies the
+  // contributions in range (and thus fiber) order, so the result equals the sequential one bit by bit.
+  const int numThreads = std::max(1, static_cast<int>(this->GetNumberOfThreads()));
+  const int numSlabs = std::max(1, std::min(4*numThreads, depth));
+  const unsigned int chunkSize = 10000*numThreads;
+
+  typedef std::pair< OffsetValueType, double > ContributionType;
+  std::vector< std::vector< std::vector< ContributionType > > > contributions(numThreads, std::vector< std::vector< ContributionType > >(numSlabs));
+
+  unsigned int numFibers = fibers.GetNumFibers();
+  for (unsigned int chunkStart=0; chunkStart<numFibers; chunkStart+=chunkSize)
+  {
+    const unsigned int chunkEnd = std::min(chunkStart+chunkSize, numFibers);
+
+#pragma omp parallel for num_threads(numThreads)
+    for (int range=0; range<numThreads; range++)
+    {
+      unsigned int begin = chunkStart + static_cast<unsigned int>((static_cast<unsigned long long>(chunkEnd-chunkStart)*range)/numThreads);
+      unsigned int end = chunkStart + static_cast<unsigned int>((static_cast<unsigned long long>(chunkEnd-chunkStart)*(range+1))/numThreads);
+      std::vector< std::vector< ContributionType > >& rangeContributions = contributions[range];
+
+      for (unsigned int i=begin; i<end; i++)
+      {
+        int numPoints = fibers.GetNumPoints(i);
+        float weight = useWeights ? m_FiberBundle->GetFiberWeight(i) : 1;
+
+        for( int j=0; j<numPoints-1; j++)
+        {
+          itk::Point<float, 3> startVertex = fibers.GetItkPoint(i, j);
+          itk::Index<3> startIndex;
+          itk::ContinuousIndex<float, 3> startIndexCont;
+          outImage->TransformPhysicalPointToIndex(startVertex, startIndex);
+          outImage->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
+
+          itk::Point<float, 3> endVertex = fibers.GetItkPoint(i, j + 1);
+          itk::Index<3> endIndex;
+          itk::ContinuousIndex<float, 3> endIndexCont;
+          outImage->TransformPhysicalPointToIndex(endVertex, endIndex);
+          outImage->TransformPhysicalPointToContinuousIndex(endVertex, endIndexCont);
+
+          std::vector< std::pair< itk::Index<3>, double > > segments = mitk::imv::IntersectImage(spacing, startIndex, endIndex, startIndexCont, endIndexCont);
+          for (const std::pair< itk::Index<3>, double >& segment : segments)
+          {
+            if (!region.IsInside(segment.first))
+              continue;
+            int slab = static_cast<int>((segment.first[2] - region.GetIndex(2))*numSlabs/depth);
+            rangeContributions[slab].push_back(ContributionType(outImage->ComputeOffset(segment.first), segment.second * weight));
+          }
+        }
+      }
+    }
+
+    int coveredVoxels = 0;
+#pragma omp parallel for num_threads(numThreads) reduction(+:coveredVoxels)
+    for (int slab=0; slab<numSlabs; slab++)
+      for (int range=0; range<numThreads; range++)
+      {
+        std::vector< ContributionType >& slabContributions = contributions[range][slab];
+        for (const ContributionType& contribution : slabContributions)
+        {
+          OutPixelType& pixel = outImageBufferPointer[contribution.first];
+          if (pixel==0)
+            coveredVoxels++;
+
+          if (m_BinaryOutput)
+            pixel = 1;
+          else
+            pixel = pixel + contribution.second;
+        }
+        slabContributions.clear();
+      }
+    m_NumCoveredVoxels += coveredVoxels;
+
+    if (disp)
+      (*disp) += chunkEnd-chunkStart;
+  }
+}
+
 template< class OutputImageType >
 void TractDensityImageFilter< OutputImageType >::GenerateData()
 {
+  bool streaming = !m_FiberStreamFileName.empty();
+  if (streaming && (!m_UseImageGeometry || m_InputImage.IsNull()))
+    mitkThrow() << "TractDensityImageFilter: streaming fibers from file requires an input image geometry.";
+  if (!streaming && m_FiberBundle.IsNull())
+    mitkThrow() << "TractDensityImageFilter: no input fiber bundle set.";
+
+  m_NumCoveredVoxels = 0;
+
   // generate upsampled image
-  mitk::BaseGeometry::Pointer geometry = m_FiberBundle->GetGeometry();
   typename OutputImageType::Pointer outImage = this->GetOutput();
 
   // calculate new image parameters
@@ -74,6 +172,7 @@ void TractDensityImageFilter< OutputImageType >::GenerateData()
   else
   {
     MITK_INFO << "TractDensityImageFilter: using fiber bundle geometry";
+    mitk::BaseGeometry::Pointer geometry = m_FiberBundle->GetGeometry();
     newSpacing = geometry->GetSpacing()/m_UpsamplingFactor;
     newOrigin = geometry->GetOrigin();
     mitk::Geometry3D::BoundsArrayType bounds = geometry->GetBounds();
@@ -111,48 +210,27 @@ void TractDensityImageFilter< OutputImageType >::GenerateData()
   OutPixelType* outImageBufferPointer = (OutPixelType*)outImage->GetBufferPointer();
 
   MITK_INFO << "TractDensityImageFilter: starting image generation";
-  vtkSmartPointer<vtkPolyData> fiberPolyData = m_FiberBundle->GetFiberPolyData();
-
-  int numFibers = m_FiberBundle->GetNumFibers();
-  boost::progress_display disp(numFibers);
-  for( int i=0; i<numFibers; i++ )
+  if (streaming)
   {
-    ++disp;
-    vtkCell* cell = fiberPolyData->GetCell(i);
-    int numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
-
-    float weight = m_FiberBundle->GetFiberWeight(i);
-
-    // fill output image
-    for( int j=0; j<numPoints-1; j++)
+    // only one chunk of fibers is held in memory at a time
+    mitk::FiberStreamReader reader;
+    reader.Open(m_FiberStreamFileName);
+    std::unique_ptr< boost::progress_display > disp;
+    if (reader.GetNumFibersInHeader()>0)
+      disp.reset(new boost::progress_display(reader.GetNumFibersInHeader()));
+    unsigned long numFibers = reader.ForEachChunk(m_StreamChunkSize, [this, &reader, &disp](const mitk::FiberStore& chunk)
     {
-      itk::Point<float, 3> startVertex = mitk::imv::GetItkPoint(points->GetPoint(j));
-      itk::Index<3> startIndex;
-      itk::ContinuousIndex<float, 3> startIndexCont;
-      outImage->TransformPhysicalPointToIndex(startVertex, startIndex);
-      outImage->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
-
-      itk::Point<float, 3> endVertex = mitk::imv::GetItkPoint(points->GetPoint(j + 1));
-      itk::Index<3> endIndex;
-      itk::ContinuousIndex<float, 3> endIndexCont;
-      outImage->TransformPhysicalPointToIndex(endVertex, endIndex);
-      outImage->TransformPhysicalPointToContinuousIndex(endVertex, endIndexCont);
-
-      std::vector< std::pair< itk::Index<3>, double > > segments = mitk::imv::IntersectImage(newSpacing, startIndex, endIndex, startIndexCont, endIndexCont);
-      for (std::pair< itk::Index<3>, double > segment : segments)
-      {
-        if (!outImage->GetLargestPossibleRegion().IsInside(segment.first))
-          continue;
-        if (outImage->GetPixel(segment.first)==0)
-          m_NumCoveredVoxels++;
-
-        if (m_BinaryOutput)
-          outImage->SetPixel(segment.first, 1);
-        else
-          outImage->SetPixel(segment.first, outImage->GetPixel(segment.first)+segment.second * weight);
-      }
-    }
+      this->ProcessFibers(chunk, false, disp.get());
+      if (!disp)
+        MITK_INFO << "TractDensityImageFilter: processed " << reader.GetNumFibersRead() << " fibers";
+    });
+    MITK_INFO << "TractDensityImageFilter: streamed " << numFibers << " fibers from " << m_FiberStreamFileName;
+  }
+  else
+  {
+    std::shared_ptr<const mitk::FiberStore> fibers = m_FiberBundle->GetFiberStore();
+    boost::progress_display disp(fibers->GetNumFibers());
+    ProcessFibers(*fibers, true, &disp);
   }
 
   m_MaxDensity = 0;
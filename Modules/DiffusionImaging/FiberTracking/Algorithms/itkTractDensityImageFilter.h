@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkVectorContainer.h>
 #include <itkRGBAPixel.h>
 #include <mitkFiberBundle.h>
+#include <mitkFiberStore.h>
+#include <boost/progress.hpp>
 
 namespace itk{
 
@@ -54,6 +56,10 @@ public:
   itkSetMacro( UseImageGeometry, bool)                          ///< use input image geometry to initialize output image
   itkGetMacro( UseImageGeometry, bool)                          ///< use input image geometry to initialize output image
   itkSetMacro( FiberBundle, mitk::FiberBundle::Pointer)         ///< input fiber bundle
+  itkSetMacro( FiberStreamFileName, std::string)                ///< stream fibers chunk-wise from this .tck/.trk file instead of using the fiber bundle (requires input image geometry)
+  itkGetMacro( FiberStreamFileName, std::string)
+  itkSetMacro( StreamChunkSize, unsigned int)                   ///< number of fibers held in memory when streaming from file
+  itkGetMacro( StreamChunkSize, unsigned int)
   itkSetMacro( InputImage, typename OutputImageType::Pointer)   ///< use input image geometry to initialize output image
   itkGetMacro( MaxDensity, OutPixelType)
   itkGetMacro( NumCoveredVoxels, unsigned int)
@@ -65,8 +71,13 @@ protected:
   TractDensityImageFilter();
   ~TractDensityImageFilter() override;
 
+  /** Adds the fibers to the output image using GetNumberOfThreads() OpenMP threads. The weights are taken from m_FiberBundle if useWeights is set, otherwise 1 is used. The progress display (if given) is advanced by the number of fibers. */
+  void ProcessFibers(const mitk::FiberStore& fibers, bool useWeights, boost::progress_display* disp);
+
   typename OutputImageType::Pointer m_InputImage;           ///< use input image geometry to initialize output image
   mitk::FiberBundle::Pointer        m_FiberBundle;          ///< input fiber bundle
+  std::string                       m_FiberStreamFileName;  ///< input tractogram file for streaming mode
+  unsigned int                      m_StreamChunkSize;      ///< number of fibers per chunk in streaming mode
   float                             m_UpsamplingFactor;     ///< use higher resolution for ouput image
   bool                              m_InvertImage;          ///< voxelvalue = 1-voxelvalue
   bool                              m_BinaryOutput;         ///< generate binary fiber envelope
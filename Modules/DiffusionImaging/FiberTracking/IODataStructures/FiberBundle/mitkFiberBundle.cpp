@@ -44,11 +44,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkLookupTable.h>
 #include <vtkCardinalSpline.h>
 #include <vtkAppendPolyData.h>
+#include <itkMutexLockHolder.h>
 
 const char* mitk::FiberBundle::FIBER_ID_ARRAY = "Fiber_IDs";
 
 mitk::FiberBundle::FiberBundle( vtkPolyData* fiberPolyData )
   : m_NumFibers(0)
+  , m_FiberStorePolyData(nullptr)
+  , m_FiberStoreMTime(0)
+  , m_FiberSpatialIndexPolyData(nullptr)
+  , m_FiberSpatialIndexMTime(0)
 {
   m_FiberWeights = vtkSmartPointer<vtkFloatArray>::New();
   m_FiberWeights->SetName("FIBER_WEIGHTS");
@@ -505,6 +510,42 @@ vtkSmartPointer<vtkPolyData> mitk::FiberBundle::GetFiberPolyData() const
   return m_FiberPolyData;
 }
 
+/*
+ * return contiguous copy of the fibers, rebuilt if the polydata was replaced or modified
+ */
+std::shared_ptr<const mitk::FiberStore> mitk::FiberBundle::GetFiberStore() const
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_FiberStoreLock);
+  return this->InternalGetFiberStore();
+}
+
+std::shared_ptr<const mitk::FiberStore> mitk::FiberBundle::InternalGetFiberStore() const
+{
+  if (!m_FiberStore || m_FiberStorePolyData!=m_FiberPolyData.GetPointer() || m_FiberStoreMTime!=m_FiberPolyData->GetMTime())
+  {
+    auto fibers = std::make_shared<FiberStore>();
+    fibers->SetFromPolyData(m_FiberPolyData, false);
+    m_FiberStore = fibers;
+    m_FiberStorePolyData = m_FiberPolyData.GetPointer();
+    m_FiberStoreMTime = m_FiberPolyData->GetMTime();
+  }
+  return m_FiberStore;
+}
+
+std::shared_ptr<const mitk::FiberSpatialIndex> mitk::FiberBundle::GetFiberSpatialIndex() const
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_FiberStoreLock);
+  if (!m_FiberSpatialIndex || m_FiberSpatialIndexPolyData!=m_FiberPolyData.GetPointer() || m_FiberSpatialIndexMTime!=m_FiberPolyData->GetMTime())
+  {
+    auto index = std::make_shared<FiberSpatialIndex>();
+    index->Build(*this->InternalGetFiberStore());
+    m_FiberSpatialIndex = index;
+    m_FiberSpatialIndexPolyData = m_FiberPolyData.GetPointer();
+    m_FiberSpatialIndexMTime = m_FiberPolyData->GetMTime();
+  }
+  return m_FiberSpatialIndex;
+}
+
 void mitk::FiberBundle::ColorFibersByLength(bool opacity, bool normalize)
 {
   if (m_MaxFiberLength<=0)
@@ -531,11 +572,12 @@ void mitk::FiberBundle::ColorFibersByLength(bool opacity, bool normalize)
   mitkLookup->SetType(mitk::LookupTable::JET);
 
   unsigned int count = 0;
-  for (unsigned int i=0; i<m_FiberPolyData->GetNumberOfCells(); i++)
+  vtkCellArray* lines = m_FiberPolyData->GetLines();
+  vtkIdType numPoints = 0;
+  vtkIdType* ids = nullptr;
+  lines->InitTraversal();
+  for (unsigned int i=0; lines->GetNextCell(numPoints, ids); i++)
   {
-    vtkCell* cell = m_FiberPolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
-
     float l = m_FiberLengths.at(i)/m_MaxFiberLength;
     if (!normalize)
     {
@@ -555,7 +597,7 @@ void mitk::FiberBundle::ColorFibersByLength(bool opacity, bool normalize)
         rgba[3] = static_cast<unsigned char>(255.0f * l);
       else
         rgba[3] = static_cast<unsigned char>(255.0);
-      m_FiberColors->InsertTypedTuple(cell->GetPointId(j), rgba);
+      m_FiberColors->InsertTypedTuple(ids[j], rgba);
       count++;
     }
   }
@@ -699,12 +741,14 @@ void mitk::FiberBundle::ColorFibersByCurvature(bool, bool normalize)
   double max = 0;
   MITK_INFO << "Coloring fibers by curvature";
   boost::progress_display disp(static_cast<unsigned long>(m_FiberPolyData->GetNumberOfCells()));
-  for (int i=0; i<m_FiberPolyData->GetNumberOfCells(); i++)
+  vtkCellArray* lines = m_FiberPolyData->GetLines();
+  vtkPoints* points = m_FiberPolyData->GetPoints();
+  vtkIdType numPoints = 0;
+  vtkIdType* ids = nullptr;
+  lines->InitTraversal();
+  while (lines->GetNextCell(numPoints, ids))
   {
     ++disp;
-    vtkCell* cell = m_FiberPolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
 
     // calculate curvatures
     for (int j=0; j<numPoints; j++)
@@ -716,9 +760,9 @@ void mitk::FiberBundle::ColorFibersByCurvature(bool, bool normalize)
       while(dist<window/2 && c>1)
       {
         double p1[3];
-        points->GetPoint(c-1, p1);
+        points->GetPoint(ids[c-1], p1);
         double p2[3];
-        points->GetPoint(c, p2);
+        points->GetPoint(ids[c], p2);
 
         vnl_vector_fixed< double, 3 > v;
         v[0] = p2[0]-p1[0];
@@ -735,9 +779,9 @@ void mitk::FiberBundle::ColorFibersByCurvature(bool, bool normalize)
       while(dist<window/2 && c<numPoints-1)
       {
         double p1[3];
-        points->GetPoint(c, p1);
+        points->GetPoint(ids[c], p1);
         double p2[3];
-        points->GetPoint(c+1, p2);
+        points->GetPoint(ids[c+1], p2);
 
         vnl_vector_fixed< double, 3 > v;
         v[0] = p2[0]-p1[0];
@@ -773,10 +817,9 @@ void mitk::FiberBundle::ColorFibersByCurvature(bool, bool normalize)
     }
   }
   unsigned int count = 0;
-  for (int i=0; i<m_FiberPolyData->GetNumberOfCells(); i++)
+  lines->InitTraversal();
+  while (lines->GetNextCell(numPoints, ids))
   {
-    vtkCell* cell = m_FiberPolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
     for (int j=0; j<numPoints; j++)
     {
       double color[3];
@@ -791,7 +834,7 @@ void mitk::FiberBundle::ColorFibersByCurvature(bool, bool normalize)
       rgba[1] = static_cast<unsigned char>(255.0 * color[1]);
       rgba[2] = static_cast<unsigned char>(255.0 * color[2]);
       rgba[3] = static_cast<unsigned char>(255.0);
-      m_FiberColors->InsertTypedTuple(cell->GetPointId(j), rgba);
+      m_FiberColors->InsertTypedTuple(ids[j], rgba);
       count++;
     }
   }
@@ -996,7 +1039,8 @@ void mitk::FiberBundle::GenerateFiberIds()
 
 float mitk::FiberBundle::GetNumEpFractionInMask(ItkUcharImgType* mask, bool different_label)
 {
-  vtkSmartPointer<vtkPolyData> PolyData = m_FiberPolyData;
+  std::shared_ptr<const FiberStore> fiberStore = this->GetFiberStore();
+  const FiberStore& fibers = *fiberStore;
 
   MITK_INFO << "Calculating EP-Fraction";
 
@@ -1006,15 +1050,15 @@ float mitk::FiberBundle::GetNumEpFractionInMask(ItkUcharImgType* mask, bool diff
   for (unsigned int i=0; i<m_NumFibers; i++)
   {
     ++disp;
-    vtkCell* cell = PolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
+    auto numPoints = fibers.GetNumPoints(i);
+    if (numPoints==0)
+      continue;
 
-    itk::Point<float, 3> startVertex =mitk::imv::GetItkPoint(points->GetPoint(0));
+    itk::Point<float, 3> startVertex = fibers.GetItkPoint(i, 0);
     itk::Index<3> startIndex;
     mask->TransformPhysicalPointToIndex(startVertex, startIndex);
 
-    itk::Point<float, 3> endVertex =mitk::imv::GetItkPoint(points->GetPoint(numPoints-1));
+    itk::Point<float, 3> endVertex = fibers.GetItkPoint(i, numPoints-1);
     itk::Index<3> endIndex;
     mask->TransformPhysicalPointToIndex(endVertex, endIndex);
 
@@ -1023,7 +1067,7 @@ float mitk::FiberBundle::GetNumEpFractionInMask(ItkUcharImgType* mask, bool diff
       float v1 = mask->GetPixel(startIndex);
       if (v1 < 0.5f)
         continue;
-      float v2 = mask->GetPixel(startIndex);
+      float v2 = mask->GetPixel(endIndex);
       if (v2 < 0.5f)
         continue;
 
@@ -1038,7 +1082,8 @@ float mitk::FiberBundle::GetNumEpFractionInMask(ItkUcharImgType* mask, bool diff
 
 std::tuple<float, float> mitk::FiberBundle::GetDirectionalOverlap(ItkUcharImgType* mask, mitk::PeakImage::ItkPeakImageType* peak_image)
 {
-  vtkSmartPointer<vtkPolyData> PolyData = m_FiberPolyData;
+  std::shared_ptr<const FiberStore> fiberStore = this->GetFiberStore();
+  const FiberStore& fibers = *fiberStore;
 
   MITK_INFO << "Calculating overlap";
   auto spacing = mask->GetSpacing();
@@ -1049,19 +1094,17 @@ std::tuple<float, float> mitk::FiberBundle::GetDirectionalOverlap(ItkUcharImgTyp
   for (unsigned int i=0; i<m_NumFibers; i++)
   {
     ++disp;
-    vtkCell* cell = PolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
+    int numPoints = static_cast<int>(fibers.GetNumPoints(i));
 
     for (int j=0; j<numPoints-1; j++)
     {
-      itk::Point<float, 3> startVertex =mitk::imv::GetItkPoint(points->GetPoint(j));
+      itk::Point<float, 3> startVertex = fibers.GetItkPoint(i, j);
       itk::Index<3> startIndex;
       itk::ContinuousIndex<float, 3> startIndexCont;
       mask->TransformPhysicalPointToIndex(startVertex, startIndex);
       mask->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
 
-      itk::Point<float, 3> endVertex =mitk::imv::GetItkPoint(points->GetPoint(j + 1));
+      itk::Point<float, 3> endVertex = fibers.GetItkPoint(i, j + 1);
       itk::Index<3> endIndex;
       itk::ContinuousIndex<float, 3> endIndexCont;
       mask->TransformPhysicalPointToIndex(endVertex, endIndex);
@@ -1114,7 +1157,8 @@ std::tuple<float, float> mitk::FiberBundle::GetDirectionalOverlap(ItkUcharImgTyp
 
 float mitk::FiberBundle::GetOverlap(ItkUcharImgType* mask)
 {
-  vtkSmartPointer<vtkPolyData> PolyData = m_FiberPolyData;
+  std::shared_ptr<const FiberStore> fiberStore = this->GetFiberStore();
+  const FiberStore& fibers = *fiberStore;
 
   MITK_INFO << "Calculating overlap";
   auto spacing = mask->GetSpacing();
@@ -1124,19 +1168,17 @@ float mitk::FiberBundle::GetOverlap(ItkUcharImgType* mask)
   for (unsigned int i=0; i<m_NumFibers; i++)
   {
     ++disp;
-    vtkCell* cell = PolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
+    int numPoints = static_cast<int>(fibers.GetNumPoints(i));
 
     for (int j=0; j<numPoints-1; j++)
     {
-      itk::Point<float, 3> startVertex =mitk::imv::GetItkPoint(points->GetPoint(j));
+      itk::Point<float, 3> startVertex = fibers.GetItkPoint(i, j);
       itk::Index<3> startIndex;
       itk::ContinuousIndex<float, 3> startIndexCont;
       mask->TransformPhysicalPointToIndex(startVertex, startIndex);
       mask->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
 
-      itk::Point<float, 3> endVertex =mitk::imv::GetItkPoint(points->GetPoint(j + 1));
+      itk::Point<float, 3> endVertex = fibers.GetItkPoint(i, j + 1);
       itk::Index<3> endIndex;
       itk::ContinuousIndex<float, 3> endIndexCont;
       mask->TransformPhysicalPointToIndex(endVertex, endIndex);
@@ -1166,6 +1208,8 @@ mitk::FiberBundle::Pointer mitk::FiberBundle::RemoveFibersOutside(ItkUcharImgTyp
   vtkSmartPointer<vtkCellArray> vtkNewCells = vtkSmartPointer<vtkCellArray>::New();
 
   std::vector< float > fib_weights;
+  std::shared_ptr<const FiberStore> fiberStore = this->GetFiberStore();
+  const FiberStore& fibers = *fiberStore;
 
   MITK_INFO << "Cutting fibers";
   boost::progress_display disp(m_NumFibers);
@@ -1173,9 +1217,7 @@ mitk::FiberBundle::Pointer mitk::FiberBundle::RemoveFibersOutside(ItkUcharImgTyp
   {
     ++disp;
 
-    vtkCell* cell = m_FiberPolyData->GetCell(i);
-    auto numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
+    int numPoints = static_cast<int>(fibers.GetNumPoints(i));
 
     vtkSmartPointer<vtkPolyLine> container = vtkSmartPointer<vtkPolyLine>::New();
     int newNumPoints = 0;
@@ -1183,7 +1225,7 @@ mitk::FiberBundle::Pointer mitk::FiberBundle::RemoveFibersOutside(ItkUcharImgTyp
     {
       for (int j=0; j<numPoints; j++)
       {
-        itk::Point<float, 3> itkP =mitk::imv::GetItkPoint(points->GetPoint(j));
+        itk::Point<float, 3> itkP = fibers.GetItkPoint(i, j);
         itk::Index<3> idx;
         mask->TransformPhysicalPointToIndex(itkP, idx);
 
@@ -1277,6 +1319,17 @@ mitk::FiberBundle::Pointer mitk::FiberBundle::ExtractFiberSubset(DataNode* roi,
 }
 
 std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi, DataStorage* storage)
+{
+  if (roi==nullptr || roi->GetData()==nullptr)
+    return std::vector<unsigned int>();
+
+  // fetched once for the whole ROI tree, the children of composite ROIs use the same copies
+  std::shared_ptr<const FiberStore> fiberStore = this->GetFiberStore();
+  std::shared_ptr<const FiberSpatialIndex> spatialIndex = this->GetFiberSpatialIndex();
+  return this->ExtractFiberIdSubset(roi, storage, *fiberStore, *spatialIndex);
+}
+
+std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi, DataStorage* storage, const FiberStore& fibers, const FiberSpatialIndex& index)
 {
   std::vector<unsigned int> result;
   if (roi==nullptr || roi->GetData()==nullptr)
@@ -1294,11 +1347,11 @@ std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi,
     case 0: // AND
     {
       MITK_INFO << "AND";
-      result = this->ExtractFiberIdSubset(children->ElementAt(0), storage);
+      result = this->ExtractFiberIdSubset(children->ElementAt(0), storage, fibers, index);
       std::vector<unsigned int>::iterator it;
       for (unsigned int i=1; i<children->Size(); ++i)
       {
-        std::vector<unsigned int> inRoi = this->ExtractFiberIdSubset(children->ElementAt(i), storage);
+        std::vector<unsigned int> inRoi = this->ExtractFiberIdSubset(children->ElementAt(i), storage, fibers, index);
 
         std::vector<unsigned int> rest(std::min(result.size(),inRoi.size()));
         it = std::set_intersection(result.begin(), result.end(), inRoi.begin(), inRoi.end(), rest.begin() );
@@ -1310,12 +1363,12 @@ std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi,
     case 1: // OR
     {
       MITK_INFO << "OR";
-      result = ExtractFiberIdSubset(children->ElementAt(0), storage);
+      result = this->ExtractFiberIdSubset(children->ElementAt(0), storage, fibers, index);
       std::vector<unsigned int>::iterator it;
       for (unsigned int i=1; i<children->Size(); ++i)
       {
         it = result.end();
-        std::vector<unsigned int> inRoi = ExtractFiberIdSubset(children->ElementAt(i), storage);
+        std::vector<unsigned int> inRoi = this->ExtractFiberIdSubset(children->ElementAt(i), storage, fibers, index);
         result.insert(it, inRoi.begin(), inRoi.end());
       }
 
@@ -1334,7 +1387,7 @@ std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi,
       std::vector<unsigned int>::iterator it;
       for (unsigned int i=0; i<children->Size(); ++i)
       {
-        std::vector<unsigned int> inRoi = ExtractFiberIdSubset(children->ElementAt(i), storage);
+        std::vector<unsigned int> inRoi = this->ExtractFiberIdSubset(children->ElementAt(i), storage, fibers, index);
 
         std::vector<unsigned int> rest(result.size()-inRoi.size());
         it = std::set_difference(result.begin(), result.end(), inRoi.begin(), inRoi.end(), rest.begin() );
@@ -1361,36 +1414,41 @@ std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi,
       }
 
       MITK_INFO << "Extracting with polygon";
-      boost::progress_display disp(m_NumFibers);
-      for (unsigned int i=0; i<m_NumFibers; i++)
+      double tolerance = 0.001;
+
+      // only segments close to the polygon are tested
+      double bounds[6];
+      polygonVtk->GetPoints()->GetBounds(bounds);
+      double pad = tolerance*std::sqrt(polygonVtk->GetLength2()) + tolerance;
+      for (int d=0; d<3; ++d)
       {
-        ++disp ;
-        vtkCell* cell = m_FiberPolyData->GetCell(i);
-        auto numPoints = cell->GetNumberOfPoints();
-        vtkPoints* points = cell->GetPoints();
+        bounds[2*d] -= pad;
+        bounds[2*d+1] += pad;
+      }
+      std::vector< size_t > segments;
+      index.GetSegments(bounds, segments);
 
-        for (int j=0; j<numPoints-1; j++)
-        {
-          // Inputs
-          double p1[3] = {0,0,0};
-          points->GetPoint(j, p1);
-          double p2[3] = {0,0,0};
-          points->GetPoint(j+1, p2);
-          double tolerance = 0.001;
-
-          // Outputs
-          double t = 0; // Parametric coordinate of intersection (0 (corresponding to p1) to 1 (corresponding to p2))
-          double x[3] = {0,0,0}; // The coordinate of the intersection
-          double pcoords[3] = {0,0,0};
-          int subId = 0;
-
-          int iD = polygonVtk->IntersectWithLine(p1, p2, tolerance, t, x, pcoords, subId);
-          if (iD!=0)
-          {
-            result.push_back(i);
-            break;
-          }
-        }
+      // segments are sorted by their point index and hence by fiber
+      const float* points = fibers.GetPoints();
+      for (size_t k : segments)
+      {
+        unsigned int i = fibers.GetFiberOfPoint(k);
+        if (!result.empty() && result.back()==i)
+          continue;
+
+        // Inputs
+        double p1[3] = {points[3*k], points[3*k+1], points[3*k+2]};
+        double p2[3] = {points[3*k+3], points[3*k+4], points[3*k+5]};
+
+        // Outputs
+        double t = 0; // Parametric coordinate of intersection (0 (corresponding to p1) to 1 (corresponding to p2))
+        double x[3] = {0,0,0}; // The coordinate of the intersection
+        double pcoords[3] = {0,0,0};
+        int subId = 0;
+
+        int iD = polygonVtk->IntersectWithLine(p1, p2, tolerance, t, x, pcoords, subId);
+        if (iD!=0)
+          result.push_back(i);
       }
     }
     else if ( dynamic_cast<mitk::PlanarCircle*>(roi->GetData()) )
@@ -1407,37 +1465,41 @@ std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi,
       radius *= radius;
 
       MITK_INFO << "Extracting with circle";
-      boost::progress_display disp(m_NumFibers);
-      for (unsigned int i=0; i<m_NumFibers; i++)
+
+      // only segments close to the circle are tested
+      double bounds[6];
+      double pad = std::sqrt(radius) + 0.001;
+      for (int d=0; d<3; ++d)
       {
-        ++disp ;
-        vtkCell* cell = m_FiberPolyData->GetCell(i);
-        auto numPoints = cell->GetNumberOfPoints();
-        vtkPoints* points = cell->GetPoints();
+        bounds[2*d] = V1w[d] - pad;
+        bounds[2*d+1] = V1w[d] + pad;
+      }
+      std::vector< size_t > segments;
+      index.GetSegments(bounds, segments);
 
-        for (int j=0; j<numPoints-1; j++)
-        {
-          // Inputs
-          double p1[3] = {0,0,0};
-          points->GetPoint(j, p1);
-          double p2[3] = {0,0,0};
-          points->GetPoint(j+1, p2);
+      // segments are sorted by their point index and hence by fiber
+      const float* points = fibers.GetPoints();
+      for (size_t k : segments)
+      {
+        unsigned int i = fibers.GetFiberOfPoint(k);
+        if (!result.empty() && result.back()==i)
+          continue;
 
-          // Outputs
-          double t = 0; // Parametric coordinate of intersection (0 (corresponding to p1) to 1 (corresponding to p2))
-          double x[3] = {0,0,0}; // The coordinate of the intersection
+        // Inputs
+        double p1[3] = {points[3*k], points[3*k+1], points[3*k+2]};
+        double p2[3] = {points[3*k+3], points[3*k+4], points[3*k+5]};
 
-          int iD = vtkPlane::IntersectWithLine(p1,p2,planeNormal.GetDataPointer(),V1w.GetDataPointer(),t,x);
+        // Outputs
+        double t = 0; // Parametric coordinate of intersection (0 (corresponding to p1) to 1 (corresponding to p2))
+        double x[3] = {0,0,0}; // The coordinate of the intersection
 
-          if (iD!=0)
-          {
-            double dist = (x[0]-V1w[0])*(x[0]-V1w[0])+(x[1]-V1w[1])*(x[1]-V1w[1])+(x[2]-V1w[2])*(x[2]-V1w[2]);
-            if( dist <= radius)
-            {
-              result.push_back(i);
-              break;
-            }
-          }
+        int iD = vtkPlane::IntersectWithLine(p1,p2,planeNormal.GetDataPointer(),V1w.GetDataPointer(),t,x);
+
+        if (iD!=0)
+        {
+          double dist = (x[0]-V1w[0])*(x[0]-V1w[0])+(x[1]-V1w[1])*(x[1]-V1w[1])+(x[2]-V1w[2])*(x[2]-V1w[2]);
+          if( dist <= radius)
+            result.push_back(i);
         }
       }
     }
@@ -1449,6 +1511,13 @@ std::vector<unsigned int> mitk::FiberBundle::ExtractFiberIdSubset(DataNode *roi,
 
 void mitk::FiberBundle::UpdateFiberGeometry()
 {
+  {
+    // the copies are rebuilt from the new polydata on their next use
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_FiberStoreLock);
+    m_FiberStore.reset();
+    m_FiberSpatialIndex.reset();
+  }
+
   vtkSmartPointer<vtkCleanPolyData> cleaner = vtkSmartPointer<vtkCleanPolyData>::New();
   cleaner->SetInputData(m_FiberPolyData);
   cleaner->PointMergingOff();
@@ -1486,19 +1555,22 @@ void mitk::FiberBundle::UpdateFiberGeometry()
   double b[6];
   m_FiberPolyData->GetBounds(b);
 
-  // calculate statistics
-  for (int i=0; i<m_FiberPolyData->GetNumberOfCells(); i++)
+  // calculate statistics, the point ids of the lines are traversed directly (no vtkCell per fiber)
+  vtkCellArray* lines = m_FiberPolyData->GetLines();
+  vtkPoints* points = m_FiberPolyData->GetPoints();
+  vtkIdType numIds = 0;
+  vtkIdType* ids = nullptr;
+  lines->InitTraversal();
+  for (unsigned int i=0; lines->GetNextCell(numIds, ids); i++)
   {
-    vtkCell* cell = m_FiberPolyData->GetCell(i);
-    auto p = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
+    int p = static_cast<int>(numIds);
     float length = 0;
     for (int j=0; j<p-1; j++)
     {
       double p1[3];
-      points->GetPoint(j, p1);
+      points->GetPoint(ids[j], p1);
       double p2[3];
-      points->GetPoint(j+1, p2);
+      points->GetPoint(ids[j+1], p2);
 
       double dist = std::sqrt((p1[0]-p2[0])*(p1[0]-p2[0])+(p1[1]-p2[1])*(p1[1]-p2[1])+(p1[2]-p2[2])*(p1[2]-p2[2]));
       length += static_cast<float>(dist);
@@ -2112,21 +2184,25 @@ void mitk::FiberBundle::ResampleSpline(float pointDistance, double tension, doub
   std::vector< vtkSmartPointer<vtkPolyLine> > resampled_streamlines;
   resampled_streamlines.resize(m_NumFibers);
 
+  // the threads read the points from the store, GetCell() of the polydata is not thread safe
+  std::shared_ptr<const FiberStore> fiberStore = this->GetFiberStore();
+  const FiberStore& fibers = *fiberStore;
+
   boost::progress_display disp(m_NumFibers);
 #pragma omp parallel for
   for (int i=0; i<static_cast<int>(m_NumFibers); i++)
   {
-    vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
-    float length = 0;
+    float length = m_FiberLengths.at(static_cast<unsigned int>(i));
 #pragma omp critical
+    ++disp;
+
+    unsigned int numPoints = fibers.GetNumPoints(static_cast<unsigned int>(i));
+    vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+    newPoints->SetNumberOfPoints(numPoints);
+    for (unsigned int j=0; j<numPoints; j++)
     {
-      length = m_FiberLengths.at(static_cast<unsigned int>(i));
-      ++disp;
-      vtkCell* cell = m_FiberPolyData->GetCell(i);
-      auto numPoints = cell->GetNumberOfPoints();
-      vtkPoints* points = cell->GetPoints();
-      for (int j=0; j<numPoints; j++)
-        newPoints->InsertNextPoint(points->GetPoint(j));
+      const float* p = fibers.GetPoint(static_cast<unsigned int>(i), j);
+      newPoints->SetPoint(j, p[0], p[1], p[2]);
     }
 
     int sampling = static_cast<int>(std::ceil(length/pointDistance));
@@ -2186,13 +2262,7 @@ void mitk::FiberBundle::ResampleSpline(float pointDistance)
 
 unsigned int mitk::FiberBundle::GetNumberOfPoints() const
 {
-  unsigned int points = 0;
-  for (int i=0; i<m_FiberPolyData->GetNumberOfCells(); i++)
-  {
-    vtkCell* cell = m_FiberPolyData->GetCell(i);
-    points += cell->GetNumberOfPoints();
-  }
-  return points;
+  return static_cast<unsigned int>(m_FiberPolyData->GetNumberOfPoints());
 }
 
 void mitk::FiberBundle::Compress(float error)
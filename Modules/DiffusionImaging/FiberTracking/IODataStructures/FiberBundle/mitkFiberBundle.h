@@ -37,6 +37,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkFloatArray.h>
 #include <itkScalableAffineTransform.h>
 #include <mitkDiffusionFunctionCollection.h>
+#include <mitkFiberStore.h>
+#include <mitkFiberSpatialIndex.h>
+#include <itkSimpleFastMutexLock.h>
+#include <memory>
 
 namespace mitk {
 
@@ -151,6 +155,12 @@ public:
     void SetFiberWeights(vtkSmartPointer<vtkFloatArray> weights);
     void SetFiberPolyData(vtkSmartPointer<vtkPolyData>, bool updateGeometry = true);
     vtkSmartPointer<vtkPolyData> GetFiberPolyData() const;
+    /** Contiguous copy of the fiber points (without point data) used by the processing methods. The copy is built on
+     * first use and kept until the polydata is replaced or modified. */
+    std::shared_ptr<const FiberStore> GetFiberStore() const;
+    /** Grid over the fiber segments used by the ROI based extraction. Built on first use and kept until the polydata is
+     * modified. */
+    std::shared_ptr<const FiberSpatialIndex> GetFiberSpatialIndex() const;
     itkGetConstMacro( NumFibers, unsigned int)
     //itkGetMacro( FiberSampling, int)
     itkGetConstMacro( MinFiberLength, float )
@@ -188,6 +198,8 @@ protected:
 
 private:
 
+    std::vector<unsigned int>      ExtractFiberIdSubset(DataNode* roi, DataStorage* storage, const FiberStore& fibers, const FiberSpatialIndex& index);
+
     // actual fiber container
     vtkSmartPointer<vtkPolyData>  m_FiberPolyData;
 
@@ -207,6 +219,17 @@ private:
     itk::TimeStamp m_UpdateTime2D;
     itk::TimeStamp m_UpdateTime3D;
     mitk::BaseGeometry::Pointer m_ReferenceGeometry;
+
+    std::shared_ptr<const FiberStore> InternalGetFiberStore() const;  ///< caller holds m_FiberStoreLock
+
+    // structure-of-arrays copy of m_FiberPolyData, built on first use and released by UpdateFiberGeometry()
+    mutable std::shared_ptr<const FiberStore> m_FiberStore;
+    mutable vtkPolyData* m_FiberStorePolyData;
+    mutable vtkMTimeType m_FiberStoreMTime;
+    mutable std::shared_ptr<const FiberSpatialIndex> m_FiberSpatialIndex;
+    mutable vtkPolyData* m_FiberSpatialIndexPolyData;
+    mutable vtkMTimeType m_FiberSpatialIndexMTime;
+    mutable itk::SimpleFastMutexLock m_FiberStoreLock;
 };
 
 } // namespace mitk
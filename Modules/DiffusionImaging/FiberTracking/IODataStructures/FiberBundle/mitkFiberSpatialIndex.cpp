@@ -0,0 +1,172 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkFiberSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double FIBER_INDEX_MAX_CELLS = 4194304;
+static const double FIBER_INDEX_SEGMENTS_PER_CELL = 4;
+
+mitk::FiberSpatialIndex::FiberSpatialIndex()
+{
+  Clear();
+}
+
+void mitk::FiberSpatialIndex::Clear()
+{
+  m_Origin[0] = m_Origin[1] = m_Origin[2] = 0;
+  m_Dims[0] = m_Dims[1] = m_Dims[2] = 0;
+  m_CellSize = 1;
+  m_CellOffsets.clear();
+  m_Segments.clear();
+  m_Built = false;
+}
+
+void mitk::FiberSpatialIndex::Build(const FiberStore& fibers, double cellSize)
+{
+  Clear();
+  m_Built = true;
+
+  const float* points = fibers.GetPoints();
+  size_t numSegments = 0;
+  double bounds[6] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+                       std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+                       std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() };
+  for (unsigned int i=0; i<fibers.GetNumFibers(); ++i)
+  {
+    if (fibers.GetNumPoints(i)<2)
+      continue;
+    numSegments += fibers.GetNumPoints(i)-1;
+    for (size_t k=fibers.GetFiberOffset(i); k<fibers.GetFiberOffset(i+1); ++k)
+      for (int d=0; d<3; ++d)
+      {
+        bounds[2*d] = std::min(bounds[2*d], static_cast<double>(points[3*k+d]));
+        bounds[2*d+1] = std::max(bounds[2*d+1], static_cast<double>(points[3*k+d]));
+      }
+  }
+  if (numSegments==0)
+    return;
+
+  double extent[3];
+  double maxExtent = 0;
+  for (int d=0; d<3; ++d)
+  {
+    m_Origin[d] = bounds[2*d];
+    extent[d] = bounds[2*d+1]-bounds[2*d];
+    maxExtent = std::max(maxExtent, extent[d]);
+  }
+
+  // flat bundles must not degenerate the cell size
+  double minExtent = std::max(maxExtent*0.001, 0.000001);
+  if (cellSize<=0)
+  {
+    double numCells = std::min(FIBER_INDEX_MAX_CELLS, std::max(1.0, numSegments/FIBER_INDEX_SEGMENTS_PER_CELL));
+    double volume = std::max(extent[0], minExtent)*std::max(extent[1], minExtent)*std::max(extent[2], minExtent);
+    cellSize = std::cbrt(volume/numCells);
+  }
+  m_CellSize = std::max(cellSize, minExtent);
+
+  double totalCells = 0;
+  do
+  {
+    totalCells = 1;
+    for (int d=0; d<3; ++d)
+    {
+      m_Dims[d] = static_cast<int>(std::floor(extent[d]/m_CellSize)) + 1;
+      totalCells *= m_Dims[d];
+    }
+    if (totalCells>2*FIBER_INDEX_MAX_CELLS)
+      m_CellSize *= 2;
+  }
+  while (totalCells>2*FIBER_INDEX_MAX_CELLS);
+
+  // count the segments per cell, then fill the cells
+  m_CellOffsets.assign(static_cast<size_t>(totalCells) + 1, 0);
+  for (int pass=0; pass<2; ++pass)
+  {
+    std::vector< size_t > cursor;
+    if (pass==1)
+    {
+      for (size_t c=1; c<m_CellOffsets.size(); ++c)
+        m_CellOffsets[c] += m_CellOffsets[c-1];
+      m_Segments.resize(m_CellOffsets.back());
+      cursor.assign(m_CellOffsets.begin(), m_CellOffsets.end()-1);
+    }
+
+    for (unsigned int i=0; i<fibers.GetNumFibers(); ++i)
+    {
+      if (fibers.GetNumPoints(i)<2)
+        continue;
+      for (size_t k=fibers.GetFiberOffset(i); k+1<fibers.GetFiberOffset(i+1); ++k)
+      {
+        double segmentBounds[6];
+        for (int d=0; d<3; ++d)
+        {
+          segmentBounds[2*d] = std::min(points[3*k+d], points[3*k+3+d]);
+          segmentBounds[2*d+1] = std::max(points[3*k+d], points[3*k+3+d]);
+        }
+
+        int minCell[3], maxCell[3];
+        GetCellRange(segmentBounds, minCell, maxCell);
+        for (int z=minCell[2]; z<=maxCell[2]; ++z)
+          for (int y=minCell[1]; y<=maxCell[1]; ++y)
+            for (int x=minCell[0]; x<=maxCell[0]; ++x)
+            {
+              size_t c = (static_cast<size_t>(z)*m_Dims[1] + y)*m_Dims[0] + x;
+              if (pass==0)
+                ++m_CellOffsets[c+1];
+              else
+                m_Segments[cursor[c]++] = k;
+            }
+      }
+    }
+  }
+}
+
+bool mitk::FiberSpatialIndex::GetCellRange(const double bounds[6], int minCell[3], int maxCell[3]) const
+{
+  for (int d=0; d<3; ++d)
+  {
+    if (m_Dims[d]==0 || bounds[2*d+1]<m_Origin[d] || bounds[2*d]>m_Origin[d]+m_Dims[d]*m_CellSize)
+      return false;
+    minCell[d] = std::max(0, std::min(m_Dims[d]-1, static_cast<int>(std::floor((bounds[2*d]-m_Origin[d])/m_CellSize))));
+    maxCell[d] = std::max(0, std::min(m_Dims[d]-1, static_cast<int>(std::floor((bounds[2*d+1]-m_Origin[d])/m_CellSize))));
+  }
+  return true;
+}
+
+void mitk::FiberSpatialIndex::GetSegments(const double bounds[6], std::vector< size_t >& segments) const
+{
+  segments.clear();
+  int minCell[3], maxCell[3];
+  if (!GetCellRange(bounds, minCell, maxCell))
+    return;
+
+  for (int z=minCell[2]; z<=maxCell[2]; ++z)
+    for (int y=minCell[1]; y<=maxCell[1]; ++y)
+      for (int x=minCell[0]; x<=maxCell[0]; ++x)
+      {
+        size_t c = (static_cast<size_t>(z)*m_Dims[1] + y)*m_Dims[0] + x;
+        segments.insert(segments.end(), m_Segments.begin() + m_CellOffsets[c], m_Segments.begin() + m_CellOffsets[c+1]);
+      }
+
+  // segments spanning several cells are listed more than once
+  std::sort(segments.begin(), segments.end());
+  segments.erase(std::unique(segments.begin(), segments.end()), segments.end());
+}
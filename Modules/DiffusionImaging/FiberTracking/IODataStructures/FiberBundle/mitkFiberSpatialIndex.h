@@ -0,0 +1,66 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_FiberSpatialIndex_H
+#define _MITK_FiberSpatialIndex_H
+
+#include <MitkFiberTrackingExports.h>
+#include <mitkFiberStore.h>
+#include <vector>
+
+namespace mitk {
+
+/**
+  * \brief Uniform grid over the line segments of a FiberStore.
+  *
+  * Each segment (point k to point k+1 of the same fiber, identified by the store index k of its first point) is
+  * registered in every grid cell its bounding box overlaps. GetSegments() returns all segments that may intersect
+  * a given axis aligned box, so that ROI based extraction only has to test the segments near the ROI instead of
+  * every segment of the tractogram.
+  */
+class MITKFIBERTRACKING_EXPORT FiberSpatialIndex
+{
+public:
+
+  FiberSpatialIndex();
+
+  void Clear();
+  bool IsBuilt() const { return m_Built; }
+
+  /** Builds the grid. If cellSize is not positive, it is chosen so that a cell holds a few segments on average. */
+  void Build(const FiberStore& fibers, double cellSize = -1);
+
+  /** Store indices of all segments whose bounding box overlaps bounds (xmin,xmax,ymin,ymax,zmin,zmax), sorted ascending. */
+  void GetSegments(const double bounds[6], std::vector< size_t >& segments) const;
+
+  double GetCellSize() const { return m_CellSize; }
+
+private:
+
+  /** Returns false if the box does not overlap the grid. */
+  bool GetCellRange(const double bounds[6], int minCell[3], int maxCell[3]) const;
+
+  double                m_Origin[3];
+  double                m_CellSize;
+  int                   m_Dims[3];
+  std::vector< size_t > m_CellOffsets;  ///< numCells+1 entries, segments of cell c are m_Segments[m_CellOffsets[c]] to m_Segments[m_CellOffsets[c+1]-1]
+  std::vector< size_t > m_Segments;
+  bool                  m_Built;
+};
+
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkFiberStore.h"
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <mitkLogMacros.h>
+
+mitk::FiberStore::FiberStore()
+{
+  m_Offsets.push_back(0);
+}
+
+void mitk::FiberStore::Clear()
+{
+  m_Offsets.clear();
+  m_Offsets.push_back(0);
+  m_Points.clear();
+  m_PointAttributes.clear();
+}
+
+void mitk::FiberStore::Reserve(size_t numFibers, size_t numPoints)
+{
+  m_Offsets.reserve(numFibers+1);
+  m_Points.reserve(3*numPoints);
+}
+
+void mitk::FiberStore::AddFiber(const float* points, unsigned int numPoints)
+{
+  m_Points.insert(m_Points.end(), points, points + 3*numPoints);
+  m_Offsets.push_back(m_Offsets.back() + numPoints);
+}
+
+void mitk::FiberStore::SetPointAttribute(const std::string& name, const std::vector< float >& values)
+{
+  if (values.size()!=GetNumPoints())
+  {
+    MITK_WARN << "Point attribute " << name << " has " << values.size() << " values but the store contains " << GetNumPoints() << " points. Ignoring attribute.";
+    return;
+  }
+  m_PointAttributes[name] = values;
+}
+
+const std::vector< float >* mitk::FiberStore::GetPointAttribute(const std::string& name) const
+{
+  auto it = m_PointAttributes.find(name);
+  if (it==m_PointAttributes.end())
+    return nullptr;
+  return &it->second;
+}
+
+void mitk::FiberStore::SetFromPolyData(vtkPolyData* polyData, bool copyPointAttributes)
+{
+  Clear();
+  if (polyData==nullptr || polyData->GetLines()==nullptr || polyData->GetPoints()==nullptr)
+    return;
+
+  vtkCellArray* lines = polyData->GetLines();
+  vtkPoints* points = polyData->GetPoints();
+  Reserve(static_cast<size_t>(lines->GetNumberOfCells()), static_cast<size_t>(lines->GetNumberOfConnectivityEntries() - lines->GetNumberOfCells()));
+
+  // point data arrays are resolved via the point ids of the polydata
+  std::vector< std::pair< vtkFloatArray*, std::vector< float >* > > attributes;
+  vtkPointData* pointData = polyData->GetPointData();
+  for (int a=0; copyPointAttributes && pointData!=nullptr && a<pointData->GetNumberOfArrays(); ++a)
+  {
+    vtkFloatArray* array = vtkFloatArray::SafeDownCast(pointData->GetArray(a));
+    if (array!=nullptr && array->GetName()!=nullptr && array->GetNumberOfComponents()==1)
+    {
+      std::vector< float >& values = m_PointAttributes[array->GetName()];
+      values.reserve(m_Points.capacity()/3);
+      attributes.push_back(std::make_pair(array, &values));
+    }
+  }
+
+  vtkIdType numIds = 0;
+  vtkIdType* ids = nullptr;
+  double p[3];
+  lines->InitTraversal();
+  while (lines->GetNextCell(numIds, ids))
+  {
+    for (vtkIdType j=0; j<numIds; ++j)
+    {
+      points->GetPoint(ids[j], p);
+      m_Points.push_back(static_cast<float>(p[0]));
+      m_Points.push_back(static_cast<float>(p[1]));
+      m_Points.push_back(static_cast<float>(p[2]));
+      for (auto& attribute : attributes)
+        attribute.second->push_back(attribute.first->GetValue(ids[j]));
+    }
+    m_Offsets.push_back(m_Offsets.back() + static_cast<size_t>(numIds));
+  }
+}
+
+vtkSmartPointer<vtkPolyData> mitk::FiberStore::GeneratePolyData() const
+{
+  vtkSmartPointer<vtkFloatArray> coordinates = vtkSmartPointer<vtkFloatArray>::New();
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetNumberOfTuples(static_cast<vtkIdType>(GetNumPoints()));
+  std::copy(m_Points.begin(), m_Points.end(), coordinates->GetPointer(0));
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetData(coordinates);
+
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  lines->Allocate(static_cast<vtkIdType>(GetNumFibers() + GetNumPoints()));
+  for (unsigned int i=0; i<GetNumFibers(); ++i)
+  {
+    lines->InsertNextCell(static_cast<int>(GetNumPoints(i)));
+    for (size_t j=m_Offsets[i]; j<m_Offsets[i+1]; ++j)
+      lines->InsertCellPoint(static_cast<vtkIdType>(j));
+  }
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetLines(lines);
+
+  for (auto& attribute : m_PointAttributes)
+  {
+    vtkSmartPointer<vtkFloatArray> array = vtkSmartPointer<vtkFloatArray>::New();
+    array->SetName(attribute.first.c_str());
+    array->SetNumberOfValues(static_cast<vtkIdType>(attribute.second.size()));
+    std::copy(attribute.second.begin(), attribute.second.end(), array->GetPointer(0));
+    polyData->GetPointData()->AddArray(array);
+  }
+
+  return polyData;
+}
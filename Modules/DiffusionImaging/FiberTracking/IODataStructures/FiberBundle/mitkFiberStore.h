@@ -0,0 +1,100 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_FiberStore_H
+#define _MITK_FiberStore_H
+
+#include <MitkFiberTrackingExports.h>
+#include <itkPoint.h>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mitk {
+
+/**
+  * \brief Contiguous structure-of-arrays representation of a set of fibers.
+  *
+  * All points of all fibers are stored in one float array (x,y,z interleaved). Fiber i consists of the points
+  * GetFiberOffset(i) to GetFiberOffset(i+1)-1. Optional per-point attributes are stored as additional float arrays
+  * with one value per point. Iterating over this structure avoids the vtkCell lookups (and point copies) of
+  * vtkPolyData::GetCell(), which dominate fiber processing on large tractograms.
+  */
+class MITKFIBERTRACKING_EXPORT FiberStore
+{
+public:
+
+  typedef std::map< std::string, std::vector< float > > AttributeMapType;
+
+  FiberStore();
+
+  void Clear();
+  void Reserve(size_t numFibers, size_t numPoints);
+
+  /** Appends a fiber consisting of numPoints points (x,y,z interleaved). */
+  void AddFiber(const float* points, unsigned int numPoints);
+
+  unsigned int GetNumFibers() const { return static_cast<unsigned int>(m_Offsets.size()-1); }
+  size_t GetNumPoints() const { return m_Points.size()/3; }
+  unsigned int GetNumPoints(unsigned int fiber) const { return static_cast<unsigned int>(m_Offsets[fiber+1]-m_Offsets[fiber]); }
+  size_t GetFiberOffset(unsigned int fiber) const { return m_Offsets[fiber]; }
+
+  /** Pointer to the x,y,z coordinates of point j of the given fiber. */
+  const float* GetPoint(unsigned int fiber, unsigned int j) const { return &m_Points[3*(m_Offsets[fiber]+j)]; }
+  float* GetPoint(unsigned int fiber, unsigned int j) { return &m_Points[3*(m_Offsets[fiber]+j)]; }
+
+  /** All points of all fibers (x,y,z interleaved), point k of the store starts at GetPoints()[3*k]. */
+  const float* GetPoints() const { return m_Points.data(); }
+
+  /** Index of the fiber containing point k of the store. */
+  unsigned int GetFiberOfPoint(size_t k) const
+  {
+    return static_cast<unsigned int>(std::upper_bound(m_Offsets.begin(), m_Offsets.end(), k) - m_Offsets.begin() - 1);
+  }
+
+  itk::Point<float, 3> GetItkPoint(unsigned int fiber, unsigned int j) const
+  {
+    const float* p = GetPoint(fiber, j);
+    itk::Point<float, 3> itkPoint;
+    itkPoint[0] = p[0];
+    itkPoint[1] = p[1];
+    itkPoint[2] = p[2];
+    return itkPoint;
+  }
+
+  /** Per-point attribute arrays (one value per point, same order as the points). */
+  void SetPointAttribute(const std::string& name, const std::vector< float >& values);
+  const std::vector< float >* GetPointAttribute(const std::string& name) const;
+
+  /** Copies the lines and, if requested, the point data scalars (single component float arrays) of the given polydata. */
+  void SetFromPolyData(vtkPolyData* polyData, bool copyPointAttributes = true);
+
+  /** Materializes the fibers (and point attributes) as vtkPolyData with one polyline per fiber. */
+  vtkSmartPointer<vtkPolyData> GeneratePolyData() const;
+
+private:
+
+  std::vector< size_t >   m_Offsets;  ///< numFibers+1 entries, m_Offsets[0]==0
+  std::vector< float >    m_Points;   ///< 3*numPoints entries
+  AttributeMapType        m_PointAttributes;
+};
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkFiberStreamReader.h"
+
+#include <mitkTrackvis.h>
+#include <mitkExceptionMacro.h>
+#include <mitkLexicalCast.h>
+#include <itksys/SystemTools.hxx>
+#include <vtkMatrix4x4.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+static const size_t FIBER_STREAM_BLOCK_SIZE = 4*1024*1024;
+
+mitk::FiberStreamReader::FiberStreamReader()
+  : m_FilePointer(nullptr)
+  , m_Format(TCK)
+  , m_DataOffset(0)
+  , m_NumFibersInHeader(-1)
+  , m_NumFibersRead(0)
+  , m_EndOfData(true)
+  , m_NumScalars(0)
+  , m_NumProperties(0)
+  , m_BlockPos(0)
+  , m_BlockSize(0)
+{
+  m_Flip[0] = m_Flip[1] = m_Flip[2] = 1;
+}
+
+mitk::FiberStreamReader::~FiberStreamReader()
+{
+  Close();
+}
+
+void mitk::FiberStreamReader::Open(const std::string& filename)
+{
+  Close();
+
+  std::string ext = itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(filename));
+  if (ext==".tck")
+    m_Format = TCK;
+  else if (ext==".trk")
+    m_Format = TRK;
+  else
+    mitkThrow() << "Unsupported tractogram format for streaming: " << filename;
+
+  m_FilePointer = std::fopen(filename.c_str(), "rb");
+  if (m_FilePointer==nullptr)
+    mitkThrow() << "Unable to open file " << filename;
+  m_FileName = filename;
+  m_NumFibersInHeader = -1;
+  m_ReferenceGeometry = nullptr;
+  m_Flip[0] = m_Flip[1] = m_Flip[2] = 1;
+
+  try
+  {
+    if (m_Format==TCK)
+      ReadTckHeader();
+    else
+      ReadTrkHeader();
+  }
+  catch(...)
+  {
+    Close();
+    throw;
+  }
+
+  m_Block.resize(FIBER_STREAM_BLOCK_SIZE);
+  Rewind();
+}
+
+void mitk::FiberStreamReader::Close()
+{
+  if (m_FilePointer!=nullptr)
+    std::fclose(m_FilePointer);
+  m_FilePointer = nullptr;
+  m_EndOfData = true;
+  m_BlockPos = 0;
+  m_BlockSize = 0;
+}
+
+void mitk::FiberStreamReader::Rewind()
+{
+  if (m_FilePointer==nullptr)
+    mitkThrow() << "No tractogram opened.";
+  std::fseek(m_FilePointer, m_DataOffset, SEEK_SET);
+  m_BlockPos = 0;
+  m_BlockSize = 0;
+  m_NumFibersRead = 0;
+  m_EndOfData = false;
+}
+
+void mitk::FiberStreamReader::ReadTckHeader()
+{
+  std::string header = "";
+  char c;
+  while (header.size()<3 || header.compare(header.size() - 3, 3, "END") != 0)
+  {
+    if (std::fread(&c, 1, 1, m_FilePointer)!=1)
+      mitkThrow() << "Unexpected end of file while reading the header of " << m_FileName;
+    header += c;
+  }
+
+  m_DataOffset = -1;
+  std::istringstream stream(header);
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    size_t pos = line.find(':');
+    if (pos==std::string::npos)
+      continue;
+    std::string key = line.substr(0, pos);
+    std::string value = line.substr(pos+1);
+    value.erase(0, value.find_first_not_of(" \t"));
+    value.erase(value.find_last_not_of(" \t\r") + 1);
+
+    try
+    {
+      if (key=="file" && value.compare(0, 2, ". ")==0)
+        m_DataOffset = boost::lexical_cast<long>(value.substr(2));
+      else if (key=="count")
+        m_NumFibersInHeader = boost::lexical_cast<long>(value);
+      else if (key=="datatype" && value!="Float32LE")
+        mitkThrow() << "Unsupported tck datatype " << value << " in " << m_FileName;
+    }
+    catch(const boost::bad_lexical_cast&)
+    {
+    }
+  }
+
+  if (m_DataOffset<0)
+    mitkThrow() << "Could not parse header size from " << m_FileName;
+
+  // transform from RAS (MRtrix) to LPS (MITK)
+  m_Flip[0] = -1;
+  m_Flip[1] = -1;
+}
+
+void mitk::FiberStreamReader::ReadTrkHeader()
+{
+  TrackVis_header header;
+  if (std::fread((char*)(&header), 1, 1000, m_FilePointer)!=1000 || std::strncmp(header.id_string, "TRACK", 5)!=0)
+    mitkThrow() << "Invalid TrackVis header in " << m_FileName;
+  if (header.hdr_size!=1000)
+    mitkThrow() << "Unsupported TrackVis header size (byte swapped file?) in " << m_FileName;
+
+  m_DataOffset = 1000;
+  m_NumScalars = header.n_scalars;
+  m_NumProperties = header.n_properties;
+  if (header.n_count>0)
+    m_NumFibersInHeader = header.n_count;
+
+  if (header.voxel_order[0]=='R')
+    m_Flip[0] = -1;
+  if (header.voxel_order[1]=='A')
+    m_Flip[1] = -1;
+  if (header.voxel_order[2]=='I')
+    m_Flip[2] = -1;
+
+  if (header.voxel_size[0]>0 && header.voxel_size[1]>0 && header.voxel_size[2]>0 && header.dim[0]>0 && header.dim[1]>0 && header.dim[2]>0)
+  {
+    mitk::Geometry3D::Pointer geometry = mitk::Geometry3D::New();
+    vtkSmartPointer< vtkMatrix4x4 > matrix = vtkSmartPointer< vtkMatrix4x4 >::New();
+    matrix->Identity();
+    for (int i=0; i<3; ++i)
+      matrix->SetElement(i, i, m_Flip[i]);
+    geometry->SetIndexToWorldTransformByVtkMatrix(matrix);
+
+    mitk::Point3D origin;
+    mitk::Vector3D spacing;
+    for (int i=0; i<3; ++i)
+    {
+      origin[i] = header.origin[i];
+      spacing[i] = header.voxel_size[i];
+    }
+    geometry->SetOrigin(origin);
+    geometry->SetSpacing(spacing);
+    for (int i=0; i<3; ++i)
+      geometry->SetExtentInMM(i, header.voxel_size[i]*header.dim[i]);
+    m_ReferenceGeometry = geometry;
+  }
+}
+
+bool mitk::FiberStreamReader::ReadBytes(void* data, size_t numBytes)
+{
+  char* out = static_cast<char*>(data);
+  while (numBytes>0)
+  {
+    if (m_BlockPos==m_BlockSize)
+    {
+      m_BlockPos = 0;
+      m_BlockSize = std::fread(m_Block.data(), 1, m_Block.size(), m_FilePointer);
+      if (m_BlockSize==0)
+        return false;
+    }
+    size_t n = std::min(numBytes, m_BlockSize-m_BlockPos);
+    std::memcpy(out, &m_Block[m_BlockPos], n);
+    m_BlockPos += n;
+    out += n;
+    numBytes -= n;
+  }
+  return true;
+}
+
+bool mitk::FiberStreamReader::ReadTckFiber(std::vector< float >& points)
+{
+  points.clear();
+  float p[3];
+  while (ReadBytes(p, 12))
+  {
+    if (std::isinf(p[0]) || std::isinf(p[1]) || std::isinf(p[2]))
+      break;
+    if (std::isnan(p[0]) || std::isnan(p[1]) || std::isnan(p[2]))
+      return true;
+    points.push_back(m_Flip[0]*p[0]);
+    points.push_back(m_Flip[1]*p[1]);
+    points.push_back(m_Flip[2]*p[2]);
+  }
+
+  // end of data, an unterminated fiber is discarded
+  m_EndOfData = true;
+  return false;
+}
+
+bool mitk::FiberStreamReader::ReadTrkFiber(std::vector< float >& points)
+{
+  points.clear();
+  int numPoints = 0;
+  if (!ReadBytes(&numPoints, 4))
+  {
+    m_EndOfData = true;
+    return false;
+  }
+  if (numPoints<=0)
+    mitkThrow() << "Trying to read a fiber with " << numPoints << " points from " << m_FileName;
+
+  const size_t pointSize = 3 + static_cast<size_t>(m_NumScalars);
+  m_FiberBuffer.resize(pointSize*numPoints + m_NumProperties);
+  if (!ReadBytes(m_FiberBuffer.data(), 4*m_FiberBuffer.size()))
+  {
+    m_EndOfData = true;
+    return false;
+  }
+
+  points.resize(3*numPoints);
+  for (int i=0; i<numPoints; ++i)
+    for (int d=0; d<3; ++d)
+      points[3*i+d] = m_Flip[d]*m_FiberBuffer[pointSize*i+d];
+  return true;
+}
+
+bool mitk::FiberStreamReader::ReadChunk(FiberStore& chunk, unsigned int maxFibers)
+{
+  chunk.Clear();
+  std::vector< float > points;
+  while (!m_EndOfData && chunk.GetNumFibers()<maxFibers)
+  {
+    bool valid = m_Format==TCK ? ReadTckFiber(points) : ReadTrkFiber(points);
+    if (!valid)
+      break;
+    chunk.AddFiber(points.data(), static_cast<unsigned int>(points.size()/3));
+    ++m_NumFibersRead;
+  }
+  return chunk.GetNumFibers()>0;
+}
+
+void mitk::FiberStreamReader::ReadAll(FiberStore& fibers)
+{
+  if (m_NumFibersInHeader>0)
+    fibers.Reserve(fibers.GetNumFibers() + m_NumFibersInHeader, 0);
+
+  std::vector< float > points;
+  while (!m_EndOfData)
+  {
+    bool valid = m_Format==TCK ? ReadTckFiber(points) : ReadTrkFiber(points);
+    if (!valid)
+      break;
+    fibers.AddFiber(points.data(), static_cast<unsigned int>(points.size()/3));
+    ++m_NumFibersRead;
+  }
+}
+
+unsigned long mitk::FiberStreamReader::ForEachChunk(unsigned int chunkSize, const ChunkCallbackType& callback)
+{
+  unsigned long numFibers = 0;
+  FiberStore chunk;
+  while (ReadChunk(chunk, chunkSize))
+  {
+    numFibers += chunk.GetNumFibers();
+    callback(chunk);
+  }
+  return numFibers;
+}
@@ -0,0 +1,119 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_FiberStreamReader_H
+#define _MITK_FiberStreamReader_H
+
+#include <MitkFiberTrackingExports.h>
+#include <mitkFiberStore.h>
+#include <mitkGeometry3D.h>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mitk {
+
+/**
+  * \brief Sequential reader for tractograms in MRtrix (.tck) and TrackVis (.trk) format.
+  *
+  * In contrast to FiberBundleTckReader and FiberBundleTrackVisReader, the fibers are not converted to vtkPolyData at
+  * once but read chunk by chunk into a FiberStore. Only one chunk is held in memory, so tractograms that are larger
+  * than the available memory can be processed:
+  *
+  * \code
+  * mitk::FiberStreamReader reader;
+  * reader.Open("tracts.tck");
+  * reader.ForEachChunk(100000, [&](const mitk::FiberStore& chunk){ ... });
+  * \endcode
+  *
+  * The coordinates are converted to the MITK world coordinate system in the same way the file readers do it (RAS to
+  * LPS for .tck files, flips according to the voxel order for .trk files). All methods throw a mitk::Exception if
+  * the file cannot be read.
+  */
+class MITKFIBERTRACKING_EXPORT FiberStreamReader
+{
+public:
+
+  typedef std::function< void(const FiberStore&) > ChunkCallbackType;
+
+  FiberStreamReader();
+  ~FiberStreamReader();
+
+  FiberStreamReader(const FiberStreamReader&) = delete;
+  FiberStreamReader& operator=(const FiberStreamReader&) = delete;
+
+  /** Opens the file and parses the header. The file type is determined by the extension. */
+  void Open(const std::string& filename);
+  void Close();
+  bool IsOpen() const { return m_FilePointer!=nullptr; }
+
+  /** Restarts reading at the first fiber. */
+  void Rewind();
+
+  /** Replaces the content of chunk with the next (at most maxFibers) fibers. Returns false if no fiber was left. */
+  bool ReadChunk(FiberStore& chunk, unsigned int maxFibers);
+
+  /** Appends all remaining fibers to the given store. */
+  void ReadAll(FiberStore& fibers);
+
+  /** Calls the callback for each chunk of at most chunkSize fibers. Returns the number of fibers read. */
+  unsigned long ForEachChunk(unsigned int chunkSize, const ChunkCallbackType& callback);
+
+  /** Number of fibers stated in the file header or -1 if the header does not contain this information. */
+  long GetNumFibersInHeader() const { return m_NumFibersInHeader; }
+  unsigned long GetNumFibersRead() const { return m_NumFibersRead; }
+
+  /** Image geometry stored in the header of .trk files (nullptr for .tck files or invalid headers). */
+  mitk::Geometry3D::Pointer GetReferenceGeometry() const { return m_ReferenceGeometry; }
+
+private:
+
+  enum FORMAT
+  {
+    TCK,
+    TRK
+  };
+
+  void ReadTckHeader();
+  void ReadTrkHeader();
+  bool ReadTckFiber(std::vector< float >& points);
+  bool ReadTrkFiber(std::vector< float >& points);
+
+  /** Reads from the internal block buffer, refilled from the file if necessary. */
+  bool ReadBytes(void* data, size_t numBytes);
+
+  std::string                 m_FileName;
+  std::FILE*                  m_FilePointer;
+  FORMAT                      m_Format;
+  long                        m_DataOffset;
+  long                        m_NumFibersInHeader;
+  unsigned long               m_NumFibersRead;
+  bool                        m_EndOfData;
+  float                       m_Flip[3];
+  int                         m_NumScalars;
+  int                         m_NumProperties;
+  mitk::Geometry3D::Pointer   m_ReferenceGeometry;
+
+  std::vector< char >         m_Block;
+  size_t                      m_BlockPos;
+  size_t                      m_BlockSize;
+  std::vector< float >        m_FiberBuffer;
+};
+
+}
+
+#endif
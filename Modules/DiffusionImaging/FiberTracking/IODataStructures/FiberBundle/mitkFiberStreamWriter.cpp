@@ -0,0 +1,151 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkFiberStreamWriter.h"
+
+#include <mitkTrackvis.h>
+#include <mitkExceptionMacro.h>
+#include <itkMutexLockHolder.h>
+#include <itksys/SystemTools.hxx>
+#include <limits>
+
+// the header is padded to a fixed size so that the count can be updated in place
+static const long TCK_DATA_OFFSET = 1024;
+
+mitk::FiberStreamWriter::FiberStreamWriter()
+  : m_Format(TCK)
+  , m_FilePointer(nullptr)
+  , m_CountPosition(0)
+  , m_NumFibersWritten(0)
+{
+  m_Flip[0] = m_Flip[1] = m_Flip[2] = 1;
+}
+
+mitk::FiberStreamWriter::~FiberStreamWriter()
+{
+  Close();
+}
+
+bool mitk::FiberStreamWriter::IsOpen() const
+{
+  return m_FilePointer!=nullptr || m_TrackVisFile!=nullptr;
+}
+
+void mitk::FiberStreamWriter::Open(const std::string& filename, const mitk::BaseGeometry* referenceGeometry, bool lps)
+{
+  Close();
+
+  std::string ext = itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(filename));
+  m_FileName = filename;
+  m_NumFibersWritten = 0;
+
+  if (ext==".trk")
+  {
+    if (referenceGeometry==nullptr)
+      mitkThrow() << "A reference geometry is required to write " << filename;
+    m_Format = TRK;
+    m_TrackVisFile.reset(new TrackVisFiberReader());
+    if (m_TrackVisFile->create(filename, referenceGeometry, lps)==0)
+    {
+      m_TrackVisFile.reset();
+      mitkThrow() << "Unable to create file " << filename;
+    }
+    // the TrackVis reader flips the coordinates according to the voxel order
+    m_Flip[0] = m_Flip[1] = lps ? 1 : -1;
+    m_Flip[2] = 1;
+  }
+  else if (ext==".tck")
+  {
+    m_Format = TCK;
+    m_FilePointer = std::fopen(filename.c_str(), "w+b");
+    if (m_FilePointer==nullptr)
+      mitkThrow() << "Unable to create file " << filename;
+
+    std::string header = "mrtrix tracks\ndatatype: Float32LE\ncount: ";
+    m_CountPosition = static_cast<long>(header.size());
+    header += "0000000000\nfile: . " + std::to_string(TCK_DATA_OFFSET) + "\nEND\n";
+    header.resize(TCK_DATA_OFFSET, '\0');
+    if (std::fwrite(header.data(), 1, header.size(), m_FilePointer)!=header.size())
+    {
+      Close();
+      mitkThrow() << "Unable to write header to " << filename;
+    }
+    // transform from LPS (MITK) to RAS (MRtrix)
+    m_Flip[0] = m_Flip[1] = -1;
+    m_Flip[2] = 1;
+  }
+  else
+    mitkThrow() << "Unsupported tractogram format for streaming: " << filename;
+}
+
+void mitk::FiberStreamWriter::WriteFiber(const float* points, unsigned int numPoints)
+{
+  if (numPoints==0)
+    return;
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  if (!IsOpen())
+    mitkThrow() << "No tractogram opened for writing.";
+
+  m_Buffer.resize(3*numPoints);
+  for (unsigned int i=0; i<numPoints; ++i)
+    for (int d=0; d<3; ++d)
+      m_Buffer[3*i + d] = m_Flip[d]*points[3*i + d];
+
+  if (m_Format==TRK)
+  {
+    if (m_TrackVisFile->append(m_Buffer.data(), numPoints)!=0)
+      mitkThrow() << "Unable to write fiber to " << m_FileName;
+  }
+  else
+  {
+    m_Buffer.push_back(std::numeric_limits<float>::quiet_NaN());
+    m_Buffer.push_back(std::numeric_limits<float>::quiet_NaN());
+    m_Buffer.push_back(std::numeric_limits<float>::quiet_NaN());
+    if (std::fwrite(m_Buffer.data(), sizeof(float), m_Buffer.size(), m_FilePointer)!=m_Buffer.size())
+      mitkThrow() << "Unable to write fiber to " << m_FileName;
+  }
+  ++m_NumFibersWritten;
+}
+
+void mitk::FiberStreamWriter::WriteFibers(const FiberStore& fibers)
+{
+  for (unsigned int i=0; i<fibers.GetNumFibers(); ++i)
+    if (fibers.GetNumPoints(i)>0)
+      WriteFiber(fibers.GetPoint(i, 0), fibers.GetNumPoints(i));
+}
+
+void mitk::FiberStreamWriter::Close()
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  if (m_TrackVisFile!=nullptr)
+  {
+    m_TrackVisFile->updateTotal(static_cast<int>(m_NumFibersWritten));
+    m_TrackVisFile->close();
+    m_TrackVisFile.reset();
+  }
+  if (m_FilePointer!=nullptr)
+  {
+    float end[3] = { std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() };
+    std::fwrite(end, sizeof(float), 3, m_FilePointer);
+    std::string count = std::to_string(m_NumFibersWritten);
+    count.insert(0, count.size()<10 ? 10-count.size() : 0, '0');
+    std::fseek(m_FilePointer, m_CountPosition, SEEK_SET);
+    std::fwrite(count.data(), 1, count.size(), m_FilePointer);
+    std::fclose(m_FilePointer);
+    m_FilePointer = nullptr;
+  }
+}
@@ -0,0 +1,82 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_FiberStreamWriter_H
+#define _MITK_FiberStreamWriter_H
+
+#include <MitkFiberTrackingExports.h>
+#include <mitkFiberStore.h>
+#include <mitkBaseGeometry.h>
+#include <itkSimpleFastMutexLock.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+class TrackVisFiberReader;
+
+namespace mitk {
+
+/**
+  * \brief Writes fibers to a MRtrix (.tck) or TrackVis (.trk) file as they are produced.
+  *
+  * The header is written on Open(), fibers are appended with WriteFiber()/WriteFibers() and the fiber count in the
+  * header is updated on Close(). WriteFiber() may be called concurrently from several threads (e.g. the tracking
+  * threads of StreamlineTrackingFilter); the fibers are written in the order in which the calls acquire the lock.
+  * Coordinates are expected in MITK world coordinates (LPS) and are converted to RAS for .tck files.
+  */
+class MITKFIBERTRACKING_EXPORT FiberStreamWriter
+{
+public:
+
+  FiberStreamWriter();
+  ~FiberStreamWriter();
+
+  FiberStreamWriter(const FiberStreamWriter&) = delete;
+  FiberStreamWriter& operator=(const FiberStreamWriter&) = delete;
+
+  /** Creates the file. The geometry is stored in the header of .trk files and is required for this format. */
+  void Open(const std::string& filename, const mitk::BaseGeometry* referenceGeometry = nullptr, bool lps = true);
+  void Close();
+  bool IsOpen() const;
+
+  /** Appends one fiber consisting of numPoints points (x,y,z interleaved). Thread safe. */
+  void WriteFiber(const float* points, unsigned int numPoints);
+  void WriteFibers(const FiberStore& fibers);
+
+  unsigned long GetNumFibersWritten() const { return m_NumFibersWritten; }
+
+private:
+
+  enum FORMAT
+  {
+    TCK,
+    TRK
+  };
+
+  std::string                             m_FileName;
+  FORMAT                                  m_Format;
+  std::FILE*                              m_FilePointer;      ///< .tck only
+  long                                    m_CountPosition;    ///< .tck only, file position of the count field
+  std::unique_ptr< TrackVisFiberReader >  m_TrackVisFile;     ///< .trk only
+  unsigned long                           m_NumFibersWritten;
+  float                                   m_Flip[3];
+  std::vector< float >                    m_Buffer;
+  itk::SimpleFastMutexLock                m_Mutex;
+};
+
+}
+
+#endif
@@ -9,22 +9,20 @@ TrackVisFiberReader::~TrackVisFiberReader() { if (m_FilePointer) fclose( m_FileP
 // Create a TrackVis file and store standard metadata. The file is ready to append fibers.
 // ---------------------------------------------------------------------------------------
 short TrackVisFiberReader::create(std::string filename , const mitk::FiberBundle *fib, bool lps)
+{
+  if (fib->GetReferenceGeometry().IsNotNull())
+    return create(filename, fib->GetReferenceGeometry().GetPointer(), lps);
+  return create(filename, fib->GetGeometry(), lps);
+}
+
+short TrackVisFiberReader::create(std::string filename , const mitk::BaseGeometry *geometry, bool lps)
 {
   // prepare the header
   for(int i=0; i<3 ;i++)
   {
-    if (fib->GetReferenceGeometry().IsNotNull())
-    {
-      m_Header.dim[i]            = fib->GetReferenceGeometry()->GetExtent(i);
-      m_Header.voxel_size[i]     = fib->GetReferenceGeometry()->GetSpacing()[i];
-      m_Header.origin[i]         = fib->GetReferenceGeometry()->GetOrigin()[i];
-    }
-    else
-    {
-      m_Header.dim[i]            = fib->GetGeometry()->GetExtent(i);
-      m_Header.voxel_size[i]     = fib->GetGeometry()->GetSpacing()[i];
-      m_Header.origin[i]         = fib->GetGeometry()->GetOrigin()[i];
-    }
+    m_Header.dim[i]            = geometry->GetExtent(i);
+    m_Header.voxel_size[i]     = geometry->GetSpacing()[i];
+    m_Header.origin[i]         = geometry->GetOrigin()[i];
   }
   m_Header.n_scalars = 0;
   m_Header.n_properties = 0;
@@ -87,43 +85,37 @@ short TrackVisFiberReader::open( std::string filename )
 
 
 
-// Append a fiber to the file
-// --------------------------
+// Append the fibers of a bundle to the file
+// -----------------------------------------
 short TrackVisFiberReader::append(const mitk::FiberBundle *fib)
 {
-  vtkPolyData* poly = fib->GetFiberPolyData();
-  for (unsigned int i=0; i<fib->GetNumFibers(); i++)
+  std::shared_ptr<const mitk::FiberStore> fiberStore = fib->GetFiberStore();
+  const mitk::FiberStore& fibers = *fiberStore;
+  for (unsigned int i=0; i<fibers.GetNumFibers(); i++)
   {
-    vtkCell* cell = poly->GetCell(i);
-    int numPoints = cell->GetNumberOfPoints();
-    vtkPoints* points = cell->GetPoints();
-
-    unsigned int     numSaved, pos = 0;
-    //float* tmp = new float[3*maxSteps];
-    std::vector< float > tmp;
-    tmp.reserve(3*numPoints);
-
-    numSaved = numPoints;
-    for(unsigned int i=0; i<numSaved ;i++)
-    {
-      double* p = points->GetPoint(i);
+    if (fibers.GetNumPoints(i)==0)
+      continue;
+    if (append(fibers.GetPoint(i, 0), fibers.GetNumPoints(i))!=0)
+      return 1;
+  }
 
-      tmp[pos++] = p[0];
-      tmp[pos++] = p[1];
-      tmp[pos++] = p[2];
-    }
+  return 0;
+}
 
-    // write the coordinates to the file
-    if ( fwrite((char*)&numSaved, 1, 4, m_FilePointer) != 4 )
-    {
-      printf( "[ERROR] Problems saving the fiber!\n" );
-      return 1;
-    }
-    if ( fwrite((char*)&(tmp.front()), 1, 4*pos, m_FilePointer) != 4*pos )
-    {
-      printf( "[ERROR] Problems saving the fiber!\n" );
-      return 1;
-    }
+// Append a single fiber (x,y,z interleaved) to the file
+// -----------------------------------------------------
+short TrackVisFiberReader::append(const float* points, unsigned int numPoints)
+{
+  // write the coordinates to the file
+  if ( fwrite((char*)&numPoints, 1, 4, m_FilePointer) != 4 )
+  {
+    printf( "[ERROR] Problems saving the fiber!\n" );
+    return 1;
+  }
+  if ( fwrite((const char*)points, 1, 12*numPoints, m_FilePointer) != 12*numPoints )
+  {
+    printf( "[ERROR] Problems saving the fiber!\n" );
+    return 1;
   }
 
   return 0;
@@ -65,9 +65,11 @@ public:
     TrackVis_header     m_Header;
 
     short   create(std::string m_Filename, const mitk::FiberBundle* fib, bool lps);
+    short   create(std::string m_Filename, const mitk::BaseGeometry* geometry, bool lps);
     short   open(std::string m_Filename );
     short   read( mitk::FiberBundle* fib );
     short   append(const mitk::FiberBundle* fib );
+    short   append(const float* points, unsigned int numPoints );
     void    writeHdr();
     void    updateTotal( int totFibers );
     void    close();
@@ -1,5 +1,8 @@
 SET(MODULE_CUSTOM_TESTS
   mitkFiberBundleReaderWriterTest.cpp
+  mitkFiberStreamReaderWriterTest.cpp
+  mitkFiberSpatialIndexTest.cpp
+  mitkTractDensityImageFilterTest.cpp
   mitkGibbsTrackingTest.cpp
   mitkStreamlineTractographyTest.cpp
   mitkFiberTransformationTest.cpp
@@ -0,0 +1,193 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+#include <mitkFiberStore.h>
+#include <mitkFiberSpatialIndex.h>
+#include <algorithm>
+#include <random>
+#include <set>
+
+class mitkFiberSpatialIndexTestSuite : public mitk::TestFixture
+{
+
+  CPPUNIT_TEST_SUITE(mitkFiberSpatialIndexTestSuite);
+  MITK_TEST(GetSegments_DefaultCellSize_EqualsBruteForce);
+  MITK_TEST(GetSegments_SmallCells_EqualsBruteForce);
+  MITK_TEST(GetSegments_FlatBundle_EqualsBruteForce);
+  MITK_TEST(GetSegments_OutsideBundle_Empty);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  /** Members used inside the different (sub-)tests. All members are initialized via setUp().*/
+  mitk::FiberStore m_Fibers;
+  std::mt19937 m_Random;
+
+  /** Random walk fibers with 1 to 30 points inside roughly [0,100]^3 (z is scaled by zScale). */
+  void GenerateFibers(unsigned int numFibers, float zScale)
+  {
+    std::uniform_real_distribution<float> position(0, 100);
+    std::uniform_real_distribution<float> step(-3, 3);
+    std::uniform_int_distribution<unsigned int> length(1, 30);
+
+    m_Fibers.Clear();
+    for (unsigned int i=0; i<numFibers; ++i)
+    {
+      std::vector< float > points;
+      float p[3] = { position(m_Random), position(m_Random), zScale*position(m_Random) };
+      unsigned int numPoints = length(m_Random);
+      for (unsigned int j=0; j<numPoints; ++j)
+      {
+        points.insert(points.end(), p, p+3);
+        p[0] += step(m_Random);
+        p[1] += step(m_Random);
+        p[2] += zScale*step(m_Random);
+      }
+      m_Fibers.AddFiber(points.data(), numPoints);
+    }
+  }
+
+  /** Fibers with a segment whose bounding box overlaps the query box, found by testing every segment. */
+  std::set< unsigned int > BruteForceFibers(const double bounds[6])
+  {
+    std::set< unsigned int > result;
+    for (unsigned int i=0; i<m_Fibers.GetNumFibers(); ++i)
+      for (unsigned int j=0; j+1<m_Fibers.GetNumPoints(i); ++j)
+        if (SegmentOverlaps(m_Fibers.GetFiberOffset(i)+j, bounds))
+        {
+          result.insert(i);
+          break;
+        }
+    return result;
+  }
+
+  /** Same query through the index. The index may return additional segments of the touched cells, which are
+   * removed by the same exact test the ROI extraction applies. */
+  std::set< unsigned int > IndexFibers(const mitk::FiberSpatialIndex& index, const double bounds[6])
+  {
+    std::vector< size_t > segments;
+    index.GetSegments(bounds, segments);
+    CPPUNIT_ASSERT_MESSAGE("Segments are sorted and unique", std::adjacent_find(segments.begin(), segments.end(), std::greater_equal<size_t>())==segments.end());
+
+    std::set< unsigned int > result;
+    for (size_t k : segments)
+    {
+      unsigned int fiber = m_Fibers.GetFiberOfPoint(k);
+      CPPUNIT_ASSERT_MESSAGE("Segment is within its fiber", k+1 < m_Fibers.GetFiberOffset(fiber+1));
+      if (SegmentOverlaps(k, bounds))
+        result.insert(fiber);
+    }
+    return result;
+  }
+
+  bool SegmentOverlaps(size_t k, const double bounds[6])
+  {
+    const float* points = m_Fibers.GetPoints();
+    for (int d=0; d<3; ++d)
+    {
+      double segmentMin = std::min(points[3*k+d], points[3*k+3+d]);
+      double segmentMax = std::max(points[3*k+d], points[3*k+3+d]);
+      if (segmentMax<bounds[2*d] || segmentMin>bounds[2*d+1])
+        return false;
+    }
+    return true;
+  }
+
+  void CompareQueries(const mitk::FiberSpatialIndex& index, float zScale)
+  {
+    std::uniform_real_distribution<double> center(-10, 110);
+    std::uniform_real_distribution<double> size(0, 25);
+    for (int q=0; q<200; ++q)
+    {
+      double bounds[6];
+      for (int d=0; d<3; ++d)
+      {
+        double scale = d==2 ? zScale : 1;
+        double c = scale*center(m_Random);
+        double s = scale*size(m_Random);
+        bounds[2*d] = c - s;
+        bounds[2*d+1] = c + s;
+      }
+      std::set< unsigned int > expected = BruteForceFibers(bounds);
+      std::set< unsigned int > actual = IndexFibers(index, bounds);
+      CPPUNIT_ASSERT_MESSAGE("Index query returns the fibers of the brute force search", expected==actual);
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Random.seed(42);
+    m_Fibers.Clear();
+  }
+
+  void tearDown() override
+  {
+    m_Fibers.Clear();
+  }
+
+  void GetSegments_DefaultCellSize_EqualsBruteForce()
+  {
+    GenerateFibers(500, 1);
+    mitk::FiberSpatialIndex index;
+    index.Build(m_Fibers);
+    CPPUNIT_ASSERT(index.IsBuilt());
+    CompareQueries(index, 1);
+  }
+
+  void GetSegments_SmallCells_EqualsBruteForce()
+  {
+    // cells smaller than the segments, so that most segments are registered in several cells
+    GenerateFibers(200, 1);
+    mitk::FiberSpatialIndex index;
+    index.Build(m_Fibers, 2);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2, index.GetCellSize(), 0.000001);
+    CompareQueries(index, 1);
+  }
+
+  void GetSegments_FlatBundle_EqualsBruteForce()
+  {
+    GenerateFibers(300, 0);
+    mitk::FiberSpatialIndex index;
+    index.Build(m_Fibers);
+    CompareQueries(index, 0);
+  }
+
+  void GetSegments_OutsideBundle_Empty()
+  {
+    GenerateFibers(100, 1);
+    mitk::FiberSpatialIndex index;
+    index.Build(m_Fibers);
+
+    double bounds[6] = { 500, 510, 500, 510, 500, 510 };
+    std::vector< size_t > segments;
+    index.GetSegments(bounds, segments);
+    CPPUNIT_ASSERT(segments.empty());
+
+    // an empty store gives an empty index
+    m_Fibers.Clear();
+    index.Build(m_Fibers);
+    double all[6] = { -1000, 1000, -1000, 1000, -1000, 1000 };
+    index.GetSegments(all, segments);
+    CPPUNIT_ASSERT(segments.empty());
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFiberSpatialIndex)
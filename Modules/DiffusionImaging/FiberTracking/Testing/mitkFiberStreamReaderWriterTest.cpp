@@ -0,0 +1,214 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+#include <mitkTestingConfig.h>
+#include <mitkException.h>
+#include <mitkFiberStore.h>
+#include <mitkFiberStreamReader.h>
+#include <mitkFiberStreamWriter.h>
+#include <mitkGeometry3D.h>
+#include <fstream>
+#include <iterator>
+
+class mitkFiberStreamReaderWriterTestSuite : public mitk::TestFixture
+{
+
+  CPPUNIT_TEST_SUITE(mitkFiberStreamReaderWriterTestSuite);
+  MITK_TEST(Tck_WriteRead_Equal);
+  MITK_TEST(Trk_WriteRead_Equal);
+  MITK_TEST(Tck_ReadChunks_EqualsReadAll);
+  MITK_TEST(Tck_Truncated_ReturnsCompleteFibers);
+  MITK_TEST(Trk_Truncated_ReturnsCompleteFibers);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  /** Members used inside the different (sub-)tests. All members are initialized via setUp().*/
+  mitk::FiberStore m_Fibers;
+  mitk::Geometry3D::Pointer m_Geometry;
+
+  std::string GetOutputFile(const std::string& name)
+  {
+    return std::string(MITK_TEST_OUTPUT_DIR) + "/" + name;
+  }
+
+  void Write(const std::string& filename)
+  {
+    mitk::FiberStreamWriter writer;
+    writer.Open(filename, m_Geometry);
+    writer.WriteFibers(m_Fibers);
+    writer.Close();
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(m_Fibers.GetNumFibers()), writer.GetNumFibersWritten());
+  }
+
+  /** Copies the file without its last numBytes bytes. */
+  void Truncate(const std::string& filename, const std::string& truncatedFilename, size_t numBytes)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    std::vector< char > data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CPPUNIT_ASSERT(data.size() > numBytes);
+    std::ofstream out(truncatedFilename, std::ios::binary);
+    out.write(data.data(), data.size() - numBytes);
+  }
+
+  /** Compares the first numFibers fibers of m_Fibers with the given fibers. The coordinates are written as float32 and
+   * only flipped by the writer and reader, so they have to match exactly. */
+  void CompareFibers(const mitk::FiberStore& fibers, unsigned int numFibers)
+  {
+    CPPUNIT_ASSERT_EQUAL(numFibers, fibers.GetNumFibers());
+    for (unsigned int i=0; i<numFibers; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(m_Fibers.GetNumPoints(i), fibers.GetNumPoints(i));
+      for (unsigned int j=0; j<fibers.GetNumPoints(i); ++j)
+        for (int d=0; d<3; ++d)
+          CPPUNIT_ASSERT_EQUAL(m_Fibers.GetPoint(i, j)[d], fibers.GetPoint(i, j)[d]);
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    // fibers of different length (2 to 8 points), more fibers than a single chunk in Tck_ReadChunks_EqualsReadAll
+    m_Fibers.Clear();
+    for (unsigned int i=0; i<25; ++i)
+    {
+      std::vector< float > points;
+      for (unsigned int j=0; j<2+i%7; ++j)
+      {
+        points.push_back(-10.0f + 0.75f*i + 1.25f*j);
+        points.push_back(3.5f - 0.5f*i);
+        points.push_back(0.125f*i*j);
+      }
+      m_Fibers.AddFiber(points.data(), static_cast<unsigned int>(points.size()/3));
+    }
+
+    m_Geometry = mitk::Geometry3D::New();
+    mitk::Point3D origin;
+    origin.Fill(0);
+    m_Geometry->SetOrigin(origin);
+    float bounds[] = {0, 20, 0, 20, 0, 20};
+    m_Geometry->SetFloatBounds(bounds);
+  }
+
+  void tearDown() override
+  {
+    m_Fibers.Clear();
+    m_Geometry = nullptr;
+  }
+
+  void Tck_WriteRead_Equal()
+  {
+    std::string filename = GetOutputFile("streamTest.tck");
+    Write(filename);
+
+    mitk::FiberStreamReader reader;
+    reader.Open(filename);
+    CPPUNIT_ASSERT_EQUAL(static_cast<long>(m_Fibers.GetNumFibers()), reader.GetNumFibersInHeader());
+    mitk::FiberStore fibers;
+    reader.ReadAll(fibers);
+    CompareFibers(fibers, m_Fibers.GetNumFibers());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(m_Fibers.GetNumFibers()), reader.GetNumFibersRead());
+  }
+
+  void Trk_WriteRead_Equal()
+  {
+    std::string filename = GetOutputFile("streamTest.trk");
+    Write(filename);
+
+    mitk::FiberStreamReader reader;
+    reader.Open(filename);
+    CPPUNIT_ASSERT_EQUAL(static_cast<long>(m_Fibers.GetNumFibers()), reader.GetNumFibersInHeader());
+    CPPUNIT_ASSERT(reader.GetReferenceGeometry().IsNotNull());
+    mitk::FiberStore fibers;
+    reader.ReadAll(fibers);
+    CompareFibers(fibers, m_Fibers.GetNumFibers());
+  }
+
+  void Tck_ReadChunks_EqualsReadAll()
+  {
+    std::string filename = GetOutputFile("streamTest.tck");
+    Write(filename);
+
+    mitk::FiberStreamReader reader;
+    reader.Open(filename);
+    mitk::FiberStore fibers;
+    unsigned long numChunks = 0;
+    unsigned long numFibers = reader.ForEachChunk(4, [&](const mitk::FiberStore& chunk)
+    {
+      CPPUNIT_ASSERT(chunk.GetNumFibers()<=4);
+      for (unsigned int i=0; i<chunk.GetNumFibers(); ++i)
+        fibers.AddFiber(chunk.GetPoint(i, 0), chunk.GetNumPoints(i));
+      ++numChunks;
+    });
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(m_Fibers.GetNumFibers()), numFibers);
+    CPPUNIT_ASSERT_EQUAL(7ul, numChunks);
+    CompareFibers(fibers, m_Fibers.GetNumFibers());
+
+    // reading again after Rewind gives the same fibers
+    reader.Rewind();
+    mitk::FiberStore fibers2;
+    reader.ReadAll(fibers2);
+    CompareFibers(fibers2, m_Fibers.GetNumFibers());
+  }
+
+  void Tck_Truncated_ReturnsCompleteFibers()
+  {
+    std::string filename = GetOutputFile("streamTest.tck");
+    std::string truncatedFilename = GetOutputFile("streamTest_truncated.tck");
+    Write(filename);
+
+    // removes the end marker (3 floats), the delimiter of the last fiber (3 floats) and half of its last point
+    Truncate(filename, truncatedFilename, 30);
+
+    mitk::FiberStreamReader reader;
+    reader.Open(truncatedFilename);
+    CPPUNIT_ASSERT_EQUAL(static_cast<long>(m_Fibers.GetNumFibers()), reader.GetNumFibersInHeader());
+    mitk::FiberStore fibers;
+    reader.ReadAll(fibers);
+    CompareFibers(fibers, m_Fibers.GetNumFibers()-1);
+  }
+
+  void Trk_Truncated_ReturnsCompleteFibers()
+  {
+    std::string filename = GetOutputFile("streamTest.trk");
+    std::string truncatedFilename = GetOutputFile("streamTest_truncated.trk");
+    Write(filename);
+
+    // cuts the last fiber in the middle of a coordinate
+    Truncate(filename, truncatedFilename, 6);
+
+    mitk::FiberStreamReader reader;
+    reader.Open(truncatedFilename);
+    mitk::FiberStore fibers;
+    reader.ReadAll(fibers);
+    CompareFibers(fibers, m_Fibers.GetNumFibers()-1);
+
+    // a file truncated within the header is rejected
+    std::ifstream in(filename, std::ios::binary);
+    std::vector< char > header(500);
+    in.read(header.data(), header.size());
+    std::ofstream out(truncatedFilename, std::ios::binary | std::ios::trunc);
+    out.write(header.data(), header.size());
+    out.close();
+    CPPUNIT_ASSERT_THROW(reader.Open(truncatedFilename), mitk::Exception);
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFiberStreamReaderWriter)
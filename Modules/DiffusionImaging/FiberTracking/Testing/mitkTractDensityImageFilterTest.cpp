@@ -0,0 +1,201 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+#include <mitkFiberBundle.h>
+#include <mitkFiberStore.h>
+#include <mitkDiffusionFunctionCollection.h>
+#include <itkTractDensityImageFilter.h>
+#include <random>
+
+class mitkTractDensityImageFilterTestSuite : public mitk::TestFixture
+{
+
+  CPPUNIT_TEST_SUITE(mitkTractDensityImageFilterTestSuite);
+  MITK_TEST(Density_MultipleThreads_EqualsSequentialResult);
+  MITK_TEST(Density_Upsampled_EqualsSequentialResult);
+  MITK_TEST(BinaryEnvelope_MultipleThreads_EqualsSequentialResult);
+  CPPUNIT_TEST_SUITE_END();
+
+  typedef itk::Image< float, 3 > ItkFloatImgType;
+
+private:
+
+  /** Members used inside the different (sub-)tests. All members are initialized via setUp().*/
+  mitk::FiberBundle::Pointer m_FiberBundle;
+  ItkFloatImgType::Pointer m_ReferenceImage;
+
+public:
+
+  /** Random walk fibers with random weights inside a 40x30x20 image with 2.5 mm voxels. Some fibers leave the image. */
+  void setUp() override
+  {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0, 100);
+    std::uniform_real_distribution<float> step(-4, 4);
+    std::uniform_int_distribution<unsigned int> length(1, 40);
+    std::uniform_real_distribution<float> weight(0.1f, 2.0f);
+
+    mitk::FiberStore fibers;
+    for (unsigned int i=0; i<3000; ++i)
+    {
+      std::vector< float > points;
+      float p[3] = { position(random), 0.75f*position(random), 0.5f*position(random) };
+      unsigned int numPoints = length(random);
+      for (unsigned int j=0; j<numPoints; ++j)
+      {
+        points.insert(points.end(), p, p+3);
+        p[0] += step(random);
+        p[1] += step(random);
+        p[2] += step(random);
+      }
+      fibers.AddFiber(points.data(), numPoints);
+    }
+    m_FiberBundle = mitk::FiberBundle::New(fibers.GeneratePolyData());
+    for (unsigned int i=0; i<m_FiberBundle->GetNumFibers(); ++i)
+      m_FiberBundle->SetFiberWeight(i, weight(random));
+
+    m_ReferenceImage = ItkFloatImgType::New();
+    ItkFloatImgType::RegionType region;
+    ItkFloatImgType::SizeType size;
+    size[0] = 40;
+    size[1] = 30;
+    size[2] = 20;
+    region.SetSize(size);
+    ItkFloatImgType::SpacingType spacing;
+    spacing.Fill(2.5);
+    m_ReferenceImage->SetRegions(region);
+    m_ReferenceImage->SetSpacing(spacing);
+    m_ReferenceImage->Allocate();
+    m_ReferenceImage->FillBuffer(0.0);
+  }
+
+  void tearDown() override
+  {
+    m_FiberBundle = nullptr;
+    m_ReferenceImage = nullptr;
+  }
+
+  ItkFloatImgType::Pointer GenerateDensity(itk::ThreadIdType numThreads, float upsampling, bool binary, unsigned int& numCoveredVoxels)
+  {
+    itk::TractDensityImageFilter< ItkFloatImgType >::Pointer generator = itk::TractDensityImageFilter< ItkFloatImgType >::New();
+    generator->SetFiberBundle(m_FiberBundle);
+    generator->SetInputImage(m_ReferenceImage);
+    generator->SetUseImageGeometry(true);
+    generator->SetUpsamplingFactor(upsampling);
+    generator->SetBinaryOutput(binary);
+    generator->SetOutputAbsoluteValues(true);
+    generator->SetNumberOfThreads(numThreads);
+    generator->Update();
+    numCoveredVoxels = generator->GetNumCoveredVoxels();
+
+    ItkFloatImgType::Pointer output = generator->GetOutput();
+    output->DisconnectPipeline();
+    return output;
+  }
+
+  /** The sequential loop the filter used before it was parallelized, applied to an empty image of the same geometry. */
+  ItkFloatImgType::Pointer GenerateSequentialDensity(ItkFloatImgType::Pointer geometry, bool binary, unsigned int& numCoveredVoxels)
+  {
+    ItkFloatImgType::Pointer outImage = ItkFloatImgType::New();
+    outImage->CopyInformation(geometry);
+    outImage->SetRegions(geometry->GetLargestPossibleRegion());
+    outImage->Allocate();
+    outImage->FillBuffer(0.0);
+    itk::Vector<double,3> spacing = outImage->GetSpacing();
+
+    numCoveredVoxels = 0;
+    std::shared_ptr<const mitk::FiberStore> fibers = m_FiberBundle->GetFiberStore();
+    for (unsigned int i=0; i<fibers->GetNumFibers(); i++)
+    {
+      int numPoints = fibers->GetNumPoints(i);
+      float weight = m_FiberBundle->GetFiberWeight(i);
+      for (int j=0; j<numPoints-1; j++)
+      {
+        itk::Point<float, 3> startVertex = fibers->GetItkPoint(i, j);
+        itk::Index<3> startIndex;
+        itk::ContinuousIndex<float, 3> startIndexCont;
+        outImage->TransformPhysicalPointToIndex(startVertex, startIndex);
+        outImage->TransformPhysicalPointToContinuousIndex(startVertex, startIndexCont);
+
+        itk::Point<float, 3> endVertex = fibers->GetItkPoint(i, j + 1);
+        itk::Index<3> endIndex;
+        itk::ContinuousIndex<float, 3> endIndexCont;
+        outImage->TransformPhysicalPointToIndex(endVertex, endIndex);
+        outImage->TransformPhysicalPointToContinuousIndex(endVertex, endIndexCont);
+
+        std::vector< std::pair< itk::Index<3>, double > > segments = mitk::imv::IntersectImage(spacing, startIndex, endIndex, startIndexCont, endIndexCont);
+        for (std::pair< itk::Index<3>, double > segment : segments)
+        {
+          if (!outImage->GetLargestPossibleRegion().IsInside(segment.first))
+            continue;
+          if (outImage->GetPixel(segment.first)==0)
+            numCoveredVoxels++;
+
+          if (binary)
+            outImage->SetPixel(segment.first, 1);
+          else
+            outImage->SetPixel(segment.first, outImage->GetPixel(segment.first)+segment.second * weight);
+        }
+      }
+    }
+    return outImage;
+  }
+
+  /** Compares the filter output for 1 to 8 threads voxel by voxel (without tolerance) with the sequential result. */
+  void CompareWithSequentialResult(float upsampling, bool binary)
+  {
+    unsigned int numCovered = 0;
+    ItkFloatImgType::Pointer singleThreaded = GenerateDensity(1, upsampling, binary, numCovered);
+
+    unsigned int expectedNumCovered = 0;
+    ItkFloatImgType::Pointer expected = GenerateSequentialDensity(singleThreaded, binary, expectedNumCovered);
+    CPPUNIT_ASSERT_MESSAGE("Fibers cover some voxels", expectedNumCovered>0);
+
+    size_t numVoxels = expected->GetLargestPossibleRegion().GetNumberOfPixels();
+    for (itk::ThreadIdType numThreads : {1u, 2u, 3u, 8u})
+    {
+      ItkFloatImgType::Pointer output = GenerateDensity(numThreads, upsampling, binary, numCovered);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of covered voxels", expectedNumCovered, numCovered);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of voxels", numVoxels, static_cast<size_t>(output->GetLargestPossibleRegion().GetNumberOfPixels()));
+
+      size_t numDifferent = 0;
+      for (size_t i=0; i<numVoxels; ++i)
+        if (output->GetBufferPointer()[i]!=expected->GetBufferPointer()[i])
+          ++numDifferent;
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Voxels differing from the sequential result", static_cast<size_t>(0), numDifferent);
+    }
+  }
+
+  void Density_MultipleThreads_EqualsSequentialResult()
+  {
+    CompareWithSequentialResult(1, false);
+  }
+
+  void Density_Upsampled_EqualsSequentialResult()
+  {
+    CompareWithSequentialResult(2, false);
+  }
+
+  void BinaryEnvelope_MultipleThreads_EqualsSequentialResult()
+  {
+    CompareWithSequentialResult(1, true);
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTractDensityImageFilter)
@@ -4,6 +4,10 @@ set(CPP_FILES
 
   ## IO datastructures
   IODataStructures/FiberBundle/mitkFiberBundle.cpp
+  IODataStructures/FiberBundle/mitkFiberStore.cpp
+  IODataStructures/FiberBundle/mitkFiberSpatialIndex.cpp
+  IODataStructures/FiberBundle/mitkFiberStreamReader.cpp
+  IODataStructures/FiberBundle/mitkFiberStreamWriter.cpp
   IODataStructures/FiberBundle/mitkTrackvis.cpp
   IODataStructures/PlanarFigureComposite/mitkPlanarFigureComposite.cpp
   IODataStructures/mitkTractographyForest.cpp
@@ -29,6 +33,10 @@ set(CPP_FILES
 set(H_FILES
   # DataStructures -> FiberBundle
   IODataStructures/FiberBundle/mitkFiberBundle.h
+  IODataStructures/FiberBundle/mitkFiberStore.h
+  IODataStructures/FiberBundle/mitkFiberSpatialIndex.h
+  IODataStructures/FiberBundle/mitkFiberStreamReader.h
+  IODataStructures/FiberBundle/mitkFiberStreamWriter.h
   IODataStructures/FiberBundle/mitkTrackvis.h
   IODataStructures/mitkFiberfoxParameters.h
   IODataStructures/mitkTractographyForest.h
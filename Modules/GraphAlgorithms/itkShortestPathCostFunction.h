@@ -47,7 +47,17 @@ namespace itk
     typedef typename TInputImageType::IndexType IndexType;
 
     // \brief Set the input image.
-    itkSetConstObjectMacro(Image, TInputImageType);
+    virtual void SetImage(const TInputImageType *image)
+    {
+      if (this->m_Image != image)
+      {
+        this->m_Image = image;
+        this->CostsModified();
+      }
+    }
+
+    // \brief Returns the time of the last change that affects the costs returned by GetCost
+    ModifiedTimeType GetCostsMTime() const { return m_CostsMTime.GetMTime(); }
 
     // \brief Calculate the cost for going from pixel p1 to pixel p2
     virtual double GetCost(IndexType p1, IndexType p2) = 0;
@@ -58,6 +68,11 @@ namespace itk
     // \brief Initialize the metric
     virtual void Initialize() = 0;
 
+    // \brief Whether ShortestPathImageFilter may continue its previous search if only the end index changed.
+    // Subclasses may return true if GetCost and GetMinCost do not depend on the start and end index, and if every
+    // other change of their costs is reported by CostsModified().
+    virtual bool IsSearchContinuable() const { return false; }
+
     // \brief Set the starting index of a path
     void SetStartIndex(const IndexType &index);
 
@@ -65,13 +80,23 @@ namespace itk
     void SetEndIndex(const IndexType &index);
 
   protected:
-    ShortestPathCostFunction(){};
+    ShortestPathCostFunction() { m_CostsMTime.Modified(); };
     ~ShortestPathCostFunction() override{};
     void PrintSelf(std::ostream &os, Indent indent) const override;
     ImageConstPointer m_Image;
     IndexType m_StartIndex, m_EndIndex;
 
+    // \brief Has to be called by subclasses whenever a change affects the costs returned by GetCost.
+    // Unlike Modified(), changes of e.g. the start or end index do not invalidate already computed costs.
+    void CostsModified()
+    {
+      m_CostsMTime.Modified();
+      this->Modified();
+    }
+
   private:
+    TimeStamp m_CostsMTime;
+
     ShortestPathCostFunction(const Self &); // purposely not implemented
     void operator=(const Self &);           // purposely not implemented
   };
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkShortestPathCostFunction.h"
 
 #include "itkImageRegionConstIterator.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -39,6 +40,10 @@ namespace itk
   To compute  the costs of the gradient magnitude dynamically
   an iverted map of the histogram of gradient magnitude image is used.
 
+  All features only depend on the pixel a link leads to. Initialize() therefore
+  precomputes the costs of all pixels of the image in parallel (once with and once
+  without the dynamic cost map, as needed), so GetCost() is a lookup during the search.
+
   */
   template <class TInputImageType>
   class ITK_EXPORT ShortestPathCostFunctionLiveWire : public ShortestPathCostFunction<TInputImageType>
@@ -59,6 +64,7 @@ namespace itk
 
     typedef itk::Image<unsigned char, 2> UnsignedCharImageType;
     typedef itk::Image<float, 2> FloatImageType;
+    typedef itk::Image<double, 2> CostImageType;
 
     typedef float ComponentType;
     typedef itk::CovariantVector<ComponentType, 2> OutputPixelType;
@@ -77,6 +83,9 @@ namespace itk
     /** \brief Initialize the metric*/
     void Initialize() override;
 
+    /** \brief The costs do not depend on the start and end index, changes of the maps are reported by CostsModified()*/
+    bool IsSearchContinuable() const override { return true; }
+
     /** \brief Add void pixel in cost map*/
     virtual void AddRepulsivePoint(const IndexType &index);
 
@@ -96,14 +105,30 @@ namespace itk
       this->m_CostMap = costMap;
       this->m_UseCostMap = true;
       this->m_MaxMapCosts = -1;
-      this->Modified();
+      this->m_DynamicCostImage = nullptr;
+      this->CostsModified();
     }
 
-    void SetUseCostMap(bool useCostMap) { this->m_UseCostMap = useCostMap; }
+    void SetUseCostMap(bool useCostMap)
+    {
+      if (this->m_UseCostMap != useCostMap)
+      {
+        this->m_UseCostMap = useCostMap;
+        this->CostsModified();
+      }
+    }
     /**
      \brief Set the maximum of the dynamic cost map to save computation time.
     */
-    void SetCostMapMaximum(double max) { this->m_MaxMapCosts = max; }
+    void SetCostMapMaximum(double max)
+    {
+      if (this->m_MaxMapCosts != max)
+      {
+        this->m_MaxMapCosts = max;
+        this->m_DynamicCostImage = nullptr;
+        this->CostsModified();
+      }
+    }
     enum Constants
     {
       MAPSCALEFACTOR = 10
@@ -155,8 +180,27 @@ namespace itk
 
     double m_MaxMapCosts;
 
+    /** \brief Precomputed costs of each pixel without and with the dynamic cost map, see Initialize() */
+    CostImageType::Pointer m_CostImage;
+    CostImageType::Pointer m_DynamicCostImage;
+
+    /** \brief Costs of a link leading to pixel p, before scaling by the length of the link */
+    double ComputePixelCost(const IndexType &p, bool useCostMap);
+
+    /** \brief Computes the costs of all pixels of the image, split row-wise over the available threads */
+    CostImageType::Pointer ComputeCostImage(bool useCostMap);
+
   private:
     double SigmoidFunction(double I, double max, double min, double alpha, double beta);
+
+    static ITK_THREAD_RETURN_TYPE ComputeCostImageThreaderCallback(void *arg);
+
+    struct CostImageThreadStruct
+    {
+      Self *CostFunction;
+      CostImageType *CostImage;
+      bool UseCostMap;
+    };
   };
 
 } // end namespace itk
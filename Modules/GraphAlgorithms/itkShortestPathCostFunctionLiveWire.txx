@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkCastImageFilter.h>
 #include <itkGradientImageFilter.h>
 #include <itkGradientMagnitudeImageFilter.h>
+#include <itkImageRegionIteratorWithIndex.h>
 #include <itkLaplacianImageFilter.h>
 #include <itkStatisticsImageFilter.h>
 #include <itkZeroCrossingImageFilter.h>
@@ -42,12 +43,14 @@ namespace itk
   {
     this->m_MaskImage->SetPixel(index, 255);
     m_UseRepulsivePoints = true;
+    this->CostsModified();
   }
 
   template <class TInputImageType>
   void ShortestPathCostFunctionLiveWire<TInputImageType>::RemoveRepulsivePoint(const IndexType &index)
   {
     this->m_MaskImage->SetPixel(index, 0);
+    this->CostsModified();
   }
 
   template <class TInputImageType>
@@ -66,7 +69,7 @@ namespace itk
       this->m_MaskImage->Allocate();
       this->m_MaskImage->FillBuffer(0);
 
-      this->Modified();
+      this->CostsModified();
       this->m_Initialized = false;
     }
   }
@@ -76,18 +79,12 @@ namespace itk
   {
     m_UseRepulsivePoints = false;
     this->m_MaskImage->FillBuffer(0);
+    this->CostsModified();
   }
 
   template <class TInputImageType>
   double ShortestPathCostFunctionLiveWire<TInputImageType>::GetCost(IndexType p1, IndexType p2)
   {
-    // local component costs
-    // weights
-    double w1;
-    double w2;
-    double w3;
-    double costs = 0.0;
-
     // if we are on the mask, return asap
     if (m_UseRepulsivePoints)
     {
@@ -95,6 +92,38 @@ namespace itk
         return 1000;
     }
 
+    // local component costs, precomputed in Initialize()
+    const CostImageType *costImage = m_UseCostMap ? m_DynamicCostImage.GetPointer() : m_CostImage.GetPointer();
+    double costs = nullptr != costImage ? costImage->GetPixel(p2) : this->ComputePixelCost(p2, m_UseCostMap);
+
+    // scale by euclidian distance
+    double costScale;
+    if (p1[0] == p2[0] || p1[1] == p2[1])
+    {
+      // horizontal or vertical neighbor
+      costScale = 1.0;
+    }
+    else
+    {
+      // diagonal neighbor
+      costScale = sqrt(2.0);
+    }
+
+    costs *= costScale;
+
+    return costs;
+  }
+
+  template <class TInputImageType>
+  double ShortestPathCostFunctionLiveWire<TInputImageType>::ComputePixelCost(const IndexType &p2, bool useCostMap)
+  {
+    // local component costs
+    // weights
+    double w1;
+    double w2;
+    double w3;
+    double costs = 0.0;
+
     double gradientX, gradientY;
     gradientX = gradientY = 0.0;
 
@@ -107,7 +136,7 @@ namespace itk
     gradientX = m_GradientImage->GetPixel(p2)[0];
     gradientY = m_GradientImage->GetPixel(p2)[1];
 
-    if (m_UseCostMap && !m_CostMap.empty())
+    if (useCostMap && !m_CostMap.empty())
     {
       std::map<int, int>::iterator end = m_CostMap.end();
       std::map<int, int>::iterator last = --(m_CostMap.end());
@@ -257,7 +286,7 @@ namespace itk
 
     double gradientDirectionCost = acos(scalarProduct) / 3.14159265;
 
-    if (this->m_UseCostMap)
+    if (useCostMap)
     {
       w1 = 0.43;
       w2 = 0.43;
@@ -271,22 +300,53 @@ namespace itk
     }
     costs = w1 * laplacianCost + w2 * gradientCost + w3 * gradientDirectionCost;
 
-    // scale by euclidian distance
-    double costScale;
-    if (p1[0] == p2[0] || p1[1] == p2[1])
-    {
-      // horizontal or vertical neighbor
-      costScale = 1.0;
-    }
-    else
+    return costs;
+  }
+
+  template <class TInputImageType>
+  typename ShortestPathCostFunctionLiveWire<TInputImageType>::CostImageType::Pointer
+    ShortestPathCostFunctionLiveWire<TInputImageType>::ComputeCostImage(bool useCostMap)
+  {
+    typename CostImageType::Pointer costImage = CostImageType::New();
+    costImage->SetRegions(this->m_Image->GetLargestPossibleRegion());
+    costImage->Allocate();
+
+    CostImageThreadStruct str;
+    str.CostFunction = this;
+    str.CostImage = costImage;
+    str.UseCostMap = useCostMap;
+
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetSingleMethod(ComputeCostImageThreaderCallback, &str);
+    threader->SingleMethodExecute();
+
+    return costImage;
+  }
+
+  template <class TInputImageType>
+  ITK_THREAD_RETURN_TYPE ShortestPathCostFunctionLiveWire<TInputImageType>::ComputeCostImageThreaderCallback(void *arg)
+  {
+    auto *threadInfo = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+    auto *str = static_cast<CostImageThreadStruct *>(threadInfo->UserData);
+
+    // split the rows of the image over the threads
+    RegionType region = str->CostImage->GetLargestPossibleRegion();
+    const SizeValueType numberOfRows = region.GetSize(1);
+    const SizeValueType firstRow = numberOfRows * threadInfo->ThreadID / threadInfo->NumberOfThreads;
+    const SizeValueType endRow = numberOfRows * (threadInfo->ThreadID + 1) / threadInfo->NumberOfThreads;
+    if (firstRow == endRow)
+      return ITK_THREAD_RETURN_VALUE;
+
+    region.SetIndex(1, region.GetIndex(1) + static_cast<IndexValueType>(firstRow));
+    region.SetSize(1, endRow - firstRow);
+
+    ImageRegionIteratorWithIndex<CostImageType> it(str->CostImage, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
     {
-      // diagonal neighbor
-      costScale = sqrt(2.0);
+      it.Set(str->CostFunction->ComputePixelCost(it.GetIndex(), str->UseCostMap));
     }
 
-    costs *= costScale;
-
-    return costs;
+    return ITK_THREAD_RETURN_VALUE;
   }
 
   template <class TInputImageType>
@@ -372,9 +432,22 @@ namespace itk
                       // everything is fine. If estimation is higher than actual costs, you might not get the shortest
                       // but a different path.
 
+      m_CostImage = nullptr;
+      m_DynamicCostImage = nullptr;
+
       m_Initialized = true;
     }
 
+    // precompute the costs of all pixels, so the search only has to look them up
+    if (m_UseCostMap && m_DynamicCostImage.IsNull())
+    {
+      m_DynamicCostImage = this->ComputeCostImage(true);
+    }
+    else if (!m_UseCostMap && m_CostImage.IsNull())
+    {
+      m_CostImage = this->ComputeCostImage(false);
+    }
+
     // check start/end point value
     startValue = this->m_Image->GetPixel(this->m_StartIndex);
     endValue = this->m_Image->GetPixel(this->m_EndIndex);
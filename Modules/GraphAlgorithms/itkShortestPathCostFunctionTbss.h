@@ -54,7 +54,17 @@ namespace itk
     // \brief returns the minimal costs possible (needed for A*)
     double GetMinCost() override;
 
-    void SetThreshold(double t) { m_Threshold = t; }
+    // \brief The costs only depend on the image and the threshold
+    bool IsSearchContinuable() const override { return true; }
+
+    void SetThreshold(double t)
+    {
+      if (m_Threshold != t)
+      {
+        m_Threshold = t;
+        this->CostsModified();
+      }
+    }
   protected:
     ShortestPathCostFunctionTbss();
 
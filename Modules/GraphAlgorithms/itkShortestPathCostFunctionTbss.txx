@@ -22,7 +22,7 @@ namespace itk
 {
   // Constructor
   template <class TInputImageType>
-  ShortestPathCostFunctionTbss<TInputImageType>::ShortestPathCostFunctionTbss()
+  ShortestPathCostFunctionTbss<TInputImageType>::ShortestPathCostFunctionTbss() : m_Threshold(0.0)
   {
   }
 
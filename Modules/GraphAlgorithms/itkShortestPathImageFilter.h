@@ -40,6 +40,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 // void AddEndIndex(const IndexType & EndIndex) //Optional. By calling this function you can add several endpoints! The
 // algorithm will look for several shortest Pathes. From Start to all Endpoints.
 //
+// If only the end index changes between two updates and the cost function allows it (see
+// ShortestPathCostFunction::IsSearchContinuable), the search tree of the previous update is continued instead of
+// starting a new search. Changes of the input, the start index or the costs (see
+// ShortestPathCostFunction::GetCostsMTime) start a new search.
+//
 /// GET FUNCTIONS
 // std::vector< itk::Index<3> > GetVectorPath(); // returns the shortest path as vector
 // std::vector< std::vector< itk::Index<3> > GetMultipleVectorPathe(); // returns a vector of shortest Pathes (which are
@@ -184,7 +189,19 @@ namespace itk
 
     bool m_ActivateTimeOut; // if true, then i search max. 30 secs. then abort
 
-    bool m_Initialized;
+    bool m_Initialized; // m_Nodes holds the search tree of the last search, which might be continued
+
+    // \brief Id of the current search. Nodes with another id have not been reached by this search yet
+    unsigned int m_SearchId;
+
+    // \brief Discovered but not yet closed nodes, as binary min-heap of node numbers ordered by distAndEst
+    std::vector<NodeNumType> m_OpenList;
+
+    // \brief Parameters of the last search, which has to be restarted if any of them changes
+    NodeNumType m_SearchStartNode;
+    ModifiedTimeType m_SearchInputMTime;
+    ModifiedTimeType m_SearchCostsMTime;
+    bool m_SearchFullNeighbors;
 
     CostFunctionTypePointer m_CostFunction;
     IndexType m_StartIndex, m_EndIndex;
@@ -214,6 +231,21 @@ namespace itk
     // \brief Convert image coordinate to a indexnumber of a node in m_Nodes
     unsigned int CoordToNode(IndexType);
 
+    // \brief Returns a node of m_Nodes, which is reset first if the current search did not reach it yet
+    ShortestPathNode *GetNode(NodeNumType nodeNum);
+
+    // \brief Inserts a node into the open list
+    void PushOpenNode(ShortestPathNode *node);
+
+    // \brief Removes and returns the node with the lowest distAndEst from the open list
+    ShortestPathNode *PopOpenNode();
+
+    // \brief Restores the order of the open list after distAndEst of the given node changed
+    void UpdateOpenNode(ShortestPathNode *node);
+
+    void SiftUpOpenNode(NodeNumType heapIndex);
+    void SiftDownOpenNode(NodeNumType heapIndex);
+
     // \brief Returns the neighbors of a node
     std::vector<ShortestPathNode *> GetNeighbors(NodeNumType nodeNum, bool FullNeighbors);
 
@@ -38,7 +38,12 @@ namespace itk
       m_CalcAllDistances(false),
       multipleEndPoints(false),
       m_ActivateTimeOut(false),
-      m_Initialized(false)
+      m_Initialized(false),
+      m_SearchId(0),
+      m_SearchStartNode(0),
+      m_SearchInputMTime(0),
+      m_SearchCostsMTime(0),
+      m_SearchFullNeighbors(false)
   {
     m_endPoints.clear();
     m_endPointsClosed.clear();
@@ -162,22 +167,22 @@ namespace itk
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1] - neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] + neighborDistance;
       NeighborCoord[1] = Coord[1];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1] + neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] - neighborDistance;
       NeighborCoord[1] = Coord[1];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       if (FullNeighbors)
       {
@@ -185,22 +190,22 @@ namespace itk
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
       }
     }
     if (dim == 3)
@@ -210,37 +215,37 @@ namespace itk
       NeighborCoord[1] = Coord[1] - neighborDistance;
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] + neighborDistance;
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1] + neighborDistance;
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] - neighborDistance;
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2] + neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2] - neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
       if (FullNeighbors)
       {
@@ -250,125 +255,125 @@ namespace itk
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         // BackSlice (Diagonal)
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         // BackSlice (Non-Diag)
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         // FrontSlice (Diagonal)
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         // FrontSlice(Non-Diag)
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
       }
     }
     return nodeList;
@@ -385,7 +390,6 @@ namespace itk
     m_Graph_StartNode = CoordToNode(m_StartIndex);
     // MITK_INFO << "StartIndex = " << StartIndex;
     // MITK_INFO << "StartNode = " << m_Graph_StartNode;
-    m_Initialized = false;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -420,51 +424,187 @@ namespace itk
     const typename TInputImageType::IndexType &a)
   {
     // Returns the minimal possible costs for a path from "a" to targetnode.
-    itk::Vector<float, 3> v;
-    v[0] = m_EndIndex[0] - a[0];
-    v[1] = m_EndIndex[1] - a[1];
-    v[2] = m_EndIndex[2] - a[2];
+    itk::Vector<float, TInputImageType::ImageDimension> v;
+    for (unsigned int i = 0; i < TInputImageType::ImageDimension; ++i)
+    {
+      v[i] = m_EndIndex[i] - a[i];
+    }
 
     return m_CostFunction->GetMinCost() * v.GetNorm();
   }
 
+  template <class TInputImageType, class TOutputImageType>
+  inline ShortestPathNode *ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNode(NodeNumType nodeNum)
+  {
+    ShortestPathNode *node = &m_Nodes[nodeNum];
+    if (node->searchId != m_SearchId)
+    {
+      // first access during the current search, forget what an earlier search stored in this node
+      node->distance = -1;
+      node->distAndEst = -1;
+      node->prevNode = -1;
+      node->closed = false;
+      node->heapIndex = -1;
+      node->searchId = m_SearchId;
+    }
+    return node;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::PushOpenNode(ShortestPathNode *node)
+  {
+    node->heapIndex = m_OpenList.size();
+    m_OpenList.push_back(node->mainListIndex);
+    SiftUpOpenNode(node->heapIndex);
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  ShortestPathNode *ShortestPathImageFilter<TInputImageType, TOutputImageType>::PopOpenNode()
+  {
+    ShortestPathNode *node = &m_Nodes[m_OpenList.front()];
+    node->heapIndex = -1;
+
+    NodeNumType lastNode = m_OpenList.back();
+    m_OpenList.pop_back();
+    if (!m_OpenList.empty())
+    {
+      m_OpenList.front() = lastNode;
+      m_Nodes[lastNode].heapIndex = 0;
+      SiftDownOpenNode(0);
+    }
+    return node;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::UpdateOpenNode(ShortestPathNode *node)
+  {
+    // the key may have moved in both directions if the target changed during the search
+    SiftUpOpenNode(node->heapIndex);
+    SiftDownOpenNode(node->heapIndex);
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::SiftUpOpenNode(NodeNumType heapIndex)
+  {
+    const NodeNumType nodeNum = m_OpenList[heapIndex];
+    const DistanceType key = m_Nodes[nodeNum].distAndEst;
+
+    while (heapIndex > 0)
+    {
+      NodeNumType parentIndex = (heapIndex - 1) / 2;
+      if (m_Nodes[m_OpenList[parentIndex]].distAndEst <= key)
+        break;
+
+      m_OpenList[heapIndex] = m_OpenList[parentIndex];
+      m_Nodes[m_OpenList[heapIndex]].heapIndex = heapIndex;
+      heapIndex = parentIndex;
+    }
+
+    m_OpenList[heapIndex] = nodeNum;
+    m_Nodes[nodeNum].heapIndex = heapIndex;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::SiftDownOpenNode(NodeNumType heapIndex)
+  {
+    const NodeNumType size = m_OpenList.size();
+    const NodeNumType nodeNum = m_OpenList[heapIndex];
+    const DistanceType key = m_Nodes[nodeNum].distAndEst;
+
+    while (2 * heapIndex + 1 < size)
+    {
+      NodeNumType childIndex = 2 * heapIndex + 1;
+      if (childIndex + 1 < size &&
+          m_Nodes[m_OpenList[childIndex + 1]].distAndEst < m_Nodes[m_OpenList[childIndex]].distAndEst)
+        ++childIndex;
+      if (key <= m_Nodes[m_OpenList[childIndex]].distAndEst)
+        break;
+
+      m_OpenList[heapIndex] = m_OpenList[childIndex];
+      m_Nodes[m_OpenList[heapIndex]].heapIndex = heapIndex;
+      heapIndex = childIndex;
+    }
+
+    m_OpenList[heapIndex] = nodeNum;
+    m_Nodes[nodeNum].heapIndex = heapIndex;
+  }
+
   template <class TInputImageType, class TOutputImageType>
   void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitGraph()
   {
-    if (!m_Initialized)
+    // Calc Number of nodes
+    auto imageDimensions = TInputImageType::ImageDimension;
+    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
+    NodeNumType numberOfNodes = 1;
+    for (NodeNumType i = 0; i < imageDimensions; ++i)
+      numberOfNodes = numberOfNodes * size[i];
+
+    if (!m_Nodes || numberOfNodes != m_Graph_NumberOfNodes)
     {
       // Clean up previous stuff
       CleanUp();
 
-      // Calc Number of nodes
-      auto imageDimensions = TInputImageType::ImageDimension;
-      const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-      m_Graph_NumberOfNodes = 1;
-      for (NodeNumType i = 0; i < imageDimensions; ++i)
-        m_Graph_NumberOfNodes = m_Graph_NumberOfNodes * size[i];
-
-      // Initialize mainNodeList with that number
+      // Initialize mainNodeList with that number. The nodes are reset lazily by GetNode(), when a search reaches them,
+      // so the node list is only allocated once for all searches on images of the same size.
+      m_Graph_NumberOfNodes = numberOfNodes;
       m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
-
-      // Initialize each node in nodelist
       for (NodeNumType i = 0; i < m_Graph_NumberOfNodes; i++)
       {
-        m_Nodes[i].distAndEst = -1;
-        m_Nodes[i].distance = -1;
-        m_Nodes[i].prevNode = -1;
         m_Nodes[i].mainListIndex = i;
-        m_Nodes[i].closed = false;
+        m_Nodes[i].searchId = 0;
       }
-
-      m_Initialized = true;
+      m_SearchId = 0;
     }
 
-    // In the beginning, the Startnode needs a distance of 0
-    m_Nodes[m_Graph_StartNode].distance = 0;
-    m_Nodes[m_Graph_StartNode].distAndEst = 0;
-
     // initalize cost function
     m_CostFunction->Initialize();
+
+    // If only the end point changed since the last search (the typical live wire case), the search tree is still
+    // valid: closed nodes keep their optimal distances and the search is continued with the estimates to the new end.
+    // This requires costs which do not depend on the end point, which the cost function has to confirm.
+    bool continueSearch = m_Initialized && m_CostFunction->IsSearchContinuable() && !multipleEndPoints &&
+                          !m_CalcAllDistances && !m_StoreVectorOrder &&
+                          m_SearchStartNode == m_Graph_StartNode &&
+                          m_SearchInputMTime == this->GetInput()->GetMTime() &&
+                          m_SearchCostsMTime == m_CostFunction->GetCostsMTime() &&
+                          m_SearchFullNeighbors == m_Graph_fullNeighbors;
+
+    if (continueSearch)
+    {
+      for (NodeNumType i = 0; i < m_OpenList.size(); ++i)
+      {
+        ShortestPathNode &node = m_Nodes[m_OpenList[i]];
+        node.distAndEst = node.distance + getEstimatedCostsToTarget(NodeToCoord(node.mainListIndex));
+      }
+      for (NodeNumType i = m_OpenList.size() / 2; i > 0; --i)
+      {
+        SiftDownOpenNode(i - 1);
+      }
+    }
+    else
+    {
+      // a new search id invalidates all nodes at once, only on overflow they have to be reset explicitly
+      if (++m_SearchId == 0)
+      {
+        for (NodeNumType i = 0; i < m_Graph_NumberOfNodes; i++)
+          m_Nodes[i].searchId = 0;
+        m_SearchId = 1;
+      }
+      m_OpenList.clear();
+      m_VectorOrder.clear();
+
+      // In the beginning, the Startnode needs a distance of 0 and is the only discovered node
+      ShortestPathNode *startNode = GetNode(m_Graph_StartNode);
+      startNode->distance = 0;
+      startNode->distAndEst = 0;
+      PushOpenNode(startNode);
+
+      m_SearchStartNode = m_Graph_StartNode;
+      m_SearchInputMTime = this->GetInput()->GetMTime();
+      m_SearchCostsMTime = m_CostFunction->GetCostsMTime();
+      m_SearchFullNeighbors = m_Graph_fullNeighbors;
+      m_Initialized = true;
+    }
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -481,43 +621,25 @@ namespace itk
     DistanceType curNodeDistance = 0;
     NodeNumType numberOfNodesChecked = 0;
 
-    // Create Multimap (tree structure for fast searching)
-    std::multimap<double, ShortestPathNode *> myMap;
-    std::pair<std::multimap<double, ShortestPathNode *>::iterator, std::multimap<double, ShortestPathNode *>::iterator>
-      ret;
-    std::multimap<double, ShortestPathNode *>::iterator it;
-
-    // At first, only startNote is discovered.
-    myMap.insert(
-      std::pair<double, ShortestPathNode *>(m_Nodes[m_Graph_StartNode].distAndEst, &m_Nodes[m_Graph_StartNode]));
+    // A continued search may already know the shortest path to the end node
+    if (!multipleEndPoints && !m_CalcAllDistances && GetNode(m_Graph_EndNode)->closed)
+    {
+      return;
+    }
 
     // While there are discovered Nodes, pick the one with lowest distance,
     // update its neighbors and eventually delete it from the discovered Nodes list.
-    while (!myMap.empty())
+    // The discovered nodes are kept in a binary heap (m_OpenList), so picking the best node and updating the
+    // distance of a discovered node are logarithmic in the number of discovered nodes.
+    while (!m_OpenList.empty())
     {
       numberOfNodesChecked++;
-      /*if ( (numberOfNodesChecked % (m_Graph_NumberOfNodes/100)) == 0)
-      {
-        MITK_INFO << "Checked " << ( numberOfNodesChecked / (m_Graph_NumberOfNodes/100) ) << "% List: " << myMap.size()
-      << "\n";
-      }*/
-
-      // Get element with lowest score
-      mainNodeListIndex = myMap.begin()->second->mainListIndex;
-      curNodeDistance = myMap.begin()->second->distance;
-      myMap.begin()->second->closed = true; // close it
-
-      // Debug:
-      // MITK_INFO << "INFO: size " << myMap.size();
-      /*
-      for (it = myMap.begin(); it != myMap.end(); ++it)
-      {
-      MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-      }
-      */
 
-      // Kicks out element with lowest score
-      myMap.erase(myMap.begin());
+      // Get element with lowest score, kick it out of the open list and close it
+      ShortestPathNode *curNode = PopOpenNode();
+      curNode->closed = true;
+      mainNodeListIndex = curNode->mainListIndex;
+      curNodeDistance = curNode->distance;
 
       // if wanted, store vector order
       if (m_StoreVectorOrder)
@@ -526,137 +648,34 @@ namespace itk
       }
 
       // Check neighbors
+      IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
       std::vector<ShortestPathNode *> neighborNodes = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors);
       for (NodeNumType i = 0; i < neighborNodes.size(); i++)
       {
-        if (neighborNodes[i]->closed)
+        ShortestPathNode *neighborNode = neighborNodes[i];
+        if (neighborNode->closed)
           continue; // this nodes is already closed, go to next neighbor
 
-        IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
-        IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]->mainListIndex);
+        IndexType coordNeighborNode = NodeToCoord(neighborNode->mainListIndex);
 
         // calculate the new Distance to the current neighbor
         double newDistance = curNodeDistance + (m_CostFunction->GetCost(coordCurNode, coordNeighborNode));
 
         // if it is shorter than any yet known path to this neighbor, than the current path is better. Save that!
-        if ((newDistance < neighborNodes[i]->distance) || (neighborNodes[i]->distance == -1))
+        if ((newDistance < neighborNode->distance) || (neighborNode->distance == -1))
         {
-          // if that neighbornode is not in discoverednodeList yet, Push it there and update
-          if (neighborNodes[i]->distance == -1)
+          neighborNode->distance = newDistance;
+          neighborNode->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighborNode->prevNode = mainNodeListIndex;
+
+          // if that neighbornode is not in discoverednodeList yet, Push it there, otherwise update its position
+          if (neighborNode->heapIndex == static_cast<NodeNumType>(-1))
           {
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-            /*
-            MITK_INFO << "Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            MITK_INFO << "INFO: size " << myMap.size();
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }
-            */
+            PushOpenNode(neighborNode);
           }
-          // or if is already in discoverednodelist, update
           else
           {
-            /*
-            it = myMap.find(neighborNodes[i]->distAndEst);
-            if (it == myMap.end() )
-            {
-            MITK_INFO << "Nothing!";
-            // look further
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            if ((*it).second->mainListIndex == lookForId)
-            {
-            MITK_INFO << "But it is there!!!";
-            MITK_INFO << "Searched for: " << lookFor << "   but had: " << (*it).second->distAndEst;
-            }
-
-            }
-            }
-            */
-
-            // 1st : find and delete old element
-            bool found = false;
-            ret = myMap.equal_range(neighborNodes[i]->distAndEst);
-
-            if ((ret.first == ret.second))
-            {
-              /*+++++++++++++ no exact match +++++++++++++*/
-              // MITK_INFO << "No exact match!"; // if this happens, you are screwed
-              /*
-              MITK_INFO << "Was looking for: " << lookFor << "  ID: " << lookForId;
-              if (ret.first != myMap.end() )
-              {
-              it = ret.first;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              ++it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              --it;
-              --it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              }
-
-              // look if that ID is found in the map
-              for (it = myMap.begin(); it != myMap.end(); ++it)
-              {
-              if ((*it).second->mainListIndex == lookForId)
-              {
-              MITK_INFO << "But it is there!!!";
-              MITK_INFO << "Searched dist: " << lookFor << "  found dist: " << (*it).second->distAndEst;
-              }
-
-              }
-              */
-            }
-            else
-            {
-              for (it = ret.first; it != ret.second; ++it)
-              {
-                if (it->second->mainListIndex == neighborNodes[i]->mainListIndex)
-                {
-                  found = true;
-                  myMap.erase(it);
-                  /*
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  MITK_INFO << "Erase: " << it->first << "|" << it->second->mainListIndex;
-
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  for (it = myMap.begin(); it != myMap.end(); ++it)
-                  {
-                  MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-                  }
-                  */
-                  break;
-                }
-              }
-            }
-
-            if (!found)
-            {
-              // MITK_INFO << "Could not find it! :(";
-              continue;
-            }
-
-            // 2nd: update and insert new element
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            // myMap.insert( std::pair<double,ShortestPathNode*> (neighborNodes[i]->distAndEst, neighborNodes[i]));
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-
-            // MITK_INFO << "Re-Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            // m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            // MITK_INFO << "INFO: size " << myMap.size();
-            /*for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }*/
+            UpdateOpenNode(neighborNode);
           }
         }
       }
@@ -792,9 +811,10 @@ namespace itk
     {
       IndexType index = distanceImageIt.GetIndex();
       myNodeNum = CoordToNode(index);
-      double newVal = m_Nodes[myNodeNum].distance;
+      double newVal = GetNode(myNodeNum)->distance; // -1 for nodes the search did not reach
       distanceImageIt.Set(newVal);
     }
+    return image;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -863,8 +883,11 @@ namespace itk
     m_VectorPath.clear();
     // TODO: if multiple Path, clear all multiple Paths
 
-    if (m_Nodes)
-      delete[] m_Nodes;
+    delete[] m_Nodes;
+    m_Nodes = nullptr;
+    m_Graph_NumberOfNodes = 0;
+    m_OpenList.clear();
+    m_Initialized = false;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -32,6 +32,8 @@ namespace itk
     NodeNumType prevNode;      // previous node. Important to find the Shortest Path
     NodeNumType mainListIndex; // Indexnumber of this node in m_Nodes
     bool closed;               // determines if this node is closes, so its optimal path to startNode is known
+    NodeNumType heapIndex;     // position in the open list of the search, or -1 if it is not in the open list
+    unsigned int searchId;     // search this node was last initialized for, older nodes are initialized on access
   };
 
   // bool operator<(const ShortestPathNode &a) const;
@@ -0,0 +1,4 @@
+set(MODULE_TESTS
+  mitkShortestPathCostFunctionLiveWireTest.cpp
+  mitkShortestPathImageFilterTest.cpp
+)
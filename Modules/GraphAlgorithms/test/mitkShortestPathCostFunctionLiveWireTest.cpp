@@ -0,0 +1,166 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkShortestPathCostFunctionLiveWire.h>
+
+#include <cmath>
+#include <map>
+
+namespace
+{
+  typedef itk::Image<float, 2> ImageType;
+  typedef ImageType::IndexType IndexType;
+
+  /** Gives access to the per pixel costs and the precomputed cost images. */
+  class LiveWireCostFunction : public itk::ShortestPathCostFunctionLiveWire<ImageType>
+  {
+  public:
+    typedef LiveWireCostFunction Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkFactorylessNewMacro(Self);
+
+    double GetPixelCost(const IndexType &p, bool useCostMap) { return this->ComputePixelCost(p, useCostMap); }
+
+    const CostImageType *GetCostImage(bool useCostMap) const
+    {
+      return useCostMap ? this->m_DynamicCostImage.GetPointer() : this->m_CostImage.GetPointer();
+    }
+  };
+}
+
+class mitkShortestPathCostFunctionLiveWireTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShortestPathCostFunctionLiveWireTestSuite);
+  MITK_TEST(TestCostImageEqualsPixelCosts);
+  MITK_TEST(TestDynamicCostImageEqualsPixelCosts);
+  MITK_TEST(TestCostsAreScaledByStepLength);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  ImageType::Pointer m_Image;
+  LiveWireCostFunction::Pointer m_CostFunction;
+
+  static IndexType MakeIndex(itk::IndexValueType x, itk::IndexValueType y)
+  {
+    IndexType index;
+    index[0] = x;
+    index[1] = y;
+    return index;
+  }
+
+  /** Pixels without gradient have undefined direction costs, which compare equal only as NaN. */
+  static void AssertEqualCosts(double expected, double actual)
+  {
+    if (std::isnan(expected))
+      CPPUNIT_ASSERT_MESSAGE("Cost is NaN", std::isnan(actual));
+    else
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, 1e-12);
+  }
+
+  /** Compares every pixel of the precomputed cost image with the costs computed for that pixel alone. */
+  void AssertCostImageEqualsPixelCosts(bool useCostMap)
+  {
+    const LiveWireCostFunction::CostImageType *costImage = m_CostFunction->GetCostImage(useCostMap);
+    CPPUNIT_ASSERT_MESSAGE("The costs are precomputed", costImage != nullptr);
+    CPPUNIT_ASSERT_EQUAL(m_Image->GetLargestPossibleRegion(), costImage->GetLargestPossibleRegion());
+
+    itk::ImageRegionConstIteratorWithIndex<LiveWireCostFunction::CostImageType> it(
+      costImage, costImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      AssertEqualCosts(m_CostFunction->GetPixelCost(it.GetIndex(), useCostMap), it.Get());
+  }
+
+public:
+  void setUp() override
+  {
+    ImageType::SizeType size;
+    size[0] = 57;
+    size[1] = 43;
+    m_Image = ImageType::New();
+    m_Image->SetRegions(ImageType::RegionType(size));
+    m_Image->Allocate();
+
+    // a bright disc on a ramp with some texture, so all features of the cost function vary over the image
+    itk::ImageRegionIteratorWithIndex<ImageType> it(m_Image, m_Image->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const double x = it.GetIndex()[0];
+      const double y = it.GetIndex()[1];
+      const bool disc = (x - 30) * (x - 30) + (y - 20) * (y - 20) < 144;
+      it.Set(static_cast<float>((disc ? 150.0 : 20.0) + 0.5 * x + 10.0 * std::sin(0.7 * x) * std::cos(0.4 * y)));
+    }
+
+    m_CostFunction = LiveWireCostFunction::New();
+    m_CostFunction->SetImage(m_Image);
+    m_CostFunction->SetStartIndex(MakeIndex(3, 4));
+    m_CostFunction->SetEndIndex(MakeIndex(50, 40));
+  }
+
+  void tearDown() override
+  {
+    m_CostFunction = nullptr;
+    m_Image = nullptr;
+  }
+
+  void TestCostImageEqualsPixelCosts()
+  {
+    m_CostFunction->Initialize();
+    this->AssertCostImageEqualsPixelCosts(false);
+  }
+
+  void TestDynamicCostImageEqualsPixelCosts()
+  {
+    std::map<int, int> costMap;
+    for (int key = 0; key < 200; key += 3)
+      costMap[key] = 1 + (key * 37) % 100;
+
+    m_CostFunction->SetDynamicCostMap(costMap);
+    m_CostFunction->SetCostMapMaximum(250.0);
+    m_CostFunction->Initialize();
+    this->AssertCostImageEqualsPixelCosts(true);
+
+    // switching back uses the costs without the map, without discarding the dynamic costs
+    m_CostFunction->SetUseCostMap(false);
+    m_CostFunction->Initialize();
+    this->AssertCostImageEqualsPixelCosts(false);
+    this->AssertCostImageEqualsPixelCosts(true);
+  }
+
+  void TestCostsAreScaledByStepLength()
+  {
+    m_CostFunction->Initialize();
+
+    const IndexType p = MakeIndex(20, 20);
+    for (itk::IndexValueType dy = -1; dy <= 1; ++dy)
+    {
+      for (itk::IndexValueType dx = -1; dx <= 1; ++dx)
+      {
+        if (dx == 0 && dy == 0)
+          continue;
+        const IndexType q = MakeIndex(p[0] + dx, p[1] + dy);
+        const double stepLength = (dx == 0 || dy == 0) ? 1.0 : std::sqrt(2.0);
+        AssertEqualCosts(stepLength * m_CostFunction->GetPixelCost(q, false), m_CostFunction->GetCost(p, q));
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShortestPathCostFunctionLiveWire)
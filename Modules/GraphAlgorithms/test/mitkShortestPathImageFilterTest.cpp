@@ -0,0 +1,234 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkShortestPathCostFunctionLiveWire.h>
+#include <itkShortestPathImageFilter.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  typedef itk::Image<float, 2> ImageType;
+  typedef ImageType::IndexType IndexType;
+  typedef std::vector<IndexType> PathType;
+
+  /** Costs of a synthetic image: the pixel value of the target pixel, scaled by the length of the step. */
+  class SyntheticCostFunction : public itk::ShortestPathCostFunction<ImageType>
+  {
+  public:
+    typedef SyntheticCostFunction Self;
+    typedef itk::ShortestPathCostFunction<ImageType> Superclass;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkFactorylessNewMacro(Self);
+
+    double GetCost(IndexType p1, IndexType p2) override
+    {
+      const double stepLength = (p1[0] == p2[0] || p1[1] == p2[1]) ? 1.0 : std::sqrt(2.0);
+      return stepLength * (MINIMUM_COST + this->m_Image->GetPixel(p2));
+    }
+
+    double GetMinCost() override { return MINIMUM_COST; }
+
+    void Initialize() override {}
+
+    bool IsSearchContinuable() const override { return m_SearchContinuable; }
+
+    void SetSearchContinuable(bool continuable) { m_SearchContinuable = continuable; }
+
+  private:
+    SyntheticCostFunction() : m_SearchContinuable(true) {}
+
+    static constexpr double MINIMUM_COST = 0.05;
+    bool m_SearchContinuable;
+  };
+
+  constexpr double SyntheticCostFunction::MINIMUM_COST;
+
+  /** Gives access to the id of the current search, which changes whenever a new search is started. */
+  class SearchIdFilter : public itk::ShortestPathImageFilter<ImageType, ImageType>
+  {
+  public:
+    typedef SearchIdFilter Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkFactorylessNewMacro(Self);
+
+    unsigned int GetSearchId() const { return this->m_SearchId; }
+  };
+}
+
+class mitkShortestPathImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShortestPathImageFilterTestSuite);
+  MITK_TEST(TestContinuedSearchEqualsNewSearch);
+  MITK_TEST(TestSearchIsNotContinuedWithoutOptIn);
+  MITK_TEST(TestContinuedLiveWireSearchEqualsNewSearch);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  ImageType::Pointer m_Image;
+  IndexType m_StartIndex;
+  std::vector<IndexType> m_EndIndices;
+
+  /** Pseudo random value in [0, 1) of a pixel. */
+  static float Noise(unsigned int x, unsigned int y)
+  {
+    unsigned int hash = x * 73856093u ^ y * 19349663u;
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    hash ^= hash >> 15;
+    return static_cast<float>(hash % 10007) / 10007.0f;
+  }
+
+  static IndexType MakeIndex(itk::IndexValueType x, itk::IndexValueType y)
+  {
+    IndexType index;
+    index[0] = x;
+    index[1] = y;
+    return index;
+  }
+
+  static itk::ShortestPathImageFilter<ImageType, ImageType>::Pointer CreateFilter(
+    itk::ShortestPathImageFilter<ImageType, ImageType> *filter,
+    itk::ShortestPathCostFunction<ImageType> *costFunction,
+    const ImageType *image)
+  {
+    filter->SetInput(image);
+    filter->SetCostFunction(costFunction);
+    filter->SetFullNeighborsMode(true);
+    filter->SetGraph_fullNeighbors(true);
+    filter->SetMakeOutputImage(false);
+    return filter;
+  }
+
+  /** Sum of the costs along path. */
+  static double GetPathCosts(itk::ShortestPathCostFunction<ImageType> *costFunction, const PathType &path)
+  {
+    double costs = 0.0;
+    for (size_t i = 1; i < path.size(); ++i)
+      costs += costFunction->GetCost(path[i - 1], path[i]);
+    return costs;
+  }
+
+  /** Runs a search from startIndex to endIndex with filter. */
+  static PathType FindPath(itk::ShortestPathImageFilter<ImageType, ImageType> *filter,
+                           itk::ShortestPathCostFunction<ImageType> *costFunction,
+                           const IndexType &startIndex,
+                           const IndexType &endIndex)
+  {
+    costFunction->SetStartIndex(startIndex);
+    costFunction->SetEndIndex(endIndex);
+    filter->SetStartIndex(startIndex);
+    filter->SetEndIndex(endIndex);
+    filter->Modified();
+    filter->Update();
+    return filter->GetVectorPath();
+  }
+
+  /**
+    Moves the end point of one filter over all m_EndIndices, as the live wire does, and compares every path and its
+    costs with the result of a new filter and cost function.
+  */
+  template <typename CreateCostFunction>
+  void CompareContinuedWithNewSearches(CreateCostFunction createCostFunction)
+  {
+    auto costFunction = createCostFunction();
+    auto continuedFilter = CreateFilter(SearchIdFilter::New(), costFunction, m_Image);
+
+    for (const IndexType &endIndex : m_EndIndices)
+    {
+      const PathType continuedPath = FindPath(continuedFilter, costFunction, m_StartIndex, endIndex);
+
+      auto newCostFunction = createCostFunction();
+      auto newFilter =
+        CreateFilter(itk::ShortestPathImageFilter<ImageType, ImageType>::New(), newCostFunction, m_Image);
+      const PathType newPath = FindPath(newFilter, newCostFunction, m_StartIndex, endIndex);
+
+      CPPUNIT_ASSERT_MESSAGE("A path is found", !newPath.empty());
+      CPPUNIT_ASSERT_EQUAL(newPath.size(), continuedPath.size());
+      for (size_t i = 0; i < newPath.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(newPath[i], continuedPath[i]);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(
+        GetPathCosts(newCostFunction, newPath), GetPathCosts(costFunction, continuedPath), 1e-9);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    ImageType::SizeType size;
+    size.Fill(64);
+    m_Image = ImageType::New();
+    m_Image->SetRegions(ImageType::RegionType(size));
+    m_Image->Allocate();
+
+    // noise with a high cost wall in the middle, which the paths to the right half have to go around
+    for (unsigned int y = 0; y < 64; ++y)
+    {
+      for (unsigned int x = 0; x < 64; ++x)
+      {
+        const bool wall = x >= 30 && x <= 33 && y < 50;
+        m_Image->SetPixel(MakeIndex(x, y), wall ? 20.0f : Noise(x, y));
+      }
+    }
+
+    m_StartIndex = MakeIndex(5, 5);
+
+    // the end point moves in small steps and jumps back to points of earlier searches, as the mouse does
+    m_EndIndices = {MakeIndex(10, 8),  MakeIndex(20, 10), MakeIndex(50, 10), MakeIndex(51, 11), MakeIndex(52, 13),
+                    MakeIndex(45, 40), MakeIndex(20, 10), MakeIndex(60, 60), MakeIndex(6, 5),   MakeIndex(25, 58),
+                    MakeIndex(50, 10), MakeIndex(63, 0)};
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void TestContinuedSearchEqualsNewSearch()
+  {
+    this->CompareContinuedWithNewSearches([]() { return SyntheticCostFunction::New(); });
+  }
+
+  void TestSearchIsNotContinuedWithoutOptIn()
+  {
+    auto costFunction = SyntheticCostFunction::New();
+    auto filter = SearchIdFilter::New();
+    CreateFilter(filter, costFunction, m_Image);
+
+    FindPath(filter, costFunction, m_StartIndex, m_EndIndices[0]);
+    const unsigned int firstSearchId = filter->GetSearchId();
+    FindPath(filter, costFunction, m_StartIndex, m_EndIndices[1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The search of an opting in cost function is continued", firstSearchId,
+                                 filter->GetSearchId());
+
+    costFunction->SetSearchContinuable(false);
+    FindPath(filter, costFunction, m_StartIndex, m_EndIndices[2]);
+    CPPUNIT_ASSERT_MESSAGE("Without opt-in, a new search is started", filter->GetSearchId() != firstSearchId);
+  }
+
+  void TestContinuedLiveWireSearchEqualsNewSearch()
+  {
+    const ImageType *image = m_Image;
+    this->CompareContinuedWithNewSearches([image]() {
+      auto costFunction = itk::ShortestPathCostFunctionLiveWire<ImageType>::New();
+      costFunction->SetImage(image);
+      return costFunction;
+    });
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShortestPathImageFilter)
@@ -24,6 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIOUtil.h>
 #include <mitkImageGenerator.h>
 #include <mitkImagePixelWriteAccessor.h>
+#include <mitkITKImageImport.h>
+
+#include <itkImageRegionIteratorWithIndex.h>
 
 #include <mitkPlanarFigureMaskGenerator.h>
 #include <mitkIgnorePixelMaskGenerator.h>
@@ -73,6 +76,7 @@ class mitkImageStatisticsCalculatorTestSuite : public mitk::TestFixture
   MITK_TEST(TestUS4DCylImageMaskStatistics_time1_label_2);
   MITK_TEST(TestUS4DCylIgnorePixelValueMaskStatistics_time1);
   MITK_TEST(TestUS4DCylSecondaryMaskStatistics_time1);
+  MITK_TEST(TestAllNegativeFloatImage);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -117,6 +121,8 @@ public:
   void TestUS4DCylIgnorePixelValueMaskStatistics_time1();
   void TestUS4DCylSecondaryMaskStatistics_time1();
 
+  void TestAllNegativeFloatImage();
+
   void TestDifferentNBinsForHistogramStatistics();
   void TestDifferentBinSizeForHistogramStatistic();
 
@@ -1833,4 +1839,50 @@ void mitkImageStatisticsCalculatorTestSuite::TestUninitializedImage()
   MITK_TEST_FOR_EXCEPTION_END(mitk::Exception)
 }
 
+void mitkImageStatisticsCalculatorTestSuite::TestAllNegativeFloatImage()
+{
+  /*****************************
+  * float image with only negative values, unmasked and masked
+  * -> the maximum has to be negative (the extrema were initialized with numeric_limits::min())
+  ******************************/
+  MITK_INFO << std::endl << "Test all negative float image: -----------------------------------------------------------------------------------";
+  typedef itk::Image<float, 3> FloatImageType;
+  FloatImageType::Pointer itkImage = FloatImageType::New();
+  FloatImageType::SizeType size = { { 5, 5, 5 } };
+  itkImage->SetRegions(size);
+  itkImage->Allocate();
+
+  // values -125 ... -1, the maximum is the last voxel
+  itk::ImageRegionIteratorWithIndex<FloatImageType> it(itkImage, itkImage->GetLargestPossibleRegion());
+  float value = -125.0f;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value++);
+  }
+  mitk::Image::Pointer image = mitk::GrabItkImageMemory(itkImage);
+  mitk::Image::Pointer mask = mitk::ImageGenerator::GenerateImageFromReference<unsigned char>(image, 1);
+
+  mitk::ImageMaskGenerator::Pointer imgMaskGen = mitk::ImageMaskGenerator::New();
+  imgMaskGen->SetImageMask(mask);
+
+  std::vector<mitk::ImageStatisticsContainer::Pointer> statisticsContainers;
+  statisticsContainers.push_back(ComputeStatisticsNew(image.GetPointer()));
+  statisticsContainers.push_back(ComputeStatisticsNew(image.GetPointer(), imgMaskGen.GetPointer()));
+
+  for (const auto &statisticsContainer : statisticsContainers)
+  {
+    auto stats = statisticsContainer->GetStatisticsForTimeStep(0);
+    auto min = stats.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MINIMUM());
+    auto max = stats.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MAXIMUM());
+    auto maxIndex = stats.GetValueConverted<mitk::ImageStatisticsContainer::IndexType>(mitk::ImageStatisticsConstants::MAXIMUMPOSITION());
+
+    MITK_TEST_CONDITION(min == -125.0, "calculated min: " << min << " expected min: " << -125.0);
+    MITK_TEST_CONDITION(max == -1.0, "calculated max: " << max << " expected max: " << -1.0);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      MITK_TEST_CONDITION(maxIndex[i] == 4, "maxIndex [" << i << "] = " << maxIndex[i] << " expected: " << 4);
+    }
+  }
+}
+
 MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsCalculator)
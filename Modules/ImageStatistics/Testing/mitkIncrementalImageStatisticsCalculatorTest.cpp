@@ -0,0 +1,291 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkIncrementalImageStatisticsCalculator.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageMaskGenerator.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageRegionModificationEvent.h>
+#include <mitkImageStatisticsCalculator.h>
+#include <mitkImageStatisticsConstants.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+class mitkIncrementalImageStatisticsCalculatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIncrementalImageStatisticsCalculatorTestSuite);
+  MITK_TEST(InitialComputationEqualsImageStatisticsCalculator);
+  MITK_TEST(RegionUpdatesEqualImageStatisticsCalculator);
+  MITK_TEST(RegionUpdatesRemovingExtremaAndLabels);
+  MITK_TEST(RegionModificationEventsUpdateStatistics);
+  MITK_TEST(ModificationWithoutEventIsDetected);
+  MITK_TEST(FailingRegionUpdateInObserverDoesNotThrow);
+  MITK_TEST(RegionUpdatesOfFloatImage);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_LabelImage;
+  mitk::IncrementalImageStatisticsCalculator::Pointer m_Calculator;
+
+  void FillLabel(const itk::ImageRegion<3> &region, unsigned short label)
+  {
+    mitk::ImagePixelWriteAccessor<unsigned short, 3> accessor(m_LabelImage);
+    for (unsigned int z = region.GetIndex(2); z < region.GetIndex(2) + region.GetSize(2); ++z)
+      for (unsigned int y = region.GetIndex(1); y < region.GetIndex(1) + region.GetSize(1); ++y)
+        for (unsigned int x = region.GetIndex(0); x < region.GetIndex(0) + region.GetSize(0); ++x)
+        {
+          itk::Index<3> index;
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          accessor.SetPixelByIndex(index, label);
+        }
+  }
+
+  itk::ImageRegion<3> CreateRegion(unsigned int startX,
+                                   unsigned int startY,
+                                   unsigned int startZ,
+                                   unsigned int sizeX,
+                                   unsigned int sizeY,
+                                   unsigned int sizeZ)
+  {
+    itk::ImageRegion<3> region;
+    region.SetIndex(0, startX);
+    region.SetIndex(1, startY);
+    region.SetIndex(2, startZ);
+    region.SetSize(0, sizeX);
+    region.SetSize(1, sizeY);
+    region.SetSize(2, sizeZ);
+    return region;
+  }
+
+  // edits the label image like a segmentation tool does, but without notifying the calculator
+  void EditWithRegionUpdate(const itk::ImageRegion<3> &region, unsigned short label)
+  {
+    m_Calculator->BeginRegionUpdate(region, 0);
+    this->FillLabel(region, label);
+    m_Calculator->EndRegionUpdate();
+  }
+
+  // compares the incrementally updated statistics with a full computation of ImageStatisticsCalculator using the
+  // label image as mask
+  void CompareWithImageStatisticsCalculator(mitk::ImageStatisticsContainer::LabelIndex label)
+  {
+    auto maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_LabelImage);
+
+    auto referenceCalculator = mitk::ImageStatisticsCalculator::New();
+    referenceCalculator->SetInputImage(m_Image);
+    referenceCalculator->SetMask(maskGenerator.GetPointer());
+    referenceCalculator->SetNBinsForHistogramStatistics(m_Calculator->GetNBinsForHistogramStatistics());
+
+    auto reference = referenceCalculator->GetStatistics(label)->GetStatisticsForTimeStep(0);
+    auto incremental = m_Calculator->GetStatistics(label)->GetStatisticsForTimeStep(0);
+
+    using VoxelCountType = mitk::ImageStatisticsContainer::VoxelCountType;
+    using RealType = mitk::ImageStatisticsContainer::RealType;
+    using IndexType = mitk::ImageStatisticsContainer::IndexType;
+
+    // ImageStatisticsCalculator derives the number of voxels from sum / mean, which may be off by one
+    const auto referenceCount =
+      reference.GetValueConverted<VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS());
+    const auto incrementalCount =
+      incremental.GetValueConverted<VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Number of voxels",
+                                         static_cast<double>(referenceCount),
+                                         static_cast<double>(incrementalCount),
+                                         1.);
+
+    for (const auto &name : {mitk::ImageStatisticsConstants::MEAN(),
+                             mitk::ImageStatisticsConstants::MINIMUM(),
+                             mitk::ImageStatisticsConstants::MAXIMUM(),
+                             mitk::ImageStatisticsConstants::STANDARDDEVIATION(),
+                             mitk::ImageStatisticsConstants::VARIANCE(),
+                             mitk::ImageStatisticsConstants::SKEWNESS(),
+                             mitk::ImageStatisticsConstants::KURTOSIS(),
+                             mitk::ImageStatisticsConstants::RMS(),
+                             mitk::ImageStatisticsConstants::MPP(),
+                             mitk::ImageStatisticsConstants::MEDIAN(),
+                             mitk::ImageStatisticsConstants::ENTROPY(),
+                             mitk::ImageStatisticsConstants::UNIFORMITY(),
+                             mitk::ImageStatisticsConstants::UPP()})
+    {
+      const auto expected = reference.GetValueConverted<RealType>(name);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+        name, expected, incremental.GetValueConverted<RealType>(name), 1e-9 * std::max(1., std::abs(expected)));
+    }
+
+    for (const auto &name :
+         {mitk::ImageStatisticsConstants::MINIMUMPOSITION(), mitk::ImageStatisticsConstants::MAXIMUMPOSITION()})
+    {
+      CPPUNIT_ASSERT_MESSAGE(name,
+                             reference.GetValueConverted<IndexType>(name) ==
+                               incremental.GetValueConverted<IndexType>(name));
+    }
+
+    const auto *referenceHistogram = reference.m_Histogram.GetPointer();
+    const auto *incrementalHistogram = incremental.m_Histogram.GetPointer();
+    CPPUNIT_ASSERT_EQUAL(referenceHistogram->Size(), incrementalHistogram->Size());
+    for (unsigned int bin = 0; bin < referenceHistogram->Size(); ++bin)
+    {
+      CPPUNIT_ASSERT_EQUAL(referenceHistogram->GetFrequency(bin), incrementalHistogram->GetFrequency(bin));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(
+        referenceHistogram->GetBinMin(0, bin), incrementalHistogram->GetBinMin(0, bin), mitk::eps);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    // few distinct values, so that the extrema occur several times and their positions are ambiguous
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(20, 20, 20, 1, 1, 1, 1, 30, 1);
+    m_LabelImage = mitk::ImageGenerator::GenerateImageFromReference<unsigned short>(m_Image, 0);
+    this->FillLabel(this->CreateRegion(2, 2, 2, 10, 10, 10), 1);
+    this->FillLabel(this->CreateRegion(14, 3, 5, 4, 12, 6), 2);
+
+    m_Calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    m_Calculator->SetInputImage(m_Image);
+    m_Calculator->SetLabelImage(m_LabelImage);
+  }
+
+  void tearDown() override
+  {
+    m_Calculator = nullptr;
+    m_Image = nullptr;
+    m_LabelImage = nullptr;
+  }
+
+  void InitialComputationEqualsImageStatisticsCalculator()
+  {
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+
+    m_Calculator->SetNBinsForHistogramStatistics(17);
+    this->CompareWithImageStatisticsCalculator(1);
+  }
+
+  void RegionUpdatesEqualImageStatisticsCalculator()
+  {
+    auto container = m_Calculator->GetStatistics(1);
+
+    // grow label 1 slice by slice, like a segmentation tool
+    for (unsigned int z = 8; z < 16; ++z)
+    {
+      this->EditWithRegionUpdate(this->CreateRegion(6, 6, z, 9, 7, 1), 1);
+      CPPUNIT_ASSERT_MESSAGE("Container is updated in place", container == m_Calculator->GetStatistics(1));
+      this->CompareWithImageStatisticsCalculator(1);
+      this->CompareWithImageStatisticsCalculator(2);
+    }
+
+    // erase a part of label 1
+    this->EditWithRegionUpdate(this->CreateRegion(0, 0, 4, 20, 20, 2), 0);
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+
+    // the dirty region may be larger than the modified voxels and may exceed the image
+    this->EditWithRegionUpdate(this->CreateRegion(15, 15, 15, 10, 10, 10), 2);
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+  }
+
+  void RegionUpdatesRemovingExtremaAndLabels()
+  {
+    m_Calculator->GetStatistics(1);
+
+    // overwrites most of label 1, including the first positions of its extrema
+    this->EditWithRegionUpdate(this->CreateRegion(2, 2, 2, 9, 9, 9), 2);
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+
+    // removes label 1 completely
+    this->EditWithRegionUpdate(this->CreateRegion(0, 0, 0, 20, 20, 12), 0);
+    const auto statistics = m_Calculator->GetStatistics(1)->GetStatisticsForTimeStep(0);
+    CPPUNIT_ASSERT_EQUAL(mitk::ImageStatisticsContainer::VoxelCountType(0),
+                         statistics.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+                           mitk::ImageStatisticsConstants::NUMBEROFVOXELS()));
+    this->CompareWithImageStatisticsCalculator(2);
+
+    // and adds it again
+    this->EditWithRegionUpdate(this->CreateRegion(3, 4, 5, 3, 3, 3), 1);
+    this->CompareWithImageStatisticsCalculator(1);
+  }
+
+  void RegionModificationEventsUpdateStatistics()
+  {
+    m_Calculator->GetStatistics(1);
+
+    // the events sent by the segmentation tools (SegTool2D, DiffSliceOperationApplier)
+    for (unsigned int z = 0; z < 20; z += 3)
+    {
+      auto region = this->CreateRegion(0, 5, z, 20, 4, 1);
+      m_LabelImage->InvokeEvent(mitk::ImageRegionAboutToBeModifiedEvent(region, 0));
+      this->FillLabel(region, z % 2 == 0 ? 1 : 2);
+      m_LabelImage->Modified();
+      m_LabelImage->InvokeEvent(mitk::ImageRegionModifiedEvent(region, 0));
+
+      this->CompareWithImageStatisticsCalculator(1);
+      this->CompareWithImageStatisticsCalculator(2);
+    }
+  }
+
+  void ModificationWithoutEventIsDetected()
+  {
+    m_Calculator->GetStatistics(1);
+
+    this->FillLabel(this->CreateRegion(0, 0, 0, 5, 5, 5), 1);
+    m_LabelImage->Modified();
+
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+  }
+
+  void FailingRegionUpdateInObserverDoesNotThrow()
+  {
+    m_Calculator->GetStatistics(1);
+
+    // the time step does not exist, the update fails inside of the observers of the segmentation tool's events
+    auto region = this->CreateRegion(0, 0, 0, 20, 20, 5);
+    CPPUNIT_ASSERT_NO_THROW(m_LabelImage->InvokeEvent(mitk::ImageRegionAboutToBeModifiedEvent(region, 3)));
+    this->FillLabel(region, 2);
+    m_LabelImage->Modified();
+    CPPUNIT_ASSERT_NO_THROW(m_LabelImage->InvokeEvent(mitk::ImageRegionModifiedEvent(region, 3)));
+
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+  }
+
+  void RegionUpdatesOfFloatImage()
+  {
+    // (almost) every value occurs once, so most edits remove an extremum of a label
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<float>(20, 20, 20, 1, 1, 1, 1, 1000.f, -1000.f);
+    m_Calculator->SetInputImage(m_Image);
+    m_Calculator->GetStatistics(1);
+
+    for (unsigned int z = 2; z < 12; z += 3)
+    {
+      this->EditWithRegionUpdate(this->CreateRegion(2, 2, z, 10, 10, 2), 2);
+      this->CompareWithImageStatisticsCalculator(1);
+      this->CompareWithImageStatisticsCalculator(2);
+    }
+
+    this->EditWithRegionUpdate(this->CreateRegion(4, 4, 4, 12, 12, 3), 1);
+    this->CompareWithImageStatisticsCalculator(1);
+    this->CompareWithImageStatisticsCalculator(2);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIncrementalImageStatisticsCalculator)
@@ -1,5 +1,6 @@
 set(CPP_FILES
   mitkImageStatisticsCalculator.cpp
+  mitkIncrementalImageStatisticsCalculator.cpp
   mitkImageStatisticsContainer.cpp
   mitkPointSetStatisticsCalculator.cpp
   mitkPointSetDifferenceStatisticsCalculator.cpp
@@ -22,6 +23,7 @@ set(CPP_FILES
 
 set(H_FILES
   mitkImageStatisticsCalculator.h
+  mitkIncrementalImageStatisticsCalculator.h
   mitkImageStatisticsContainer.h
   mitkPointSetDifferenceStatisticsCalculator.h
   mitkPointSetStatisticsCalculator.h
@@ -470,7 +470,8 @@ namespace itk
     ImageScanlineConstIterator< TLabelImage > labelIt (this->GetLabelInput(),
                                                        outputRegionForThread);
 
-    StatisticsMapIterator mapIt;
+    StatisticsMapIterator mapIt = m_LabelStatisticsPerThread[threadId].end();
+    LabelPixelType lastLabel = 0;
 
     // support progress methods/callbacks
     const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
@@ -487,8 +488,12 @@ namespace itk
 
         const LabelPixelType & label = labelIt.Get();
 
-        // is the label already in this thread?
-        mapIt = m_LabelStatisticsPerThread[threadId].find(label);
+        // is the label already in this thread? (labels are spatially coherent, so the previous entry is usually right)
+        if ( mapIt == m_LabelStatisticsPerThread[threadId].end() || label != lastLabel )
+          {
+          mapIt = m_LabelStatisticsPerThread[threadId].find(label);
+          lastLabel = label;
+          }
         if ( mapIt == m_LabelStatisticsPerThread[threadId].end() )
           {
           // if global histogram parameters are set and preferred then use them
@@ -554,9 +559,9 @@ namespace itk
           }
 
         // bounding box is min,max pairs
+        const typename TInputImage::IndexType & index = it.GetIndex();
         for ( unsigned int i = 0; i < ( 2 * TInputImage::ImageDimension ); i += 2 )
           {
-          const typename TInputImage::IndexType & index = it.GetIndex();
           if ( labelStats.m_BoundingBox[i] > index[i / 2] )
             {
             labelStats.m_BoundingBox[i] = index[i / 2];
@@ -567,11 +572,12 @@ namespace itk
             }
           }
 
+        const RealType valueSquared = value * value;
         labelStats.m_Sum += value;
-        labelStats.m_SumOfSquares += ( value * value );
+        labelStats.m_SumOfSquares += valueSquared;
         labelStats.m_Count++;
-        labelStats.m_SumOfCubes += std::pow(value, 3.);
-        labelStats.m_SumOfQuadruples += std::pow(value, 4.);
+        labelStats.m_SumOfCubes += valueSquared * value;
+        labelStats.m_SumOfQuadruples += valueSquared * valueSquared;
 
         if (value > 0)
         {
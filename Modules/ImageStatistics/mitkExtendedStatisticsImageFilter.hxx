@@ -332,10 +332,11 @@ namespace itk
           ++countOfPositivePixels;
         }
 
+        const RealType realValueSquared = realValue * realValue;
         sum += realValue;
-        sumOfSquares += ( realValue * realValue );
-        sumOfCubes += std::pow(realValue, 3.);
-        sumOfQuadruples += std::pow(realValue, 4.);
+        sumOfSquares += realValueSquared;
+        sumOfCubes += realValueSquared * realValue;
+        sumOfQuadruples += realValueSquared * realValueSquared;
         ++count;
         ++it;
         }
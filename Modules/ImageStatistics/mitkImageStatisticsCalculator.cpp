@@ -207,10 +207,8 @@ namespace mitk
     statisticsFilter->SetCoordinateTolerance(0.001);
     statisticsFilter->SetDirectionTolerance(0.001);
 
-    // TODO: this is single threaded. Implement our own image filter that does this multi threaded
-    //        typename itk::MinimumMaximumImageCalculator<ImageType>::Pointer imgMinMaxFilter =
-    //        itk::MinimumMaximumImageCalculator<ImageType>::New(); imgMinMaxFilter->SetImage(image);
-    //        imgMinMaxFilter->Compute();
+    // MinMaxImageFilterWithIndex is multi threaded (per-thread extrema, reduced in AfterThreadedGenerateData). Its
+    // result is needed up front because it defines the histogram range of the statistics pass below.
     vnl_vector<int> minIndex, maxIndex;
 
     typename MinMaxFilterType::Pointer minMaxFilter = MinMaxFilterType::New();
@@ -222,9 +220,6 @@ namespace mitk
     typename ImageType::IndexType tmpMinIndex = minMaxFilter->GetMinIndex();
     typename ImageType::IndexType tmpMaxIndex = minMaxFilter->GetMaxIndex();
 
-    //        typename ImageType::IndexType tmpMinIndex = imgMinMaxFilter->GetIndexOfMinimum();
-    //        typename ImageType::IndexType tmpMaxIndex = imgMinMaxFilter->GetIndexOfMaximum();
-
     minIndex.set_size(tmpMaxIndex.GetIndexDimension());
     maxIndex.set_size(tmpMaxIndex.GetIndexDimension());
 
@@ -133,7 +133,7 @@ namespace mitk
   {
     if (timeStep < this->GetTimeSteps())
     {
-      m_TimeStepMap.emplace(timeStep, statistics);
+      m_TimeStepMap[timeStep] = statistics;
       this->Modified();
     }
     else
@@ -136,7 +136,7 @@ namespace mitk
     const StatisticsObject& GetStatisticsForTimeStep(TimeStepType timeStep) const;
 
     /**
-    @brief Sets the statisticObject for the given Timestep
+    @brief Sets the statisticObject for the given Timestep. Existing statistics of this timestep are replaced.
     @pre timeStep must be valid
     */
     void SetStatisticsForTimeStep(TimeStepType timeStep, StatisticsObject statistics);
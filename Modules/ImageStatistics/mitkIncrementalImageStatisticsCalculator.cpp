@@ -0,0 +1,963 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkIncrementalImageStatisticsCalculator.h"
+#include <mitkHistogramStatisticsCalculator.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkImageRegionModificationEvent.h>
+#include <mitkImageStatisticsConstants.h>
+#include <mitkImageTimeSelector.h>
+#include <mitkImageToItk.h>
+
+#include <itkCommand.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+
+#include <limits>
+
+namespace
+{
+  // regions are processed in chunks of whole slices with at most this many voxels, so that the label values of a
+  // chunk can be buffered without copying the label image
+  const itk::SizeValueType MaximumVoxelsPerChunk = 1 << 20;
+
+  std::vector<itk::ImageRegion<3>> SplitIntoChunks(const itk::ImageRegion<3> &region)
+  {
+    std::vector<itk::ImageRegion<3>> chunks;
+    const itk::SizeValueType voxelsPerSlice = region.GetSize(0) * region.GetSize(1);
+    if (voxelsPerSlice == 0 || region.GetSize(2) == 0)
+    {
+      return chunks;
+    }
+
+    const itk::SizeValueType slicesPerChunk = std::max<itk::SizeValueType>(1, MaximumVoxelsPerChunk / voxelsPerSlice);
+    for (itk::SizeValueType z = 0; z < region.GetSize(2); z += slicesPerChunk)
+    {
+      itk::ImageRegion<3> chunk = region;
+      chunk.SetIndex(2, region.GetIndex(2) + z);
+      chunk.SetSize(2, std::min(slicesPerChunk, region.GetSize(2) - z));
+      chunks.push_back(chunk);
+    }
+    return chunks;
+  }
+
+  itk::ImageRegion<3> GetLargestPossibleRegion3D(const mitk::Image *image)
+  {
+    itk::ImageRegion<3> region;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      region.SetSize(i, image->GetDimension() > i ? image->GetDimension(i) : 1);
+    }
+    return region;
+  }
+
+  // true if index a comes before index b in image (raster) order
+  bool IsBefore(const itk::Index<3> &a, const itk::Index<3> &b)
+  {
+    for (int i = 2; i >= 0; --i)
+    {
+      if (a[i] != b[i])
+      {
+        return a[i] < b[i];
+      }
+    }
+    return false;
+  }
+
+  mitk::ImageStatisticsContainer::HistogramType::Pointer CreateHistogram(double minimum,
+                                                                         double maximum,
+                                                                         unsigned int nBins)
+  {
+    typedef mitk::ImageStatisticsContainer::HistogramType HistogramType;
+    HistogramType::Pointer histogram = HistogramType::New();
+    HistogramType::SizeType hsize;
+    HistogramType::MeasurementVectorType lb;
+    HistogramType::MeasurementVectorType ub;
+    hsize.SetSize(1);
+    lb.SetSize(1);
+    ub.SetSize(1);
+    histogram->SetMeasurementVectorSize(1);
+    hsize[0] = nBins;
+    lb[0] = minimum;
+    ub[0] = maximum;
+    histogram->Initialize(hsize, lb, ub);
+    return histogram;
+  }
+
+  // bin of the label histogram, which spans the extrema of the label, so every value of the label has one
+  bool GetHistogramIndex(const mitk::ImageStatisticsContainer::HistogramType *histogram,
+                         double value,
+                         mitk::ImageStatisticsContainer::HistogramType::IndexType &index)
+  {
+    mitk::ImageStatisticsContainer::HistogramType::MeasurementVectorType measurement(1);
+    measurement[0] = value;
+    return histogram->GetIndex(measurement, index);
+  }
+}
+
+namespace mitk
+{
+  IncrementalImageStatisticsCalculator::LabelAccumulator::LabelAccumulator()
+    : m_Count(0),
+      m_Sum(0.),
+      m_SumOfSquares(0.),
+      m_SumOfCubes(0.),
+      m_SumOfQuadruples(0.),
+      m_SumOfPositivePixels(0.),
+      m_PositivePixelCount(0),
+      m_Minimum(std::numeric_limits<double>::max()),
+      m_Maximum(std::numeric_limits<double>::lowest()),
+      m_MinimumCount(0),
+      m_MaximumCount(0),
+      m_ExtremaValid(true),
+      m_MinIndexValid(false),
+      m_MaxIndexValid(false),
+      m_HistogramValid(false)
+  {
+    m_MinIndex.Fill(0);
+    m_MaxIndex.Fill(0);
+    m_BoundingBoxMin.Fill(itk::NumericTraits<itk::IndexValueType>::max());
+    m_BoundingBoxMax.Fill(itk::NumericTraits<itk::IndexValueType>::NonpositiveMin());
+  }
+
+  IncrementalImageStatisticsCalculator::IncrementalImageStatisticsCalculator()
+    : m_nBinsForHistogramStatistics(100),
+      m_ImageMTime(0),
+      m_LabelImageMTime(0),
+      m_RegionUpdatePending(false),
+      m_PendingTimeStep(0),
+      m_RegionAboutToBeModifiedTag(0),
+      m_RegionModifiedTag(0),
+      m_ModificationCount(0)
+  {
+  }
+
+  IncrementalImageStatisticsCalculator::~IncrementalImageStatisticsCalculator()
+  {
+    this->RemoveLabelImageObservers();
+  }
+
+  void IncrementalImageStatisticsCalculator::SetInputImage(mitk::Image::ConstPointer image)
+  {
+    if (image != m_Image)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Image = image;
+      this->ResetAccumulators();
+      this->Modified();
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::SetLabelImage(mitk::Image::ConstPointer labelImage)
+  {
+    if (labelImage == m_LabelImage)
+    {
+      return;
+    }
+
+    this->RemoveLabelImageObservers();
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_LabelImage = labelImage;
+      this->ResetAccumulators();
+    }
+
+    if (m_LabelImage.IsNotNull())
+    {
+      // the events are sent by the segmentation tools, which only have a non-const pointer to the image
+      auto *observedImage = const_cast<mitk::Image *>(m_LabelImage.GetPointer());
+
+      auto aboutToBeModifiedCommand = itk::MemberCommand<Self>::New();
+      aboutToBeModifiedCommand->SetCallbackFunction(this, &Self::OnRegionAboutToBeModified);
+      m_RegionAboutToBeModifiedTag =
+        observedImage->AddObserver(ImageRegionAboutToBeModifiedEvent(), aboutToBeModifiedCommand);
+
+      auto modifiedCommand = itk::MemberCommand<Self>::New();
+      modifiedCommand->SetCallbackFunction(this, &Self::OnRegionModified);
+      m_RegionModifiedTag = observedImage->AddObserver(ImageRegionModifiedEvent(), modifiedCommand);
+    }
+
+    this->Modified();
+  }
+
+  void IncrementalImageStatisticsCalculator::RemoveLabelImageObservers()
+  {
+    if (m_LabelImage.IsNotNull())
+    {
+      auto *observedImage = const_cast<mitk::Image *>(m_LabelImage.GetPointer());
+      observedImage->RemoveObserver(m_RegionAboutToBeModifiedTag);
+      observedImage->RemoveObserver(m_RegionModifiedTag);
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::SetNBinsForHistogramStatistics(unsigned int nBins)
+  {
+    if (nBins != m_nBinsForHistogramStatistics)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_nBinsForHistogramStatistics = nBins;
+      this->ResetAccumulators();
+      this->Modified();
+    }
+  }
+
+  unsigned int IncrementalImageStatisticsCalculator::GetNBinsForHistogramStatistics() const
+  {
+    return m_nBinsForHistogramStatistics;
+  }
+
+  void IncrementalImageStatisticsCalculator::Reset()
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    this->ResetAccumulators();
+  }
+
+  void IncrementalImageStatisticsCalculator::ResetAccumulators()
+  {
+    // the containers are kept, they are refilled in place by the next full computation
+    m_Accumulators.clear();
+    m_RegionUpdatePending = false;
+    m_PendingLabels.clear();
+    ++m_ModificationCount;
+  }
+
+  IncrementalImageStatisticsCalculator::Inputs IncrementalImageStatisticsCalculator::GetInputs() const
+  {
+    Inputs inputs;
+    inputs.m_Image = m_Image;
+    inputs.m_LabelImage = m_LabelImage;
+    inputs.m_nBinsForHistogramStatistics = m_nBinsForHistogramStatistics;
+    return inputs;
+  }
+
+  void IncrementalImageStatisticsCalculator::BeginRegionUpdate(const RegionType &region, TimeStepType timeStep)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ++m_ModificationCount;
+
+    if (m_RegionUpdatePending)
+    {
+      // the previous modification was not finished, its region cannot be restored
+      MITK_WARN << "BeginRegionUpdate called twice without EndRegionUpdate, statistics will be recomputed";
+      this->ResetAccumulators();
+      return;
+    }
+
+    if (m_Accumulators.empty())
+    {
+      // nothing computed yet, the next GetStatistics() will do a full computation anyway
+      return;
+    }
+
+    if (m_Image->GetMTime() != m_ImageMTime || m_LabelImage->GetMTime() != m_LabelImageMTime)
+    {
+      // modified without notification, the accumulators do not describe the current voxels any more
+      this->ResetAccumulators();
+      return;
+    }
+
+    if (timeStep >= m_Accumulators.size())
+    {
+      this->ResetAccumulators();
+      mitkThrow() << "Invalid time step " << timeStep;
+    }
+
+    m_PendingRegion = region;
+    if (!m_PendingRegion.Crop(GetLargestPossibleRegion3D(m_LabelImage)))
+    {
+      return;
+    }
+    m_PendingTimeStep = timeStep;
+    m_PendingLabels.clear();
+    m_RegionUpdatePending = true;
+
+    try
+    {
+      this->AccumulateRegion(this->GetInputs(),
+                             m_PendingRegion,
+                             m_PendingTimeStep,
+                             &m_Accumulators[m_PendingTimeStep],
+                             &m_PendingLabels,
+                             true);
+    }
+    catch (...)
+    {
+      // the region is only partially removed, so the accumulators cannot be used any more
+      this->ResetAccumulators();
+      throw;
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::EndRegionUpdate()
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ++m_ModificationCount;
+
+    if (!m_RegionUpdatePending)
+    {
+      return;
+    }
+
+    try
+    {
+      const Inputs inputs = this->GetInputs();
+      AccumulatorMapType *accumulators = &m_Accumulators[m_PendingTimeStep];
+      this->AccumulateRegion(inputs, m_PendingRegion, m_PendingTimeStep, accumulators, &m_PendingLabels, false);
+      this->CompleteLabels(inputs, m_PendingTimeStep, accumulators, m_PendingLabels);
+      this->UpdateContainers(m_PendingTimeStep, m_PendingLabels);
+    }
+    catch (...)
+    {
+      this->ResetAccumulators();
+      throw;
+    }
+
+    m_ImageMTime = m_Image->GetMTime();
+    m_LabelImageMTime = m_LabelImage->GetMTime();
+    m_RegionUpdatePending = false;
+    m_PendingLabels.clear();
+  }
+
+  // The observers are called from within the code modifying the label image (e.g. SegTool2D::WriteSliceToVolume),
+  // which must not be aborted because of the statistics. A failed update has reset the accumulators, so the next
+  // call of GetStatistics() does a full computation.
+  void IncrementalImageStatisticsCalculator::OnRegionAboutToBeModified(itk::Object *, const itk::EventObject &event)
+  {
+    const auto *modificationEvent = dynamic_cast<const ImageRegionModificationEvent *>(&event);
+    if (modificationEvent == nullptr)
+    {
+      return;
+    }
+
+    try
+    {
+      this->BeginRegionUpdate(modificationEvent->GetRegion(), modificationEvent->GetTimeStep());
+    }
+    catch (const std::exception &e)
+    {
+      MITK_WARN << "Incremental statistics update failed, statistics will be recomputed: " << e.what();
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::OnRegionModified(itk::Object *, const itk::EventObject &)
+  {
+    try
+    {
+      this->EndRegionUpdate();
+    }
+    catch (const std::exception &e)
+    {
+      MITK_WARN << "Incremental statistics update failed, statistics will be recomputed: " << e.what();
+    }
+  }
+
+  ImageStatisticsContainer::Pointer IncrementalImageStatisticsCalculator::GetStatistics(LabelIndex label)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+      if (m_Image.IsNull() || m_LabelImage.IsNull())
+      {
+        mitkThrow() << "Input image and label image have to be set";
+      }
+
+      if (!m_Accumulators.empty() && m_Image->GetMTime() == m_ImageMTime &&
+          m_LabelImage->GetMTime() == m_LabelImageMTime)
+      {
+        break;
+      }
+
+      // A full computation supersedes a pending region update. If the modification is still in progress, the
+      // modification time of the label image changes afterwards and the statistics are computed again.
+      m_RegionUpdatePending = false;
+      m_PendingLabels.clear();
+
+      const Inputs inputs = this->GetInputs();
+      const unsigned long modificationCount = m_ModificationCount;
+      const unsigned long imageMTime = m_Image->GetMTime();
+      const unsigned long labelImageMTime = m_LabelImage->GetMTime();
+
+      // computed without holding the mutex, so region updates and other threads are not blocked meanwhile
+      lock.unlock();
+      std::vector<AccumulatorMapType> accumulators = this->ComputeAccumulators(inputs);
+      lock.lock();
+
+      if (modificationCount != m_ModificationCount)
+      {
+        // the inputs were changed or modified by a region update meanwhile
+        continue;
+      }
+
+      m_Accumulators.swap(accumulators);
+      m_ImageMTime = imageMTime;
+      m_LabelImageMTime = labelImageMTime;
+
+      for (TimeStepType timeStep = 0; timeStep < m_Accumulators.size(); ++timeStep)
+      {
+        std::set<LabelPixelType> labels;
+        for (const auto &labelAccumulator : m_Accumulators[timeStep])
+        {
+          labels.insert(labelAccumulator.first);
+        }
+
+        // labels that vanished since the last computation get an empty statistics object
+        for (const auto &container : m_StatisticContainers)
+        {
+          if (container.second->TimeStepExists(timeStep))
+          {
+            labels.insert(static_cast<LabelPixelType>(container.first));
+          }
+        }
+
+        this->UpdateContainers(timeStep, labels);
+      }
+    }
+
+    auto it = m_StatisticContainers.find(label);
+    if (it == m_StatisticContainers.end())
+    {
+      // the label does not occur (yet), the container is filled as soon as voxels are assigned to it
+      auto container = ImageStatisticsContainer::New();
+      container->SetTimeGeometry(const_cast<mitk::TimeGeometry *>(m_Image->GetTimeGeometry()));
+      it = m_StatisticContainers.emplace(label, container).first;
+    }
+    return it->second;
+  }
+
+  std::vector<IncrementalImageStatisticsCalculator::AccumulatorMapType>
+    IncrementalImageStatisticsCalculator::ComputeAccumulators(const Inputs &inputs) const
+  {
+    if (!inputs.m_Image->IsInitialized() || !inputs.m_LabelImage->IsInitialized())
+    {
+      mitkThrow() << "Image not initialized!";
+    }
+
+    if (inputs.m_Image->GetTimeSteps() != inputs.m_LabelImage->GetTimeSteps())
+    {
+      mitkThrow() << "Input image and label image differ in the number of time steps";
+    }
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (inputs.m_Image->GetDimension(i) != inputs.m_LabelImage->GetDimension(i))
+      {
+        mitkThrow() << "Input image and label image differ in size";
+      }
+    }
+
+    std::vector<AccumulatorMapType> accumulators(inputs.m_Image->GetTimeSteps());
+    for (TimeStepType timeStep = 0; timeStep < accumulators.size(); ++timeStep)
+    {
+      std::set<LabelPixelType> labels;
+      this->AccumulateRegion(inputs,
+                             GetLargestPossibleRegion3D(inputs.m_LabelImage),
+                             timeStep,
+                             &accumulators[timeStep],
+                             &labels,
+                             false);
+      this->CompleteLabels(inputs, timeStep, &accumulators[timeStep], labels);
+    }
+    return accumulators;
+  }
+
+  mitk::Image::Pointer IncrementalImageStatisticsCalculator::GetImageTimeStep(const mitk::Image *image,
+                                                                              TimeStepType timeStep) const
+  {
+    // the time selector shares the voxel buffer of the input, no voxels are copied
+    ImageTimeSelector::Pointer imgTimeSel = ImageTimeSelector::New();
+    imgTimeSel->SetInput(image);
+    imgTimeSel->SetTimeNr(timeStep);
+    imgTimeSel->UpdateLargestPossibleRegion();
+    return imgTimeSel->GetOutput();
+  }
+
+  void IncrementalImageStatisticsCalculator::AccumulateRegion(const Inputs &inputs,
+                                                              const RegionType &region,
+                                                              TimeStepType timeStep,
+                                                              AccumulatorMapType *accumulators,
+                                                              std::set<LabelPixelType> *modifiedLabels,
+                                                              bool subtract) const
+  {
+    mitk::Image::Pointer imageTimeStep = this->GetImageTimeStep(inputs.m_Image, timeStep);
+    mitk::Image::Pointer labelTimeStep = this->GetImageTimeStep(inputs.m_LabelImage, timeStep);
+    const mitk::Image *constImageTimeStep = imageTimeStep.GetPointer();
+    const mitk::Image *constLabelTimeStep = labelTimeStep.GetPointer();
+
+    std::vector<LabelPixelType> labels;
+    for (const auto &chunk : SplitIntoChunks(region))
+    {
+      AccessFixedDimensionByItk_n(constLabelTimeStep, InternalExtractLabels, 3, (chunk, &labels));
+      AccessFixedDimensionByItk_n(
+        constImageTimeStep, InternalAccumulateRegion, 3, (&labels, chunk, accumulators, modifiedLabels, subtract));
+    }
+  }
+
+  template <typename TPixel>
+  void IncrementalImageStatisticsCalculator::InternalExtractLabels(const itk::Image<TPixel, 3> *labelImage,
+                                                                   const RegionType &region,
+                                                                   std::vector<LabelPixelType> *labels) const
+  {
+    labels->resize(region.GetNumberOfPixels());
+
+    itk::ImageRegionConstIterator<itk::Image<TPixel, 3>> labelIt(labelImage, region);
+    for (auto labelValue = labels->begin(); !labelIt.IsAtEnd(); ++labelIt, ++labelValue)
+    {
+      *labelValue = static_cast<LabelPixelType>(labelIt.Get());
+    }
+  }
+
+  template <typename TPixel>
+  void IncrementalImageStatisticsCalculator::InternalAccumulateRegion(const itk::Image<TPixel, 3> *image,
+                                                                      const std::vector<LabelPixelType> *labels,
+                                                                      const RegionType &region,
+                                                                      AccumulatorMapType *accumulators,
+                                                                      std::set<LabelPixelType> *modifiedLabels,
+                                                                      bool subtract) const
+  {
+    itk::ImageRegionConstIteratorWithIndex<itk::Image<TPixel, 3>> it(image, region);
+    HistogramType::IndexType histogramIndex(1);
+
+    LabelAccumulator *accumulator = nullptr;
+    LabelPixelType lastLabel = 0;
+
+    for (auto labelValue = labels->cbegin(); !it.IsAtEnd(); ++it, ++labelValue)
+    {
+      const LabelPixelType label = *labelValue;
+      if (label == 0)
+      {
+        continue;
+      }
+
+      // labels are spatially coherent, so only look the label up if it differs from the previous voxel
+      if (accumulator == nullptr || label != lastLabel)
+      {
+        accumulator = &((*accumulators)[label]);
+        lastLabel = label;
+        modifiedLabels->insert(label);
+      }
+
+      const double value = static_cast<double>(it.Get());
+      const IndexType &index = it.GetIndex();
+
+      if (subtract)
+      {
+        if (accumulator->m_Count == 0 || (accumulator->m_ExtremaValid &&
+                                          (value < accumulator->m_Minimum || value > accumulator->m_Maximum)))
+        {
+          mitkThrow() << "Statistics are out of sync with the label image";
+        }
+        --accumulator->m_Count;
+      }
+      else
+      {
+        if (accumulator->m_Count == 0)
+        {
+          // start from scratch, this drops the rounding errors of the sums and the old bounding box
+          *accumulator = LabelAccumulator();
+        }
+        ++accumulator->m_Count;
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          accumulator->m_BoundingBoxMin[i] = std::min(accumulator->m_BoundingBoxMin[i], index[i]);
+          accumulator->m_BoundingBoxMax[i] = std::max(accumulator->m_BoundingBoxMax[i], index[i]);
+        }
+      }
+
+      const double sign = subtract ? -1. : 1.;
+      const double valueSquared = value * value;
+      accumulator->m_Sum += sign * value;
+      accumulator->m_SumOfSquares += sign * valueSquared;
+      accumulator->m_SumOfCubes += sign * valueSquared * value;
+      accumulator->m_SumOfQuadruples += sign * valueSquared * valueSquared;
+      if (value > 0)
+      {
+        accumulator->m_SumOfPositivePixels += sign * value;
+        if (subtract)
+        {
+          --accumulator->m_PositivePixelCount;
+        }
+        else
+        {
+          ++accumulator->m_PositivePixelCount;
+        }
+      }
+
+      if (!accumulator->m_ExtremaValid)
+      {
+        // the label is rescanned after the update anyway
+        continue;
+      }
+
+      if (subtract)
+      {
+        if (value == accumulator->m_Minimum)
+        {
+          accumulator->m_MinIndexValid = accumulator->m_MinIndexValid && index != accumulator->m_MinIndex;
+          accumulator->m_ExtremaValid = --accumulator->m_MinimumCount > 0;
+        }
+        if (value == accumulator->m_Maximum)
+        {
+          accumulator->m_MaxIndexValid = accumulator->m_MaxIndexValid && index != accumulator->m_MaxIndex;
+          accumulator->m_ExtremaValid = accumulator->m_ExtremaValid && --accumulator->m_MaximumCount > 0;
+        }
+      }
+      else
+      {
+        // the positions of the extrema are the first ones in image order, like in ImageStatisticsCalculator
+        if (value < accumulator->m_Minimum)
+        {
+          accumulator->m_Minimum = value;
+          accumulator->m_MinimumCount = 1;
+          accumulator->m_MinIndex = index;
+          accumulator->m_MinIndexValid = true;
+          accumulator->m_HistogramValid = false;
+        }
+        else if (value == accumulator->m_Minimum)
+        {
+          ++accumulator->m_MinimumCount;
+          if (accumulator->m_MinIndexValid && IsBefore(index, accumulator->m_MinIndex))
+          {
+            accumulator->m_MinIndex = index;
+          }
+        }
+
+        if (value > accumulator->m_Maximum)
+        {
+          accumulator->m_Maximum = value;
+          accumulator->m_MaximumCount = 1;
+          accumulator->m_MaxIndex = index;
+          accumulator->m_MaxIndexValid = true;
+          accumulator->m_HistogramValid = false;
+        }
+        else if (value == accumulator->m_Maximum)
+        {
+          ++accumulator->m_MaximumCount;
+          if (accumulator->m_MaxIndexValid && IsBefore(index, accumulator->m_MaxIndex))
+          {
+            accumulator->m_MaxIndex = index;
+          }
+        }
+      }
+
+      if (!accumulator->m_ExtremaValid)
+      {
+        // the last voxel with an extremum was removed, the bins of the histogram change
+        accumulator->m_HistogramValid = false;
+      }
+      else if (accumulator->m_HistogramValid &&
+               GetHistogramIndex(accumulator->m_Histogram, value, histogramIndex))
+      {
+        const auto frequency = accumulator->m_Histogram->GetFrequency(histogramIndex);
+        if (subtract && frequency == 0)
+        {
+          mitkThrow() << "Statistics are out of sync with the label image";
+        }
+        accumulator->m_Histogram->SetFrequencyOfIndex(histogramIndex, subtract ? frequency - 1 : frequency + 1);
+      }
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::CompleteLabels(const Inputs &inputs,
+                                                            TimeStepType timeStep,
+                                                            AccumulatorMapType *accumulators,
+                                                            const std::set<LabelPixelType> &labels) const
+  {
+    mitk::Image::Pointer imageTimeStep;
+    mitk::Image::Pointer labelTimeStep;
+
+    for (const auto label : labels)
+    {
+      auto labelAccumulator = accumulators->find(label);
+      if (labelAccumulator == accumulators->end())
+      {
+        continue;
+      }
+
+      LabelAccumulator &accumulator = labelAccumulator->second;
+      if (accumulator.m_Count == 0)
+      {
+        accumulator = LabelAccumulator();
+        continue;
+      }
+
+      if (accumulator.m_ExtremaValid && accumulator.m_MinIndexValid && accumulator.m_MaxIndexValid &&
+          accumulator.m_HistogramValid)
+      {
+        continue;
+      }
+
+      if (imageTimeStep.IsNull())
+      {
+        imageTimeStep = this->GetImageTimeStep(inputs.m_Image, timeStep);
+        labelTimeStep = this->GetImageTimeStep(inputs.m_LabelImage, timeStep);
+      }
+
+      // only the bounding box of the label is scanned
+      const unsigned int nBins = inputs.m_nBinsForHistogramStatistics;
+      if (!accumulator.m_ExtremaValid)
+      {
+        this->ScanLabel(imageTimeStep, labelTimeStep, label, &accumulator, ScanMode::Extrema, nBins);
+        if (accumulator.m_Count == 0)
+        {
+          mitkThrow() << "Statistics are out of sync with the label image";
+        }
+      }
+      else if (!accumulator.m_MinIndexValid || !accumulator.m_MaxIndexValid)
+      {
+        this->ScanLabel(imageTimeStep, labelTimeStep, label, &accumulator, ScanMode::ExtremaIndices, nBins);
+      }
+
+      if (!accumulator.m_HistogramValid)
+      {
+        this->ScanLabel(imageTimeStep, labelTimeStep, label, &accumulator, ScanMode::Histogram, nBins);
+      }
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::ScanLabel(const mitk::Image *image,
+                                                       const mitk::Image *labelImage,
+                                                       LabelPixelType label,
+                                                       LabelAccumulator *accumulator,
+                                                       ScanMode mode,
+                                                       unsigned int nBins) const
+  {
+    RegionType boundingBox;
+    boundingBox.SetIndex(accumulator->m_BoundingBoxMin);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      boundingBox.SetSize(i, accumulator->m_BoundingBoxMax[i] - accumulator->m_BoundingBoxMin[i] + 1);
+    }
+
+    if (mode == ScanMode::Extrema)
+    {
+      // everything is recounted from the voxels, which also drops the rounding errors of the sums
+      *accumulator = LabelAccumulator();
+    }
+    else if (mode == ScanMode::Histogram)
+    {
+      accumulator->m_Histogram = CreateHistogram(accumulator->m_Minimum, accumulator->m_Maximum, nBins);
+    }
+
+    std::vector<LabelPixelType> labels;
+    for (const auto &chunk : SplitIntoChunks(boundingBox))
+    {
+      AccessFixedDimensionByItk_n(labelImage, InternalExtractLabels, 3, (chunk, &labels));
+      AccessFixedDimensionByItk_n(image, InternalScanLabel, 3, (&labels, chunk, label, accumulator, mode));
+      if (mode == ScanMode::ExtremaIndices && accumulator->m_MinIndexValid && accumulator->m_MaxIndexValid)
+      {
+        break;
+      }
+    }
+
+    if (mode == ScanMode::Histogram)
+    {
+      accumulator->m_HistogramValid = true;
+    }
+  }
+
+  template <typename TPixel>
+  void IncrementalImageStatisticsCalculator::InternalScanLabel(const itk::Image<TPixel, 3> *image,
+                                                               const std::vector<LabelPixelType> *labels,
+                                                               const RegionType &region,
+                                                               LabelPixelType label,
+                                                               LabelAccumulator *accumulator,
+                                                               ScanMode mode) const
+  {
+    itk::ImageRegionConstIteratorWithIndex<itk::Image<TPixel, 3>> it(image, region);
+    HistogramType::IndexType histogramIndex(1);
+
+    for (auto labelValue = labels->cbegin(); !it.IsAtEnd(); ++it, ++labelValue)
+    {
+      if (*labelValue != label)
+      {
+        continue;
+      }
+
+      const double value = static_cast<double>(it.Get());
+      switch (mode)
+      {
+        case ScanMode::Extrema:
+        {
+          // voxels are visited in image order, so this finds the first positions of the extrema
+          const double valueSquared = value * value;
+          const IndexType &index = it.GetIndex();
+          ++accumulator->m_Count;
+          accumulator->m_Sum += value;
+          accumulator->m_SumOfSquares += valueSquared;
+          accumulator->m_SumOfCubes += valueSquared * value;
+          accumulator->m_SumOfQuadruples += valueSquared * valueSquared;
+          if (value > 0)
+          {
+            accumulator->m_SumOfPositivePixels += value;
+            ++accumulator->m_PositivePixelCount;
+          }
+          if (value < accumulator->m_Minimum)
+          {
+            accumulator->m_Minimum = value;
+            accumulator->m_MinimumCount = 1;
+            accumulator->m_MinIndex = index;
+            accumulator->m_MinIndexValid = true;
+          }
+          else if (value == accumulator->m_Minimum)
+          {
+            ++accumulator->m_MinimumCount;
+          }
+          if (value > accumulator->m_Maximum)
+          {
+            accumulator->m_Maximum = value;
+            accumulator->m_MaximumCount = 1;
+            accumulator->m_MaxIndex = index;
+            accumulator->m_MaxIndexValid = true;
+          }
+          else if (value == accumulator->m_Maximum)
+          {
+            ++accumulator->m_MaximumCount;
+          }
+          for (unsigned int i = 0; i < 3; ++i)
+          {
+            accumulator->m_BoundingBoxMin[i] = std::min(accumulator->m_BoundingBoxMin[i], index[i]);
+            accumulator->m_BoundingBoxMax[i] = std::max(accumulator->m_BoundingBoxMax[i], index[i]);
+          }
+          break;
+        }
+        case ScanMode::ExtremaIndices:
+        {
+          if (!accumulator->m_MinIndexValid && value == accumulator->m_Minimum)
+          {
+            accumulator->m_MinIndex = it.GetIndex();
+            accumulator->m_MinIndexValid = true;
+          }
+          if (!accumulator->m_MaxIndexValid && value == accumulator->m_Maximum)
+          {
+            accumulator->m_MaxIndex = it.GetIndex();
+            accumulator->m_MaxIndexValid = true;
+          }
+          if (accumulator->m_MinIndexValid && accumulator->m_MaxIndexValid)
+          {
+            return;
+          }
+          break;
+        }
+        case ScanMode::Histogram:
+        {
+          if (GetHistogramIndex(accumulator->m_Histogram, value, histogramIndex))
+          {
+            accumulator->m_Histogram->IncreaseFrequencyOfIndex(histogramIndex, 1);
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::UpdateContainers(TimeStepType timeStep,
+                                                              const std::set<LabelPixelType> &labels)
+  {
+    auto &timeStepAccumulators = m_Accumulators[timeStep];
+
+    for (const auto label : labels)
+    {
+      ImageStatisticsContainer::Pointer container;
+      auto containerIt = m_StatisticContainers.find(label);
+      if (containerIt != m_StatisticContainers.end())
+      {
+        container = containerIt->second;
+      }
+      else
+      {
+        container = ImageStatisticsContainer::New();
+        container->SetTimeGeometry(const_cast<mitk::TimeGeometry *>(m_Image->GetTimeGeometry()));
+        m_StatisticContainers.emplace(label, container);
+      }
+
+      container->SetStatisticsForTimeStep(timeStep, this->ComputeStatisticsObject(timeStepAccumulators[label]));
+    }
+  }
+
+  ImageStatisticsContainer::StatisticsObject IncrementalImageStatisticsCalculator::ComputeStatisticsObject(
+    const LabelAccumulator &accumulator) const
+  {
+    ImageStatisticsContainer::StatisticsObject statObj;
+
+    auto spacing = m_Image->GetGeometry()->GetSpacing();
+    const double voxelVolume = spacing[0] * spacing[1] * spacing[2];
+
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(), accumulator.m_Count);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), accumulator.m_Count * voxelVolume);
+
+    if (accumulator.m_Count == 0)
+    {
+      return statObj;
+    }
+
+    // same formulas as in ExtendedLabelStatisticsImageFilter
+    const double count = static_cast<double>(accumulator.m_Count);
+    const double sum = accumulator.m_Sum;
+    const double mean = sum / count;
+    const double variance = (accumulator.m_SumOfSquares - (sum * sum / count)) / count;
+    const double secondMoment = accumulator.m_SumOfSquares / count;
+    const double thirdMoment = accumulator.m_SumOfCubes / count;
+    const double fourthMoment = accumulator.m_SumOfQuadruples / count;
+    const double skewness = (thirdMoment - 3. * secondMoment * mean + 2. * std::pow(mean, 3.)) /
+                            std::pow(secondMoment - std::pow(mean, 2.), 1.5);
+    const double kurtosis =
+      (fourthMoment - 4. * thirdMoment * mean + 6. * secondMoment * std::pow(mean, 2.) - 3. * std::pow(mean, 4.)) /
+      std::pow(secondMoment - std::pow(mean, 2.), 2.);
+    const double mpp = accumulator.m_SumOfPositivePixels / static_cast<double>(accumulator.m_PositivePixelCount);
+    const double sigma = std::sqrt(variance);
+
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), mean);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(), accumulator.m_Minimum);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(), accumulator.m_Maximum);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), sigma);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), sigma * sigma);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), skewness);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), kurtosis);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), std::sqrt(std::pow(mean, 2.) + variance));
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), mpp);
+
+    vnl_vector<int> minIndex(3), maxIndex(3);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      minIndex[i] = accumulator.m_MinIndex[i];
+      maxIndex[i] = accumulator.m_MaxIndex[i];
+    }
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
+
+    // the statistics object gets its own copy, the bins of the accumulator keep changing with the label image
+    HistogramType::Pointer histogram =
+      CreateHistogram(accumulator.m_Minimum, accumulator.m_Maximum, accumulator.m_Histogram->Size());
+    for (HistogramType::InstanceIdentifier bin = 0; bin < histogram->Size(); ++bin)
+    {
+      histogram->SetFrequency(bin, accumulator.m_Histogram->GetFrequency(bin));
+    }
+
+    HistogramStatisticsCalculator histStatCalc;
+    histStatCalc.SetHistogram(histogram);
+    histStatCalc.CalculateStatistics();
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), histStatCalc.GetEntropy());
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), histStatCalc.GetMedian());
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), histStatCalc.GetUniformity());
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), histStatCalc.GetUPP());
+    statObj.m_Histogram = histogram.GetPointer();
+
+    return statObj;
+  }
+} // namespace mitk
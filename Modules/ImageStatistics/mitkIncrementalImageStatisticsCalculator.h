@@ -0,0 +1,262 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKINCREMENTALIMAGESTATISTICSCALCULATOR
+#define MITKINCREMENTALIMAGESTATISTICSCALCULATOR
+
+#include <MitkImageStatisticsExports.h>
+#include <mitkImage.h>
+#include <mitkImageStatisticsContainer.h>
+#include <itkImage.h>
+#include <itkImageRegion.h>
+#include <itkObject.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  \brief Computes per label statistics of an image and keeps them up to date while the label image is edited.
+
+  In contrast to ImageStatisticsCalculator, which recomputes all time steps whenever an input changes, this class
+  keeps for every label and time step the running sums of the voxel values, the extrema and the histogram bins. When
+  only a small part of the label image is modified (e.g. by a segmentation tool or an undo/redo of a
+  DiffSliceOperation) the statistics are updated by removing the voxels of the modified region before the
+  modification and adding them again afterwards:
+
+  \code
+  calculator->BeginRegionUpdate(modifiedRegion, timeStep);
+  // ... modify the label image inside modifiedRegion ...
+  calculator->EndRegionUpdate();
+  \endcode
+
+  The calculator observes the ImageRegionAboutToBeModifiedEvent and ImageRegionModifiedEvent of the label image, so
+  modifications done by the segmentation tools are applied this way automatically. Errors during such an update never
+  leave the observer, the statistics are just recomputed on the next call of GetStatistics(). Any other modification
+  of the input or the label image (detected by their modification time) leads to a full computation on the next call
+  of GetStatistics().
+
+  The statistics equal the ones of ImageStatisticsCalculator with an ImageMaskGenerator for the same label: the
+  histogram of each label spans the minimum to the maximum of the label with GetNBinsForHistogramStatistics() bins,
+  and minimum and maximum position are the first voxels (in image order) holding the extrema. The containers returned
+  by GetStatistics() are updated in place, so statistics nodes that are already managed by
+  ImageStatisticsContainerManager stay valid and just get modified. Label 0 is treated as background and is not
+  evaluated.
+
+  Memory per label and time step is bounded by the number of histogram bins. If a modification removes the last voxel
+  holding the minimum or maximum of a label, or adds a value outside of its range, the histogram bins no longer fit
+  and the label is rescanned within its bounding box.
+
+  The public methods may be called from different threads. GetStatistics() does a full computation without blocking
+  region updates; if the images are modified meanwhile, the result is discarded and computed again.
+  */
+  class MITKIMAGESTATISTICS_EXPORT IncrementalImageStatisticsCalculator : public itk::Object
+  {
+  public:
+    /** Standard Self typedef */
+    typedef IncrementalImageStatisticsCalculator Self;
+    typedef itk::Object Superclass;
+    typedef itk::SmartPointer<Self> Pointer;
+    typedef itk::SmartPointer<const Self> ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self)
+
+    /** Runtime information support. */
+    itkTypeMacro(IncrementalImageStatisticsCalculator, itk::Object)
+
+    typedef unsigned short LabelPixelType;
+    typedef itk::ImageRegion<3> RegionType;
+    using LabelIndex = ImageStatisticsContainer::LabelIndex;
+
+    /**Documentation
+    @brief Set the image for which the statistics are to be computed.*/
+    void SetInputImage(mitk::Image::ConstPointer image);
+
+    /**Documentation
+    @brief Set the label image (e.g. a LabelSetImage or a binary segmentation). It has to share the geometry and the
+    number of time steps with the input image.*/
+    void SetLabelImage(mitk::Image::ConstPointer labelImage);
+
+    /**Documentation
+    @brief Set number of bins to be used for histogram statistics.*/
+    void SetNBinsForHistogramStatistics(unsigned int nBins);
+
+    unsigned int GetNBinsForHistogramStatistics() const;
+
+    /**Documentation
+    @brief Discards all accumulators. The next call of GetStatistics() performs a full computation.*/
+    void Reset();
+
+    /**Documentation
+    @brief Removes the contribution of @a region (index coordinates) of time step @a timeStep from the statistics.
+    Has to be called before the label image is modified inside this region.*/
+    void BeginRegionUpdate(const RegionType &region, TimeStepType timeStep);
+
+    /**Documentation
+    @brief Adds the contribution of the region passed to BeginRegionUpdate() again and updates the statistics
+    containers of all labels involved.*/
+    void EndRegionUpdate();
+
+    /**Documentation
+    @brief Returns the statistics for label @a label. A full computation is done if no statistics exist yet or the
+    images were modified otherwise than by region updates. Time steps in which the label does not occur have no
+    statistics (or a voxel count of 0, if the label was removed by a region update).
+    */
+    ImageStatisticsContainer::Pointer GetStatistics(LabelIndex label = 1);
+
+  protected:
+    IncrementalImageStatisticsCalculator();
+    ~IncrementalImageStatisticsCalculator() override;
+
+  private:
+    typedef itk::Index<3> IndexType;
+    typedef ImageStatisticsContainer::VoxelCountType VoxelCountType;
+    typedef ImageStatisticsContainer::HistogramType HistogramType;
+
+    /** Running sums, extrema and histogram of one label in one time step */
+    struct LabelAccumulator
+    {
+      LabelAccumulator();
+
+      VoxelCountType m_Count;
+      double m_Sum;
+      double m_SumOfSquares;
+      double m_SumOfCubes;
+      double m_SumOfQuadruples;
+      double m_SumOfPositivePixels;
+      VoxelCountType m_PositivePixelCount;
+      // minimum and maximum and how often they occur, invalid if the last voxel of an extremum was removed
+      double m_Minimum;
+      double m_Maximum;
+      VoxelCountType m_MinimumCount;
+      VoxelCountType m_MaximumCount;
+      bool m_ExtremaValid;
+      IndexType m_MinIndex;
+      IndexType m_MaxIndex;
+      bool m_MinIndexValid;
+      bool m_MaxIndexValid;
+      // spans m_Minimum to m_Maximum, invalid whenever the extrema change
+      HistogramType::Pointer m_Histogram;
+      bool m_HistogramValid;
+      // bounding box of all voxels ever added, limits rescans of the label
+      IndexType m_BoundingBoxMin;
+      IndexType m_BoundingBoxMax;
+    };
+
+    typedef std::map<LabelPixelType, LabelAccumulator> AccumulatorMapType;
+
+    /** The images and settings a computation works on, so it can run without holding the mutex */
+    struct Inputs
+    {
+      mitk::Image::ConstPointer m_Image;
+      mitk::Image::ConstPointer m_LabelImage;
+      unsigned int m_nBinsForHistogramStatistics;
+    };
+
+    void ResetAccumulators();
+
+    Inputs GetInputs() const;
+
+    std::vector<AccumulatorMapType> ComputeAccumulators(const Inputs &inputs) const;
+
+    void AccumulateRegion(const Inputs &inputs,
+                          const RegionType &region,
+                          TimeStepType timeStep,
+                          AccumulatorMapType *accumulators,
+                          std::set<LabelPixelType> *modifiedLabels,
+                          bool subtract) const;
+
+    template <typename TPixel>
+    void InternalExtractLabels(const itk::Image<TPixel, 3> *labelImage,
+                               const RegionType &region,
+                               std::vector<LabelPixelType> *labels) const;
+
+    template <typename TPixel>
+    void InternalAccumulateRegion(const itk::Image<TPixel, 3> *image,
+                                  const std::vector<LabelPixelType> *labels,
+                                  const RegionType &region,
+                                  AccumulatorMapType *accumulators,
+                                  std::set<LabelPixelType> *modifiedLabels,
+                                  bool subtract) const;
+
+    /** Rescans the labels whose extrema, extrema positions or histogram became invalid. */
+    void CompleteLabels(const Inputs &inputs,
+                        TimeStepType timeStep,
+                        AccumulatorMapType *accumulators,
+                        const std::set<LabelPixelType> &labels) const;
+
+    enum class ScanMode
+    {
+      Extrema,
+      ExtremaIndices,
+      Histogram
+    };
+
+    void ScanLabel(const mitk::Image *image,
+                   const mitk::Image *labelImage,
+                   LabelPixelType label,
+                   LabelAccumulator *accumulator,
+                   ScanMode mode,
+                   unsigned int nBins) const;
+
+    template <typename TPixel>
+    void InternalScanLabel(const itk::Image<TPixel, 3> *image,
+                           const std::vector<LabelPixelType> *labels,
+                           const RegionType &region,
+                           LabelPixelType label,
+                           LabelAccumulator *accumulator,
+                           ScanMode mode) const;
+
+    void UpdateContainers(TimeStepType timeStep, const std::set<LabelPixelType> &labels);
+
+    ImageStatisticsContainer::StatisticsObject ComputeStatisticsObject(const LabelAccumulator &accumulator) const;
+
+    mitk::Image::Pointer GetImageTimeStep(const mitk::Image *image, TimeStepType timeStep) const;
+
+    void OnRegionAboutToBeModified(itk::Object *caller, const itk::EventObject &event);
+
+    void OnRegionModified(itk::Object *caller, const itk::EventObject &event);
+
+    void RemoveLabelImageObservers();
+
+    mitk::Image::ConstPointer m_Image;
+    mitk::Image::ConstPointer m_LabelImage;
+    unsigned int m_nBinsForHistogramStatistics;
+
+    std::vector<AccumulatorMapType> m_Accumulators;
+    std::map<LabelIndex, ImageStatisticsContainer::Pointer> m_StatisticContainers;
+    unsigned long m_ImageMTime;
+    unsigned long m_LabelImageMTime;
+
+    bool m_RegionUpdatePending;
+    RegionType m_PendingRegion;
+    TimeStepType m_PendingTimeStep;
+    std::set<LabelPixelType> m_PendingLabels;
+
+    unsigned long m_RegionAboutToBeModifiedTag;
+    unsigned long m_RegionModifiedTag;
+
+    // counts every region update and reset, a full computation is only used if it did not change meanwhile
+    unsigned long m_ModificationCount;
+
+    mutable std::mutex m_Mutex;
+  };
+}
+#endif // MITKINCREMENTALIMAGESTATISTICSCALCULATOR
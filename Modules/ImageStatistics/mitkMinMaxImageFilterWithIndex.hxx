@@ -39,7 +39,7 @@ void MinMaxImageFilterWithIndex< TInputImage >::ThreadedGenerateData(const Regio
   threadMaxIndex.Fill(0);
 
   threadMin = std::numeric_limits<PixelType>::max();
-  threadMax = std::numeric_limits<PixelType>::min();
+  threadMax = std::numeric_limits<PixelType>::lowest();
 
   ImageRegionConstIteratorWithIndex< TInputImage > it (this->GetInput(), outputRegionForThread);
 
@@ -78,11 +78,11 @@ void MinMaxImageFilterWithIndex< TInputImage >::BeforeThreadedGenerateData()
   for (unsigned int i =0; i < numberOfThreads; i++)
   {
     m_ThreadMin[i] = std::numeric_limits<PixelType>::max();
-    m_ThreadMax[i] = std::numeric_limits<PixelType>::min();
+    m_ThreadMax[i] = std::numeric_limits<PixelType>::lowest();
   }
 
   m_Min = std::numeric_limits<PixelType>::max();
-  m_Max = std::numeric_limits<PixelType>::min();
+  m_Max = std::numeric_limits<PixelType>::lowest();
 
 }
 
@@ -49,7 +49,7 @@ public:
 
         LabelExtrema():
             m_Min(std::numeric_limits<PixelType>::max()),
-            m_Max(std::numeric_limits<PixelType>::min())
+            m_Max(std::numeric_limits<PixelType>::lowest())
         {}
     };
 
@@ -34,7 +34,8 @@ void MinMaxLabelImageFilterWithIndex< TInputImage, TLabelImage >::ThreadedGenera
   LabelPixelType label;
 
   ExtremaMapType threadExtrema;
-  ExtremaMapTypeIterator threadExtremaIt;
+  ExtremaMapTypeIterator threadExtremaIt = threadExtrema.end();
+  LabelPixelType lastLabel = 0;
 
   ImageRegionConstIteratorWithIndex< TInputImage > it (this->GetInput(), outputRegionForThread);
   ImageRegionConstIteratorWithIndex< TLabelImage > labelit (this->GetLabelInput(), outputRegionForThread);
@@ -45,12 +46,17 @@ void MinMaxLabelImageFilterWithIndex< TInputImage, TLabelImage >::ThreadedGenera
     value = it.Get();
     label = labelit.Get();
 
-    threadExtremaIt = threadExtrema.find(label);
-
-    // if label does not exist yet, create a new entry in the map.
-    if (threadExtremaIt == threadExtrema.end())
+    // labels are spatially coherent, so only look the label up if it differs from the previous voxel
+    if (threadExtremaIt == threadExtrema.end() || label != lastLabel)
     {
-      threadExtremaIt = threadExtrema.insert( MapValueType(label, LabelExtrema()) ).first;
+      threadExtremaIt = threadExtrema.find(label);
+
+      // if label does not exist yet, create a new entry in the map.
+      if (threadExtremaIt == threadExtrema.end())
+      {
+        threadExtremaIt = threadExtrema.insert( MapValueType(label, LabelExtrema()) ).first;
+      }
+      lastLabel = label;
     }
 
     if (value < (*threadExtremaIt).second.m_Min)
@@ -88,7 +94,7 @@ void MinMaxLabelImageFilterWithIndex< TInputImage, TLabelImage >::AfterThreadedG
   ThreadIdType numberOfThreads = this->GetNumberOfThreads();
 
   m_GlobalMin = std::numeric_limits<PixelType>::max();
-  m_GlobalMax = std::numeric_limits<PixelType>::min();
+  m_GlobalMax = std::numeric_limits<PixelType>::lowest();
 
   ExtremaMapTypeIterator it;
 
@@ -31,6 +31,7 @@ QmitkImageStatisticsCalculationJob::QmitkImageStatisticsCalculationJob()
   , m_HistogramNBins(100)
   , m_StatisticChanged(false)
   , m_CalculationSuccessful(false)
+  , m_IncrementalCalculator(mitk::IncrementalImageStatisticsCalculator::New())
 {
 }
 
@@ -132,8 +133,51 @@ bool QmitkImageStatisticsCalculationJob::GetStatisticsUpdateSuccessFlag() const
   return m_CalculationSuccessful;
 }
 
+bool QmitkImageStatisticsCalculationJob::CanUseIncrementalCalculator() const
+{
+  if (m_StatisticsImage.IsNull() || m_BinaryMask.IsNull() || m_PlanarFigureMask.IsNotNull() || m_IgnoreZeros)
+    return false;
+
+  if (m_StatisticsImage->GetDimension() != 3 || m_BinaryMask->GetDimension() != 3 ||
+      m_StatisticsImage->GetTimeSteps() != m_BinaryMask->GetTimeSteps())
+    return false;
+
+  return mitk::Equal(*m_StatisticsImage->GetGeometry(), *m_BinaryMask->GetGeometry(), mitk::eps, false);
+}
+
 void QmitkImageStatisticsCalculationJob::run()
 {
+  // statistics of a segmentation are kept up to date by the incremental calculator, so that only the voxels touched by
+  // the segmentation tools are evaluated again when the segmentation is edited
+  if (this->CanUseIncrementalCalculator())
+  {
+    try
+    {
+      m_IncrementalCalculator->SetInputImage(m_StatisticsImage);
+      m_IncrementalCalculator->SetLabelImage(m_BinaryMask);
+      m_IncrementalCalculator->SetNBinsForHistogramStatistics(m_HistogramNBins);
+      m_StatisticsContainer = m_IncrementalCalculator->GetStatistics();
+
+      this->m_HistogramVector.clear();
+      for (unsigned int i = 0; i < m_StatisticsImage->GetTimeSteps(); i++)
+      {
+        this->m_HistogramVector.push_back(m_StatisticsContainer->TimeStepExists(i)
+                                            ? m_StatisticsContainer->GetStatisticsForTimeStep(i).m_Histogram
+                                            : nullptr);
+      }
+
+      this->m_StatisticChanged = false;
+      this->m_CalculationSuccessful = true;
+      return;
+    }
+    catch (const std::exception &e)
+    {
+      // e.g. multi component images, use ImageStatisticsCalculator instead
+      MITK_WARN << "Incremental statistics calculation failed: " << e.what();
+      m_IncrementalCalculator->SetLabelImage(nullptr);
+    }
+  }
+
   bool statisticCalculationSuccessful = true;
   mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
 
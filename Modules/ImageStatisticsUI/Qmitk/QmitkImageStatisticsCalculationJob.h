@@ -24,6 +24,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImage.h"
 #include "mitkPlanarFigure.h"
 #include "mitkImageStatisticsContainer.h"
+#include "mitkIncrementalImageStatisticsCalculator.h"
 #include <MitkImageStatisticsUIExports.h>
 
 // itk headers
@@ -98,6 +99,11 @@ public:
   std::string GetLastErrorMessage() const;
 
 private:
+  /*!
+  /brief Returns true if the statistics can be computed by m_IncrementalCalculator (plain binary mask of the same
+  geometry as the image). */
+  bool CanUseIncrementalCalculator() const;
+
   //member declaration
 
   mitk::Image::ConstPointer m_StatisticsImage;                         ///< member variable holds the input image for which the statistics need to be calculated.
@@ -112,5 +118,7 @@ private:
   bool m_CalculationSuccessful;                                   ///< flag set if statistics calculation was successful
   std::vector<HistogramType::ConstPointer> m_HistogramVector;          ///< member holds the histograms of all time steps.
   std::string m_message;
+  /// keeps the statistics of segmentations up to date between runs
+  mitk::IncrementalImageStatisticsCalculator::Pointer m_IncrementalCalculator;
 };
 #endif // QMITKIMAGESTATISTICSCALCULATIONTHREAD_H_INCLUDED
@@ -15,6 +15,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 // std includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <string>
 
 // itk includes
@@ -36,12 +39,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkExtractTimeGrid.h>
 #include <mitkModelFitCmdAppsHelper.h>
 #include <mitkPreferenceListReaderOptionsFunctor.h>
+#include <mitkGenericParamModel.h>
+#include <mitkCompiledFormula.h>
+#include <mitkFormulaParser.h>
 
 std::string inFilename;
 std::string outFileName;
 std::string maskFileName;
 bool verbose(false);
 bool roibased(false);
+bool benchmark(false);
 std::string functionName;
 std::string formular;
 mitk::Image::Pointer image;
@@ -99,6 +106,8 @@ void setupParser(mitkCommandLineParser& parser)
         "verbose", "v", mitkCommandLineParser::Bool, "Verbose Output", "Whether to produce verbose output");
     parser.addArgument(
         "roibased", "r", mitkCommandLineParser::Bool, "Roi based fitting", "Will compute a mean intesity signal over the ROI before fitting it. If this mode is used a mask must be specified.");
+    parser.addArgument(
+        "benchmark", "b", mitkCommandLineParser::Bool, "Benchmark formula", "Compares the evaluation time of the generic model formular with the compiled formula and with the formula parser on the time grid of the input image instead of fitting.");
     parser.addArgument("help", "h", mitkCommandLineParser::Bool, "Help:", "Show this help text");
     parser.endGroup();
     //! [add arguments]
@@ -140,6 +149,12 @@ bool configureApplicationSettings(std::map<std::string, us::Any> parsedArgs)
         maskFileName = us::any_cast<std::string>(parsedArgs["mask"]);
     }
 
+    benchmark = false;
+    if (parsedArgs.count("benchmark"))
+    {
+        benchmark = us::any_cast<bool>(parsedArgs["benchmark"]);
+    }
+
     return true;
 }
 
@@ -238,6 +253,63 @@ void generateModelFit_ROIBased(
     generator = fitGenerator.GetPointer();
 }
 
+void benchmarkFormular()
+{
+    const unsigned int repetitions = 10000;
+
+    mitk::ModelBase::TimeGridType timeGrid = mitk::ExtractTimeGrid(image);
+
+    mitk::GenericParamModel::Pointer model = mitk::GenericParamModel::New();
+    model->SetNumberOfParameters(10);
+    mitk::CompiledFormula::VariableNamesType variableNames = model->GetParameterNames();
+    variableNames.insert(variableNames.begin(), model->GetXName());
+
+    std::vector<double> values(variableNames.size(), 1.0);
+    std::map<std::string, double> parameterMap;
+    for (std::size_t i = 0; i < variableNames.size(); ++i)
+    {
+        parameterMap[variableNames[i]] = values[i];
+    }
+
+    std::cout << "Formular:   " << formular << std::endl;
+    std::cout << "Time steps: " << timeGrid.GetSize() << std::endl;
+
+    // formula parser, as used by the generic model before
+    std::vector<double> parserSignal(timeGrid.GetSize());
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repetitions; ++r)
+    {
+        mitk::FormulaParser formulaParser(&parameterMap);
+        for (unsigned int t = 0; t < timeGrid.GetSize(); ++t)
+        {
+            parameterMap[model->GetXName()] = timeGrid[t];
+            parserSignal[t] = formulaParser.parse(formular);
+        }
+    }
+    double parserTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // compiled once, evaluated for the whole time grid per call
+    std::vector<double> compiledSignal(timeGrid.GetSize());
+    start = std::chrono::steady_clock::now();
+    mitk::CompiledFormula compiled(formular, variableNames);
+    for (unsigned int r = 0; r < repetitions; ++r)
+    {
+        compiled.Evaluate(values.data(), 0, timeGrid.data_block(), timeGrid.GetSize(), compiledSignal.data());
+    }
+    double compiledTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double maxDifference = 0;
+    for (unsigned int t = 0; t < timeGrid.GetSize(); ++t)
+    {
+        maxDifference = std::max(maxDifference, std::abs(parserSignal[t] - compiledSignal[t]));
+    }
+
+    std::cout << "Formula parser:   " << parserTime / repetitions * 1e6 << " us per signal" << std::endl;
+    std::cout << "Compiled formula: " << compiledTime / repetitions * 1e6 << " us per signal" << std::endl;
+    std::cout << "Speedup:          " << parserTime / compiledTime << std::endl;
+    std::cout << "Max. difference:  " << maxDifference << std::endl;
+}
+
 void doFitting()
 {
         mitk::ParameterFitImageGeneratorBase::Pointer generator = NULL;
@@ -340,6 +412,16 @@ int main(int argc, char* argv[])
         }
         std::cout << std::endl;
 
+        if (benchmark)
+        {
+            if (formular.empty())
+            {
+                mitkThrow() << "Error. Cannot benchmark. Please specify the formular of a generic model.";
+            }
+            benchmarkFormular();
+            return EXIT_SUCCESS;
+        }
+
         doFitting();
 
         std::cout << "Processing finished." << std::endl;
@@ -22,6 +22,7 @@ set(CPP_FILES
   Common/mitkModelFitParameterValueExtraction.cpp
   Common/mitkBinaryImageToLabelSetImageFilter.cpp
   Common/mitkFormulaParser.cpp
+  Common/mitkCompiledFormula.cpp
   Common/mitkFresnel.cpp
   Common/mitkModelFitPlotDataHelper.cpp
   Common/mitkModelSignalImageGenerator.cpp
@@ -64,6 +65,7 @@ set(CPP_FILES
 
 set(TPP_FILES
     include/itkMultiOutputNaryFunctorImageFilter.tpp
+    include/itkBatchedModelFitImageFilter.tpp
     include/itkMaskedStatisticsImageFilter.hxx
     include/itkMaskedNaryStatisticsImageFilter.hxx
 	include/mitkModelFitProviderBase.tpp
@@ -0,0 +1,144 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkBatchedModelFitImageFilter_h
+#define __itkBatchedModelFitImageFilter_h
+
+#include <chrono>
+#include <vector>
+
+#include "itkImageToImageFilter.h"
+
+#include "mitkModelFitFunctorBase.h"
+#include "mitkModelParameterizerBase.h"
+
+namespace itk
+{
+/** \class BatchedModelFitImageFilter
+ * \brief Fits a model voxel wise onto N input images (one per time frame) and produces one output image per
+ * functor output (see mitk::ModelFitFunctorBase::Compute()).
+ *
+ * The filter generates the same results as a itk::MultiOutputNaryFunctorImageFilter with a
+ * mitk::ModelFitFunctorPolicy, but each thread collects up to BatchSize (unmasked) voxels into structure of arrays
+ * buffers for signals, initial parameters and results and passes them to mitk::ModelFitFunctorBase::ComputeBatch().
+ * Each thread reuses one fit workspace (see mitk::ModelFitFunctorBase::CreateWorkspace()) and its model instances
+ * for all its voxels. Models are generated by the parameterizer once per thread; for following voxels only the local
+ * static parameters (if the parameterizer defines any) are set. Thus the filter assumes that
+ * GenerateParameterizedModel(index) only depends on the index via GetLocalStaticParameters(index).\n
+ * All the input images must be of the same type and must have the same buffered region.
+ *
+ * \ingroup IntensityImageFilters MultiThreaded
+ */
+template< class TInputImage, class TOutputImage, class TMaskImage = ::itk::Image<unsigned char, TInputImage::ImageDimension> >
+class ITK_EXPORT BatchedModelFitImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BatchedModelFitImageFilter                      Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BatchedModelFitImageFilter, ImageToImageFilter);
+
+  /** Some typedefs. */
+  typedef TInputImage                          InputImageType;
+  typedef typename InputImageType::Pointer     InputImagePointer;
+  typedef typename InputImageType::PixelType   InputImagePixelType;
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::Pointer    OutputImagePointer;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+  typedef typename OutputImageType::PixelType  OutputImagePixelType;
+  typedef TMaskImage                           MaskImageType;
+  typedef typename MaskImageType::Pointer      MaskImagePointer;
+
+  typedef ::mitk::ModelFitFunctorBase     FitFunctorType;
+  typedef ::mitk::ModelParameterizerBase  ParameterizerType;
+
+  /** Sets the functor used to fit the voxels. Changes the number of outputs if the parameterizer is already set.*/
+  void SetFitFunctor(const FitFunctorType* functor);
+  itkGetConstObjectMacro(FitFunctor, FitFunctorType);
+
+  /** Sets the parameterizer used to generate the models for the voxels. Changes the number of outputs if the
+   functor is already set.*/
+  void SetModelParameterizer(const ParameterizerType* parameterizer);
+  itkGetConstObjectMacro(ModelParameterizer, ParameterizerType);
+
+  itkSetObjectMacro(Mask, MaskImageType);
+  itkGetConstObjectMacro(Mask, MaskImageType);
+
+  /** Maximum number of voxels a thread passes at once to the functor. Default is 256.*/
+  itkSetClampMacro(BatchSize, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(BatchSize, unsigned int);
+
+  /** Number of voxels fitted by the last update (masked out voxels are not counted).*/
+  itkGetConstMacro(NumberOfFittedVoxels, SizeValueType);
+  /** Wall clock time in seconds the threads of the last update needed for the fitting.*/
+  itkGetConstMacro(FitDuration, double);
+  /** Fitted voxels per second of the last update.*/
+  double GetVoxelsPerSecond() const;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(
+    InputImageDimension, unsigned int, TInputImage::ImageDimension);
+  itkStaticConstMacro(
+    OutputImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< InputImageDimension, OutputImageDimension > ) );
+  /** End concept checking */
+#endif
+protected:
+  BatchedModelFitImageFilter();
+  virtual ~BatchedModelFitImageFilter() {}
+
+  void BeforeThreadedGenerateData();
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  void AfterThreadedGenerateData();
+
+  /** Methods actualize the output settings of the filter according to the current functor and parameterizer*/
+  void ActualizeOutputs();
+
+private:
+  BatchedModelFitImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);         //purposely not implemented
+
+  FitFunctorType::ConstPointer m_FitFunctor;
+  ParameterizerType::ConstPointer m_ModelParameterizer;
+  MaskImagePointer m_Mask;
+  unsigned int m_BatchSize;
+
+  std::vector<SizeValueType> m_FittedVoxelsPerThread;
+  SizeValueType m_NumberOfFittedVoxels;
+  double m_FitDuration;
+  std::chrono::steady_clock::time_point m_StartTime;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBatchedModelFitImageFilter.tpp"
+#endif
+
+#endif
@@ -0,0 +1,351 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkBatchedModelFitImageFilter_hxx
+#define __itkBatchedModelFitImageFilter_hxx
+
+#include <algorithm>
+#include <memory>
+
+#include "itkBatchedModelFitImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::BatchedModelFitImageFilter() : m_BatchSize(256), m_NumberOfFittedVoxels(0), m_FitDuration(0.0)
+  {
+    this->SetNumberOfRequiredInputs(1);
+
+    this->ActualizeOutputs();
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  void
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::SetFitFunctor(const FitFunctorType* functor)
+  {
+    if (m_FitFunctor != functor)
+    {
+      m_FitFunctor = functor;
+      this->ActualizeOutputs();
+      this->Modified();
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  void
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::SetModelParameterizer(const ParameterizerType* parameterizer)
+  {
+    if (m_ModelParameterizer != parameterizer)
+    {
+      m_ModelParameterizer = parameterizer;
+      this->ActualizeOutputs();
+      this->Modified();
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  double
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::GetVoxelsPerSecond() const
+  {
+    if (m_FitDuration <= 0.0)
+    {
+      return 0.0;
+    }
+
+    return m_NumberOfFittedVoxels / m_FitDuration;
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  void
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::ActualizeOutputs()
+  {
+    unsigned int numberOfOutputs = 0;
+
+    if (m_FitFunctor.IsNotNull() && m_ModelParameterizer.IsNotNull())
+    {
+      ParameterizerType::ModelBasePointer tempModel = m_ModelParameterizer->GenerateParameterizedModel();
+      numberOfOutputs = m_FitFunctor->GetNumberOfOutputs(tempModel);
+    }
+
+    this->SetNumberOfRequiredOutputs(numberOfOutputs);
+
+    for (typename Superclass::DataObjectPointerArraySizeType i = this->GetNumberOfIndexedOutputs(); i < numberOfOutputs; ++i)
+    {
+      this->SetNthOutput( i, this->MakeOutput(i) );
+    }
+
+    while(this->GetNumberOfIndexedOutputs() > numberOfOutputs)
+    {
+      this->RemoveOutput(this->GetNumberOfIndexedOutputs()-1);
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  void
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::BeforeThreadedGenerateData()
+  {
+    if (m_FitFunctor.IsNull())
+    {
+      itkExceptionMacro("Error. Cannot fit. Functor is Null.");
+    }
+
+    if (m_ModelParameterizer.IsNull())
+    {
+      itkExceptionMacro("Error. Cannot fit. Parameterizer is Null.");
+    }
+
+    const TInputImage* firstInput = this->GetInput(0);
+    for (unsigned int i = 1; i < this->GetNumberOfIndexedInputs(); ++i)
+    {
+      const TInputImage* input = this->GetInput(i);
+      if (input && input->GetBufferedRegion() != firstInput->GetBufferedRegion())
+      {
+        itkExceptionMacro("Error. Cannot fit. Buffered regions of the inputs differ. Input #0: " << firstInput->GetBufferedRegion() << "; input #" << i << ": " << input->GetBufferedRegion());
+      }
+    }
+
+    m_FittedVoxelsPerThread.assign(this->GetNumberOfThreads(), 0);
+    m_NumberOfFittedVoxels = 0;
+    m_FitDuration = 0.0;
+    m_StartTime = std::chrono::steady_clock::now();
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  void
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::AfterThreadedGenerateData()
+  {
+    m_FitDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_StartTime).count();
+
+    m_NumberOfFittedVoxels = 0;
+    for (const auto count : m_FittedVoxelsPerThread)
+    {
+      m_NumberOfFittedVoxels += count;
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TMaskImage >
+  void
+    BatchedModelFitImageFilter< TInputImage, TOutputImage, TMaskImage >
+    ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId)
+  {
+    typedef FitFunctorType::ParameterImagePixelType ValueType;
+    typedef ParameterizerType::StaticParameterMapType StaticParameterMapType;
+    typedef ParameterizerType::ModelBasePointer ModelBasePointer;
+
+    ProgressReporter progress( this, threadId,
+      outputRegionForThread.GetNumberOfPixels() );
+
+    const unsigned int numberOfInputImages =
+      static_cast< unsigned int >( this->GetNumberOfIndexedInputs() );
+
+    const unsigned int numberOfOutputImages =
+      static_cast< unsigned int >( this->GetNumberOfIndexedOutputs() );
+
+    if (numberOfInputImages == 0 || numberOfOutputImages == 0)
+    {
+      return;
+    }
+
+    typedef ImageRegionConstIterator< TInputImage > InputIteratorType;
+    std::vector< InputIteratorType > inputIterators;
+    inputIterators.reserve(numberOfInputImages);
+    for ( unsigned int i = 0; i < numberOfInputImages; ++i )
+    {
+      inputIterators.push_back(InputIteratorType(this->GetInput(i), outputRegionForThread));
+    }
+
+    std::vector< OutputImagePixelType* > outputBuffers(numberOfOutputImages);
+    for ( unsigned int i = 0; i < numberOfOutputImages; ++i )
+    {
+      outputBuffers[i] = this->GetOutput(i)->GetBufferPointer();
+    }
+    const OutputImageType* firstOutput = this->GetOutput(0);
+
+    typedef ImageRegionConstIterator< TMaskImage > MaskIteratorType;
+    MaskIteratorType maskIterator;
+    const bool useMask = m_Mask.IsNotNull();
+    if (useMask)
+    {
+      if (!m_Mask->GetLargestPossibleRegion().IsInside(outputRegionForThread))
+      {
+        itkExceptionMacro("Mask of filter is set but does not cover region of thread. Mask region: "<< m_Mask->GetLargestPossibleRegion() <<"Thread region: "<<outputRegionForThread)
+      }
+      maskIterator = MaskIteratorType(m_Mask, outputRegionForThread);
+    }
+
+    //all per thread state is set up once; the voxel loop itself only reuses it.
+    const unsigned int batchSize = m_BatchSize;
+    const ModelBasePointer referenceModel = m_ModelParameterizer->GenerateParameterizedModel();
+    const unsigned int numberOfParameters = referenceModel->GetNumberOfParameters();
+    if (m_FitFunctor->GetNumberOfOutputs(referenceModel) != numberOfOutputImages)
+    {
+      itkExceptionMacro("Error. Number of outputs do not equal number of outputs required by functor. Number of outputs: "<< numberOfOutputImages << "; needed output number:" << m_FitFunctor->GetNumberOfOutputs(referenceModel));
+    }
+
+    std::unique_ptr<FitFunctorType::FitWorkspace> workspace = m_FitFunctor->CreateWorkspace();
+
+    std::vector< ValueType > signals(static_cast<std::size_t>(numberOfInputImages) * batchSize);
+    std::vector< ValueType > initialParameters(static_cast<std::size_t>(numberOfParameters) * batchSize);
+    std::vector< ValueType > results(static_cast<std::size_t>(numberOfOutputImages) * batchSize);
+    std::vector< OffsetValueType > outputOffsets(batchSize);
+
+    //models are generated on first use. Voxels without local static parameters share one model, otherwise every
+    //batch slot has its own model that gets the local static parameters of its current voxel.
+    ModelBasePointer sharedModel;
+    std::vector< ModelBasePointer > slotModels(batchSize);
+    std::vector< const ::mitk::ModelBase* > batchModels(batchSize);
+
+    unsigned int batchCount = 0;
+    SizeValueType pendingProgress = 0;
+    SizeValueType fittedVoxels = 0;
+
+    auto fitBatch = [&]()
+    {
+      if (batchCount > 0)
+      {
+        m_FitFunctor->ComputeBatch(signals.data(), numberOfInputImages, batchCount, batchModels.data(),
+                                   initialParameters.data(), results.data(), workspace.get());
+
+        for (unsigned int i = 0; i < batchCount; ++i)
+        {
+          for (unsigned int o = 0; o < numberOfOutputImages; ++o)
+          {
+            outputBuffers[o][outputOffsets[i]] = static_cast<OutputImagePixelType>(results[o * batchCount + i]);
+          }
+        }
+
+        fittedVoxels += batchCount;
+        batchCount = 0;
+      }
+
+      for (; pendingProgress > 0; --pendingProgress)
+      {
+        progress.CompletedPixel();
+      }
+    };
+
+    while ( !inputIterators.front().IsAtEnd() )
+    {
+      bool isValid = true;
+
+      if (useMask)
+      {
+        isValid = maskIterator.Get() > 0;
+        ++maskIterator;
+      }
+
+      const typename InputImageType::IndexType currentIndex = inputIterators.front().GetIndex();
+      const OffsetValueType outputOffset = firstOutput->ComputeOffset(currentIndex);
+
+      if (isValid)
+      {
+        //signals and initial parameters are collected as structure of arrays with the stride batchSize
+        //(value t of slot i is stored at t*batchSize+i).
+        for (unsigned int t = 0; t < numberOfInputImages; ++t)
+        {
+          signals[t * batchSize + batchCount] = static_cast<ValueType>(inputIterators[t].Get());
+        }
+
+        const ParameterizerType::ParametersType initialParameterization =
+          m_ModelParameterizer->GetInitialParameterization(currentIndex);
+        if (initialParameterization.Size() != numberOfParameters)
+        {
+          itkExceptionMacro("Cannot compute fit. Parameter count of model and initial parameters differ. Model parameter count: "
+                            << numberOfParameters << "; Initial parameters: " << initialParameterization);
+        }
+        for (unsigned int p = 0; p < numberOfParameters; ++p)
+        {
+          initialParameters[p * batchSize + batchCount] = initialParameterization[p];
+        }
+
+        const StaticParameterMapType localParameters = m_ModelParameterizer->GetLocalStaticParameters(currentIndex);
+        if (localParameters.empty())
+        {
+          if (sharedModel.IsNull())
+          {
+            sharedModel = m_ModelParameterizer->GenerateParameterizedModel(currentIndex);
+          }
+          batchModels[batchCount] = sharedModel;
+        }
+        else
+        {
+          if (slotModels[batchCount].IsNull())
+          {
+            slotModels[batchCount] = m_ModelParameterizer->GenerateParameterizedModel(currentIndex);
+          }
+          else
+          {
+            slotModels[batchCount]->SetStaticParameters(localParameters, false);
+          }
+          batchModels[batchCount] = slotModels[batchCount];
+        }
+
+        outputOffsets[batchCount] = outputOffset;
+        ++batchCount;
+      }
+      else
+      {
+        for (unsigned int o = 0; o < numberOfOutputImages; ++o)
+        {
+          outputBuffers[o][outputOffset] = 0.0;
+        }
+      }
+
+      ++pendingProgress;
+
+      for (auto& inputIterator : inputIterators)
+      {
+        ++inputIterator;
+      }
+
+      if (batchCount == batchSize)
+      {
+        fitBatch();
+      }
+      else if (batchCount > 0 && inputIterators.front().IsAtEnd())
+      {
+        //last (incomplete) batch: compact the structure of arrays to the stride batchCount
+        for (unsigned int t = 1; t < numberOfInputImages; ++t)
+        {
+          std::copy(signals.begin() + t * batchSize, signals.begin() + t * batchSize + batchCount,
+                    signals.begin() + t * batchCount);
+        }
+        for (unsigned int p = 1; p < numberOfParameters; ++p)
+        {
+          std::copy(initialParameters.begin() + p * batchSize, initialParameters.begin() + p * batchSize + batchCount,
+                    initialParameters.begin() + p * batchCount);
+        }
+        fitBatch();
+      }
+    }
+
+    fitBatch();
+
+    m_FittedVoxelsPerThread[threadId] += fittedVoxels;
+  }
+} // end namespace itk
+
+#endif
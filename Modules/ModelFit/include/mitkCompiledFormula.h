@@ -0,0 +1,126 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __MITKCOMPILEDFORMULA_H__
+#define __MITKCOMPILEDFORMULA_H__
+
+#include <string>
+#include <vector>
+
+#include "mitkFormulaParser.h"
+
+#include "MitkModelFitExports.h"
+
+namespace mitk
+{
+  /*!
+   *	@brief		Formula string that is parsed once and can then be evaluated repeatedly
+   *				without parsing it again.
+   *	@details	The formula is translated into a sequence of stack machine instructions.
+   *				Variables are referenced by their index in the variable name list given on
+   *				construction, so evaluating the formula only needs an array of values and no
+   *				look-up table. Evaluate() with a value array for one of the variables computes
+   *				the formula for all values in one call (e.g. a model function for all time
+   *				points), running each instruction over the whole array.
+   *
+   *				The language is the one of FormulaParser: sums, differences, products,
+   *				divisions, algebraic signs, parentheses, variables and the unary functions
+   *				known to FormulaParser::lookupFunction(). Operations are carried out in the
+   *				same order as by FormulaParser, so the results are the same. Sub expressions
+   *				consisting only of numbers are computed once on construction.
+   *
+   *				A CompiledFormula is immutable after construction, so Evaluate() may be called
+   *				concurrently.
+   */
+  class MITKMODELFIT_EXPORT CompiledFormula
+  {
+  public:
+    using ValueType = FormulaParser::ValueType;
+    using VariableNamesType = std::vector<std::string>;
+
+    /*!
+     *	@brief	Parses the formula.
+     *	@param[in] formula			The formula string (e.g. <code>"a * exp(b * x)"</code>).
+     *	@param[in] variableNames	Names of the variables that may be used in the formula. The
+     *								index of a name is the index of its value in the arrays passed
+     *								to Evaluate().
+     *	@throw FormulaParserException	If the formula cannot be parsed or uses a variable that is not
+     *								in variableNames.
+     */
+    CompiledFormula(const std::string& formula, const VariableNamesType& variableNames);
+
+    /*!
+     *	@brief	Evaluates the formula.
+     *	@param[in] variableValues	One value for each variable name.
+     */
+    ValueType Evaluate(const ValueType* variableValues) const;
+
+    /*!
+     *	@brief	Evaluates the formula for count values of the variable with index vectorVariable.
+     *	@param[in] variableValues	One value for each variable name; the value of vectorVariable is ignored.
+     *	@param[in] vectorVariable	Index of the variable that takes the values of vectorValues.
+     *	@param[in] vectorValues		count values for vectorVariable.
+     *	@param[out] results			count results, results[i] is the formula for vectorValues[i].
+     */
+    void Evaluate(const ValueType* variableValues, std::size_t vectorVariable, const ValueType* vectorValues,
+      std::size_t count, ValueType* results) const;
+
+    const std::string& GetFormula() const { return m_Formula; };
+    const VariableNamesType& GetVariableNames() const { return m_VariableNames; };
+
+  private:
+    enum class OpCode
+    {
+      Constant,
+      Variable,
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Negate,
+      Function
+    };
+
+    struct Instruction
+    {
+      OpCode code;
+      ValueType value;
+      std::size_t variable;
+      FormulaParser::UnaryFunctionType function;
+    };
+
+    using Iterator = std::string::const_iterator;
+
+    /*! the recursive descent parser, one method per rule of the FormulaParser grammar */
+    void ParseExpression(Iterator& pos);
+    void ParseTerm(Iterator& pos);
+    void ParsePrimary(Iterator& pos);
+    bool ParseNumber(Iterator& pos);
+    void SkipSpaces(Iterator& pos) const;
+    void ThrowUnexpected(Iterator pos) const;
+
+    /*! appends the instruction, computing it right away if all its operands are constants */
+    void Emit(const Instruction& instruction);
+
+    std::string m_Formula;
+    VariableNamesType m_VariableNames;
+    std::vector<Instruction> m_Instructions;
+    std::size_t m_StackDepth;
+    std::size_t m_MaxStackDepth;
+  };
+}
+
+#endif
@@ -70,6 +70,7 @@ namespace mitk
   public:
     using ValueType = double;
     using VariableMapType = std::map<std::string, ValueType>;
+    using UnaryFunctionType = ValueType(*)(ValueType);
     /*!
      *	@brief					Construct the FormulaParser and initialized the variables with
      *							@b variables.
@@ -102,6 +103,15 @@ namespace mitk
      */
     ValueType lookupVariable(const std::string var);
 
+    /*!
+     *	@brief			Looks up the unary function (e.g. @c "sin" or @c "abs") with the given
+     *					name.
+     *	@param[in] name	The name of the function.
+     *	@return			The function or @c nullptr if the parser does not know a function
+     *					with this name.
+     */
+    static UnaryFunctionType lookupFunction(const std::string& name);
+
   private:
     /*! @brief Map that holds the values that will replace the variables during evaluation. */
     const VariableMapType* m_Variables;
@@ -17,12 +17,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef __MITK_GENERIC_PARAM_MODEL_H_
 #define __MITK_GENERIC_PARAM_MODEL_H_
 
+#include <memory>
+
 #include "mitkModelBase.h"
 
 #include "MitkModelFitExports.h"
 
 namespace mitk
 {
+  class CompiledFormula;
 
   /** Model that can parse a user specified function string and uses it as model function
   that is represented by the model instance.
@@ -37,6 +40,9 @@ namespace mitk
 
   Remark: The variable "x" is reserved. It is the signal position / timepoint.
   Remark: The current version supports up to 10 model parameter.
+  Remark: The function string is parsed only once into a CompiledFormula, which evaluates all time points in one
+  call. Models with the same function string and number of parameters (e.g. the models generated for each voxel of
+  a fit) share the compiled formula.
   Don't use it for a model parameter that should be deduced by fitting (these are a..j).*/
   class MITKMODELFIT_EXPORT GenericParamModel : public mitk::ModelBase
   {
@@ -64,10 +70,10 @@ namespace mitk
     virtual std::string GetModelType() const override;
 
     virtual FunctionStringType GetFunctionString() const override;
-    itkSetStringMacro(FunctionString);
+    void SetFunctionString(const FunctionStringType& functionString);
 
     /**@pre The Number of paremeters must be between 1 and 10.*/
-    itkSetClampMacro(NumberOfParameters, ParametersSizeType, 1, 10);
+    void SetNumberOfParameters(ParametersSizeType numberOfParameters);
 
     virtual std::string GetXName() const override;
 
@@ -102,6 +108,10 @@ namespace mitk
     /**Number of parameters the model should offer / the function string contains.*/
     ParametersSizeType m_NumberOfParameters;
 
+    /**Function string compiled for the current function string and number of parameters. Reset by the setters and
+    created on demand by ComputeModelfunction.*/
+    mutable std::shared_ptr<const CompiledFormula> m_CompiledFormula;
+
     //No copy constructor allowed
     GenericParamModel(const Self& source);
     void operator=(const Self&);  //purposely not implemented
@@ -64,6 +64,10 @@ namespace mitk
 
     virtual ParameterNamesType GetCriterionNames() const;
 
+    /** Returns a workspace that keeps the cost function and the optimizer of the last fit, so that subsequent
+     * fits only rebind model and signal instead of reinstantiating them.*/
+    virtual std::unique_ptr<FitWorkspace> CreateWorkspace() const;
+
   protected:
 
     typedef Superclass::ParametersType ParametersType;
@@ -80,7 +84,16 @@ namespace mitk
     virtual OutputPixelArrayType GetCriteria(const ModelBase* model, const ParametersType& parameters,
         const SignalType& sample) const;
 
-    /** Generator function that instantiates and parameterizes the cost function that should be used by the fit functor*/
+    virtual ParametersType DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+        const ModelBase::ParametersType& initialParameters,
+        DebugParameterMapType& debugParameters, FitWorkspace& workspace) const;
+
+    virtual OutputPixelArrayType GetCriteriaInWorkspace(const ModelBase* model, const ParametersType& parameters,
+        const SignalType& sample, FitWorkspace& workspace) const;
+
+    /** Generator function that instantiates and parameterizes the cost function that should be used by the fit functor.
+     If the functor fits in a workspace, the cost function is generated once per workspace and afterwards only model and
+     sample are reset (for MVConstrainedCostFunctionDecorator also the ones of the wrapped cost function).*/
     virtual MVModelFitCostFunction::Pointer GenerateCostFunction(const SignalType& value,
         const ModelBase* model) const;
 
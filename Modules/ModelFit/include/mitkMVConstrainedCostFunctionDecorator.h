@@ -78,6 +78,10 @@ public:
 
     /**Returns the index of the first (in terms of index position) failed parameter in the last failed evaluation.*/
     ParametersType::size_type GetFailedParameter() const;
+
+    /**Resets the evaluation, penalty and failure counts and the last failed parameter. Use it if the instance is
+     reused for another fit, so that the ratios only regard the evaluations of the new fit.*/
+    void ResetStatistics();
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const;
@@ -19,6 +19,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkObject.h>
 
+#include <memory>
+
 #include <mitkVector.h>
 
 #include "mitkModelBase.h"
@@ -58,6 +60,34 @@ namespace mitk
     OutputPixelArrayType Compute(const InputPixelArrayType& value, const ModelBase* model,
                                  const ModelBase::ParametersType& initialParameters) const;
 
+    /** Per thread state of a functor that is reused between fits (e.g. signal buffer, cost function and optimizer
+     * instances), so that fitting many signals in a row does not allocate per signal. Derived functors extend it
+     * by overriding CreateWorkspace(). A workspace must not be used by more than one thread at a time.*/
+    class MITKMODELFIT_EXPORT FitWorkspace
+    {
+    public:
+      virtual ~FitWorkspace();
+
+      ModelFitCostFunctionInterface::SignalType m_Sample;
+      ModelBase::ParametersType m_InitialParameters;
+      std::map<std::string, ParameterImagePixelType> m_DebugParameters;
+    };
+
+    /** Creates a new workspace that can be passed to ComputeBatch().*/
+    virtual std::unique_ptr<FitWorkspace> CreateWorkspace() const;
+
+    /** Fits numberOfSignals signals at once. All buffers are structure of arrays:
+     * - signals: value of time point t of signal i is signals[t*numberOfSignals + i]
+     * - initialParameters: parameter p of signal i is initialParameters[p*numberOfSignals + i]
+     * - results: output o (same sequence as for Compute()) of signal i is results[o*numberOfSignals + i]
+     * @param models Model for each signal. The same instance may be passed several times. All models must be of
+     * the same type.
+     * @param workspace Workspace that is reused for all fits of the batch. If it is null, a temporary one is created.
+     * @pre results must provide GetNumberOfOutputs(models[0])*numberOfSignals values.*/
+    void ComputeBatch(const ParameterImagePixelType* signals, unsigned int signalSize, unsigned int numberOfSignals,
+                      const ModelBase* const* models, const ParameterImagePixelType* initialParameters,
+                      ParameterImagePixelType* results, FitWorkspace* workspace = nullptr) const;
+
     /** Returns the number of outputs the fit functor will return if compute is called.
      * The number depends in parts on the passed model.
      * @exception Exception will be thrown if no valid model is passed.*/
@@ -127,8 +157,25 @@ namespace mitk
     if debug is activated. */
     virtual ParameterNamesType DefineDebugParameterNames()const = 0;
 
+    /** Called by Compute() and ComputeBatch() instead of DoModelFit(). Reimplement to reuse the state stored
+    in the workspace (see CreateWorkspace()). The default implementation just calls DoModelFit().*/
+    virtual ParametersType DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+        const ModelBase::ParametersType& initialParameters,
+        DebugParameterMapType& debugParameters, FitWorkspace& workspace) const;
+
+    /** Called by Compute() and ComputeBatch() instead of GetCriteria(). The default implementation just calls
+    GetCriteria().*/
+    virtual OutputPixelArrayType GetCriteriaInWorkspace(const ModelBase* model, const ParametersType& parameters,
+        const SignalType& sample, FitWorkspace& workspace) const;
+
   private:
 
+    /** Fits the signal stored in the workspace and writes the numberOfOutputs outputs to result[0], result[stride], ...*/
+    void ComputeInWorkspace(const ModelBase* model, const ParametersType& initialParameters,
+                            const ParameterNamesType& debugNames, ParameterNamesType::size_type numberOfCriteria,
+                            FitWorkspace& workspace, ParameterImagePixelType* result, std::size_t numberOfOutputs,
+                            std::size_t stride) const;
+
     typedef std::map<std::string, SVModelFitCostFunction::Pointer> CostFunctionMapType;
     CostFunctionMapType m_CostFunctionMap;
     bool m_DebugParameterMaps;
@@ -75,6 +75,15 @@ public:
     itkGetMacro(TimeGridByParameterizer, bool);
     itkBooleanMacro(TimeGridByParameterizer);
 
+    /** Number of voxels each thread collects and passes at once to the fit functor (see
+    itk::BatchedModelFitImageFilter). If set to 0 every voxel is passed on its own via
+    itk::MultiOutputNaryFunctorImageFilter. Default is 256.*/
+    itkSetMacro(BatchSize, unsigned int);
+    itkGetConstMacro(BatchSize, unsigned int);
+
+    /** Returns the number of voxels that were fitted per second by the last generation.*/
+    itkGetConstMacro(VoxelsPerSecond, double);
+
     virtual double GetProgress() const override;
 
     virtual ParameterNamesType GetParameterNames() const override;
@@ -86,7 +95,8 @@ public:
     virtual ParameterNamesType GetEvaluationParameterNames() const override;
 
 protected:
-  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false)
+  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false), m_BatchSize(256),
+    m_VoxelsPerSecond(0)
   {
     m_InternalMask = nullptr;
     m_Mask = nullptr;
@@ -127,6 +137,9 @@ private:
     /**Indicates if the time grid defined in the parameterizer should be used (True)
     or if the filter should extract the time grid from the input image (False).*/
     bool m_TimeGridByParameterizer;
+
+    unsigned int m_BatchSize;
+    double m_VoxelsPerSecond;
 };
 
 }
@@ -0,0 +1,332 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <algorithm>
+#include <cctype>
+#include <locale>
+#include <sstream>
+
+#include "mitkCompiledFormula.h"
+
+namespace mitk
+{
+  CompiledFormula::CompiledFormula(const std::string& formula, const VariableNamesType& variableNames) :
+    m_Formula(formula), m_VariableNames(variableNames), m_StackDepth(0), m_MaxStackDepth(0)
+  {
+    Iterator pos = m_Formula.begin();
+    ParseExpression(pos);
+    SkipSpaces(pos);
+
+    if (pos != m_Formula.end() || m_Instructions.empty())
+    {
+      ThrowUnexpected(pos);
+    }
+  };
+
+  void CompiledFormula::SkipSpaces(Iterator& pos) const
+  {
+    while (pos != m_Formula.end() && std::isspace(static_cast<unsigned char>(*pos)))
+    {
+      ++pos;
+    }
+  };
+
+  void CompiledFormula::ThrowUnexpected(Iterator pos) const
+  {
+    if (pos == m_Formula.end())
+    {
+      mitkThrowException(FormulaParserException) << "Could not parse '" << m_Formula <<
+        "': Unexpected end of input";
+    }
+
+    mitkThrowException(FormulaParserException) << "Error while parsing '" << m_Formula <<
+      "': Unexpected character '" << *pos << "' after '" << std::string(m_Formula.begin(), pos) << "'";
+  };
+
+  // expression = term (('+' | '-') term)*
+  void CompiledFormula::ParseExpression(Iterator& pos)
+  {
+    ParseTerm(pos);
+
+    for (SkipSpaces(pos); pos != m_Formula.end() && (*pos == '+' || *pos == '-'); SkipSpaces(pos))
+    {
+      OpCode code = *pos == '+' ? OpCode::Add : OpCode::Subtract;
+      ParseTerm(++pos);
+      Emit({ code, 0, 0, nullptr });
+    }
+  };
+
+  // term = primary (('*' | '/') primary)*
+  void CompiledFormula::ParseTerm(Iterator& pos)
+  {
+    ParsePrimary(pos);
+
+    for (SkipSpaces(pos); pos != m_Formula.end() && (*pos == '*' || *pos == '/'); SkipSpaces(pos))
+    {
+      OpCode code = *pos == '*' ? OpCode::Multiply : OpCode::Divide;
+      ParsePrimary(++pos);
+      Emit({ code, 0, 0, nullptr });
+    }
+  };
+
+  // primary = number | '(' expression ')' | '-' primary | '+' primary | function '(' expression ')' | variable
+  void CompiledFormula::ParsePrimary(Iterator& pos)
+  {
+    SkipSpaces(pos);
+    if (pos == m_Formula.end())
+    {
+      ThrowUnexpected(pos);
+    }
+
+    if (ParseNumber(pos))
+    {
+      return;
+    }
+
+    if (*pos == '(')
+    {
+      ParseExpression(++pos);
+      SkipSpaces(pos);
+      if (pos == m_Formula.end() || *pos != ')')
+      {
+        ThrowUnexpected(pos);
+      }
+      ++pos;
+    }
+    else if (*pos == '-')
+    {
+      ParsePrimary(++pos);
+      Emit({ OpCode::Negate, 0, 0, nullptr });
+    }
+    else if (*pos == '+')
+    {
+      ParsePrimary(++pos);
+    }
+    else if (std::isalpha(static_cast<unsigned char>(*pos)))
+    {
+      Iterator begin = pos;
+      while (pos != m_Formula.end() && (std::isalnum(static_cast<unsigned char>(*pos)) || *pos == '_'))
+      {
+        ++pos;
+      }
+      std::string name(begin, pos);
+
+      Iterator afterName = pos;
+      SkipSpaces(afterName);
+      FormulaParser::UnaryFunctionType function = FormulaParser::lookupFunction(name);
+      if (function != nullptr && afterName != m_Formula.end() && *afterName == '(')
+      {
+        pos = afterName;
+        ParseExpression(++pos);
+        SkipSpaces(pos);
+        if (pos == m_Formula.end() || *pos != ')')
+        {
+          ThrowUnexpected(pos);
+        }
+        ++pos;
+        Emit({ OpCode::Function, 0, 0, function });
+      }
+      else
+      {
+        auto variable = std::find(m_VariableNames.begin(), m_VariableNames.end(), name);
+        if (variable == m_VariableNames.end())
+        {
+          mitkThrowException(FormulaParserException) << "No variable '" << name << "' defined in lookup";
+        }
+        Emit({ OpCode::Variable, 0, static_cast<std::size_t>(variable - m_VariableNames.begin()), nullptr });
+      }
+    }
+    else
+    {
+      ThrowUnexpected(pos);
+    }
+  };
+
+  // number = digits ['.' digits] [('e' | 'E') ['+' | '-'] digits], with at least one digit before or after the '.'
+  bool CompiledFormula::ParseNumber(Iterator& pos)
+  {
+    Iterator end = pos;
+    std::size_t mantissaDigits = 0;
+    while (end != m_Formula.end() && std::isdigit(static_cast<unsigned char>(*end)))
+    {
+      ++end;
+      ++mantissaDigits;
+    }
+    if (end != m_Formula.end() && *end == '.')
+    {
+      ++end;
+      while (end != m_Formula.end() && std::isdigit(static_cast<unsigned char>(*end)))
+      {
+        ++end;
+        ++mantissaDigits;
+      }
+    }
+    if (mantissaDigits == 0)
+    {
+      return false;
+    }
+
+    // the exponent is only part of the number if it has digits
+    if (end != m_Formula.end() && (*end == 'e' || *end == 'E'))
+    {
+      Iterator exponent = end + 1;
+      if (exponent != m_Formula.end() && (*exponent == '+' || *exponent == '-'))
+      {
+        ++exponent;
+      }
+      if (exponent != m_Formula.end() && std::isdigit(static_cast<unsigned char>(*exponent)))
+      {
+        end = exponent;
+        while (end != m_Formula.end() && std::isdigit(static_cast<unsigned char>(*end)))
+        {
+          ++end;
+        }
+      }
+    }
+
+    std::istringstream stream(std::string(pos, end));
+    stream.imbue(std::locale::classic());
+    ValueType value = 0;
+    stream >> value;
+    pos = end;
+
+    Emit({ OpCode::Constant, value, 0, nullptr });
+    return true;
+  };
+
+  void CompiledFormula::Emit(const Instruction& instruction)
+  {
+    switch (instruction.code)
+    {
+    case OpCode::Constant:
+    case OpCode::Variable:
+      m_MaxStackDepth = std::max(m_MaxStackDepth, ++m_StackDepth);
+      break;
+    case OpCode::Negate:
+    case OpCode::Function:
+      if (m_Instructions.back().code == OpCode::Constant)
+      {
+        ValueType& value = m_Instructions.back().value;
+        value = instruction.code == OpCode::Negate ? -value : instruction.function(value);
+        return;
+      }
+      break;
+    default:
+      --m_StackDepth;
+      std::size_t size = m_Instructions.size();
+      if (m_Instructions[size - 2].code == OpCode::Constant && m_Instructions[size - 1].code == OpCode::Constant)
+      {
+        ValueType& left = m_Instructions[size - 2].value;
+        const ValueType right = m_Instructions[size - 1].value;
+        switch (instruction.code)
+        {
+        case OpCode::Add: left += right; break;
+        case OpCode::Subtract: left -= right; break;
+        case OpCode::Multiply: left *= right; break;
+        default: left /= right; break;
+        }
+        m_Instructions.pop_back();
+        return;
+      }
+      break;
+    }
+
+    m_Instructions.push_back(instruction);
+  };
+
+  CompiledFormula::ValueType CompiledFormula::Evaluate(const ValueType* variableValues) const
+  {
+    ValueType result = 0;
+    Evaluate(variableValues, m_VariableNames.size(), nullptr, 1, &result);
+    return result;
+  };
+
+  void CompiledFormula::Evaluate(const ValueType* variableValues, std::size_t vectorVariable,
+    const ValueType* vectorValues, std::size_t count, ValueType* results) const
+  {
+    if (count == 0)
+    {
+      return;
+    }
+
+    // the bottom of the stack is the result array itself
+    std::vector<ValueType> stack(m_MaxStackDepth > 1 ? (m_MaxStackDepth - 1) * count : 0);
+    auto slot = [&](std::size_t depth) { return depth == 0 ? results : stack.data() + (depth - 1) * count; };
+
+    std::size_t depth = 0;
+    for (const auto& instruction : m_Instructions)
+    {
+      switch (instruction.code)
+      {
+      case OpCode::Constant:
+        std::fill(slot(depth), slot(depth) + count, instruction.value);
+        ++depth;
+        break;
+      case OpCode::Variable:
+        if (instruction.variable == vectorVariable)
+        {
+          std::copy(vectorValues, vectorValues + count, slot(depth));
+        }
+        else
+        {
+          std::fill(slot(depth), slot(depth) + count, variableValues[instruction.variable]);
+        }
+        ++depth;
+        break;
+      case OpCode::Negate:
+      {
+        ValueType* values = slot(depth - 1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          values[i] = -values[i];
+        }
+        break;
+      }
+      case OpCode::Function:
+      {
+        ValueType* values = slot(depth - 1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          values[i] = instruction.function(values[i]);
+        }
+        break;
+      }
+      default:
+      {
+        --depth;
+        ValueType* left = slot(depth - 1);
+        const ValueType* right = slot(depth);
+        switch (instruction.code)
+        {
+        case OpCode::Add:
+          for (std::size_t i = 0; i < count; ++i) left[i] += right[i];
+          break;
+        case OpCode::Subtract:
+          for (std::size_t i = 0; i < count; ++i) left[i] -= right[i];
+          break;
+        case OpCode::Multiply:
+          for (std::size_t i = 0; i < count; ++i) left[i] *= right[i];
+          break;
+        default:
+          for (std::size_t i = 0; i < count; ++i) left[i] /= right[i];
+          break;
+        }
+        break;
+      }
+      }
+    }
+  };
+}
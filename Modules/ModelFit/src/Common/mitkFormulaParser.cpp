@@ -113,6 +113,34 @@ namespace mitk
     return static_cast<T>(fresnel_c(x) / boost::math::constants::root_two_div_pi<T>());
   }
 
+  /*!
+   *	@brief	Helper structure that maps strings to function calls so that parsing e.g.
+   *			@c "cos(0)" actually calls the @c std::cos function with parameter @c 1 so it
+   *			returns @c 0.
+   */
+  class unaryFunction_ :
+    public qi::symbols<typename std::iterator_traits<Iter>::value_type, FormulaParser::ValueType(*)(FormulaParser::ValueType)>
+  {
+  public:
+    /*!
+     *	@brief Constructs the structure, this is where the mapping takes place.
+     */
+    unaryFunction_()
+    {
+      this->add
+      ("abs", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::abs))
+        ("exp", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::exp)) // @TODO: exp ignores division by zero
+        ("sin", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::sin))
+        ("cos", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::cos))
+        ("tan", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::tan))
+        ("sind", &sind)
+        ("cosd", &cosd)
+        ("tand", &tand)
+        ("fresnelS", &fresnelS)
+        ("fresnelC", &fresnelC);
+    }
+  };
+
   /*!
    *	@brief		The grammar that defines the language (i.e. what is allowed) for the parser.
    */
@@ -160,33 +188,8 @@ namespace mitk
       }
     };
 
-    /*!
-     *	@brief	Helper structure that maps strings to function calls so that parsing e.g.
-     *			@c "cos(0)" actually calls the @c std::cos function with parameter @c 1 so it
-     *			returns @c 0.
-     */
-    class unaryFunction_ :
-      public qi::symbols<typename std::iterator_traits<Iter>::value_type, FormulaParser::ValueType(*)(FormulaParser::ValueType)>
-    {
-    public:
-      /*!
-       *	@brief Constructs the structure, this is where the mapping takes place.
-       */
-      unaryFunction_()
-      {
-        this->add
-        ("abs", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::abs))
-          ("exp", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::exp)) // @TODO: exp ignores division by zero
-          ("sin", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::sin))
-          ("cos", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::cos))
-          ("tan", static_cast<FormulaParser::ValueType(*)(FormulaParser::ValueType)>(&std::tan))
-          ("sind", &sind)
-          ("cosd", &cosd)
-          ("tand", &tand)
-          ("fresnelS", &fresnelS)
-          ("fresnelC", &fresnelC);
-      }
-    } unaryFunction;
+    /*! the functions known to the grammar. */
+    unaryFunction_ unaryFunction;
 
   public:
     /*!
@@ -274,6 +277,13 @@ namespace mitk
     return result;
   };
 
+  FormulaParser::UnaryFunctionType FormulaParser::lookupFunction(const std::string& name)
+  {
+    static unaryFunction_ functions;
+    UnaryFunctionType* function = functions.find(name);
+    return function != nullptr ? *function : nullptr;
+  };
+
   FormulaParser::ValueType FormulaParser::lookupVariable(const std::string var)
   {
     if (m_Variables == NULL)
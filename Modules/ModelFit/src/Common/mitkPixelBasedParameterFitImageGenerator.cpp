@@ -16,6 +16,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkCommand.h"
 #include "itkMultiOutputNaryFunctorImageFilter.h"
+#include "itkBatchedModelFitImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <chrono>
 
 #include "mitkPixelBasedParameterFitImageGenerator.h"
 #include "mitkImageTimeSelector.h"
@@ -89,8 +93,23 @@ void
   using ParameterImageType = itk::Image<ScalarType, VDim-1>;
 
   using FitFilterType = itk::MultiOutputNaryFunctorImageFilter<InputFrameImageType, ParameterImageType, ModelFitFunctorPolicy, InternalMaskType>;
+  using BatchedFitFilterType = itk::BatchedModelFitImageFilter<InputFrameImageType, ParameterImageType, InternalMaskType>;
+
+  typename BatchedFitFilterType::Pointer batchedFitFilter;
+  typename FitFilterType::Pointer voxelFitFilter;
+  typename itk::ImageToImageFilter<InputFrameImageType, ParameterImageType>::Pointer fitFilter;
 
-  typename FitFilterType::Pointer fitFilter = FitFilterType::New();
+  if (this->m_BatchSize > 0)
+  {
+    batchedFitFilter = BatchedFitFilterType::New();
+    batchedFitFilter->SetBatchSize(this->m_BatchSize);
+    fitFilter = batchedFitFilter.GetPointer();
+  }
+  else
+  {
+    voxelFitFilter = FitFilterType::New();
+    fitFilter = voxelFitFilter.GetPointer();
+  }
 
   typename ::itk::MemberCommand<Self>::Pointer spProgressCommand = ::itk::MemberCommand<Self>::New();
   spProgressCommand->SetCallbackFunction(this, &Self::onFitProgressEvent);
@@ -126,18 +145,56 @@ void
     this->m_ModelParameterizer->SetDefaultTimeGrid(timeGrid);
   }
 
-  ModelFitFunctorPolicy functor;
-
-  functor.SetModelFitFunctor(this->m_FitFunctor); 
-  functor.SetModelParameterizer(this->m_ModelParameterizer);
-  fitFilter->SetFunctor(functor);
-  if (this->m_InternalMask.IsNotNull())
+  if (batchedFitFilter.IsNotNull())
   {
-    fitFilter->SetMask(this->m_InternalMask);
+    batchedFitFilter->SetFitFunctor(this->m_FitFunctor);
+    batchedFitFilter->SetModelParameterizer(this->m_ModelParameterizer);
+    if (this->m_InternalMask.IsNotNull())
+    {
+      batchedFitFilter->SetMask(this->m_InternalMask);
+    }
+  }
+  else
+  {
+    ModelFitFunctorPolicy functor;
+
+    functor.SetModelFitFunctor(this->m_FitFunctor);
+    functor.SetModelParameterizer(this->m_ModelParameterizer);
+    voxelFitFilter->SetFunctor(functor);
+    if (this->m_InternalMask.IsNotNull())
+    {
+      voxelFitFilter->SetMask(this->m_InternalMask);
+    }
   }
 
   //generate the fits
+  const auto startTime = std::chrono::steady_clock::now();
   fitFilter->Update();
+  const double fitDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  unsigned long numberOfFittedVoxels = 0;
+  if (batchedFitFilter.IsNotNull())
+  {
+    numberOfFittedVoxels = batchedFitFilter->GetNumberOfFittedVoxels();
+  }
+  else if (this->m_InternalMask.IsNotNull())
+  {
+    for (itk::ImageRegionConstIterator<InternalMaskType> maskIt(this->m_InternalMask, this->m_InternalMask->GetLargestPossibleRegion()); !maskIt.IsAtEnd(); ++maskIt)
+    {
+      if (maskIt.Get() > 0)
+      {
+        ++numberOfFittedVoxels;
+      }
+    }
+  }
+  else
+  {
+    numberOfFittedVoxels = fitFilter->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+  }
+
+  this->m_VoxelsPerSecond = fitDuration > 0 ? numberOfFittedVoxels / fitDuration : 0;
+  MITK_INFO << "Parameter Fit Generator. Fitted " << numberOfFittedVoxels << " voxels in " << fitDuration << " s ("
+            << this->m_VoxelsPerSecond << " voxels/s; batch size: " << this->m_BatchSize << ").";
 
   //convert the outputs into mitk images and fill the parameter image map
   ModelBaseType::Pointer refModel = this->m_ModelParameterizer->GenerateParameterizedModel();
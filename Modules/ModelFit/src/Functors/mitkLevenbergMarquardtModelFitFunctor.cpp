@@ -21,6 +21,42 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <chrono>
 #include <mitkExceptionMacro.h>
 
+namespace
+{
+  /** Workspace of the functor. Cost functions and optimizer are instantiated by the first fit and reused by all
+   following fits of the workspace.*/
+  class LevenbergMarquardtWorkspace : public mitk::ModelFitFunctorBase::FitWorkspace
+  {
+  public:
+    mitk::MVModelFitCostFunction::Pointer m_CostFunction;
+    ::itk::LevenbergMarquardtOptimizer::Pointer m_Optimizer;
+    mitk::SumOfSquaredDifferencesFitCostFunction::Pointer m_CriterionMetric;
+    unsigned int m_NumberOfParameters = 0;
+    unsigned int m_NumberOfValues = 0;
+  };
+
+  void RebindCostFunction(mitk::MVModelFitCostFunction* costFunction, const mitk::ModelBase* model,
+                          const mitk::MVModelFitCostFunction::SignalType& value)
+  {
+    costFunction->SetModel(model);
+    costFunction->SetSample(value);
+
+    auto* decorator = dynamic_cast<mitk::MVConstrainedCostFunctionDecorator*>(costFunction);
+    if (decorator)
+    {
+      decorator->ResetStatistics();
+      //break constness to rebind the wrapped cost function. It was generated by GenerateCostFunction() for
+      //this workspace only, so nobody else depends on its state.
+      auto* wrapped = const_cast<mitk::MVModelFitCostFunction*>(decorator->GetWrappedCostFunction());
+      if (wrapped)
+      {
+        wrapped->SetModel(model);
+        wrapped->SetSample(value);
+      }
+    }
+  }
+}
+
 mitk::LevenbergMarquardtModelFitFunctor::
 LevenbergMarquardtModelFitFunctor(): m_Epsilon(1e-5), m_GradientTolerance(1e-3),
   m_ValueTolerance(1e-5), m_Iterations(1000), m_DerivativeStepLength(1e-5),
@@ -45,17 +81,42 @@ mitk::LevenbergMarquardtModelFitFunctor::
 GetCriteria(const ModelBase* model, const ParametersType& parameters,
               const SignalType& sample) const
 {
-  ::mitk::SumOfSquaredDifferencesFitCostFunction::Pointer metric
-    = ::mitk::SumOfSquaredDifferencesFitCostFunction::New();
-  metric->SetModel(model);
-  metric->SetSample(sample);
+  LevenbergMarquardtWorkspace workspace;
+  return this->GetCriteriaInWorkspace(model, parameters, sample, workspace);
+};
+
+mitk::LevenbergMarquardtModelFitFunctor::OutputPixelArrayType
+mitk::LevenbergMarquardtModelFitFunctor::
+GetCriteriaInWorkspace(const ModelBase* model, const ParametersType& parameters,
+                       const SignalType& sample, FitWorkspace& workspace) const
+{
+  LevenbergMarquardtWorkspace tempWorkspace;
+  auto* lmWorkspace = dynamic_cast<LevenbergMarquardtWorkspace*>(&workspace);
+  if (!lmWorkspace)
+  {
+    lmWorkspace = &tempWorkspace;
+  }
+
+  if (lmWorkspace->m_CriterionMetric.IsNull())
+  {
+    lmWorkspace->m_CriterionMetric = ::mitk::SumOfSquaredDifferencesFitCostFunction::New();
+  }
+
+  lmWorkspace->m_CriterionMetric->SetModel(model);
+  lmWorkspace->m_CriterionMetric->SetSample(sample);
 
   mitk::LevenbergMarquardtModelFitFunctor::OutputPixelArrayType result(1);
-  result[0] = metric->GetValue(parameters);
+  result[0] = lmWorkspace->m_CriterionMetric->GetValue(parameters);
 
   return result;
 };
 
+std::unique_ptr<mitk::ModelFitFunctorBase::FitWorkspace>
+mitk::LevenbergMarquardtModelFitFunctor::CreateWorkspace() const
+{
+  return std::unique_ptr<FitWorkspace>(new LevenbergMarquardtWorkspace);
+};
+
 mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::GenerateCostFunction(
   const SignalType& value, const ModelBase* model) const
 {
@@ -105,6 +166,16 @@ mitk::LevenbergMarquardtModelFitFunctor::
 DoModelFit(const SignalType& value, const ModelBase* model,
            const ModelBase::ParametersType& initialParameters,
            DebugParameterMapType& debugParameters) const
+{
+  LevenbergMarquardtWorkspace workspace;
+  return this->DoModelFitInWorkspace(value, model, initialParameters, debugParameters, workspace);
+};
+
+mitk::LevenbergMarquardtModelFitFunctor::ParametersType
+mitk::LevenbergMarquardtModelFitFunctor::
+DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                      const ModelBase::ParametersType& initialParameters,
+                      DebugParameterMapType& debugParameters, FitWorkspace& workspace) const
 {
     std::chrono::time_point<std::chrono::system_clock> startTime;
     startTime = std::chrono::system_clock::now();
@@ -127,11 +198,42 @@ DoModelFit(const SignalType& value, const ModelBase* model,
     scales.Fill(1.0);
   }
 
-  mitk::MVModelFitCostFunction::Pointer metric = this->GenerateCostFunction(value, model);
+  LevenbergMarquardtWorkspace tempWorkspace;
+  auto* lmWorkspace = dynamic_cast<LevenbergMarquardtWorkspace*>(&workspace);
+  if (!lmWorkspace)
+  {
+    lmWorkspace = &tempWorkspace;
+  }
 
-  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+  bool newCostFunction = false;
+  if (lmWorkspace->m_CostFunction.IsNull())
+  {
+    lmWorkspace->m_CostFunction = this->GenerateCostFunction(value, model);
+    newCostFunction = true;
+  }
+  else
+  {
+    RebindCostFunction(lmWorkspace->m_CostFunction, model, value);
+  }
+
+  mitk::MVModelFitCostFunction::Pointer metric = lmWorkspace->m_CostFunction;
+
+  if (lmWorkspace->m_Optimizer.IsNull())
+  {
+    lmWorkspace->m_Optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+  }
+
+  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = lmWorkspace->m_Optimizer;
+
+  //setting the cost function instantiates the vnl optimizer for the problem size, so only do it if needed.
+  if (newCostFunction || lmWorkspace->m_NumberOfParameters != model->GetNumberOfParameters() ||
+      lmWorkspace->m_NumberOfValues != value.GetSize())
+  {
+    optimizer->SetCostFunction(metric);
+    lmWorkspace->m_NumberOfParameters = model->GetNumberOfParameters();
+    lmWorkspace->m_NumberOfValues = value.GetSize();
+  }
 
-  optimizer->SetCostFunction(metric);
   optimizer->SetEpsilonFunction(m_Epsilon);
   optimizer->SetGradientTolerance(m_GradientTolerance);
   optimizer->SetNumberOfIterations(m_Iterations);
@@ -85,3 +85,13 @@ GetFailedParameter() const
 {
   return m_LastFailedParameter;
 };
+
+void
+mitk::MVConstrainedCostFunctionDecorator::
+ResetStatistics()
+{
+  m_EvaluationCount = 0;
+  m_PenaltyCount = 0;
+  m_FailureCount = 0;
+  m_LastFailedParameter = -1;
+};
@@ -16,6 +16,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkModelFitFunctorBase.h"
 
+mitk::ModelFitFunctorBase::FitWorkspace::~FitWorkspace()
+{};
+
+std::unique_ptr<mitk::ModelFitFunctorBase::FitWorkspace>
+mitk::ModelFitFunctorBase::CreateWorkspace() const
+{
+  return std::unique_ptr<FitWorkspace>(new FitWorkspace);
+};
+
 mitk::ModelFitFunctorBase::OutputPixelArrayType
 mitk::ModelFitFunctorBase::
 Compute(const InputPixelArrayType& value, const ModelBase* model,
@@ -32,76 +41,157 @@ Compute(const InputPixelArrayType& value, const ModelBase* model,
                       << model->GetNumberOfParameters() << "; Initial parameters: " << initialParameters);
   }
 
-  SignalType sample(value.size());
+  std::unique_ptr<FitWorkspace> workspace = this->CreateWorkspace();
 
-  for (SignalType::SizeValueType i = 0; i < sample.Size(); ++i)
+  workspace->m_Sample.SetSize(value.size());
+  for (SignalType::SizeValueType i = 0; i < workspace->m_Sample.Size(); ++i)
   {
-    sample[i] = value [i];
+    workspace->m_Sample[i] = value [i];
   }
 
-  DebugParameterMapType debugParams;
-  ParameterNamesType debugNames;
-  if (this->m_DebugParameterMaps)
+  ParameterNamesType debugNames = this->GetDebugParameterNames();
+
+  OutputPixelArrayType result(this->GetNumberOfOutputs(model));
+  this->ComputeInWorkspace(model, initialParameters, debugNames, this->GetCriterionNames().size(), *workspace,
+                           result.data(), result.size(), 1);
+
+  return result;
+};
+
+void
+mitk::ModelFitFunctorBase::
+ComputeBatch(const ParameterImagePixelType* signals, unsigned int signalSize, unsigned int numberOfSignals,
+             const ModelBase* const* models, const ParameterImagePixelType* initialParameters,
+             ParameterImagePixelType* results, FitWorkspace* workspace) const
+{
+  if (numberOfSignals == 0)
   {
-    debugNames = this->GetDebugParameterNames();
+    return;
   }
 
-  ParametersType fittedParameters = DoModelFit(sample, model, initialParameters, debugParams);
+  if (!models || !models[0])
+  {
+    itkExceptionMacro("Cannot compute fit. Passed model is not defined.");
+  }
+
+  std::unique_ptr<FitWorkspace> tempWorkspace;
+  if (!workspace)
+  {
+    tempWorkspace = this->CreateWorkspace();
+    workspace = tempWorkspace.get();
+  }
+
+  const ParametersType::SizeValueType numberOfParameters = models[0]->GetNumberOfParameters();
+  const ParameterNamesType debugNames = this->GetDebugParameterNames();
+  const ParameterNamesType::size_type numberOfCriteria = this->GetCriterionNames().size();
+  const std::size_t numberOfOutputs = this->GetNumberOfOutputs(models[0]);
+
+  workspace->m_Sample.SetSize(signalSize);
+  workspace->m_InitialParameters.SetSize(numberOfParameters);
+
+  for (unsigned int i = 0; i < numberOfSignals; ++i)
+  {
+    if (!models[i] || models[i]->GetNumberOfParameters() != numberOfParameters)
+    {
+      itkExceptionMacro("Cannot compute fit. Models of the batch are not defined or differ in their parameter count. Invalid signal: " << i);
+    }
+
+    for (unsigned int t = 0; t < signalSize; ++t)
+    {
+      workspace->m_Sample[t] = signals[t * numberOfSignals + i];
+    }
+
+    for (ParametersType::SizeValueType p = 0; p < numberOfParameters; ++p)
+    {
+      workspace->m_InitialParameters[p] = initialParameters[p * numberOfSignals + i];
+    }
+
+    this->ComputeInWorkspace(models[i], workspace->m_InitialParameters, debugNames, numberOfCriteria, *workspace,
+                             results + i, numberOfOutputs, numberOfSignals);
+  }
+};
+
+void
+mitk::ModelFitFunctorBase::
+ComputeInWorkspace(const ModelBase* model, const ParametersType& initialParameters,
+                   const ParameterNamesType& debugNames, ParameterNamesType::size_type numberOfCriteria,
+                   FitWorkspace& workspace, ParameterImagePixelType* result, std::size_t numberOfOutputs,
+                   std::size_t stride) const
+{
+  const SignalType& sample = workspace.m_Sample;
+
+  ParametersType fittedParameters = DoModelFitInWorkspace(sample, model, initialParameters,
+                                    workspace.m_DebugParameters, workspace);
 
   OutputPixelArrayType derivedParameters = this->GetDerivedParameters(model, fittedParameters);
 
-  OutputPixelArrayType criteria = this->GetCriteria(model, fittedParameters, sample);
+  OutputPixelArrayType criteria = this->GetCriteriaInWorkspace(model, fittedParameters, sample, workspace);
 
   OutputPixelArrayType evaluationParameters = this->GetEvaluationParameters(model, fittedParameters,
       sample);
 
-  if (criteria.size() != this->GetCriterionNames().size())
+  if (criteria.size() != numberOfCriteria)
   {
     itkExceptionMacro("ModelFitInfo implementation seems to be inconsitent. Number of criterion values is not equal to number of criterion names.");
   }
 
-  OutputPixelArrayType result(fittedParameters.Size() + derivedParameters.size() + criteria.size() +
-                              evaluationParameters.size() + debugNames.size());
-
-  for (ParametersType::SizeValueType i = 0; i < fittedParameters.Size(); ++i)
+  if (fittedParameters.Size() + derivedParameters.size() + criteria.size() + evaluationParameters.size() +
+      debugNames.size() != numberOfOutputs)
   {
-    result[i] = fittedParameters[i];
+    itkExceptionMacro("ModelFitInfo implementation seems to be inconsitent. Number of fit results is not equal to the number of outputs. Number of outputs: " << numberOfOutputs);
   }
 
-  OutputPixelArrayType::size_type offset = fittedParameters.Size();
+  std::size_t pos = 0;
+
+  for (ParametersType::SizeValueType i = 0; i < fittedParameters.Size(); ++i, ++pos)
+  {
+    result[pos * stride] = fittedParameters[i];
+  }
 
-  for (OutputPixelArrayType::size_type j = 0; j < derivedParameters.size(); ++j)
+  for (OutputPixelArrayType::size_type j = 0; j < derivedParameters.size(); ++j, ++pos)
   {
-    result[offset + j] = derivedParameters[j];
+    result[pos * stride] = derivedParameters[j];
   }
 
-  offset += derivedParameters.size();
-  for (OutputPixelArrayType::size_type j = 0; j < criteria.size(); ++j)
+  for (OutputPixelArrayType::size_type j = 0; j < criteria.size(); ++j, ++pos)
   {
-    result[offset + j] = criteria[j];
+    result[pos * stride] = criteria[j];
   }
 
-  offset += criteria.size();
-  for (OutputPixelArrayType::size_type j = 0; j < evaluationParameters.size(); ++j)
+  for (OutputPixelArrayType::size_type j = 0; j < evaluationParameters.size(); ++j, ++pos)
   {
-    result[offset + j] = evaluationParameters[j];
+    result[pos * stride] = evaluationParameters[j];
   }
 
-  offset += evaluationParameters.size();
-  for (OutputPixelArrayType::size_type j = 0; j < debugNames.size(); ++j)
+  for (OutputPixelArrayType::size_type j = 0; j < debugNames.size(); ++j, ++pos)
   {
-    DebugParameterMapType::const_iterator pos = debugParams.find(debugNames[j]);
-    if (pos == debugParams.end())
+    DebugParameterMapType::const_iterator finding = workspace.m_DebugParameters.find(debugNames[j]);
+    if (finding == workspace.m_DebugParameters.end())
     {
       itkExceptionMacro("ModelFitInfo implementation seems to be inconsitent. Debug parameter defined by functor is not in its returned debug map. Invalid debug parameter name: "<<debugNames[j]);
     }
     else
     {
-      result[offset + j] = pos->second;
+      result[pos * stride] = finding->second;
     }
   }
+};
 
-  return result;
+mitk::ModelFitFunctorBase::ParametersType
+mitk::ModelFitFunctorBase::
+DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                      const ModelBase::ParametersType& initialParameters,
+                      DebugParameterMapType& debugParameters, FitWorkspace& /*workspace*/) const
+{
+  return this->DoModelFit(value, model, initialParameters, debugParameters);
+};
+
+mitk::ModelFitFunctorBase::OutputPixelArrayType
+mitk::ModelFitFunctorBase::
+GetCriteriaInWorkspace(const ModelBase* model, const ParametersType& parameters,
+                       const SignalType& sample, FitWorkspace& /*workspace*/) const
+{
+  return this->GetCriteria(model, parameters, sample);
 };
 
 unsigned int
@@ -14,8 +14,44 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 ===================================================================*/
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+
 #include "mitkGenericParamModel.h"
-#include "mitkFormulaParser.h"
+#include "mitkCompiledFormula.h"
+
+namespace
+{
+  /** Returns the compiled formula for the given formula and variables. Formulas are compiled only once as long as
+  any model still uses them.*/
+  std::shared_ptr<const mitk::CompiledFormula> GetCompiledFormula(const std::string& formula,
+    const mitk::CompiledFormula::VariableNamesType& variableNames)
+  {
+    static std::mutex cacheMutex;
+    static std::map<std::string, std::weak_ptr<const mitk::CompiledFormula> > cache;
+
+    std::string key = formula;
+    for (const auto& name : variableNames)
+    {
+      key += '\n' + name;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_ptr<const mitk::CompiledFormula> compiled = cache[key].lock();
+    if (!compiled)
+    {
+      for (auto pos = cache.begin(); pos != cache.end();)
+      {
+        pos = pos->second.expired() ? cache.erase(pos) : ++pos;
+      }
+
+      compiled = std::make_shared<const mitk::CompiledFormula>(formula, variableNames);
+      cache[key] = compiled;
+    }
+    return compiled;
+  }
+}
 
 const std::string mitk::GenericParamModel::NAME_STATIC_PARAMETER_number = "number_of_parameters";
 
@@ -34,6 +70,27 @@ mitk::GenericParamModel::FunctionStringType mitk::GenericParamModel::GetFunction
   return m_FunctionString;
 };
 
+void mitk::GenericParamModel::SetFunctionString(const FunctionStringType& functionString)
+{
+  if (functionString != m_FunctionString)
+  {
+    m_FunctionString = functionString;
+    m_CompiledFormula.reset();
+    this->Modified();
+  }
+};
+
+void mitk::GenericParamModel::SetNumberOfParameters(ParametersSizeType numberOfParameters)
+{
+  numberOfParameters = std::max<ParametersSizeType>(1, std::min<ParametersSizeType>(10, numberOfParameters));
+  if (numberOfParameters != m_NumberOfParameters)
+  {
+    m_NumberOfParameters = numberOfParameters;
+    m_CompiledFormula.reset();
+    this->Modified();
+  }
+};
+
 std::string mitk::GenericParamModel::GetXName() const
 {
   return "x";
@@ -101,27 +158,22 @@ mitk::GenericParamModel::ComputeModelfunction(const ParametersType& parameters)
   unsigned int timeSteps = m_TimeGrid.GetSize();
   ModelResultType signal(timeSteps);
 
-  std::map<std::string, double> parameterMap;
-  parameterMap.insert(std::make_pair(GetXName(), 0.0));
-
-  auto paramNames = this->GetParameterNames();
-  for (ParametersType::size_type i = 0; i < parameters.size(); ++i)
+  if (!m_CompiledFormula)
   {
-    parameterMap.insert(std::make_pair(paramNames[i], parameters[i]));
+    // variable 0 is x, followed by the parameters
+    CompiledFormula::VariableNamesType variableNames = this->GetParameterNames();
+    variableNames.insert(variableNames.begin(), GetXName());
+    m_CompiledFormula = GetCompiledFormula(m_FunctionString, variableNames);
   }
 
-  FormulaParser formulaParser(&parameterMap);
-
-  TimeGridType::const_iterator timeGridEnd = m_TimeGrid.end();
-  ModelResultType::iterator signalPos = signal.begin();
-
-  for (TimeGridType::const_iterator gridPos = m_TimeGrid.begin(); gridPos != timeGridEnd;
-       ++gridPos, ++signalPos)
+  std::vector<double> variableValues(m_CompiledFormula->GetVariableNames().size(), 0.0);
+  for (ParametersType::size_type i = 0; i < parameters.size() && i + 1 < variableValues.size(); ++i)
   {
-    parameterMap[GetXName()] = *gridPos;
-    *signalPos = formulaParser.parse(m_FunctionString);
+    variableValues[i + 1] = parameters[i];
   }
 
+  m_CompiledFormula->Evaluate(variableValues.data(), 0, m_TimeGrid.data_block(), timeSteps, signal.data_block());
+
   return signal;
 };
 
@@ -168,6 +220,8 @@ itk::LightObject::Pointer mitk::GenericParamModel::InternalClone() const
 
   newClone->SetTimeGrid(this->m_TimeGrid);
   newClone->SetNumberOfParameters(this->m_NumberOfParameters);
+  newClone->SetFunctionString(this->m_FunctionString);
+  newClone->m_CompiledFormula = this->m_CompiledFormula;
 
   return newClone.GetPointer();
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkCompiledFormula.h"
+#include "mitkFormulaParser.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mitk;
+
+class CompiledFormulaTests
+{
+public:
+  static void TestErrors()
+  {
+    CompiledFormula::VariableNamesType names = { "x", "test" };
+
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("_", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("5=", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("a", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("(1+2", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("sin(x", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("2 3", names));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula("x*", names));
+  }
+
+  /*! compares the compiled formula with FormulaParser, both evaluated per value and for all values at once */
+  static void TestEqualsParser(const std::string& formula)
+  {
+    CompiledFormula::VariableNamesType names = { "x", "a", "b", "test_var_" };
+    std::vector<double> values = { 0, 1.5, -0.25, 17 };
+    std::vector<double> xValues = { -3, -0.5, 0, 0.1, 1, 2.5, 10, 90 };
+
+    std::map<std::string, double> varMap;
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+      varMap[names[i]] = values[i];
+    }
+    FormulaParser parser(&varMap);
+
+    CompiledFormula compiled(formula, names);
+    std::vector<double> vectorResults(xValues.size());
+    compiled.Evaluate(values.data(), 0, xValues.data(), xValues.size(), vectorResults.data());
+
+    bool equal = true;
+    for (std::size_t i = 0; i < xValues.size(); ++i)
+    {
+      varMap["x"] = values[0] = xValues[i];
+      double expected = parser.parse(formula);
+      // number literals are converted independently of boost::spirit, allow for rounding differences
+      double tolerance = 1e-12 * std::max(1.0, std::abs(expected));
+      equal = equal && std::abs(compiled.Evaluate(values.data()) - expected) <= tolerance &&
+        std::abs(vectorResults[i] - expected) <= tolerance;
+    }
+
+    MITK_TEST_CONDITION_REQUIRED(equal, "Testing if '" << formula << "' gives the results of FormulaParser");
+  }
+};
+
+int mitkCompiledFormulaTest(int, char *[])
+{
+  MITK_TEST_BEGIN("CompiledFormula Test");
+
+  CompiledFormulaTests::TestErrors();
+
+  CompiledFormulaTests::TestEqualsParser("1+2");
+  CompiledFormulaTests::TestEqualsParser("x");
+  CompiledFormulaTests::TestEqualsParser("-7 + +1 - -1");
+  CompiledFormulaTests::TestEqualsParser("(1+2)*(4-2) / 3");
+  CompiledFormulaTests::TestEqualsParser("2*test_var_-test_var_");
+  CompiledFormulaTests::TestEqualsParser("a + b * x - x / 3 * a");
+  CompiledFormulaTests::TestEqualsParser("a*exp(b*x)");
+  CompiledFormulaTests::TestEqualsParser(" 3.5 + 4 * x * sin(x) - 1 / 2 ");
+  CompiledFormulaTests::TestEqualsParser("abs(-x) + cos (x) + tan(x/100)");
+  CompiledFormulaTests::TestEqualsParser("sind(x) * cosd(x) - tand(a)");
+  CompiledFormulaTests::TestEqualsParser("fresnelS(x) + fresnelC(b)");
+  CompiledFormulaTests::TestEqualsParser("-(x - -a) * -b");
+  CompiledFormulaTests::TestEqualsParser("1.5e2 * .5 + 2. - 1E-3 * x");
+  CompiledFormulaTests::TestEqualsParser("exp(-(x-a)*(x-a)/(2*b*b))");
+
+  MITK_TEST_END();
+}
@@ -85,5 +85,39 @@ int mitkLevenbergMarquardtModelFitFunctorTest(int  /*argc*/, char*[] /*argv[]*/)
   MITK_TEST_CONDITION_REQUIRED(mitk::Equal(-5, output[2], 1e-6, true) == true,
                                "Check derived parameter 1 (x-intercept) for sample 2.");
 
+  //Test batched computation (structure of arrays buffers, shared workspace)
+  std::vector<double> signals(2 * 10);
+  for (int i = 0; i < 10; ++i)
+  {
+    signals[i * 2] = sample1[i];
+    signals[i * 2 + 1] = sample2[i];
+  }
+  std::vector<double> batchInitParams(2 * 2, 0.0);
+  std::vector<double> batchResults(4 * 2, -1.0);
+  const mitk::ModelBase* batchModels[2] = { model, model };
+
+  auto workspace = testFunctor->CreateWorkspace();
+  testFunctor->ComputeBatch(signals.data(), 10, 2, batchModels, batchInitParams.data(), batchResults.data(), workspace.get());
+
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(5, batchResults[0], 1e-6, true) == true,
+                               "Check fitted parameter 1 (slope) for sample 1 in batch.");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(2, batchResults[1], 1e-6, true) == true,
+                               "Check fitted parameter 1 (slope) for sample 2 in batch.");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0, batchResults[2], 1e-6, true) == true,
+                               "Check fitted parameter 2 (offset) for sample 1 in batch.");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(10, batchResults[3], 1e-6, true) == true,
+                               "Check fitted parameter 2 (offset) for sample 2 in batch.");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(-5, batchResults[5], 1e-6, true) == true,
+                               "Check derived parameter 1 (x-intercept) for sample 2 in batch.");
+
+  //a reused workspace must produce the same results as a fresh one
+  testFunctor->ComputeBatch(signals.data(), 10, 2, batchModels, batchInitParams.data(), batchResults.data(), workspace.get());
+  output = testFunctor->Compute(sample2, model, initParams);
+  for (unsigned int i = 0; i < output.size(); ++i)
+  {
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(output[i], batchResults[i * 2 + 1], 1e-10, true) == true,
+                                 "Check output " << i << " of reused workspace.");
+  }
+
   MITK_TEST_END()
 }
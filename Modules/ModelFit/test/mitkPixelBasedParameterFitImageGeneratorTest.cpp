@@ -155,5 +155,25 @@ int mitkPixelBasedParameterFitImageGeneratorTest(int  /*argc*/, char*[] /*argv[]
     testValue = offsetAccessor2.GetPixelByIndex(testIndex6);
     MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #6");
 
+    //Test that batch sizes that do not divide the number of masked voxels and the voxel wise fit produce the same results
+    std::vector<itk::Index<3> > testIndices = { testIndex1, testIndex2, testIndex3, testIndex4, testIndex5, testIndex6 };
+    for (unsigned int batchSize : { 0u, 1u, 3u })
+    {
+      generator->SetBatchSize(batchSize);
+      generator->Generate();
+
+      mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType batchResultImages = generator->GetParameterImages();
+      mitk::ImagePixelReadAccessor<mitk::ScalarType,3> batchSlopeAccessor(batchResultImages["slope"]);
+      mitk::ImagePixelReadAccessor<mitk::ScalarType,3> batchOffsetAccessor(batchResultImages["offset"]);
+
+      for (const auto& index : testIndices)
+      {
+        MITK_TEST_CONDITION_REQUIRED(mitk::Equal(slopeAccessor2.GetPixelByIndex(index), batchSlopeAccessor.GetPixelByIndex(index), 1e-4, true)==true, "Check param #1 (slope) with batch size " << batchSize << " at index " << index);
+        MITK_TEST_CONDITION_REQUIRED(mitk::Equal(offsetAccessor2.GetPixelByIndex(index), batchOffsetAccessor.GetPixelByIndex(index), 1e-5, true)==true, "Check param #2 (offset) with batch size " << batchSize << " at index " << index);
+      }
+    }
+
+    MITK_TEST_CONDITION(generator->GetVoxelsPerSecond() > 0, "Check if the fit throughput is reported.");
+
   MITK_TEST_END()
 }
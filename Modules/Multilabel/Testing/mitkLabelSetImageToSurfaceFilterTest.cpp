@@ -0,0 +1,151 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkITKImageImport.h>
+#include <mitkLabelSetImageToSurfaceFilter.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+
+#include <vtkPolyData.h>
+
+class mitkLabelSetImageToSurfaceFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageToSurfaceFilterTestSuite);
+
+  MITK_TEST(GenerateAllLabels_OneSurfacePerLabel);
+  MITK_TEST(RequestedLabel_SurfaceOfLabel);
+  MITK_TEST(RequestedLabelMissing_Throws);
+  MITK_TEST(LabelAtImageBorder_SurfaceIsOpenAtBorder);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<mitk::Label::PixelType, 3> ItkImageType;
+
+  mitk::Image::Pointer m_Image;
+
+  static void FillBox(ItkImageType *image, int x0, int y0, int z0, unsigned int size, mitk::Label::PixelType value)
+  {
+    ItkImageType::IndexType index = {{x0, y0, z0}};
+    ItkImageType::SizeType boxSize = {{size, size, size}};
+    itk::ImageRegionIterator<ItkImageType> it(image, ItkImageType::RegionType(index, boxSize));
+    for (; !it.IsAtEnd(); ++it)
+      it.Set(value);
+  }
+
+  /** Checks that the surface is not empty and lies within the box (plus one voxel). */
+  void CheckSurfaceInBox(mitk::Surface *surface, int x0, int y0, int z0, unsigned int size)
+  {
+    CPPUNIT_ASSERT(surface != nullptr);
+    vtkPolyData *polyData = surface->GetVtkPolyData();
+    CPPUNIT_ASSERT(polyData != nullptr);
+    CPPUNIT_ASSERT(polyData->GetNumberOfPoints() > 0);
+
+    double bounds[6];
+    polyData->GetBounds(bounds);
+    const int box[3] = {x0, y0, z0};
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Surface exceeds the lower bound of its label", bounds[2 * d] >= box[d] - 1.0);
+      CPPUNIT_ASSERT_MESSAGE("Surface exceeds the upper bound of its label",
+                             bounds[2 * d + 1] <= box[d] + static_cast<double>(size));
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    ItkImageType::Pointer itkImage = ItkImageType::New();
+    ItkImageType::SizeType size = {{30, 30, 30}};
+    itkImage->SetRegions(size);
+    itkImage->Allocate();
+    itkImage->FillBuffer(0);
+
+    FillBox(itkImage, 2, 2, 2, 8, 1);
+    FillBox(itkImage, 18, 16, 14, 10, 2);
+
+    m_Image = mitk::GrabItkImageMemory(itkImage);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void GenerateAllLabels_OneSurfacePerLabel()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), static_cast<std::size_t>(filter->GetNumberOfIndexedOutputs()));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), filter->GetAvailableLabels().size());
+    CPPUNIT_ASSERT_EQUAL(8ul * 8 * 8, filter->GetAvailableLabels().at(1));
+    CPPUNIT_ASSERT_EQUAL(10ul * 10 * 10, filter->GetAvailableLabels().at(2));
+
+    CPPUNIT_ASSERT_EQUAL(mitk::LabelSetImageToSurfaceFilter::LabelType(1), filter->GetLabelOfOutput(0));
+    CPPUNIT_ASSERT_EQUAL(mitk::LabelSetImageToSurfaceFilter::LabelType(2), filter->GetLabelOfOutput(1));
+    CPPUNIT_ASSERT_THROW(filter->GetLabelOfOutput(2), mitk::Exception);
+
+    CheckSurfaceInBox(filter->GetOutput(0), 2, 2, 2, 8);
+    CheckSurfaceInBox(filter->GetOutput(1), 18, 16, 14, 10);
+  }
+
+  void RequestedLabel_SurfaceOfLabel()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetRequestedLabel(2);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(mitk::LabelSetImageToSurfaceFilter::LabelType(2), filter->GetLabelOfOutput(0));
+    CheckSurfaceInBox(filter->GetOutput(), 18, 16, 14, 10);
+  }
+
+  void RequestedLabelMissing_Throws()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetRequestedLabel(3);
+    CPPUNIT_ASSERT_THROW(filter->Update(), itk::ExceptionObject);
+  }
+
+  void LabelAtImageBorder_SurfaceIsOpenAtBorder()
+  {
+    ItkImageType::Pointer itkImage = ItkImageType::New();
+    ItkImageType::SizeType size = {{20, 20, 20}};
+    itkImage->SetRegions(size);
+    itkImage->Allocate();
+    itkImage->FillBuffer(0);
+    FillBox(itkImage, 0, 6, 6, 8, 1);
+
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(mitk::GrabItkImageMemory(itkImage));
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+
+    CheckSurfaceInBox(filter->GetOutput(0), 0, 6, 6, 8);
+
+    // the crop region is clipped to the image, so the surface ends at the first slice instead of being closed outside
+    double bounds[6];
+    filter->GetOutput(0)->GetVtkPolyData()->GetBounds(bounds);
+    CPPUNIT_ASSERT_MESSAGE("Surface is closed outside of the image", bounds[0] >= -mitk::eps);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageToSurfaceFilter)
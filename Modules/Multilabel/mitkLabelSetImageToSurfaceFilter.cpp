@@ -18,15 +18,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
+#include <mitkParallelFor.h>
 
 // itk
 #include <itkAntiAliasBinaryImageFilter.h>
-#include <itkAutoCropLabelMapFilter.h>
-#include <itkBinaryThresholdImageFilter.h>
-#include <itkLabelImageToLabelMapFilter.h>
-#include <itkLabelMap.h>
-#include <itkLabelMapToLabelImageFilter.h>
-#include <itkLabelObject.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <itkImageScanlineConstIterator.h>
 #include <itkNumericTraits.h>
 #include <itkSmoothingRecursiveGaussianImageFilter.h>
 
@@ -36,8 +34,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkMarchingCubes.h>
+#include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
+#include <algorithm>
+
+namespace
+{
+  // border of background voxels around the bounding box of a label, needed by the anti-aliasing
+  const itk::IndexValueType CROP_BORDER = 3;
+}
+
 mitk::LabelSetImageToSurfaceFilter::LabelSetImageToSurfaceFilter()
   : m_GenerateAllLabels(false), m_RequestedLabel(1), m_BackgroundLabel(0), m_UseSmoothing(0), m_Sigma(0.1)
 {
@@ -58,6 +65,17 @@ void mitk::LabelSetImageToSurfaceFilter::SetObserver(mitk::ProcessObserver::Poin
    m_Observer = observer;
 }
 */
+mitk::LabelSetImageToSurfaceFilter::LabelType mitk::LabelSetImageToSurfaceFilter::GetLabelOfOutput(
+  unsigned int idx) const
+{
+  auto iter = m_IndexToLabels.find(idx);
+  if (iter == m_IndexToLabels.end())
+  {
+    mitkThrow() << "No surface was generated for output " << idx << ".";
+  }
+  return iter->second;
+}
+
 const mitk::Image *mitk::LabelSetImageToSurfaceFilter::GetInput(void)
 {
   if (this->GetNumberOfInputs() < 1)
@@ -91,52 +109,221 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
                                                             mitk::Surface * /*surface*/)
 {
   typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::IndexType IndexType;
 
-  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> BinaryThresholdFilterType;
-  typedef itk::LabelObject<TPixel, VDimension> LabelObjectType;
-  typedef itk::LabelMap<LabelObjectType> LabelMapType;
-  typedef itk::LabelImageToLabelMapFilter<ImageType, LabelMapType> Image2LabelMapType;
-  typedef itk::AutoCropLabelMapFilter<LabelMapType> AutoCropType;
-  typedef itk::LabelMapToLabelImageFilter<LabelMapType, ImageType> LabelMap2ImageType;
+  struct LabelRegion
+  {
+    IndexType Min;
+    IndexType Max;
+    unsigned long NumberOfVoxels;
+  };
+  typedef std::map<TPixel, LabelRegion> LabelRegionMapType;
+
+  const TPixel background = static_cast<TPixel>(m_BackgroundLabel);
+
+  // Find the bounding boxes of all labels in one sweep. The image is split into slabs along the slowest
+  // dimension, each slab is scanned by one thread and the bounding boxes are merged afterwards.
+  const RegionType largestRegion = input->GetLargestPossibleRegion();
+  const unsigned int slowestDimension = VDimension - 1;
+  const itk::SizeValueType maximumNumberOfSlabs = 4 * mitk::GetParallelForNumberOfThreads();
+  const unsigned int numberOfSlabs = static_cast<unsigned int>(std::max<itk::SizeValueType>(
+    1, std::min<itk::SizeValueType>(largestRegion.GetSize(slowestDimension), maximumNumberOfSlabs)));
+  std::vector<LabelRegionMapType> slabLabelRegions(numberOfSlabs);
+
+  mitk::ParallelFor(numberOfSlabs, [&](unsigned int slab) {
+    const itk::SizeValueType numberOfLayers = largestRegion.GetSize(slowestDimension);
+    const itk::SizeValueType firstLayer = numberOfLayers * slab / numberOfSlabs;
+    const itk::SizeValueType endLayer = numberOfLayers * (slab + 1) / numberOfSlabs;
+    if (firstLayer == endLayer)
+      return;
+
+    RegionType slabRegion = largestRegion;
+    slabRegion.SetIndex(slowestDimension,
+                        largestRegion.GetIndex(slowestDimension) + static_cast<itk::IndexValueType>(firstLayer));
+    slabRegion.SetSize(slowestDimension, endLayer - firstLayer);
+
+    LabelRegionMapType &labelRegions = slabLabelRegions[slab];
+    itk::ImageScanlineConstIterator<ImageType> it(input, slabRegion);
+    while (!it.IsAtEnd())
+    {
+      IndexType index = it.GetIndex();
+      LabelRegion *labelRegion = nullptr;
+      TPixel currentLabel = background;
+
+      for (; !it.IsAtEndOfLine(); ++it, ++index[0])
+      {
+        const TPixel value = it.Get();
+        if (value == background)
+          continue;
+
+        // labels come in runs along a scanline, so the map only has to be searched when the label changes
+        if (nullptr == labelRegion || value != currentLabel)
+        {
+          labelRegion = &labelRegions.insert(std::make_pair(value, LabelRegion{index, index, 0})).first->second;
+          currentLabel = value;
+        }
+
+        for (unsigned int d = 0; d < VDimension; ++d)
+        {
+          labelRegion->Min[d] = std::min(labelRegion->Min[d], index[d]);
+          labelRegion->Max[d] = std::max(labelRegion->Max[d], index[d]);
+        }
+        ++labelRegion->NumberOfVoxels;
+      }
+      it.NextLine();
+    }
+  });
+
+  LabelRegionMapType labelRegions;
+  for (const auto &slab : slabLabelRegions)
+  {
+    for (const auto &slabLabelRegion : slab)
+    {
+      auto inserted = labelRegions.insert(slabLabelRegion);
+      if (inserted.second)
+        continue;
+
+      LabelRegion &labelRegion = inserted.first->second;
+      for (unsigned int d = 0; d < VDimension; ++d)
+      {
+        labelRegion.Min[d] = std::min(labelRegion.Min[d], slabLabelRegion.second.Min[d]);
+        labelRegion.Max[d] = std::max(labelRegion.Max[d], slabLabelRegion.second.Max[d]);
+      }
+      labelRegion.NumberOfVoxels += slabLabelRegion.second.NumberOfVoxels;
+    }
+  }
 
-  typedef itk::Image<float, VDimension> RealImageType;
+  m_AvailableLabels.clear();
+  for (const auto &labelRegion : labelRegions)
+    m_AvailableLabels[static_cast<LabelType>(labelRegion.first)] = labelRegion.second.NumberOfVoxels;
 
-  typedef itk::AntiAliasBinaryImageFilter<ImageType, RealImageType> AntiAliasFilterType;
-  typedef itk::SmoothingRecursiveGaussianImageFilter<RealImageType, RealImageType> GaussianFilterType;
+  std::vector<TPixel> labels;
+  if (m_GenerateAllLabels)
+  {
+    for (const auto &labelRegion : labelRegions)
+      labels.push_back(labelRegion.first);
+  }
+  else
+  {
+    if (labelRegions.find(static_cast<TPixel>(m_RequestedLabel)) == labelRegions.end())
+      throw itk::ExceptionObject(__FILE__, __LINE__, "requested label is not present in the image.");
 
-  typename BinaryThresholdFilterType::Pointer thresholdFilter = BinaryThresholdFilterType::New();
-  thresholdFilter->SetInput(input);
-  thresholdFilter->SetLowerThreshold(m_RequestedLabel);
-  thresholdFilter->SetUpperThreshold(m_RequestedLabel);
-  thresholdFilter->SetOutsideValue(0);
-  thresholdFilter->SetInsideValue(1);
-  //  thresholdFilter->ReleaseDataFlagOn();
-  thresholdFilter->Update();
+    labels.push_back(static_cast<TPixel>(m_RequestedLabel));
+  }
 
-  typename Image2LabelMapType::Pointer image2label = Image2LabelMapType::New();
-  image2label->SetInput(thresholdFilter->GetOutput());
+  // Crop region of each label: its bounding box plus a border, clipped to the image, so labels at the border of the
+  // image keep open surfaces there.
+  std::vector<RegionType> cropRegions(labels.size());
+  double totalCropVolume = 0.0;
+  for (size_t i = 0; i < labels.size(); ++i)
+  {
+    const LabelRegion &labelRegion = labelRegions.at(labels[i]);
+
+    IndexType cropIndex;
+    typename RegionType::SizeType cropSize;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      cropIndex[d] = labelRegion.Min[d] - CROP_BORDER;
+      cropSize[d] = static_cast<itk::SizeValueType>(labelRegion.Max[d] - labelRegion.Min[d] + 1 + 2 * CROP_BORDER);
+    }
+
+    cropRegions[i] = RegionType(cropIndex, cropSize);
+    cropRegions[i].Crop(largestRegion);
+    totalCropVolume += cropRegions[i].GetNumberOfPixels();
+  }
 
-  typename AutoCropType::SizeType border;
-  border[0] = 3;
-  border[1] = 3;
-  border[2] = 3;
+  // The labels are processed in parallel, largest crop region first, so a big label does not start last and keep a
+  // single thread busy after all others finished. Each label pipeline gets a share of the threads according to the
+  // size of its crop region, so a label dominating the image still runs multi-threaded.
+  std::vector<size_t> processingOrder(labels.size());
+  for (size_t i = 0; i < processingOrder.size(); ++i)
+    processingOrder[i] = i;
+  std::stable_sort(processingOrder.begin(), processingOrder.end(), [&cropRegions](size_t a, size_t b) {
+    return cropRegions[a].GetNumberOfPixels() > cropRegions[b].GetNumberOfPixels();
+  });
+
+  const unsigned int numberOfThreads = mitk::GetParallelForNumberOfThreads();
+  std::vector<vtkSmartPointer<vtkPolyData>> polyDatas(labels.size());
+
+  mitk::ParallelFor(labels.size(), [&](unsigned int n) {
+    const size_t i = processingOrder[n];
+    const unsigned int numberOfLabelThreads = std::max(
+      1u,
+      static_cast<unsigned int>(numberOfThreads * cropRegions[i].GetNumberOfPixels() / totalCropVolume + 0.5));
+
+    try
+    {
+      polyDatas[i] = this->GenerateLabelSurface(input, labels[i], cropRegions[i], numberOfLabelThreads);
+    }
+    catch (const std::exception &e)
+    {
+      // a single failing label must not cancel the surfaces of all other labels
+      if (!m_GenerateAllLabels)
+        throw;
+
+      MITK_WARN << "Could not generate surface of label "
+                << static_cast<typename itk::NumericTraits<TPixel>::PrintType>(labels[i]) << ": " << e.what();
+      polyDatas[i] = vtkSmartPointer<vtkPolyData>::New();
+    }
+  });
+
+  // one output per label
+  const unsigned int numberOfOutputs = std::max<unsigned int>(1, labels.size());
+  this->SetNumberOfIndexedOutputs(numberOfOutputs);
+  for (unsigned int i = 0; i < numberOfOutputs; ++i)
+  {
+    if (this->GetOutput(i) == nullptr)
+      this->SetNthOutput(i, this->MakeOutput(i));
+  }
 
-  typename AutoCropType::Pointer autoCropFilter = AutoCropType::New();
-  autoCropFilter->SetInput(image2label->GetOutput());
-  autoCropFilter->SetCropBorder(border);
-  autoCropFilter->InPlaceOn();
+  m_IndexToLabels.clear();
+  for (unsigned int i = 0; i < labels.size(); ++i)
+  {
+    m_IndexToLabels[i] = static_cast<LabelType>(labels[i]);
+    this->GetOutput(i)->SetVtkPolyData(polyDatas[i], 0);
+  }
 
-  typename LabelMap2ImageType::Pointer label2image = LabelMap2ImageType::New();
-  label2image->SetInput(autoCropFilter->GetOutput());
+  if (labels.empty())
+    this->GetOutput(0)->SetVtkPolyData(vtkSmartPointer<vtkPolyData>::New(), 0);
+}
 
-  label2image->Update();
+template <typename TPixel, unsigned int VDimension>
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageToSurfaceFilter::GenerateLabelSurface(
+  const itk::Image<TPixel, VDimension> *input,
+  TPixel label,
+  const typename itk::Image<TPixel, VDimension>::RegionType &region,
+  unsigned int numberOfThreads)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef typename ImageType::RegionType RegionType;
+
+  typedef itk::Image<float, VDimension> RealImageType;
+
+  typedef itk::AntiAliasBinaryImageFilter<ImageType, RealImageType> AntiAliasFilterType;
+  typedef itk::SmoothingRecursiveGaussianImageFilter<RealImageType, RealImageType> GaussianFilterType;
+
+  // binary image of the label within the crop region
+  typename ImageType::Pointer binaryImage = ImageType::New();
+  binaryImage->SetRegions(region);
+  binaryImage->SetSpacing(input->GetSpacing());
+  binaryImage->SetOrigin(input->GetOrigin());
+  binaryImage->SetDirection(input->GetDirection());
+  binaryImage->Allocate();
+
+  itk::ImageRegionConstIterator<ImageType> inputIt(input, region);
+  itk::ImageRegionIterator<ImageType> binaryIt(binaryImage, region);
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++binaryIt)
+    binaryIt.Set(inputIt.Get() == label ? 1 : 0);
 
   typename AntiAliasFilterType::Pointer antiAliasFilter = AntiAliasFilterType::New();
-  antiAliasFilter->SetInput(label2image->GetOutput());
+  antiAliasFilter->SetInput(binaryImage);
   antiAliasFilter->SetMaximumRMSError(0.001);
   antiAliasFilter->SetNumberOfLayers(3);
   antiAliasFilter->SetUseImageSpacing(false);
   antiAliasFilter->SetNumberOfIterations(40);
+  if (numberOfThreads > 0)
+    antiAliasFilter->SetNumberOfThreads(numberOfThreads);
 
   antiAliasFilter->Update();
 
@@ -147,6 +334,8 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
     typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
     gaussianFilter->SetSigma(m_Sigma);
     gaussianFilter->SetInput(antiAliasFilter->GetOutput());
+    if (numberOfThreads > 0)
+      gaussianFilter->SetNumberOfThreads(numberOfThreads);
     gaussianFilter->Update();
     result = gaussianFilter->GetOutput();
   }
@@ -157,21 +346,18 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 
   result->DisconnectPipeline();
 
-  typename ImageType::RegionType cropRegion;
-  cropRegion = autoCropFilter->GetOutput()->GetLargestPossibleRegion();
-
-  const typename ImageType::IndexType &cropIndex = cropRegion.GetIndex();
+  const typename ImageType::IndexType &cropIndex = region.GetIndex();
 
-  m_ResultImage = mitk::Image::New();
-  mitk::CastToMitkImage(result, m_ResultImage);
+  mitk::Image::Pointer resultImage = mitk::Image::New();
+  mitk::CastToMitkImage(result, resultImage);
 
-  mitk::BaseGeometry *newGeometry = m_ResultImage->GetSlicedGeometry();
+  mitk::BaseGeometry *newGeometry = resultImage->GetSlicedGeometry();
   mitk::Point3D origin;
   vtk2itk(cropIndex, origin);
   this->GetInput()->GetGeometry()->IndexToWorld(origin, origin);
   newGeometry->SetOrigin(origin);
 
-  auto *vtkimage = m_ResultImage->GetVtkImageData(0);
+  auto *vtkimage = resultImage->GetVtkImageData(0);
 
   vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
     vtkSmartPointer<vtkImageChangeInformation>::New();
@@ -223,6 +409,5 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   cleanPolyDataFilter->PointMergingOn();
   cleanPolyDataFilter->Update();
 
-  mitk::Surface::Pointer output = this->GetOutput(0);
-  output->SetVtkPolyData(cleanPolyDataFilter->GetOutput(), 0);
+  return cleanPolyDataFilter->GetOutput();
 }
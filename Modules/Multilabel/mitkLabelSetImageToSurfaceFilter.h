@@ -33,7 +33,13 @@ namespace mitk
   /**
    * Generates surface meshes from a labelset image.
    * If you want to calculate a surface representation for all available labels,
-   * you may call GenerateAllLabelsOn().
+   * you may call GenerateAllLabelsOn(). In that case there is one output per label
+   * present in the image, see GetLabelOfOutput().
+   *
+   * The bounding boxes of all labels are determined in a single parallel sweep over
+   * the image. Each label is then extracted from its bounding box only, so small
+   * labels are cheap, and several labels are processed in parallel, the largest
+   * ones first and with a share of the threads according to their size.
    */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceFilter : public SurfaceSource
   {
@@ -109,6 +115,18 @@ namespace mitk
      */
     itkSetMacro(Sigma, float);
 
+    /**
+     * Returns the label the surface of the given output was generated for.
+     * Only valid after an update.
+     */
+    LabelType GetLabelOfOutput(unsigned int idx) const;
+
+    /**
+     * Returns the number of voxels of each label (except the background) found
+     * in the input during the last update.
+     */
+    const LabelMapType &GetAvailableLabels() const { return m_AvailableLabels; }
+
   protected:
     LabelSetImageToSurfaceFilter();
 
@@ -128,11 +146,20 @@ namespace mitk
       out[2] = z;
     }
 
-    mitk::Image::Pointer m_ResultImage;
-
     template <typename TPixel, unsigned int VImageDimension>
     void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input, mitk::Surface *surface);
 
+    /**
+     * Creates the surface of a single label, only considering the given region of the input.
+     * The ITK filters use numberOfThreads threads, or their default if it is 0.
+     */
+    template <typename TPixel, unsigned int VImageDimension>
+    vtkSmartPointer<vtkPolyData> GenerateLabelSurface(
+      const itk::Image<TPixel, VImageDimension> *input,
+      TPixel label,
+      const typename itk::Image<TPixel, VImageDimension>::RegionType &region,
+      unsigned int numberOfThreads);
+
     bool m_GenerateAllLabels;
 
     int m_RequestedLabel;
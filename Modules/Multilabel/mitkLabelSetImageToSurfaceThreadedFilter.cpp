@@ -16,12 +16,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkLabelSetImageToSurfaceThreadedFilter.h"
 
-#include "mitkLabelSetImage.h"
 #include "mitkLabelSetImageToSurfaceFilter.h"
 
+#include <vtkPolyData.h>
+
 namespace mitk
 {
-  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1), m_Result(nullptr)
+  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter()
+    : m_RequestedLabel(1), m_GenerateAllLabels(false)
   {
   }
 
@@ -74,10 +76,20 @@ namespace mitk
       MITK_WARN << "\"RequestedLabel\" parameter was not set: will use the default value (" << m_RequestedLabel << ").";
     }
 
+    m_GenerateAllLabels = false;
+    try
+    {
+      this->GetParameter("GenerateAllLabels", m_GenerateAllLabels);
+    }
+    catch (std::invalid_argument &)
+    {
+      // optional parameter, only the requested label is generated by default
+    }
+
     mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
     filter->SetInput(image);
     //  filter->SetObserver(obsv);
-    filter->SetGenerateAllLabels(false);
+    filter->SetGenerateAllLabels(m_GenerateAllLabels);
     filter->SetRequestedLabel(m_RequestedLabel);
     filter->SetUseSmoothing(useSmoothing);
 
@@ -101,14 +113,18 @@ namespace mitk
       return false;
     }
 
-    m_Result = filter->GetOutput();
-
-    if (m_Result.IsNull() || !m_Result->GetVtkPolyData())
-      return false;
+    m_Results.clear();
+    for (unsigned int i = 0; i < filter->GetNumberOfIndexedOutputs(); ++i)
+    {
+      Surface::Pointer result = filter->GetOutput(i);
+      if (result.IsNull() || !result->GetVtkPolyData() || !result->GetVtkPolyData()->GetNumberOfPoints())
+        continue;
 
-    m_Result->DisconnectPipeline();
+      result->DisconnectPipeline();
+      m_Results[filter->GetLabelOfOutput(i)] = result;
+    }
 
-    return true;
+    return !m_Results.empty();
   }
 
   void LabelSetImageToSurfaceThreadedFilter::ThreadedUpdateSuccessful()
@@ -116,17 +132,29 @@ namespace mitk
     LabelSetImage::Pointer image;
     this->GetPointerParameter("Input", image);
 
-    std::string name = this->GetGroupNode()->GetName();
-    name.append("-surf");
+    for (const auto &result : m_Results)
+    {
+      mitk::Label *label = image->GetLabel(result.first, image->GetActiveLayer());
 
-    mitk::DataNode::Pointer node = mitk::DataNode::New();
-    node->SetData(m_Result);
-    node->SetName(name);
+      std::string name = this->GetGroupNode()->GetName();
+      if (m_GenerateAllLabels)
+      {
+        name.append("-");
+        name.append(label ? label->GetName() : std::to_string(result.first));
+      }
+      name.append("-surf");
+
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetData(result.second);
+      node->SetName(name);
 
-    mitk::Color color = image->GetLabel(m_RequestedLabel, image->GetActiveLayer())->GetColor();
-    node->SetColor(color);
+      if (label)
+        node->SetColor(label->GetColor());
+
+      this->InsertBelowGroupNode(node);
+    }
 
-    this->InsertBelowGroupNode(node);
+    m_Results.clear();
 
     Superclass::ThreadedUpdateSuccessful();
   }
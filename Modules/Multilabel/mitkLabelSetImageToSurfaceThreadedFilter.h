@@ -17,12 +17,20 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef __mitkLabelSetImageToSurfaceThreadedFilter_H_
 #define __mitkLabelSetImageToSurfaceThreadedFilter_H_
 
+#include "mitkLabelSetImage.h"
 #include "mitkSegmentationSink.h"
 #include "mitkSurface.h"
 #include <MitkMultilabelExports.h>
 
+#include <map>
+
 namespace mitk
 {
+  /**
+   * Creates the surface of the label "RequestedLabel" of the labelset image "Input" in a thread. If the bool parameter
+   * "GenerateAllLabels" is true, the surfaces of all labels of the image are created in one pass instead, and one node
+   * per label is inserted below the group node.
+   */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceThreadedFilter : public SegmentationSink
   {
   public:
@@ -42,7 +50,8 @@ namespace mitk
 
   private:
     int m_RequestedLabel;
-    Surface::Pointer m_Result;
+    bool m_GenerateAllLabels;
+    std::map<LabelSetImage::PixelType, Surface::Pointer> m_Results;
   };
 
 } // namespace
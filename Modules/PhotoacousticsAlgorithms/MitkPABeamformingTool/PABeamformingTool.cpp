@@ -36,6 +36,7 @@ struct InputParameters
   float angle;
   unsigned int samples;
   mitk::BeamformingSettings::BeamformingAlgorithm algorithm;
+  unsigned int benchmarkRepetitions;
 };
 
 InputParameters parseInput(int argc, char* argv[])
@@ -78,6 +79,9 @@ InputParameters parseInput(int argc, char* argv[])
   parser.addArgument(
     "algorithm", "alg", mitkCommandLineParser::String,
     "one of [\"DAS\", \"DMAS\", \"sDMAS\"]", "The beamforming algorithm to be used for reconstruction (default: DAS).");
+  parser.addArgument(
+    "benchmark", "b", mitkCommandLineParser::Int,
+    "number of benchmark repetitions", "Beamforms the input image this many additional times and reports the images per second on the CPU (default: 0).");
   parser.endGroup();
 
   InputParameters input;
@@ -176,6 +180,15 @@ InputParameters parseInput(int argc, char* argv[])
     MITK_INFO(input.verbose) << "No matching algorithm found. Using DAS.";
   }
 
+  if (parsedArgs.count("benchmark"))
+  {
+    input.benchmarkRepetitions = us::any_cast<int>(parsedArgs["benchmark"]);
+  }
+  else
+  {
+    input.benchmarkRepetitions = 0;
+  }
+
   return input;
 }
 
@@ -218,6 +231,19 @@ int main(int argc, char * argv[])
   auto floatImage = castFilter->GetOutput();
 
   auto output = m_BeamformingService->ApplyBeamforming(floatImage, settings);
+
+  if (input.benchmarkRepetitions > 0)
+  {
+    // the first run above computed the delay tables, so this measures the steady state frame rate
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < input.benchmarkRepetitions; ++i)
+      m_BeamformingService->ApplyBeamforming(floatImage, settings);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / 1e9;
+    double images = (double)input.benchmarkRepetitions * floatImage->GetDimension(2);
+    MITK_INFO << "Benchmark: beamformed " << images << " images in " << seconds << " s (" << images / seconds << " images per second)";
+  }
   MITK_INFO(input.verbose) << "Applying BModeFilter to image...";
   auto output2 = m_BeamformingService->ApplyBmodeFilter(output, mitk::PhotoacousticFilterService::EnvelopeDetection, false);
   MITK_INFO(input.verbose) << "Applying BModeFilter to image...[Done]";
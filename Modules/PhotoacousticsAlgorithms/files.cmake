@@ -11,6 +11,8 @@ set(CPP_FILES
   source/OpenCLFilter/mitkPhotoacousticBModeFilter.cpp
   source/utils/mitkPhotoacousticFilterService.cpp
   source/utils/mitkBeamformingUtils.cpp
+  source/utils/mitkPhotoacousticWorkerPool.cpp
+  source/utils/mitkPhotoacousticFramePipeline.cpp
   source/mitkPhotoacousticMotionCorrectionFilter.cpp
 )
 
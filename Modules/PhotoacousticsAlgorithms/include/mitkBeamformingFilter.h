@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImageToImageFilter.h"
 #include <functional>
+#include <vector>
 #include "./OpenCLFilter/mitkPhotoacousticOCLBeamformingFilter.h"
 #include "mitkBeamformingSettings.h"
 #include "mitkBeamformingUtils.h"
@@ -48,6 +49,22 @@ namespace mitk {
     */
     void SetProgressHandle(std::function<void(int, std::string)> progressHandle);
 
+    /** \brief Returns the configuration the filter was created with
+    */
+    BeamformingSettings::Pointer GetConfig() const { return m_Conf; }
+
+    /** \brief Maximum size in bytes of the delay table the CPU implementation keeps between updates (default: 256 MB)
+    *
+    *  The delays and apodization weights only depend on the configuration and the image dimensions, so they are computed once and
+    *  reused for all following frames of the same size. If the table would need more memory, the delays are computed again for every frame.
+    */
+    itkSetMacro(MaximumDelayTableSize, unsigned long);
+    itkGetConstMacro(MaximumDelayTableSize, unsigned long);
+
+    /** \brief Number of images beamformed per second by the last update
+    */
+    itkGetConstMacro(FramesPerSecond, double);
+
   protected:
     BeamformingFilter(mitk::BeamformingSettings::Pointer settings);
 
@@ -59,6 +76,10 @@ namespace mitk {
 
     void GenerateData() override;
 
+    /** \brief Recomputes m_DelayTable if the image dimensions changed since it was computed
+    */
+    void UpdateDelayTable(float inputDim[2], float outputDim[2]);
+
     //##Description
     //## @brief Time when Header was last initialized
     itk::TimeStamp m_TimeOfHeaderInitialization;
@@ -83,6 +104,18 @@ namespace mitk {
     /** \brief Pointer to the GPU beamforming filter class; for performance reasons the filter is initialized within the constructor and kept for all later computations.
     */
     mitk::PhotoacousticOCLBeamformingFilter::Pointer m_BeamformingOclFilter;
+
+    /** \brief Delays of every reconstruction line for the CPU implementation; empty if they exceed m_MaximumDelayTableSize
+    */
+    std::vector<BeamformingUtils::LineDelays> m_DelayTable;
+
+    /** \brief Input and output dimensions m_DelayTable was computed for
+    */
+    float m_DelayTableDimensions[4];
+
+    unsigned long m_MaximumDelayTableSize;
+
+    double m_FramesPerSecond;
   };
 } // namespace mitk
 
@@ -19,18 +19,68 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImageToImageFilter.h"
 #include <functional>
+#include <vector>
 #include "./OpenCLFilter/mitkPhotoacousticOCLBeamformingFilter.h"
 #include "mitkBeamformingSettings.h"
+#include "MitkPhotoacousticsAlgorithmsExports.h"
 
 namespace mitk {
   /*!
   * \brief Class implementing util functionality for beamforming on CPU
   *
   */
-  class BeamformingUtils final
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT BeamformingUtils final
   {
   public:
 
+    /** \brief Delays and apodization weights of the samples [firstSample, firstSample + number of samples) of one reconstruction line
+    *
+    *  Only the contributions which lie inside the input image are stored. The contributions to the sample s are the entries
+    *  [sampleOffsets[s - firstSample], sampleOffsets[s - firstSample + 1]) of inputIndices and weights.
+    */
+    struct LineDelays
+    {
+      unsigned int firstSample;
+      std::vector<unsigned int> sampleOffsets;
+      /** \brief Index of the delayed input sample within the input slice */
+      std::vector<int> inputIndices;
+      /** \brief Apodization weight of the contribution */
+      std::vector<float> weights;
+      /** \brief Per sample: 1 if the contribution of the last transducer element within the aperture lies inside the input image.
+      * (D)MAS does not count this element when it is invalid, see DMASLine(). */
+      std::vector<unsigned char> lastElementValid;
+    };
+
+    /** \brief Computes the delays of the samples [firstSample, endSample) of a line.
+    *
+    *  The delays are rounded exactly as in the corresponding *Line functions of the algorithm set in config,
+    *  thus DASLine(), DMASLine() and sDMASLine() produce the same images.
+    */
+    static void ComputeLineDelays(float inputDim[2], float outputDim[2], const short& line, unsigned int firstSample, unsigned int endSample,
+      const mitk::BeamformingSettings::Pointer config, LineDelays& delays);
+
+    /** \brief Upper bound for the number of contributions ComputeLineDelays() stores for a whole line; used to estimate the size of delay tables
+    */
+    static unsigned long GetNumberOfLineContributions(float inputDim[2], float outputDim[2], const short& line, const mitk::BeamformingSettings::Pointer config);
+
+    /** \brief Function to perform DAS beamforming on CPU for the samples [firstSample, endSample) of a line, using precomputed delays
+    */
+    static void DASLine(const float* input, float* output, float outputDim[2], const short& line, unsigned int firstSample, unsigned int endSample,
+      const LineDelays& delays);
+
+    /** \brief Function to perform DMAS beamforming on CPU for the samples [firstSample, endSample) of a line, using precomputed delays
+    *
+    *  Instead of summing all products of pairs of signals, the sum is computed in linear time from the sum and the sum of squares
+    *  of the signed square roots of the signals.
+    */
+    static void DMASLine(const float* input, float* output, float outputDim[2], const short& line, unsigned int firstSample, unsigned int endSample,
+      const LineDelays& delays);
+
+    /** \brief Function to perform signed DMAS beamforming on CPU for the samples [firstSample, endSample) of a line, using precomputed delays
+    */
+    static void sDMASLine(const float* input, float* output, float outputDim[2], const short& line, unsigned int firstSample, unsigned int endSample,
+      const LineDelays& delays);
+
     /** \brief Function to perform beamforming on CPU for a single line, using DAS and quadratic delay
    */
     static void DASQuadraticLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, const mitk::BeamformingSettings::Pointer config);
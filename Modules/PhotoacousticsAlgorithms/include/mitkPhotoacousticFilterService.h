@@ -24,6 +24,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBeamformingSettings.h"
 #include "mitkBeamformingFilter.h"
+#include "mitkPhotoacousticFramePipeline.h"
 #include "MitkPhotoacousticsAlgorithmsExports.h"
 
 namespace mitk {
@@ -112,6 +113,25 @@ namespace mitk {
       float alphaHighPass, float alphaLowPass,
       float timeSpacing, float SpeedOfSound, bool IsBFImage);
 
+    /** \brief Creates a pipeline for the live processing of single frames
+    *
+    * The stages are an optional bandpass filter on the raw data, beamforming, a B-mode filter and the cropping of the beamformed image.
+    * They run concurrently on consecutive frames, see mitk::PhotoacousticFramePipeline; every stage uses its own filter service, so
+    * the pipeline does not share any state with this service. The pipeline still has to be started.
+    * @param config The configuration set to be used for beamforming.
+    * @param method The kind of B-Mode Filter to be used.
+    * @param useLogFilter Setting this to true will apply a simple logarithm to the image after the B-Mode Filter has been applied.
+    * @param cropAbove How many pixels will be cut from the top of the beamformed image.
+    * @param cropBelow How many pixels will be cut from the bottom of the beamformed image.
+    * @param useBandpass Whether the bandpass filter is applied; its parameters are explained at ApplyBandpassFilter().
+    * @return The pipeline, which is not started yet.
+    */
+    PhotoacousticFramePipeline::Pointer CreateFramePipeline(BeamformingSettings::Pointer config,
+      BModeMethod method = BModeMethod::Abs, bool useLogFilter = false,
+      int cropAbove = 0, int cropBelow = 0,
+      bool useBandpass = false, float BPHighPass = 0, float BPLowPass = 0,
+      float alphaHighPass = 0, float alphaLowPass = 0);
+
   protected:
     PhotoacousticFilterService();
     ~PhotoacousticFilterService() override;
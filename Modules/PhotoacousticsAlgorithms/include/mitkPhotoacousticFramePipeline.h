@@ -0,0 +1,147 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkPhotoacousticFramePipeline_H_HEADER_INCLUDED
+#define mitkPhotoacousticFramePipeline_H_HEADER_INCLUDED
+
+#include "itkObject.h"
+#include "mitkCommon.h"
+#include "mitkImage.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+namespace mitk {
+  /*!
+  * \brief Processes a stream of frames through a chain of stages, running the stages concurrently on consecutive frames
+  *
+  *  Every stage runs in its own thread and passes its result to the next stage through a bounded queue. While stage k
+  *  works on frame n, stage k - 1 already works on frame n + 1, so for a long stream the throughput is limited by the
+  *  slowest stage instead of the sum of all stages. With the default queue capacity of 2 each handoff is double buffered:
+  *  one frame can be waiting while the next one is produced, and a producer faster than the pipeline is blocked in Push()
+  *  instead of piling up frames.
+  *
+  *  Frames are handed from stage to stage as mitk::Image::Pointer without copying the pixel data. A stage may modify its
+  *  input frame in place and return it, or return a new image. If a stage returns nullptr or throws, the frame is dropped.
+  *  The frames leave the pipeline in the order they were pushed.
+  */
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT PhotoacousticFramePipeline : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(mitk::PhotoacousticFramePipeline, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef std::function<mitk::Image::Pointer(mitk::Image::Pointer)> StageFunctionType;
+    typedef std::function<void(mitk::Image::Pointer, unsigned long)> FrameCallbackType;
+
+    /** \brief Appends a stage to the pipeline. Stages can only be added while the pipeline is not running.
+    */
+    void AddStage(const std::string& name, const StageFunctionType& stage);
+
+    unsigned int GetNumberOfStages() const;
+
+    std::string GetStageName(unsigned int stage) const;
+
+    /** \brief Number of frames that can wait in front of each stage (default: 2). Takes effect with the next Start().
+    */
+    void SetQueueCapacity(unsigned int capacity);
+
+    unsigned int GetQueueCapacity() const;
+
+    /** \brief Starts one thread per stage.
+    *
+    * @param callback If set, it is called with every processed frame and its frame number, from the thread of the last stage.
+    * Otherwise the processed frames are collected and can be fetched with Pop().
+    */
+    void Start(const FrameCallbackType& callback = FrameCallbackType());
+
+    bool IsRunning() const;
+
+    /** \brief Hands a frame to the first stage; blocks while the first queue is full.
+    *
+    * The frame is not copied, so it must not be modified by the caller afterwards.
+    * @return The number of the frame, counting from 0 since Start().
+    */
+    unsigned long Push(mitk::Image::Pointer frame);
+
+    /** \brief Waits for the next processed frame if no callback was given to Start().
+    *
+    * @param frameNumber If not nullptr, receives the number of the returned frame.
+    * @return The next processed frame, or nullptr if the pipeline was stopped and all frames have been fetched.
+    */
+    mitk::Image::Pointer Pop(unsigned long* frameNumber = nullptr);
+
+    /** \brief Waits until all pushed frames have passed the pipeline and stops the threads.
+    */
+    void Stop();
+
+    /** \brief Number of frames that left the last stage since Start().
+    */
+    unsigned long GetNumberOfProcessedFrames() const;
+
+    /** \brief Number of frames dropped by a stage since Start().
+    */
+    unsigned long GetNumberOfDroppedFrames() const;
+
+    /** \brief Mean time in seconds the given stage needed per frame since Start().
+    */
+    double GetMeanStageDuration(unsigned int stage) const;
+
+    /** \brief Processed frames per second between Start() and the last processed frame.
+    */
+    double GetFramesPerSecond() const;
+
+  protected:
+    PhotoacousticFramePipeline();
+    ~PhotoacousticFramePipeline() override;
+
+  private:
+    class FrameQueue;
+
+    struct Stage
+    {
+      std::string name;
+      StageFunctionType function;
+      std::thread thread;
+      std::atomic<unsigned long long> nanoseconds;
+      std::atomic<unsigned long> frames;
+    };
+
+    void RunStage(unsigned int stage);
+
+    std::vector<std::unique_ptr<Stage>> m_Stages;
+    /** \brief m_Queues[k] holds the frames waiting for stage k; the last queue holds the processed frames if there is no callback.
+    */
+    std::vector<std::unique_ptr<FrameQueue>> m_Queues;
+    FrameCallbackType m_Callback;
+    unsigned int m_QueueCapacity;
+    bool m_Running;
+
+    unsigned long m_NextFrameNumber;
+    std::atomic<unsigned long> m_ProcessedFrames;
+    std::atomic<unsigned long> m_DroppedFrames;
+    std::chrono::steady_clock::time_point m_StartTime;
+    std::atomic<long long> m_LastFrameNanoseconds;
+  };
+} // namespace mitk
+
+#endif /* mitkPhotoacousticFramePipeline_H_HEADER_INCLUDED */
@@ -0,0 +1,94 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_PHOTOACOUSTIC_WORKER_POOL
+#define MITK_PHOTOACOUSTIC_WORKER_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+namespace mitk {
+  /*!
+  * \brief Persistent set of worker threads for the CPU implementations of the photoacoustic filters
+  *
+  *  The threads are started once and then wait for work, so that processing a frame does not pay for creating and
+  *  joining operating system threads. ParallelFor() hands out task indices through a shared counter: a thread that
+  *  finishes its task early simply fetches the next one, which balances tasks of different cost (e.g. image lines
+  *  with different aperture sizes) without a static partition. Unlike mitk::ParallelFor(), the threads are kept
+  *  alive between calls, as the filters process a stream of small frames.
+  */
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT PhotoacousticWorkerPool final
+  {
+  public:
+    typedef std::function<void(unsigned int task, unsigned int thread)> TaskFunctionType;
+
+    /** \brief Pool shared by all filters of the module, using itk::MultiThreader::GetGlobalDefaultNumberOfThreads()
+    *  threads at its creation.
+    */
+    static PhotoacousticWorkerPool* GetInstance();
+
+    /** \brief Creates a pool; if numberOfThreads is 0, itk::MultiThreader::GetGlobalDefaultNumberOfThreads() is used.
+    *  The number is limited to itk::MultiThreader::GetGlobalMaximumNumberOfThreads().
+    */
+    explicit PhotoacousticWorkerPool(unsigned int numberOfThreads = 0);
+
+    ~PhotoacousticWorkerPool();
+
+    /** \brief Number of threads taking part in ParallelFor(), including the calling thread.
+    */
+    unsigned int GetNumberOfThreads() const;
+
+    /** \brief Calls task(i, thread) for every i in [0, numberOfTasks) and returns when all tasks are done.
+    *
+    *  The calling thread works on the tasks as well. The thread argument is in [0, GetNumberOfThreads()) and is unique
+    *  among the threads running concurrently, so it can be used to index per thread scratch memory. If a task throws,
+    *  the remaining tasks are skipped and the first exception is rethrown in the calling thread. Concurrent calls are
+    *  serialized, so a task must not call ParallelFor() of the same pool.
+    */
+    void ParallelFor(unsigned int numberOfTasks, const TaskFunctionType& task);
+
+  private:
+    PhotoacousticWorkerPool(const PhotoacousticWorkerPool&) = delete;
+    PhotoacousticWorkerPool& operator=(const PhotoacousticWorkerPool&) = delete;
+
+    void WorkerLoop(unsigned int thread);
+    void RunTasks(unsigned int thread);
+
+    std::vector<std::thread> m_Threads;
+
+    std::mutex m_CallMutex;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_WorkDone;
+
+    const TaskFunctionType* m_Task;
+    unsigned int m_NumberOfTasks;
+    std::atomic<unsigned int> m_NextTask;
+    std::exception_ptr m_Exception;
+    unsigned long m_Generation;
+    unsigned int m_BusyWorkers;
+    bool m_Stop;
+  };
+} // namespace mitk
+
+#endif //MITK_PHOTOACOUSTIC_WORKER_POOL
@@ -24,12 +24,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkBeamformingFilter.h"
 #include "mitkBeamformingUtils.h"
+#include "mitkPhotoacousticWorkerPool.h"
 
 mitk::BeamformingFilter::BeamformingFilter(mitk::BeamformingSettings::Pointer settings) :
   m_OutputData(nullptr),
   m_InputData(nullptr),
-  m_Conf(settings)
+  m_Conf(settings),
+  m_MaximumDelayTableSize(256 * 1024 * 1024),
+  m_FramesPerSecond(0)
 {
+  for (float& dimension : m_DelayTableDimensions)
+    dimension = -1;
+
   MITK_INFO << "Instantiating BeamformingFilter...";
   this->SetNumberOfIndexedInputs(1);
   this->SetNumberOfRequiredInputs(1);
@@ -116,95 +122,68 @@ void mitk::BeamformingFilter::GenerateData()
 
     float inputDim[2] = { (float)input->GetDimension(0), (float)input->GetDimension(1) };
     float outputDim[2] = { (float)output->GetDimension(0), (float)output->GetDimension(1) };
+    const unsigned int lines = output->GetDimension(0);
+    const unsigned int samples = output->GetDimension(1);
+
+    UpdateDelayTable(inputDim, outputDim);
+
+    PhotoacousticWorkerPool* pool = PhotoacousticWorkerPool::GetInstance();
+
+    // the lines are split into tiles of consecutive samples, so that there are enough tasks to balance the load between the threads
+    const unsigned int tilesPerLine = std::min(samples, std::max(1u, (4 * pool->GetNumberOfThreads() + lines - 1) / lines));
+    const unsigned int samplesPerTile = (samples + tilesPerLine - 1) / tilesPerLine;
+
+    // delays computed per tile if they do not fit into the delay table
+    std::vector<BeamformingUtils::LineDelays> tileDelays(m_DelayTable.empty() ? pool->GetNumberOfThreads() : 0);
+
+    // every sample of the output is written by the beamforming functions
+    std::vector<float> outputSlice(lines * samples);
+    const BeamformingSettings::BeamformingAlgorithm algorithm = m_Conf->GetAlgorithm();
 
     for (unsigned int i = 0; i < output->GetDimension(2); ++i) // seperate Slices should get Beamforming seperately applied
     {
       mitk::ImageReadAccessor inputReadAccessor(input, input->GetSliceData(i));
       m_InputData = (float*)inputReadAccessor.GetData();
+      m_OutputData = outputSlice.data();
 
-      m_OutputData = new float[m_Conf->GetReconstructionLines()*m_Conf->GetSamplesPerLine()];
-
-      // fill the image with zeros
-      for (int l = 0; l < outputDim[0]; ++l)
-      {
-        for (int s = 0; s < outputDim[1]; ++s)
-        {
-          m_OutputData[l*(short)outputDim[1] + s] = 0;
-        }
-      }
-
-      std::thread *threads = new std::thread[(short)outputDim[0]];
-
-      // every line will be beamformed in a seperate thread
-      if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DAS)
-      {
-        if (m_Conf->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::QuadApprox)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingUtils::DASQuadraticLine, m_InputData,
-              m_OutputData, inputDim, outputDim, line, m_Conf);
-          }
-        }
-        else if (m_Conf->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::Spherical)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingUtils::DASSphericalLine, m_InputData,
-              m_OutputData, inputDim, outputDim, line, m_Conf);
-          }
-        }
-      }
-      else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DMAS)
+      pool->ParallelFor(lines * tilesPerLine, [&](unsigned int task, unsigned int thread)
       {
-        if (m_Conf->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::QuadApprox)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingUtils::DMASQuadraticLine, m_InputData,
-              m_OutputData, inputDim, outputDim, line, m_Conf);
-          }
-        }
-        else if (m_Conf->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::Spherical)
+        const short line = (short)(task / tilesPerLine);
+        const unsigned int firstSample = (task % tilesPerLine) * samplesPerTile;
+        const unsigned int endSample = std::min(firstSample + samplesPerTile, samples);
+        if (firstSample >= endSample)
+          return;
+
+        const BeamformingUtils::LineDelays* delays = nullptr;
+        if (m_DelayTable.empty())
         {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingUtils::DMASSphericalLine, m_InputData,
-              m_OutputData, inputDim, outputDim, line, m_Conf);
-          }
+          BeamformingUtils::ComputeLineDelays(inputDim, outputDim, line, firstSample, endSample, m_Conf, tileDelays[thread]);
+          delays = &tileDelays[thread];
         }
-      }
-      else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::sDMAS)
-      {
-        if (m_Conf->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::QuadApprox)
+        else
         {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingUtils::sDMASQuadraticLine, m_InputData,
-              m_OutputData, inputDim, outputDim, line, m_Conf);
-          }
+          delays = &m_DelayTable[line];
         }
-        else if (m_Conf->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::Spherical)
+
+        switch (algorithm)
         {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingUtils::sDMASSphericalLine, m_InputData,
-              m_OutputData, inputDim, outputDim, line, m_Conf);
-          }
+        case BeamformingSettings::BeamformingAlgorithm::DAS:
+          BeamformingUtils::DASLine(m_InputData, m_OutputData, outputDim, line, firstSample, endSample, *delays);
+          break;
+        case BeamformingSettings::BeamformingAlgorithm::DMAS:
+          BeamformingUtils::DMASLine(m_InputData, m_OutputData, outputDim, line, firstSample, endSample, *delays);
+          break;
+        case BeamformingSettings::BeamformingAlgorithm::sDMAS:
+          BeamformingUtils::sDMASLine(m_InputData, m_OutputData, outputDim, line, firstSample, endSample, *delays);
+          break;
         }
-      }
-      // wait for all lines to finish
-      for (short line = 0; line < outputDim[0]; ++line)
-      {
-        threads[line].join();
-      }
+      });
 
       output->SetSlice(m_OutputData, i);
 
       if (i % progInterval == 0)
         m_ProgressHandle((int)((i + 1) / (float)output->GetDimension(2) * 100), "performing reconstruction");
 
-      delete[] m_OutputData;
       m_OutputData = nullptr;
       m_InputData = nullptr;
     }
@@ -294,5 +273,37 @@ void mitk::BeamformingFilter::GenerateData()
   m_TimeOfHeaderInitialization.Modified();
 
   auto end = std::chrono::high_resolution_clock::now();
-  MITK_INFO << "Beamforming of " << output->GetDimension(2) << " Images completed in " << ((float)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / 1000000 << "ms" << std::endl;
+  double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / 1e9;
+  m_FramesPerSecond = seconds > 0 ? output->GetDimension(2) / seconds : 0;
+  MITK_INFO << "Beamforming of " << output->GetDimension(2) << " Images completed in " << ((float)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / 1000000 << "ms (" << m_FramesPerSecond << " images per second)" << std::endl;
+}
+
+void mitk::BeamformingFilter::UpdateDelayTable(float inputDim[2], float outputDim[2])
+{
+  float dimensions[4] = { inputDim[0], inputDim[1], outputDim[0], outputDim[1] };
+  if (std::equal(dimensions, dimensions + 4, m_DelayTableDimensions))
+    return;
+
+  std::vector<BeamformingUtils::LineDelays>().swap(m_DelayTable);
+
+  const short lines = (short)outputDim[0];
+  unsigned long contributions = 0;
+  for (short line = 0; line < lines; ++line)
+    contributions += BeamformingUtils::GetNumberOfLineContributions(inputDim, outputDim, line, m_Conf);
+
+  unsigned long tableSize = contributions * (sizeof(int) + sizeof(float)) +
+    (unsigned long)lines * (unsigned long)outputDim[1] * (sizeof(unsigned int) + sizeof(unsigned char));
+  if (tableSize > m_MaximumDelayTableSize)
+  {
+    MITK_INFO << "Delay table would need " << tableSize / (1024 * 1024) << " MB; computing the delays for every image instead.";
+    std::copy(dimensions, dimensions + 4, m_DelayTableDimensions);
+    return;
+  }
+
+  m_DelayTable.resize(lines);
+  PhotoacousticWorkerPool::GetInstance()->ParallelFor(lines, [&](unsigned int line, unsigned int)
+  {
+    BeamformingUtils::ComputeLineDelays(inputDim, outputDim, (short)line, 0, (unsigned int)outputDim[1], m_Conf, m_DelayTable[line]);
+  });
+  std::copy(dimensions, dimensions + 4, m_DelayTableDimensions);
 }
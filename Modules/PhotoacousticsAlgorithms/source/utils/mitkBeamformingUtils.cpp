@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkProperties.h"
 #include "mitkImageReadAccessor.h"
 #include <algorithm>
+#include <cmath>
 #include <itkImageIOBase.h>
 #include <chrono>
 #include <thread>
@@ -561,3 +562,237 @@ void mitk::BeamformingUtils::sDMASSphericalLine(
     delete[] AddSample;
   }
 }
+
+namespace
+{
+  // aperture of the samples of one line, computed exactly as in the *Line functions above
+  class LineAperture
+  {
+  public:
+    LineAperture(float inputDim[2], float outputDim[2], const short& line, const mitk::BeamformingSettings::Pointer config) :
+      m_InputS(inputDim[1]),
+      m_InputL(inputDim[0]),
+      m_OutputS(outputDim[1]),
+      m_IsPhotoacousticImage(config->GetIsPhotoacousticImage())
+    {
+      float tan_phi = std::tan(config->GetAngle() / 360 * 2 * itk::Math::pi);
+      m_PartMultiplicator = tan_phi * config->GetTimeSpacing() *
+        config->GetSpeedOfSound() / config->GetPitchInMeters() * m_InputL / (float)config->GetTransducerElements();
+
+      m_PercentOfImageReconstructed = (float)(config->GetReconstructionDepth()) /
+        (float)(m_InputS * config->GetSpeedOfSound() * config->GetTimeSpacing() / (float)(2 - (int)m_IsPhotoacousticImage));
+      m_PercentOfImageReconstructed = m_PercentOfImageReconstructed <= 1 ? m_PercentOfImageReconstructed : 1;
+
+      m_Li = (float)line / outputDim[0] * m_InputL;
+    }
+
+    float GetLi() const { return m_Li; }
+
+    void GetAperture(unsigned int sample, float& s_i, short& minLine, short& maxLine) const
+    {
+      s_i = (float)sample / m_OutputS * m_InputS / (float)(2 - (int)m_IsPhotoacousticImage) * m_PercentOfImageReconstructed;
+
+      float part = m_PartMultiplicator*s_i;
+
+      if (part < 1)
+        part = 1;
+
+      maxLine = (short)std::min((m_Li + part) + 1, m_InputL);
+      minLine = (short)std::max((m_Li - part), 0.0f);
+    }
+
+  private:
+    float m_InputS;
+    float m_InputL;
+    float m_OutputS;
+    bool m_IsPhotoacousticImage;
+    float m_PartMultiplicator;
+    float m_PercentOfImageReconstructed;
+    float m_Li;
+  };
+}
+
+unsigned long mitk::BeamformingUtils::GetNumberOfLineContributions(
+  float inputDim[2], float outputDim[2], const short& line, const mitk::BeamformingSettings::Pointer config)
+{
+  LineAperture aperture(inputDim, outputDim, line, config);
+
+  unsigned long contributions = 0;
+  float s_i = 0;
+  short minLine = 0;
+  short maxLine = 0;
+  for (unsigned int sample = 0; sample < outputDim[1]; ++sample)
+  {
+    aperture.GetAperture(sample, s_i, minLine, maxLine);
+    if (maxLine > minLine)
+      contributions += maxLine - minLine;
+  }
+  return contributions;
+}
+
+void mitk::BeamformingUtils::ComputeLineDelays(
+  float inputDim[2], float outputDim[2], const short& line, unsigned int firstSample, unsigned int endSample,
+  const mitk::BeamformingSettings::Pointer config, LineDelays& delays)
+{
+  const float* apodisation = config->GetApodizationFunction();
+  const short apodArraySize = config->GetApodizationArraySize();
+
+  float& inputS = inputDim[1];
+  float& inputL = inputDim[0];
+
+  const bool spherical = config->GetDelayCalculationMethod() == BeamformingSettings::DelayCalc::Spherical;
+  // DAS and (s)DMAS round the quadratic delays differently for ultrasound images
+  const bool roundLikeDAS = config->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DAS;
+
+  LineAperture aperture(inputDim, outputDim, line, config);
+  const float l_i = aperture.GetLi();
+
+  short AddSample = 0;
+  short maxLine = 0;
+  short minLine = 0;
+  float delayMultiplicator = 0;
+  float s_i = 0;
+  float apod_mult = 1;
+
+  delays.firstSample = firstSample;
+  delays.sampleOffsets.clear();
+  delays.inputIndices.clear();
+  delays.weights.clear();
+  delays.lastElementValid.clear();
+  delays.sampleOffsets.reserve(endSample - firstSample + 1);
+  delays.lastElementValid.reserve(endSample - firstSample);
+  delays.sampleOffsets.push_back(0);
+
+  for (unsigned int sample = firstSample; sample < endSample; ++sample)
+  {
+    aperture.GetAperture(sample, s_i, minLine, maxLine);
+
+    apod_mult = (float)apodArraySize / (float)(maxLine - minLine);
+
+    if (!spherical)
+    {
+      delayMultiplicator = pow((1 / (config->GetTimeSpacing()*config->GetSpeedOfSound()) *
+        (config->GetPitchInMeters()*config->GetTransducerElements()) / inputL), 2) / s_i / 2;
+    }
+
+    bool valid = false;
+    for (short l_s = minLine; l_s < maxLine; ++l_s)
+    {
+      if (spherical)
+      {
+        AddSample = (int)sqrt(
+          pow(s_i, 2)
+          +
+          pow((1 / (config->GetTimeSpacing()*config->GetSpeedOfSound()) *
+          (((float)l_s - l_i)*config->GetPitchInMeters()*(float)config->GetTransducerElements()) / inputL), 2)
+        ) + (1 - config->GetIsPhotoacousticImage())*s_i;
+      }
+      else if (roundLikeDAS)
+      {
+        AddSample = delayMultiplicator * pow((l_s - l_i), 2) + s_i + (1 - config->GetIsPhotoacousticImage())*s_i;
+      }
+      else
+      {
+        AddSample = (short)(delayMultiplicator * pow((l_s - l_i), 2) + s_i) +
+          (1 - config->GetIsPhotoacousticImage())*s_i;
+      }
+
+      valid = AddSample < inputS && AddSample >= 0;
+      if (valid)
+      {
+        delays.inputIndices.push_back(l_s + AddSample*(short)inputL);
+        delays.weights.push_back(apodisation[(short)((l_s - minLine)*apod_mult)]);
+      }
+    }
+
+    delays.lastElementValid.push_back(valid ? 1 : 0);
+    delays.sampleOffsets.push_back((unsigned int)delays.inputIndices.size());
+  }
+}
+
+void mitk::BeamformingUtils::DASLine(const float* input, float* output, float outputDim[2], const short& line,
+  unsigned int firstSample, unsigned int endSample, const LineDelays& delays)
+{
+  const short outputL = (short)outputDim[0];
+  const int* inputIndices = delays.inputIndices.data();
+  const float* weights = delays.weights.data();
+
+  for (unsigned int sample = firstSample; sample < endSample; ++sample)
+  {
+    const unsigned int begin = delays.sampleOffsets[sample - delays.firstSample];
+    const unsigned int end = delays.sampleOffsets[sample - delays.firstSample + 1];
+
+    float sum = 0;
+    for (unsigned int i = begin; i < end; ++i)
+      sum += input[inputIndices[i]] * weights[i];
+
+    const short usedLines = (short)(end - begin);
+    output[sample*outputL + line] = sum / usedLines;
+  }
+}
+
+namespace
+{
+  // sum over all pairs i < j of sign(a_i*a_j)*sqrt(|a_i*a_j|) of the apodized signals a, which equals
+  // ((sum of t)^2 - sum of t^2) / 2 with t = sign(a)*sqrt(|a|)
+  double SumOfPairs(const float* input, const int* inputIndices, const float* weights, unsigned int begin, unsigned int end)
+  {
+    double sum = 0;
+    double sumOfSquares = 0;
+    for (unsigned int i = begin; i < end; ++i)
+    {
+      const float a = input[inputIndices[i]] * weights[i];
+      const float t = std::copysign(std::sqrt(std::fabs(a)), a);
+      sum += t;
+      sumOfSquares += std::fabs(a);
+    }
+    return (sum*sum - sumOfSquares) / 2;
+  }
+
+  // (s)DMAS does not count invalid contributions of the last element of the aperture
+  short DMASUsedLines(unsigned int begin, unsigned int end, unsigned char lastElementValid)
+  {
+    return (short)(1 + (end - begin) - lastElementValid);
+  }
+}
+
+void mitk::BeamformingUtils::DMASLine(const float* input, float* output, float outputDim[2], const short& line,
+  unsigned int firstSample, unsigned int endSample, const LineDelays& delays)
+{
+  const short outputL = (short)outputDim[0];
+
+  for (unsigned int sample = firstSample; sample < endSample; ++sample)
+  {
+    const unsigned int begin = delays.sampleOffsets[sample - delays.firstSample];
+    const unsigned int end = delays.sampleOffsets[sample - delays.firstSample + 1];
+
+    const float sum = (float)SumOfPairs(input, delays.inputIndices.data(), delays.weights.data(), begin, end);
+
+    const short usedLines = DMASUsedLines(begin, end, delays.lastElementValid[sample - delays.firstSample]);
+    output[sample*outputL + line] = sum / (float)(pow(usedLines, 2) - (usedLines - 1));
+  }
+}
+
+void mitk::BeamformingUtils::sDMASLine(const float* input, float* output, float outputDim[2], const short& line,
+  unsigned int firstSample, unsigned int endSample, const LineDelays& delays)
+{
+  const short outputL = (short)outputDim[0];
+  const int* inputIndices = delays.inputIndices.data();
+
+  for (unsigned int sample = firstSample; sample < endSample; ++sample)
+  {
+    const unsigned int begin = delays.sampleOffsets[sample - delays.firstSample];
+    const unsigned int end = delays.sampleOffsets[sample - delays.firstSample + 1];
+    const unsigned char lastElementValid = delays.lastElementValid[sample - delays.firstSample];
+
+    const float sum = (float)SumOfPairs(input, inputIndices, delays.weights.data(), begin, end);
+
+    // the sign is taken from the unweighted signals, again without the last element of the aperture
+    float sign = 0;
+    for (unsigned int i = begin; i < end - lastElementValid; ++i)
+      sign += input[inputIndices[i]];
+
+    const short usedLines = DMASUsedLines(begin, end, lastElementValid);
+    output[sample*outputL + line] = sum / (float)(pow(usedLines, 2) - (usedLines - 1)) * ((sign > 0) - (sign < 0));
+  }
+}
@@ -225,12 +225,16 @@ mitk::Image::Pointer mitk::PhotoacousticFilterService::ApplyBeamforming(
     processedImage = inputImage;
   }
 
-  m_BeamformingFilter = mitk::BeamformingFilter::New(config);
+  // the filter is kept as long as the same settings are used, so that its delay tables are reused for the following images
+  if (m_BeamformingFilter.IsNull() || m_BeamformingFilter->GetConfig() != config)
+    m_BeamformingFilter = mitk::BeamformingFilter::New(config);
   m_BeamformingFilter->SetInput(ConvertToFloat(processedImage));
   m_BeamformingFilter->SetProgressHandle(progressHandle);
   m_BeamformingFilter->UpdateLargestPossibleRegion();
 
   processedImage = m_BeamformingFilter->GetOutput();
+  // the next update must not overwrite the image returned now
+  processedImage->DisconnectPipeline();
 
   return processedImage;
 }
@@ -267,6 +271,51 @@ mitk::Image::Pointer mitk::PhotoacousticFilterService::ApplyBandpassFilter(
   }
 }
 
+mitk::PhotoacousticFramePipeline::Pointer mitk::PhotoacousticFilterService::CreateFramePipeline(
+  BeamformingSettings::Pointer config,
+  BModeMethod method, bool useLogFilter,
+  int cropAbove, int cropBelow,
+  bool useBandpass, float BPHighPass, float BPLowPass,
+  float alphaHighPass, float alphaLowPass)
+{
+  PhotoacousticFramePipeline::Pointer pipeline = PhotoacousticFramePipeline::New();
+
+  if (useBandpass)
+  {
+    Self::Pointer service = Self::New();
+    pipeline->AddStage("bandpass", [=](mitk::Image::Pointer frame)
+    {
+      return service->ApplyBandpassFilter(frame, BPHighPass, BPLowPass, alphaHighPass, alphaLowPass,
+        config->GetTimeSpacing(), config->GetSpeedOfSound(), false);
+    });
+  }
+
+  Self::Pointer beamformingService = Self::New();
+  pipeline->AddStage("beamforming", [=](mitk::Image::Pointer frame)
+  {
+    return beamformingService->ApplyBeamforming(frame, config);
+  });
+
+  Self::Pointer bModeService = Self::New();
+  pipeline->AddStage("b-mode", [=](mitk::Image::Pointer frame)
+  {
+    return bModeService->ApplyBmodeFilter(frame, method, useLogFilter);
+  });
+
+  if (cropAbove > 0 || cropBelow > 0)
+  {
+    Self::Pointer croppingService = Self::New();
+    pipeline->AddStage("cropping", [=](mitk::Image::Pointer frame)
+    {
+      int errCode = 0;
+      mitk::Image::Pointer croppedFrame = croppingService->ApplyCropping(frame, cropAbove, cropBelow, 0, 0, 0, 0, &errCode);
+      return errCode == 0 ? croppedFrame : mitk::Image::Pointer();
+    });
+  }
+
+  return pipeline;
+}
+
 mitk::Image::Pointer mitk::PhotoacousticFilterService::ConvertToFloat(mitk::Image::Pointer inputImage)
 {
   if ((inputImage->GetPixelType().GetTypeAsString() == "scalar (float)" ||
@@ -0,0 +1,285 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPhotoacousticFramePipeline.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <mitkExceptionMacro.h>
+
+// queue between two stages; a capacity of 0 means unbounded
+class mitk::PhotoacousticFramePipeline::FrameQueue
+{
+public:
+  struct Frame
+  {
+    mitk::Image::Pointer image;
+    unsigned long number;
+  };
+
+  explicit FrameQueue(unsigned int capacity) : m_Capacity(capacity), m_Closed(false) {}
+
+  void Push(Frame frame)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_NotFull.wait(lock, [this] { return m_Capacity == 0 || m_Frames.size() < m_Capacity; });
+    m_Frames.push_back(std::move(frame));
+    m_NotEmpty.notify_one();
+  }
+
+  // returns false once the queue is closed and empty
+  bool Pop(Frame& frame)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_NotEmpty.wait(lock, [this] { return m_Closed || !m_Frames.empty(); });
+    if (m_Frames.empty())
+      return false;
+
+    frame = std::move(m_Frames.front());
+    m_Frames.pop_front();
+    m_NotFull.notify_one();
+    return true;
+  }
+
+  void Close()
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Closed = true;
+    m_NotEmpty.notify_all();
+  }
+
+private:
+  unsigned int m_Capacity;
+  bool m_Closed;
+  std::deque<Frame> m_Frames;
+  std::mutex m_Mutex;
+  std::condition_variable m_NotEmpty;
+  std::condition_variable m_NotFull;
+};
+
+mitk::PhotoacousticFramePipeline::PhotoacousticFramePipeline() :
+  m_QueueCapacity(2),
+  m_Running(false),
+  m_NextFrameNumber(0),
+  m_ProcessedFrames(0),
+  m_DroppedFrames(0),
+  m_LastFrameNanoseconds(0)
+{
+}
+
+mitk::PhotoacousticFramePipeline::~PhotoacousticFramePipeline()
+{
+  Stop();
+}
+
+void mitk::PhotoacousticFramePipeline::AddStage(const std::string& name, const StageFunctionType& stage)
+{
+  if (m_Running)
+    mitkThrow() << "Cannot add stage " << name << " to a running pipeline.";
+  if (!stage)
+    mitkThrow() << "Stage " << name << " has no function.";
+
+  std::unique_ptr<Stage> newStage(new Stage);
+  newStage->name = name;
+  newStage->function = stage;
+  newStage->nanoseconds = 0;
+  newStage->frames = 0;
+  m_Stages.push_back(std::move(newStage));
+}
+
+unsigned int mitk::PhotoacousticFramePipeline::GetNumberOfStages() const
+{
+  return static_cast<unsigned int>(m_Stages.size());
+}
+
+std::string mitk::PhotoacousticFramePipeline::GetStageName(unsigned int stage) const
+{
+  if (stage >= m_Stages.size())
+    mitkThrow() << "Pipeline has no stage " << stage;
+  return m_Stages[stage]->name;
+}
+
+void mitk::PhotoacousticFramePipeline::SetQueueCapacity(unsigned int capacity)
+{
+  m_QueueCapacity = capacity > 0 ? capacity : 1;
+}
+
+unsigned int mitk::PhotoacousticFramePipeline::GetQueueCapacity() const
+{
+  return m_QueueCapacity;
+}
+
+void mitk::PhotoacousticFramePipeline::Start(const FrameCallbackType& callback)
+{
+  if (m_Running)
+    mitkThrow() << "Pipeline is already running.";
+  if (m_Stages.empty())
+    mitkThrow() << "Pipeline has no stages.";
+
+  m_Callback = callback;
+  m_NextFrameNumber = 0;
+  m_ProcessedFrames = 0;
+  m_DroppedFrames = 0;
+  m_LastFrameNanoseconds = 0;
+
+  m_Queues.clear();
+  for (unsigned int stage = 0; stage < m_Stages.size(); ++stage)
+    m_Queues.emplace_back(new FrameQueue(m_QueueCapacity));
+  // processed frames are not limited, so that a caller may push all frames before fetching the results
+  m_Queues.emplace_back(new FrameQueue(0));
+
+  m_StartTime = std::chrono::steady_clock::now();
+  m_Running = true;
+
+  for (unsigned int stage = 0; stage < m_Stages.size(); ++stage)
+  {
+    m_Stages[stage]->nanoseconds = 0;
+    m_Stages[stage]->frames = 0;
+    m_Stages[stage]->thread = std::thread(&PhotoacousticFramePipeline::RunStage, this, stage);
+  }
+}
+
+bool mitk::PhotoacousticFramePipeline::IsRunning() const
+{
+  return m_Running;
+}
+
+unsigned long mitk::PhotoacousticFramePipeline::Push(mitk::Image::Pointer frame)
+{
+  if (!m_Running)
+    mitkThrow() << "Pipeline is not running.";
+
+  FrameQueue::Frame queuedFrame;
+  queuedFrame.image = frame;
+  queuedFrame.number = m_NextFrameNumber++;
+  const unsigned long frameNumber = queuedFrame.number;
+  m_Queues.front()->Push(std::move(queuedFrame));
+  return frameNumber;
+}
+
+mitk::Image::Pointer mitk::PhotoacousticFramePipeline::Pop(unsigned long* frameNumber)
+{
+  if (m_Callback)
+    mitkThrow() << "Processed frames are passed to the callback of the pipeline.";
+  if (m_Queues.empty())
+    return nullptr;
+
+  FrameQueue::Frame frame;
+  if (!m_Queues.back()->Pop(frame))
+    return nullptr;
+
+  if (frameNumber != nullptr)
+    *frameNumber = frame.number;
+  return frame.image;
+}
+
+void mitk::PhotoacousticFramePipeline::Stop()
+{
+  if (!m_Running)
+    return;
+
+  // every stage closes the queue behind it when its input is closed and empty
+  m_Queues.front()->Close();
+  for (auto& stage : m_Stages)
+    stage->thread.join();
+
+  m_Running = false;
+}
+
+void mitk::PhotoacousticFramePipeline::RunStage(unsigned int stage)
+{
+  Stage& currentStage = *m_Stages[stage];
+  FrameQueue& input = *m_Queues[stage];
+  FrameQueue& output = *m_Queues[stage + 1];
+  const bool isLastStage = stage + 1 == m_Stages.size();
+
+  FrameQueue::Frame frame;
+  while (input.Pop(frame))
+  {
+    auto begin = std::chrono::steady_clock::now();
+    try
+    {
+      frame.image = currentStage.function(frame.image);
+    }
+    catch (std::exception& e)
+    {
+      MITK_ERROR << "Stage " << currentStage.name << " failed on frame " << frame.number << ": " << e.what();
+      frame.image = nullptr;
+    }
+    auto end = std::chrono::steady_clock::now();
+    currentStage.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    ++currentStage.frames;
+
+    if (frame.image.IsNull())
+    {
+      ++m_DroppedFrames;
+      continue;
+    }
+
+    if (!isLastStage)
+    {
+      output.Push(std::move(frame));
+      continue;
+    }
+
+    ++m_ProcessedFrames;
+    m_LastFrameNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_StartTime).count();
+    if (m_Callback)
+    {
+      try
+      {
+        m_Callback(frame.image, frame.number);
+      }
+      catch (std::exception& e)
+      {
+        MITK_ERROR << "Frame callback failed on frame " << frame.number << ": " << e.what();
+      }
+    }
+    else
+    {
+      output.Push(std::move(frame));
+    }
+  }
+
+  output.Close();
+}
+
+unsigned long mitk::PhotoacousticFramePipeline::GetNumberOfProcessedFrames() const
+{
+  return m_ProcessedFrames;
+}
+
+unsigned long mitk::PhotoacousticFramePipeline::GetNumberOfDroppedFrames() const
+{
+  return m_DroppedFrames;
+}
+
+double mitk::PhotoacousticFramePipeline::GetMeanStageDuration(unsigned int stage) const
+{
+  if (stage >= m_Stages.size())
+    mitkThrow() << "Pipeline has no stage " << stage;
+
+  unsigned long frames = m_Stages[stage]->frames;
+  return frames > 0 ? m_Stages[stage]->nanoseconds / 1e9 / frames : 0;
+}
+
+double mitk::PhotoacousticFramePipeline::GetFramesPerSecond() const
+{
+  long long nanoseconds = m_LastFrameNanoseconds;
+  return nanoseconds > 0 ? m_ProcessedFrames * 1e9 / nanoseconds : 0;
+}
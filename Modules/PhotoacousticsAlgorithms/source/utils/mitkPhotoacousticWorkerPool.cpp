@@ -0,0 +1,142 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPhotoacousticWorkerPool.h"
+#include "mitkParallelFor.h"
+
+mitk::PhotoacousticWorkerPool* mitk::PhotoacousticWorkerPool::GetInstance()
+{
+  static PhotoacousticWorkerPool instance;
+  return &instance;
+}
+
+mitk::PhotoacousticWorkerPool::PhotoacousticWorkerPool(unsigned int numberOfThreads) :
+  m_Task(nullptr),
+  m_NumberOfTasks(0),
+  m_NextTask(0),
+  m_Generation(0),
+  m_BusyWorkers(0),
+  m_Stop(false)
+{
+  numberOfThreads = mitk::GetParallelForNumberOfThreads(numberOfThreads);
+
+  // the thread calling ParallelFor() is the first worker
+  for (unsigned int thread = 1; thread < numberOfThreads; ++thread)
+    m_Threads.emplace_back(&PhotoacousticWorkerPool::WorkerLoop, this, thread);
+}
+
+mitk::PhotoacousticWorkerPool::~PhotoacousticWorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_WorkAvailable.notify_all();
+
+  for (auto& thread : m_Threads)
+    thread.join();
+}
+
+unsigned int mitk::PhotoacousticWorkerPool::GetNumberOfThreads() const
+{
+  return static_cast<unsigned int>(m_Threads.size()) + 1;
+}
+
+void mitk::PhotoacousticWorkerPool::ParallelFor(unsigned int numberOfTasks, const TaskFunctionType& task)
+{
+  if (numberOfTasks == 0)
+    return;
+
+  std::lock_guard<std::mutex> callLock(m_CallMutex);
+
+  if (m_Threads.empty() || numberOfTasks == 1)
+  {
+    for (unsigned int i = 0; i < numberOfTasks; ++i)
+      task(i, 0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Task = &task;
+    m_NumberOfTasks = numberOfTasks;
+    m_NextTask = 0;
+    m_Exception = nullptr;
+    m_BusyWorkers = static_cast<unsigned int>(m_Threads.size());
+    ++m_Generation;
+  }
+  m_WorkAvailable.notify_all();
+
+  RunTasks(0);
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkDone.wait(lock, [this] { return m_BusyWorkers == 0; });
+    m_Task = nullptr;
+    exception = m_Exception;
+    m_Exception = nullptr;
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+void mitk::PhotoacousticWorkerPool::WorkerLoop(unsigned int thread)
+{
+  unsigned long lastGeneration = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_WorkAvailable.wait(lock, [this, lastGeneration] { return m_Stop || m_Generation != lastGeneration; });
+      if (m_Stop)
+        return;
+      lastGeneration = m_Generation;
+    }
+
+    RunTasks(thread);
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (--m_BusyWorkers == 0)
+        m_WorkDone.notify_one();
+    }
+  }
+}
+
+void mitk::PhotoacousticWorkerPool::RunTasks(unsigned int thread)
+{
+  while (true)
+  {
+    unsigned int i = m_NextTask++;
+    if (i >= m_NumberOfTasks)
+      return;
+
+    try
+    {
+      (*m_Task)(i, thread);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (!m_Exception)
+        m_Exception = std::current_exception();
+      // skip the tasks nobody has started yet
+      m_NextTask = m_NumberOfTasks;
+    }
+  }
+}
@@ -17,5 +17,7 @@ set(MODULE_TESTS
   mitkPAFilterServiceTest.cpp
   mitkCastToFloatImageFilterTest.cpp
   mitkCropImageFilterTest.cpp
+  mitkBeamformingUtilsTest.cpp
+  mitkPhotoacousticFramePipelineTest.cpp
   )
 set(RESOURCE_FILES)
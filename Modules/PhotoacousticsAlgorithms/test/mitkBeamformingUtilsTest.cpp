@@ -0,0 +1,216 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkBeamformingSettings.h>
+#include <mitkBeamformingUtils.h>
+#include <mitkPhotoacousticWorkerPool.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+class mitkBeamformingUtilsTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBeamformingUtilsTestSuite);
+  MITK_TEST(testDelayTablesMatchLineFunctions);
+  MITK_TEST(testTilesMatchWholeLines);
+  MITK_TEST(testWorkerPool);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  const unsigned int INPUT_LINES = 32;
+  const unsigned int INPUT_SAMPLES = 256;
+  const unsigned int OUTPUT_LINES = 48;
+  const unsigned int OUTPUT_SAMPLES = 128;
+
+  std::vector<float> m_Input;
+
+  typedef void(*LineFunctionType)(float*, float*, float*, float*, const short&, const mitk::BeamformingSettings::Pointer);
+  typedef void(*DelayedLineFunctionType)(const float*, float*, float*, const short&, unsigned int, unsigned int, const mitk::BeamformingUtils::LineDelays&);
+
+  mitk::BeamformingSettings::Pointer CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm algorithm,
+    mitk::BeamformingSettings::DelayCalc delayCalculation, bool isPhotoacousticImage)
+  {
+    unsigned int inputDim[3] = { INPUT_LINES, INPUT_SAMPLES, 1 };
+    return mitk::BeamformingSettings::New(0.0003f, 1540, 2.5e-8f, 27, isPhotoacousticImage, OUTPUT_SAMPLES, OUTPUT_LINES, inputDim,
+      0.008f, false, 16, delayCalculation, mitk::BeamformingSettings::Apodization::Hann, 64, algorithm);
+  }
+
+  LineFunctionType GetLineFunction(mitk::BeamformingSettings::BeamformingAlgorithm algorithm, mitk::BeamformingSettings::DelayCalc delayCalculation)
+  {
+    bool spherical = delayCalculation == mitk::BeamformingSettings::DelayCalc::Spherical;
+    switch (algorithm)
+    {
+    case mitk::BeamformingSettings::BeamformingAlgorithm::DAS:
+      return spherical ? &mitk::BeamformingUtils::DASSphericalLine : &mitk::BeamformingUtils::DASQuadraticLine;
+    case mitk::BeamformingSettings::BeamformingAlgorithm::DMAS:
+      return spherical ? &mitk::BeamformingUtils::DMASSphericalLine : &mitk::BeamformingUtils::DMASQuadraticLine;
+    default:
+      return spherical ? &mitk::BeamformingUtils::sDMASSphericalLine : &mitk::BeamformingUtils::sDMASQuadraticLine;
+    }
+  }
+
+  DelayedLineFunctionType GetDelayedLineFunction(mitk::BeamformingSettings::BeamformingAlgorithm algorithm)
+  {
+    switch (algorithm)
+    {
+    case mitk::BeamformingSettings::BeamformingAlgorithm::DAS:
+      return &mitk::BeamformingUtils::DASLine;
+    case mitk::BeamformingSettings::BeamformingAlgorithm::DMAS:
+      return &mitk::BeamformingUtils::DMASLine;
+    default:
+      return &mitk::BeamformingUtils::sDMASLine;
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    std::default_random_engine randGen(42);
+    std::uniform_real_distribution<float> randDistr(-1000, 1000);
+
+    m_Input.resize(INPUT_LINES*INPUT_SAMPLES);
+    for (float& value : m_Input)
+      value = randDistr(randGen);
+  }
+
+  void tearDown() override
+  {
+    m_Input.clear();
+  }
+
+  void testDelayTablesMatchLineFunctions()
+  {
+    float inputDim[2] = { (float)INPUT_LINES, (float)INPUT_SAMPLES };
+    float outputDim[2] = { (float)OUTPUT_LINES, (float)OUTPUT_SAMPLES };
+
+    for (auto algorithm : { mitk::BeamformingSettings::BeamformingAlgorithm::DAS,
+      mitk::BeamformingSettings::BeamformingAlgorithm::DMAS, mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS })
+    {
+      for (auto delayCalculation : { mitk::BeamformingSettings::DelayCalc::QuadApprox, mitk::BeamformingSettings::DelayCalc::Spherical })
+      {
+        for (bool isPhotoacousticImage : { true, false })
+        {
+          auto config = CreateSettings(algorithm, delayCalculation, isPhotoacousticImage);
+
+          std::vector<float> expected(OUTPUT_LINES*OUTPUT_SAMPLES, 0);
+          std::vector<float> result(OUTPUT_LINES*OUTPUT_SAMPLES, 0);
+          mitk::BeamformingUtils::LineDelays delays;
+
+          for (short line = 0; line < (short)OUTPUT_LINES; ++line)
+          {
+            GetLineFunction(algorithm, delayCalculation)(m_Input.data(), expected.data(), inputDim, outputDim, line, config);
+
+            mitk::BeamformingUtils::ComputeLineDelays(inputDim, outputDim, line, 0, OUTPUT_SAMPLES, config, delays);
+            CPPUNIT_ASSERT(delays.inputIndices.size() <= mitk::BeamformingUtils::GetNumberOfLineContributions(inputDim, outputDim, line, config));
+            GetDelayedLineFunction(algorithm)(m_Input.data(), result.data(), outputDim, line, 0, OUTPUT_SAMPLES, delays);
+          }
+
+          float maxValue = 0;
+          for (float value : expected)
+            if (std::isfinite(value))
+              maxValue = std::max(maxValue, std::abs(value));
+
+          for (unsigned int i = 0; i < expected.size(); ++i)
+          {
+            if (!std::isfinite(expected[i]))
+            {
+              CPPUNIT_ASSERT_MESSAGE("expected a non finite value at " + std::to_string(i), !std::isfinite(result[i]));
+              continue;
+            }
+            // (s)DMAS sums the products of pairs in a different order
+            CPPUNIT_ASSERT_MESSAGE(std::string("expected ") + std::to_string(expected[i]) + " but was " + std::to_string(result[i]),
+              std::abs(expected[i] - result[i]) <= 1e-4f * maxValue + 1e-5f);
+          }
+        }
+      }
+    }
+  }
+
+  void testTilesMatchWholeLines()
+  {
+    float inputDim[2] = { (float)INPUT_LINES, (float)INPUT_SAMPLES };
+    float outputDim[2] = { (float)OUTPUT_LINES, (float)OUTPUT_SAMPLES };
+    auto config = CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS, mitk::BeamformingSettings::DelayCalc::Spherical, true);
+
+    std::vector<float> expected(OUTPUT_LINES*OUTPUT_SAMPLES, 0);
+    std::vector<float> result(OUTPUT_LINES*OUTPUT_SAMPLES, 0);
+    mitk::BeamformingUtils::LineDelays lineDelays;
+    mitk::BeamformingUtils::LineDelays tileDelays;
+    const unsigned int tileSize = 37;
+
+    for (short line = 0; line < (short)OUTPUT_LINES; ++line)
+    {
+      mitk::BeamformingUtils::ComputeLineDelays(inputDim, outputDim, line, 0, OUTPUT_SAMPLES, config, lineDelays);
+      mitk::BeamformingUtils::sDMASLine(m_Input.data(), expected.data(), outputDim, line, 0, OUTPUT_SAMPLES, lineDelays);
+
+      for (unsigned int first = 0; first < OUTPUT_SAMPLES; first += tileSize)
+      {
+        unsigned int end = std::min(first + tileSize, OUTPUT_SAMPLES);
+        mitk::BeamformingUtils::ComputeLineDelays(inputDim, outputDim, line, first, end, config, tileDelays);
+        mitk::BeamformingUtils::sDMASLine(m_Input.data(), result.data(), outputDim, line, first, end, tileDelays);
+      }
+    }
+
+    for (unsigned int i = 0; i < expected.size(); ++i)
+    {
+      CPPUNIT_ASSERT(expected[i] == result[i] || (std::isnan(expected[i]) && std::isnan(result[i])));
+    }
+  }
+
+  void testWorkerPool()
+  {
+    mitk::PhotoacousticWorkerPool pool(4);
+    CPPUNIT_ASSERT_EQUAL(4u, pool.GetNumberOfThreads());
+
+    for (unsigned int numberOfTasks : { 0u, 1u, 3u, 1000u })
+    {
+      std::vector<std::atomic<int>> calls(numberOfTasks);
+      for (auto& call : calls)
+        call = 0;
+
+      std::atomic<bool> validThread(true);
+      pool.ParallelFor(numberOfTasks, [&](unsigned int task, unsigned int thread)
+      {
+        ++calls[task];
+        if (thread >= 4)
+          validThread = false;
+      });
+
+      CPPUNIT_ASSERT(validThread);
+      for (auto& call : calls)
+        CPPUNIT_ASSERT_EQUAL(1, call.load());
+    }
+
+    CPPUNIT_ASSERT_THROW(pool.ParallelFor(100, [](unsigned int task, unsigned int)
+    {
+      if (task == 50)
+        throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    // the pool is still usable after a task failed
+    std::atomic<unsigned int> sum(0);
+    pool.ParallelFor(10, [&](unsigned int task, unsigned int) { sum += task; });
+    CPPUNIT_ASSERT_EQUAL(45u, sum.load());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBeamformingUtils)
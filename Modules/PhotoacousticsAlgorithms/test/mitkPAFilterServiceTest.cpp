@@ -36,6 +36,7 @@ class mitkPAFilterServiceTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkPAFilterServiceTestSuite);
   MITK_TEST(testRunning);
+  MITK_TEST(testFramePipeline);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -113,6 +114,43 @@ public:
     }
   }
 
+  void testFramePipeline()
+  {
+    std::vector<float> testArray(length, 0);
+
+    auto pipeline = m_PhotoacousticFilterService->CreateFramePipeline(m_BeamformingSettings);
+    CPPUNIT_ASSERT_EQUAL(2u, pipeline->GetNumberOfStages());
+    pipeline->Start();
+
+    const unsigned long numberOfFrames = 3;
+    for (unsigned long frame = 0; frame < numberOfFrames; ++frame)
+    {
+      mitk::Image::Pointer testImage = mitk::Image::New();
+      testImage->Initialize(mitk::MakeScalarPixelType<float>(), 2, inputDimensions);
+      testImage->SetImportSlice(testArray.data(), 0, 0, 0, mitk::Image::ImportMemoryManagementType::CopyMemory);
+      CPPUNIT_ASSERT_EQUAL(frame, pipeline->Push(testImage));
+    }
+    pipeline->Stop();
+
+    for (unsigned long frame = 0; frame < numberOfFrames; ++frame)
+    {
+      unsigned long frameNumber = 0;
+      mitk::Image::Pointer output = pipeline->Pop(&frameNumber);
+      CPPUNIT_ASSERT(output.IsNotNull());
+      CPPUNIT_ASSERT_EQUAL(frame, frameNumber);
+      CPPUNIT_ASSERT_EQUAL(m_BeamformingSettings->GetReconstructionLines(), output->GetDimension(0));
+
+      mitk::ImageReadAccessor readAccess(output);
+      const float* outputArray = (const float*)readAccess.GetData();
+      for (unsigned int i = 0; i < output->GetDimension(0) * output->GetDimension(1); ++i)
+      {
+        CPPUNIT_ASSERT_MESSAGE(std::string("Output array not correct: " + std::to_string(abs(outputArray[i]))), abs(outputArray[i]) < 1e-5f);
+      }
+    }
+    CPPUNIT_ASSERT(pipeline->Pop().IsNull());
+    CPPUNIT_ASSERT_EQUAL(numberOfFrames, pipeline->GetNumberOfProcessedFrames());
+  }
+
   void tearDown() override
   {
     m_PhotoacousticFilterService = nullptr;
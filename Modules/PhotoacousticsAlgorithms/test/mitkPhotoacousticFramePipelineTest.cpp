@@ -0,0 +1,184 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkPhotoacousticFramePipeline.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class mitkPhotoacousticFramePipelineTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPhotoacousticFramePipelineTestSuite);
+  MITK_TEST(testFramesPassAllStagesInOrder);
+  MITK_TEST(testStagesRunConcurrently);
+  MITK_TEST(testDroppedFrames);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  const unsigned int NUMBER_OF_FRAMES = 12;
+
+  mitk::PhotoacousticFramePipeline::Pointer m_Pipeline;
+  std::atomic<int> m_ActiveStages;
+  std::atomic<int> m_MaxActiveStages;
+
+  static mitk::Image::Pointer CreateFrame(float value)
+  {
+    float data[4] = { value, value, value, value };
+    unsigned int dimension[2] = { 2, 2 };
+    mitk::Image::Pointer frame = mitk::Image::New();
+    frame->Initialize(mitk::MakeScalarPixelType<float>(), 2, dimension);
+    frame->SetImportSlice(data, 0, 0, 0, mitk::Image::ImportMemoryManagementType::CopyMemory);
+    return frame;
+  }
+
+  static float GetValue(mitk::Image::Pointer frame)
+  {
+    mitk::ImageReadAccessor readAccess(frame);
+    return ((const float*)readAccess.GetData())[0];
+  }
+
+  // adds summand to every pixel in place, taking some time to let the stages overlap
+  mitk::PhotoacousticFramePipeline::StageFunctionType CreateAddingStage(float summand)
+  {
+    return [this, summand](mitk::Image::Pointer frame)
+    {
+      int active = ++m_ActiveStages;
+      int maxActive = m_MaxActiveStages;
+      while (active > maxActive && !m_MaxActiveStages.compare_exchange_weak(maxActive, active))
+        ;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      {
+        mitk::ImageWriteAccessor writeAccess(frame);
+        float* data = (float*)writeAccess.GetData();
+        for (unsigned int i = 0; i < 4; ++i)
+          data[i] += summand;
+      }
+
+      --m_ActiveStages;
+      return frame;
+    };
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Pipeline = mitk::PhotoacousticFramePipeline::New();
+    m_ActiveStages = 0;
+    m_MaxActiveStages = 0;
+  }
+
+  void tearDown() override
+  {
+    m_Pipeline = nullptr;
+  }
+
+  void testFramesPassAllStagesInOrder()
+  {
+    m_Pipeline->AddStage("add 1", CreateAddingStage(1));
+    m_Pipeline->AddStage("add 10", CreateAddingStage(10));
+    m_Pipeline->AddStage("add 100", CreateAddingStage(100));
+    CPPUNIT_ASSERT_EQUAL(3u, m_Pipeline->GetNumberOfStages());
+    CPPUNIT_ASSERT_EQUAL(std::string("add 10"), m_Pipeline->GetStageName(1));
+
+    m_Pipeline->Start();
+    for (unsigned int frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+      CPPUNIT_ASSERT_EQUAL((unsigned long)frame, m_Pipeline->Push(CreateFrame(1000.f * frame)));
+
+    for (unsigned int frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+    {
+      unsigned long frameNumber = 0;
+      mitk::Image::Pointer output = m_Pipeline->Pop(&frameNumber);
+      CPPUNIT_ASSERT(output.IsNotNull());
+      CPPUNIT_ASSERT_EQUAL((unsigned long)frame, frameNumber);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(1000.f * frame + 111, GetValue(output), 1e-3);
+    }
+    m_Pipeline->Stop();
+
+    CPPUNIT_ASSERT(m_Pipeline->Pop().IsNull());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)NUMBER_OF_FRAMES, m_Pipeline->GetNumberOfProcessedFrames());
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Pipeline->GetNumberOfDroppedFrames());
+    CPPUNIT_ASSERT(m_Pipeline->GetMeanStageDuration(0) > 0);
+    CPPUNIT_ASSERT(m_Pipeline->GetFramesPerSecond() > 0);
+  }
+
+  void testStagesRunConcurrently()
+  {
+    m_Pipeline->AddStage("add 1", CreateAddingStage(1));
+    m_Pipeline->AddStage("add 2", CreateAddingStage(2));
+
+    // the callback is called from a pipeline thread, so the results are checked afterwards
+    std::mutex mutex;
+    std::vector<unsigned long> frameNumbers;
+    std::vector<float> values;
+    m_Pipeline->Start([&](mitk::Image::Pointer frame, unsigned long frameNumber)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      frameNumbers.push_back(frameNumber);
+      values.push_back(GetValue(frame));
+    });
+
+    for (unsigned int frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+      m_Pipeline->Push(CreateFrame(0));
+    m_Pipeline->Stop();
+
+    CPPUNIT_ASSERT_EQUAL((size_t)NUMBER_OF_FRAMES, frameNumbers.size());
+    CPPUNIT_ASSERT(std::is_sorted(frameNumbers.begin(), frameNumbers.end()));
+    for (float value : values)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(3, value, 1e-3);
+    CPPUNIT_ASSERT_MESSAGE("the stages did not work on different frames at the same time", m_MaxActiveStages > 1);
+  }
+
+  void testDroppedFrames()
+  {
+    m_Pipeline->AddStage("drop odd frames", [](mitk::Image::Pointer frame)
+    {
+      if (static_cast<int>(GetValue(frame)) % 2 == 1)
+        throw std::runtime_error("odd frame");
+      return frame;
+    });
+
+    m_Pipeline->Start();
+    for (unsigned int frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+      m_Pipeline->Push(CreateFrame(frame));
+    m_Pipeline->Stop();
+
+    for (unsigned int frame = 0; frame < NUMBER_OF_FRAMES; frame += 2)
+    {
+      unsigned long frameNumber = 0;
+      mitk::Image::Pointer output = m_Pipeline->Pop(&frameNumber);
+      CPPUNIT_ASSERT(output.IsNotNull());
+      CPPUNIT_ASSERT_EQUAL((unsigned long)frame, frameNumber);
+    }
+    CPPUNIT_ASSERT(m_Pipeline->Pop().IsNull());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)NUMBER_OF_FRAMES / 2, m_Pipeline->GetNumberOfDroppedFrames());
+
+    CPPUNIT_ASSERT_THROW(m_Pipeline->Push(CreateFrame(0)), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPhotoacousticFramePipeline)
@@ -35,6 +35,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <thread>
 #include <chrono>
 
+#include <map>
 #include <vector>
 #include <iostream>
 
@@ -50,6 +51,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkPAProbe.h>
 #include <mitkPALightSource.h>
 #include <mitkPAMonteCarloThreadHandler.h>
+#include <mitkPAFluenceAccumulator.h>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -68,6 +70,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define SIGN(x)     ((x)>=0 ? 1:-1)
 #define ONE_MINUS_COSZERO 1.0E-12   /* If 1-cos(theta) <= ONE_MINUS_COSZERO, fabs(theta) <= 1e-6 rad. */
  /* If 1+cos(theta) <= ONE_MINUS_COSZERO, fabs(PI-theta) <= 1e-6 rad. */
+#define PACKET_SIZE 8               /* number of photons propagated in lockstep by one thread */
 
  /* Struct for storing x,y and z coordinates */
 struct Location
@@ -90,17 +93,11 @@ class DetectorVoxel
 {
 public:
   Location location;
-  std::vector<Location>* recordedPhotonRoute = new std::vector<Location>();
-  double* fluenceContribution;
   double m_PhotonNormalizationValue;
-  long m_NumberPhotonsCurrent;
 
-  DetectorVoxel(Location location, long totalNumberOfVoxels, double photonNormalizationValue)
+  DetectorVoxel(Location location, double photonNormalizationValue)
   {
     this->location = location;
-    this->fluenceContribution = (double *)malloc(totalNumberOfVoxels * sizeof(double));
-    for (int j = 0; j < totalNumberOfVoxels; j++)   fluenceContribution[j] = 0; // ensure fluenceContribution[] starts empty.
-    m_NumberPhotonsCurrent = 0;
     m_PhotonNormalizationValue = photonNormalizationValue;
   }
 };
@@ -244,14 +241,8 @@ public:
 
 class ReturnValues
 {
-private:
-  long i1 = 0, i2 = 31; // used Random Generator
-  long ma[56];   // used Random Generator /* ma[0] is not used. */
-  long mj, mk;
-  short i, ii;
 public:
   long long Nphotons;
-  double* totalFluence;
   std::string myname;
   DetectorVoxel* detectorVoxel;
 
@@ -259,94 +250,10 @@ public:
   {
     detectorVoxel = nullptr;
     Nphotons = 0;
-    totalFluence = nullptr;
   }
 
   /* SUBROUTINES */
 
-  /**************************************************************************
-   *  RandomGen
-   *      A random number generator that generates uniformly
-   *      distributed random numbers between 0 and 1 inclusive.
-   *      The algorithm is based on:
-   *      W.H. Press, S.A. Teukolsky, W.T. Vetterling, and B.P.
-   *      Flannery, "Numerical Recipes in C," Cambridge University
-   *      Press, 2nd edition, (1992).
-   *      and
-   *      D.E. Knuth, "Seminumerical Algorithms," 2nd edition, vol. 2
-   *      of "The Art of Computer Programming", Addison-Wesley, (1981).
-   *
-   *      When Type is 0, sets Seed as the seed. Make sure 0<Seed<32000.
-   *      When Type is 1, returns a random number.
-   *      When Type is 2, gets the status of the generator.
-   *      When Type is 3, restores the status of the generator.
-   *
-   *      The status of the generator is represented by Status[0..56].
-   *
-   *      Make sure you initialize the seed before you get random
-   *      numbers.
-   ****/
-#define MBIG 1000000000
-#define MSEED 161803398
-#define MZ 0
-#define FAC 1.0E-9
-
-  double RandomGen(char Type, long Seed, long *Status) {
-    if (Type == 0) {              /* set seed. */
-      if (verbose) std::cout << "Initialized random generator " << this << " with seed: " << Seed << std::endl;
-      mj = MSEED - (Seed < 0 ? -Seed : Seed);
-      mj %= MBIG;
-      ma[55] = mj;
-      mk = 1;
-      for (i = 1; i <= 54; i++) {
-        ii = (21 * i) % 55;
-        ma[ii] = mk;
-        mk = mj - mk;
-        if (mk < MZ)
-          mk += MBIG;
-        mj = ma[ii];
-      }
-      for (ii = 1; ii <= 4; ii++)
-        for (i = 1; i <= 55; i++) {
-          ma[i] -= ma[1 + (i + 30) % 55];
-          if (ma[i] < MZ)
-            ma[i] += MBIG;
-        }
-      i1 = 0;
-      i2 = 31;
-    }
-    else if (Type == 1) {       /* get a number. */
-      if (++i1 == 56)
-        i1 = 1;
-      if (++i2 == 56)
-        i2 = 1;
-      mj = ma[i1] - ma[i2];
-      if (mj < MZ)
-        mj += MBIG;
-      ma[i1] = mj;
-      return (mj * FAC);
-    }
-    else if (Type == 2) {       /* get status. */
-      for (i = 0; i < 55; i++)
-        Status[i] = ma[i + 1];
-      Status[55] = i1;
-      Status[56] = i2;
-    }
-    else if (Type == 3) {       /* restore status. */
-      for (i = 0; i < 55; i++)
-        ma[i + 1] = Status[i];
-      i1 = Status[55];
-      i2 = Status[56];
-    }
-    else
-      puts("Wrong parameter to RandomGen().");
-    return (0);
-  }
-#undef MBIG
-#undef MSEED
-#undef MZ
-#undef FAC
-
   /***********************************************************
    *  Determine if the two position are located in the same voxel
    *  Returns 1 if same voxel, 0 if not same voxel.
@@ -612,9 +519,88 @@ public:
   }
 };
 
+/**************************************************************************
+ *  PhotonRandomGen
+ *      A counter based random number generator. The n-th random number of a
+ *      photon is a hash of the seed, the index of its work package, its index
+ *      inside the package and n. So the random numbers of a photon neither
+ *      depend on the thread simulating it nor on the photons simulated
+ *      before, which makes the result independent of the number of threads.
+ *      The hash is the finalizer of SplitMix64:
+ *      G.L. Steele, D. Lea, and C.H. Flood, "Fast splittable pseudorandom
+ *      number generators," OOPSLA 2014.
+ *
+ *      Next() returns uniformly distributed random numbers in (0, 1].
+ ****/
+class PhotonRandomGen
+{
+public:
+  PhotonRandomGen() : m_Key(0), m_Counter(0) {}
+
+  void Initialize(unsigned long long seed, long workPackage, long photon)
+  {
+    m_Key = Mix(Mix(Mix(seed) + (unsigned long long)workPackage) + (unsigned long long)photon);
+    m_Counter = 0;
+  }
+
+  double Next()
+  {
+    unsigned long long bits = Mix(m_Key ^ Mix(++m_Counter));
+    return ((bits >> 11) + 1) * (1.0 / 9007199254740992.0); /* 53 random bits, 2^-53 <= rnd <= 1 */
+  }
+
+private:
+  static unsigned long long Mix(unsigned long long z)
+  {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  unsigned long long m_Key;
+  unsigned long long m_Counter;
+};
+
+/***********************************************************
+ *  PhotonPacket
+ *  State of PACKET_SIZE photons which are propagated in lockstep. Every
+ *  quantity is stored in its own array, so that the steps without
+ *  branches (sampling of the step size, SPIN) are plain loops over the
+ *  packet which the compiler can vectorize. Lanes without a photon are DEAD.
+ ****/
+struct PhotonPacket
+{
+  double x[PACKET_SIZE], y[PACKET_SIZE], z[PACKET_SIZE];     /* photon position */
+  double ux[PACKET_SIZE], uy[PACKET_SIZE], uz[PACKET_SIZE];  /* photon trajectory as cosines */
+  double W[PACKET_SIZE];                                     /* photon weight */
+  double sleft[PACKET_SIZE];                                 /* dimensionless step */
+  long i[PACKET_SIZE];                                       /* index of the current voxel */
+  int ix[PACKET_SIZE], iy[PACKET_SIZE], iz[PACKET_SIZE];
+  int bflag[PACKET_SIZE];                                    /* 1 = photon inside volume, 0 = outside */
+  short status[PACKET_SIZE];                                 /* ALIVE or DEAD */
+  PhotonRandomGen rng[PACKET_SIZE];
+  std::vector<Location> route[PACKET_SIZE];                  /* recorded photon route for the PVFC */
+
+  PhotonPacket()
+  {
+    for (int lane = 0; lane < PACKET_SIZE; lane++)
+    {
+      x[lane] = y[lane] = z[lane] = 0;
+      ux[lane] = uy[lane] = 0;
+      uz[lane] = 1;
+      W[lane] = sleft[lane] = 0;
+      i[lane] = 0;
+      ix[lane] = iy[lane] = iz[lane] = 0;
+      bflag[lane] = 0;
+      status[lane] = DEAD;
+    }
+  }
+};
+
 /* DECLARE FUNCTIONS */
 
-void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thread, mitk::pa::MonteCarloThreadHandler::Pointer threadHandler);
+void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thread, mitk::pa::MonteCarloThreadHandler::Pointer threadHandler, mitk::pa::FluenceAccumulator* accumulator);
 
 int detector_x = -1;
 int detector_z = -1;
@@ -623,6 +609,7 @@ bool simulatePVFC = false;
 int requestedNumberOfPhotons = 100000;
 float requestedSimulationTime = 0; // in minutes
 int concurentThreadsSupported = -1;
+unsigned long long randomSeed = 0;
 float yOffset = 0; // in mm
 bool saveLegacy = false;
 std::string normalizationFilename;
@@ -675,6 +662,9 @@ int main(int argc, char * argv[]) {
   parser.addArgument(
     "jobs", "j", mitkCommandLineParser::Int,
     "Number of jobs", "Specifies the number of jobs for simutation (default: -1 which starts as many jobs as supported).");
+  parser.addArgument(
+    "seed", "s", mitkCommandLineParser::Int,
+    "Random seed", "Specifies the seed of the random number generator (default: derived from the current time). With the same seed and number of photons the result is identical for any number of jobs.");
   parser.addArgument(
     "probe-xml", "p", mitkCommandLineParser::InputFile,
     "Xml definition of the probe", "Specifies the absolute path of the location of the xml definition file of the probe design.");
@@ -730,6 +720,14 @@ int main(int argc, char * argv[]) {
   {
     concurentThreadsSupported = us::any_cast<int>(parsedArgs["jobs"]);
   }
+  if (parsedArgs.count("seed"))
+  {
+    randomSeed = us::any_cast<int>(parsedArgs["seed"]);
+  }
+  else
+  {
+    randomSeed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
   if (parsedArgs.count("probe-xml"))
   {
     std::string inputXmlProbeDesign = us::any_cast<std::string>(parsedArgs["probe-xml"]);
@@ -799,19 +797,22 @@ int main(int argc, char * argv[]) {
   if (simulatePVFC)
     threadHandler->SetPackageSize(1000);
 
-  if (verbose) std::cout << "\nStarting simulation ...\n" << std::endl;
+  mitk::pa::FluenceAccumulator::Pointer accumulator = mitk::pa::FluenceAccumulator::New(allInput.totalNumberOfVoxels, simulatePVFC);
+
+  if (verbose) std::cout << "\nStarting simulation with random seed " << randomSeed << " ...\n" << std::endl;
 
   auto simulationStartTime = std::chrono::system_clock::now();
 
   for (int i = 0; i < concurentThreadsSupported; i++)
   {
-    threads[i] = std::thread(runMonteCarlo, &allInput, &allValues[i], (i + 1), threadHandler);
+    threads[i] = std::thread(runMonteCarlo, &allInput, &allValues[i], (i + 1), threadHandler, accumulator.GetPointer());
   }
 
   for (int i = 0; i < concurentThreadsSupported; i++)
   {
     threads[i].join();
   }
+  accumulator->Finish();
 
   auto simulationFinishTime = std::chrono::system_clock::now();
   auto simulationTimeElapsed = simulationFinishTime - simulationStartTime;
@@ -820,34 +821,23 @@ int main(int argc, char * argv[]) {
   std::cout << "total time for simulation: "
     << (int)std::chrono::duration_cast<std::chrono::seconds>(simulationTimeElapsed).count() << "sec " << std::endl;
 
+  long long simulatedPhotons = 0;
+  for (int t = 0; t < concurentThreadsSupported; t++)
+    simulatedPhotons += allValues[t].Nphotons;
+  double simulationSeconds = std::chrono::duration_cast<std::chrono::microseconds>(simulationTimeElapsed).count() / 1e6;
+  std::cout << "photons per second: "
+    << (simulationSeconds > 0 ? simulatedPhotons / simulationSeconds : 0) << " (" << concurentThreadsSupported << " jobs, random seed " << randomSeed << ")" << std::endl;
+
   /**** SAVE
    Convert data to relative fluence rate [cm^-2] and save.
    *****/
 
   if (!simulatePVFC)
   {
-    if (verbose) std::cout << "Allocating memory for normal simulation result ... ";
-    auto* finalTotalFluence = (double *)malloc(allInput.totalNumberOfVoxels * sizeof(double));
-    if (verbose) std::cout << "[OK]" << std::endl;
-    if (verbose) std::cout << "Cleaning memory for normal simulation result ...";
-    for (int i = 0; i < allInput.totalNumberOfVoxels; i++) {
-      finalTotalFluence[i] = 0;
-    }
-    if (verbose) std::cout << "[OK]" << std::endl;
-
     if (verbose) std::cout << "Calculating resulting fluence ... ";
-    double tdx = 0, tdy = 0, tdz = 0;
-    long long tNphotons = 0;
-    for (int t = 0; t < concurentThreadsSupported; t++)
-    {
-      tdx = allInput.xSpacing;
-      tdy = allInput.ySpacing;
-      tdz = allInput.zSpacing;
-      tNphotons += allValues[t].Nphotons;
-      for (int voxelNumber = 0; voxelNumber < allInput.totalNumberOfVoxels; voxelNumber++) {
-        finalTotalFluence[voxelNumber] += allValues[t].totalFluence[voxelNumber];
-      }
-    }
+    double* finalTotalFluence = accumulator->GetTotalFluence();
+    double tdx = allInput.xSpacing, tdy = allInput.ySpacing, tdz = allInput.zSpacing;
+    long long tNphotons = simulatedPhotons;
     if (verbose) std::cout << "[OK]" << std::endl;
     std::cout << "total number of photons simulated: "
       << tNphotons << std::endl;
@@ -896,31 +886,11 @@ int main(int argc, char * argv[]) {
   }
   else // if simulate PVFC
   {
-    if (verbose) std::cout << "Allocating memory for PVFC simulation result ... ";
-    double* detectorFluence = ((double*)malloc(allInput.totalNumberOfVoxels * sizeof(double)));
-    if (verbose) std::cout << "[OK]" << std::endl;
-    if (verbose) std::cout << "Cleaning memory for PVFC simulation result ...";
-    for (int i = 0; i < allInput.totalNumberOfVoxels; i++) {
-      detectorFluence[i] = 0;
-    }
-    if (verbose) std::cout << "[OK]" << std::endl;
-
     if (verbose) std::cout << "Calculating resulting PVFC fluence ... ";
-    double tdx = 0, tdy = 0, tdz = 0;
-    long long tNphotons = 0;
-    long pvfcPhotons = 0;
-    for (int t = 0; t < concurentThreadsSupported; t++)
-    {
-      tdx = allInput.xSpacing;
-      tdy = allInput.ySpacing;
-      tdz = allInput.zSpacing;
-      tNphotons += allValues[t].Nphotons;
-      pvfcPhotons += allValues[t].detectorVoxel->m_NumberPhotonsCurrent;
-      for (int voxelNumber = 0; voxelNumber < allInput.totalNumberOfVoxels; voxelNumber++) {
-        detectorFluence[voxelNumber] +=
-          allValues[t].detectorVoxel->fluenceContribution[voxelNumber];
-      }
-    }
+    double* detectorFluence = accumulator->GetDetectorFluence();
+    double tdx = allInput.xSpacing, tdy = allInput.ySpacing, tdz = allInput.zSpacing;
+    long long tNphotons = simulatedPhotons;
+    long pvfcPhotons = accumulator->GetNumberOfDetectorPhotons();
     if (verbose) std::cout << "[OK]" << std::endl;
     std::cout << "total number of photons simulated: "
       << tNphotons << std::endl;
@@ -989,40 +959,365 @@ int main(int argc, char * argv[]) {
 } /* end of main */
 
 /* CORE FUNCTION */
-void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thread, mitk::pa::MonteCarloThreadHandler::Pointer threadHandler)
-{
-  if (verbose) std::cout << "Thread " << thread << ": Locking Mutex ..." << std::endl;
-  if (verbose) std::cout << "[OK]" << std::endl;
-  if (verbose) std::cout << "Initializing ... ";
 
-  /* Propagation parameters */
+/***********************************************************
+ *  LAUNCH
+ *  Initialize position, trajectory and voxel of the photon in the given
+ *  lane. packet.rng[lane] has to be initialized for the photon before.
+ ****/
+void launchPhoton(InputValues* inputValues, PhotonPacket& packet, int lane)
+{
+  PhotonRandomGen& rng = packet.rng[lane];
   double  x, y, z;        /* photon position */
   double  ux, uy, uz;     /* photon trajectory as cosines */
-  double  uxx, uyy, uzz;  /* temporary values used during SPIN */
-  double  s;              /* step sizes. s = -log(RND)/mus [cm] */
-  double  sleft;          /* dimensionless */
   double  costheta;       /* cos(theta) */
   double  sintheta;       /* sin(theta) */
   double  cospsi;         /* cos(psi) */
   double  sinpsi;         /* sin(psi) */
   double  psi;            /* azimuthal angle */
-  long    photonIterator = 0;       /* current photon */
-  double  W;              /* photon weight */
+  double  rnd;            /* assigned random value 0-1 */
+  double  r, phi;         /* dummy values */
+  double  temp;           /* dummy variable */
+
+  /**** SET SOURCE* Launch collimated beam at x,y center.****/
+  /****************************/
+  /* Initial position. */
+
+  if (m_PhotoacousticProbe.IsNotNull())
+  {
+    double rnd1 = rng.Next();
+    double rnd2 = rng.Next();
+    double rnd3 = rng.Next();
+    double rnd4 = rng.Next();
+    double rnd5 = rng.Next();
+    double rnd6 = rng.Next();
+    double rnd7 = rng.Next();
+    double rnd8 = rng.Next();
+
+    mitk::pa::LightSource::PhotonInformation info = m_PhotoacousticProbe->GetNextPhoton(rnd1, rnd2, rnd3, rnd4, rnd5, rnd6, rnd7, rnd8);
+    x = info.xPosition;
+    y = yOffset + info.yPosition;
+    z = info.zPosition;
+    ux = info.xAngle;
+    uy = info.yAngle;
+    uz = info.zAngle;
+    if (verbose)
+      std::cout << "Created photon at position (" << x << "|" << y << "|" << z << ") with angles (" << ux << "|" << uy << "|" << uz << ")." << std::endl;
+  }
+  else
+  {
+    /* trajectory */
+    if (inputValues->launchflag == 1) // manually set launch
+    {
+      x = inputValues->xs;
+      y = inputValues->ys;
+      z = inputValues->zs;
+      ux = inputValues->ux0;
+      uy = inputValues->uy0;
+      uz = inputValues->uz0;
+    }
+    else // use mcflag
+    {
+      if (inputValues->mcflag == 0) // uniform beam
+      {
+        // set launch point and width of beam
+        rnd = rng.Next();
+        r = inputValues->radius*sqrt(rnd); // radius of beam at launch point
+        rnd = rng.Next();
+        phi = rnd*2.0*PI;
+        x = inputValues->xs + r*cos(phi);
+        y = inputValues->ys + r*sin(phi);
+        z = inputValues->zs;
+        // set trajectory toward focus
+        rnd = rng.Next();
+        r = inputValues->waist*sqrt(rnd); // radius of beam at focus
+        rnd = rng.Next();
+        phi = rnd*2.0*PI;
+
+        // the focus is sampled per photon, so it must not be stored in the shared input values
+        double xfocus = r*cos(phi);
+        double yfocus = r*sin(phi);
+        temp = sqrt((x - xfocus)*(x - xfocus)
+          + (y - yfocus)*(y - yfocus) + inputValues->zfocus*inputValues->zfocus);
+        ux = -(x - xfocus) / temp;
+        uy = -(y - yfocus) / temp;
+        uz = sqrt(1 - ux*ux + uy*uy);
+      }
+      else if (inputValues->mcflag == 5) // Multispectral DKFZ prototype
+      {
+        // set launch point and width of beam
+        rnd = rng.Next();
+
+        //offset in x direction in cm (random)
+        x = (rnd*2.5) - 1.25;
+
+        rnd = rng.Next();
+        double b = ((rnd)-0.5);
+        y = (b > 0 ? yOffset + 1.5 : yOffset - 1.5);
+        z = 0.1;
+        ux = 0;
+
+        rnd = rng.Next();
+
+        //Angle of beam in y direction
+        uy = sin((rnd*0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * 0.436);
+
+        rnd = rng.Next();
+
+        // angle of beam in x direction
+        ux = sin((rnd*0.42) - 0.21);
+        uz = sqrt(1 - ux*ux - uy*uy);
+      }
+      else if (inputValues->mcflag == 4) // Monospectral prototype DKFZ
+      {
+        // set launch point and width of beam
+        rnd = rng.Next();
+
+        //offset in x direction in cm (random)
+        x = (rnd*2.5) - 1.25;
+
+        rnd = rng.Next();
+        double b = ((rnd)-0.5);
+        y = (b > 0 ? yOffset + 0.83 : yOffset - 0.83);
+        z = 0.1;
+        ux = 0;
+
+        rnd = rng.Next();
+
+        //Angle of beam in y direction
+        uy = sin((rnd*0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * 0.375);
+
+        rnd = rng.Next();
+
+        // angle of beam in x direction
+        ux = sin((rnd*0.42) - 0.21);
+        uz = sqrt(1 - ux*ux - uy*uy);
+      }
+      else { // isotropic pt source
+        costheta = 1.0 - 2.0 * rng.Next();
+        sintheta = sqrt(1.0 - costheta*costheta);
+        psi = 2.0 * PI * rng.Next();
+        cospsi = cos(psi);
+        if (psi < PI)
+          sinpsi = sqrt(1.0 - cospsi*cospsi);
+        else
+          sinpsi = -sqrt(1.0 - cospsi*cospsi);
+        x = inputValues->xs;
+        y = inputValues->ys;
+        z = inputValues->zs;
+        ux = sintheta*cospsi;
+        uy = sintheta*sinpsi;
+        uz = costheta;
+      }
+    } // end  use mcflag
+  }
+  /****************************/
+
+  /* Get tissue voxel properties of launchpoint.
+   * If photon beyond outer edge of defined voxels,
+   * the tissue equals properties of outermost voxels.
+   * Therefore, set outermost voxels to infinite background value.
+   */
+  int ix = (int)(inputValues->Nx / 2 + x / inputValues->xSpacing);
+  int iy = (int)(inputValues->Ny / 2 + y / inputValues->ySpacing);
+  int iz = (int)(z / inputValues->zSpacing);
+  if (ix >= inputValues->Nx) ix = inputValues->Nx - 1;
+  if (iy >= inputValues->Ny) iy = inputValues->Ny - 1;
+  if (iz >= inputValues->Nz) iz = inputValues->Nz - 1;
+  if (ix < 0)   ix = 0;
+  if (iy < 0)   iy = 0;
+  if (iz < 0)   iz = 0;
+
+  packet.x[lane] = x;
+  packet.y[lane] = y;
+  packet.z[lane] = z;
+  packet.ux[lane] = ux;
+  packet.uy[lane] = uy;
+  packet.uz[lane] = uz;
+  packet.ix[lane] = ix;
+  packet.iy[lane] = iy;
+  packet.iz[lane] = iz;
+  /* Get the tissue type of located voxel */
+  packet.i[lane] = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
+  packet.bflag[lane] = 1; // initialize as 1 = inside volume, but later check as photon propagates.
+  packet.W[lane] = 1.0;             /* set photon weight to one */
+  packet.status[lane] = ALIVE;      /* Launch an ALIVE photon */
+  packet.route[lane].clear();
+}
+
+/***********************************************************
+ *  Add the weight absorbed in voxel (ix, iy, iz) to the route of a photon.
+ *  If the photon is at the detector position, the whole route is added to
+ *  the detector fluence and the route starts anew.
+ ****/
+void recordPhotonRoute(InputValues* inputValues, DetectorVoxel* detectorVoxel, std::vector<Location>& route, mitk::pa::FluenceAccumulator::ThreadFluence* fluence, int ix, int iy, int iz, double absorb)
+{
+  //Add photon position to the recorded photon route
+  route.push_back(initLocation(ix, iy, iz, absorb));
+
+  //If the photon is currently at the detector position
+  if ((detectorVoxel->location.x == ix)
+    && ((detectorVoxel->location.y == iy)
+      || (detectorVoxel->location.y - 1 == iy))
+    && (detectorVoxel->location.z == iz))
+  {
+    //For each voxel in the recorded photon route
+    for (const Location& location : route)
+    {
+      //increment the fluence contribution at that particular position
+      long i = (long)(location.z*inputValues->Ny*inputValues->Nx + location.x*inputValues->Ny + location.y);
+      fluence->AddDetectorFluence(i, location.absorb);
+    }
+
+    //Clear the recorded photon route
+    fluence->AddDetectorPhoton();
+    route.clear();
+  }
+}
+
+/***********************************************************
+ *  HOP and DROP
+ *  Move the photon in the given lane by its dimensionless step packet.sleft,
+ *  voxel by voxel, and drop the absorbed weight into the voxels passed.
+ ****/
+void hopAndDrop(InputValues* inputValues, ReturnValues* returnValue, PhotonPacket& packet, int lane, mitk::pa::FluenceAccumulator::ThreadFluence* fluence)
+{
+  double  x = packet.x[lane], y = packet.y[lane], z = packet.z[lane];
+  double  ux = packet.ux[lane], uy = packet.uy[lane], uz = packet.uz[lane];
+  double  W = packet.W[lane];
+  double  sleft = packet.sleft[lane];
+  long    i = packet.i[lane];
+  int     ix = packet.ix[lane], iy = packet.iy[lane], iz = packet.iz[lane];
+  int     bflag = packet.bflag[lane];
+  short   photon_status = packet.status[lane];
+  double  s;              /* step sizes. s = -log(RND)/mus [cm] */
   double  absorb;         /* weighted deposited in a step due to absorption */
-  short   photon_status;  /* flag = ALIVE=1 or DEAD=0 */
+  double  tempx, tempy, tempz; /* temporary variables, used during photon step. */
   bool    sv;             /* Are they in the same voxel? */
+  DetectorVoxel* detectorVoxel = returnValue->detectorVoxel;
 
-  /* dummy variables */
-  double  rnd;         /* assigned random value 0-1 */
-  double  r, phi;      /* dummy values */
-  long    i, j;         /* dummy indices */
-  double  tempx, tempy, tempz; /* temporary variables, used during photon step. */
-  int     ix, iy, iz;  /* Added. Used to track photons */
-  double  temp;        /* dummy variable */
-  int     bflag;       /* boundary flag:  0 = photon inside volume. 1 = outside volume */
-  int     CNT = 0;
+  do {  // while sleft>0
+    s = sleft / inputValues->musVector[i];        /* Step size [cm].*/
+    tempx = x + s*ux;        /* Update positions. [cm] */
+    tempy = y + s*uy;
+    tempz = z + s*uz;
+
+    sv = returnValue->SameVoxel(x, y, z, tempx, tempy, tempz, inputValues->xSpacing, inputValues->ySpacing, inputValues->zSpacing);
+    if (sv) /* photon in same voxel */
+    {
+      x = tempx;  /* Update positions. */
+      y = tempy;
+      z = tempz;
 
-  returnValue->totalFluence = (double *)malloc(inputValues->totalNumberOfVoxels * sizeof(double));  /* relative fluence rate [W/cm^2/W.delivered] */
+      /**** DROP
+      Drop photon weight (W) into local bin.
+      *****/
+
+      absorb = W*(1 - exp(-inputValues->muaVector[i] * s));  /* photon weight absorbed at this step */
+      W -= absorb;          /* decrement WEIGHT by amount absorbed */
+      // If photon within volume of heterogeneity, deposit energy in F[].
+      // Normalize F[] later, when save output.
+      if (bflag)
+      {
+        i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
+        fluence->AddTotalFluence(i, absorb);
+        // only save data if blag==1, i.e., photon inside simulation cube
+
+        if (detectorVoxel != nullptr)
+          recordPhotonRoute(inputValues, detectorVoxel, packet.route[lane], fluence, ix, iy, iz, absorb);
+      }
+
+      /* Update sleft */
+      sleft = 0;    /* dimensionless step remaining */
+    }
+    else /* photon has crossed voxel boundary */
+    {
+      /* step to voxel face + "littlest step" so just inside new voxel. */
+      s = ls + returnValue->FindVoxelFace2(x, y, z, tempx, tempy, tempz, inputValues->xSpacing, inputValues->ySpacing, inputValues->zSpacing, ux, uy, uz);
+
+      /**** DROP
+      Drop photon weight (W) into local bin.
+      *****/
+      absorb = W*(1 - exp(-inputValues->muaVector[i] * s));   /* photon weight absorbed at this step */
+      W -= absorb;                  /* decrement WEIGHT by amount absorbed */
+      // If photon within volume of heterogeneity, deposit energy in F[].
+      // Normalize F[] later, when save output.
+      if (bflag)
+      {
+        // only save data if bflag==1, i.e., photon inside simulation cube
+        if (detectorVoxel != nullptr)
+          recordPhotonRoute(inputValues, detectorVoxel, packet.route[lane], fluence, ix, iy, iz, absorb);
+
+        i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
+        fluence->AddTotalFluence(i, absorb);
+      }
+
+      /* Update sleft */
+      sleft -= s*inputValues->musVector[i];  /* dimensionless step remaining */
+      if (sleft <= ls) sleft = 0;
+
+      /* Update positions. */
+      x += s*ux;
+      y += s*uy;
+      z += s*uz;
+
+      // pointers to voxel containing optical properties
+      ix = (int)(inputValues->Nx / 2 + x / inputValues->xSpacing);
+      iy = (int)(inputValues->Ny / 2 + y / inputValues->ySpacing);
+      iz = (int)(z / inputValues->zSpacing);
+
+      bflag = 1;  // Boundary flag. Initialize as 1 = inside volume, then check.
+      if (inputValues->boundaryflag == 0) { // Infinite medium.
+        // Check if photon has wandered outside volume.
+        // If so, set tissue type to boundary value, but let photon wander.
+        // Set blag to zero, so DROP does not deposit energy.
+        if (iz >= inputValues->Nz) { iz = inputValues->Nz - 1; bflag = 0; }
+        if (ix >= inputValues->Nx) { ix = inputValues->Nx - 1; bflag = 0; }
+        if (iy >= inputValues->Ny) { iy = inputValues->Ny - 1; bflag = 0; }
+        if (iz < 0) { iz = 0;    bflag = 0; }
+        if (ix < 0) { ix = 0;    bflag = 0; }
+        if (iy < 0) { iy = 0;    bflag = 0; }
+      }
+      else if (inputValues->boundaryflag == 1) { // Escape at boundaries
+        if (iz >= inputValues->Nz) { iz = inputValues->Nz - 1; photon_status = DEAD; sleft = 0; }
+        if (ix >= inputValues->Nx) { ix = inputValues->Nx - 1; photon_status = DEAD; sleft = 0; }
+        if (iy >= inputValues->Ny) { iy = inputValues->Ny - 1; photon_status = DEAD; sleft = 0; }
+        if (iz < 0) { iz = 0;    photon_status = DEAD; sleft = 0; }
+        if (ix < 0) { ix = 0;    photon_status = DEAD; sleft = 0; }
+        if (iy < 0) { iy = 0;    photon_status = DEAD; sleft = 0; }
+      }
+      else if (inputValues->boundaryflag == 2) { // Escape at top surface, no x,y bottom z boundaries
+        if (iz >= inputValues->Nz) { iz = inputValues->Nz - 1; bflag = 0; }
+        if (ix >= inputValues->Nx) { ix = inputValues->Nx - 1; bflag = 0; }
+        if (iy >= inputValues->Ny) { iy = inputValues->Ny - 1; bflag = 0; }
+        if (iz < 0) { iz = 0;    photon_status = DEAD; sleft = 0; }
+        if (ix < 0) { ix = 0;    bflag = 0; }
+        if (iy < 0) { iy = 0;    bflag = 0; }
+      }
+
+      // update pointer to tissue type
+      i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
+    } //(sv) /* same voxel */
+  } while (sleft > 0); //do...while
+
+  packet.x[lane] = x;
+  packet.y[lane] = y;
+  packet.z[lane] = z;
+  packet.W[lane] = W;
+  packet.sleft[lane] = sleft;
+  packet.i[lane] = i;
+  packet.ix[lane] = ix;
+  packet.iy[lane] = iy;
+  packet.iz[lane] = iz;
+  packet.bflag[lane] = bflag;
+  packet.status[lane] = photon_status;
+}
+
+void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thread, mitk::pa::MonteCarloThreadHandler::Pointer threadHandler, mitk::pa::FluenceAccumulator* accumulator)
+{
+  if (verbose) std::cout << "Thread " << thread << ": Locking Mutex ..." << std::endl;
+  if (verbose) std::cout << "[OK]" << std::endl;
+  if (verbose) std::cout << "Initializing ... ";
 
   if (detector_x != -1 && detector_z != -1)
   {
@@ -1038,21 +1333,23 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
     }
 
     double photonNormalizationValue = 1 / inputValues->GetNormalizationValue(detector_x, inputValues->Ny / 2, detector_z);
-    returnValue->detectorVoxel = new DetectorVoxel(initLocation(detector_x, inputValues->Ny / 2, detector_z, 0), inputValues->totalNumberOfVoxels, photonNormalizationValue);
+    returnValue->detectorVoxel = new DetectorVoxel(initLocation(detector_x, inputValues->Ny / 2, detector_z, 0), photonNormalizationValue);
   }
 
   /**** ======================== MAJOR CYCLE ============================ *****/
 
-  auto duration = std::chrono::system_clock::now().time_since_epoch();
-  returnValue->RandomGen(0, (std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() + thread) % 32000, nullptr); /* initiate with seed = 1, or any long integer. */
-  for (j = 0; j < inputValues->totalNumberOfVoxels; j++) returnValue->totalFluence[j] = 0; // ensure F[] starts empty.
+  PhotonPacket packet;
+  mitk::pa::FluenceAccumulator::ThreadFluence* fluence = accumulator->CreateThreadFluence();
+  double rndTheta[PACKET_SIZE];  /* random values for the SPIN of all lanes */
+  double rndPsi[PACKET_SIZE];
 
   /**** RUN Launch N photons, initializing each one before progation. *****/
 
   long photonsToSimulate = 0;
+  long workPackage = 0;
 
-  do {
-    photonsToSimulate = threadHandler->GetNextWorkPackage();
+  while ((photonsToSimulate = threadHandler->GetNextWorkPackage(&workPackage)) > 0)
+  {
     if (returnValue->detectorVoxel != nullptr)
     {
       photonsToSimulate = photonsToSimulate * returnValue->detectorVoxel->m_PhotonNormalizationValue;
@@ -1061,413 +1358,103 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
     if (verbose)
       MITK_INFO << "Photons to simulate: " << photonsToSimulate;
 
-    photonIterator = 0L;
-
-    do {
-      /**** LAUNCH Initialize photon position and trajectory. *****/
-
-      photonIterator += 1;        /* increment photon count */
-      W = 1.0;                    /* set photon weight to one */
-      photon_status = ALIVE;      /* Launch an ALIVE photon */
-      CNT = 0;
+    long photonIterator = 0L;   /* next photon of the package */
 
-      /**** SET SOURCE* Launch collimated beam at x,y center.****/
-      /****************************/
-      /* Initial position. */
-
-      if (m_PhotoacousticProbe.IsNotNull())
-      {
-        double rnd1 = -1;
-        double rnd2 = -1;
-        double rnd3 = -1;
-        double rnd4 = -1;
-        double rnd5 = -1;
-        double rnd6 = -1;
-        double rnd7 = -1;
-        double rnd8 = -1;
-
-        while ((rnd1 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd2 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd3 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd4 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd5 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd6 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd7 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd8 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-        mitk::pa::LightSource::PhotonInformation info = m_PhotoacousticProbe->GetNextPhoton(rnd1, rnd2, rnd3, rnd4, rnd5, rnd6, rnd7, rnd8);
-        x = info.xPosition;
-        y = yOffset + info.yPosition;
-        z = info.zPosition;
-        ux = info.xAngle;
-        uy = info.yAngle;
-        uz = info.zAngle;
-        if (verbose)
-          std::cout << "Created photon at position (" << x << "|" << y << "|" << z << ") with angles (" << ux << "|" << uy << "|" << uz << ")." << std::endl;
-      }
-      else
+    while (true)
+    {
+      /**** LAUNCH a new photon into every lane whose photon is DEAD. *****/
+      bool anyAlive = false;
+      for (int lane = 0; lane < PACKET_SIZE; lane++)
       {
-        /* trajectory */
-        if (inputValues->launchflag == 1) // manually set launch
+        if (packet.status[lane] == DEAD && photonIterator < photonsToSimulate)
         {
-          x = inputValues->xs;
-          y = inputValues->ys;
-          z = inputValues->zs;
-          ux = inputValues->ux0;
-          uy = inputValues->uy0;
-          uz = inputValues->uz0;
+          packet.rng[lane].Initialize(randomSeed, workPackage, photonIterator);
+          photonIterator += 1;
+          launchPhoton(inputValues, packet, lane);
         }
-        else // use mcflag
-        {
-          if (inputValues->mcflag == 0) // uniform beam
-          {
-            // set launch point and width of beam
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
-            r = inputValues->radius*sqrt(rnd); // radius of beam at launch point
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
-            phi = rnd*2.0*PI;
-            x = inputValues->xs + r*cos(phi);
-            y = inputValues->ys + r*sin(phi);
-            z = inputValues->zs;
-            // set trajectory toward focus
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
-            r = inputValues->waist*sqrt(rnd); // radius of beam at focus
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
-            phi = rnd*2.0*PI;
-
-            // !!!!!!!!!!!!!!!!!!!!!!! setting input values will braek
-
-            inputValues->xfocus = r*cos(phi);
-            inputValues->yfocus = r*sin(phi);
-            temp = sqrt((x - inputValues->xfocus)*(x - inputValues->xfocus)
-              + (y - inputValues->yfocus)*(y - inputValues->yfocus) + inputValues->zfocus*inputValues->zfocus);
-            ux = -(x - inputValues->xfocus) / temp;
-            uy = -(y - inputValues->yfocus) / temp;
-            uz = sqrt(1 - ux*ux + uy*uy);
-          }
-          else if (inputValues->mcflag == 5) // Multispectral DKFZ prototype
-          {
-            // set launch point and width of beam
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-            //offset in x direction in cm (random)
-            x = (rnd*2.5) - 1.25;
-
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-            double b = ((rnd)-0.5);
-            y = (b > 0 ? yOffset + 1.5 : yOffset - 1.5);
-            z = 0.1;
-            ux = 0;
-
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-            //Angle of beam in y direction
-            uy = sin((rnd*0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * 0.436);
-
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-            // angle of beam in x direction
-            ux = sin((rnd*0.42) - 0.21);
-            uz = sqrt(1 - ux*ux - uy*uy);
-          }
-          else if (inputValues->mcflag == 4) // Monospectral prototype DKFZ
-          {
-            // set launch point and width of beam
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-            //offset in x direction in cm (random)
-            x = (rnd*2.5) - 1.25;
-
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-            double b = ((rnd)-0.5);
-            y = (b > 0 ? yOffset + 0.83 : yOffset - 0.83);
-            z = 0.1;
-            ux = 0;
-
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-            //Angle of beam in y direction
-            uy = sin((rnd*0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * 0.375);
-
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-
-            // angle of beam in x direction
-            ux = sin((rnd*0.42) - 0.21);
-            uz = sqrt(1 - ux*ux - uy*uy);
-          }
-          else { // isotropic pt source
-            costheta = 1.0 - 2.0 * returnValue->RandomGen(1, 0, nullptr);
-            sintheta = sqrt(1.0 - costheta*costheta);
-            psi = 2.0 * PI * returnValue->RandomGen(1, 0, nullptr);
-            cospsi = cos(psi);
-            if (psi < PI)
-              sinpsi = sqrt(1.0 - cospsi*cospsi);
-            else
-              sinpsi = -sqrt(1.0 - cospsi*cospsi);
-            x = inputValues->xs;
-            y = inputValues->ys;
-            z = inputValues->zs;
-            ux = sintheta*cospsi;
-            uy = sintheta*sinpsi;
-            uz = costheta;
-          }
-        } // end  use mcflag
+        anyAlive = anyAlive || packet.status[lane] == ALIVE;
       }
-      /****************************/
+      if (!anyAlive)
+        break;
 
-      /* Get tissue voxel properties of launchpoint.
-     * If photon beyond outer edge of defined voxels,
-     * the tissue equals properties of outermost voxels.
-     * Therefore, set outermost voxels to infinite background value.
-     */
-      ix = (int)(inputValues->Nx / 2 + x / inputValues->xSpacing);
-      iy = (int)(inputValues->Ny / 2 + y / inputValues->ySpacing);
-      iz = (int)(z / inputValues->zSpacing);
-      if (ix >= inputValues->Nx) ix = inputValues->Nx - 1;
-      if (iy >= inputValues->Ny) iy = inputValues->Ny - 1;
-      if (iz >= inputValues->Nz) iz = inputValues->Nz - 1;
-      if (ix < 0)   ix = 0;
-      if (iy < 0)   iy = 0;
-      if (iz < 0)   iz = 0;
-      /* Get the tissue type of located voxel */
-      i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
-
-      bflag = 1; // initialize as 1 = inside volume, but later check as photon propagates.
-
-      if (returnValue->detectorVoxel != nullptr)
-        returnValue->detectorVoxel->recordedPhotonRoute->clear();
+      /**** HOP_DROP_SPIN_CHECK
+      One step of all photons in the packet. The random numbers of a lane
+      only influence the photon in this lane, so drawing them for DEAD
+      lanes as well keeps the loops free of branches.
+      *****/
 
-      /* HOP_DROP_SPIN_CHECK
-    Propagate one photon until it dies as determined by ROULETTE.
-    *******/
-      do {
-        /**** HOP
+      /**** HOP
       Take step to new position
       s = dimensionless stepsize
-      x, uy, uz are cosines of current photon trajectory
       *****/
-        while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);   /* yields 0 < rnd <= 1 */
-        sleft = -log(rnd);        /* dimensionless step */
-        CNT += 1;
-
-        do {  // while sleft>0
-          s = sleft / inputValues->musVector[i];        /* Step size [cm].*/
-          tempx = x + s*ux;        /* Update positions. [cm] */
-          tempy = y + s*uy;
-          tempz = z + s*uz;
-
-          sv = returnValue->SameVoxel(x, y, z, tempx, tempy, tempz, inputValues->xSpacing, inputValues->ySpacing, inputValues->zSpacing);
-          if (sv) /* photon in same voxel */
-          {
-            x = tempx;  /* Update positions. */
-            y = tempy;
-            z = tempz;
-
-            /**** DROP
-          Drop photon weight (W) into local bin.
-          *****/
-
-            absorb = W*(1 - exp(-inputValues->muaVector[i] * s));  /* photon weight absorbed at this step */
-            W -= absorb;          /* decrement WEIGHT by amount absorbed */
-            // If photon within volume of heterogeneity, deposit energy in F[].
-            // Normalize F[] later, when save output.
-            if (bflag)
-            {
-              i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
-              returnValue->totalFluence[i] += absorb;
-              // only save data if blag==1, i.e., photon inside simulation cube
-
-              //For each detectorvoxel
-              if (returnValue->detectorVoxel != nullptr)
-              {
-                //Add photon position to the recorded photon route
-                returnValue->detectorVoxel->recordedPhotonRoute->push_back(initLocation(ix, iy, iz, absorb));
-
-                //If the photon is currently at the detector position
-                if ((returnValue->detectorVoxel->location.x == ix)
-                  && ((returnValue->detectorVoxel->location.y == iy)
-                    || (returnValue->detectorVoxel->location.y - 1 == iy))
-                  && (returnValue->detectorVoxel->location.z == iz))
-                {
-                  //For each voxel in the recorded photon route
-                  for (unsigned int routeIndex = 0; routeIndex < returnValue->detectorVoxel->recordedPhotonRoute->size(); routeIndex++)
-                  {
-                    //increment the fluence contribution at that particular position
-                    i = (long)(returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).z*inputValues->Ny*inputValues->Nx
-                      + returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).x*inputValues->Ny
-                      + returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).y);
-                    returnValue->detectorVoxel->fluenceContribution[i] += returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).absorb;
-                  }
-
-                  //Clear the recorded photon route
-                  returnValue->detectorVoxel->m_NumberPhotonsCurrent++;
-                  returnValue->detectorVoxel->recordedPhotonRoute->clear();
-                }
-              }
-            }
-
-            /* Update sleft */
-            sleft = 0;    /* dimensionless step remaining */
-          }
-          else /* photon has crossed voxel boundary */
-          {
-            /* step to voxel face + "littlest step" so just inside new voxel. */
-            s = ls + returnValue->FindVoxelFace2(x, y, z, tempx, tempy, tempz, inputValues->xSpacing, inputValues->ySpacing, inputValues->zSpacing, ux, uy, uz);
-
-            /**** DROP
-          Drop photon weight (W) into local bin.
-          *****/
-            absorb = W*(1 - exp(-inputValues->muaVector[i] * s));   /* photon weight absorbed at this step */
-            W -= absorb;                  /* decrement WEIGHT by amount absorbed */
-            // If photon within volume of heterogeneity, deposit energy in F[].
-            // Normalize F[] later, when save output.
-            if (bflag)
-            {
-              // only save data if bflag==1, i.e., photon inside simulation cube
-
-              //For each detectorvoxel
-              if (returnValue->detectorVoxel != nullptr)
-              {
-                //Add photon position to the recorded photon route
-                returnValue->detectorVoxel->recordedPhotonRoute->push_back(initLocation(ix, iy, iz, absorb));
-
-                //If the photon is currently at the detector position
-                if ((returnValue->detectorVoxel->location.x == ix)
-                  && ((returnValue->detectorVoxel->location.y == iy)
-                    || (returnValue->detectorVoxel->location.y - 1 == iy))
-                  && (returnValue->detectorVoxel->location.z == iz))
-                {
-                  //For each voxel in the recorded photon route
-                  for (unsigned int routeIndex = 0; routeIndex < returnValue->detectorVoxel->recordedPhotonRoute->size(); routeIndex++)
-                  {
-                    //increment the fluence contribution at that particular position
-                    i = (long)(returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).z*inputValues->Ny*inputValues->Nx
-                      + returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).x*inputValues->Ny
-                      + returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).y);
-                    returnValue->detectorVoxel->fluenceContribution[i] += returnValue->detectorVoxel->recordedPhotonRoute->at(routeIndex).absorb;
-                  }
-
-                  //Clear the recorded photon route
-                  returnValue->detectorVoxel->m_NumberPhotonsCurrent++;
-                  returnValue->detectorVoxel->recordedPhotonRoute->clear();
-                }
-              }
-
-              i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
-              returnValue->totalFluence[i] += absorb;
-            }
-
-            /* Update sleft */
-            sleft -= s*inputValues->musVector[i];  /* dimensionless step remaining */
-            if (sleft <= ls) sleft = 0;
-
-            /* Update positions. */
-            x += s*ux;
-            y += s*uy;
-            z += s*uz;
-
-            // pointers to voxel containing optical properties
-            ix = (int)(inputValues->Nx / 2 + x / inputValues->xSpacing);
-            iy = (int)(inputValues->Ny / 2 + y / inputValues->ySpacing);
-            iz = (int)(z / inputValues->zSpacing);
-
-            bflag = 1;  // Boundary flag. Initialize as 1 = inside volume, then check.
-            if (inputValues->boundaryflag == 0) { // Infinite medium.
-              // Check if photon has wandered outside volume.
-              // If so, set tissue type to boundary value, but let photon wander.
-              // Set blag to zero, so DROP does not deposit energy.
-              if (iz >= inputValues->Nz) { iz = inputValues->Nz - 1; bflag = 0; }
-              if (ix >= inputValues->Nx) { ix = inputValues->Nx - 1; bflag = 0; }
-              if (iy >= inputValues->Ny) { iy = inputValues->Ny - 1; bflag = 0; }
-              if (iz < 0) { iz = 0;    bflag = 0; }
-              if (ix < 0) { ix = 0;    bflag = 0; }
-              if (iy < 0) { iy = 0;    bflag = 0; }
-            }
-            else if (inputValues->boundaryflag == 1) { // Escape at boundaries
-              if (iz >= inputValues->Nz) { iz = inputValues->Nz - 1; photon_status = DEAD; sleft = 0; }
-              if (ix >= inputValues->Nx) { ix = inputValues->Nx - 1; photon_status = DEAD; sleft = 0; }
-              if (iy >= inputValues->Ny) { iy = inputValues->Ny - 1; photon_status = DEAD; sleft = 0; }
-              if (iz < 0) { iz = 0;    photon_status = DEAD; sleft = 0; }
-              if (ix < 0) { ix = 0;    photon_status = DEAD; sleft = 0; }
-              if (iy < 0) { iy = 0;    photon_status = DEAD; sleft = 0; }
-            }
-            else if (inputValues->boundaryflag == 2) { // Escape at top surface, no x,y bottom z boundaries
-              if (iz >= inputValues->Nz) { iz = inputValues->Nz - 1; bflag = 0; }
-              if (ix >= inputValues->Nx) { ix = inputValues->Nx - 1; bflag = 0; }
-              if (iy >= inputValues->Ny) { iy = inputValues->Ny - 1; bflag = 0; }
-              if (iz < 0) { iz = 0;    photon_status = DEAD; sleft = 0; }
-              if (ix < 0) { ix = 0;    bflag = 0; }
-              if (iy < 0) { iy = 0;    bflag = 0; }
-            }
-
-            // update pointer to tissue type
-            i = (long)(iz*inputValues->Ny*inputValues->Nx + ix*inputValues->Ny + iy);
-          } //(sv) /* same voxel */
-        } while (sleft > 0); //do...while
-
-        /**** SPIN
-       Scatter photon into new trajectory defined by theta and psi.
-       Theta is specified by cos(theta), which is determined
-       based on the Henyey-Greenstein scattering function.
-       Convert theta and psi into cosines ux, uy, uz.
-       *****/
-       /* Sample for costheta */
-        while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        if (inputValues->gVector[i] == 0.0)
-        {
-          costheta = 2.0 * rnd - 1.0;
-        }
-        else
-        {
-          double temp = (1.0 - inputValues->gVector[i] * inputValues->gVector[i])
-            / (1.0 - inputValues->gVector[i] + 2 * inputValues->gVector[i] * rnd);
-          costheta = (1.0 + inputValues->gVector[i] * inputValues->gVector[i] - temp*temp) / (2.0*inputValues->gVector[i]);
-        }
-        sintheta = sqrt(1.0 - costheta*costheta); /* sqrt() is faster than sin(). */
+      for (int lane = 0; lane < PACKET_SIZE; lane++)
+        packet.sleft[lane] = -log(packet.rng[lane].Next());  /* dimensionless step */
+
+      for (int lane = 0; lane < PACKET_SIZE; lane++)
+      {
+        if (packet.status[lane] == ALIVE)
+          hopAndDrop(inputValues, returnValue, packet, lane, fluence);
+      }
+
+      /**** SPIN
+      Scatter photon into new trajectory defined by theta and psi.
+      Theta is specified by cos(theta), which is determined
+      based on the Henyey-Greenstein scattering function.
+      Convert theta and psi into cosines ux, uy, uz.
+      *****/
+      for (int lane = 0; lane < PACKET_SIZE; lane++)
+      {
+        rndTheta[lane] = packet.rng[lane].Next();
+        rndPsi[lane] = packet.rng[lane].Next();
+      }
+
+      for (int lane = 0; lane < PACKET_SIZE; lane++)
+      {
+        /* Sample for costheta */
+        double g = inputValues->gVector[packet.i[lane]];
+        double temp = (1.0 - g * g) / (1.0 - g + 2 * g * rndTheta[lane]);
+        double costheta = 2.0 * rndTheta[lane] - 1.0;
+        if (g != 0.0)
+          costheta = (1.0 + g * g - temp*temp) / (2.0 * g);
+        double sintheta = sqrt(1.0 - costheta*costheta); /* sqrt() is faster than sin(). */
 
         /* Sample psi. */
-        psi = 2.0*PI*returnValue->RandomGen(1, 0, nullptr);
-        cospsi = cos(psi);
-        if (psi < PI)
-          sinpsi = sqrt(1.0 - cospsi*cospsi);     /* sqrt() is faster than sin(). */
-        else
-          sinpsi = -sqrt(1.0 - cospsi*cospsi);
+        double psi = 2.0*PI*rndPsi[lane];
+        double cospsi = cos(psi);
+        double sinpsi = sqrt(1.0 - cospsi*cospsi);     /* sqrt() is faster than sin(). */
+        if (psi >= PI)
+          sinpsi = -sinpsi;
 
         /* New trajectory. */
-        if (1 - fabs(uz) <= ONE_MINUS_COSZERO) {      /* close to perpendicular. */
-          uxx = sintheta * cospsi;
-          uyy = sintheta * sinpsi;
-          uzz = costheta * SIGN(uz);   /* SIGN() is faster than division. */
-        }
-        else {          /* usually use this option */
-          temp = sqrt(1.0 - uz * uz);
-          uxx = sintheta * (ux * uz * cospsi - uy * sinpsi) / temp + ux * costheta;
-          uyy = sintheta * (uy * uz * cospsi + ux * sinpsi) / temp + uy * costheta;
-          uzz = -sintheta * cospsi * temp + uz * costheta;
-        }
-
-        /* Update trajectory */
-        ux = uxx;
-        uy = uyy;
-        uz = uzz;
+        double ux = packet.ux[lane], uy = packet.uy[lane], uz = packet.uz[lane];
+        bool perpendicular = 1 - fabs(uz) <= ONE_MINUS_COSZERO;  /* close to perpendicular. */
+        temp = perpendicular ? 1.0 : sqrt(1.0 - uz * uz);
+        packet.ux[lane] = perpendicular ? sintheta * cospsi
+          : sintheta * (ux * uz * cospsi - uy * sinpsi) / temp + ux * costheta;
+        packet.uy[lane] = perpendicular ? sintheta * sinpsi
+          : sintheta * (uy * uz * cospsi + ux * sinpsi) / temp + uy * costheta;
+        packet.uz[lane] = perpendicular ? costheta * SIGN(uz)   /* SIGN() is faster than division. */
+          : -sintheta * cospsi * temp + uz * costheta;
+      }
 
-        /**** CHECK ROULETTE
+      /**** CHECK ROULETTE
       If photon weight below THRESHOLD, then terminate photon using Roulette technique.
       Photon has CHANCE probability of having its weight increased by factor of 1/CHANCE,
       and 1-CHANCE probability of terminating.
       *****/
-        if (W < THRESHOLD) {
-          if (returnValue->RandomGen(1, 0, nullptr) <= CHANCE)
-            W /= CHANCE;
-          else photon_status = DEAD;
+      for (int lane = 0; lane < PACKET_SIZE; lane++)
+      {
+        if (packet.status[lane] == ALIVE && packet.W[lane] < THRESHOLD) {
+          if (packet.rng[lane].Next() <= CHANCE)
+            packet.W[lane] /= CHANCE;
+          else packet.status[lane] = DEAD;
         }
-      } while (photon_status == ALIVE);  /* end STEP_CHECK_HOP_SPIN */
-      /* if ALIVE, continue propagating */
+      }
       /* If photon DEAD, then launch new photon. */
-    } while (photonIterator < photonsToSimulate);  /* end RUN */
+    }  /* end RUN */
 
     returnValue->Nphotons += photonsToSimulate;
-  } while (photonsToSimulate > 0);
+  }
 
   if (verbose) std::cout << "------------------------------------------------------" << std::endl;
   if (verbose) std::cout << "Thread " << thread << " is finished." << std::endl;
@@ -0,0 +1,106 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPAFLUENCEACCUMULATOR_H
+#define MITKPAFLUENCEACCUMULATOR_H
+
+#include <MitkPhotoacousticsLibExports.h>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+//Includes for smart pointer usage
+#include "mitkCommon.h"
+#include "itkLightObject.h"
+
+namespace mitk {
+  namespace pa {
+    /**
+     * @brief The FluenceAccumulator class sums the weight deposited by the photons of a Monte Carlo simulation
+     * that runs in several threads.
+     *
+     * Every thread deposits into its own ThreadFluence, which is allocated once per thread. The weights are stored
+     * as 64 bit fixed point numbers (FIXED_POINT_SCALE units per unit of photon weight). Integer addition is
+     * associative, so the sum computed by Finish() neither depends on the order of the deposits nor on the number of
+     * threads, as long as every photon deposits the same weights.
+     *
+     * A voxel can hold a deposited weight of up to 2^31 before the fixed point value overflows, i.e. the total weight
+     * of more than 10^9 photons.
+     */
+    class MITKPHOTOACOUSTICSLIB_EXPORT FluenceAccumulator : public itk::LightObject
+    {
+    public:
+
+      mitkClassMacroItkParent(FluenceAccumulator, itk::LightObject)
+        mitkNewMacro2Param(FluenceAccumulator, long, bool)
+
+      static constexpr double FIXED_POINT_SCALE = 4294967296.0; // 2^32
+
+      /**
+       * @brief The ThreadFluence class holds the weight deposited by one thread.
+       * It must only be used by the thread that requested it.
+       */
+      class MITKPHOTOACOUSTICSLIB_EXPORT ThreadFluence
+      {
+      public:
+        ThreadFluence(long numberOfVoxels, bool recordDetectorFluence);
+
+        void AddTotalFluence(long voxel, double weight) { m_TotalFluence[voxel] += ToFixedPoint(weight); }
+        void AddDetectorFluence(long voxel, double weight) { m_DetectorFluence[voxel] += ToFixedPoint(weight); }
+        void AddDetectorPhoton() { m_DetectorPhotons++; }
+
+      private:
+        friend class FluenceAccumulator;
+
+        static long long ToFixedPoint(double weight) { return static_cast<long long>(weight * FIXED_POINT_SCALE + 0.5); }
+
+        std::vector<long long> m_TotalFluence;
+        std::vector<long long> m_DetectorFluence;
+        long long m_DetectorPhotons;
+      };
+
+      /**
+       * @brief CreateThreadFluence returns a new, zero initialized fluence buffer for the calling thread.
+       * The buffer is owned by the accumulator and is valid until Finish() is called.
+       */
+      ThreadFluence* CreateThreadFluence();
+
+      /**
+       * @brief Finish sums the buffers of all threads, converts the sum to floating point and releases the buffers.
+       */
+      void Finish();
+
+      /** The summed fluence (valid after Finish()). */
+      double* GetTotalFluence() { return m_TotalFluence.data(); }
+      double* GetDetectorFluence() { return m_DetectorFluence.data(); }
+      long long GetNumberOfDetectorPhotons() const { return m_DetectorPhotons; }
+
+    protected:
+      FluenceAccumulator(long numberOfVoxels, bool recordDetectorFluence);
+      ~FluenceAccumulator() override;
+
+      long m_NumberOfVoxels;
+      bool m_RecordDetectorFluence;
+      long long m_DetectorPhotons;
+      std::vector<double> m_TotalFluence;
+      std::vector<double> m_DetectorFluence;
+      std::vector<std::unique_ptr<ThreadFluence>> m_ThreadFluences;
+      std::mutex m_Mutex;
+    };
+  }
+}
+
+#endif // MITKPAFLUENCEACCUMULATOR_H
@@ -40,13 +40,21 @@ namespace mitk {
         mitkNewMacro2Param(MonteCarloThreadHandler, long, bool)
         mitkNewMacro3Param(MonteCarloThreadHandler, long, bool, bool)
 
-        long GetNextWorkPackage();
+        /**
+         * @brief GetNextWorkPackage returns the number of photons (or the package size on time basis) to simulate next
+         * @param workPackageIndex if not nullptr, receives the index of the returned package. Packages are numbered
+         * consecutively from 0 in the order they are handed out, independent of the thread asking for them, so the index
+         * together with the position of a photon inside its package identifies the photon in a reproducible way.
+         * @return the size of the package, or 0 if there is no more work.
+         */
+        long GetNextWorkPackage(long* workPackageIndex = nullptr);
 
       void SetPackageSize(long sizeInMilliseconsOrNumberOfPhotons);
 
       itkGetMacro(NumberPhotonsToSimulate, long);
       itkGetMacro(NumberPhotonsRemaining, long);
       itkGetMacro(WorkPackageSize, long);
+      itkGetMacro(NumberOfWorkPackages, long);
       itkGetMacro(SimulationTime, long);
       itkGetMacro(SimulateOnTimeBasis, bool);
       itkGetMacro(Verbose, bool);
@@ -55,6 +63,7 @@ namespace mitk {
       long m_NumberPhotonsToSimulate;
       long m_NumberPhotonsRemaining;
       long m_WorkPackageSize;
+      long m_NumberOfWorkPackages;
       long m_SimulationTime;
       long m_Time;
       bool m_SimulateOnTimeBasis;
@@ -0,0 +1,69 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPAFluenceAccumulator.h"
+
+constexpr double mitk::pa::FluenceAccumulator::FIXED_POINT_SCALE;
+
+mitk::pa::FluenceAccumulator::ThreadFluence::ThreadFluence(long numberOfVoxels, bool recordDetectorFluence) :
+  m_TotalFluence(numberOfVoxels, 0),
+  m_DetectorFluence(recordDetectorFluence ? numberOfVoxels : 0, 0),
+  m_DetectorPhotons(0)
+{
+}
+
+mitk::pa::FluenceAccumulator::FluenceAccumulator(long numberOfVoxels, bool recordDetectorFluence) :
+  m_NumberOfVoxels(numberOfVoxels),
+  m_RecordDetectorFluence(recordDetectorFluence),
+  m_DetectorPhotons(0)
+{
+}
+
+mitk::pa::FluenceAccumulator::~FluenceAccumulator()
+{
+}
+
+mitk::pa::FluenceAccumulator::ThreadFluence* mitk::pa::FluenceAccumulator::CreateThreadFluence()
+{
+  std::unique_ptr<ThreadFluence> fluence(new ThreadFluence(m_NumberOfVoxels, m_RecordDetectorFluence));
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_ThreadFluences.push_back(std::move(fluence));
+  return m_ThreadFluences.back().get();
+}
+
+void mitk::pa::FluenceAccumulator::Finish()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  std::vector<long long> totalFluence(m_NumberOfVoxels, 0);
+  std::vector<long long> detectorFluence(m_RecordDetectorFluence ? m_NumberOfVoxels : 0, 0);
+  for (const std::unique_ptr<ThreadFluence>& fluence : m_ThreadFluences)
+  {
+    for (long voxel = 0; voxel < m_NumberOfVoxels; voxel++)
+      totalFluence[voxel] += fluence->m_TotalFluence[voxel];
+    for (size_t voxel = 0; voxel < detectorFluence.size(); voxel++)
+      detectorFluence[voxel] += fluence->m_DetectorFluence[voxel];
+    m_DetectorPhotons += fluence->m_DetectorPhotons;
+  }
+  m_ThreadFluences.clear();
+
+  m_TotalFluence.resize(totalFluence.size());
+  for (size_t voxel = 0; voxel < totalFluence.size(); voxel++)
+    m_TotalFluence[voxel] = totalFluence[voxel] / FIXED_POINT_SCALE;
+  m_DetectorFluence.resize(detectorFluence.size());
+  for (size_t voxel = 0; voxel < detectorFluence.size(); voxel++)
+    m_DetectorFluence[voxel] = detectorFluence[voxel] / FIXED_POINT_SCALE;
+}
@@ -25,6 +25,7 @@ mitk::pa::MonteCarloThreadHandler::MonteCarloThreadHandler(long timInMillisecond
   m_Verbose = verbose;
   m_SimulateOnTimeBasis = simulateOnTimeBasis;
   m_WorkPackageSize = 10000L;
+  m_NumberOfWorkPackages = 0;
   m_SimulationTime = 0;
   m_Time = 0;
   m_NumberPhotonsToSimulate = 0;
@@ -46,15 +47,19 @@ mitk::pa::MonteCarloThreadHandler::~MonteCarloThreadHandler()
 {
 }
 
-long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage()
+long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage(long* workPackageIndex)
 {
   long workPackageSize = 0;
+  long index = -1;
   if (m_SimulateOnTimeBasis)
   {
     long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     if (now - m_Time <= m_SimulationTime)
     {
       workPackageSize = m_WorkPackageSize;
+      m_MutexRemainingPhotonsManipulation.lock();
+      index = m_NumberOfWorkPackages++;
+      m_MutexRemainingPhotonsManipulation.unlock();
       if (m_Verbose)
       {
         std::cout << "<filter-progress-text progress='" << ((double)(now - m_Time) / m_SimulationTime) << "'></filter-progress-text>" << std::endl;
@@ -75,6 +80,8 @@ long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage()
     }
 
     m_NumberPhotonsRemaining -= workPackageSize;
+    if (workPackageSize > 0)
+      index = m_NumberOfWorkPackages++;
     m_MutexRemainingPhotonsManipulation.unlock();
 
     if (m_Verbose)
@@ -83,6 +90,9 @@ long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage()
     }
   }
 
+  if (workPackageIndex != nullptr)
+    *workPackageIndex = index;
+
   return workPackageSize;
 }
 
@@ -36,6 +36,7 @@ class mitkMCThreadHandlerTestSuite : public mitk::TestFixture
   MITK_TEST(testCorrectNumberOfPhotons);
   MITK_TEST(testCorrectNumberOfPhotonsWithUnevenPackageSize);
   MITK_TEST(testCorrectNumberOfPhotonsWithTooLargePackageSize);
+  MITK_TEST(testWorkPackagesAreNumberedConsecutively);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -96,6 +97,21 @@ public:
     CPPUNIT_ASSERT(numberOfPhotonsSimulated == m_NumberOrTime);
   }
 
+  void testWorkPackagesAreNumberedConsecutively()
+  {
+    m_MonteCarloThreadHandler = mitk::pa::MonteCarloThreadHandler::New(m_NumberOrTime, false, false);
+    m_MonteCarloThreadHandler->SetPackageSize(77);
+    long expectedIndex = 0;
+    long workPackageIndex = -1;
+    while (m_MonteCarloThreadHandler->GetNextWorkPackage(&workPackageIndex) > 0)
+    {
+      CPPUNIT_ASSERT_EQUAL(expectedIndex, workPackageIndex);
+      expectedIndex++;
+    }
+    CPPUNIT_ASSERT_EQUAL(-1L, workPackageIndex);
+    CPPUNIT_ASSERT_EQUAL(7L, m_MonteCarloThreadHandler->GetNumberOfWorkPackages());
+  }
+
   void tearDown() override
   {
     m_MonteCarloThreadHandler = nullptr;
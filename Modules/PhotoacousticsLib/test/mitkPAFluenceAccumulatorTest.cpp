@@ -0,0 +1,165 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkPAFluenceAccumulator.h>
+#include <mitkPAMonteCarloThreadHandler.h>
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+class mitkPAFluenceAccumulatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPAFluenceAccumulatorTestSuite);
+  MITK_TEST(testFluenceIsIndependentOfNumberOfThreads);
+  MITK_TEST(testDetectorFluenceIsIndependentOfNumberOfThreads);
+  MITK_TEST(testFluenceEqualsFloatingPointSum);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  static const long NUMBER_OF_VOXELS = 1000;
+  static const long NUMBER_OF_PHOTONS = 20000;
+
+  /** Hash of the photon index and the step, like the counter based random numbers of MCxyz. */
+  static unsigned long long Mix(unsigned long long z)
+  {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  /** Every photon drops a deterministic sequence of weights into pseudo random voxels, as the photons of MCxyz do.
+   * Calls deposit(voxel, weight, photonReachedDetector) for each drop. */
+  template <typename DepositFunction>
+  static void SimulatePhoton(long workPackage, long photon, DepositFunction deposit)
+  {
+    unsigned long long key = Mix(Mix((unsigned long long)workPackage) + (unsigned long long)photon);
+    double weight = 1.0;
+    for (unsigned long long step = 1; weight > 0.01; step++)
+    {
+      unsigned long long bits = Mix(key ^ Mix(step));
+      long voxel = (long)(bits % NUMBER_OF_VOXELS);
+      double absorb = weight * ((bits >> 40) + 1) / 16777216.0 * 0.3; /* up to 30% of the weight */
+      weight -= absorb;
+      deposit(voxel, absorb, (bits & 0xFF) == 0);
+    }
+  }
+
+  /** Simulates all photons with the given number of threads, which fetch their work from a thread handler. */
+  mitk::pa::FluenceAccumulator::Pointer Simulate(int numberOfThreads, bool recordDetectorFluence)
+  {
+    auto threadHandler = mitk::pa::MonteCarloThreadHandler::New(NUMBER_OF_PHOTONS, false, false);
+    threadHandler->SetPackageSize(97);
+    auto accumulator = mitk::pa::FluenceAccumulator::New(NUMBER_OF_VOXELS, recordDetectorFluence);
+
+    auto worker = [&]()
+    {
+      mitk::pa::FluenceAccumulator::ThreadFluence* fluence = accumulator->CreateThreadFluence();
+      long workPackage = 0;
+      long photonsToSimulate = 0;
+      while ((photonsToSimulate = threadHandler->GetNextWorkPackage(&workPackage)) > 0)
+      {
+        for (long photon = 0; photon < photonsToSimulate; photon++)
+        {
+          SimulatePhoton(workPackage, photon, [&](long voxel, double absorb, bool atDetector)
+          {
+            fluence->AddTotalFluence(voxel, absorb);
+            if (recordDetectorFluence && atDetector)
+            {
+              fluence->AddDetectorFluence(voxel, absorb);
+              fluence->AddDetectorPhoton();
+            }
+          });
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numberOfThreads; t++)
+      threads.emplace_back(worker);
+    for (std::thread& thread : threads)
+      thread.join();
+
+    accumulator->Finish();
+    return accumulator;
+  }
+
+  static void AssertEqualFluence(double* expected, double* actual, const std::string& message)
+  {
+    long numberOfDifferentVoxels = 0;
+    for (long voxel = 0; voxel < NUMBER_OF_VOXELS; voxel++)
+      if (expected[voxel] != actual[voxel])
+        numberOfDifferentVoxels++;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(message, 0L, numberOfDifferentVoxels);
+  }
+
+public:
+
+  void setUp() override
+  {
+  }
+
+  void testFluenceIsIndependentOfNumberOfThreads()
+  {
+    auto singleThreaded = Simulate(1, false);
+    for (int numberOfThreads : { 2, 3, 8 })
+    {
+      auto multiThreaded = Simulate(numberOfThreads, false);
+      AssertEqualFluence(singleThreaded->GetTotalFluence(), multiThreaded->GetTotalFluence(),
+        "Fluence of " + std::to_string(numberOfThreads) + " threads differs from the fluence of 1 thread");
+    }
+  }
+
+  void testDetectorFluenceIsIndependentOfNumberOfThreads()
+  {
+    auto singleThreaded = Simulate(1, true);
+    CPPUNIT_ASSERT_MESSAGE("Some photons reach the detector", singleThreaded->GetNumberOfDetectorPhotons() > 0);
+    for (int numberOfThreads : { 2, 5 })
+    {
+      auto multiThreaded = Simulate(numberOfThreads, true);
+      CPPUNIT_ASSERT_EQUAL(singleThreaded->GetNumberOfDetectorPhotons(), multiThreaded->GetNumberOfDetectorPhotons());
+      AssertEqualFluence(singleThreaded->GetTotalFluence(), multiThreaded->GetTotalFluence(), "Total fluence differs");
+      AssertEqualFluence(singleThreaded->GetDetectorFluence(), multiThreaded->GetDetectorFluence(), "Detector fluence differs");
+    }
+  }
+
+  void testFluenceEqualsFloatingPointSum()
+  {
+    std::vector<double> expected(NUMBER_OF_VOXELS, 0.0);
+    long numberOfDeposits = 0;
+    for (long photon = 0; photon < NUMBER_OF_PHOTONS; photon++)
+    {
+      SimulatePhoton(photon / 97, photon % 97, [&](long voxel, double absorb, bool)
+      {
+        expected[voxel] += absorb;
+        numberOfDeposits++;
+      });
+    }
+
+    auto accumulator = Simulate(4, false);
+    // every deposit is rounded to a multiple of 1/FIXED_POINT_SCALE
+    double tolerance = numberOfDeposits / mitk::pa::FluenceAccumulator::FIXED_POINT_SCALE;
+    for (long voxel = 0; voxel < NUMBER_OF_VOXELS; voxel++)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[voxel], accumulator->GetTotalFluence()[voxel], tolerance);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPAFluenceAccumulator)
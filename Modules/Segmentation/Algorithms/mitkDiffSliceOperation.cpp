@@ -35,7 +35,8 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
                                              Image *slice,
                                              SlicedGeometry3D *sliceGeometry,
                                              unsigned int timestep,
-                                             BaseGeometry *currentWorldGeometry)
+                                             BaseGeometry *currentWorldGeometry,
+                                             DiffSliceOperation *referenceOperation)
   : Operation(1)
 
 {
@@ -53,7 +54,7 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
   m_TimeStep = timestep;
 
   m_zlibSliceContainer = CompressedImageContainer::New();
-  m_zlibSliceContainer->SetImage(slice);
+  m_zlibSliceContainer->SetImage(slice, referenceOperation ? referenceOperation->m_zlibSliceContainer.GetPointer() : nullptr);
 
   m_Image = imageVolume;
   m_DeleteObserverTag = 0;
@@ -97,6 +98,16 @@ bool mitk::DiffSliceOperation::IsValid()
   return m_ImageIsValid && m_zlibSliceContainer.IsNotNull() && (m_WorldGeometry.IsNotNull()); // TODO improve
 }
 
+std::size_t mitk::DiffSliceOperation::GetMemorySize() const
+{
+  return m_zlibSliceContainer.IsNotNull() ? m_zlibSliceContainer->GetCompressedSize() : 0;
+}
+
+bool mitk::DiffSliceOperation::SwapOut(const std::string &directory)
+{
+  return m_zlibSliceContainer.IsNotNull() && m_zlibSliceContainer->SwapOut(directory);
+}
+
 void mitk::DiffSliceOperation::OnImageDeleted()
 {
   // if our imageVolume is removed e.g. from the datastorage the operation is no lnger valid
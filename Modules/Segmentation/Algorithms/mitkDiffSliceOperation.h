@@ -54,16 +54,27 @@ namespace mitk
     */
     DiffSliceOperation();
 
-    /** \brief */
+    /** \brief Creates an operation holding a compressed copy of slice.
+
+      If a referenceOperation holding a slice of the same size is given (usually the undo operation holding the
+      slice before the edit), only the difference to its slice is stored. The reference is kept alive by this operation.
+    */
     DiffSliceOperation(mitk::Image *imageVolume,
                        mitk::Image *slice,
                        SlicedGeometry3D *sliceGeometry,
                        unsigned int timestep,
-                       BaseGeometry *currentWorldGeometry);
+                       BaseGeometry *currentWorldGeometry,
+                       DiffSliceOperation *referenceOperation = nullptr);
 
     /** \brief Check if it is a valid operation.*/
     bool IsValid();
 
+    /** \brief Size of the compressed slice held in memory.*/
+    std::size_t GetMemorySize() const override;
+
+    /** \brief Moves the compressed slice to a temporary file.*/
+    bool SwapOut(const std::string &directory) override;
+
     /** \brief Set the image volume.*/
     void SetImage(mitk::Image *image) { this->m_Image = image; }
     /** \brief Get th image volume.*/
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkRenderingManager.h"
 #include "mitkSegTool2D.h"
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageRegionModificationEvent.h>
 #include <mitkVtkImageOverwrite.h>
 
 // VTK
@@ -63,12 +64,19 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
     extractor->SetVtkOutputRequest(true);
     extractor->SetResliceTransformByGeometry(imageOperation->GetImage()->GetGeometry(imageOperation->GetTimeStep()));
 
+    // observers (e.g. statistics) may restrict their update to the overwritten part of the image
+    const itk::ImageRegion<3> affectedRegion = SegTool2D::GetAffectedImageRegion(
+      imageOperation->GetImage(), imageOperation->GetWorldGeometry(), imageOperation->GetTimeStep());
+    imageOperation->GetImage()->InvokeEvent(
+      ImageRegionAboutToBeModifiedEvent(affectedRegion, imageOperation->GetTimeStep()));
+
     extractor->Modified();
     extractor->Update();
 
     // make sure the modification is rendered
     RenderingManager::GetInstance()->RequestUpdateAll();
     imageOperation->GetImage()->Modified();
+    imageOperation->GetImage()->InvokeEvent(ImageRegionModifiedEvent(affectedRegion, imageOperation->GetTimeStep()));
 
     mitk::ExtractSliceFilter::Pointer extractor2 = mitk::ExtractSliceFilter::New();
     extractor2->SetInput(imageOperation->GetImage());
@@ -261,6 +261,14 @@ bool mitk::ImageLiveWireContourModelFilter::CreateDynamicCostMap(mitk::ContourMo
   return true;
 }
 
+void mitk::ImageLiveWireContourModelFilter::ClearDynamicCostMap()
+{
+  std::map<int, int> emptyCostMap;
+  m_CostFunction->SetDynamicCostMap(emptyCostMap);
+  m_CostFunction->SetUseCostMap(false);
+  m_UseDynamicCostMap = false;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::ImageLiveWireContourModelFilter::CreateDynamicCostMapByITK(
   const itk::Image<TPixel, VImageDimension> *inputImage, mitk::ContourModel *path)
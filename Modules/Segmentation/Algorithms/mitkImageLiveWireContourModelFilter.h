@@ -117,6 +117,9 @@ namespace mitk
     /** \brief Create dynamic cost tranfer map - on the fly training*/
     bool CreateDynamicCostMap(mitk::ContourModel *path = nullptr);
 
+    /** \brief Discard the dynamic cost tranfer map of previous contours and stop using it*/
+    void ClearDynamicCostMap();
+
   protected:
     ImageLiveWireContourModelFilter();
 
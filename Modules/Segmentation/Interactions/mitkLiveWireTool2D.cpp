@@ -30,7 +30,12 @@ namespace mitk
 }
 
 mitk::LiveWireTool2D::LiveWireTool2D()
-  : SegTool2D("LiveWireTool"), m_CreateAndUseDynamicCosts(false)
+  : SegTool2D("LiveWireTool"),
+    m_WorkingSliceReferenceImage(nullptr),
+    m_WorkingSliceReferenceImageMTime(0),
+    m_WorkingSliceTimeStep(0),
+    m_WorkingSliceComponent(0),
+    m_CreateAndUseDynamicCosts(false)
 {
 }
 
@@ -200,6 +205,50 @@ bool mitk::LiveWireTool2D::IsPositionEventInsideImageRegion(mitk::InteractionPos
   return isPositionEventInsideImageRegion;
 }
 
+void mitk::LiveWireTool2D::UpdateWorkingSlice(const InteractionPositionEvent *positionEvent)
+{
+  auto referenceNode = m_ToolManager->GetReferenceData(0);
+  const Image *referenceImage = nullptr != referenceNode ? dynamic_cast<Image *>(referenceNode->GetData()) : nullptr;
+
+  int displayedComponent = 0;
+  unsigned int timeStep = 0;
+  if (nullptr != referenceImage)
+  {
+    referenceNode->GetIntProperty("Image.Displayed Component", displayedComponent);
+    timeStep = positionEvent->GetSender()->GetTimeStep(referenceImage);
+  }
+
+  auto planeGeometry = positionEvent->GetSender()->GetCurrentWorldPlaneGeometry();
+
+  if (m_WorkingSlice.IsNotNull() && m_LiveWireFilter.IsNotNull() && nullptr != referenceImage &&
+      referenceImage == m_WorkingSliceReferenceImage &&
+      referenceImage->GetMTime() == m_WorkingSliceReferenceImageMTime && timeStep == m_WorkingSliceTimeStep &&
+      displayedComponent == m_WorkingSliceComponent && m_WorkingSlicePlaneGeometry.IsNotNull() &&
+      mitk::Equal(*planeGeometry, *m_WorkingSlicePlaneGeometry, mitk::eps, false))
+  {
+    // Keep the costs of the slice, but forget the training of the previous contour
+    m_LiveWireFilter->ClearRepulsivePoints();
+    m_LiveWireFilter->ClearDynamicCostMap();
+    return;
+  }
+
+  m_WorkingSlice = this->GetAffectedReferenceSlice(positionEvent);
+
+  auto origin = m_WorkingSlice->GetSlicedGeometry()->GetOrigin();
+  m_WorkingSlice->GetSlicedGeometry()->WorldToIndex(origin, origin);
+  m_WorkingSlice->GetSlicedGeometry()->IndexToWorld(origin, origin);
+  m_WorkingSlice->GetSlicedGeometry()->SetOrigin(origin);
+
+  m_LiveWireFilter = ImageLiveWireContourModelFilter::New();
+  m_LiveWireFilter->SetInput(m_WorkingSlice);
+
+  m_WorkingSliceReferenceImage = referenceImage;
+  m_WorkingSliceReferenceImageMTime = nullptr != referenceImage ? referenceImage->GetMTime() : 0;
+  m_WorkingSliceTimeStep = timeStep;
+  m_WorkingSliceComponent = displayedComponent;
+  m_WorkingSlicePlaneGeometry = planeGeometry->Clone();
+}
+
 void mitk::LiveWireTool2D::OnInitLiveWire(StateMachineAction *, InteractionEvent *interactionEvent)
 {
   auto positionEvent = dynamic_cast<mitk::InteractionPositionEvent *>(interactionEvent);
@@ -261,15 +310,7 @@ void mitk::LiveWireTool2D::OnInitLiveWire(StateMachineAction *, InteractionEvent
   dataStorage->Add(m_EditingContourNode, workingDataNode);
 
   // Set current slice as input for ImageToLiveWireContourFilter
-  m_WorkingSlice = this->GetAffectedReferenceSlice(positionEvent);
-
-  auto origin = m_WorkingSlice->GetSlicedGeometry()->GetOrigin();
-  m_WorkingSlice->GetSlicedGeometry()->WorldToIndex(origin, origin);
-  m_WorkingSlice->GetSlicedGeometry()->IndexToWorld(origin, origin);
-  m_WorkingSlice->GetSlicedGeometry()->SetOrigin(origin);
-
-  m_LiveWireFilter = ImageLiveWireContourModelFilter::New();
-  m_LiveWireFilter->SetInput(m_WorkingSlice);
+  this->UpdateWorkingSlice(positionEvent);
 
   // Map click to pixel coordinates
   auto click = positionEvent->GetPositionInWorld();
@@ -91,6 +91,10 @@ namespace mitk
 
     bool IsPositionEventInsideImageRegion(InteractionPositionEvent *positionEvent, BaseData *data);
 
+    /// \brief Extract the slice of the event and create the LiveWire filter for it. The costs of the LiveWire are
+    /// computed per slice, so slice and filter of the previous contour are reused on the same, unchanged slice.
+    void UpdateWorkingSlice(const InteractionPositionEvent *positionEvent);
+
     void ReleaseInteractors();
 
     void ReleaseHelperObjects();
@@ -114,6 +118,13 @@ namespace mitk
 
     mitk::Image::Pointer m_WorkingSlice;
 
+    // Origin of m_WorkingSlice, which has to match to reuse it for the next contour
+    const mitk::Image *m_WorkingSliceReferenceImage;
+    unsigned long m_WorkingSliceReferenceImageMTime;
+    unsigned int m_WorkingSliceTimeStep;
+    int m_WorkingSliceComponent;
+    PlaneGeometry::Pointer m_WorkingSlicePlaneGeometry;
+
     mitk::ImageLiveWireContourModelFilter::Pointer m_LiveWireFilter;
 
     bool m_CreateAndUseDynamicCosts;
@@ -41,6 +41,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // includes for resling and overwriting
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageRegionModificationEvent.h>
 #include <mitkVtkImageOverwrite.h>
 #include <vtkImageData.h>
 #include <vtkSmartPointer.h>
@@ -81,6 +82,48 @@ bool mitk::SegTool2D::FilterEvents(InteractionEvent *interactionEvent, DataNode
   return isValidEvent;
 }
 
+itk::ImageRegion<3> mitk::SegTool2D::GetAffectedImageRegion(const Image *image,
+                                                            const BaseGeometry *sliceGeometry,
+                                                            TimeStepType timeStep)
+{
+  itk::ImageRegion<3> largestRegion;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    largestRegion.SetSize(i, image->GetDimension() > i ? image->GetDimension(i) : 1);
+  }
+
+  // bounding box of the slice corners in continuous index coordinates (voxel centers are at integer positions)
+  Point3D minIndex, maxIndex;
+  minIndex.Fill(std::numeric_limits<ScalarType>::max());
+  maxIndex.Fill(std::numeric_limits<ScalarType>::lowest());
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    Point3D index;
+    image->GetGeometry(timeStep)->WorldToIndex(sliceGeometry->GetCornerPoint(corner), index);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      minIndex[i] = std::min(minIndex[i], index[i]);
+      maxIndex[i] = std::max(maxIndex[i], index[i]);
+    }
+  }
+
+  // one voxel of margin for the interpolation of the reslicer
+  itk::ImageRegion<3> region;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const auto first = static_cast<itk::IndexValueType>(std::floor(minIndex[i])) - 1;
+    const auto last = static_cast<itk::IndexValueType>(std::ceil(maxIndex[i])) + 1;
+    region.SetIndex(i, first);
+    region.SetSize(i, static_cast<itk::SizeValueType>(last - first + 1));
+  }
+
+  if (!region.Crop(largestRegion))
+  {
+    return itk::ImageRegion<3>();
+  }
+  return region;
+}
+
 bool mitk::SegTool2D::DetermineAffectedImageSlice(const Image *image,
                                                   const PlaneGeometry *plane,
                                                   int &affectedDimension,
@@ -401,6 +444,10 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   extractor->SetVtkOutputRequest(false);
   extractor->SetResliceTransformByGeometry(image->GetGeometry(sliceInfo.timestep));
 
+  // observers (e.g. statistics) may restrict their update to the overwritten part of the image
+  const itk::ImageRegion<3> affectedRegion = GetAffectedImageRegion(image, sliceInfo.plane, sliceInfo.timestep);
+  image->InvokeEvent(ImageRegionAboutToBeModifiedEvent(affectedRegion, sliceInfo.timestep));
+
   extractor->Modified();
   extractor->Update();
 
@@ -408,14 +455,17 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   image->Modified();
   image->GetVtkImageData()->Modified();
 
+  image->InvokeEvent(ImageRegionModifiedEvent(affectedRegion, sliceInfo.timestep));
+
   /*============= BEGIN undo/redo feature block ========================*/
-  // specify the undo operation with the edited slice
+  // specify the undo operation with the edited slice, only its difference to the original slice is stored
   auto *doOperation =
     new DiffSliceOperation(image,
                            extractor->GetOutput(),
                            dynamic_cast<SlicedGeometry3D *>(sliceInfo.slice->GetGeometry()),
                            sliceInfo.timestep,
-                           sliceInfo.plane);
+                           sliceInfo.plane,
+                           undoOperation);
 
   // create an operation event for the undo stack
   OperationEvent *undoStackItem =
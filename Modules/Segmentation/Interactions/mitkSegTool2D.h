@@ -73,6 +73,14 @@ namespace mitk
                                             int &affectedDimension,
                                             int &affectedSlice);
 
+    /**
+      \brief Calculates the region of the image (in index coordinates of a 3D volume) that is touched when a slice
+      with the given geometry is written into the image. Oblique slices give their bounding box.
+    */
+    static itk::ImageRegion<3> GetAffectedImageRegion(const Image *image,
+                                                      const BaseGeometry *sliceGeometry,
+                                                      TimeStepType timeStep);
+
     /**
      * @brief Updates the surface interpolation by extracting the contour form the given slice.
      * @param slice the slice from which the contour should be extracted
@@ -0,0 +1,169 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkImageCast.h>
+#include <mitkImageLiveWireContourModelFilter.h>
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <cmath>
+
+namespace
+{
+  /** Gives access to the cost function of the filter. */
+  class LiveWireFilter : public mitk::ImageLiveWireContourModelFilter
+  {
+  public:
+    mitkClassMacro(LiveWireFilter, mitk::ImageLiveWireContourModelFilter);
+    itkFactorylessNewMacro(Self);
+
+    CostFunctionType *GetCostFunction() { return this->m_CostFunction; }
+  };
+}
+
+class mitkImageLiveWireContourModelFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageLiveWireContourModelFilterTestSuite);
+  MITK_TEST(TestClearDynamicCostMapRestoresCosts);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ImageLiveWireContourModelFilter::InternalImageType ItkImageType;
+
+  mitk::Image::Pointer m_Image;
+
+  static mitk::Point3D MakePoint(mitk::ScalarType x, mitk::ScalarType y)
+  {
+    mitk::Point3D point;
+    point[0] = x;
+    point[1] = y;
+    point[2] = 0.0;
+    return point;
+  }
+
+  static LiveWireFilter::Pointer CreateFilter(const mitk::Image *image)
+  {
+    LiveWireFilter::Pointer filter = LiveWireFilter::New();
+    filter->SetInput(image);
+    filter->SetStartPoint(MakePoint(8, 20));
+    return filter;
+  }
+
+  static void UpdateLiveWire(LiveWireFilter *filter, const mitk::Point3D &endPoint)
+  {
+    filter->SetEndPoint(endPoint);
+    filter->Update();
+  }
+
+  /** Number of links between 8-neighbours whose costs differ between the two cost functions. */
+  static unsigned int CountDifferentCosts(LiveWireFilter::CostFunctionType *costFunction,
+                                          LiveWireFilter::CostFunctionType *expectedCostFunction,
+                                          const ItkImageType::RegionType &region)
+  {
+    unsigned int numberOfDifferentCosts = 0;
+    itk::ImageRegionConstIteratorWithIndex<ItkImageType> it(expectedCostFunction->GetGradientMagnitudeImage(), region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const ItkImageType::IndexType p = it.GetIndex();
+      for (itk::IndexValueType dy = -1; dy <= 1; ++dy)
+      {
+        for (itk::IndexValueType dx = -1; dx <= 1; ++dx)
+        {
+          ItkImageType::IndexType q = p;
+          q[0] += dx;
+          q[1] += dy;
+          if (p == q || !region.IsInside(q))
+            continue;
+
+          const double expected = expectedCostFunction->GetCost(p, q);
+          const double actual = costFunction->GetCost(p, q);
+          if (expected != actual && !(std::isnan(expected) && std::isnan(actual)))
+            ++numberOfDifferentCosts;
+        }
+      }
+    }
+    return numberOfDifferentCosts;
+  }
+
+public:
+  void setUp() override
+  {
+    ItkImageType::SizeType size;
+    size.Fill(48);
+    ItkImageType::Pointer itkImage = ItkImageType::New();
+    itkImage->SetRegions(ItkImageType::RegionType(size));
+    itkImage->Allocate();
+
+    // a bright disc on a textured background, so the trained costs differ from the default costs
+    itk::ImageRegionIteratorWithIndex<ItkImageType> it(itkImage, itkImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const double x = it.GetIndex()[0];
+      const double y = it.GetIndex()[1];
+      const bool disc = (x - 24) * (x - 24) + (y - 24) * (y - 24) < 225;
+      it.Set(static_cast<float>((disc ? 160.0 : 40.0) + 8.0 * std::sin(0.9 * x) * std::cos(0.6 * y)));
+    }
+
+    mitk::CastToMitkImage(itkImage, m_Image);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void TestClearDynamicCostMapRestoresCosts()
+  {
+    const mitk::Point3D endPoint = MakePoint(40, 24);
+
+    LiveWireFilter::Pointer newFilter = CreateFilter(m_Image);
+    UpdateLiveWire(newFilter, endPoint);
+    const ItkImageType::RegionType region =
+      newFilter->GetCostFunction()->GetGradientMagnitudeImage()->GetLargestPossibleRegion();
+
+    // train the costs on a first segment and use them for the next ones, as the live wire tool does
+    LiveWireFilter::Pointer trainedFilter = CreateFilter(m_Image);
+    UpdateLiveWire(trainedFilter, MakePoint(24, 9));
+    CPPUNIT_ASSERT(trainedFilter->CreateDynamicCostMap(trainedFilter->GetOutput()));
+    trainedFilter->SetUseDynamicCostMap(true);
+    UpdateLiveWire(trainedFilter, MakePoint(30, 38));
+    CPPUNIT_ASSERT_MESSAGE(
+      "The trained costs differ from the default costs",
+      CountDifferentCosts(trainedFilter->GetCostFunction(), newFilter->GetCostFunction(), region) > 0);
+
+    trainedFilter->ClearDynamicCostMap();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "After clearing the map, the costs equal those of a new filter",
+      0u,
+      CountDifferentCosts(trainedFilter->GetCostFunction(), newFilter->GetCostFunction(), region));
+
+    UpdateLiveWire(trainedFilter, endPoint);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "After the next update, the costs equal those of a new filter",
+      0u,
+      CountDifferentCosts(trainedFilter->GetCostFunction(), newFilter->GetCostFunction(), region));
+
+    mitk::ContourModel *expectedContour = newFilter->GetOutput();
+    mitk::ContourModel *contour = trainedFilter->GetOutput();
+    CPPUNIT_ASSERT_MESSAGE("A contour is found", expectedContour->GetNumberOfVertices() > 1);
+    CPPUNIT_ASSERT_EQUAL(expectedContour->GetNumberOfVertices(), contour->GetNumberOfVertices());
+    for (int i = 0; i < expectedContour->GetNumberOfVertices(); ++i)
+      CPPUNIT_ASSERT_EQUAL(expectedContour->GetVertexAt(i)->Coordinates, contour->GetVertexAt(i)->Coordinates);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageLiveWireContourModelFilter)
@@ -192,9 +192,11 @@ void QmitkLabelSetWidget::OnTableViewContextMenuRequested(const QPoint & /*pos*/
 
     QAction *tmp1 = createSurfaceAction->menu()->addAction(QString("Detailed"));
     QAction *tmp2 = createSurfaceAction->menu()->addAction(QString("Smoothed"));
+    QAction *tmp3 = createSurfaceAction->menu()->addAction(QString("All labels"));
 
     QObject::connect(tmp1, SIGNAL(triggered(bool)), this, SLOT(OnCreateDetailedSurface(bool)));
     QObject::connect(tmp2, SIGNAL(triggered(bool)), this, SLOT(OnCreateSmoothedSurface(bool)));
+    QObject::connect(tmp3, SIGNAL(triggered(bool)), this, SLOT(OnCreateSurfacesOfAllLabels(bool)));
 
     menu->addAction(createSurfaceAction);
 
@@ -1146,47 +1148,20 @@ void QmitkLabelSetWidget::OnToggleOutline(bool value)
 
 void QmitkLabelSetWidget::OnCreateSmoothedSurface(bool /*triggered*/)
 {
-  m_ToolManager->ActivateTool(-1);
-
-  mitk::DataNode::Pointer workingNode = GetWorkingNode();
-  mitk::LabelSetImage *workingImage = GetWorkingImage();
-  int pixelValue = GetPixelValueOfSelectedItem();
-
-  mitk::LabelSetImageToSurfaceThreadedFilter::Pointer surfaceFilter = mitk::LabelSetImageToSurfaceThreadedFilter::New();
-
-  itk::SimpleMemberCommand<QmitkLabelSetWidget>::Pointer successCommand =
-    itk::SimpleMemberCommand<QmitkLabelSetWidget>::New();
-  successCommand->SetCallbackFunction(this, &QmitkLabelSetWidget::OnThreadedCalculationDone);
-  surfaceFilter->AddObserver(mitk::ResultAvailable(), successCommand);
-
-  itk::SimpleMemberCommand<QmitkLabelSetWidget>::Pointer errorCommand =
-    itk::SimpleMemberCommand<QmitkLabelSetWidget>::New();
-  errorCommand->SetCallbackFunction(this, &QmitkLabelSetWidget::OnThreadedCalculationDone);
-  surfaceFilter->AddObserver(mitk::ProcessingError(), errorCommand);
-
-  mitk::DataNode::Pointer groupNode = workingNode;
-  surfaceFilter->SetPointerParameter("Group node", groupNode);
-  surfaceFilter->SetPointerParameter("Input", workingImage);
-  surfaceFilter->SetParameter("RequestedLabel", pixelValue);
-  surfaceFilter->SetParameter("Smooth", true);
-  surfaceFilter->SetDataStorage(*m_DataStorage);
+  this->CreateSurface(true, false);
+}
 
-  mitk::StatusBar::GetInstance()->DisplayText("Surface creation is running in background...");
+void QmitkLabelSetWidget::OnCreateDetailedSurface(bool /*triggered*/)
+{
+  this->CreateSurface(false, false);
+}
 
-  try
-  {
-    surfaceFilter->StartAlgorithm();
-  }
-  catch (mitk::Exception &e)
-  {
-    MITK_ERROR << "Exception caught: " << e.GetDescription();
-    QMessageBox::information(this,
-                             "Create Surface",
-                             "Could not create a surface mesh out of the selected label. See error log for details.\n");
-  }
+void QmitkLabelSetWidget::OnCreateSurfacesOfAllLabels(bool /*triggered*/)
+{
+  this->CreateSurface(false, true);
 }
 
-void QmitkLabelSetWidget::OnCreateDetailedSurface(bool /*triggered*/)
+void QmitkLabelSetWidget::CreateSurface(bool smooth, bool allLabels)
 {
   m_ToolManager->ActivateTool(-1);
 
@@ -1210,7 +1185,8 @@ void QmitkLabelSetWidget::OnCreateDetailedSurface(bool /*triggered*/)
   surfaceFilter->SetPointerParameter("Group node", groupNode);
   surfaceFilter->SetPointerParameter("Input", workingImage);
   surfaceFilter->SetParameter("RequestedLabel", pixelValue);
-  surfaceFilter->SetParameter("Smooth", false);
+  surfaceFilter->SetParameter("Smooth", smooth);
+  surfaceFilter->SetParameter("GenerateAllLabels", allLabels);
   surfaceFilter->SetDataStorage(*m_DataStorage);
 
   mitk::StatusBar::GetInstance()->DisplayText("Surface creation is running in background...");
@@ -1222,9 +1198,9 @@ void QmitkLabelSetWidget::OnCreateDetailedSurface(bool /*triggered*/)
   catch (mitk::Exception &e)
   {
     MITK_ERROR << "Exception caught: " << e.GetDescription();
-    QMessageBox::information(this,
-                             "Create Surface",
-                             "Could not create a surface mesh out of the selected label. See error log for details.\n");
+    QString message = allLabels ? "Could not create surface meshes out of the labels." :
+                                  "Could not create a surface mesh out of the selected label.";
+    QMessageBox::information(this, "Create Surface", message + " See error log for details.\n");
   }
 }
 
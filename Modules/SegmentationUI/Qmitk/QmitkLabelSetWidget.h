@@ -110,6 +110,7 @@ private slots:
   // LabelSetImage Dependet
   void OnCreateDetailedSurface(bool);
   void OnCreateSmoothedSurface(bool);
+  void OnCreateSurfacesOfAllLabels(bool);
   // reaction to the signal "createMask" from QmitkLabelSetTableWidget
   void OnCreateMask(bool);
   void OnCreateMasks(bool);
@@ -149,6 +150,9 @@ private:
 
   void OnThreadedCalculationDone();
 
+  // starts the surface creation in background, for the selected label or for all labels
+  void CreateSurface(bool smooth, bool allLabels);
+
   void InitializeTableWidget();
 
   int GetPixelValueOfSelectedItem();
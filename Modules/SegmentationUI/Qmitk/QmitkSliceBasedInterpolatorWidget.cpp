@@ -49,6 +49,8 @@ QmitkSliceBasedInterpolatorWidget::QmitkSliceBasedInterpolatorWidget(QWidget *pa
     m_SliceInterpolatorController(mitk::SliceBasedInterpolationController::New()),
     m_ToolManager(nullptr),
     m_Activated(false),
+    m_doOperation(nullptr),
+    m_undoOperation(nullptr),
     m_DataStorage(nullptr),
     m_LastSNC(nullptr),
     m_LastSliceIndex(0)
@@ -509,7 +511,8 @@ void QmitkSliceBasedInterpolatorWidget::OnAcceptInterpolationClicked()
                                                  extractor->GetOutput(),
                                                  sliceGeometry,
                                                  timeStep,
-                                                 const_cast<mitk::PlaneGeometry *>(planeGeometry));
+                                                 const_cast<mitk::PlaneGeometry *>(planeGeometry),
+                                                 m_undoOperation);
 
     // create an operation event for the undo stack
     mitk::OperationEvent *undoStackItem = new mitk::OperationEvent(
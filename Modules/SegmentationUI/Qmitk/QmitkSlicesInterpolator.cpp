@@ -1215,8 +1215,12 @@ void QmitkSlicesInterpolator::OnSurfaceInterpolationInfoChanged(const itk::Event
 {
   if (m_3DInterpolationEnabled)
   {
+    // the running interpolation is outdated by the changed contours
     if (m_Watcher.isRunning())
+    {
+      m_SurfaceInterpolator->AbortInterpolation();
       m_Watcher.waitForFinished();
+    }
     m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
     m_Watcher.setFuture(m_Future);
   }
@@ -1276,7 +1280,10 @@ void QmitkSlicesInterpolator::SetCurrentContourListID()
         if (m_3DInterpolationEnabled)
         {
           if (m_Watcher.isRunning())
+          {
+            m_SurfaceInterpolator->AbortInterpolation();
             m_Watcher.waitForFinished();
+          }
           m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
           m_Watcher.setFuture(m_Future);
         }
@@ -1335,6 +1342,7 @@ void QmitkSlicesInterpolator::WaitForFutures()
 {
   if (m_Watcher.isRunning())
   {
+    m_SurfaceInterpolator->AbortInterpolation();
     m_Watcher.waitForFinished();
   }
 
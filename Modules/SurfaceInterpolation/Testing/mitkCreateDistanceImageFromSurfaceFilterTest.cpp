@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCreateDistanceImageFromSurfaceFilter.h>
 #include <mitkIOUtil.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
@@ -29,6 +30,8 @@ class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixtu
   vtkDebugLeaks::SetExitError(0);
   MITK_TEST(TestCreateDistanceImageForLiver);
   MITK_TEST(TestCreateDistanceImageForTube);
+  MITK_TEST(TestPartitionOfUnityInterpolationForLiver);
+  MITK_TEST(TestAbortBeforeUpdate);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -131,6 +134,115 @@ public:
     CPPUNIT_ASSERT_MESSAGE("HolesDistanceImages are not equal!",
                            mitk::Equal(*(holesDistanceImageReference), *(holeDistanceImage), 0.0001, true));
   }
+
+  // An abort requested before the update started must not be reset by the pipeline
+  void TestAbortBeforeUpdate()
+  {
+    unsigned int NUMBER_OF_TUBE_CONTOURS = 5;
+
+    for (unsigned int i = 0; i < NUMBER_OF_TUBE_CONTOURS; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateWithHoles/ContourWithHoles_";
+      s << i;
+      s << ".vtk";
+      mitk::Surface::Pointer contour = mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath(s.str()));
+      contourList.push_back(contour);
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/SegmentationWithHoles.nrrd"));
+
+    mitk::ComputeContourSetNormalsFilter::Pointer m_NormalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer m_InterpolateSurfaceFilter =
+      mitk::CreateDistanceImageFromSurfaceFilter::New();
+
+    m_NormalsFilter->SetSegmentationBinaryImage(segmentationImage);
+    itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, itkImage);
+    m_InterpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      m_NormalsFilter->SetInput(j, contourList.at(j));
+      m_InterpolateSurfaceFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+    }
+
+    m_InterpolateSurfaceFilter->Abort();
+    CPPUNIT_ASSERT_THROW(m_InterpolateSurfaceFilter->Update(), itk::ProcessAborted);
+
+    m_InterpolateSurfaceFilter->ResetAbort();
+    m_InterpolateSurfaceFilter->Modified();
+    CPPUNIT_ASSERT_NO_THROW(m_InterpolateSurfaceFilter->Update());
+    CPPUNIT_ASSERT(m_InterpolateSurfaceFilter->GetOutput()->IsInitialized());
+  }
+
+  // The local interpolations must put nearly all pixels on the same side of the surface as the global one
+  void TestPartitionOfUnityInterpolationForLiver()
+  {
+    unsigned int NUMBER_OF_LIVER_CONTOURS = 18;
+
+    for (unsigned int i = 0; i <= NUMBER_OF_LIVER_CONTOURS; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateLiver/LiverContourWithNormals_";
+      s << i;
+      s << ".vtk";
+      mitk::Surface::Pointer contour = mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath(s.str()));
+      contourList.push_back(contour);
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverSegmentation.nrrd"));
+
+    mitk::ComputeContourSetNormalsFilter::Pointer m_NormalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer m_InterpolateSurfaceFilter =
+      mitk::CreateDistanceImageFromSurfaceFilter::New();
+    m_InterpolateSurfaceFilter->SetInterpolationMethod(
+      mitk::CreateDistanceImageFromSurfaceFilter::PartitionOfUnityInterpolation);
+    // small patches, so that the liver is covered by many of them
+    m_InterpolateSurfaceFilter->SetMaximumNumberOfCentersPerPatch(100);
+
+    itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, itkImage);
+    m_InterpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      m_NormalsFilter->SetInput(j, contourList.at(j));
+      m_InterpolateSurfaceFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+    }
+
+    m_InterpolateSurfaceFilter->Update();
+
+    mitk::Image::Pointer liverDistanceImage = m_InterpolateSurfaceFilter->GetOutput();
+    CPPUNIT_ASSERT(liverDistanceImage.IsNotNull());
+
+    mitk::Image::Pointer liverDistanceImageReference =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverDistanceImage.nrrd"));
+    CPPUNIT_ASSERT_MESSAGE("LiverDistanceImages differ in size!",
+                           mitk::Equal(*(liverDistanceImageReference->GetGeometry()),
+                                       *(liverDistanceImage->GetGeometry()),
+                                       0.0001,
+                                       true));
+
+    mitk::ImageReadAccessor readAccess(liverDistanceImage);
+    mitk::ImageReadAccessor referenceReadAccess(liverDistanceImageReference);
+    const auto *distances = static_cast<const double *>(readAccess.GetData());
+    const auto *referenceDistances = static_cast<const double *>(referenceReadAccess.GetData());
+
+    const unsigned int numberOfPixels =
+      liverDistanceImage->GetDimension(0) * liverDistanceImage->GetDimension(1) * liverDistanceImage->GetDimension(2);
+    unsigned int numberOfDifferentSides = 0;
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if ((distances[i] < 0) != (referenceDistances[i] < 0))
+        ++numberOfDifferentSides;
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("More than 2% of the pixels are on the other side of the surface!",
+                           numberOfDifferentSides * 50 < numberOfPixels);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilter)
@@ -26,6 +26,7 @@ class mitkReduceContourSetFilterTestSuite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkReduceContourSetFilterTestSuite);
   MITK_TEST(TestReduceContourWithNthPoint);
   MITK_TEST(TestReduceContourWithDouglasPeuker);
+  MITK_TEST(TestReductionOfUnchangedContourIsReused);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -74,6 +75,34 @@ public:
       "Unequal contours",
       mitk::Equal(*(reducedContour->GetVtkPolyData()), *(reference->GetVtkPolyData()), 0.000001, true));
   }
+
+  // Updating again reuses the reduction of an unchanged contour
+  void TestReductionOfUnchangedContourIsReused()
+  {
+    mitk::Surface::Pointer contour =
+      mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath("SurfaceInterpolation/Reference/SingleContour.vtk"));
+    m_ContourReducer->SetInput(contour);
+    m_ContourReducer->SetReductionType(mitk::ReduceContourSetFilter::NTH_POINT);
+    m_ContourReducer->SetStepSize(20);
+    m_ContourReducer->Update();
+    mitk::Surface::Pointer reducedContour = m_ContourReducer->GetOutput();
+
+    m_ContourReducer->Modified();
+    m_ContourReducer->Update();
+    CPPUNIT_ASSERT_MESSAGE("Reduction not reused", m_ContourReducer->GetOutput() == reducedContour);
+
+    contour->GetVtkPolyData()->Modified();
+    m_ContourReducer->Modified();
+    m_ContourReducer->Update();
+    CPPUNIT_ASSERT_MESSAGE("Reduction of modified contour reused", m_ContourReducer->GetOutput() != reducedContour);
+
+    mitk::Surface::Pointer reference =
+      mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath("SurfaceInterpolation/Reference/ReducedContourNthPoint_20.vtk"));
+
+    CPPUNIT_ASSERT_MESSAGE(
+      "Unequal contours",
+      mitk::Equal(*(m_ContourReducer->GetOutput()->GetVtkPolyData()), *(reference->GetVtkPolyData()), 0.000001, true));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkReduceContourSetFilter)
@@ -19,6 +19,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIOUtil.h"
 #include "mitkImagePixelReadAccessor.h"
 
+#include <memory>
+
 mitk::ComputeContourSetNormalsFilter::ComputeContourSetNormalsFilter()
   : m_SegmentationBinaryImage(nullptr),
     m_MaxSpacing(5),
@@ -39,6 +41,14 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
 {
   unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
 
+  // Normals of inputs which are not set anymore are dropped
+  std::map<const mitk::Surface *, ContourNormals> contourNormals;
+
+  // The segmentation is accessed once for all vertices, since every access locks the image
+  std::unique_ptr<mitk::ImagePixelReadAccessor<unsigned char>> ucharReadAccess;
+  std::unique_ptr<mitk::ImagePixelReadAccessor<unsigned short>> ushortReadAccess;
+  bool readAccessCreated(false);
+
   // Iterating over each input
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
@@ -46,6 +56,38 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
     auto *currentSurface = this->GetInput(i);
     vtkPolyData *polyData = currentSurface->GetVtkPolyData();
 
+    auto cachedNormals = m_ContourNormals.find(currentSurface);
+    if (cachedNormals != m_ContourNormals.end() && cachedNormals->second.InputMTime == polyData->GetMTime() &&
+        cachedNormals->second.MaxSpacing == m_MaxSpacing &&
+        cachedNormals->second.UsedSegmentationImage == m_SegmentationBinaryImage.IsNotNull())
+    {
+      contourNormals[currentSurface] = cachedNormals->second;
+      this->GetOutput(i)->GetVtkPolyData()->GetCellData()->SetNormals(cachedNormals->second.Normals);
+      continue;
+    }
+
+    if (m_SegmentationBinaryImage && !readAccessCreated)
+    {
+      readAccessCreated = true;
+      try
+      {
+        auto componentType =
+          m_SegmentationBinaryImage->GetImageDescriptor()->GetChannelDescriptor().GetPixelType().GetComponentType();
+        if (componentType == itk::ImageIOBase::UCHAR)
+        {
+          ucharReadAccess.reset(new mitk::ImagePixelReadAccessor<unsigned char>(m_SegmentationBinaryImage));
+        }
+        else if (componentType == itk::ImageIOBase::USHORT)
+        {
+          ushortReadAccess.reset(new mitk::ImagePixelReadAccessor<unsigned short>(m_SegmentationBinaryImage));
+        }
+      }
+      catch (const mitk::Exception &e)
+      {
+        MITK_WARN << e.what();
+      }
+    }
+
     vtkSmartPointer<vtkCellArray> existingPolys = polyData->GetPolys();
 
     vtkSmartPointer<vtkPoints> existingPoints = polyData->GetPoints();
@@ -157,21 +199,13 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
           m_SegmentationBinaryImage->GetGeometry()->WorldToIndex(worldCoord, idx);
           try
           {
-            if (m_SegmentationBinaryImage->GetImageDescriptor()
-                  ->GetChannelDescriptor()
-                  .GetPixelType()
-                  .GetComponentType() == itk::ImageIOBase::UCHAR)
+            if (ucharReadAccess)
             {
-              mitk::ImagePixelReadAccessor<unsigned char> readAccess(m_SegmentationBinaryImage);
-              val = readAccess.GetPixelByIndexSafe(idx);
+              val = ucharReadAccess->GetPixelByIndexSafe(idx);
             }
-            else if (m_SegmentationBinaryImage->GetImageDescriptor()
-                       ->GetChannelDescriptor()
-                       .GetPixelType()
-                       .GetComponentType() == itk::ImageIOBase::USHORT)
+            else if (ushortReadAccess)
             {
-              mitk::ImagePixelReadAccessor<unsigned short> readAccess(m_SegmentationBinaryImage);
-              val = readAccess.GetPixelByIndexSafe(idx);
+              val = ushortReadAccess->GetPixelByIndexSafe(idx);
             }
           }
           catch (const mitk::Exception &e)
@@ -242,8 +276,17 @@ void mitk::ComputeContourSetNormalsFilter::GenerateData()
 
     Surface::Pointer surface = this->GetOutput(i);
     surface->GetVtkPolyData()->GetCellData()->SetNormals(normals);
+
+    ContourNormals &currentNormals = contourNormals[currentSurface];
+    currentNormals.Input = currentSurface;
+    currentNormals.InputMTime = polyData->GetMTime();
+    currentNormals.MaxSpacing = m_MaxSpacing;
+    currentNormals.UsedSegmentationImage = m_SegmentationBinaryImage.IsNotNull();
+    currentNormals.Normals = normals;
   } // end for all inputs
 
+  m_ContourNormals.swap(contourNormals);
+
   // Setting progressbar
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(this->m_ProgressStepSize);
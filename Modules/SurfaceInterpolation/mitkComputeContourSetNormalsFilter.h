@@ -32,6 +32,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImage.h"
 
+#include <map>
+
 namespace mitk
 {
   /**
@@ -49,6 +51,10 @@ namespace mitk
    Note: If a segmentation binary image is provided this filter assures that the computed normals
          do not point into the segmentation image
 
+   The normals of each input are cached between updates and only computed again if the input's polydata
+   was modified. The direction of the normals is determined in the plane of the contour, and a contour is
+   replaced whenever the segmentation in its plane changes, so cached normals stay valid.
+
    $Author: fetzer$
 */
   class MITKSURFACEINTERPOLATION_EXPORT ComputeContourSetNormalsFilter : public SurfaceToSurfaceFilter
@@ -62,7 +68,7 @@ namespace mitk
      */
       mitk::Surface::Pointer GetNormalsAsSurface();
 
-    // Resets the filter, i.e. removes all inputs and outputs
+    // Resets the filter, i.e. removes all inputs and outputs. The cached normals are kept for inputs set again
     void Reset();
 
     void SetMaxSpacing(double);
@@ -89,6 +95,16 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** \brief The normals of one input, reused as long as the input does not change */
+    struct ContourNormals
+    {
+      mitk::Surface::ConstPointer Input;
+      unsigned long InputMTime;
+      double MaxSpacing;
+      bool UsedSegmentationImage;
+      vtkSmartPointer<vtkDoubleArray> Normals;
+    };
+
     // The segmentation out of which the contours were extracted. Can be used to determine the direction of the normals
     mitk::Image::Pointer m_SegmentationBinaryImage;
     double m_MaxSpacing;
@@ -99,6 +115,8 @@ namespace mitk
     bool m_UseProgressBar;
     unsigned int m_ProgressStepSize;
 
+    std::map<const mitk::Surface *, ContourNormals> m_ContourNormals;
+
   }; // class
 
 } // namespace
@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkCreateDistanceImageFromSurfaceFilter.h"
 #include "mitkImageCast.h"
+#include "mitkParallelFor.h"
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
@@ -24,9 +25,37 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkSmartPointer.h"
 
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodIterator.h"
 
-#include <queue>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <set>
+
+namespace
+{
+  // The sphere of a patch encloses its grid cell, enlarged by this factor to overlap the neighbouring patches
+  const double PATCH_OVERLAP = 1.25;
+
+  // Patches with fewer centers are enlarged (up to twice their radius), as few centers extrapolate poorly
+  const unsigned int MINIMUM_NUMBER_OF_CENTERS_PER_PATCH = 20;
+
+  // The patches are not made smaller than 1/64 of the extent of all centers
+  const unsigned int MAXIMUM_PATCH_GRID_SIZE = 64;
+
+  // Pixels of the narrow band whose distances are calculated by one thread at a time
+  const unsigned int NUMBER_OF_PIXELS_PER_TASK = 256;
+
+  /** Wendland's compactly supported C2 function, which weights a patch by the relative distance r from its center. */
+  double WendlandWeight(double r)
+  {
+    if (r >= 1.0)
+      return 0.0;
+
+    const double oneMinusR = 1.0 - r;
+    return oneMinusR * oneMinusR * oneMinusR * oneMinusR * (4.0 * r + 1.0);
+  }
+}
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -109,7 +138,13 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_InterpolationMethod(GlobalInterpolation),
+    m_MaximumNumberOfCentersPerPatch(300),
+    m_PatchGridSpacing(0.0),
+    m_MaximumPatchRadius(0.0),
+    m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0),
+    m_Aborted(false)
 {
   m_DistanceImageVolume = 50000;
   this->m_UseProgressBar = false;
@@ -130,11 +165,21 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   // First of all we have to build the equation-system from the existing contour-edge-points
   this->CreateSolutionMatrixAndFunctionValues();
+  this->CheckAbortGenerateData();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  if (m_InterpolationMethod == PartitionOfUnityInterpolation)
+  {
+    this->CreateAndSolvePatches();
+  }
+  else
+  {
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  }
+
+  this->CheckAbortGenerateData();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
@@ -147,6 +192,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   m_Centers.clear();
   m_Normals.clear();
+  m_Patches.clear();
+  m_PatchGrid.clear();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -172,6 +219,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   PointType currentPoint;
   PointType normal;
 
+  std::set<std::array<double, 3>> existingCenters;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto currentSurface = this->GetInput(i);
@@ -203,9 +252,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (existingCenters.insert({{p[0], p[1], p[2]}}).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -268,6 +315,11 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   // Now we have created all centers and all function values. Next step is to create the solution matrix
   numberOfCenters = m_Centers.size();
 
+  if (m_InterpolationMethod == PartitionOfUnityInterpolation)
+  {
+    return; // every patch creates an equation system of its own
+  }
+
   m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
 
   m_Weights.resize(numberOfCenters);
@@ -290,23 +342,188 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   }
 }
 
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateAndSolvePatches()
+{
+  PointType minPoint = m_Centers.at(0);
+  PointType maxPoint = m_Centers.at(0);
+  for (const auto &center : m_Centers)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      minPoint[dim] = std::min(minPoint[dim], center[dim]);
+      maxPoint[dim] = std::max(maxPoint[dim], center[dim]);
+    }
+  }
+  const PointType extent = maxPoint - minPoint;
+  const double maximumExtent = std::max(extent.max_value(), m_DistanceImageSpacing);
+  m_PatchGridOrigin = minPoint;
+
+  const auto numberOfCenters = static_cast<unsigned int>(m_Centers.size());
+  const unsigned int minimumNumberOfCenters = std::min(MINIMUM_NUMBER_OF_CENTERS_PER_PATCH, numberOfCenters);
+
+  // the centers in each cell of the grid
+  std::vector<std::vector<unsigned int>> centersOfCells;
+
+  auto cellIdOf = [this](int x, int y, int z) { return (z * m_PatchGridSize[1] + y) * m_PatchGridSize[0] + x; };
+
+  // Calls function for every cell whose center is closer than radius to point
+  auto forEachCellAround = [this, &cellIdOf](
+    const PointType &point, double radius, const std::function<void(unsigned int)> &function) {
+    int first[3], last[3];
+    this->GetPatchCellRange(point, radius, first, last);
+
+    PointType cellCenter;
+    for (int z = first[2]; z <= last[2]; ++z)
+    {
+      for (int y = first[1]; y <= last[1]; ++y)
+      {
+        for (int x = first[0]; x <= last[0]; ++x)
+        {
+          cellCenter[0] = m_PatchGridOrigin[0] + (x + 0.5) * m_PatchGridSpacing;
+          cellCenter[1] = m_PatchGridOrigin[1] + (y + 0.5) * m_PatchGridSpacing;
+          cellCenter[2] = m_PatchGridOrigin[2] + (z + 0.5) * m_PatchGridSpacing;
+          if ((point - cellCenter).two_norm() < radius)
+            function(cellIdOf(x, y, z));
+        }
+      }
+    }
+  };
+
+  // The ids of the centers closer than radius to point
+  auto gatherCenters = [this, &centersOfCells, &forEachCellAround](const PointType &point, double radius) {
+    std::vector<unsigned int> centerIds;
+    // a center is in a cell whose center is at most half a cell diagonal away
+    forEachCellAround(point, radius + std::sqrt(3.0) / 2.0 * m_PatchGridSpacing, [&](unsigned int cellId) {
+      for (auto centerId : centersOfCells[cellId])
+      {
+        if ((m_Centers[centerId] - point).two_norm() < radius)
+          centerIds.push_back(centerId);
+      }
+    });
+    return centerIds;
+  };
+
+  // Start with one patch for all centers and halve the cells until no patch has too many centers
+  m_PatchGridSpacing = maximumExtent;
+  std::vector<int> numberOfCentersOfPatches;
+  while (true)
+  {
+    unsigned int numberOfCells = 1;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      m_PatchGridSize[dim] = std::max(1u, static_cast<unsigned int>(std::ceil(extent[dim] / m_PatchGridSpacing)));
+      numberOfCells *= m_PatchGridSize[dim];
+    }
+    m_MaximumPatchRadius = PATCH_OVERLAP * std::sqrt(3.0) / 2.0 * m_PatchGridSpacing;
+
+    centersOfCells.assign(numberOfCells, std::vector<unsigned int>());
+    for (unsigned int i = 0; i < numberOfCenters; ++i)
+    {
+      unsigned int cell[3];
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        const double position = (m_Centers[i][dim] - m_PatchGridOrigin[dim]) / m_PatchGridSpacing;
+        cell[dim] = std::min(m_PatchGridSize[dim] - 1, static_cast<unsigned int>(position));
+      }
+      centersOfCells[cellIdOf(cell[0], cell[1], cell[2])].push_back(i);
+    }
+
+    // count the centers of the patches
+    numberOfCentersOfPatches.assign(numberOfCells, 0);
+    for (const auto &center : m_Centers)
+    {
+      forEachCellAround(center, m_MaximumPatchRadius, [&numberOfCentersOfPatches](unsigned int cellId) {
+        ++numberOfCentersOfPatches[cellId];
+      });
+    }
+
+    const int largestNumberOfCenters =
+      *std::max_element(numberOfCentersOfPatches.begin(), numberOfCentersOfPatches.end());
+    if (largestNumberOfCenters <= static_cast<int>(m_MaximumNumberOfCentersPerPatch) ||
+        maximumExtent / (0.5 * m_PatchGridSpacing) > MAXIMUM_PATCH_GRID_SIZE)
+    {
+      break;
+    }
+    m_PatchGridSpacing *= 0.5;
+  }
+
+  // create a patch for every cell whose sphere contains centers
+  m_Patches.clear();
+  m_PatchGrid.assign(numberOfCentersOfPatches.size(), -1);
+  for (unsigned int z = 0; z < m_PatchGridSize[2]; ++z)
+  {
+    for (unsigned int y = 0; y < m_PatchGridSize[1]; ++y)
+    {
+      for (unsigned int x = 0; x < m_PatchGridSize[0]; ++x)
+      {
+        const unsigned int cellId = cellIdOf(x, y, z);
+        if (numberOfCentersOfPatches[cellId] == 0)
+          continue;
+
+        Patch patch;
+        patch.m_Center[0] = m_PatchGridOrigin[0] + (x + 0.5) * m_PatchGridSpacing;
+        patch.m_Center[1] = m_PatchGridOrigin[1] + (y + 0.5) * m_PatchGridSpacing;
+        patch.m_Center[2] = m_PatchGridOrigin[2] + (z + 0.5) * m_PatchGridSpacing;
+        patch.m_Radius = PATCH_OVERLAP * std::sqrt(3.0) / 2.0 * m_PatchGridSpacing;
+        patch.m_CenterIds = gatherCenters(patch.m_Center, patch.m_Radius);
+
+        const double maximumRadius = 2.0 * patch.m_Radius;
+        while (patch.m_CenterIds.size() < minimumNumberOfCenters && patch.m_Radius < maximumRadius)
+        {
+          patch.m_Radius = std::min(1.25 * patch.m_Radius, maximumRadius);
+          patch.m_CenterIds = gatherCenters(patch.m_Center, patch.m_Radius);
+        }
+
+        m_MaximumPatchRadius = std::max(m_MaximumPatchRadius, patch.m_Radius);
+        m_PatchGrid[cellId] = static_cast<int>(m_Patches.size());
+        m_Patches.push_back(patch);
+      }
+    }
+  }
+
+  // The local equation systems are independent and use the same radial basis function as the global one
+  mitk::ParallelFor(static_cast<unsigned int>(m_Patches.size()), [this](unsigned int patchId) {
+    if (this->IsAborted())
+      return;
+
+    Patch &patch = m_Patches[patchId];
+    const auto numberOfPatchCenters = static_cast<int>(patch.m_CenterIds.size());
+
+    Eigen::MatrixXd solutionMatrix(numberOfPatchCenters, numberOfPatchCenters);
+    Eigen::VectorXd functionValues(numberOfPatchCenters);
+    for (int i = 0; i < numberOfPatchCenters; ++i)
+    {
+      const PointType &center = m_Centers[patch.m_CenterIds[i]];
+      for (int j = 0; j < numberOfPatchCenters; ++j)
+      {
+        solutionMatrix(i, j) = (center - m_Centers[patch.m_CenterIds[j]]).two_norm();
+      }
+      functionValues[i] = m_FunctionValues[patch.m_CenterIds[i]];
+    }
+
+    patch.m_Weights = solutionMatrix.partialPivLu().solve(functionValues);
+  });
+
+  MITK_DEBUG << "Interpolating " << numberOfCenters << " centers with " << m_Patches.size() << " patches";
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
 {
   /*
   * Now we must calculate the distance for each pixel. But instead of calculating the distance value
   * for all of the image's pixels we proceed similar to the region growing algorithm:
   *
-  * 1. Take the first pixel from the narrowband_point_list and calculate the distance for each neighbor (6er)
-  * 2. If the current index's distance value is below a certain threshold push it into the list
-  * 3. Next iteration take the next index from the list and originAsIndex with 1. again
+  * 1. Take the pixels that were added to the narrow band last and calculate the distance for each of their
+  *    neighbors (6er) that was not calculated before
+  * 2. If the current index's distance value is below a certain threshold add it to the narrow band
+  * 3. Next iteration take the added pixels and continue with 1. again
   *
-  * This is done until the narrowband_point_list is empty.
+  * This is done until no pixel is added. The distances of the neighbors in step 1 are independent,
+  * so they are calculated in parallel.
   */
 
   typedef itk::ImageRegionIteratorWithIndex<DistanceImageType> ImageIterator;
-  typedef itk::NeighborhoodIterator<DistanceImageType> NeighborhoodImageIterator;
 
-  std::queue<DistanceImageType::IndexType> narrowbandPoints;
   PointType currentPoint = m_Centers.at(0);
   double distance = this->CalculateDistanceValue(currentPoint);
 
@@ -320,49 +537,76 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   DistanceImageType::IndexType currentIndex;
   m_DistanceImageITK->TransformPhysicalPointToIndex(currentPointAsPoint, currentIndex);
 
-  assert(
-    m_DistanceImageITK->GetLargestPossibleRegion().IsInside(currentIndex)); // we are quite certain this should hold
+  const DistanceImageType::RegionType &largestPossibleRegion = m_DistanceImageITK->GetLargestPossibleRegion();
+  assert(largestPossibleRegion.IsInside(currentIndex)); // we are quite certain this should hold
 
-  narrowbandPoints.push(currentIndex);
   m_DistanceImageITK->SetPixel(currentIndex, distance);
 
-  NeighborhoodImageIterator::RadiusType radius;
-  radius.Fill(1);
-  NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  unsigned int relativeNbIdx[] = {4, 10, 12, 14, 16, 22};
+  std::vector<bool> isCalculated(largestPossibleRegion.GetNumberOfPixels(), false);
+  isCalculated[m_DistanceImageITK->ComputeOffset(currentIndex)] = true;
+
+  std::vector<DistanceImageType::IndexType> narrowbandPoints(1, currentIndex);
+  std::vector<DistanceImageType::IndexType> neighbors;
+  std::vector<double> distances;
 
-  bool isInBounds = false;
   while (!narrowbandPoints.empty())
   {
-    nIt.SetLocation(narrowbandPoints.front());
-    narrowbandPoints.pop();
+    this->CheckAbortGenerateData();
 
-    unsigned int *relativeNb = &relativeNbIdx[0];
-    for (int i = 0; i < 6; i++)
+    neighbors.clear();
+    for (const auto &narrowbandPoint : narrowbandPoints)
     {
-      nIt.GetPixel(*relativeNb, isInBounds);
-      if (isInBounds && nIt.GetPixel(*relativeNb) == m_DistanceImageDefaultBufferValue)
+      for (unsigned int dim = 0; dim < 3; ++dim)
       {
-        currentIndex = nIt.GetIndex(*relativeNb);
-
-        // Transform the currently checked point from index-coordinates to
-        // world-coordinates
-        m_DistanceImageITK->TransformIndexToPhysicalPoint(currentIndex, currentPointAsPoint);
+        for (int step = -1; step <= 1; step += 2)
+        {
+          currentIndex = narrowbandPoint;
+          currentIndex[dim] += step;
+
+          if (largestPossibleRegion.IsInside(currentIndex))
+          {
+            const auto offset = m_DistanceImageITK->ComputeOffset(currentIndex);
+            if (!isCalculated[offset])
+            {
+              isCalculated[offset] = true;
+              neighbors.push_back(currentIndex);
+            }
+          }
+        }
+      }
+    }
 
-        // create a vnl_vector
-        currentPoint[0] = currentPointAsPoint[0];
-        currentPoint[1] = currentPointAsPoint[1];
-        currentPoint[2] = currentPointAsPoint[2];
+    distances.resize(neighbors.size());
+    const auto numberOfNeighbors = static_cast<unsigned int>(neighbors.size());
+    const unsigned int numberOfTasks = (numberOfNeighbors + NUMBER_OF_PIXELS_PER_TASK - 1) / NUMBER_OF_PIXELS_PER_TASK;
+    mitk::ParallelFor(numberOfTasks, [&](unsigned int task) {
+      if (this->IsAborted())
+        return;
+
+      const unsigned int end = std::min(numberOfNeighbors, (task + 1) * NUMBER_OF_PIXELS_PER_TASK);
+      DistanceImageType::PointType neighborAsPoint;
+      PointType neighbor;
+      for (unsigned int i = task * NUMBER_OF_PIXELS_PER_TASK; i < end; ++i)
+      {
+        // Transform the currently checked point from index-coordinates to world-coordinates
+        m_DistanceImageITK->TransformIndexToPhysicalPoint(neighbors[i], neighborAsPoint);
+        neighbor[0] = neighborAsPoint[0];
+        neighbor[1] = neighborAsPoint[1];
+        neighbor[2] = neighborAsPoint[2];
 
         // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
-        if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
-        {
-          nIt.SetPixel(*relativeNb, distance);
-          narrowbandPoints.push(currentIndex);
-        }
+        distances[i] = this->CalculateDistanceValue(neighbor);
+      }
+    });
+
+    narrowbandPoints.clear();
+    for (unsigned int i = 0; i < numberOfNeighbors; ++i)
+    {
+      if (std::fabs(distances[i]) <= m_DistanceImageSpacing * 2)
+      {
+        m_DistanceImageITK->SetPixel(neighbors[i], distances[i]);
+        narrowbandPoints.push_back(neighbors[i]);
       }
-      relativeNb++;
     }
   }
 
@@ -423,14 +667,19 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
-double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(const PointType &p) const
 {
+  if (m_InterpolationMethod == PartitionOfUnityInterpolation)
+  {
+    return this->CalculateDistanceValueByPatches(p);
+  }
+
   double distanceValue(0);
   PointType p1;
   PointType p2;
   double norm;
 
-  CenterList::iterator centerIter;
+  CenterList::const_iterator centerIter;
 
   unsigned int count(0);
   for (centerIter = m_Centers.begin(); centerIter != m_Centers.end(); centerIter++)
@@ -444,6 +693,94 @@ double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointT
   return distanceValue;
 }
 
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValueByPatches(const PointType &p) const
+{
+  int first[3], last[3];
+  this->GetPatchCellRange(p, m_MaximumPatchRadius, first, last);
+
+  // blend the interpolations of all patches containing p
+  double weightedDistanceValue(0);
+  double sumOfWeights(0);
+  for (int z = first[2]; z <= last[2]; ++z)
+  {
+    for (int y = first[1]; y <= last[1]; ++y)
+    {
+      for (int x = first[0]; x <= last[0]; ++x)
+      {
+        const int patchId = m_PatchGrid[(z * m_PatchGridSize[1] + y) * m_PatchGridSize[0] + x];
+        if (patchId < 0)
+          continue;
+
+        const Patch &patch = m_Patches[patchId];
+        const double weight = WendlandWeight((p - patch.m_Center).two_norm() / patch.m_Radius);
+        if (weight == 0.0)
+          continue;
+
+        double distanceValue(0);
+        for (unsigned int i = 0; i < patch.m_CenterIds.size(); ++i)
+        {
+          distanceValue += (p - m_Centers[patch.m_CenterIds[i]]).two_norm() * patch.m_Weights[i];
+        }
+
+        weightedDistanceValue += weight * distanceValue;
+        sumOfWeights += weight;
+      }
+    }
+  }
+
+  // far from all contours, which is outside of the narrow band
+  if (sumOfWeights == 0.0)
+    return m_DistanceImageDefaultBufferValue;
+
+  return weightedDistanceValue / sumOfWeights;
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::Abort()
+{
+  m_Aborted = true;
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::ResetAbort()
+{
+  m_Aborted = false;
+}
+
+bool mitk::CreateDistanceImageFromSurfaceFilter::IsAborted() const
+{
+  return m_Aborted || this->GetAbortGenerateData();
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CheckAbortGenerateData()
+{
+  if (!this->IsAborted())
+    return;
+
+  m_Centers.clear();
+  m_Normals.clear();
+  m_Patches.clear();
+  m_PatchGrid.clear();
+
+  itk::ProcessAborted e(__FILE__, __LINE__);
+  e.SetDescription("Process aborted.");
+  e.SetLocation(ITK_LOCATION);
+  throw e;
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::GetPatchCellRange(const PointType &point,
+                                                                   double radius,
+                                                                   int first[3],
+                                                                   int last[3]) const
+{
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    // the position in units of cells, relative to the center of the first cell
+    const double position = (point[dim] - m_PatchGridOrigin[dim]) / m_PatchGridSpacing - 0.5;
+    const double reach = radius / m_PatchGridSpacing;
+    first[dim] = std::max(0, static_cast<int>(std::ceil(position - reach)));
+    last[dim] = std::min(static_cast<int>(m_PatchGridSize[dim]) - 1, static_cast<int>(std::floor(position + reach)));
+  }
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
 {
 }
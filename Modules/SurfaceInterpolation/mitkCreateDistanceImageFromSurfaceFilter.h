@@ -29,6 +29,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <Eigen/Dense>
 
+#include <atomic>
+
 namespace mitk
 {
   /**
@@ -61,6 +63,13 @@ namespace mitk
          adjusted by calling SetDistanceImageVolume(unsigned int volume) which specifies the number ob pixels enclosed
   by the image.
 
+         The default GlobalInterpolation solves one equation system over all points, whose size grows quadratically
+         and whose solution time grows cubically with the number of points. For many contours,
+         PartitionOfUnityInterpolation solves small local systems instead, see SetInterpolationMethod().
+
+         An update can be aborted from another thread by Abort(). Update() then throws itk::ProcessAborted and the
+         previous output is left unchanged.
+
   \ingroup Process
 
   $Author: fetzer$
@@ -78,6 +87,19 @@ namespace mitk
 
     typedef std::vector<Surface::Pointer> SurfaceList;
 
+    /** \brief Methods to interpolate the distance function between the contour points. */
+    enum InterpolationMethod
+    {
+      /** One radial basis function interpolation over all points. */
+      GlobalInterpolation,
+      /**
+        Radial basis function interpolations over overlapping spherical patches of at most
+        GetMaximumNumberOfCentersPerPatch() points each, blended with compactly supported
+        weights (partition of unity). Runtime and memory grow linearly with the number of points.
+      */
+      PartitionOfUnityInterpolation
+    };
+
     mitkClassMacro(CreateDistanceImageFromSurfaceFilter, ImageSource);
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
@@ -103,6 +125,17 @@ namespace mitk
     */
     itkSetMacro(DistanceImageVolume, unsigned int);
 
+    /** \brief Set the method to interpolate the distance function (default GlobalInterpolation). */
+    itkSetEnumMacro(InterpolationMethod, InterpolationMethod);
+    itkGetEnumMacro(InterpolationMethod, InterpolationMethod);
+
+    /**
+    \brief Set the maximum number of points a patch of the PartitionOfUnityInterpolation is fitted to (default 300).
+           The patches are made smaller until no patch exceeds this number (or they cannot be made smaller).
+    */
+    itkSetMacro(MaximumNumberOfCentersPerPatch, unsigned int);
+    itkGetMacro(MaximumNumberOfCentersPerPatch, unsigned int);
+
     void PrintEquationSystem();
 
     // Resets the filter, i.e. removes all inputs and outputs
@@ -124,6 +157,16 @@ namespace mitk
 
     void SetReferenceImage(itk::ImageBase<3>::Pointer referenceImage);
 
+    /**
+      \brief Aborts a running update, may be called from another thread.
+
+      Unlike SetAbortGenerateData(), which ITK resets at the start of every update, the request is kept until
+      ResetAbort() is called. So it is not lost if it arrives before GenerateData() started.
+    */
+    void Abort();
+
+    void ResetAbort();
+
   protected:
     CreateDistanceImageFromSurfaceFilter();
     ~CreateDistanceImageFromSurfaceFilter() override;
@@ -131,11 +174,32 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** \brief A local interpolation of the PartitionOfUnityInterpolation: the centers within m_Radius of m_Center. */
+    struct Patch
+    {
+      PointType m_Center;
+      double m_Radius;
+      std::vector<unsigned int> m_CenterIds;
+      Eigen::VectorXd m_Weights;
+    };
+
     void CreateSolutionMatrixAndFunctionValues();
-    double CalculateDistanceValue(PointType p);
+    double CalculateDistanceValue(const PointType &p) const;
+
+    /** \brief Creates the patches of the PartitionOfUnityInterpolation and solves their equation systems. */
+    void CreateAndSolvePatches();
+    double CalculateDistanceValueByPatches(const PointType &p) const;
+
+    /** \brief The range of grid cells whose centers may be closer than radius to point; empty if first > last. */
+    void GetPatchCellRange(const PointType &point, double radius, int first[3], int last[3]) const;
 
     void FillDistanceImage();
 
+    bool IsAborted() const;
+
+    /** \brief Drops the intermediate data and throws itk::ProcessAborted if the update was aborted. */
+    void CheckAbortGenerateData();
+
     /**
     * \brief This method fills the given variables with the minimum and
     * maximum coordinates that contain all input-points in index- and
@@ -166,6 +230,17 @@ namespace mitk
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
+    InterpolationMethod m_InterpolationMethod;
+    unsigned int m_MaximumNumberOfCentersPerPatch;
+
+    // The patches are centered in the cells of a regular grid, m_PatchGrid holds the patch of each cell (or -1)
+    std::vector<Patch> m_Patches;
+    std::vector<int> m_PatchGrid;
+    PointType m_PatchGridOrigin;
+    unsigned int m_PatchGridSize[3];
+    double m_PatchGridSpacing;
+    double m_MaximumPatchRadius;
+
     DistanceImageType::Pointer m_DistanceImageITK;
     itk::ImageBase<3>::Pointer m_ReferenceImage;
 
@@ -175,6 +250,8 @@ namespace mitk
 
     bool m_UseProgressBar;
     unsigned int m_ProgressStepSize;
+
+    std::atomic<bool> m_Aborted;
   };
 
 } // namespace
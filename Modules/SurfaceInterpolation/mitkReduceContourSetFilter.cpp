@@ -52,77 +52,77 @@ void mitk::ReduceContourSetFilter::GenerateData()
   unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
   unsigned int numberOfOutputs(0);
 
-  vtkSmartPointer<vtkPolyData> newPolyData;
-  vtkSmartPointer<vtkCellArray> newPolygons;
-  vtkSmartPointer<vtkPoints> newPoints;
+  // Set tolerance if none is specified. Done before reducing because it is part of the cached reductions
+  if (m_ReductionType == DOUGLAS_PEUCKER && m_Tolerance < 0)
+  {
+    if (m_MaxSpacing > 0)
+    {
+      m_Tolerance = m_MinSpacing;
+    }
+    else
+    {
+      m_Tolerance = 1.5;
+    }
+  }
 
   // For the purpose of evaluation
   //  unsigned int numberOfPointsBefore (0);
   m_NumberOfPointsAfterReduction = 0;
 
+  // Reductions of inputs which are not set anymore are dropped
+  std::map<const mitk::Surface *, ReducedContour> reducedContours;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto *currentSurface = this->GetInput(i);
     vtkSmartPointer<vtkPolyData> polyData = currentSurface->GetVtkPolyData();
 
-    newPolyData = vtkSmartPointer<vtkPolyData>::New();
-    newPolygons = vtkSmartPointer<vtkCellArray>::New();
-    newPoints = vtkSmartPointer<vtkPoints>::New();
-
     vtkSmartPointer<vtkCellArray> existingPolys = polyData->GetPolys();
 
     vtkSmartPointer<vtkPoints> existingPoints = polyData->GetPoints();
 
-    existingPolys->InitTraversal();
-
     vtkIdType *cell(nullptr);
     vtkIdType cellSize(0);
+    vtkIdType cellId(0);
 
-    for (existingPolys->InitTraversal(); existingPolys->GetNextCell(cellSize, cell);)
+    // The intersection check depends on all other inputs, so it is done even if the input itself is unchanged
+    std::vector<vtkIdType> incorporatedCells;
+    for (existingPolys->InitTraversal(); existingPolys->GetNextCell(cellSize, cell); ++cellId)
     {
-      bool incorporatePolygon =
-        this->CheckForIntersection(cell, cellSize, existingPoints, /*numberOfIntersections, intersectionPoints, */ i);
-      if (!incorporatePolygon)
-        continue;
-
-      vtkSmartPointer<vtkPolygon> newPolygon = vtkSmartPointer<vtkPolygon>::New();
-
-      if (m_ReductionType == NTH_POINT)
+      if (this->CheckForIntersection(cell, cellSize, existingPoints, /*numberOfIntersections, intersectionPoints, */ i))
       {
-        this->ReduceNumberOfPointsByNthPoint(cellSize, cell, existingPoints, newPolygon, newPoints);
-        if (newPolygon->GetPointIds()->GetNumberOfIds() != 0)
-        {
-          newPolygons->InsertNextCell(newPolygon);
-        }
-      }
-      else if (m_ReductionType == DOUGLAS_PEUCKER)
-      {
-        this->ReduceNumberOfPointsByDouglasPeucker(cellSize, cell, existingPoints, newPolygon, newPoints);
-        if (newPolygon->GetPointIds()->GetNumberOfIds() > 3)
-        {
-          newPolygons->InsertNextCell(newPolygon);
-        }
+        incorporatedCells.push_back(cellId);
       }
-
-      // Again for evaluation
-      //      numberOfPointsBefore += cellSize;
-      m_NumberOfPointsAfterReduction += newPolygon->GetPointIds()->GetNumberOfIds();
     }
 
-    if (newPolygons->GetNumberOfCells() != 0)
+    ReducedContour &reducedContour = reducedContours[currentSurface];
+
+    auto cachedContour = m_ReducedContours.find(currentSurface);
+    if (cachedContour != m_ReducedContours.end() && cachedContour->second.InputMTime == polyData->GetMTime() &&
+        cachedContour->second.ReductionType == m_ReductionType && cachedContour->second.StepSize == m_StepSize &&
+        cachedContour->second.Tolerance == m_Tolerance && cachedContour->second.IncorporatedCells == incorporatedCells)
     {
-      newPolyData->SetPolys(newPolygons);
-      newPolyData->SetPoints(newPoints);
-      newPolyData->BuildLinks();
+      reducedContour = cachedContour->second;
+    }
+    else
+    {
+      this->ReduceContour(currentSurface, incorporatedCells, reducedContour);
+    }
+
+    // Again for evaluation
+    //      numberOfPointsBefore += cellSize;
+    m_NumberOfPointsAfterReduction += reducedContour.NumberOfPoints;
 
+    if (reducedContour.Output.IsNotNull())
+    {
       this->SetNumberOfIndexedOutputs(numberOfOutputs + 1);
-      mitk::Surface::Pointer surface = mitk::Surface::New();
-      this->SetNthOutput(numberOfOutputs, surface.GetPointer());
-      surface->SetVtkPolyData(newPolyData);
+      this->SetNthOutput(numberOfOutputs, reducedContour.Output.GetPointer());
       numberOfOutputs++;
     }
   }
 
+  m_ReducedContours.swap(reducedContours);
+
   //  MITK_INFO<<"Points before: "<<numberOfPointsBefore<<" ##### Points after: "<<numberOfPointsAfter;
   this->SetNumberOfIndexedOutputs(numberOfOutputs);
 
@@ -137,6 +137,71 @@ void mitk::ReduceContourSetFilter::GenerateData()
     mitk::ProgressBar::GetInstance()->Progress(this->m_ProgressStepSize);
 }
 
+void mitk::ReduceContourSetFilter::ReduceContour(const mitk::Surface *input,
+                                                 const std::vector<vtkIdType> &incorporatedCells,
+                                                 ReducedContour &reducedContour)
+{
+  vtkPolyData *polyData = input->GetVtkPolyData();
+  vtkPoints *existingPoints = polyData->GetPoints();
+  vtkCellArray *existingPolys = polyData->GetPolys();
+
+  reducedContour.Input = input;
+  reducedContour.InputMTime = polyData->GetMTime();
+  reducedContour.ReductionType = m_ReductionType;
+  reducedContour.StepSize = m_StepSize;
+  reducedContour.Tolerance = m_Tolerance;
+  reducedContour.IncorporatedCells = incorporatedCells;
+  reducedContour.Output = nullptr;
+  reducedContour.NumberOfPoints = 0;
+
+  vtkSmartPointer<vtkCellArray> newPolygons = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+
+  vtkIdType *cell(nullptr);
+  vtkIdType cellSize(0);
+  vtkIdType cellId(0);
+  auto incorporatedCell = incorporatedCells.begin();
+
+  for (existingPolys->InitTraversal(); existingPolys->GetNextCell(cellSize, cell); ++cellId)
+  {
+    if (incorporatedCell == incorporatedCells.end() || *incorporatedCell != cellId)
+      continue;
+    ++incorporatedCell;
+
+    vtkSmartPointer<vtkPolygon> newPolygon = vtkSmartPointer<vtkPolygon>::New();
+
+    if (m_ReductionType == NTH_POINT)
+    {
+      this->ReduceNumberOfPointsByNthPoint(cellSize, cell, existingPoints, newPolygon, newPoints);
+      if (newPolygon->GetPointIds()->GetNumberOfIds() != 0)
+      {
+        newPolygons->InsertNextCell(newPolygon);
+      }
+    }
+    else if (m_ReductionType == DOUGLAS_PEUCKER)
+    {
+      this->ReduceNumberOfPointsByDouglasPeucker(cellSize, cell, existingPoints, newPolygon, newPoints);
+      if (newPolygon->GetPointIds()->GetNumberOfIds() > 3)
+      {
+        newPolygons->InsertNextCell(newPolygon);
+      }
+    }
+
+    reducedContour.NumberOfPoints += newPolygon->GetPointIds()->GetNumberOfIds();
+  }
+
+  if (newPolygons->GetNumberOfCells() != 0)
+  {
+    vtkSmartPointer<vtkPolyData> newPolyData = vtkSmartPointer<vtkPolyData>::New();
+    newPolyData->SetPolys(newPolygons);
+    newPolyData->SetPoints(newPoints);
+    newPolyData->BuildLinks();
+
+    reducedContour.Output = mitk::Surface::New();
+    reducedContour.Output->SetVtkPolyData(newPolyData);
+  }
+}
+
 void mitk::ReduceContourSetFilter::ReduceNumberOfPointsByNthPoint(
   vtkIdType cellSize, vtkIdType *cell, vtkPoints *points, vtkPolygon *reducedPolygon, vtkPoints *reducedPoints)
 {
@@ -212,19 +277,6 @@ void mitk::ReduceContourSetFilter::ReduceNumberOfPointsByDouglasPeucker(
   reduced ones
   */
 
-  // First of all set tolerance if none is specified
-  if (m_Tolerance < 0)
-  {
-    if (m_MaxSpacing > 0)
-    {
-      m_Tolerance = m_MinSpacing;
-    }
-    else
-    {
-      m_Tolerance = 1.5;
-    }
-  }
-
   std::stack<LineSegment> lineSegments;
 
   // 1. Divide in line segments
@@ -29,7 +29,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkPolygon.h"
 #include "vtkSmartPointer.h"
 
+#include <map>
 #include <stack>
+#include <vector>
 
 namespace mitk
 {
@@ -50,6 +52,10 @@ namespace mitk
 
     The output is a mitk::Surface.
 
+    The reduced polygons of each input are cached between updates. An input whose polydata is unchanged and
+    whose polygons pass the intersection check as before is not reduced again, and its previous output
+    surface is reused. This makes updating after a single contour was added or removed cheap.
+
     $Author: fetzer$
   */
 
@@ -79,7 +85,7 @@ namespace mitk
 
     itkGetMacro(NumberOfPointsAfterReduction, unsigned int);
 
-    // Resets the filter, i.e. removes all inputs and outputs
+    // Resets the filter, i.e. removes all inputs and outputs. The cached reductions are kept for inputs set again
     void Reset();
 
     /**
@@ -107,6 +113,23 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** \brief The reduction of one input, reused as long as the input and the reduction parameters do not change */
+    struct ReducedContour
+    {
+      mitk::Surface::ConstPointer Input;
+      unsigned long InputMTime;
+      Reduction_Type ReductionType;
+      unsigned int StepSize;
+      double Tolerance;
+      std::vector<vtkIdType> IncorporatedCells;
+      mitk::Surface::Pointer Output;
+      unsigned int NumberOfPoints;
+    };
+
+    void ReduceContour(const mitk::Surface *input,
+                       const std::vector<vtkIdType> &incorporatedCells,
+                       ReducedContour &reducedContour);
+
     void ReduceNumberOfPointsByNthPoint(
       vtkIdType cellSize, vtkIdType *cell, vtkPoints *points, vtkPolygon *reducedPolygon, vtkPoints *reducedPoints);
 
@@ -132,6 +155,8 @@ namespace mitk
 
     unsigned int m_NumberOfPointsAfterReduction;
 
+    std::map<const mitk::Surface *, ReducedContour> m_ReducedContours;
+
   }; // class
 
 } // namespace
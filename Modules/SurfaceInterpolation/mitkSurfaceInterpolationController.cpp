@@ -23,6 +23,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 //#include "vtkXMLPolyDataWriter.h"
 #include "vtkPolyDataWriter.h"
 
+namespace
+{
+  // More centers are interpolated by patches, solving the global equation system would take seconds
+  const unsigned int MAXIMUM_NUMBER_OF_CENTERS_FOR_GLOBAL_INTERPOLATION = 3000;
+}
+
 // Check whether the given contours are coplanar
 bool ContoursCoplanar(mitk::SurfaceInterpolationController::ContourPositionInformation leftHandSide,
                       mitk::SurfaceInterpolationController::ContourPositionInformation rightHandSide)
@@ -78,7 +84,7 @@ mitk::SurfaceInterpolationController::ContourPositionInformation CreateContourPo
 }
 
 mitk::SurfaceInterpolationController::SurfaceInterpolationController()
-  : m_SelectedSegmentation(nullptr), m_CurrentTimeStep(0)
+  : m_SelectedSegmentation(nullptr), m_CurrentTimeStep(0), m_InterpolationAborted(false)
 {
   m_DistanceImageSpacing = 0.0;
   m_ReduceFilter = ReduceContourSetFilter::New();
@@ -265,6 +271,9 @@ unsigned int mitk::SurfaceInterpolationController::GetNumberOfContours()
 
 void mitk::SurfaceInterpolationController::Interpolate()
 {
+  m_InterpolationAborted = false;
+  m_InterpolateSurfaceFilter->ResetAbort();
+
   m_ReduceFilter->Update();
 
   m_CurrentNumberOfReducedContours = m_ReduceFilter->GetNumberOfOutputs();
@@ -300,6 +309,22 @@ void mitk::SurfaceInterpolationController::Interpolate()
     return;
   }
 
+  // Each contour point is a center of the interpolation, together with a point inside and one outside
+  if (m_ReduceFilter->GetNumberOfPointsAfterReduction() * 3 > MAXIMUM_NUMBER_OF_CENTERS_FOR_GLOBAL_INTERPOLATION)
+  {
+    m_InterpolateSurfaceFilter->SetInterpolationMethod(
+      CreateDistanceImageFromSurfaceFilter::PartitionOfUnityInterpolation);
+  }
+  else
+  {
+    m_InterpolateSurfaceFilter->SetInterpolationMethod(CreateDistanceImageFromSurfaceFilter::GlobalInterpolation);
+  }
+
+  if (m_InterpolationAborted)
+  {
+    return;
+  }
+
   // Setting up progress bar
   mitk::ProgressBar::GetInstance()->AddStepsToDo(10);
 
@@ -309,7 +334,22 @@ void mitk::SurfaceInterpolationController::Interpolate()
   imageToSurfaceFilter->SetThreshold(0);
   imageToSurfaceFilter->SetSmooth(true);
   imageToSurfaceFilter->SetSmoothIteration(20);
-  imageToSurfaceFilter->Update();
+
+  try
+  {
+    imageToSurfaceFilter->Update();
+  }
+  catch (const itk::ProcessAborted &)
+  {
+    mitk::ProgressBar::GetInstance()->Progress(20);
+    return;
+  }
+
+  if (m_InterpolationAborted)
+  {
+    mitk::ProgressBar::GetInstance()->Progress(20);
+    return;
+  }
 
   mitk::Surface::Pointer interpolationResult = mitk::Surface::New();
   interpolationResult->SetVtkPolyData(imageToSurfaceFilter->GetOutput()->GetVtkPolyData(), m_CurrentTimeStep);
@@ -332,6 +372,12 @@ void mitk::SurfaceInterpolationController::Interpolate()
   m_InterpolationResult->DisconnectPipeline();
 }
 
+void mitk::SurfaceInterpolationController::AbortInterpolation()
+{
+  m_InterpolationAborted = true;
+  m_InterpolateSurfaceFilter->Abort();
+}
+
 mitk::Surface::Pointer mitk::SurfaceInterpolationController::GetInterpolationResult()
 {
   return m_InterpolationResult;
@@ -377,6 +423,12 @@ double mitk::SurfaceInterpolationController::EstimatePortionOfNeededMemory()
 {
   double numberOfPointsAfterReduction = m_ReduceFilter->GetNumberOfPointsAfterReduction() * 3;
   double sizeOfPoints = pow(numberOfPointsAfterReduction, 2) * sizeof(double);
+  if (numberOfPointsAfterReduction > MAXIMUM_NUMBER_OF_CENTERS_FOR_GLOBAL_INTERPOLATION)
+  {
+    // The patch systems hold each point in a few patches of limited size
+    sizeOfPoints = numberOfPointsAfterReduction * m_InterpolateSurfaceFilter->GetMaximumNumberOfCentersPerPatch() *
+                   sizeof(double);
+  }
   double totalMem = mitk::MemoryUtilities::GetTotalSizeOfPhysicalRam();
   double percentage = sizeOfPoints / totalMem;
   return percentage;
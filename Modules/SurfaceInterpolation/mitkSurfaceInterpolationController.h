@@ -47,6 +47,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkProgressBar.h"
 
+#include <atomic>
+
 namespace mitk
 {
   class MITKSURFACEINTERPOLATION_EXPORT SurfaceInterpolationController : public itk::Object
@@ -121,9 +123,20 @@ namespace mitk
 
     /**
      * Interpolates the 3D surface from the given extracted contours
+     *
+     * The reduced contours and their normals are cached, so after adding or removing a contour only this
+     * contour is processed again. For many contour points the distance function is interpolated by local
+     * patches (see CreateDistanceImageFromSurfaceFilter::PartitionOfUnityInterpolation), which keeps
+     * updating a large interpolation fast. May be called from a worker thread, see AbortInterpolation().
      */
     void Interpolate();
 
+    /**
+     * Aborts an Interpolate() running in another thread, e.g. because the contours changed meanwhile
+     * and a new interpolation is about to start. The previous interpolation result is kept.
+     */
+    void AbortInterpolation();
+
     mitk::Surface::Pointer GetInterpolationResult();
 
     /**
@@ -249,6 +262,8 @@ namespace mitk
     std::map<mitk::Image *, unsigned long> m_SegmentationObserverTags;
 
     unsigned int m_CurrentTimeStep;
+
+    std::atomic<bool> m_InterpolationAborted;
   };
 }
 #endif